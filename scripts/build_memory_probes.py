@@ -34,7 +34,7 @@ SUPPORTED_PLATFORMS = {
         "prefix": "lib",
         "compiler": {
             "command": "gcc",
-            "args": "-shared -fPIC -o {output_file} {source_file} -DMEMORY_PROBE_MAIN"
+            "args": "-shared -fPIC -pthread -o {output_file} {source_file} -DMEMORY_PROBE_MAIN"
         }
     },
     "Darwin": {  # macOS
@@ -42,7 +42,7 @@ SUPPORTED_PLATFORMS = {
         "prefix": "lib",
         "compiler": {
             "command": "gcc",
-            "args": "-shared -fPIC -o {output_file} {source_file} -DMEMORY_PROBE_MAIN"
+            "args": "-shared -fPIC -pthread -o {output_file} {source_file} -DMEMORY_PROBE_MAIN"
         }
     }
 }
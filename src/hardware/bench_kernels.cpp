@@ -0,0 +1,650 @@
+/**
+ * 原生内核基准 - VisionAI-ClipsMaster
+ *
+ * performance_verification.py 从 Python 经 ctypes 计时，结果含调用与数组转换开销。
+ * bench_kernels 直接链接 simd_kernels/assembly_kernels，按尺寸扫描各导出内核
+ * (GEMM、GEMV、量化矩阵乘、逐元素、点积、按位运算、归约与 Transformer 算子)，
+ * 以 Google Benchmark 的方式自动确定迭代次数并重复测量，报告 GFLOP/s、GB/s
+ * 及其占本机实测峰值的比例: 算力以 simd_peak_gflops 为分母 (INT8 用例为 simd_peak_int8_gops)，
+ * 带宽以工作集所在缓存级别 (L1d/L2/L3/DRAM) 的 simd_peak_bandwidth 为分母，
+ * 可输出 JSON 供回归跟踪与分发阈值选择。
+ *
+ * 用法: bench_kernels [--filter=正则] [--min_time=秒] [--repetitions=N] [--threads=N]
+ *                     [--json=路径|-] [--quick] [--no_peak] [--list]
+ */
+
+#include "simd_kernels.h"
+#include "assembly_kernels.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <functional>
+#include <memory>
+#include <random>
+#include <regex>
+#include <string>
+#include <vector>
+
+namespace {
+
+/**
+ * 一个基准用例: setup 分配并初始化输入，返回被计时的调用 (闭包持有缓冲区)
+ * flops 为每次调用的运算次数 (按位运算按元素计)，bytes 为必须读写的最少内存流量
+ */
+struct Benchmark {
+    std::string name;
+    std::string family;
+    double flops;
+    double bytes;
+    std::function<std::function<void()>()> setup;
+};
+
+/**
+ * 一级存储的带宽屋顶: capacity 为该级对所有线程的合计容量 (DRAM 为 0)
+ */
+struct BandwidthLevel {
+    const char* name;
+    long long capacity;
+    double gbs;
+};
+
+struct Result {
+    const Benchmark* bench;
+    long long iterations;
+    double median_ns;
+    double min_ns;
+};
+
+struct Options {
+    std::string filter;
+    std::string json;
+    double min_time = 0.1;
+    int repetitions = 3;
+    int threads = 0;
+    bool quick = false;
+    bool peak = true;
+    bool list = false;
+};
+
+std::vector<float> random_floats(size_t n, unsigned seed) {
+    std::mt19937 rng(seed);
+    std::uniform_real_distribution<float> dist(-1.0f, 1.0f);
+    std::vector<float> v(n);
+    for (float& x : v) {
+        x = dist(rng);
+    }
+    return v;
+}
+
+std::vector<int> random_ints(size_t n, unsigned seed) {
+    std::mt19937 rng(seed);
+    std::vector<int> v(n);
+    for (int& x : v) {
+        x = (int)rng();
+    }
+    return v;
+}
+
+std::string shape_name(const char* family, std::initializer_list<long long> dims) {
+    std::string name = family;
+    char sep = '/';
+    for (long long d : dims) {
+        name += sep;
+        name += std::to_string(d);
+        sep = 'x';
+    }
+    return name;
+}
+
+void add_sgemm(std::vector<Benchmark>& out, bool quick) {
+    struct Shape { int m, n, k; };
+    std::vector<Shape> shapes = quick
+        ? std::vector<Shape>{{64, 64, 64}, {256, 256, 256}, {16, 2048, 2048}}
+        : std::vector<Shape>{{64, 64, 64}, {128, 128, 128}, {256, 256, 256}, {512, 512, 512},
+                             {1024, 1024, 1024}, {1, 4096, 4096}, {16, 2048, 2048},
+                             {128, 4096, 1024}};
+    for (const Shape& s : shapes) {
+        Benchmark b;
+        b.name = shape_name("sgemm", {s.m, s.n, s.k});
+        b.family = "sgemm";
+        b.flops = 2.0 * s.m * s.n * s.k;
+        b.bytes = 4.0 * ((double)s.m * s.k + (double)s.k * s.n + (double)s.m * s.n);
+        b.setup = [s]() -> std::function<void()> {
+            auto a = std::make_shared<std::vector<float>>(random_floats((size_t)s.m * s.k, 1));
+            auto w = std::make_shared<std::vector<float>>(random_floats((size_t)s.k * s.n, 2));
+            auto c = std::make_shared<std::vector<float>>((size_t)s.m * s.n);
+            return [s, a, w, c]() {
+                simd_sgemm(SIMD_GEMM_NO_TRANS, SIMD_GEMM_NO_TRANS, s.m, s.n, s.k, 1.0f,
+                           a->data(), s.k, w->data(), s.n, 0.0f, c->data(), s.n);
+            };
+        };
+        out.push_back(b);
+    }
+
+    // 注意力头大小的批量 GEMM
+    const int batches[] = {64, 512};
+    for (int batch : batches) {
+        if (quick && batch > 64) {
+            continue;
+        }
+        const int d = 64;
+        Benchmark b;
+        b.name = shape_name("sgemm_batched", {batch, d, d, d});
+        b.family = "sgemm_batched";
+        b.flops = 2.0 * batch * d * d * d;
+        b.bytes = 4.0 * 3 * batch * d * d;
+        b.setup = [batch, d]() -> std::function<void()> {
+            const size_t stride = (size_t)d * d;
+            auto a = std::make_shared<std::vector<float>>(random_floats(stride * batch, 1));
+            auto w = std::make_shared<std::vector<float>>(random_floats(stride * batch, 2));
+            auto c = std::make_shared<std::vector<float>>(stride * batch);
+            return [batch, d, stride, a, w, c]() {
+                sgemm_strided_batched(SIMD_GEMM_NO_TRANS, SIMD_GEMM_NO_TRANS, d, d, d, 1.0f,
+                                      a->data(), d, (long long)stride, w->data(), d, (long long)stride,
+                                      0.0f, c->data(), d, (long long)stride, batch);
+            };
+        };
+        out.push_back(b);
+    }
+}
+
+void add_gemv(std::vector<Benchmark>& out, bool quick) {
+    std::vector<int> sizes = quick ? std::vector<int>{1024} : std::vector<int>{1024, 4096, 8192};
+    for (int n : sizes) {
+        const int k = n;
+        const double nk = (double)n * k;
+        const double vec_bytes = 4.0 * (n + k);
+
+        Benchmark f32{shape_name("gemv_f32", {n, k}), "gemv", 2.0 * nk, 4.0 * nk + vec_bytes, nullptr};
+        f32.setup = [n, k]() -> std::function<void()> {
+            auto w = std::make_shared<std::vector<float>>(random_floats((size_t)n * k, 1));
+            auto x = std::make_shared<std::vector<float>>(random_floats(k, 2));
+            auto y = std::make_shared<std::vector<float>>(n);
+            return [n, k, w, x, y]() { simd_gemv_f32(w->data(), k, x->data(), nullptr, y->data(), n, k); };
+        };
+        out.push_back(f32);
+
+        Benchmark f16{shape_name("gemv_f16", {n, k}), "gemv", 2.0 * nk, 2.0 * nk + vec_bytes, nullptr};
+        f16.setup = [n, k]() -> std::function<void()> {
+            auto w = std::make_shared<std::vector<unsigned short>>((size_t)n * k, (unsigned short)0x3C00);
+            auto x = std::make_shared<std::vector<float>>(random_floats(k, 2));
+            auto y = std::make_shared<std::vector<float>>(n);
+            return [n, k, w, x, y]() { simd_gemv_f16(w->data(), k, x->data(), nullptr, y->data(), n, k); };
+        };
+        out.push_back(f16);
+
+        Benchmark q8{shape_name("gemv_q8", {n, k}), "gemv", 2.0 * nk, nk + 4.0 * n + vec_bytes, nullptr};
+        q8.setup = [n, k]() -> std::function<void()> {
+            auto w = std::make_shared<std::vector<signed char>>((size_t)n * k, (signed char)3);
+            auto scales = std::make_shared<std::vector<float>>(n, 0.01f);
+            auto x = std::make_shared<std::vector<float>>(random_floats(k, 2));
+            auto y = std::make_shared<std::vector<float>>(n);
+            return [n, k, w, scales, x, y]() {
+                simd_gemv_q8(w->data(), k, scales->data(), x->data(), nullptr, y->data(), n, k);
+            };
+        };
+        out.push_back(q8);
+
+        const int group = 128;
+        Benchmark q4{shape_name("gemv_q4", {n, k}), "gemv", 2.0 * nk,
+                     0.5 * nk + 4.0 * nk / group + vec_bytes, nullptr};
+        q4.setup = [n, k, group]() -> std::function<void()> {
+            auto w = std::make_shared<std::vector<unsigned char>>((size_t)n * k / 2, (unsigned char)0x97);
+            auto scales = std::make_shared<std::vector<float>>((size_t)n * (k / group), 0.01f);
+            auto x = std::make_shared<std::vector<float>>(random_floats(k, 2));
+            auto y = std::make_shared<std::vector<float>>(n);
+            return [n, k, group, w, scales, x, y]() {
+                simd_gemv_q4(w->data(), k / 2, scales->data(), group, x->data(), nullptr, y->data(), n, k);
+            };
+        };
+        out.push_back(q4);
+    }
+}
+
+void add_quantized(std::vector<Benchmark>& out, bool quick) {
+    std::vector<int> sizes = quick ? std::vector<int>{1024} : std::vector<int>{1024, 4096};
+    for (int k : sizes) {
+        const int width = k;
+        const int groups = k / 128;
+        const double nk = (double)k * width;
+
+        // AutoGPTQ 8 位分组量化 (单行激活，即解码)
+        Benchmark q8{shape_name("vecquant8matmul", {1, k, width}), "quant_matmul", 2.0 * nk,
+                     nk + 4.0 * (groups * width + k + width), nullptr};
+        q8.setup = [k, width, groups]() -> std::function<void()> {
+            auto vec = std::make_shared<std::vector<float>>(random_floats(k, 1));
+            auto qweight = std::make_shared<std::vector<int>>(random_ints((size_t)k / 4 * width, 2));
+            auto mul = std::make_shared<std::vector<float>>(width);
+            auto scales = std::make_shared<std::vector<float>>((size_t)groups * width, 0.01f);
+            auto zeros = std::make_shared<std::vector<int>>(random_ints((size_t)groups * width / 4, 3));
+            auto g_idx = std::make_shared<std::vector<int>>(k);
+            for (int i = 0; i < k; ++i) {
+                (*g_idx)[i] = i / 128;
+            }
+            return [k, width, groups, vec, qweight, mul, scales, zeros, g_idx]() {
+                vecquant8matmul(vec->data(), qweight->data(), mul->data(), scales->data(), zeros->data(),
+                                g_idx->data(), 1, k, width, groups, width / 4);
+            };
+        };
+        out.push_back(q8);
+
+        Benchmark q4{shape_name("vecquant4matmul_batched", {1, k, width}), "quant_matmul", 2.0 * nk,
+                     0.5 * nk + 4.0 * (2 * width + k + width), nullptr};
+        q4.setup = [k, width]() -> std::function<void()> {
+            auto vec = std::make_shared<std::vector<float>>(random_floats(k, 1));
+            auto qweight = std::make_shared<std::vector<int>>(random_ints((size_t)k / 8 * width, 2));
+            auto mul = std::make_shared<std::vector<float>>(width);
+            auto scales = std::make_shared<std::vector<float>>(width, 0.01f);
+            auto zeros = std::make_shared<std::vector<int>>(random_ints(width / 8, 3));
+            return [k, width, vec, qweight, mul, scales, zeros]() {
+                vecquant4matmul_batched(vec->data(), qweight->data(), mul->data(), scales->data(),
+                                        zeros->data(), 1, 1, 1, k, width, width / 8);
+            };
+        };
+        out.push_back(q4);
+    }
+
+    // INT8 GEMM: 解码 (M = 1) 到预填充 (M = 128)
+    std::vector<int> rows = quick ? std::vector<int>{1, 64} : std::vector<int>{1, 16, 128};
+    const int k = 2048;
+    const int n = 2048;
+    for (int m : rows) {
+        Benchmark b{shape_name("int8_gemm", {m, n, k}), "int8_gemm", 2.0 * m * n * k,
+                    (double)k * n + 4.0 * ((double)m * k + (double)m * n), nullptr};
+        b.setup = [m, n, k]() -> std::function<void()> {
+            const std::vector<float> w = random_floats((size_t)k * n, 2);
+            std::shared_ptr<SimdInt8Weights> packed(simd_int8_pack_weights(w.data(), k, n, n),
+                                                   simd_int8_free_weights);
+            auto a = std::make_shared<std::vector<float>>(random_floats((size_t)m * k, 1));
+            auto c = std::make_shared<std::vector<float>>((size_t)m * n);
+            return [m, n, k, packed, a, c]() { simd_int8_gemm(a->data(), k, packed.get(), c->data(), n, m); };
+        };
+        out.push_back(b);
+    }
+}
+
+/**
+ * 逐元素类: flops_per 与 bytes_per 为每个元素的运算数与字节数
+ */
+template <typename Call>
+void add_streaming(std::vector<Benchmark>& out, const char* family, const std::vector<long long>& sizes,
+                   double flops_per, double bytes_per, int n_arrays, Call call) {
+    for (long long n : sizes) {
+        Benchmark b{shape_name(family, {n}), family, flops_per * n, bytes_per * n, nullptr};
+        b.setup = [n, n_arrays, call]() -> std::function<void()> {
+            auto bufs = std::make_shared<std::vector<std::vector<float>>>();
+            for (int i = 0; i < n_arrays; ++i) {
+                bufs->push_back(random_floats((size_t)n, 11 + i));
+            }
+            return [n, bufs, call]() { call(*bufs, n); };
+        };
+        out.push_back(b);
+    }
+}
+
+void add_elementwise(std::vector<Benchmark>& out, bool quick) {
+    const std::vector<long long> sizes = quick
+        ? std::vector<long long>{1 << 12, 1 << 20}
+        : std::vector<long long>{1 << 12, 1 << 16, 1 << 20, 1 << 24};
+    typedef std::vector<std::vector<float>> Bufs;
+
+    add_streaming(out, "add", sizes, 1, 12, 3, [](Bufs& b, long long n) {
+        dispatch_matrix_add(b[0].data(), b[1].data(), b[2].data(), (int)n);
+    });
+    add_streaming(out, "scale", sizes, 1, 8, 1, [](Bufs& b, long long n) {
+        dispatch_vector_scale(b[0].data(), 1.0f, (int)n);
+    });
+    add_streaming(out, "fma", sizes, 2, 16, 4, [](Bufs& b, long long n) {
+        dispatch_fma(b[0].data(), b[1].data(), b[2].data(), b[3].data(), (int)n);
+    });
+    add_streaming(out, "dot", sizes, 2, 8, 2, [](Bufs& b, long long n) {
+        volatile float r = asm_vector_dot(b[0].data(), b[1].data(), (int)n);
+        (void)r;
+    });
+    // 按位运算以 float 缓冲区的位模式作为 int 输入
+    add_streaming(out, "bitwise_or", sizes, 1, 12, 3, [](Bufs& b, long long n) {
+        asm_vector_bitwise_or(reinterpret_cast<const int*>(b[0].data()),
+                              reinterpret_cast<const int*>(b[1].data()),
+                              reinterpret_cast<int*>(b[2].data()), (int)n);
+    });
+    add_streaming(out, "bitwise_and", sizes, 1, 12, 3, [](Bufs& b, long long n) {
+        asm_vector_bitwise_and(reinterpret_cast<const int*>(b[0].data()),
+                               reinterpret_cast<const int*>(b[1].data()),
+                               reinterpret_cast<int*>(b[2].data()), (int)n);
+    });
+    add_streaming(out, "reduce_sum", sizes, 1, 4, 1, [](Bufs& b, long long n) {
+        volatile float r = simd_reduce(SIMD_REDUCE_SUM, b[0].data(), n);
+        (void)r;
+    });
+    add_streaming(out, "silu", sizes, 4, 8, 2, [](Bufs& b, long long n) {
+        simd_activation(SIMD_ACT_SILU, b[0].data(), b[1].data(), n);
+    });
+}
+
+void add_transformer(std::vector<Benchmark>& out, bool quick) {
+    struct Shape { int rows, cols; };
+    std::vector<Shape> shapes = quick ? std::vector<Shape>{{64, 4096}}
+                                      : std::vector<Shape>{{1, 4096}, {64, 4096}, {512, 4096}};
+    for (const Shape& s : shapes) {
+        const double n = (double)s.rows * s.cols;
+        Benchmark sm{shape_name("softmax", {s.rows, s.cols}), "transformer", 4.0 * n, 8.0 * n, nullptr};
+        sm.setup = [s]() -> std::function<void()> {
+            auto x = std::make_shared<std::vector<float>>(random_floats((size_t)s.rows * s.cols, 1));
+            auto y = std::make_shared<std::vector<float>>((size_t)s.rows * s.cols);
+            return [s, x, y]() { simd_softmax(x->data(), s.cols, y->data(), s.cols, s.rows, s.cols, 1.0f); };
+        };
+        out.push_back(sm);
+
+        Benchmark rms{shape_name("rmsnorm", {s.rows, s.cols}), "transformer", 4.0 * n, 8.0 * n, nullptr};
+        rms.setup = [s]() -> std::function<void()> {
+            auto x = std::make_shared<std::vector<float>>(random_floats((size_t)s.rows * s.cols, 1));
+            auto w = std::make_shared<std::vector<float>>(random_floats(s.cols, 2));
+            auto y = std::make_shared<std::vector<float>>((size_t)s.rows * s.cols);
+            return [s, x, w, y]() {
+                simd_rmsnorm(x->data(), s.cols, w->data(), y->data(), s.cols, s.rows, s.cols, 1e-6f);
+            };
+        };
+        out.push_back(rms);
+    }
+
+    // 融合注意力: 32 头 x 128 维，预填充 (n_q = n_kv) 与解码 (n_q = 1)
+    struct AttnShape { int n_q, n_kv; };
+    std::vector<AttnShape> attn = quick ? std::vector<AttnShape>{{1, 1024}}
+                                        : std::vector<AttnShape>{{1, 4096}, {512, 512}, {2048, 2048}};
+    const int heads = 32;
+    const int dim = 128;
+    for (const AttnShape& s : attn) {
+        const double flops = 4.0 * heads * dim * (double)s.n_q * s.n_kv;
+        const double bytes = 4.0 * heads * dim * (2.0 * s.n_q + 2.0 * s.n_kv);
+        Benchmark b{shape_name("attention", {s.n_q, s.n_kv}), "attention", flops, bytes, nullptr};
+        b.setup = [s, heads, dim]() -> std::function<void()> {
+            const long long token_stride = (long long)heads * dim;
+            auto q = std::make_shared<std::vector<float>>(random_floats((size_t)s.n_q * token_stride, 1));
+            auto k = std::make_shared<std::vector<float>>(random_floats((size_t)s.n_kv * token_stride, 2));
+            auto v = std::make_shared<std::vector<float>>(random_floats((size_t)s.n_kv * token_stride, 3));
+            auto o = std::make_shared<std::vector<float>>((size_t)s.n_q * token_stride);
+            SimdAttentionParams p = {s.n_q, s.n_kv, dim, heads, heads,
+                                     token_stride, dim, token_stride, dim, token_stride, dim,
+                                     token_stride, dim, 0.0f, 1};
+            return [p, q, k, v, o]() { simd_attention(&p, q->data(), k->data(), v->data(), o->data()); };
+        };
+        out.push_back(b);
+    }
+}
+
+double seconds_since(std::chrono::steady_clock::time_point t0) {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+}
+
+/**
+ * 与 Google Benchmark 相同的迭代次数选择: 倍增直到一轮耗时达到 min_time，
+ * 之后以该迭代次数重复 repetitions 轮，取每次调用耗时的中位数与最小值
+ */
+Result run_benchmark(const Benchmark& bench, const Options& opt) {
+    std::function<void()> body = bench.setup();
+    body();     // 预热: 首次调用的缺页与线程池启动不计入
+
+    long long iters = 1;
+    for (;;) {
+        const auto t0 = std::chrono::steady_clock::now();
+        for (long long i = 0; i < iters; ++i) {
+            body();
+        }
+        const double sec = seconds_since(t0);
+        if (sec >= opt.min_time || iters >= (1LL << 30)) {
+            break;
+        }
+        const double grow = sec > 0.0 ? opt.min_time * 1.4 / sec : 10.0;
+        iters = (long long)std::ceil((double)iters * std::min(std::max(grow, 2.0), 10.0));
+    }
+
+    std::vector<double> per_call;
+    for (int r = 0; r < opt.repetitions; ++r) {
+        const auto t0 = std::chrono::steady_clock::now();
+        for (long long i = 0; i < iters; ++i) {
+            body();
+        }
+        per_call.push_back(seconds_since(t0) * 1e9 / (double)iters);
+    }
+    std::sort(per_call.begin(), per_call.end());
+    return Result{&bench, iters, per_call[per_call.size() / 2], per_call.front()};
+}
+
+/**
+ * 各级带宽屋顶，工作集取法与 roofline 相同: L1d/L2 取每线程私有容量的一半，
+ * L3 取 L2 的 4 倍 (不超过 L3 的一半)，内存为 L3 的 4 倍 (至少 64 MiB，至多 1 GiB)
+ */
+std::vector<BandwidthLevel> measure_levels(const SimdCacheInfo& cache, int threads) {
+    const long long t = std::max(threads, 1);
+    struct Level { const char* name; long long bytes; long long capacity; };
+    const Level levels[] = {
+        {"L1d", cache.l1d_size / 2 * t, cache.l1d_size * t},
+        {"L2", cache.l2_size / 2 * t, cache.l2_size * t},
+        {"L3", std::min(cache.l2_size * 4 * t, cache.l3_size / 2), cache.l3_size},
+        {"DRAM", std::min(std::max(cache.l3_size * 4, 64LL << 20), 1LL << 30), 0},
+    };
+    std::vector<BandwidthLevel> out;
+    for (const Level& level : levels) {
+        if (level.bytes > 0) {
+            out.push_back({level.name, level.capacity, simd_peak_bandwidth(level.bytes, threads)});
+        }
+    }
+    return out;
+}
+
+// 工作集 (用例的最少内存流量，反复调用时常驻缓存) 能放入的最内层存储
+const BandwidthLevel* level_for(const std::vector<BandwidthLevel>& levels, double bytes) {
+    const BandwidthLevel* best = nullptr;
+    for (const BandwidthLevel& level : levels) {
+        best = &level;
+        if (level.capacity > 0 && bytes <= (double)level.capacity) {
+            break;
+        }
+    }
+    return best;
+}
+
+/**
+ * 用例的算力与带宽分母: INT8 GEMM 按整数乘加计数，以 INT8 峰值为分母
+ */
+struct Peaks {
+    double gflops;
+    double int8_gops;
+    std::vector<BandwidthLevel> levels;
+
+    double compute_for(const Benchmark& b) const { return b.family == "int8_gemm" ? int8_gops : gflops; }
+};
+
+std::string json_escape(const std::string& s) {
+    std::string out;
+    for (char c : s) {
+        if (c == '"' || c == '\\') {
+            out += '\\';
+        }
+        out += c;
+    }
+    return out;
+}
+
+// 峰值未测量 (<= 0) 时比例输出为 null
+std::string json_ratio(double value, double peak) {
+    if (peak <= 0.0) {
+        return "null";
+    }
+    char buf[32];
+    snprintf(buf, sizeof(buf), "%.4f", value / peak);
+    return buf;
+}
+
+bool write_json(const std::string& path, const std::vector<Result>& results, const Options& opt,
+                const Peaks& peaks) {
+    FILE* f = path == "-" ? stdout : fopen(path.c_str(), "w");
+    if (!f) {
+        return false;
+    }
+    char date[64];
+    const time_t now = time(nullptr);
+    strftime(date, sizeof(date), "%Y-%m-%dT%H:%M:%S", localtime(&now));
+    SimdCacheInfo cache;
+    simd_get_cache_info(&cache);
+
+    fprintf(f, "{\n  \"context\": {\n");
+    fprintf(f, "    \"date\": \"%s\",\n", date);
+    fprintf(f, "    \"variant\": \"%s\",\n", json_escape(simd_get_active_variant()).c_str());
+    fprintf(f, "    \"int8_variant\": \"%s\",\n", json_escape(simd_int8_get_variant()).c_str());
+    fprintf(f, "    \"num_threads\": %d,\n", simd_get_num_threads());
+    fprintf(f, "    \"cache_line\": %d,\n", cache.line_size);
+    fprintf(f, "    \"l1d_bytes\": %lld,\n    \"l2_bytes\": %lld,\n    \"l3_bytes\": %lld,\n",
+            cache.l1d_size, cache.l2_size, cache.l3_size);
+    fprintf(f, "    \"peak_gflops\": %.3f,\n", peaks.gflops);
+    fprintf(f, "    \"peak_int8_gops\": %.3f,\n", peaks.int8_gops);
+    fprintf(f, "    \"peak_bandwidth_gbs\": %.3f,\n",
+            peaks.levels.empty() ? 0.0 : peaks.levels.back().gbs);
+    fprintf(f, "    \"bandwidth_levels\": [");
+    for (size_t i = 0; i < peaks.levels.size(); ++i) {
+        fprintf(f, "%s{\"level\": \"%s\", \"capacity\": %lld, \"gbs\": %.3f}", i ? ", " : "",
+                peaks.levels[i].name, peaks.levels[i].capacity, peaks.levels[i].gbs);
+    }
+    fprintf(f, "],\n");
+    fprintf(f, "    \"min_time\": %.3f,\n    \"repetitions\": %d\n  },\n", opt.min_time, opt.repetitions);
+    fprintf(f, "  \"benchmarks\": [");
+    for (size_t i = 0; i < results.size(); ++i) {
+        const Result& r = results[i];
+        const Benchmark& b = *r.bench;
+        const double sec = r.median_ns * 1e-9;
+        const double gflops = b.flops / sec * 1e-9;
+        const double gbs = b.bytes / sec * 1e-9;
+        const BandwidthLevel* level = level_for(peaks.levels, b.bytes);
+        fprintf(f, "%s\n    {\"name\": \"%s\", \"family\": \"%s\", \"iterations\": %lld, "
+                "\"real_time_ns\": %.1f, \"min_time_ns\": %.1f, \"flops\": %.0f, \"bytes\": %.0f, "
+                "\"gflops\": %.3f, \"gbs\": %.3f, \"intensity\": %.4f, "
+                "\"pct_peak_flops\": %s, \"bw_level\": \"%s\", \"pct_peak_bandwidth\": %s}",
+                i ? "," : "", json_escape(b.name).c_str(), json_escape(b.family).c_str(), r.iterations,
+                r.median_ns, r.min_ns, b.flops, b.bytes, gflops, gbs, b.flops / b.bytes,
+                json_ratio(gflops, peaks.compute_for(b)).c_str(), level ? level->name : "",
+                json_ratio(gbs, level ? level->gbs : 0.0).c_str());
+    }
+    fprintf(f, "\n  ]\n}\n");
+    return f == stdout ? fflush(f) == 0 : fclose(f) == 0;
+}
+
+const char* option_value(const char* arg, const char* name) {
+    const size_t len = strlen(name);
+    return strncmp(arg, name, len) == 0 && arg[len] == '=' ? arg + len + 1 : nullptr;
+}
+
+bool parse_options(int argc, char** argv, Options* opt) {
+    for (int i = 1; i < argc; ++i) {
+        const char* arg = argv[i];
+        const char* v = nullptr;
+        if ((v = option_value(arg, "--filter"))) {
+            opt->filter = v;
+        } else if ((v = option_value(arg, "--json"))) {
+            opt->json = v;
+        } else if ((v = option_value(arg, "--min_time"))) {
+            opt->min_time = atof(v);
+        } else if ((v = option_value(arg, "--repetitions"))) {
+            opt->repetitions = std::max(1, atoi(v));
+        } else if ((v = option_value(arg, "--threads"))) {
+            opt->threads = atoi(v);
+        } else if (strcmp(arg, "--quick") == 0) {
+            opt->quick = true;
+        } else if (strcmp(arg, "--no_peak") == 0) {
+            opt->peak = false;
+        } else if (strcmp(arg, "--list") == 0) {
+            opt->list = true;
+        } else {
+            fprintf(stderr, "unknown option: %s\n", arg);
+            return false;
+        }
+    }
+    return true;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    Options opt;
+    if (!parse_options(argc, argv, &opt)) {
+        fprintf(stderr, "usage: %s [--filter=REGEX] [--min_time=SEC] [--repetitions=N] [--threads=N] "
+                "[--json=PATH|-] [--quick] [--no_peak] [--list]\n", argv[0]);
+        return 2;
+    }
+    if (opt.threads > 0) {
+        simd_set_num_threads(opt.threads);
+    }
+
+    std::vector<Benchmark> all;
+    add_sgemm(all, opt.quick);
+    add_gemv(all, opt.quick);
+    add_quantized(all, opt.quick);
+    add_elementwise(all, opt.quick);
+    add_transformer(all, opt.quick);
+
+    std::vector<const Benchmark*> selected;
+    try {
+        const std::regex re(opt.filter.empty() ? std::string(".") : opt.filter);
+        for (const Benchmark& b : all) {
+            if (std::regex_search(b.name, re)) {
+                selected.push_back(&b);
+            }
+        }
+    } catch (const std::regex_error&) {
+        fprintf(stderr, "invalid filter: %s\n", opt.filter.c_str());
+        return 2;
+    }
+    if (opt.list) {
+        for (const Benchmark* b : selected) {
+            printf("%s\n", b->name.c_str());
+        }
+        return 0;
+    }
+
+    // 控制台输出在 JSON 写到标准输出时改到标准错误
+    FILE* con = opt.json == "-" ? stderr : stdout;
+    Peaks peaks = {0.0, 0.0, {}};
+    if (opt.peak) {
+        SimdCacheInfo cache;
+        simd_get_cache_info(&cache);
+        peaks.gflops = simd_peak_gflops(nullptr, 0);
+        peaks.int8_gops = simd_peak_int8_gops(0);
+        peaks.levels = measure_levels(cache, simd_get_num_threads());
+    }
+    fprintf(con, "variant: %s, int8: %s, threads: %d, peak: %.1f GFLOP/s, %.1f int8 GOP/s\n",
+            simd_get_active_variant(), simd_int8_get_variant(), simd_get_num_threads(),
+            peaks.gflops, peaks.int8_gops);
+    for (const BandwidthLevel& level : peaks.levels) {
+        fprintf(con, "  %-5s bandwidth: %.1f GB/s\n", level.name, level.gbs);
+    }
+    fprintf(con, "%-36s %14s %12s %10s %10s %8s %8s %-5s\n",
+            "Benchmark", "Time(ns)", "Iterations", "GFLOP/s", "GB/s", "%FLOP", "%BW", "Level");
+    fprintf(con, "%s\n", std::string(110, '-').c_str());
+
+    std::vector<Result> results;
+    for (const Benchmark* b : selected) {
+        const Result r = run_benchmark(*b, opt);
+        const double sec = r.median_ns * 1e-9;
+        const double gflops = b->flops / sec * 1e-9;
+        const double gbs = b->bytes / sec * 1e-9;
+        const double peak_compute = peaks.compute_for(*b);
+        const BandwidthLevel* level = level_for(peaks.levels, b->bytes);
+        const double peak_gbs = level ? level->gbs : 0.0;
+        fprintf(con, "%-36s %14.0f %12lld %10.2f %10.2f %7.1f%% %7.1f%% %-5s\n", b->name.c_str(),
+                r.median_ns, r.iterations, gflops, gbs,
+                peak_compute > 0.0 ? 100.0 * gflops / peak_compute : 0.0,
+                peak_gbs > 0.0 ? 100.0 * gbs / peak_gbs : 0.0, level ? level->name : "-");
+        fflush(con);
+        results.push_back(r);
+    }
+
+    if (!opt.json.empty() && !write_json(opt.json, results, opt, peaks)) {
+        fprintf(stderr, "failed to write %s\n", opt.json.c_str());
+        return 1;
+    }
+    return 0;
+}
@@ -48,9 +48,172 @@ else:
     HAS_ALIGNED_MEMORY = False
 
 # 追踪已分配的内存，以便正确释放
-_ALLOCATED_MEMORY = weakref.WeakValueDictionary()
+# 必须持有强引用: 弱引用会让原始缓冲区在 aligned_alloc 返回后立即被回收
+_ALLOCATED_MEMORY: Dict[int, Any] = {}
 _MEMORY_LOCK = threading.RLock()
 
+# 原生内存池 (libsimd_kernels 的 simd_pool_*)，由 simd_wrapper 加载库后注册
+_NATIVE_LIB = None
+NATIVE_POOL_ALIGNMENTS = (64, 4096)
+
+class NativeBlock:
+    """
+    原生内存块的持有者: 通过 __array_interface__ 交给 NumPy，
+    由此创建的数组 (及其视图) 以本对象为 base，最后一个引用消失时才释放内存块
+    """
+    
+    def __init__(self, ptr: int, nbytes: int, release=None):
+        self.ptr = ptr
+        self.nbytes = nbytes
+        self._release = release
+        self.__array_interface__ = {
+            'shape': (nbytes,),
+            'typestr': '|u1',
+            'data': (ptr, False),
+            'version': 3,
+        }
+    
+    def __del__(self):
+        release, self._release = self._release, None
+        if release is not None:
+            try:
+                release(self.ptr)
+            except Exception:
+                pass  # 解释器退出时库可能已卸载
+
+def register_native_pool(lib) -> bool:
+    """
+    注册原生内存池，此后 aligned_alloc 从池中分配 (对齐值不超过 4096 时)
+    
+    Args:
+        lib: 已加载的 libsimd_kernels (ctypes.CDLL)
+        
+    Returns:
+        bool: 库是否导出内存池接口
+    """
+    global _NATIVE_LIB
+    try:
+        lib.simd_pool_alloc.argtypes = [ctypes.c_longlong, ctypes.c_int]
+        lib.simd_pool_alloc.restype = ctypes.c_void_p
+        lib.simd_pool_free.argtypes = [ctypes.c_void_p]
+        lib.simd_pool_free.restype = None
+        lib.simd_arena_create.argtypes = [ctypes.c_longlong]
+        lib.simd_arena_create.restype = ctypes.c_void_p
+        lib.simd_arena_destroy.argtypes = [ctypes.c_void_p]
+        lib.simd_arena_destroy.restype = None
+        lib.simd_arena_alloc.argtypes = [ctypes.c_void_p, ctypes.c_longlong, ctypes.c_int]
+        lib.simd_arena_alloc.restype = ctypes.c_void_p
+        lib.simd_arena_reset.argtypes = [ctypes.c_void_p]
+        lib.simd_arena_reset.restype = None
+        lib.simd_arena_stats.argtypes = [ctypes.c_void_p] + [ctypes.POINTER(ctypes.c_longlong)] * 3
+        lib.simd_arena_stats.restype = None
+    except AttributeError:
+        return False
+    _NATIVE_LIB = lib
+    return True
+
+def has_native_pool() -> bool:
+    """原生内存池是否可用"""
+    return _NATIVE_LIB is not None
+
+def _pool_block(size: int, alignment: int) -> Optional[NativeBlock]:
+    """从原生内存池分配一个块，池不可用或对齐值超出范围时返回 None"""
+    lib = _NATIVE_LIB
+    if lib is None or alignment > NATIVE_POOL_ALIGNMENTS[-1]:
+        return None
+    ptr = lib.simd_pool_alloc(max(size, 1), alignment)
+    if not ptr:
+        return None
+    return NativeBlock(ptr, size, lib.simd_pool_free)
+
+def pool_empty(shape: Union[int, Tuple[int, ...]], dtype=np.float32,
+               alignment: int = DEFAULT_ALIGNMENT) -> np.ndarray:
+    """
+    从原生内存池创建未初始化数组；数组回收后内存块回到池中。
+    池不可用或 alignment 超过 4096 时改为多分配 alignment 字节的 np.empty 并按偏移取视图
+    
+    Args:
+        shape: 数组形状
+        dtype: 数据类型
+        alignment: 对齐字节数 (2 的幂)
+        
+    Returns:
+        np.ndarray: 对齐的数组
+    """
+    dtype = np.dtype(dtype)
+    size = int(np.prod(shape)) * dtype.itemsize
+    block = _pool_block(size, alignment)
+    if block is None:
+        raw = np.empty(size + alignment, dtype=np.uint8)
+        offset = -raw.ctypes.data % alignment
+        return raw[offset:offset + size].view(dtype).reshape(shape)
+    return np.asarray(block).view(dtype).reshape(shape)
+
+class NativeArena:
+    """
+    原生 arena: 同一流水线阶段内的临时数组顺序切分自几个大块，阶段结束时 reset 整体回收
+    
+    reset 会使此前分配的内存全部失效，因此仍有数组存活时拒绝 reset (除非 force=True)
+    """
+    
+    def __init__(self, chunk_bytes: int = 4 << 20, lib=None):
+        self.lib = lib if lib is not None else _NATIVE_LIB
+        if self.lib is None:
+            raise RuntimeError("原生内存池未注册")
+        self.handle = self.lib.simd_arena_create(chunk_bytes)
+        self._live = weakref.WeakSet()
+        self.lock = threading.Lock()
+    
+    def empty(self, shape: Union[int, Tuple[int, ...]], dtype=np.float32,
+              alignment: int = DEFAULT_ALIGNMENT) -> np.ndarray:
+        """在 arena 中创建未初始化数组"""
+        dtype = np.dtype(dtype)
+        size = int(np.prod(shape)) * dtype.itemsize
+        ptr = self.lib.simd_arena_alloc(self.handle, size, alignment)
+        if not ptr:
+            raise MemoryError(f"arena 分配 {size} 字节失败 (对齐 {alignment})")
+        block = NativeBlock(ptr, size)
+        with self.lock:
+            self._live.add(block)
+        return np.asarray(block).view(dtype).reshape(shape)
+    
+    def live_arrays(self) -> int:
+        """仍被引用的 arena 内存块数"""
+        with self.lock:
+            return len(self._live)
+    
+    def reset(self, force: bool = False):
+        """
+        回收本阶段的全部分配
+        
+        Args:
+            force: 为 True 时即使仍有数组引用 arena 内存也执行 (调用方保证不再访问)
+        """
+        with self.lock:
+            if not force and len(self._live) > 0:
+                raise RuntimeError(f"仍有 {len(self._live)} 个数组引用 arena 内存，不能 reset")
+            self._live = weakref.WeakSet()
+            self.lib.simd_arena_reset(self.handle)
+    
+    def get_stats(self) -> Dict[str, int]:
+        """返回 used (本阶段已分配)、reserved (持有的大块合计) 与 peak 字节数"""
+        used, reserved, peak = ctypes.c_longlong(), ctypes.c_longlong(), ctypes.c_longlong()
+        self.lib.simd_arena_stats(self.handle, ctypes.byref(used), ctypes.byref(reserved),
+                                  ctypes.byref(peak))
+        return {'used': used.value, 'reserved': reserved.value, 'peak': peak.value}
+    
+    def close(self):
+        """销毁 arena，内存块归还原生内存池"""
+        handle, self.handle = self.handle, None
+        if handle:
+            self.lib.simd_arena_destroy(handle)
+    
+    def __del__(self):
+        try:
+            self.close()
+        except Exception:
+            pass
+
 def aligned_alloc(size: int, alignment: int = DEFAULT_ALIGNMENT) -> ctypes.c_void_p:
     """
     申请内存对齐缓冲区 (64字节对齐)
@@ -66,6 +229,14 @@ def aligned_alloc(size: int, alignment: int = DEFAULT_ALIGNMENT) -> ctypes.c_voi
     if alignment & (alignment - 1) != 0:
         raise ValueError(f"对齐值必须是2的幂，而不是 {alignment}")
     
+    # 优先从原生内存池取块，释放后由池复用
+    block = _pool_block(size, alignment)
+    if block is not None:
+        ptr = ctypes.c_void_p(block.ptr)
+        with _MEMORY_LOCK:
+            _ALLOCATED_MEMORY[ptr.value] = block
+        return ptr
+    
     # 创建原始内存缓冲区 (比请求的大，以便可以进行对齐调整)
     raw_ptr = ctypes.create_string_buffer(size + alignment)
     
@@ -75,7 +246,7 @@ def aligned_alloc(size: int, alignment: int = DEFAULT_ALIGNMENT) -> ctypes.c_voi
     # 返回对齐后的指针
     ptr = ctypes.cast(ctypes.addressof(raw_ptr) + offset, ctypes.c_void_p)
     
-    # 使用弱引用字典保存原始缓冲区引用，防止垃圾回收
+    # 保存原始缓冲区引用，防止垃圾回收
     with _MEMORY_LOCK:
         _ALLOCATED_MEMORY[ptr.value] = raw_ptr
     
@@ -189,10 +360,18 @@ class AlignedMemory:
         ptr = self.allocate(size)
         
         # 创建使用此内存的NumPy数组
-        array = np.frombuffer(
-            (ctypes.c_byte * size).from_address(ptr.value),
-            dtype=dtype
-        ).reshape(shape)
+        # 直接基于原始缓冲区创建视图，使数组持有缓冲区引用，
+        # 避免管理器释放后数组指向已回收的内存
+        # (原生内存池的块同样由数组持有，管理器释放后块在数组回收时才回到池中)
+        with _MEMORY_LOCK:
+            raw_buffer = _ALLOCATED_MEMORY[ptr.value]
+        if isinstance(raw_buffer, NativeBlock):
+            array = np.asarray(raw_buffer)[:size].view(dtype).reshape(shape)
+        else:
+            offset = ptr.value - ctypes.addressof(raw_buffer)
+            array = np.frombuffer(
+                raw_buffer, dtype=np.uint8, count=size, offset=offset
+            ).view(dtype).reshape(shape)
         
         # 使数组不可调整大小，防止在不知情的情况下重新分配内存
         array.flags.writeable = True
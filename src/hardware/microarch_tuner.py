@@ -527,6 +527,13 @@ class MicroArchTuner:
             config['cache_line_size'] = 64
             config['prefetch_distance'] = 256
             
+        # 原生库检测到的缓存拓扑优先于按型号查表的结果
+        native_cache = _native_cache_info()
+        if native_cache:
+            config['cache_line_size'] = native_cache['line_size']
+            config['cache_sizes'] = {level: native_cache[f'{level}_size'] for level in ('l1d', 'l2', 'l3')}
+            config['gemm_blocking'] = native_cache['gemm_blocking']
+            
         # 确保缓存行大小是2的幂
         config['cache_line_size'] = max(16, min(128, config['cache_line_size']))
         
@@ -604,6 +611,15 @@ class MicroArchTuner:
         
         return optimized
 
+def _native_cache_info() -> Optional[Dict[str, Any]]:
+    """原生 SIMD 库的缓存拓扑 (sysfs / CPUID)，库不可用时返回 None"""
+    try:
+        from src.hardware.simd_wrapper import get_simd_operations
+        return get_simd_operations().get_cache_info()
+    except Exception as e:
+        logger.debug(f"原生缓存拓扑不可用: {str(e)}")
+        return None
+
 # 全局单例
 _microarch_tuner = None
 
@@ -63,6 +63,9 @@ PERFORMANCE_STANDARDS = {
     'default': 1.0  # 默认情况下不需要加速
 }
 
+# 屋顶线分析中实测/可达性能低于该比例的内核视为仍有优化空间
+ROOFLINE_HEADROOM_THRESHOLD = 0.5
+
 class TimeitResult:
     """计时测试结果类"""
     
@@ -408,11 +411,122 @@ def test_instruction_set_performance() -> Dict[str, bool]:
     
     return results
 
-def generate_performance_report(output_path: Optional[str] = None) -> Dict[str, Any]:
+def load_roofline_report(path: str,
+                         threshold: float = ROOFLINE_HEADROOM_THRESHOLD) -> Dict[str, Any]:
+    """读取原生屋顶线工具的输出并汇总
+    
+    先运行 bench_kernels --json=bench.json，再运行 roofline --bench=bench.json --json=roofline.json
+    
+    Args:
+        path: roofline 输出的 JSON 路径
+        threshold: 实测/可达性能低于该比例的内核列入 headroom
+        
+    Returns:
+        Dict[str, Any]: 原始报告，附加 summary (受算力/带宽限制的内核数、按效率升序的待优化内核，
+            以及实测超过全部屋顶、屋顶模型不成立的内核 over_roof)
+    """
+    with open(path, 'r', encoding='utf-8') as f:
+        report = json.load(f)
+    
+    kernels = report.get('kernels', [])
+    headroom = sorted((k for k in kernels if k.get('efficiency', 0.0) < threshold),
+                      key=lambda k: k.get('efficiency', 0.0))
+    over_roof = [k['name'] for k in kernels if k.get('over_roof')]
+    report['summary'] = {
+        'compute_bound': sum(1 for k in kernels if k.get('bound') == 'compute'),
+        'memory_bound': sum(1 for k in kernels if k.get('bound') == 'memory'),
+        'threshold': threshold,
+        'headroom': [
+            {
+                'name': k['name'],
+                'bound': k.get('bound'),
+                'level': k.get('level'),
+                'efficiency': k.get('efficiency'),
+                'attainable_gflops': k.get('attainable_gflops'),
+                'gflops': k.get('gflops')
+            }
+            for k in headroom
+        ],
+        'over_roof': over_roof
+    }
+    
+    logger.info(f"屋顶线: 峰值 {report.get('peak_gflops', 0.0):.1f} GFLOP/s, "
+                f"内存带宽 {report.get('dram_gbs', 0.0):.1f} GB/s, "
+                f"脊点 {report.get('ridge_intensity', 0.0):.2f} flop/byte")
+    for k in report['summary']['headroom']:
+        logger.info(f"  {k['name']}: {k['bound']}-bound ({k['level']}), "
+                    f"{k['gflops']:.2f}/{k['attainable_gflops']:.2f} GFLOP/s "
+                    f"({k['efficiency'] * 100:.1f}%)")
+    for name in over_roof:
+        logger.warning(f"  {name}: 实测超过全部屋顶，运算/字节计数或峰值不适用于该内核")
+    return report
+
+def plot_roofline(report: Dict[str, Any], output_path: str) -> bool:
+    """以 matplotlib 绘制屋顶线图 (对数坐标)，未安装 matplotlib 时返回 False
+    
+    每个内核按其工作集所在级别 (level) 着色，并以虚线画出它自己的屋顶
+    min(算力峰值, 强度 x 该级带宽)；INT8 内核的算力峰值为 INT8 屋顶，超过屋顶的内核以 x 标出
+    """
+    try:
+        import matplotlib
+        matplotlib.use('Agg')
+        import matplotlib.pyplot as plt
+    except ImportError:
+        logger.warning("未安装 matplotlib，跳过屋顶线绘图")
+        return False
+    
+    peak = report.get('peak_gflops', 0.0)
+    int8_peak = report.get('peak_int8_gops', 0.0)
+    threads = report.get('context', {}).get('num_threads', 1)
+    intensity = np.logspace(-4, 8, 200, base=2.0)
+    
+    fig, ax = plt.subplots(figsize=(10, 6))
+    level_colors = {}
+    for ceiling in report.get('bandwidth_ceilings', []):
+        if ceiling['threads'] != threads or ceiling['gbs'] <= 0:
+            continue
+        line, = ax.plot(intensity, np.minimum(peak, intensity * ceiling['gbs']),
+                        label=f"{ceiling['level']} {ceiling['gbs']:.1f} GB/s")
+        level_colors[ceiling['level']] = line.get_color()
+    for ceiling in report.get('compute_ceilings', []):
+        if ceiling['threads'] == threads:
+            is_int8 = ceiling.get('kind') == 'int8'
+            ax.axhline(ceiling['gflops'], linestyle='-.' if is_int8 else ':', color='gray')
+            ax.text(intensity[0], ceiling['gflops'],
+                    f" {ceiling['variant']}{' (GOP/s)' if is_int8 else ''}", va='bottom', fontsize=8)
+    for k in report.get('kernels', []):
+        color = level_colors.get(k.get('level'), 'black')
+        roof_gbs = k.get('roof_gbs', 0.0)
+        kernel_peak = k.get('peak_gflops') or (int8_peak if k.get('family') == 'int8_gemm' else peak)
+        if roof_gbs > 0 and kernel_peak > 0:
+            span = k['intensity'] * np.array([0.5, 2.0])
+            ax.plot(span, np.minimum(kernel_peak, span * roof_gbs), '--', color=color, linewidth=0.8)
+        if k.get('over_roof'):
+            marker = 'x'
+        else:
+            marker = 'o' if k.get('bound') == 'memory' else 's'
+        ax.plot(k['intensity'], k['gflops'], marker, color=color, markersize=4)
+        ax.annotate(k['name'], (k['intensity'], k['gflops']), fontsize=6)
+    
+    ax.set_xscale('log', base=2)
+    ax.set_yscale('log')
+    ax.set_xlabel('运算强度 (flop/byte)')
+    ax.set_ylabel('GFLOP/s (INT8: GOP/s)')
+    ax.legend(loc='lower right', fontsize=8)
+    ax.grid(True, which='both', alpha=0.3)
+    fig.tight_layout()
+    fig.savefig(output_path, dpi=150)
+    plt.close(fig)
+    logger.info(f"屋顶线图已保存到: {output_path}")
+    return True
+
+def generate_performance_report(output_path: Optional[str] = None,
+                                roofline_path: Optional[str] = None) -> Dict[str, Any]:
     """生成性能报告
     
     Args:
         output_path: 报告输出路径，如果为None则不保存文件
+        roofline_path: 原生屋顶线工具的输出，提供时汇总到报告的 roofline 字段
         
     Returns:
         Dict[str, Any]: 性能报告数据
@@ -468,6 +582,12 @@ def generate_performance_report(output_path: Optional[str] = None) -> Dict[str,
         }
     }
     
+    if roofline_path:
+        try:
+            report['roofline'] = load_roofline_report(roofline_path)
+        except (OSError, ValueError) as e:
+            logger.error(f"读取屋顶线报告时出错: {str(e)}")
+    
     # 保存报告
     if output_path:
         try:
@@ -491,8 +611,24 @@ def main():
                         help='只运行验证测试')
     parser.add_argument('--avx2', '-a', action='store_true',
                         help='只测试AVX2加速')
+    parser.add_argument('--roofline', type=str, default=None,
+                        help='原生 roofline 工具输出的 JSON，汇总各内核的受限类型与优化空间')
+    parser.add_argument('--roofline-plot', type=str, default=None,
+                        help='屋顶线图输出路径 (需要 matplotlib)')
     args = parser.parse_args()
     
+    # 屋顶线汇总只读取原生工具的输出，不依赖流水线优化模块
+    if (args.roofline and not args.verify and not args.avx2 and
+            not (HAS_PIPELINE_OPT and is_pipeline_opt_available())):
+        try:
+            report = load_roofline_report(args.roofline)
+        except (OSError, ValueError) as e:
+            logger.error(f"读取屋顶线报告时出错: {str(e)}")
+            return 1
+        if args.roofline_plot:
+            plot_roofline(report, args.roofline_plot)
+        return 0
+    
     # 检查流水线优化可用性
     if not HAS_PIPELINE_OPT:
         logger.error("流水线优化模块不可用，无法进行性能验证")
@@ -515,7 +651,9 @@ def main():
         return 0 if all(results.values()) else 1
     
     # 生成完整性能报告
-    generate_performance_report(args.report)
+    report = generate_performance_report(args.report, args.roofline)
+    if args.roofline_plot and 'roofline' in report:
+        plot_roofline(report['roofline'], args.roofline_plot)
     return 0
 
 if __name__ == "__main__":
@@ -0,0 +1,435 @@
+/**
+ * 屋顶线分析工具 - VisionAI-ClipsMaster
+ *
+ * 内核"慢"时需要先判断它受算力还是带宽限制。本工具实测本机的屋顶:
+ *   - 算力: 各指令集变体 (AVX-512/AVX2/基础) 单线程与全部线程的 FMA 峰值，
+ *     以及当前 INT8 GEMM 微内核 (VNNI/AVX2) 的整数乘加峰值
+ *   - 带宽: 工作集分别落在 L1d/L2/L3 与内存时的 STREAM triad 带宽
+ * 再读取 bench_kernels --json 的结果，按每个用例的运算强度 (flops/bytes) 与
+ * 工作集所在的缓存级别求可达性能 min(算力峰值, 强度 x 该级带宽)，
+ * 给出受限类型与实测/可达比例 (比例低的内核仍有优化空间)。INT8 用例按整数乘加计数，
+ * 以 INT8 峰值为算力屋顶；实测仍超过屋顶的用例标为 over_roof (屋顶模型对其不成立)。
+ * 输出 JSON 供 performance_verification.py 读取，控制台打印表格与对数坐标字符图。
+ *
+ * 用法: roofline [--bench=bench.json] [--json=路径|-] [--threads=N] [--no_chart]
+ */
+
+#include "simd_kernels.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <string>
+#include <vector>
+
+namespace {
+
+struct ComputeCeiling {
+    std::string kind;           // "fp32" (FMA) / "int8" (整数乘加)
+    std::string variant;
+    int threads;
+    double gflops;
+};
+
+struct BandwidthCeiling {
+    std::string level;          // "L1d" / "L2" / "L3" / "DRAM"
+    long long bytes;            // 测量时所有线程合计的工作集
+    long long capacity;         // 该级缓存对所有线程的合计容量 (DRAM 为 0)
+    int threads;
+    double gbs;
+};
+
+// bench_kernels 的一个用例 (只取屋顶线需要的字段)
+struct KernelPoint {
+    std::string name;
+    std::string family;
+    double flops;
+    double bytes;
+    double gflops;
+    // 以下由屋顶线计算
+    std::string level;
+    double roof_gbs;
+    double peak;                // 算力屋顶 (INT8 用例为 INT8 峰值)
+    double attainable;
+    bool compute_bound;
+    bool over_roof;             // 实测超过所有可用屋顶
+};
+
+struct Options {
+    std::string bench;
+    std::string json;
+    int threads = 0;
+    bool chart = true;
+};
+
+/**
+ * bench_kernels 的 JSON 每个用例占一行，这里按键名在行内取值，不引入通用 JSON 解析器
+ */
+bool json_string_field(const std::string& line, const char* key, std::string* out) {
+    const std::string pat = std::string("\"") + key + "\": \"";
+    const size_t pos = line.find(pat);
+    if (pos == std::string::npos) {
+        return false;
+    }
+    const size_t begin = pos + pat.size();
+    const size_t end = line.find('"', begin);
+    if (end == std::string::npos) {
+        return false;
+    }
+    *out = line.substr(begin, end - begin);
+    return true;
+}
+
+bool json_number_field(const std::string& line, const char* key, double* out) {
+    const std::string pat = std::string("\"") + key + "\": ";
+    const size_t pos = line.find(pat);
+    if (pos == std::string::npos) {
+        return false;
+    }
+    char* end = nullptr;
+    const double v = strtod(line.c_str() + pos + pat.size(), &end);
+    if (end == line.c_str() + pos + pat.size()) {
+        return false;
+    }
+    *out = v;
+    return true;
+}
+
+bool read_bench(const std::string& path, std::vector<KernelPoint>* points, int* bench_threads) {
+    FILE* f = fopen(path.c_str(), "r");
+    if (!f) {
+        return false;
+    }
+    std::string line;
+    char buf[4096];
+    while (fgets(buf, sizeof(buf), f)) {
+        line += buf;
+        if (line.empty() || line.back() != '\n') {
+            continue;   // 行比缓冲区长，继续拼接
+        }
+        double threads = 0.0;
+        KernelPoint p = {};
+        double real_ns = 0.0;
+        if (json_number_field(line, "num_threads", &threads)) {
+            *bench_threads = (int)threads;
+        } else if (json_string_field(line, "name", &p.name) &&
+                   json_number_field(line, "flops", &p.flops) &&
+                   json_number_field(line, "bytes", &p.bytes) &&
+                   json_number_field(line, "real_time_ns", &real_ns) && real_ns > 0.0 && p.bytes > 0.0) {
+            json_string_field(line, "family", &p.family);
+            p.gflops = p.flops / real_ns;
+            points->push_back(p);
+        }
+        line.clear();
+    }
+    fclose(f);
+    return true;
+}
+
+/**
+ * 带宽屋顶: L1d/L2 按每线程私有容量的一半取工作集 (其余留给代码与栈)；
+ * L3 取 L2 的 4 倍 (不超过 L3 的一半)，服务器上 L3 由大量核心共享，
+ * 按整体容量测量会落到内存；内存为 L3 的 4 倍 (至少 64 MiB，至多 1 GiB)
+ */
+std::vector<BandwidthCeiling> measure_bandwidth(const SimdCacheInfo& cache, int threads) {
+    struct Level { const char* name; long long per_thread; long long total; long long capacity; };
+    const long long l3_set = std::min(cache.l2_size * 4 * std::max(threads, 1), cache.l3_size / 2);
+    const Level levels[] = {
+        {"L1d", cache.l1d_size / 2, 0, cache.l1d_size},
+        {"L2", cache.l2_size / 2, 0, cache.l2_size},
+        {"L3", 0, l3_set, cache.l3_size},
+        {"DRAM", 0, std::min(std::max(cache.l3_size * 4, 64LL << 20), 1LL << 30), 0},
+    };
+    std::vector<int> counts = {1};
+    if (threads > 1) {
+        counts.push_back(threads);
+    }
+    std::vector<BandwidthCeiling> out;
+    for (const Level& level : levels) {
+        for (int t : counts) {
+            const long long bytes = level.per_thread > 0 ? level.per_thread * t : level.total;
+            if (bytes <= 0) {
+                continue;   // 该级缓存未检测到
+            }
+            // 私有缓存的合计容量随线程数增长
+            const long long capacity = level.per_thread > 0 ? level.capacity * t : level.capacity;
+            out.push_back({level.name, bytes, capacity, t, simd_peak_bandwidth(bytes, t)});
+        }
+    }
+    return out;
+}
+
+std::vector<ComputeCeiling> measure_compute(int threads) {
+    const char* variants[] = {"avx512", "avx2", "baseline"};
+    std::vector<ComputeCeiling> out;
+    for (const char* v : variants) {
+        const double single = simd_peak_gflops(v, 1);
+        if (single <= 0.0) {
+            continue;   // CPU 不支持或未编译该变体
+        }
+        out.push_back({"fp32", v, 1, single});
+        if (threads > 1) {
+            out.push_back({"fp32", v, threads, simd_peak_gflops(v, threads)});
+        }
+    }
+    // INT8 只有分发选用的微内核可测
+    const char* int8 = simd_int8_get_variant();
+    const double single = simd_peak_int8_gops(1);
+    if (single > 0.0) {
+        out.push_back({"int8", int8, 1, single});
+        if (threads > 1) {
+            out.push_back({"int8", int8, threads, simd_peak_int8_gops(threads)});
+        }
+    }
+    return out;
+}
+
+bool is_int8(const KernelPoint& p) {
+    return p.family == "int8_gemm";
+}
+
+/**
+ * 工作集 (用例的最少内存流量，基准反复调用时常驻缓存) 能放入的最内层缓存
+ */
+const BandwidthCeiling* level_for(const std::vector<BandwidthCeiling>& bw, double bytes, int threads) {
+    const BandwidthCeiling* best = nullptr;
+    for (const BandwidthCeiling& c : bw) {
+        if (c.threads != threads) {
+            continue;
+        }
+        best = &c;
+        if (bytes <= (double)c.capacity && c.level != "DRAM") {
+            break;
+        }
+    }
+    return best;
+}
+
+/**
+ * 容量只给出驻留级别的下限: 实测超过该级屋顶说明数据实际由更快的一级提供
+ * (如 L2 与 L3 非包含时合计容量更大、只读流没有 triad 的写流量)，
+ * 此时逐级内移到能解释实测值的级别；在 L1d 仍超过屋顶时标为 over_roof
+ */
+void place_kernels(std::vector<KernelPoint>& points, double peak, double int8_peak,
+                   const std::vector<BandwidthCeiling>& bw, int threads) {
+    std::vector<const BandwidthCeiling*> levels;
+    for (const BandwidthCeiling& c : bw) {
+        if (c.threads == threads) {
+            levels.push_back(&c);
+        }
+    }
+    for (KernelPoint& p : points) {
+        const BandwidthCeiling* roof = level_for(bw, p.bytes, threads);
+        const double intensity = p.flops / p.bytes;
+        size_t i = std::find(levels.begin(), levels.end(), roof) - levels.begin();
+        while (roof && i > 0 && p.gflops > intensity * roof->gbs) {
+            roof = levels[--i];
+        }
+        p.peak = is_int8(p) && int8_peak > 0.0 ? int8_peak : peak;
+        p.level = roof ? roof->level : "";
+        p.roof_gbs = roof ? roof->gbs : 0.0;
+        const double memory_roof = intensity * p.roof_gbs;
+        p.compute_bound = !roof || memory_roof >= p.peak;
+        p.attainable = p.compute_bound ? p.peak : memory_roof;
+        p.over_roof = p.attainable > 0.0 && p.gflops > p.attainable;
+    }
+}
+
+/**
+ * 对数坐标字符图: 横轴运算强度 (flop/byte)，纵轴 GFLOP/s；
+ * '-' 为浮点算力屋顶，'=' 为 INT8 算力屋顶 (可内存受限部分沿用 '/')，'/' 为内存带宽屋顶，
+ * 用例以序号 (0-9a-z) 标出
+ */
+void print_chart(FILE* out, const std::vector<KernelPoint>& points, double peak, double int8_peak,
+                 double dram_gbs) {
+    const int W = 72;
+    const int H = 20;
+    const double x_lo = std::log2(1.0 / 16), x_hi = std::log2(256.0);
+    const double y_hi = std::log10(std::max(peak, int8_peak) * 2.0);
+    const double y_lo = y_hi - 4.0;
+    std::vector<std::string> grid(H, std::string(W, ' '));
+    auto row_of = [&](double gflops) {
+        return (int)std::lround((y_hi - std::log10(gflops)) / (y_hi - y_lo) * (H - 1));
+    };
+    for (int x = 0; x < W; ++x) {
+        const double intensity = std::exp2(x_lo + (x_hi - x_lo) * x / (W - 1));
+        if (int8_peak > peak && intensity * dram_gbs > int8_peak) {
+            const int r8 = row_of(int8_peak);
+            if (r8 >= 0 && r8 < H) {
+                grid[r8][x] = '=';
+            }
+        }
+        const double roof = std::min(peak, intensity * dram_gbs);
+        const int r = row_of(roof);
+        if (r >= 0 && r < H) {
+            grid[r][x] = roof < peak ? '/' : '-';
+        }
+    }
+    const char* labels = "0123456789abcdefghijklmnopqrstuvwxyz";
+    for (size_t i = 0; i < points.size(); ++i) {
+        const double intensity = points[i].flops / points[i].bytes;
+        const int x = (int)std::lround((std::log2(intensity) - x_lo) / (x_hi - x_lo) * (W - 1));
+        const int r = row_of(std::max(points[i].gflops, 1e-9));
+        if (x >= 0 && x < W && r >= 0 && r < H) {
+            grid[r][x] = labels[i % 36];
+        }
+    }
+    fprintf(out, "\nGFLOP/s (log)  roof: %.1f GFLOP/s, int8 %.1f GOP/s, DRAM %.1f GB/s\n", peak, int8_peak,
+            dram_gbs);
+    for (int r = 0; r < H; ++r) {
+        const double y = std::pow(10.0, y_hi - (y_hi - y_lo) * r / (H - 1));
+        fprintf(out, "%9.2f |%s\n", y, grid[r].c_str());
+    }
+    fprintf(out, "          +%s\n", std::string(W, '-').c_str());
+    fprintf(out, "           1/16%*s256  flop/byte (log)\n", W - 8, "");
+}
+
+bool write_json(const std::string& path, const SimdCacheInfo& cache, int threads,
+                const std::vector<ComputeCeiling>& compute, const std::vector<BandwidthCeiling>& bw,
+                double peak, double int8_peak, double dram_gbs, const std::vector<KernelPoint>& points) {
+    FILE* f = path == "-" ? stdout : fopen(path.c_str(), "w");
+    if (!f) {
+        return false;
+    }
+    char date[64];
+    const time_t now = time(nullptr);
+    strftime(date, sizeof(date), "%Y-%m-%dT%H:%M:%S", localtime(&now));
+    fprintf(f, "{\n  \"context\": {\"date\": \"%s\", \"variant\": \"%s\", \"num_threads\": %d, "
+            "\"l1d_bytes\": %lld, \"l2_bytes\": %lld, \"l3_bytes\": %lld},\n",
+            date, simd_get_active_variant(), threads, cache.l1d_size, cache.l2_size, cache.l3_size);
+    fprintf(f, "  \"peak_gflops\": %.3f,\n  \"peak_int8_gops\": %.3f,\n  \"dram_gbs\": %.3f,\n"
+            "  \"ridge_intensity\": %.4f,\n",
+            peak, int8_peak, dram_gbs, dram_gbs > 0.0 ? peak / dram_gbs : 0.0);
+    fprintf(f, "  \"compute_ceilings\": [");
+    for (size_t i = 0; i < compute.size(); ++i) {
+        fprintf(f, "%s\n    {\"kind\": \"%s\", \"variant\": \"%s\", \"threads\": %d, \"gflops\": %.3f}",
+                i ? "," : "", compute[i].kind.c_str(), compute[i].variant.c_str(), compute[i].threads,
+                compute[i].gflops);
+    }
+    fprintf(f, "\n  ],\n  \"bandwidth_ceilings\": [");
+    for (size_t i = 0; i < bw.size(); ++i) {
+        fprintf(f, "%s\n    {\"level\": \"%s\", \"bytes\": %lld, \"capacity\": %lld, \"threads\": %d, "
+                "\"gbs\": %.3f}", i ? "," : "", bw[i].level.c_str(), bw[i].bytes, bw[i].capacity,
+                bw[i].threads, bw[i].gbs);
+    }
+    fprintf(f, "\n  ],\n  \"kernels\": [");
+    for (size_t i = 0; i < points.size(); ++i) {
+        const KernelPoint& p = points[i];
+        fprintf(f, "%s\n    {\"name\": \"%s\", \"family\": \"%s\", \"intensity\": %.4f, \"gflops\": %.3f, "
+                "\"bytes\": %.0f, \"level\": \"%s\", \"roof_gbs\": %.3f, \"peak_gflops\": %.3f, "
+                "\"attainable_gflops\": %.3f, \"bound\": \"%s\", \"efficiency\": %.4f, \"over_roof\": %s}",
+                i ? "," : "", p.name.c_str(), p.family.c_str(), p.flops / p.bytes, p.gflops, p.bytes,
+                p.level.c_str(), p.roof_gbs, p.peak, p.attainable, p.compute_bound ? "compute" : "memory",
+                p.attainable > 0.0 ? p.gflops / p.attainable : 0.0, p.over_roof ? "true" : "false");
+    }
+    fprintf(f, "\n  ]\n}\n");
+    return f == stdout ? fflush(f) == 0 : fclose(f) == 0;
+}
+
+const char* option_value(const char* arg, const char* name) {
+    const size_t len = strlen(name);
+    return strncmp(arg, name, len) == 0 && arg[len] == '=' ? arg + len + 1 : nullptr;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    Options opt;
+    for (int i = 1; i < argc; ++i) {
+        const char* v = nullptr;
+        if ((v = option_value(argv[i], "--bench"))) {
+            opt.bench = v;
+        } else if ((v = option_value(argv[i], "--json"))) {
+            opt.json = v;
+        } else if ((v = option_value(argv[i], "--threads"))) {
+            opt.threads = atoi(v);
+        } else if (strcmp(argv[i], "--no_chart") == 0) {
+            opt.chart = false;
+        } else {
+            fprintf(stderr, "usage: %s [--bench=bench.json] [--json=PATH|-] [--threads=N] [--no_chart]\n",
+                    argv[0]);
+            return 2;
+        }
+    }
+
+    // 默认沿用基准运行时的线程数，使屋顶与测量条件一致
+    std::vector<KernelPoint> points;
+    int bench_threads = 0;
+    if (!opt.bench.empty() && !read_bench(opt.bench, &points, &bench_threads)) {
+        fprintf(stderr, "cannot read %s\n", opt.bench.c_str());
+        return 1;
+    }
+    const int requested = opt.threads > 0 ? opt.threads : bench_threads;
+    if (requested > 0) {
+        simd_set_num_threads(requested);
+    }
+    const int threads = simd_get_num_threads();
+
+    FILE* con = opt.json == "-" ? stderr : stdout;
+    SimdCacheInfo cache;
+    simd_get_cache_info(&cache);
+    const std::vector<ComputeCeiling> compute = measure_compute(threads);
+    const std::vector<BandwidthCeiling> bw = measure_bandwidth(cache, threads);
+
+    // 用例按当前分发变体在全部线程上运行，以对应的算力峰值与内存带宽作为主屋顶
+    const std::string active = simd_get_active_variant();
+    double peak = 0.0;
+    double int8_peak = 0.0;
+    for (const ComputeCeiling& c : compute) {
+        if (c.threads != threads) {
+            continue;
+        }
+        if (c.kind == "int8") {
+            int8_peak = c.gflops;
+        } else if (c.variant == active || peak == 0.0) {
+            peak = c.gflops;
+        }
+    }
+    double dram_gbs = 0.0;
+    for (const BandwidthCeiling& c : bw) {
+        if (c.level == "DRAM" && c.threads == threads) {
+            dram_gbs = c.gbs;
+        }
+    }
+    place_kernels(points, peak, int8_peak, bw, threads);
+
+    fprintf(con, "compute ceilings (GFLOP/s, int8: GOP/s):\n");
+    for (const ComputeCeiling& c : compute) {
+        fprintf(con, "  %-4s %-12s %3d thread(s) %10.1f\n", c.kind.c_str(), c.variant.c_str(), c.threads,
+                c.gflops);
+    }
+    fprintf(con, "bandwidth ceilings (GB/s):\n");
+    for (const BandwidthCeiling& c : bw) {
+        fprintf(con, "  %-5s %12lld B %3d thread(s) %10.1f\n", c.level.c_str(), c.bytes, c.threads, c.gbs);
+    }
+    if (!points.empty()) {
+        fprintf(con, "\n%-4s %-34s %9s %9s %9s %-5s %-8s %6s\n", "id", "kernel", "flop/B", "GFLOP/s",
+                "roof", "level", "bound", "eff");
+        const char* labels = "0123456789abcdefghijklmnopqrstuvwxyz";
+        int over = 0;
+        for (size_t i = 0; i < points.size(); ++i) {
+            const KernelPoint& p = points[i];
+            fprintf(con, "%-4c %-34s %9.3f %9.2f %9.2f %-5s %-8s %5.1f%%%s\n", labels[i % 36], p.name.c_str(),
+                    p.flops / p.bytes, p.gflops, p.attainable, p.level.c_str(),
+                    p.compute_bound ? "compute" : "memory",
+                    p.attainable > 0.0 ? 100.0 * p.gflops / p.attainable : 0.0, p.over_roof ? " !" : "");
+            over += p.over_roof ? 1 : 0;
+        }
+        if (over > 0) {
+            fprintf(con, "! %d kernel(s) exceed every roof: flop/byte counts or peaks do not describe them\n",
+                    over);
+        }
+        if (opt.chart && peak > 0.0 && dram_gbs > 0.0) {
+            print_chart(con, points, peak, int8_peak, dram_gbs);
+        }
+    }
+
+    if (!opt.json.empty() && !write_json(opt.json, cache, threads, compute, bw, peak, int8_peak, dram_gbs, points)) {
+        fprintf(stderr, "failed to write %s\n", opt.json.c_str());
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,460 @@
+/**
+ * 对齐内存池与 arena - VisionAI-ClipsMaster
+ *
+ * GEMM 打包面板、注意力与 INT8 激活量化的缓冲区以及包装层的临时数组每次调用都要分配，
+ * 大块 posix_memalign 往往直接走 mmap/munmap，每次都要重新缺页。这里按大小分级缓存
+ * 已释放的块: 每个线程先查自己的缓存 (无锁)，未命中再查全局池 (互斥锁)，都没有时
+ * 才向系统申请；线程缓存超过上限或线程退出时块退回全局池，全局池超过上限的部分还给系统。
+ *
+ * 每个块前有一个对齐单位 (64 字节或 4 KiB) 的前缀，末尾 16 字节记录大小级别与对齐方式，
+ * 释放时据此放回对应的空闲链表。超过最大级别的请求直接向系统申请。
+ * 前缀中的标记在块空闲时改为 BLOCK_FREE_MAGIC，重复释放或释放非池指针时终止进程。
+ * 2 MiB 以上的块映射为透明大页区域 (环境变量 SIMD_HUGEPAGES=0 关闭)；全局池按 NUMA 节点
+ * 分开，块退回分配时所在节点的池；未命中线程缓存时先查本节点的池，再借用其他节点的空闲块
+ * (跨节点访问仍比缺页便宜)，都没有时才向系统申请。
+ *
+ * arena 从池中取 4 KiB 对齐的大块顺序切分，reset 时整体回到起点 (不归还大块)，
+ * 适合流水线每个阶段内的临时张量: 阶段结束一次 reset，下一阶段复用同一批内存。
+ */
+
+#include "simd_kernels.h"
+#include "simd_internal.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <mutex>
+#include <vector>
+
+namespace simd_internal {
+
+namespace {
+
+const uint16_t BLOCK_MAGIC = 0x5341;           // "SA"，使用中
+const uint16_t BLOCK_FREE_MAGIC = 0x4653;      // "SF"，在缓存中或已还给系统
+const int POOL_KINDS = 2;                       // 0: 64 字节对齐，1: 4 KiB 对齐
+const size_t POOL_ALIGN[POOL_KINDS] = {64, 4096};
+
+// 大小级别: 256 B 起每级交替乘 1.5 与 4/3 (即 2 的幂及其 1.5 倍)，最大 256 MiB
+const size_t POOL_MIN_CLASS = 256;
+const size_t POOL_MAX_CLASS = (size_t)256 << 20;
+const int POOL_CLASSES = 41;
+
+// 线程缓存每级最多保留的块数与总字节数，全局池保留的总字节数
+const size_t THREAD_CACHE_BLOCKS = 4;
+const size_t THREAD_CACHE_BYTES = (size_t)64 << 20;
+const size_t GLOBAL_CACHE_BYTES = (size_t)512 << 20;     // 每个节点
+
+// 不小于此大小的块 (含前缀) 映射为透明大页区域
+const size_t POOL_HUGE_BYTES = (size_t)2 << 20;
+
+struct BlockHeader {
+    uint16_t magic;
+    int16_t cls;                // 大小级别，-1 表示超过最大级别、直接向系统申请
+    uint8_t kind;
+    uint8_t region;             // 1 表示大页区域 (region_free 释放)
+    int16_t node;               // 分配时所在的 NUMA 节点
+    uint64_t size;              // 级别大小 (直接申请时为请求大小)
+};
+
+static_assert(sizeof(BlockHeader) == 16, "block header must fit the prefix tail");
+
+size_t class_size(int cls) {
+    // 偶数级为 2 的幂，奇数级为其 1.5 倍
+    const size_t base = POOL_MIN_CLASS << (cls / 2);
+    return (cls & 1) ? base + base / 2 : base;
+}
+
+int size_class(size_t size) {
+    if (size > POOL_MAX_CLASS) {
+        return -1;
+    }
+    int cls = 0;
+    while (class_size(cls) < size) {
+        ++cls;
+    }
+    return cls;
+}
+
+inline BlockHeader* header_of(void* user) {
+    return reinterpret_cast<BlockHeader*>(static_cast<char*>(user) - sizeof(BlockHeader));
+}
+
+struct PoolCounters {
+    std::atomic<long long> bytes_in_use{0};
+    std::atomic<long long> bytes_cached{0};
+    std::atomic<long long> os_allocs{0};
+    std::atomic<long long> cache_hits{0};
+};
+
+PoolCounters& counters() {
+    static PoolCounters* c = new PoolCounters();   // 不析构: 线程退出时仍可能访问
+    return *c;
+}
+
+bool hugepages_enabled() {
+    static const bool enabled = [] {
+        const char* env = getenv("SIMD_HUGEPAGES");
+        return !env || strcmp(env, "0") != 0;
+    }();
+    return enabled;
+}
+
+void* os_alloc(size_t size, int kind, int cls) {
+    const size_t align = POOL_ALIGN[kind];
+    char* raw = nullptr;
+    bool region = false;
+    if (size + align >= POOL_HUGE_BYTES && hugepages_enabled()) {
+        raw = static_cast<char*>(region_alloc(size + align, SIMD_MEM_HUGEPAGE, SIMD_NUMA_DEFAULT, -1));
+        region = raw != nullptr;
+    }
+    if (!raw) {
+        raw = static_cast<char*>(aligned_malloc(size + align, align));
+    }
+    if (!raw) {
+        return nullptr;
+    }
+    counters().os_allocs.fetch_add(1, std::memory_order_relaxed);
+    void* user = raw + align;
+    BlockHeader* h = header_of(user);
+    h->magic = BLOCK_MAGIC;
+    h->cls = (int16_t)cls;
+    h->kind = (uint8_t)kind;
+    h->region = region ? 1 : 0;
+    h->node = (int16_t)numa_current_node();
+    h->size = size;
+    return user;
+}
+
+void os_free(void* user) {
+    const BlockHeader* h = header_of(user);
+    char* raw = static_cast<char*>(user) - POOL_ALIGN[h->kind];
+    if (h->region) {
+        region_free(raw);
+    } else {
+        aligned_free(raw);
+    }
+}
+
+/**
+ * 全局池 (每个 NUMA 节点一个): 各级空闲块链表，由互斥锁保护
+ */
+struct GlobalPool {
+    std::mutex mutex;
+    std::vector<void*> bins[POOL_KINDS][POOL_CLASSES];
+    size_t bytes = 0;
+
+    // 放入空闲块，超过上限时直接还给系统
+    void put(void* user) {
+        const BlockHeader* h = header_of(user);
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (bytes + h->size <= GLOBAL_CACHE_BYTES) {
+                bins[h->kind][h->cls].push_back(user);
+                bytes += h->size;
+                counters().bytes_cached.fetch_add((long long)h->size, std::memory_order_relaxed);
+                return;
+            }
+        }
+        os_free(user);
+    }
+
+    void* take(int kind, int cls) {
+        std::lock_guard<std::mutex> lock(mutex);
+        std::vector<void*>& bin = bins[kind][cls];
+        if (bin.empty()) {
+            return nullptr;
+        }
+        void* user = bin.back();
+        bin.pop_back();
+        const size_t size = class_size(cls);
+        bytes -= size;
+        counters().bytes_cached.fetch_sub((long long)size, std::memory_order_relaxed);
+        return user;
+    }
+
+    void trim() {
+        std::vector<void*> released;
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            for (int k = 0; k < POOL_KINDS; ++k) {
+                for (int c = 0; c < POOL_CLASSES; ++c) {
+                    released.insert(released.end(), bins[k][c].begin(), bins[k][c].end());
+                    bins[k][c].clear();
+                }
+            }
+            counters().bytes_cached.fetch_sub((long long)bytes, std::memory_order_relaxed);
+            bytes = 0;
+        }
+        for (void* user : released) {
+            os_free(user);
+        }
+    }
+};
+
+GlobalPool* global_pools() {
+    static GlobalPool* pools = new GlobalPool[numa_node_count()];   // 不析构: 线程缓存析构时仍要放回
+    return pools;
+}
+
+GlobalPool& global_pool(int node) {
+    return global_pools()[node >= 0 && node < numa_node_count() ? node : 0];
+}
+
+// 先查 node 的池，再依次查其他节点；借出的块释放时仍回到原节点的池
+void* global_take(int node, int kind, int cls) {
+    GlobalPool& local = global_pool(node);
+    if (void* user = local.take(kind, cls)) {
+        return user;
+    }
+    for (int other = 0; other < numa_node_count(); ++other) {
+        GlobalPool& pool = global_pool(other);
+        if (&pool == &local) {
+            continue;
+        }
+        if (void* user = pool.take(kind, cls)) {
+            return user;
+        }
+    }
+    return nullptr;
+}
+
+/**
+ * 线程缓存: 命中时不加锁；线程退出时全部退回全局池
+ */
+struct ThreadCache {
+    std::vector<void*> bins[POOL_KINDS][POOL_CLASSES];
+    size_t bytes = 0;
+
+    ~ThreadCache() { flush(); }
+
+    void* take(int kind, int cls) {
+        std::vector<void*>& bin = bins[kind][cls];
+        if (bin.empty()) {
+            return nullptr;
+        }
+        void* user = bin.back();
+        bin.pop_back();
+        const size_t size = class_size(cls);
+        bytes -= size;
+        counters().bytes_cached.fetch_sub((long long)size, std::memory_order_relaxed);
+        return user;
+    }
+
+    bool put(void* user) {
+        const BlockHeader* h = header_of(user);
+        std::vector<void*>& bin = bins[h->kind][h->cls];
+        if (bin.size() >= THREAD_CACHE_BLOCKS || bytes + h->size > THREAD_CACHE_BYTES) {
+            return false;
+        }
+        bin.push_back(user);
+        bytes += h->size;
+        counters().bytes_cached.fetch_add((long long)h->size, std::memory_order_relaxed);
+        return true;
+    }
+
+    void flush() {
+        for (int k = 0; k < POOL_KINDS; ++k) {
+            for (int c = 0; c < POOL_CLASSES; ++c) {
+                for (void* user : bins[k][c]) {
+                    counters().bytes_cached.fetch_sub((long long)class_size(c), std::memory_order_relaxed);
+                    global_pool(header_of(user)->node).put(user);
+                }
+                bins[k][c].clear();
+            }
+        }
+        bytes = 0;
+    }
+};
+
+thread_local ThreadCache tls_cache;
+
+}  // namespace
+
+void* scratch_alloc(size_t size, size_t alignment) {
+    if (alignment > POOL_ALIGN[POOL_KINDS - 1] || (alignment & (alignment - 1)) != 0) {
+        return nullptr;
+    }
+    const int kind = alignment > POOL_ALIGN[0] ? 1 : 0;
+    const int cls = size_class(std::max<size_t>(size, 1));
+    void* user = nullptr;
+    if (cls >= 0) {
+        user = tls_cache.take(kind, cls);
+        if (!user) {
+            user = global_take(numa_current_node(), kind, cls);
+        }
+        if (user) {
+            header_of(user)->magic = BLOCK_MAGIC;
+            counters().cache_hits.fetch_add(1, std::memory_order_relaxed);
+        } else {
+            user = os_alloc(class_size(cls), kind, cls);
+        }
+    } else {
+        user = os_alloc(size, kind, -1);
+    }
+    if (user) {
+        counters().bytes_in_use.fetch_add((long long)header_of(user)->size, std::memory_order_relaxed);
+    }
+    return user;
+}
+
+void scratch_free(void* ptr) {
+    if (!ptr) {
+        return;
+    }
+    BlockHeader* h = header_of(ptr);
+    if (h->magic != BLOCK_MAGIC) {
+        // 继续执行会把同一块放进空闲链表两次或按伪造的前缀释放，之后的错误难以追查
+        fprintf(stderr, "simd_pool_free: %p %s\n", ptr,
+                h->magic == BLOCK_FREE_MAGIC ? "was already freed" : "was not allocated by the pool");
+        abort();
+    }
+    h->magic = BLOCK_FREE_MAGIC;
+    counters().bytes_in_use.fetch_sub((long long)h->size, std::memory_order_relaxed);
+    if (h->cls < 0) {
+        os_free(ptr);
+        return;
+    }
+    if (!tls_cache.put(ptr)) {
+        global_pool(h->node).put(ptr);
+    }
+}
+
+}  // namespace simd_internal
+
+/**
+ * arena: 从池中取大块顺序切分，reset 后从第一个大块重新开始
+ */
+struct SimdArena {
+    struct Chunk {
+        char* data;
+        size_t size;
+    };
+    std::mutex mutex;
+    size_t chunk_bytes;
+    std::vector<Chunk> chunks;
+    size_t current;             // 正在切分的大块
+    size_t offset;              // 当前大块内已用字节数
+    size_t used;                // 自上次 reset 以来分配的字节数 (含对齐填充)
+    size_t peak;
+};
+
+void* simd_pool_alloc(long long size, int alignment) {
+    if (size < 0) {
+        return nullptr;
+    }
+    return simd_internal::scratch_alloc((size_t)size, alignment > 0 ? (size_t)alignment : 64);
+}
+
+void simd_pool_free(void* ptr) {
+    simd_internal::scratch_free(ptr);
+}
+
+void simd_pool_trim(void) {
+    using namespace simd_internal;
+    tls_cache.flush();
+    for (int node = 0; node < numa_node_count(); ++node) {
+        global_pool(node).trim();
+    }
+}
+
+void simd_pool_stats(SimdPoolStats* stats) {
+    if (!stats) {
+        return;
+    }
+    simd_internal::PoolCounters& c = simd_internal::counters();
+    stats->bytes_in_use = c.bytes_in_use.load(std::memory_order_relaxed);
+    stats->bytes_cached = c.bytes_cached.load(std::memory_order_relaxed);
+    stats->os_allocs = c.os_allocs.load(std::memory_order_relaxed);
+    stats->cache_hits = c.cache_hits.load(std::memory_order_relaxed);
+}
+
+SimdArena* simd_arena_create(long long chunk_bytes) {
+    SimdArena* arena = new SimdArena();
+    arena->chunk_bytes = chunk_bytes > 0 ? (size_t)chunk_bytes : (size_t)4 << 20;
+    arena->current = 0;
+    arena->offset = 0;
+    arena->used = 0;
+    arena->peak = 0;
+    return arena;
+}
+
+void simd_arena_destroy(SimdArena* arena) {
+    if (!arena) {
+        return;
+    }
+    for (const SimdArena::Chunk& c : arena->chunks) {
+        simd_internal::scratch_free(c.data);
+    }
+    delete arena;
+}
+
+void* simd_arena_alloc(SimdArena* arena, long long size, int alignment) {
+    if (!arena || size < 0) {
+        return nullptr;
+    }
+    const size_t align = alignment > 0 ? (size_t)alignment : 64;
+    if (align > 4096 || (align & (align - 1)) != 0) {
+        return nullptr;
+    }
+    const size_t bytes = std::max<size_t>((size_t)size, 1);
+    std::lock_guard<std::mutex> lock(arena->mutex);
+    // 依次尝试当前及 reset 前留下的大块，都放不下时新取一个
+    while (arena->current < arena->chunks.size()) {
+        const SimdArena::Chunk& c = arena->chunks[arena->current];
+        const size_t begin = (arena->offset + align - 1) & ~(align - 1);
+        if (begin + bytes <= c.size) {
+            arena->used += begin + bytes - arena->offset;
+            arena->offset = begin + bytes;
+            arena->peak = std::max(arena->peak, arena->used);
+            return c.data + begin;
+        }
+        ++arena->current;
+        arena->offset = 0;
+    }
+    const size_t chunk_size = std::max(arena->chunk_bytes, bytes);
+    char* data = static_cast<char*>(simd_internal::scratch_alloc(chunk_size, 4096));
+    if (!data) {
+        return nullptr;
+    }
+    arena->chunks.push_back({data, chunk_size});
+    arena->current = arena->chunks.size() - 1;
+    arena->offset = bytes;
+    arena->used += bytes;
+    arena->peak = std::max(arena->peak, arena->used);
+    return data;
+}
+
+void simd_arena_reset(SimdArena* arena) {
+    if (!arena) {
+        return;
+    }
+    std::lock_guard<std::mutex> lock(arena->mutex);
+    arena->current = 0;
+    arena->offset = 0;
+    arena->used = 0;
+}
+
+void simd_arena_stats(const SimdArena* arena, long long* used, long long* reserved, long long* peak) {
+    if (!arena) {
+        return;
+    }
+    SimdArena* a = const_cast<SimdArena*>(arena);
+    std::lock_guard<std::mutex> lock(a->mutex);
+    size_t total = 0;
+    for (const SimdArena::Chunk& c : a->chunks) {
+        total += c.size;
+    }
+    if (used) {
+        *used = (long long)a->used;
+    }
+    if (reserved) {
+        *reserved = (long long)total;
+    }
+    if (peak) {
+        *peak = (long long)a->peak;
+    }
+}
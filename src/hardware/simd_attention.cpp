@@ -0,0 +1,345 @@
+/**
+ * 融合注意力 (flash attention) - VisionAI-ClipsMaster
+ *
+ * 逐个调用 GEMM 与 softmax 时要先写出 [n_q, n_kv] 的完整分数矩阵，内存随序列长度
+ * 二次增长。这里按 (键值头, 查询行块) 划分任务，每个任务在线程私有缓冲区内
+ * 逐个键值块计算 S = scale * Q K^T、在线更新每行的最大值 m 与归一化因子 l，
+ * 并把 P V 累加到输出块，所有中间结果都限制在一个分块内 (驻留 L2)。
+ * 两次矩阵乘直接调用 GEMM 微内核；同一键值头下的查询头 (GQA) 叠放为行，
+ * 共享 K/V 面板的打包。行数不足微内核 MR 时 (解码，n_q = 1 且分组较小)
+ * 打包与补齐的开销超过计算本身，改为 GEMV 求分数、逐行加权累加 V。
+ * 键值来源抽象为逐块读取: 连续张量直接给出指针，分页 KV 缓存按块表给出块内指针
+ * (分块不跨越缓存块)，量化缓存先反量化到线程私有缓冲区。
+ */
+
+#include "simd_kernels.h"
+#include "simd_internal.h"
+
+#include <algorithm>
+#include <climits>
+#include <cmath>
+#include <cstring>
+
+namespace simd_internal {
+
+// 每个任务的查询行数与每个键值块的键数 (分别向上取整到微内核的 MR/NR)
+static const int ATTN_BLOCK_Q = 64;
+static const int ATTN_BLOCK_KV = 128;
+
+namespace {
+
+inline int round_up(int x, int m) {
+    return (x + m - 1) / m * m;
+}
+
+inline size_t round_up16(size_t n) {
+    return (n + 15) & ~(size_t)15;
+}
+
+/**
+ * 一次调用内不变的分块参数与线程私有缓冲区布局 (各段按 64 字节对齐)
+ */
+struct AttentionPlan {
+    const SimdAttentionParams* p;
+    const SgemmKernelInfo* gemm;
+    const ReduceKernels* reduce;
+    const TransformerKernels* tk;
+    scale_kernel_fn scale_fn;
+    gemv_fn gemv;
+    int group;              // 每个键值头对应的查询头数
+    int br;                 // 每个任务的查询行数
+    int bc;                 // 每个键值块的键数
+    int br_pad;
+    int bc_pad;
+    int d_pad;
+    size_t off_q, off_ap, off_kp, off_s, off_pp, off_vp, off_o, off_m, off_l, off_kd, off_vd, stride;
+};
+
+/**
+ * 一个键值块: 位置 [j0, j0 + len) 的 K/V 行 (行距以元素计)
+ */
+struct KvTile {
+    const float* k;
+    const float* v;
+    int ldk;
+    int ldv;
+    int len;
+};
+
+// 连续存储的 K/V 张量 (步长见 SimdAttentionParams)
+struct DenseKv {
+    const SimdAttentionParams* p;
+    const float* K;
+    const float* V;
+
+    KvTile tile(int kv_head, int j0, int len, float*, float*) const {
+        return {K + kv_head * p->k_head_stride + j0 * p->k_token_stride,
+                V + kv_head * p->v_head_stride + j0 * p->v_token_stride,
+                (int)p->k_token_stride, (int)p->v_token_stride, len};
+    }
+};
+
+// 分页 KV 缓存: 分块截断到缓存块边界
+struct PagedKv {
+    KvCacheView view;
+
+    KvTile tile(int kv_head, int j0, int len, float* kbuf, float* vbuf) const {
+        len = std::min(len, view.block_size - j0 % view.block_size);
+        return {kv_cache_rows(view, 0, kv_head, j0, len, kbuf),
+                kv_cache_rows(view, 1, kv_head, j0, len, vbuf),
+                view.head_dim, view.head_dim, len};
+    }
+};
+
+AttentionPlan make_plan(const SimdAttentionParams* p, bool dequant) {
+    const SimdDispatchTable& table = dispatch_table();
+    AttentionPlan plan;
+    plan.p = p;
+    plan.gemm = table.sgemm;
+    plan.reduce = table.reduce;
+    plan.tk = table.transformer;
+    plan.scale_fn = table.vector_scale;
+    plan.gemv = table.gemv->f32;
+    plan.group = p->n_heads / p->n_kv_heads;
+
+    const int mr = plan.gemm->mr;
+    const int nr = plan.gemm->nr;
+    const int d = p->head_dim;
+    const int rows = plan.group * p->n_q;
+    plan.br = std::min(round_up(ATTN_BLOCK_Q, mr), round_up(std::max(rows, 1), mr));
+    plan.bc = std::min(round_up(ATTN_BLOCK_KV, nr), round_up(std::max(p->n_kv, 1), nr));
+    plan.br_pad = plan.br;
+    plan.bc_pad = plan.bc;
+    plan.d_pad = round_up(d, nr);
+
+    size_t off = 0;
+    const auto take = [&off](size_t n) {
+        const size_t at = off;
+        off += round_up16(n);
+        return at;
+    };
+    plan.off_q = take((size_t)plan.br * d);
+    plan.off_ap = take((size_t)plan.br_pad * d);
+    plan.off_kp = take((size_t)plan.bc_pad * d);
+    plan.off_s = take((size_t)plan.br_pad * plan.bc_pad);
+    plan.off_pp = take((size_t)plan.br_pad * plan.bc);
+    plan.off_vp = take((size_t)plan.bc * plan.d_pad);
+    plan.off_o = take((size_t)plan.br_pad * plan.d_pad);
+    plan.off_m = take((size_t)plan.br);
+    plan.off_l = take((size_t)plan.br);
+    plan.off_kd = take(dequant ? (size_t)plan.bc * d : 0);
+    plan.off_vd = take(dequant ? (size_t)plan.bc * d : 0);
+    plan.stride = off;
+    return plan;
+}
+
+/**
+ * 计算键值头 kv_head 的查询行 [r0, r1)，行 r 对应位置 r / group、查询头 kv_head * group + r % group
+ * (按位置优先排列，使因果掩码下同一行块的可见范围接近)
+ */
+template <typename Kv>
+void attention_block(const AttentionPlan& plan, const float* Q, const Kv& kv, float* O,
+                     int kv_head, int r0, int r1, float* scratch) {
+    const SimdAttentionParams& p = *plan.p;
+    const SgemmKernelInfo* gemm = plan.gemm;
+    const int mr = gemm->mr;
+    const int nr = gemm->nr;
+    const int d = p.head_dim;
+    const int rows = r1 - r0;
+    const bool vec = rows < mr;
+    const int causal_shift = p.n_kv - p.n_q;
+    const float scale = p.scale != 0.0f ? p.scale : 1.0f / std::sqrt((float)d);
+    const SgemmEpilogue score_ep = {scale, 0.0f, nullptr, SIMD_ACT_NONE, nullptr, 0};
+    const SgemmEpilogue accum_ep = {1.0f, 1.0f, nullptr, SIMD_ACT_NONE, nullptr, 0};
+
+    float* q = scratch + plan.off_q;
+    float* ap = scratch + plan.off_ap;
+    float* kp = scratch + plan.off_kp;
+    float* s = scratch + plan.off_s;
+    float* pp = scratch + plan.off_pp;
+    float* vp = scratch + plan.off_vp;
+    float* o = scratch + plan.off_o;
+    float* m = scratch + plan.off_m;
+    float* l = scratch + plan.off_l;
+    float* kd = scratch + plan.off_kd;
+    float* vd = scratch + plan.off_vd;
+
+    for (int r = 0; r < rows; ++r) {
+        const int row = r0 + r;
+        const int h = kv_head * plan.group + row % plan.group;
+        memcpy(q + (size_t)r * d, Q + (row / plan.group) * p.q_token_stride + h * p.q_head_stride,
+               (size_t)d * sizeof(float));
+        if (vec) {
+            plan.scale_fn(q + (size_t)r * d, scale, d);
+        }
+        m[r] = -INFINITY;
+        l[r] = 0.0f;
+    }
+    if (!vec) {
+        sgemm_pack_a(rows, d, q, d, 0, mr, ap);
+    }
+    memset(o, 0, (size_t)plan.br_pad * plan.d_pad * sizeof(float));
+
+    // 因果掩码下整个行块都看不到的键值块直接跳过
+    int kv_end = p.n_kv;
+    if (p.causal) {
+        kv_end = std::min(p.n_kv, std::max(0, (r1 - 1) / plan.group + causal_shift + 1));
+    }
+
+    for (int j0 = 0; j0 < kv_end;) {
+        const KvTile t = kv.tile(kv_head, j0, std::min(plan.bc, kv_end - j0), kd, vd);
+        const int bc = t.len;
+
+        // S = scale * Q K^T (K 按行存储，即 K^T 的转置形式；GEMV 路径的 q 已预先缩放)
+        if (vec) {
+            for (int r = 0; r < rows; ++r) {
+                const GemvArgs args = {t.k, (size_t)t.ldk, nullptr, 0,
+                                       q + (size_t)r * d, nullptr, s + (size_t)r * plan.bc_pad, d};
+                plan.gemv(args, 0, bc);
+            }
+        } else {
+            sgemm_pack_b(d, bc, t.k, t.ldk, 1, nr, kp);
+            for (int jj = 0; jj < bc; jj += nr) {
+                for (int ii = 0; ii < rows; ii += mr) {
+                    gemm->kernel(d, ap + (size_t)ii * d, kp + (size_t)jj * d,
+                                 s + (size_t)ii * plan.bc_pad + jj, plan.bc_pad, score_ep);
+                }
+            }
+        }
+
+        // 在线 softmax: P = exp(S - m_new) 写回 S，按 exp(m_old - m_new) 缩放已有的 l 与 O
+        for (int r = 0; r < rows; ++r) {
+            float* srow = s + (size_t)r * plan.bc_pad;
+            int valid = bc;
+            if (p.causal) {
+                valid = std::min(bc, (r0 + r) / plan.group + causal_shift - j0 + 1);
+            }
+            if (valid <= 0) {
+                memset(srow, 0, (size_t)bc * sizeof(float));
+                continue;
+            }
+            const float m_new = std::max(m[r], plan.reduce->max(srow, valid));
+            const float sum = plan.tk->exp_sum(srow, srow, valid, 1.0f, m_new);
+            if (valid < bc) {
+                memset(srow + valid, 0, (size_t)(bc - valid) * sizeof(float));
+            }
+            if (l[r] > 0.0f && m_new != m[r]) {
+                const float alpha = std::exp(m[r] - m_new);
+                l[r] *= alpha;
+                plan.scale_fn(o + (size_t)r * plan.d_pad, alpha, d);
+            }
+            l[r] += sum;
+            m[r] = m_new;
+        }
+
+        // O += P V
+        if (vec) {
+            for (int r = 0; r < rows; ++r) {
+                plan.tk->weighted_rows(t.v, (size_t)t.ldv, s + (size_t)r * plan.bc_pad, bc,
+                                       o + (size_t)r * plan.d_pad, d);
+            }
+        } else {
+            sgemm_pack_a(rows, bc, s, plan.bc_pad, 0, mr, pp);
+            sgemm_pack_b(bc, d, t.v, t.ldv, 0, nr, vp);
+            for (int jj = 0; jj < d; jj += nr) {
+                for (int ii = 0; ii < rows; ii += mr) {
+                    gemm->kernel(bc, pp + (size_t)ii * bc, vp + (size_t)jj * bc,
+                                 o + (size_t)ii * plan.d_pad + jj, plan.d_pad, accum_ep);
+                }
+            }
+        }
+        j0 += bc;
+    }
+
+    for (int r = 0; r < rows; ++r) {
+        const int row = r0 + r;
+        const int h = kv_head * plan.group + row % plan.group;
+        float* out = O + (row / plan.group) * p.o_token_stride + h * p.o_head_stride;
+        if (l[r] > 0.0f) {
+            plan.tk->norm_apply(o + (size_t)r * plan.d_pad, nullptr, nullptr, out, d,
+                                0.0f, 1.0f / l[r]);
+        } else {
+            std::fill(out, out + d, 0.0f);
+        }
+    }
+}
+
+bool valid_params(const SimdAttentionParams* p) {
+    return p && p->n_q >= 0 && p->n_kv >= 0 && p->head_dim > 0 && p->n_heads > 0 &&
+           p->n_kv_heads > 0 && p->n_heads % p->n_kv_heads == 0 &&
+           p->k_token_stride > 0 && p->k_token_stride <= INT_MAX &&
+           p->v_token_stride > 0 && p->v_token_stride <= INT_MAX &&
+           (long long)p->n_heads * p->n_q <= INT_MAX && std::isfinite(p->scale);
+}
+
+/**
+ * 按 (键值头, 查询行块) 切分任务并行计算，每个线程一份私有缓冲区
+ */
+template <typename Kv>
+int run_attention(const SimdAttentionParams* params, const float* Q, const Kv& kv, float* O,
+                  bool dequant) {
+    const SimdAttentionParams& p = *params;
+    const AttentionPlan plan = make_plan(params, dequant);
+    const int rows = plan.group * p.n_q;
+    const int blocks = (rows + plan.br - 1) / plan.br;
+    const int n_tasks = p.n_kv_heads * blocks;
+    const int nthreads = std::min(thread_pool_size(), n_tasks);
+    float* scratch = static_cast<float*>(scratch_alloc(plan.stride * nthreads * sizeof(float)));
+    if (!scratch) {
+        return -2;
+    }
+    parallel_for(n_tasks, nthreads, [&](int task, int tid) {
+        const int kv_head = task / blocks;
+        const int r0 = (task % blocks) * plan.br;
+        attention_block(plan, Q, kv, O, kv_head, r0, std::min(rows, r0 + plan.br),
+                        scratch + plan.stride * tid);
+    });
+    scratch_free(scratch);
+    return 0;
+}
+
+}  // namespace
+
+}  // namespace simd_internal
+
+int simd_attention(const SimdAttentionParams* params, const float* Q, const float* K,
+                   const float* V, float* O) {
+    using namespace simd_internal;
+    if (!valid_params(params)) {
+        return -1;
+    }
+    if (params->n_q == 0) {
+        return 0;
+    }
+    if (!Q || !O || (params->n_kv > 0 && (!K || !V))) {
+        return -1;
+    }
+    const DenseKv kv = {params, K, V};
+    return run_attention(params, Q, kv, O, false);
+}
+
+int simd_attention_paged(const SimdAttentionParams* params, const float* Q,
+                         const SimdKvCache* cache, int seq, int layer, float* O) {
+    using namespace simd_internal;
+    PagedKv kv;
+    if (!params || !kv_cache_view(cache, seq, layer, 0, -1, &kv.view) ||
+        params->head_dim != kv.view.head_dim || params->n_kv_heads != kv.view.n_kv_heads) {
+        return -1;
+    }
+    SimdAttentionParams p = *params;
+    p.n_kv = kv.view.n_tokens;
+    p.k_token_stride = p.v_token_stride = p.head_dim;
+    p.k_head_stride = p.v_head_stride = 0;
+    if (!valid_params(&p)) {
+        return -1;
+    }
+    if (p.n_q == 0) {
+        return 0;
+    }
+    if (!Q || !O) {
+        return -1;
+    }
+    const int status = run_attention(&p, Q, kv, O, kv.view.quantized);
+    // 计算期间序列被释放时块可能已被其他序列改写
+    return status == 0 && !kv_cache_view_current(kv.view) ? -1 : status;
+}
@@ -0,0 +1,486 @@
+/**
+ * GEMM 自动调优 - VisionAI-ClipsMaster
+ *
+ * 按缓存拓扑推导的分块只是起点: 不同节点偏好的微内核 (AVX-512 降频时 AVX2 可能更快)、
+ * 分块与参与线程数 (SMT 兄弟线程共享 L1/L2) 需要实测。simd_autotune 在代表性形状上
+ * 对每个候选微内核依次沿 kc、mc、nc 做坐标搜索，再比较只用一半线程的情形，
+ * 胜者按 CPU 签名写入调优文件；之后分发表默认内核的 GEMM 直接使用调优记录。
+ *
+ * 调优文件为文本，每行一条记录 (签名不含空白):
+ *   签名 变体 线程池大小 微内核 mc kc nc 线程数 GFLOP/s
+ * 变体与线程池大小也是键的一部分，SIMD_FORCE_VARIANT 或 simd_set_num_threads 改变后
+ * 自动改用对应的记录 (没有时回到推导值)。
+ * 记录表以只读快照发布，每次 GEMM 查询时无锁读取；只有加载、调优时才在锁内替换快照。
+ */
+
+#include "simd_kernels.h"
+#include "simd_internal.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#if defined(_WIN32)
+    #include <direct.h>
+#else
+    #include <sys/stat.h>
+#endif
+
+namespace simd_internal {
+
+// 候选配置须比当前最优快这么多才被采纳 (抵消测量噪声，平局时保留推导值)
+static const double TUNE_MIN_GAIN = 1.03;
+
+// 每个形状预热一次后取 TUNE_REPEATS 次中最快的一次
+static const int TUNE_REPEATS = 3;
+
+// 代表性形状 (M, N, K): 中等方阵、解码批次 (小 M 大权重) 与较大方阵
+static const int TUNE_SHAPES[][3] = {{512, 512, 512}, {64, 2048, 2048}, {1024, 1024, 1024}};
+
+namespace {
+
+struct TuningRecord {
+    std::string variant;
+    int pool;
+    std::string kernel;
+    SgemmBlocking blk;
+    int threads;
+    double gflops;
+};
+
+typedef std::vector<TuningRecord> RecordTable;
+
+struct TuningState {
+    std::atomic<const RecordTable*> published{nullptr};    // records 的最新快照，加载前为空
+    std::mutex mutex;                   // 保护以下字段
+    bool loaded = false;
+    RecordTable records;                // 调优文件中与本机签名匹配的记录
+    std::vector<int> auto_tried;        // 已自动调优过的线程池大小
+    // 发布过的快照保留到进程退出 (读者不持锁，无法确定何时不再使用；只在调优时新增)
+    std::vector<std::unique_ptr<const RecordTable>> snapshots;
+    std::mutex tune_mutex;              // 串行化测量
+};
+
+TuningState& tuning_state() {
+    static TuningState state;
+    return state;
+}
+
+// SIMD_AUTOTUNE: "0" 不读取调优文件也不自动调优，"1" 没有记录时自动调优，未设置时只读取
+int autotune_mode() {
+    const char* env = getenv("SIMD_AUTOTUNE");
+    if (!env || !*env) {
+        return -1;
+    }
+    return atoi(env) != 0 ? 1 : 0;
+}
+
+std::string default_tuning_file() {
+    const char* env = getenv("SIMD_TUNING_FILE");
+    if (env && *env) {
+        return env;
+    }
+#if defined(_WIN32)
+    const char* base = getenv("LOCALAPPDATA");
+    const std::string dir = base && *base ? base : "";
+#else
+    const char* xdg = getenv("XDG_CACHE_HOME");
+    const char* home = getenv("HOME");
+    const std::string dir = xdg && *xdg ? xdg : (home && *home ? std::string(home) + "/.cache" : "");
+#endif
+    return dir.empty() ? "" : dir + "/visionai_clipsmaster/simd_tuning.txt";
+}
+
+const std::string& tuning_file() {
+    static const std::string path = default_tuning_file();
+    return path;
+}
+
+void make_parent_dirs(const std::string& path) {
+    for (size_t pos = path.find_first_of("/\\", 1); pos != std::string::npos;
+         pos = path.find_first_of("/\\", pos + 1)) {
+        const std::string dir = path.substr(0, pos);
+#if defined(_WIN32)
+        _mkdir(dir.c_str());
+#else
+        mkdir(dir.c_str(), 0755);
+#endif
+    }
+}
+
+bool parse_record(const char* line, std::string* sig, TuningRecord* rec) {
+    char sig_buf[256], variant[32], kernel[32];
+    if (sscanf(line, "%255s %31s %d %31s %d %d %d %d %lf", sig_buf, variant, &rec->pool, kernel,
+               &rec->blk.mc, &rec->blk.kc, &rec->blk.nc, &rec->threads, &rec->gflops) != 9 ||
+        sig_buf[0] == '#') {
+        return false;
+    }
+    *sig = sig_buf;
+    rec->variant = variant;
+    rec->kernel = kernel;
+    return true;
+}
+
+void read_records(RecordTable* records) {
+    if (autotune_mode() == 0 || tuning_file().empty()) {
+        return;
+    }
+    FILE* f = fopen(tuning_file().c_str(), "r");
+    if (!f) {
+        return;
+    }
+    char line[512];
+    std::string sig;
+    TuningRecord rec;
+    while (fgets(line, sizeof(line), f)) {
+        if (parse_record(line, &sig, &rec) && sig == cpu_signature()) {
+            records->push_back(rec);
+        }
+    }
+    fclose(f);
+}
+
+// 以下两个函数须持有 st.mutex
+void publish(TuningState& st) {
+    st.snapshots.emplace_back(new RecordTable(st.records));
+    st.published.store(st.snapshots.back().get(), std::memory_order_release);
+}
+
+void ensure_loaded(TuningState& st) {
+    if (st.loaded) {
+        return;
+    }
+    st.loaded = true;
+    read_records(&st.records);
+    publish(st);
+}
+
+const TuningRecord* find_record(const RecordTable& records, const char* variant, int pool) {
+    for (const TuningRecord& rec : records) {
+        if (rec.variant == variant && rec.pool == pool) {
+            return &rec;
+        }
+    }
+    return nullptr;
+}
+
+/**
+ * 替换文件中同键的记录后整体重写 (先写临时文件再改名，其他签名的记录原样保留)
+ */
+bool save_record(const TuningRecord& rec) {
+    const std::string& path = tuning_file();
+    if (path.empty()) {
+        return false;
+    }
+    std::vector<std::string> lines;
+    if (FILE* f = fopen(path.c_str(), "r")) {
+        char line[512];
+        std::string sig;
+        TuningRecord old;
+        while (fgets(line, sizeof(line), f)) {
+            if (parse_record(line, &sig, &old) && sig == cpu_signature() &&
+                old.variant == rec.variant && old.pool == rec.pool) {
+                continue;
+            }
+            if (line[0] != '#' && line[0] != '\n') {
+                lines.push_back(line);
+            }
+        }
+        fclose(f);
+    }
+    char entry[512];
+    snprintf(entry, sizeof(entry), "%s %s %d %s %d %d %d %d %.1f\n", cpu_signature(),
+             rec.variant.c_str(), rec.pool, rec.kernel.c_str(), rec.blk.mc, rec.blk.kc,
+             rec.blk.nc, rec.threads, rec.gflops);
+    lines.push_back(entry);
+
+    make_parent_dirs(path);
+    const std::string tmp = path + ".tmp";
+    FILE* f = fopen(tmp.c_str(), "w");
+    if (!f) {
+        return false;
+    }
+    bool ok = fputs("# 签名 变体 线程池大小 微内核 mc kc nc 线程数 GFLOP/s\n", f) >= 0;
+    for (const std::string& line : lines) {
+        ok = ok && fputs(line.c_str(), f) >= 0;
+    }
+    ok = (fclose(f) == 0) && ok;
+#if defined(_WIN32)
+    remove(path.c_str());
+#endif
+    if (!ok || rename(tmp.c_str(), path.c_str()) != 0) {
+        remove(tmp.c_str());
+        return false;
+    }
+    return true;
+}
+
+/**
+ * 候选微内核: 分发表默认内核，以及 AVX-512 节点上的 AVX2 内核
+ */
+std::vector<const SgemmKernelInfo*> kernel_candidates() {
+    const SgemmKernelInfo* active = dispatch_table().sgemm;
+    std::vector<const SgemmKernelInfo*> kernels(1, active);
+    const SgemmKernelInfo* avx2 = sgemm_kernel_avx2();
+    if (avx2 && avx2 != active && strcmp(active->name, "avx512") == 0 && cpu_has_avx2_fma()) {
+        kernels.push_back(avx2);
+    }
+    return kernels;
+}
+
+const SgemmKernelInfo* kernel_by_name(const std::string& name) {
+    for (const SgemmKernelInfo* info : kernel_candidates()) {
+        if (name == info->name) {
+            return info;
+        }
+    }
+    return nullptr;
+}
+
+struct TuneBuffers {
+    std::vector<float> A;
+    std::vector<float> B;
+    std::vector<float> C;
+
+    TuneBuffers() {
+        size_t a = 0, b = 0, c = 0;
+        for (const auto& s : TUNE_SHAPES) {
+            a = std::max(a, (size_t)s[0] * s[2]);
+            b = std::max(b, (size_t)s[2] * s[1]);
+            c = std::max(c, (size_t)s[0] * s[1]);
+        }
+        A.resize(a);
+        B.resize(b);
+        C.resize(c);
+        for (size_t i = 0; i < a; ++i) A[i] = (float)(i % 17) * 0.0625f - 0.5f;
+        for (size_t i = 0; i < b; ++i) B[i] = (float)(i % 13) * 0.0625f - 0.375f;
+    }
+};
+
+/**
+ * 代表性形状上的几何平均吞吐 (GFLOP/s)
+ */
+double measure(const SgemmConfig& cfg, TuneBuffers& buf) {
+    typedef std::chrono::steady_clock Clock;
+    double log_sum = 0.0;
+    for (const auto& s : TUNE_SHAPES) {
+        const int M = s[0], N = s[1], K = s[2];
+        double best = 0.0;
+        for (int r = 0; r <= TUNE_REPEATS; ++r) {
+            const Clock::time_point t0 = Clock::now();
+            sgemm_blocked_config(cfg, SIMD_GEMM_NO_TRANS, SIMD_GEMM_NO_TRANS, M, N, K,
+                                 buf.A.data(), K, buf.B.data(), N, buf.C.data(), N, nullptr);
+            const double sec = std::chrono::duration<double>(Clock::now() - t0).count();
+            if (r > 0 && sec > 0.0) {
+                best = std::max(best, 2.0 * M * N * K / sec * 1e-9);
+            }
+        }
+        log_sum += std::log(std::max(best, 1e-3));
+    }
+    return std::exp(log_sum / (double)(sizeof(TUNE_SHAPES) / sizeof(TUNE_SHAPES[0])));
+}
+
+// 按 factor 缩放第 dim 个分块维度 (0: kc, 1: mc, 2: nc)，对齐到各自的粒度
+SgemmBlocking scale_blocking(const SgemmBlocking& blk, int dim, double factor,
+                             const SgemmKernelInfo* info) {
+    SgemmBlocking out = blk;
+    if (dim == 0) {
+        out.kc = std::min(2048, std::max(64, (int)(blk.kc * factor) / 16 * 16));
+    } else if (dim == 1) {
+        out.mc = std::max(info->mr, (int)(blk.mc * factor) / info->mr * info->mr);
+    } else {
+        out.nc = std::max(info->nr, (int)(blk.nc * factor) / info->nr * info->nr);
+    }
+    return out;
+}
+
+bool same_blocking(const SgemmBlocking& a, const SgemmBlocking& b) {
+    return a.mc == b.mc && a.kc == b.kc && a.nc == b.nc;
+}
+
+SgemmConfig tune_kernel(const SgemmKernelInfo* info, int pool, TuneBuffers& buf, double* score) {
+    static const double factors[] = {0.5, 0.75, 1.5, 2.0};
+    SgemmConfig best = {info, sgemm_blocking(info), 0};
+    double best_score = measure(best, buf);
+    for (int dim = 0; dim < 3; ++dim) {
+        const SgemmBlocking base = best.blk;
+        for (double f : factors) {
+            SgemmConfig trial = best;
+            trial.blk = scale_blocking(base, dim, f, info);
+            if (same_blocking(trial.blk, base)) {
+                continue;
+            }
+            const double s = measure(trial, buf);
+            if (s > best_score * TUNE_MIN_GAIN) {
+                best = trial;
+                best_score = s;
+            }
+        }
+    }
+    if (pool >= 2) {
+        SgemmConfig trial = best;
+        trial.max_threads = pool / 2;
+        const double s = measure(trial, buf);
+        if (s > best_score * TUNE_MIN_GAIN) {
+            best = trial;
+            best_score = s;
+        }
+    }
+    *score = best_score;
+    return best;
+}
+
+/**
+ * 测量所有候选并记录胜者，调用方持有 st.tune_mutex；返回调优文件是否写入成功
+ */
+bool run_autotune(TuningState& st, int pool, TuningRecord* out) {
+    TuneBuffers buf;
+    SgemmConfig best = {nullptr, {0, 0, 0}, 0};
+    double best_score = 0.0;
+    for (const SgemmKernelInfo* info : kernel_candidates()) {
+        double score = 0.0;
+        const SgemmConfig cfg = tune_kernel(info, pool, buf, &score);
+        if (!best.info || score > best_score * TUNE_MIN_GAIN) {
+            best = cfg;
+            best_score = score;
+        }
+    }
+    TuningRecord rec;
+    rec.variant = dispatch_table().variant;
+    rec.pool = pool;
+    rec.kernel = best.info->name;
+    rec.blk = best.blk;
+    rec.threads = best.max_threads;
+    rec.gflops = best_score;
+    {
+        std::lock_guard<std::mutex> lock(st.mutex);
+        ensure_loaded(st);
+        st.records.erase(std::remove_if(st.records.begin(), st.records.end(),
+                                        [&](const TuningRecord& r) {
+                                            return r.variant == rec.variant && r.pool == pool;
+                                        }),
+                         st.records.end());
+        st.records.push_back(rec);
+        publish(st);
+    }
+    *out = rec;
+    return save_record(rec);
+}
+
+/**
+ * 当前变体与线程池大小对应的记录；allow_auto 时按 SIMD_AUTOTUNE 在没有记录时自动调优
+ * (在线程池任务内或其他线程正在测量时跳过，使用推导值)。
+ * 已加载后查询只读取发布的快照，只有需要自动调优时才加锁
+ */
+bool current_record(bool allow_auto, TuningRecord* out) {
+    TuningState& st = tuning_state();
+    const int pool = thread_pool_size();
+    const char* variant = dispatch_table().variant;
+    if (const RecordTable* table = st.published.load(std::memory_order_acquire)) {
+        if (const TuningRecord* rec = find_record(*table, variant, pool)) {
+            *out = *rec;
+            return true;
+        }
+        if (!allow_auto || autotune_mode() != 1) {
+            return false;
+        }
+    }
+    {
+        std::lock_guard<std::mutex> lock(st.mutex);
+        ensure_loaded(st);
+        if (const TuningRecord* rec = find_record(st.records, variant, pool)) {
+            *out = *rec;
+            return true;
+        }
+        if (!allow_auto || autotune_mode() != 1 || in_parallel_region() ||
+            std::find(st.auto_tried.begin(), st.auto_tried.end(), pool) != st.auto_tried.end()) {
+            return false;
+        }
+        st.auto_tried.push_back(pool);
+    }
+    std::unique_lock<std::mutex> tune_lock(st.tune_mutex, std::try_to_lock);
+    if (!tune_lock) {
+        return false;
+    }
+    run_autotune(st, pool, out);
+    return true;
+}
+
+SgemmConfig config_from_record(const SgemmKernelInfo* info, const TuningRecord* rec) {
+    SgemmConfig cfg = {info, sgemm_blocking(info), 0};
+    const SgemmKernelInfo* tuned = rec ? kernel_by_name(rec->kernel) : nullptr;
+    if (tuned && rec->blk.mc > 0 && rec->blk.kc > 0 && rec->blk.nc > 0) {
+        cfg.info = tuned;
+        cfg.blk = rec->blk;
+        cfg.max_threads = std::max(rec->threads, 0);
+    }
+    return cfg;
+}
+
+void fill_result(const SgemmConfig& cfg, const TuningRecord* rec, SimdTuningResult* result) {
+    if (!result) {
+        return;
+    }
+    const bool tuned = rec && cfg.info != nullptr && kernel_by_name(rec->kernel) == cfg.info;
+    result->kernel = cfg.info->name;
+    result->mc = cfg.blk.mc;
+    result->kc = cfg.blk.kc;
+    result->nc = cfg.blk.nc;
+    result->threads = cfg.max_threads;
+    result->gflops = tuned ? rec->gflops : 0.0;
+    result->tuned = tuned ? 1 : 0;
+}
+
+}  // namespace
+
+void load_tuning_file() {
+    TuningState& st = tuning_state();
+    std::lock_guard<std::mutex> lock(st.mutex);
+    ensure_loaded(st);
+}
+
+SgemmConfig sgemm_config(const SgemmKernelInfo* info, bool allow_auto) {
+    if (info != dispatch_table().sgemm) {
+        SgemmConfig cfg = {info, sgemm_blocking(info), 0};
+        return cfg;
+    }
+    TuningRecord rec;
+    return config_from_record(info, current_record(allow_auto, &rec) ? &rec : nullptr);
+}
+
+}  // namespace simd_internal
+
+int simd_autotune(int force, SimdTuningResult* result) {
+    using namespace simd_internal;
+    const SgemmKernelInfo* active = dispatch_table().sgemm;
+    TuningRecord rec;
+    if (!force && current_record(false, &rec)) {
+        fill_result(config_from_record(active, &rec), &rec, result);
+        return 0;
+    }
+    TuningState& st = tuning_state();
+    std::lock_guard<std::mutex> tune_lock(st.tune_mutex);
+    const bool saved = run_autotune(st, thread_pool_size(), &rec);
+    fill_result(config_from_record(active, &rec), &rec, result);
+    return saved ? 0 : -1;
+}
+
+void simd_get_tuning(SimdTuningResult* result) {
+    using namespace simd_internal;
+    TuningRecord rec;
+    const bool found = current_record(false, &rec);
+    fill_result(config_from_record(dispatch_table().sgemm, found ? &rec : nullptr),
+                found ? &rec : nullptr, result);
+}
+
+const char* simd_get_tuning_file(void) {
+    return simd_internal::tuning_file().c_str();
+}
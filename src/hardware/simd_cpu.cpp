@@ -0,0 +1,363 @@
+/**
+ * CPU 特性运行时检测 - VisionAI-ClipsMaster
+ * 通过 CPUID/XGETBV 判断指令集及操作系统寄存器状态保存支持；
+ * 缓存拓扑在 Linux 上读取 sysfs (可反映虚拟机与容器内的实际配置)，
+ * 其他系统按 CPUID leaf 4 (Intel) / 0x8000001D (AMD) 枚举，均不可用时各级为 0
+ */
+
+#include "simd_kernels.h"
+#include "simd_internal.h"
+
+#include <algorithm>
+#include <cctype>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386) || defined(_M_IX86)
+    #define SIMD_ARCH_X86 1
+    #if defined(_MSC_VER)
+        #include <intrin.h>
+    #else
+        #include <cpuid.h>
+    #endif
+#endif
+
+namespace simd_internal {
+
+// 记录一级缓存 (L1 只取数据缓存)，返回是否为可用的级别
+static bool cache_topology_set(CacheTopology* topo, int level, size_t size, int shared, int line) {
+    if (size == 0) {
+        return false;
+    }
+    shared = std::max(shared, 1);
+    if (level == 1) {
+        topo->l1d = size;
+        topo->l1d_shared = shared;
+    } else if (level == 2) {
+        topo->l2 = size;
+        topo->l2_shared = shared;
+    } else if (level == 3) {
+        topo->l3 = size;
+        topo->l3_shared = shared;
+    } else {
+        return false;
+    }
+    if (line > 0) {
+        topo->line_size = line;
+    }
+    return true;
+}
+
+#if defined(SIMD_ARCH_X86)
+
+static void cpuid_count(unsigned int leaf, unsigned int subleaf, unsigned int regs[4]) {
+#if defined(_MSC_VER)
+    int info[4];
+    __cpuidex(info, (int)leaf, (int)subleaf);
+    for (int i = 0; i < 4; ++i) regs[i] = (unsigned int)info[i];
+#else
+    if (!__get_cpuid_count(leaf, subleaf, &regs[0], &regs[1], &regs[2], &regs[3])) {
+        regs[0] = regs[1] = regs[2] = regs[3] = 0;
+    }
+#endif
+}
+
+static unsigned long long read_xcr0() {
+#if defined(_MSC_VER)
+    return _xgetbv(0);
+#else
+    unsigned int eax, edx;
+    __asm__ __volatile__("xgetbv" : "=a"(eax), "=d"(edx) : "c"(0));
+    return ((unsigned long long)edx << 32) | eax;
+#endif
+}
+
+static unsigned int detect_cpu_features() {
+    unsigned int features = 0;
+    unsigned int leaf0[4], leaf1[4], leaf7[4] = {0, 0, 0, 0}, leaf7_1[4] = {0, 0, 0, 0};
+
+    cpuid_count(0, 0, leaf0);
+    cpuid_count(1, 0, leaf1);
+    if (leaf0[0] >= 7) {
+        cpuid_count(7, 0, leaf7);
+        if (leaf7[0] >= 1) {
+            cpuid_count(7, 1, leaf7_1);
+        }
+    }
+
+    if (leaf1[2] & (1u << 20)) features |= SIMD_CPU_SSE42;
+
+    // OSXSAVE (ECX bit 27) 未置位时不能执行 xgetbv，也不能使用 AVX 系列
+    unsigned long long xcr0 = 0;
+    if (leaf1[2] & (1u << 27)) {
+        xcr0 = read_xcr0();
+    }
+    const bool ymm_state = (xcr0 & 0x6) == 0x6;      // XMM | YMM
+    const bool zmm_state = (xcr0 & 0xE6) == 0xE6;    // + opmask | ZMM_Hi256 | Hi16_ZMM
+
+    if (ymm_state) {
+        if (leaf1[2] & (1u << 28)) features |= SIMD_CPU_AVX;
+        if (leaf1[2] & (1u << 12)) features |= SIMD_CPU_FMA;
+        if (leaf1[2] & (1u << 29)) features |= SIMD_CPU_F16C;
+        if (leaf7[1] & (1u << 5))  features |= SIMD_CPU_AVX2;
+        if (leaf7_1[0] & (1u << 4)) features |= SIMD_CPU_AVXVNNI;
+    }
+    if (zmm_state) {
+        if (leaf7[1] & (1u << 16)) features |= SIMD_CPU_AVX512F;
+        if (leaf7[1] & (1u << 17)) features |= SIMD_CPU_AVX512DQ;
+        if (leaf7[1] & (1u << 30)) features |= SIMD_CPU_AVX512BW;
+        if (leaf7[1] & (1u << 31)) features |= SIMD_CPU_AVX512VL;
+        if (leaf7[2] & (1u << 11)) features |= SIMD_CPU_AVX512VNNI;
+    }
+    return features;
+}
+
+/**
+ * 按确定性缓存参数叶枚举各级缓存 (leaf 4 与 0x8000001D 格式相同)
+ */
+static bool cpuid_cache_topology(CacheTopology* topo) {
+    unsigned int regs[4];
+    cpuid_count(0, 0, regs);
+    const bool intel = regs[1] == 0x756e6547;           // "GenuineIntel"
+    unsigned int leaf = 0;
+    if (intel && regs[0] >= 4) {
+        leaf = 4;
+    } else {
+        cpuid_count(0x80000000, 0, regs);
+        if (regs[0] >= 0x8000001D) {
+            cpuid_count(0x80000001, 0, regs);
+            if (regs[2] & (1u << 22)) {                   // TOPOEXT
+                leaf = 0x8000001D;
+            }
+        }
+    }
+    if (leaf == 0) {
+        return false;
+    }
+    bool found = false;
+    for (unsigned int sub = 0; sub < 16; ++sub) {
+        cpuid_count(leaf, sub, regs);
+        const unsigned int type = regs[0] & 0x1F;          // 1 数据，2 指令，3 统一
+        if (type == 0) {
+            break;
+        }
+        if (type == 2) {
+            continue;
+        }
+        const int level = (int)((regs[0] >> 5) & 0x7);
+        const int shared = (int)((regs[0] >> 14) & 0xFFF) + 1;
+        const size_t line = (regs[1] & 0xFFF) + 1;
+        const size_t size = (((regs[1] >> 22) & 0x3FF) + 1) * (((regs[1] >> 12) & 0x3FF) + 1) *
+                            line * ((size_t)regs[2] + 1);
+        found |= cache_topology_set(topo, level, size, shared, (int)line);
+    }
+    return found;
+}
+
+// 品牌字符串 (leaf 0x80000002-0x80000004) 与 family/model/stepping (leaf 1 EAX)
+static void cpu_model_string(char* buf, size_t len) {
+    unsigned int regs[4];
+    char brand[49] = {0};
+    cpuid_count(0x80000000, 0, regs);
+    if (regs[0] >= 0x80000004) {
+        for (unsigned int i = 0; i < 3; ++i) {
+            cpuid_count(0x80000002 + i, 0, regs);
+            memcpy(brand + 16 * i, regs, 16);
+        }
+    }
+    cpuid_count(1, 0, regs);
+    snprintf(buf, len, "%s-%08x", brand, regs[0]);
+}
+
+#else  // 非 x86 平台
+
+static void cpu_model_string(char* buf, size_t len) {
+#if defined(__aarch64__) || defined(_M_ARM64)
+    snprintf(buf, len, "aarch64");
+#elif defined(__arm__) || defined(_M_ARM)
+    snprintf(buf, len, "arm");
+#else
+    snprintf(buf, len, "unknown");
+#endif
+}
+
+static bool cpuid_cache_topology(CacheTopology*) {
+    return false;
+}
+
+static unsigned int detect_cpu_features() {
+#if defined(__ARM_NEON)
+    return SIMD_CPU_NEON;
+#else
+    return 0;
+#endif
+}
+
+#endif
+
+#if defined(__linux__)
+
+static bool read_sysfs_line(const char* path, char* buf, size_t len) {
+    FILE* f = fopen(path, "r");
+    if (!f) {
+        return false;
+    }
+    const bool ok = fgets(buf, (int)len, f) != nullptr;
+    fclose(f);
+    return ok;
+}
+
+// "0-3,8-11" 形式的 CPU 列表所含的 CPU 数
+static int count_cpu_list(const char* list) {
+    int count = 0;
+    const char* p = list;
+    while (*p) {
+        char* end = nullptr;
+        const long lo = strtol(p, &end, 10);
+        if (end == p) {
+            break;
+        }
+        long hi = lo;
+        p = end;
+        if (*p == '-') {
+            hi = strtol(p + 1, &end, 10);
+            p = end;
+        }
+        count += (int)(hi - lo + 1);
+        if (*p != ',') {
+            break;
+        }
+        ++p;
+    }
+    return count;
+}
+
+/**
+ * 读取 cpu0 的 cache/index* 目录 (size 形如 "48K"、"32M")
+ */
+static bool sysfs_cache_topology(CacheTopology* topo) {
+    bool found = false;
+    for (int index = 0; index < 16; ++index) {
+        char path[128];
+        char value[256];
+        const int base = snprintf(path, sizeof(path), "/sys/devices/system/cpu/cpu0/cache/index%d/", index);
+        const size_t room = sizeof(path) - (size_t)base;
+        snprintf(path + base, room, "type");
+        if (!read_sysfs_line(path, value, sizeof(value))) {
+            break;
+        }
+        if (strncmp(value, "Instruction", 11) == 0) {
+            continue;
+        }
+        snprintf(path + base, room, "level");
+        const int level = read_sysfs_line(path, value, sizeof(value)) ? atoi(value) : 0;
+        snprintf(path + base, room, "size");
+        size_t size = 0;
+        if (read_sysfs_line(path, value, sizeof(value))) {
+            char* unit = nullptr;
+            size = (size_t)strtoull(value, &unit, 10);
+            if (*unit == 'K') size <<= 10;
+            else if (*unit == 'M') size <<= 20;
+            else if (*unit == 'G') size <<= 30;
+        }
+        snprintf(path + base, room, "shared_cpu_list");
+        const int shared = read_sysfs_line(path, value, sizeof(value)) ? count_cpu_list(value) : 1;
+        snprintf(path + base, room, "coherency_line_size");
+        const int line = read_sysfs_line(path, value, sizeof(value)) ? atoi(value) : 0;
+        found |= cache_topology_set(topo, level, size, shared, line);
+    }
+    return found;
+}
+
+#else
+
+static bool sysfs_cache_topology(CacheTopology*) {
+    return false;
+}
+
+#endif
+
+static CacheTopology detect_cache_topology() {
+    CacheTopology topo = {64, 0, 0, 0, 1, 1, 1, "default"};
+    if (sysfs_cache_topology(&topo)) {
+        topo.source = "sysfs";
+    } else if (cpuid_cache_topology(&topo)) {
+        topo.source = "cpuid";
+    }
+    return topo;
+}
+
+const CacheTopology& cache_topology() {
+    static const CacheTopology topo = detect_cache_topology();
+    return topo;
+}
+
+static std::string detect_cpu_signature() {
+    char model[96];
+    cpu_model_string(model, sizeof(model));
+    const CacheTopology& topo = cache_topology();
+    char buf[192];
+    snprintf(buf, sizeof(buf), "%s-f%x-L1d%zuK-L2%zuK-L3%zuK", model, cpu_features(),
+             topo.l1d >> 10, topo.l2 >> 10, topo.l3 >> 10);
+    // 品牌字符串中的空白与分隔符统一替换为 '_'，连续的只保留一个
+    std::string sig;
+    for (const char* p = buf; *p; ++p) {
+        const char c = isalnum((unsigned char)*p) || *p == '-' || *p == '.' ? *p : '_';
+        if (c == '-' && !sig.empty() && sig.back() == '_') {
+            sig.back() = c;
+        } else if (c != '_' || (!sig.empty() && sig.back() != '_' && sig.back() != '-')) {
+            sig += c;
+        }
+    }
+    return sig;
+}
+
+const char* cpu_signature() {
+    static const std::string sig = detect_cpu_signature();
+    return sig.c_str();
+}
+
+int cache_blocking(size_t budget, size_t unit_bytes, int multiple, int lo, int hi, int fallback) {
+    if (budget == 0 || unit_bytes == 0) {
+        return fallback;
+    }
+    const size_t units = std::min<size_t>(budget / unit_bytes, (size_t)hi);
+    const int rounded = (int)units / multiple * multiple;
+    return std::max(rounded, lo);
+}
+
+unsigned int cpu_features() {
+    static const unsigned int features = detect_cpu_features();
+    return features;
+}
+
+bool cpu_has_avx2_fma() {
+    // AVX2 内核以 -mf16c 编译并使用 vcvtph2ps 转换 fp16，F16C 须单独检测 (leaf 1 ECX bit 29)
+    const unsigned int required = SIMD_CPU_AVX | SIMD_CPU_AVX2 | SIMD_CPU_FMA | SIMD_CPU_F16C;
+    return (cpu_features() & required) == required;
+}
+
+bool cpu_has_avx512f() {
+    // 内核统一以 F/BW/DQ/VL 子集编译
+    const unsigned int required = SIMD_CPU_AVX512F | SIMD_CPU_AVX512BW | SIMD_CPU_AVX512DQ | SIMD_CPU_AVX512VL;
+    return cpu_has_avx2_fma() && (cpu_features() & required) == required;
+}
+
+}  // namespace simd_internal
+
+void simd_get_cache_info(SimdCacheInfo* info) {
+    if (!info) {
+        return;
+    }
+    const simd_internal::CacheTopology& topo = simd_internal::cache_topology();
+    info->line_size = topo.line_size;
+    info->l1d_size = (long long)topo.l1d;
+    info->l1d_shared = topo.l1d_shared;
+    info->l2_size = (long long)topo.l2;
+    info->l2_shared = topo.l2_shared;
+    info->l3_size = (long long)topo.l3;
+    info->l3_shared = topo.l3_shared;
+    info->source = topo.source;
+}
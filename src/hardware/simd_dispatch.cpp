@@ -0,0 +1,196 @@
+/**
+ * 运行时指令集分发 - VisionAI-ClipsMaster
+ *
+ * 各内核族按指令集分别编译进同一个库，加载时根据 CPUID 检测结果
+ * 填充分发表，保证同一二进制在旧节点上不会执行非法指令，
+ * 在新节点上也能使用 AVX-512。
+ */
+
+#include "simd_kernels.h"
+#include "simd_internal.h"
+
+#include <cstdlib>
+#include <cstring>
+
+namespace simd_internal {
+
+// 基准变体: 不依赖任何扩展指令集
+static void matrix_mult_scalar(float* a, float* b, float* c, int n) {
+    for (int i = 0; i < n; ++i) c[i] = a[i] * b[i];
+}
+
+static void matrix_add_scalar(float* a, float* b, float* c, int n) {
+    for (int i = 0; i < n; ++i) c[i] = a[i] + b[i];
+}
+
+static void vector_scale_scalar(float* vec, float scalar, int n) {
+    for (int i = 0; i < n; ++i) vec[i] *= scalar;
+}
+
+static void fma_scalar(float* a, float* b, float* c, float* result, int n) {
+    for (int i = 0; i < n; ++i) result[i] = a[i] * b[i] + c[i];
+}
+
+// 变体优先级，数值越大越优先
+enum SimdVariantLevel {
+    LEVEL_BASELINE = 0,
+    LEVEL_NEON,
+    LEVEL_SSE42,
+    LEVEL_AVX,
+    LEVEL_AVX2,
+    LEVEL_AVX512
+};
+
+/**
+ * 解析 SIMD_FORCE_VARIANT 环境变量，返回允许的最高变体
+ */
+static int forced_level_limit() {
+    const char* env = getenv("SIMD_FORCE_VARIANT");
+    if (!env || !*env) {
+        return LEVEL_AVX512;
+    }
+    if (strcmp(env, "baseline") == 0) return LEVEL_BASELINE;
+    if (strcmp(env, "neon") == 0) return LEVEL_NEON;
+    if (strcmp(env, "sse42") == 0 || strcmp(env, "sse4.2") == 0) return LEVEL_SSE42;
+    if (strcmp(env, "avx") == 0) return LEVEL_AVX;
+    if (strcmp(env, "avx2") == 0) return LEVEL_AVX2;
+    return LEVEL_AVX512;
+}
+
+/**
+ * INT8 GEMM 内核独立于逐元素变体选择: VNNI 与 AVX-512/AVX2 主变体正交
+ */
+static const Int8GemmKernelInfo* select_int8_kernel(unsigned int features, int limit) {
+    (void)features;
+    (void)limit;
+#if defined(SIMD_BUILD_AVX512VNNI)
+    if (limit >= LEVEL_AVX512 && cpu_has_avx512f() && (features & SIMD_CPU_AVX512VNNI)) {
+        return int8_gemm_kernel_avx512vnni();
+    }
+#endif
+#if defined(SIMD_BUILD_AVXVNNI)
+    if (limit >= LEVEL_AVX2 && cpu_has_avx2_fma() && (features & SIMD_CPU_AVXVNNI)) {
+        return int8_gemm_kernel_avxvnni();
+    }
+#endif
+#if defined(SIMD_BUILD_AVX2)
+    if (limit >= LEVEL_AVX2 && cpu_has_avx2_fma()) {
+        return int8_gemm_kernel_avx2();
+    }
+#endif
+    return int8_gemm_kernel_generic();
+}
+
+static SimdDispatchTable build_dispatch_table() {
+    const unsigned int features = cpu_features();
+    const int limit = forced_level_limit();
+    (void)features;
+    (void)limit;
+
+    SimdDispatchTable table = {
+        "baseline", 1,
+        matrix_mult_scalar, matrix_add_scalar, vector_scale_scalar, fma_scalar,
+        sgemm_kernel_generic(), quant_kernels_generic(),
+        select_int8_kernel(features, limit), gemv_kernels_generic(), expr_kernels_generic(),
+        reduce_kernels_generic(), transformer_kernels_generic()
+    };
+
+    // SIMD_BUILD_* 由构建系统在编译器支持对应指令集时定义
+#if defined(SIMD_BUILD_AVX512)
+    if (limit >= LEVEL_AVX512 && cpu_has_avx512f()) {
+        table.variant = "avx512";
+        table.vector_width = 16;
+        table.matrix_mult = matrix_mult_avx512;
+        table.matrix_add = matrix_add_avx512;
+        table.vector_scale = vector_scale_avx512;
+        table.fma = fma_avx512;
+        table.sgemm = sgemm_kernel_avx512();
+        table.quant = quant_kernels_avx512();
+        table.gemv = gemv_kernels_avx512();
+        table.expr = expr_kernels_avx512();
+        table.reduce = reduce_kernels_avx512();
+        table.transformer = transformer_kernels_avx512();
+        return table;
+    }
+#endif
+#if defined(SIMD_BUILD_AVX2)
+    if (limit >= LEVEL_AVX2 && cpu_has_avx2_fma()) {
+        table.variant = "avx2";
+        table.vector_width = 8;
+        table.matrix_mult = matrix_mult_avx2;
+        table.matrix_add = matrix_add_avx2;
+        table.vector_scale = vector_scale_avx2;
+        table.fma = fma_avx2;
+        table.sgemm = sgemm_kernel_avx2();
+        table.quant = quant_kernels_avx2();
+        table.gemv = gemv_kernels_avx2();
+        table.expr = expr_kernels_avx2();
+        table.reduce = reduce_kernels_avx2();
+        table.transformer = transformer_kernels_avx2();
+        return table;
+    }
+#endif
+#if defined(SIMD_BUILD_AVX)
+    if (limit >= LEVEL_AVX && (features & SIMD_CPU_AVX)) {
+        table.variant = "avx";
+        table.vector_width = 8;
+        table.matrix_mult = matrix_mult_avx;
+        table.matrix_add = matrix_add_avx;
+        table.vector_scale = vector_scale_avx;
+        table.fma = fma_avx;
+        return table;
+    }
+#endif
+#if defined(SIMD_BUILD_SSE42)
+    if (limit >= LEVEL_SSE42 && (features & SIMD_CPU_SSE42)) {
+        table.variant = "sse42";
+        table.vector_width = 4;
+        table.matrix_mult = matrix_mult_sse42;
+        table.matrix_add = matrix_add_sse42;
+        table.vector_scale = vector_scale_sse42;
+        table.fma = fma_sse42;
+        return table;
+    }
+#endif
+#if defined(__ARM_NEON)
+    if (limit >= LEVEL_NEON) {
+        table.variant = "neon";
+        table.vector_width = 4;
+        table.matrix_mult = matrix_mult_neon;
+        table.matrix_add = matrix_add_neon;
+        table.vector_scale = vector_scale_neon;
+        table.fma = fma_neon;
+        if (reduce_kernels_neon()) {
+            table.reduce = reduce_kernels_neon();
+        }
+    }
+#endif
+
+    return table;
+}
+
+const SimdDispatchTable& dispatch_table() {
+    static const SimdDispatchTable table = build_dispatch_table();
+    return table;
+}
+
+// 在库加载时完成检测与分发表填充，并读取 GEMM 调优记录
+namespace {
+struct DispatchTableInitializer {
+    DispatchTableInitializer() {
+        dispatch_table();
+        load_tuning_file();
+    }
+};
+DispatchTableInitializer g_dispatch_table_initializer;
+}
+
+}  // namespace simd_internal
+
+const char* simd_get_active_variant(void) {
+    return simd_internal::dispatch_table().variant;
+}
+
+unsigned int simd_get_cpu_features(void) {
+    return simd_internal::cpu_features();
+}
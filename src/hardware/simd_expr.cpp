@@ -0,0 +1,178 @@
+/**
+ * 融合逐元素表达式引擎 - VisionAI-ClipsMaster
+ *
+ * 逐个调用 matrix_add/matrix_mult/vector_scale/fma 时，(a * b + c) * s 这样的链
+ * 每一步都要完整遍历一次内存。这里把整条链编码为寄存器字节码 (SimdEwInstr)，
+ * 按 L1 大小的分块求值: LOAD 只让寄存器指向输入分块，不做拷贝，中间结果留在
+ * 线程私有的分块缓冲区里，最后一条指令直接写入输出。这样每个输入只读一次、
+ * 输出只写一次，解释开销按分块长度摊薄。
+ */
+
+#include "simd_kernels.h"
+#include "simd_internal.h"
+#include "simd_vecmath.h"
+
+#include <algorithm>
+#include <cstring>
+
+namespace simd_internal {
+
+// 每个寄存器的分块长度: SIMD_EW_MAX_REGS 个分块共 16KB，与输入分块一起驻留 L1
+static const int EXPR_TILE = 256;
+
+// 每个线程至少处理的元素数
+static const size_t EXPR_PARALLEL_GRAIN = 1 << 16;
+
+static void expr_apply_generic(const SimdEwInstr& ins, float* dst, const float* a,
+                               const float* b, const float* c, int len) {
+    switch (ins.op) {
+    case SIMD_EW_CONST:
+        std::fill(dst, dst + len, ins.p0);
+        break;
+    case SIMD_EW_ADD:
+        for (int i = 0; i < len; ++i) dst[i] = a[i] + b[i];
+        break;
+    case SIMD_EW_SUB:
+        for (int i = 0; i < len; ++i) dst[i] = a[i] - b[i];
+        break;
+    case SIMD_EW_MUL:
+        for (int i = 0; i < len; ++i) dst[i] = a[i] * b[i];
+        break;
+    case SIMD_EW_DIV:
+        for (int i = 0; i < len; ++i) dst[i] = a[i] / b[i];
+        break;
+    case SIMD_EW_FMA:
+        for (int i = 0; i < len; ++i) dst[i] = a[i] * b[i] + c[i];
+        break;
+    case SIMD_EW_AFFINE:
+        for (int i = 0; i < len; ++i) dst[i] = a[i] * ins.p0 + ins.p1;
+        break;
+    case SIMD_EW_MIN:
+        for (int i = 0; i < len; ++i) dst[i] = b[i] < a[i] ? b[i] : a[i];
+        break;
+    case SIMD_EW_MAX:
+        for (int i = 0; i < len; ++i) dst[i] = b[i] > a[i] ? b[i] : a[i];
+        break;
+    case SIMD_EW_CLAMP:
+        for (int i = 0; i < len; ++i) dst[i] = std::min(std::max(a[i], ins.p0), ins.p1);
+        break;
+    case SIMD_EW_ACT:
+        for (int i = 0; i < len; ++i) dst[i] = activation_scalar(a[i], ins.b);
+        break;
+    default:
+        break;
+    }
+}
+
+const ExprKernels* expr_kernels_generic() {
+    static const ExprKernels kernels = {"generic", expr_apply_generic};
+    return &kernels;
+}
+
+namespace {
+
+int expr_arity(int op) {
+    switch (op) {
+    case SIMD_EW_LOAD:
+    case SIMD_EW_CONST:
+        return 0;
+    case SIMD_EW_AFFINE:
+    case SIMD_EW_CLAMP:
+    case SIMD_EW_ACT:
+        return 1;
+    case SIMD_EW_FMA:
+        return 3;
+    default:
+        return 2;
+    }
+}
+
+bool valid_reg(int r) {
+    return r >= 0 && r < SIMD_EW_MAX_REGS;
+}
+
+/**
+ * 检查字节码: 操作码与寄存器编号合法，寄存器先写后读，out_reg 已写入
+ */
+bool validate_program(const SimdEwInstr* program, int n_instr, int n_inputs, int out_reg) {
+    if (!program || n_instr <= 0 || !valid_reg(out_reg)) {
+        return false;
+    }
+    bool written[SIMD_EW_MAX_REGS] = {false};
+    for (int k = 0; k < n_instr; ++k) {
+        const SimdEwInstr& ins = program[k];
+        if (ins.op < SIMD_EW_LOAD || ins.op > SIMD_EW_ACT || !valid_reg(ins.dst)) {
+            return false;
+        }
+        if (ins.op == SIMD_EW_LOAD && (ins.a < 0 || ins.a >= n_inputs)) {
+            return false;
+        }
+        if (ins.op == SIMD_EW_ACT && (ins.b < SIMD_ACT_NONE || ins.b > SIMD_ACT_SILU)) {
+            return false;
+        }
+        const int srcs[3] = {ins.a, ins.b, ins.c};
+        for (int j = 0; j < expr_arity(ins.op); ++j) {
+            if (!valid_reg(srcs[j]) || !written[srcs[j]]) {
+                return false;
+            }
+        }
+        written[ins.dst] = true;
+    }
+    return written[out_reg];
+}
+
+/**
+ * 求值 [begin, end): 寄存器 r 指向输入分块或 scratch[r]，
+ * 最后一条指令写 out_reg 时直接写入输出 (out 与输入相同时逐元素读后写，仍然安全)
+ */
+void run_expr_range(const ExprKernels* kernels, const SimdEwInstr* program, int n_instr,
+                    const float* const* inputs, int out_reg, float* out,
+                    size_t begin, size_t end) {
+    alignas(64) float scratch[SIMD_EW_MAX_REGS][EXPR_TILE];
+    const float* reg[SIMD_EW_MAX_REGS] = {nullptr};
+    const bool direct_out = program[n_instr - 1].dst == out_reg &&
+                            program[n_instr - 1].op != SIMD_EW_LOAD;
+
+    for (size_t t = begin; t < end; t += EXPR_TILE) {
+        const int len = (int)std::min<size_t>(EXPR_TILE, end - t);
+        for (int k = 0; k < n_instr; ++k) {
+            const SimdEwInstr& ins = program[k];
+            if (ins.op == SIMD_EW_LOAD) {
+                reg[ins.dst] = inputs[ins.a] + t;
+                continue;
+            }
+            float* dst = direct_out && k == n_instr - 1 ? out + t : scratch[ins.dst];
+            const int arity = expr_arity(ins.op);
+            const float* a = arity > 0 ? reg[ins.a] : dst;
+            const float* b = arity > 1 ? reg[ins.b] : a;
+            const float* c = arity > 2 ? reg[ins.c] : a;
+            kernels->apply(ins, dst, a, b, c, len);
+            reg[ins.dst] = dst;
+        }
+        if (!direct_out && reg[out_reg] != out + t) {
+            memmove(out + t, reg[out_reg], (size_t)len * sizeof(float));
+        }
+    }
+}
+
+}  // namespace
+
+}  // namespace simd_internal
+
+/**
+ * 融合逐元素表达式求值，大规模输入按连续区间切分到线程池
+ */
+int simd_elementwise_fused(const SimdEwInstr* program, int n_instr,
+                           const float* const* inputs, int n_inputs,
+                           int out_reg, float* out, long long n) {
+    using namespace simd_internal;
+    if (n < 0 || !out || (n_inputs > 0 && !inputs) ||
+        !validate_program(program, n_instr, n_inputs, out_reg)) {
+        return -1;
+    }
+    const ExprKernels* kernels = dispatch_table().expr;
+    parallel_for_range((size_t)n, EXPR_PARALLEL_GRAIN, [&](size_t begin, size_t end) {
+        run_expr_range(kernels, program, n_instr, inputs, out_reg, out, begin, end);
+    });
+    return 0;
+}
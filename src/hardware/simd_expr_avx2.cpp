@@ -0,0 +1,119 @@
+/**
+ * AVX2/FMA 融合逐元素表达式内核 - VisionAI-ClipsMaster
+ * 每条指令在一个分块上执行一个向量循环，尾部使用 maskload/maskstore
+ */
+
+#include "simd_internal.h"
+#include "simd_vecmath.h"
+
+#if defined(__AVX2__) && defined(__FMA__)
+#include <immintrin.h>
+
+namespace simd_internal {
+
+namespace {
+
+// 从 EXPR_TAIL_MASK + 8 - n 处读取 8 个 int 即得到低 n 个通道的掩码
+const int EXPR_TAIL_MASK[16] = {-1, -1, -1, -1, -1, -1, -1, -1, 0, 0, 0, 0, 0, 0, 0, 0};
+
+template <typename Op>
+inline void expr_loop_avx2(float* dst, const float* a, const float* b, const float* c,
+                             int len, Op op) {
+    int i = 0;
+    for (; i + 8 <= len; i += 8) {
+        _mm256_storeu_ps(dst + i, op(_mm256_loadu_ps(a + i), _mm256_loadu_ps(b + i),
+                                     _mm256_loadu_ps(c + i)));
+    }
+    if (i < len) {
+        const __m256i m = _mm256_loadu_si256(
+            reinterpret_cast<const __m256i*>(EXPR_TAIL_MASK + 8 - (len - i)));
+        _mm256_maskstore_ps(dst + i, m, op(_mm256_maskload_ps(a + i, m),
+                                           _mm256_maskload_ps(b + i, m),
+                                           _mm256_maskload_ps(c + i, m)));
+    }
+}
+
+template <int ACT>
+inline void expr_act_avx2(float* dst, const float* a, int len) {
+    expr_loop_avx2(dst, a, a, a, len,
+                     [](__m256 x, __m256, __m256) { return activation256_ps(x, ACT); });
+}
+
+}  // namespace
+
+static void expr_apply_avx2(const SimdEwInstr& ins, float* dst, const float* a,
+                              const float* b, const float* c, int len) {
+    const __m256 p0 = _mm256_set1_ps(ins.p0);
+    const __m256 p1 = _mm256_set1_ps(ins.p1);
+    switch (ins.op) {
+    case SIMD_EW_CONST:
+        expr_loop_avx2(dst, a, b, c, len, [p0](__m256, __m256, __m256) { return p0; });
+        break;
+    case SIMD_EW_ADD:
+        expr_loop_avx2(dst, a, b, c, len,
+                         [](__m256 x, __m256 y, __m256) { return _mm256_add_ps(x, y); });
+        break;
+    case SIMD_EW_SUB:
+        expr_loop_avx2(dst, a, b, c, len,
+                         [](__m256 x, __m256 y, __m256) { return _mm256_sub_ps(x, y); });
+        break;
+    case SIMD_EW_MUL:
+        expr_loop_avx2(dst, a, b, c, len,
+                         [](__m256 x, __m256 y, __m256) { return _mm256_mul_ps(x, y); });
+        break;
+    case SIMD_EW_DIV:
+        expr_loop_avx2(dst, a, b, c, len,
+                         [](__m256 x, __m256 y, __m256) { return _mm256_div_ps(x, y); });
+        break;
+    case SIMD_EW_FMA:
+        expr_loop_avx2(dst, a, b, c, len,
+                         [](__m256 x, __m256 y, __m256 z) { return _mm256_fmadd_ps(x, y, z); });
+        break;
+    case SIMD_EW_AFFINE:
+        expr_loop_avx2(dst, a, b, c, len, [p0, p1](__m256 x, __m256, __m256) {
+            return _mm256_fmadd_ps(x, p0, p1);
+        });
+        break;
+    case SIMD_EW_MIN:
+        expr_loop_avx2(dst, a, b, c, len,
+                         [](__m256 x, __m256 y, __m256) { return _mm256_min_ps(y, x); });
+        break;
+    case SIMD_EW_MAX:
+        expr_loop_avx2(dst, a, b, c, len,
+                         [](__m256 x, __m256 y, __m256) { return _mm256_max_ps(y, x); });
+        break;
+    case SIMD_EW_CLAMP:
+        expr_loop_avx2(dst, a, b, c, len, [p0, p1](__m256 x, __m256, __m256) {
+            return _mm256_min_ps(_mm256_max_ps(x, p0), p1);
+        });
+        break;
+    case SIMD_EW_ACT:
+        if (ins.b == SIMD_ACT_RELU) {
+            expr_act_avx2<SIMD_ACT_RELU>(dst, a, len);
+        } else if (ins.b == SIMD_ACT_GELU) {
+            expr_act_avx2<SIMD_ACT_GELU>(dst, a, len);
+        } else if (ins.b == SIMD_ACT_SILU) {
+            expr_act_avx2<SIMD_ACT_SILU>(dst, a, len);
+        } else if (dst != a) {
+            expr_act_avx2<SIMD_ACT_NONE>(dst, a, len);
+        }
+        break;
+    default:
+        break;
+    }
+}
+
+const ExprKernels* expr_kernels_avx2() {
+    static const ExprKernels kernels = {"avx2", expr_apply_avx2};
+    return &kernels;
+}
+
+}  // namespace simd_internal
+
+#else  // 未启用 AVX2/FMA 编译
+
+namespace simd_internal {
+const ExprKernels* expr_kernels_avx2() { return nullptr; }
+}
+
+#endif
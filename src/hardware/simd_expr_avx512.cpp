@@ -0,0 +1,115 @@
+/**
+ * AVX-512 融合逐元素表达式内核 - VisionAI-ClipsMaster
+ * 每条指令在一个分块上执行一个向量循环，尾部使用掩码读写
+ */
+
+#include "simd_internal.h"
+#include "simd_vecmath.h"
+
+#if defined(__AVX512F__)
+#include <immintrin.h>
+
+namespace simd_internal {
+
+namespace {
+
+template <typename Op>
+inline void expr_loop_avx512(float* dst, const float* a, const float* b, const float* c,
+                             int len, Op op) {
+    int i = 0;
+    for (; i + 16 <= len; i += 16) {
+        _mm512_storeu_ps(dst + i, op(_mm512_loadu_ps(a + i), _mm512_loadu_ps(b + i),
+                                     _mm512_loadu_ps(c + i)));
+    }
+    if (i < len) {
+        const __mmask16 m = (__mmask16)((1u << (len - i)) - 1);
+        _mm512_mask_storeu_ps(dst + i, m, op(_mm512_maskz_loadu_ps(m, a + i),
+                                             _mm512_maskz_loadu_ps(m, b + i),
+                                             _mm512_maskz_loadu_ps(m, c + i)));
+    }
+}
+
+template <int ACT>
+inline void expr_act_avx512(float* dst, const float* a, int len) {
+    expr_loop_avx512(dst, a, a, a, len,
+                     [](__m512 x, __m512, __m512) { return activation512_ps(x, ACT); });
+}
+
+}  // namespace
+
+static void expr_apply_avx512(const SimdEwInstr& ins, float* dst, const float* a,
+                              const float* b, const float* c, int len) {
+    const __m512 p0 = _mm512_set1_ps(ins.p0);
+    const __m512 p1 = _mm512_set1_ps(ins.p1);
+    switch (ins.op) {
+    case SIMD_EW_CONST:
+        expr_loop_avx512(dst, a, b, c, len, [p0](__m512, __m512, __m512) { return p0; });
+        break;
+    case SIMD_EW_ADD:
+        expr_loop_avx512(dst, a, b, c, len,
+                         [](__m512 x, __m512 y, __m512) { return _mm512_add_ps(x, y); });
+        break;
+    case SIMD_EW_SUB:
+        expr_loop_avx512(dst, a, b, c, len,
+                         [](__m512 x, __m512 y, __m512) { return _mm512_sub_ps(x, y); });
+        break;
+    case SIMD_EW_MUL:
+        expr_loop_avx512(dst, a, b, c, len,
+                         [](__m512 x, __m512 y, __m512) { return _mm512_mul_ps(x, y); });
+        break;
+    case SIMD_EW_DIV:
+        expr_loop_avx512(dst, a, b, c, len,
+                         [](__m512 x, __m512 y, __m512) { return _mm512_div_ps(x, y); });
+        break;
+    case SIMD_EW_FMA:
+        expr_loop_avx512(dst, a, b, c, len,
+                         [](__m512 x, __m512 y, __m512 z) { return _mm512_fmadd_ps(x, y, z); });
+        break;
+    case SIMD_EW_AFFINE:
+        expr_loop_avx512(dst, a, b, c, len, [p0, p1](__m512 x, __m512, __m512) {
+            return _mm512_fmadd_ps(x, p0, p1);
+        });
+        break;
+    case SIMD_EW_MIN:
+        expr_loop_avx512(dst, a, b, c, len,
+                         [](__m512 x, __m512 y, __m512) { return _mm512_min_ps(y, x); });
+        break;
+    case SIMD_EW_MAX:
+        expr_loop_avx512(dst, a, b, c, len,
+                         [](__m512 x, __m512 y, __m512) { return _mm512_max_ps(y, x); });
+        break;
+    case SIMD_EW_CLAMP:
+        expr_loop_avx512(dst, a, b, c, len, [p0, p1](__m512 x, __m512, __m512) {
+            return _mm512_min_ps(_mm512_max_ps(x, p0), p1);
+        });
+        break;
+    case SIMD_EW_ACT:
+        if (ins.b == SIMD_ACT_RELU) {
+            expr_act_avx512<SIMD_ACT_RELU>(dst, a, len);
+        } else if (ins.b == SIMD_ACT_GELU) {
+            expr_act_avx512<SIMD_ACT_GELU>(dst, a, len);
+        } else if (ins.b == SIMD_ACT_SILU) {
+            expr_act_avx512<SIMD_ACT_SILU>(dst, a, len);
+        } else if (dst != a) {
+            expr_act_avx512<SIMD_ACT_NONE>(dst, a, len);
+        }
+        break;
+    default:
+        break;
+    }
+}
+
+const ExprKernels* expr_kernels_avx512() {
+    static const ExprKernels kernels = {"avx512", expr_apply_avx512};
+    return &kernels;
+}
+
+}  // namespace simd_internal
+
+#else  // 未启用 AVX-512 编译
+
+namespace simd_internal {
+const ExprKernels* expr_kernels_avx512() { return nullptr; }
+}
+
+#endif
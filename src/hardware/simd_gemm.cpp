@@ -0,0 +1,416 @@
+/**
+ * 分块 GEMM 驱动 - VisionAI-ClipsMaster
+ *
+ * 采用 Goto/BLIS 式三级分块:
+ * - NC: B 面板列数，打包后的 B 面板驻留 L3
+ * - KC: 公共维度分块，B 微面板 (KC x NR) 驻留 L1
+ * - MC: A 面板行数，打包后的 A 面板 (MC x KC) 驻留 L2
+ * 三级分块长度在运行时由检测到的缓存拓扑推导 (sgemm_blocking)，
+ * 最内层由各指令集的寄存器分块微内核完成 MR x NR 的累加
+ * 每个 (NC, KC) 面板内，B 打包与 (M 块 x N 条带) 计算均在线程池上并行
+ */
+
+#include "simd_internal.h"
+#include "simd_vecmath.h"
+
+#include <cstdlib>
+#include <cstring>
+#include <algorithm>
+
+#if defined(_MSC_VER)
+    #include <malloc.h>
+#endif
+
+namespace simd_internal {
+
+void* aligned_malloc(size_t size, size_t alignment) {
+    if (size == 0) {
+        size = alignment;
+    }
+#if defined(_MSC_VER)
+    return _aligned_malloc(size, alignment);
+#else
+    void* ptr = nullptr;
+    if (posix_memalign(&ptr, alignment, size) != 0) {
+        return nullptr;
+    }
+    return ptr;
+#endif
+}
+
+void aligned_free(void* ptr) {
+#if defined(_MSC_VER)
+    _aligned_free(ptr);
+#else
+    free(ptr);
+#endif
+}
+
+/**
+ * 按尾处理写回单个元素 (通用微内核与边界分块使用)
+ */
+static inline float apply_epilogue(float acc, const float* c, const SgemmEpilogue& ep,
+                                   int r, int col) {
+    float v = ep.alpha * acc;
+    if (ep.beta != 0.0f) {
+        v += ep.beta * *c;
+    }
+    if (ep.bias) {
+        v += ep.bias[col];
+    }
+    v = activation_scalar(v, ep.activation);
+    if (ep.residual) {
+        v += ep.residual[(size_t)r * ep.ldr + col];
+    }
+    return v;
+}
+
+// 通用微内核 (无显式SIMD，由编译器自动向量化)
+static const int GENERIC_MR = 4;
+static const int GENERIC_NR = 8;
+
+static void sgemm_ukernel_generic_4x8(int kc, const float* Ap, const float* Bp,
+                                      float* C, int ldc, const SgemmEpilogue& ep) {
+    float acc[GENERIC_MR][GENERIC_NR] = {};
+
+    for (int p = 0; p < kc; ++p) {
+        for (int i = 0; i < GENERIC_MR; ++i) {
+            const float a = Ap[i];
+            for (int j = 0; j < GENERIC_NR; ++j) {
+                acc[i][j] += a * Bp[j];
+            }
+        }
+        Ap += GENERIC_MR;
+        Bp += GENERIC_NR;
+    }
+
+    for (int i = 0; i < GENERIC_MR; ++i) {
+        float* c_row = C + (size_t)i * ldc;
+        for (int j = 0; j < GENERIC_NR; ++j) {
+            c_row[j] = apply_epilogue(acc[i][j], c_row + j, ep, i, j);
+        }
+    }
+}
+
+const SgemmKernelInfo* sgemm_kernel_generic() {
+    static const SgemmKernelInfo info = {
+        "baseline", GENERIC_MR, GENERIC_NR, 128, 256, 2048, sgemm_ukernel_generic_4x8
+    };
+    return &info;
+}
+
+/**
+ * 由缓存容量推导分块 (比例在 AVX-512/AVX2 节点上实测确定):
+ *   - kc: B 微面板 (kc x nr) 占满 L1d，A 微面板与 C 分块依靠预取流式读写；
+ *   - mc: 打包的 A 面板 (mc x kc) 占每个逻辑 CPU 的 L2 份额的 1/4，其余留给 B 微面板流；
+ *   - nc: B 面板 (kc x nc) 为所有线程共享，取 L3 的一半与 L2 份额 2 倍中的较小者
+ *         (更大的面板在共享 L3 中易被其他核挤出，而 A 的重复打包已足够摊销)
+ */
+SgemmBlocking sgemm_blocking(const SgemmKernelInfo* info) {
+    const CacheTopology& topo = cache_topology();
+    const int mr = info->mr;
+    const int nr = info->nr;
+    const size_t l2_share = topo.l2 / topo.l2_shared;
+    const size_t b_budget = topo.l3 ? std::min(topo.l3 / 2, 2 * l2_share) : 2 * l2_share;
+    SgemmBlocking blk;
+    blk.kc = cache_blocking(topo.l1d, nr * sizeof(float), 16, 128, 512, info->kc);
+    blk.mc = cache_blocking(l2_share / 4, (size_t)blk.kc * sizeof(float), mr, mr, 128 * mr, info->mc);
+    blk.nc = cache_blocking(b_budget, (size_t)blk.kc * sizeof(float), nr, nr, 256 * nr, info->nc);
+    return blk;
+}
+
+/**
+ * 打包 A 面板 (mc x kc) 为 MR 行条带，每个条带按列连续存放
+ * trans 非 0 时 A 以转置形式存储 (元素 (i, p) 位于 A[p * lda + i])
+ * 不足 MR 的尾部条带补零
+ */
+void sgemm_pack_a(int mc, int kc, const float* A, int lda, int trans, int mr, float* Ap) {
+    for (int i = 0; i < mc; i += mr) {
+        const int rows = std::min(mr, mc - i);
+        for (int p = 0; p < kc; ++p) {
+            int r = 0;
+            if (trans) {
+                const float* a_col = A + (size_t)p * lda + i;
+                for (; r < rows; ++r) {
+                    Ap[r] = a_col[r];
+                }
+            } else {
+                for (; r < rows; ++r) {
+                    Ap[r] = A[(size_t)(i + r) * lda + p];
+                }
+            }
+            for (; r < mr; ++r) {
+                Ap[r] = 0.0f;
+            }
+            Ap += mr;
+        }
+    }
+}
+
+/**
+ * 打包 B 面板 (kc x nc) 为 NR 列条带，每个条带按行连续存放
+ * trans 非 0 时 B 以转置形式存储 (元素 (p, j) 位于 B[j * ldb + p])
+ * 不足 NR 的尾部条带补零
+ */
+void sgemm_pack_b(int kc, int nc, const float* B, int ldb, int trans, int nr, float* Bp) {
+    const int tile = std::max(4, cache_topology().line_size / (int)sizeof(float));
+    for (int j = 0; j < nc; j += nr) {
+        const int cols = std::min(nr, nc - j);
+        if (trans) {
+            // 按一个缓存行的元素数分组做分块转置，读写的缓存行都留在 L1 内
+            for (int p0 = 0; p0 < kc; p0 += tile) {
+                const int p1 = std::min(kc, p0 + tile);
+                for (int c = 0; c < nr; ++c) {
+                    float* dst = Bp + (size_t)p0 * nr + c;
+                    if (c < cols) {
+                        const float* b_row = B + (size_t)(j + c) * ldb;
+                        for (int p = p0; p < p1; ++p, dst += nr) {
+                            *dst = b_row[p];
+                        }
+                    } else {
+                        for (int p = p0; p < p1; ++p, dst += nr) {
+                            *dst = 0.0f;
+                        }
+                    }
+                }
+            }
+            Bp += (size_t)kc * nr;
+            continue;
+        }
+        for (int p = 0; p < kc; ++p) {
+            const float* b_row = B + (size_t)p * ldb + j;
+            memcpy(Bp, b_row, cols * sizeof(float));
+            if (cols < nr) {
+                memset(Bp + cols, 0, (nr - cols) * sizeof(float));
+            }
+            Bp += nr;
+        }
+    }
+}
+
+/**
+ * 宏内核: 遍历打包面板，调用微内核计算 mc x nc 的 C 子块
+ * 边界分块写入临时缓冲区后再施加尾处理写回 C
+ * ep 的 bias/residual 指向本子块 C 起点对应的位置
+ */
+static void macro_kernel(const SgemmKernelInfo* info, int mc, int nc, int kc,
+                         const float* Ap, const float* Bp,
+                         float* C, int ldc, const SgemmEpilogue& ep, float* tile) {
+    const int mr = info->mr;
+    const int nr = info->nr;
+    const SgemmEpilogue raw = {1.0f, 0.0f, nullptr, SIMD_ACT_NONE, nullptr, 0};
+
+    for (int j = 0; j < nc; j += nr) {
+        const int cols = std::min(nr, nc - j);
+        const float* b_panel = Bp + (size_t)j * kc;
+
+        for (int i = 0; i < mc; i += mr) {
+            const int rows = std::min(mr, mc - i);
+            const float* a_panel = Ap + (size_t)i * kc;
+            float* c_tile = C + (size_t)i * ldc + j;
+
+            SgemmEpilogue tile_ep = ep;
+            if (ep.bias) {
+                tile_ep.bias = ep.bias + j;
+            }
+            if (ep.residual) {
+                tile_ep.residual = ep.residual + (size_t)i * ep.ldr + j;
+            }
+
+            if (rows == mr && cols == nr) {
+                info->kernel(kc, a_panel, b_panel, c_tile, ldc, tile_ep);
+                continue;
+            }
+
+            info->kernel(kc, a_panel, b_panel, tile, nr, raw);
+            for (int r = 0; r < rows; ++r) {
+                float* c_row = c_tile + (size_t)r * ldc;
+                const float* t_row = tile + (size_t)r * nr;
+                for (int c = 0; c < cols; ++c) {
+                    c_row[c] = apply_epilogue(t_row[c], c_row + c, tile_ep, r, c);
+                }
+            }
+        }
+    }
+}
+
+// 每个线程至少分到的计算量 (乘加次数)，低于此值时减少参与线程
+static const double GEMM_MIN_WORK_PER_THREAD = 64.0 * 64.0 * 64.0;
+
+/**
+ * 不分块的参考实现: 逐元素做内积后按尾处理写回，不需要任何临时缓冲区。
+ * 打包缓冲区分配失败时使用，保证 C 总是被写入
+ */
+static void sgemm_reference(int trans_a, int trans_b, int M, int N, int K,
+                            const float* A, int lda, const float* B, int ldb,
+                            float* C, int ldc, const SgemmEpilogue& ep) {
+    for (int i = 0; i < M; ++i) {
+        float* c_row = C + (size_t)i * ldc;
+        for (int j = 0; j < N; ++j) {
+            float acc = 0.0f;
+            for (int p = 0; p < K; ++p) {
+                const float a = trans_a ? A[(size_t)p * lda + i] : A[(size_t)i * lda + p];
+                const float b = trans_b ? B[(size_t)j * ldb + p] : B[(size_t)p * ldb + j];
+                acc += a * b;
+            }
+            c_row[j] = apply_epilogue(acc, c_row + j, ep, i, j);
+        }
+    }
+}
+
+void sgemm_blocked(const SgemmKernelInfo* info, int trans_a, int trans_b, int M, int N, int K,
+                   const float* A, int lda, const float* B, int ldb,
+                   float* C, int ldc, const SgemmEpilogue* epilogue, int max_threads) {
+    SgemmConfig cfg = sgemm_config(info);
+    if (max_threads > 0 && (cfg.max_threads <= 0 || max_threads < cfg.max_threads)) {
+        cfg.max_threads = max_threads;
+    }
+    sgemm_blocked_config(cfg, trans_a, trans_b, M, N, K, A, lda, B, ldb, C, ldc, epilogue);
+}
+
+void sgemm_blocked_config(const SgemmConfig& cfg, int trans_a, int trans_b, int M, int N, int K,
+                          const float* A, int lda, const float* B, int ldb,
+                          float* C, int ldc, const SgemmEpilogue* epilogue) {
+    if (M <= 0 || N <= 0) {
+        return;
+    }
+    const SgemmEpilogue plain = {1.0f, 0.0f, nullptr, SIMD_ACT_NONE, nullptr, 0};
+    const SgemmEpilogue& ep = epilogue ? *epilogue : plain;
+    if (K <= 0) {
+        sgemm_reference(trans_a, trans_b, M, N, 0, A, lda, B, ldb, C, ldc, ep);
+        return;
+    }
+
+    const SgemmKernelInfo* info = cfg.info;
+    const int mr = info->mr;
+    const int nr = info->nr;
+    const int KC = std::min(cfg.blk.kc, K);
+    const int NC = std::min(cfg.blk.nc, (N + nr - 1) / nr * nr);
+    int MC = std::min(cfg.blk.mc, (M + mr - 1) / mr * mr);
+
+    // 按计算量确定参与线程数
+    const double work = (double)M * N * K;
+    const int pool = cfg.max_threads == 1 ? 1 : thread_pool_size();
+    int nthreads = std::min(cfg.max_threads > 0 ? std::min(cfg.max_threads, pool) : pool,
+                            std::max(1, (int)(work / GEMM_MIN_WORK_PER_THREAD)));
+
+    // M 方向块数不足线程数时缩小 MC，仍不足时再沿 N 方向切分微面板
+    if (nthreads > 1 && (M + MC - 1) / MC < nthreads) {
+        const int rows_per_thread = (M + nthreads - 1) / nthreads;
+        MC = std::max(mr, (rows_per_thread + mr - 1) / mr * mr);
+    }
+    const int m_blocks = (M + MC - 1) / MC;
+    const int n_slivers = (NC + nr - 1) / nr;
+    const int n_splits = nthreads > 1
+        ? std::min(n_slivers, std::max(1, nthreads / m_blocks)) : 1;
+
+    const size_t a_stride = (size_t)MC * KC;
+    const size_t tile_stride = (size_t)mr * nr;
+    float* Ap = static_cast<float*>(scratch_alloc(a_stride * nthreads * sizeof(float)));
+    float* Bp = static_cast<float*>(scratch_alloc((size_t)NC * KC * sizeof(float)));
+    float* tiles = static_cast<float*>(scratch_alloc(tile_stride * nthreads * sizeof(float)));
+    if (!Ap || !Bp || !tiles) {
+        // 内存不足时退回不分块的参考实现，结果相同只是更慢
+        scratch_free(Ap);
+        scratch_free(Bp);
+        scratch_free(tiles);
+        sgemm_reference(trans_a, trans_b, M, N, K, A, lda, B, ldb, C, ldc, ep);
+        return;
+    }
+
+    for (int jc = 0; jc < N; jc += NC) {
+        const int nc = std::min(NC, N - jc);
+        const int nc_slivers = (nc + nr - 1) / nr;
+
+        for (int pc = 0; pc < K; pc += KC) {
+            const int kc = std::min(KC, K - pc);
+            const float* B_block = trans_b ? B + (size_t)jc * ldb + pc
+                                           : B + (size_t)pc * ldb + jc;
+
+            // 首个 K 分块按 beta 合并 C 原值，之后的分块累加；bias/激活/残差只在最后一个分块施加
+            SgemmEpilogue block_ep = ep;
+            if (pc > 0) {
+                block_ep.beta = 1.0f;
+            }
+            if (pc + kc < K) {
+                block_ep.bias = nullptr;
+                block_ep.activation = SIMD_ACT_NONE;
+                block_ep.residual = nullptr;
+            }
+
+            // 并行打包 B 面板，每个任务负责连续若干个 NR 条带
+            const int pack_tasks = std::min(nthreads, nc_slivers);
+            parallel_for(pack_tasks, nthreads, [&](int task, int) {
+                const int s0 = nc_slivers * task / pack_tasks;
+                const int s1 = nc_slivers * (task + 1) / pack_tasks;
+                const int j0 = s0 * nr;
+                const int j1 = std::min(nc, s1 * nr);
+                if (j0 < j1) {
+                    const float* B_sliver = trans_b ? B_block + (size_t)j0 * ldb : B_block + j0;
+                    sgemm_pack_b(kc, j1 - j0, B_sliver, ldb, trans_b, nr, Bp + (size_t)j0 * kc);
+                }
+            });
+
+            // 按 (M 块, N 条带组) 二维划分计算任务，各线程独立打包 A 面板
+            const int splits = std::min(n_splits, nc_slivers);
+            parallel_for(m_blocks * splits, nthreads, [&](int task, int tid) {
+                const int ic = (task / splits) * MC;
+                const int split = task % splits;
+                const int mc = std::min(MC, M - ic);
+                const int j0 = (nc_slivers * split / splits) * nr;
+                const int j1 = std::min(nc, (nc_slivers * (split + 1) / splits) * nr);
+                if (j0 >= j1) {
+                    return;
+                }
+
+                SgemmEpilogue task_ep = block_ep;
+                if (block_ep.bias) {
+                    task_ep.bias = block_ep.bias + jc + j0;
+                }
+                if (block_ep.residual) {
+                    task_ep.residual = block_ep.residual + (size_t)ic * ep.ldr + jc + j0;
+                }
+
+                float* Ap_local = Ap + a_stride * tid;
+                const float* A_block = trans_a ? A + (size_t)pc * lda + ic
+                                               : A + (size_t)ic * lda + pc;
+                sgemm_pack_a(mc, kc, A_block, lda, trans_a, mr, Ap_local);
+                macro_kernel(info, mc, j1 - j0, kc, Ap_local, Bp + (size_t)j0 * kc,
+                             C + (size_t)ic * ldc + jc + j0, ldc, task_ep,
+                             tiles + tile_stride * tid);
+            });
+        }
+    }
+
+    scratch_free(Ap);
+    scratch_free(Bp);
+    scratch_free(tiles);
+}
+
+void sgemm_batched_blocked(const SgemmKernelInfo* info, int trans_a, int trans_b,
+                           int M, int N, int K, float alpha,
+                           const float* const* A, int lda, const float* const* B, int ldb,
+                           float beta, float* const* C, int ldc, int batch_count) {
+    if (batch_count <= 0 || M <= 0 || N <= 0) {
+        return;
+    }
+    const SgemmEpilogue ep = {alpha, beta, nullptr, SIMD_ACT_NONE, nullptr, 0};
+    const double work = (double)M * N * (K > 0 ? K : 1);
+    const int threads = thread_pool_size();
+
+    // 矩阵数不少于线程数或单个矩阵太小时，整批按矩阵分配到线程，每个矩阵单线程计算；
+    // 否则逐个矩阵计算，由 sgemm_blocked 在矩阵内部并行
+    if (batch_count >= threads || work < 4 * GEMM_MIN_WORK_PER_THREAD) {
+        SgemmConfig cfg = sgemm_config(info);
+        cfg.max_threads = 1;
+        parallel_for(batch_count, 0, [&](int b, int) {
+            sgemm_blocked_config(cfg, trans_a, trans_b, M, N, K, A[b], lda, B[b], ldb, C[b], ldc, &ep);
+        });
+        return;
+    }
+    for (int b = 0; b < batch_count; ++b) {
+        sgemm_blocked(info, trans_a, trans_b, M, N, K, A[b], lda, B[b], ldb, C[b], ldc, &ep);
+    }
+}
+
+}  // namespace simd_internal
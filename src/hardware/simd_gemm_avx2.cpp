@@ -0,0 +1,117 @@
+/**
+ * AVX2/FMA GEMM 微内核 - VisionAI-ClipsMaster
+ * 6x16 寄存器分块: 12 个 ymm 累加器 + 2 个 B 向量 + 1 个 A 广播
+ */
+
+#include "simd_internal.h"
+
+#if defined(__AVX2__) && defined(__FMA__)
+#include <immintrin.h>
+#include "simd_vecmath.h"
+
+namespace simd_internal {
+
+static const int AVX2_MR = 6;
+static const int AVX2_NR = 16;
+
+/**
+ * 写回一行累加器 (2 个 ymm)，按 ep 施加缩放、累加、偏置、激活与残差
+ */
+static inline void store_row_avx2(float* c_row, __m256 v0, __m256 v1,
+                                  const SgemmEpilogue& ep, int r) {
+    if (ep.alpha != 1.0f) {
+        const __m256 alpha = _mm256_set1_ps(ep.alpha);
+        v0 = _mm256_mul_ps(v0, alpha);
+        v1 = _mm256_mul_ps(v1, alpha);
+    }
+    if (ep.beta == 1.0f) {
+        v0 = _mm256_add_ps(v0, _mm256_loadu_ps(c_row));
+        v1 = _mm256_add_ps(v1, _mm256_loadu_ps(c_row + 8));
+    } else if (ep.beta != 0.0f) {
+        const __m256 beta = _mm256_set1_ps(ep.beta);
+        v0 = _mm256_fmadd_ps(beta, _mm256_loadu_ps(c_row), v0);
+        v1 = _mm256_fmadd_ps(beta, _mm256_loadu_ps(c_row + 8), v1);
+    }
+    if (ep.bias) {
+        v0 = _mm256_add_ps(v0, _mm256_loadu_ps(ep.bias));
+        v1 = _mm256_add_ps(v1, _mm256_loadu_ps(ep.bias + 8));
+    }
+    if (ep.activation != SIMD_ACT_NONE) {
+        v0 = activation256_ps(v0, ep.activation);
+        v1 = activation256_ps(v1, ep.activation);
+    }
+    if (ep.residual) {
+        const float* res_row = ep.residual + (size_t)r * ep.ldr;
+        v0 = _mm256_add_ps(v0, _mm256_loadu_ps(res_row));
+        v1 = _mm256_add_ps(v1, _mm256_loadu_ps(res_row + 8));
+    }
+    _mm256_storeu_ps(c_row, v0);
+    _mm256_storeu_ps(c_row + 8, v1);
+}
+
+static void sgemm_ukernel_avx2_6x16(int kc, const float* Ap, const float* Bp,
+                                    float* C, int ldc, const SgemmEpilogue& ep) {
+    __m256 c00 = _mm256_setzero_ps(), c01 = _mm256_setzero_ps();
+    __m256 c10 = _mm256_setzero_ps(), c11 = _mm256_setzero_ps();
+    __m256 c20 = _mm256_setzero_ps(), c21 = _mm256_setzero_ps();
+    __m256 c30 = _mm256_setzero_ps(), c31 = _mm256_setzero_ps();
+    __m256 c40 = _mm256_setzero_ps(), c41 = _mm256_setzero_ps();
+    __m256 c50 = _mm256_setzero_ps(), c51 = _mm256_setzero_ps();
+
+    for (int p = 0; p < kc; ++p) {
+        _mm_prefetch(reinterpret_cast<const char*>(Bp + 8 * AVX2_NR), _MM_HINT_T0);
+        const __m256 b0 = _mm256_load_ps(Bp);
+        const __m256 b1 = _mm256_load_ps(Bp + 8);
+        __m256 a;
+
+        a = _mm256_broadcast_ss(Ap + 0);
+        c00 = _mm256_fmadd_ps(a, b0, c00);
+        c01 = _mm256_fmadd_ps(a, b1, c01);
+        a = _mm256_broadcast_ss(Ap + 1);
+        c10 = _mm256_fmadd_ps(a, b0, c10);
+        c11 = _mm256_fmadd_ps(a, b1, c11);
+        a = _mm256_broadcast_ss(Ap + 2);
+        c20 = _mm256_fmadd_ps(a, b0, c20);
+        c21 = _mm256_fmadd_ps(a, b1, c21);
+        a = _mm256_broadcast_ss(Ap + 3);
+        c30 = _mm256_fmadd_ps(a, b0, c30);
+        c31 = _mm256_fmadd_ps(a, b1, c31);
+        a = _mm256_broadcast_ss(Ap + 4);
+        c40 = _mm256_fmadd_ps(a, b0, c40);
+        c41 = _mm256_fmadd_ps(a, b1, c41);
+        a = _mm256_broadcast_ss(Ap + 5);
+        c50 = _mm256_fmadd_ps(a, b0, c50);
+        c51 = _mm256_fmadd_ps(a, b1, c51);
+
+        Ap += AVX2_MR;
+        Bp += AVX2_NR;
+    }
+
+#define STORE_ROW(r, v0, v1) store_row_avx2(C + (size_t)(r) * ldc, v0, v1, ep, r)
+
+    STORE_ROW(0, c00, c01);
+    STORE_ROW(1, c10, c11);
+    STORE_ROW(2, c20, c21);
+    STORE_ROW(3, c30, c31);
+    STORE_ROW(4, c40, c41);
+    STORE_ROW(5, c50, c51);
+
+#undef STORE_ROW
+}
+
+const SgemmKernelInfo* sgemm_kernel_avx2() {
+    static const SgemmKernelInfo info = {
+        "avx2", AVX2_MR, AVX2_NR, 144, 256, 4080, sgemm_ukernel_avx2_6x16
+    };
+    return &info;
+}
+
+}  // namespace simd_internal
+
+#else  // 未启用 AVX2/FMA 编译
+
+namespace simd_internal {
+const SgemmKernelInfo* sgemm_kernel_avx2() { return nullptr; }
+}
+
+#endif
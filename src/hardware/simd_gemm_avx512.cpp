@@ -0,0 +1,107 @@
+/**
+ * AVX-512 GEMM 微内核 - VisionAI-ClipsMaster
+ * 14x32 寄存器分块: 28 个 zmm 累加器 + 2 个 B 向量 + 1 个 A 广播
+ */
+
+#include "simd_internal.h"
+
+#if defined(__AVX512F__)
+#include <immintrin.h>
+#include "simd_vecmath.h"
+
+namespace simd_internal {
+
+static const int AVX512_MR = 14;
+static const int AVX512_NR = 32;
+
+/**
+ * 写回一行累加器 (2 个 zmm)，按 ep 施加缩放、累加、偏置、激活与残差
+ */
+static inline void store_row_avx512(float* c_row, __m512 v0, __m512 v1,
+                                    const SgemmEpilogue& ep, int r) {
+    if (ep.alpha != 1.0f) {
+        const __m512 alpha = _mm512_set1_ps(ep.alpha);
+        v0 = _mm512_mul_ps(v0, alpha);
+        v1 = _mm512_mul_ps(v1, alpha);
+    }
+    if (ep.beta == 1.0f) {
+        v0 = _mm512_add_ps(v0, _mm512_loadu_ps(c_row));
+        v1 = _mm512_add_ps(v1, _mm512_loadu_ps(c_row + 16));
+    } else if (ep.beta != 0.0f) {
+        const __m512 beta = _mm512_set1_ps(ep.beta);
+        v0 = _mm512_fmadd_ps(beta, _mm512_loadu_ps(c_row), v0);
+        v1 = _mm512_fmadd_ps(beta, _mm512_loadu_ps(c_row + 16), v1);
+    }
+    if (ep.bias) {
+        v0 = _mm512_add_ps(v0, _mm512_loadu_ps(ep.bias));
+        v1 = _mm512_add_ps(v1, _mm512_loadu_ps(ep.bias + 16));
+    }
+    if (ep.activation != SIMD_ACT_NONE) {
+        v0 = activation512_ps(v0, ep.activation);
+        v1 = activation512_ps(v1, ep.activation);
+    }
+    if (ep.residual) {
+        const float* res_row = ep.residual + (size_t)r * ep.ldr;
+        v0 = _mm512_add_ps(v0, _mm512_loadu_ps(res_row));
+        v1 = _mm512_add_ps(v1, _mm512_loadu_ps(res_row + 16));
+    }
+    _mm512_storeu_ps(c_row, v0);
+    _mm512_storeu_ps(c_row + 16, v1);
+}
+
+static void sgemm_ukernel_avx512_14x32(int kc, const float* Ap, const float* Bp,
+                                       float* C, int ldc, const SgemmEpilogue& ep) {
+#define DECLARE_ROW(r) __m512 c##r##0 = _mm512_setzero_ps(), c##r##1 = _mm512_setzero_ps()
+    DECLARE_ROW(0); DECLARE_ROW(1); DECLARE_ROW(2); DECLARE_ROW(3);
+    DECLARE_ROW(4); DECLARE_ROW(5); DECLARE_ROW(6); DECLARE_ROW(7);
+    DECLARE_ROW(8); DECLARE_ROW(9); DECLARE_ROW(10); DECLARE_ROW(11);
+    DECLARE_ROW(12); DECLARE_ROW(13);
+#undef DECLARE_ROW
+
+    for (int p = 0; p < kc; ++p) {
+        _mm_prefetch(reinterpret_cast<const char*>(Bp + 4 * AVX512_NR), _MM_HINT_T0);
+        _mm_prefetch(reinterpret_cast<const char*>(Ap + 4 * AVX512_MR), _MM_HINT_T0);
+        const __m512 b0 = _mm512_load_ps(Bp);
+        const __m512 b1 = _mm512_load_ps(Bp + 16);
+        __m512 a;
+
+#define FMA_ROW(r)                                   \
+        a = _mm512_set1_ps(Ap[r]);                   \
+        c##r##0 = _mm512_fmadd_ps(a, b0, c##r##0);   \
+        c##r##1 = _mm512_fmadd_ps(a, b1, c##r##1)
+
+        FMA_ROW(0); FMA_ROW(1); FMA_ROW(2); FMA_ROW(3);
+        FMA_ROW(4); FMA_ROW(5); FMA_ROW(6); FMA_ROW(7);
+        FMA_ROW(8); FMA_ROW(9); FMA_ROW(10); FMA_ROW(11);
+        FMA_ROW(12); FMA_ROW(13);
+#undef FMA_ROW
+
+        Ap += AVX512_MR;
+        Bp += AVX512_NR;
+    }
+
+#define STORE_ROW(r) store_row_avx512(C + (size_t)(r) * ldc, c##r##0, c##r##1, ep, r)
+
+    STORE_ROW(0); STORE_ROW(1); STORE_ROW(2); STORE_ROW(3);
+    STORE_ROW(4); STORE_ROW(5); STORE_ROW(6); STORE_ROW(7);
+    STORE_ROW(8); STORE_ROW(9); STORE_ROW(10); STORE_ROW(11);
+    STORE_ROW(12); STORE_ROW(13);
+#undef STORE_ROW
+}
+
+const SgemmKernelInfo* sgemm_kernel_avx512() {
+    static const SgemmKernelInfo info = {
+        "avx512", AVX512_MR, AVX512_NR, 140, 256, 3072, sgemm_ukernel_avx512_14x32
+    };
+    return &info;
+}
+
+}  // namespace simd_internal
+
+#else  // 未启用 AVX-512 编译
+
+namespace simd_internal {
+const SgemmKernelInfo* sgemm_kernel_avx512() { return nullptr; }
+}
+
+#endif
@@ -0,0 +1,385 @@
+/**
+ * GEMV 内核族 (batch 1 解码) - VisionAI-ClipsMaster
+ *
+ * y = W x，W 按 [N, K] 行主序存储 (与 Linear 层权重布局一致)，支持 fp32、
+ * fp16、按行缩放的 int8 与按组缩放的 int4 权重。解码时每个权重只读一次，
+ * 耗时取决于权重流式读取的带宽: 内核一次处理多行以共享 x 的加载、
+ * 每行使用多个累加器并提前预取，驱动层按行区间把权重流均匀分给线程池。
+ *
+ * 打包权重 (simd_gemv_pack_weights) 在多 NUMA 节点上为每个节点保存一份大页副本，
+ * 每个任务读取执行线程所在节点的副本，解码带宽随路数扩展。
+ */
+
+#include "simd_kernels.h"
+#include "simd_internal.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+namespace simd_internal {
+
+// 每个线程至少分到的权重字节数，过小时线程调度开销超过带宽收益
+static const size_t GEMV_MIN_TASK_BYTES = 1 << 18;
+
+// 行区间起点对齐到内核一次处理的行数
+static const int GEMV_ROW_ALIGN = 4;
+
+namespace {
+
+inline float half_to_float(uint16_t h) {
+    const uint32_t sign = (uint32_t)(h & 0x8000) << 16;
+    uint32_t exp = (h >> 10) & 0x1F;
+    uint32_t mant = h & 0x3FF;
+    uint32_t bits;
+    if (exp == 0x1F) {
+        bits = sign | 0x7F800000u | (mant << 13);
+    } else if (exp != 0) {
+        bits = sign | ((exp + 112) << 23) | (mant << 13);
+    } else if (mant == 0) {
+        bits = sign;
+    } else {
+        // 非规格化数: 规格化尾数后调整指数
+        exp = 113;
+        while (!(mant & 0x400)) {
+            mant <<= 1;
+            --exp;
+        }
+        bits = sign | (exp << 23) | ((mant & 0x3FF) << 13);
+    }
+    float f;
+    memcpy(&f, &bits, sizeof(f));
+    return f;
+}
+
+}  // namespace
+
+static void gemv_f32_generic(const GemvArgs& a, int n0, int n1) {
+    const float* W = static_cast<const float*>(a.W);
+    for (int n = n0; n < n1; ++n) {
+        const float* w = W + (size_t)n * a.ldw;
+        float sum = 0.0f;
+        for (int k = 0; k < a.K; ++k) {
+            sum += w[k] * a.x[k];
+        }
+        gemv_store(a, n, sum);
+    }
+}
+
+static void gemv_f16_generic(const GemvArgs& a, int n0, int n1) {
+    const uint16_t* W = static_cast<const uint16_t*>(a.W);
+    for (int n = n0; n < n1; ++n) {
+        const uint16_t* w = W + (size_t)n * a.ldw;
+        float sum = 0.0f;
+        for (int k = 0; k < a.K; ++k) {
+            sum += half_to_float(w[k]) * a.x[k];
+        }
+        gemv_store(a, n, sum);
+    }
+}
+
+static void gemv_q8_generic(const GemvArgs& a, int n0, int n1) {
+    const signed char* W = static_cast<const signed char*>(a.W);
+    for (int n = n0; n < n1; ++n) {
+        const signed char* w = W + (size_t)n * a.ldw;
+        float sum = 0.0f;
+        for (int k = 0; k < a.K; ++k) {
+            sum += (float)w[k] * a.x[k];
+        }
+        gemv_store(a, n, sum * a.scales[n]);
+    }
+}
+
+void gemv_q4_generic(const GemvArgs& a, int n0, int n1) {
+    const unsigned char* W = static_cast<const unsigned char*>(a.W);
+    const int groups = a.K / a.group_size;
+    for (int n = n0; n < n1; ++n) {
+        const unsigned char* w = W + (size_t)n * a.ldw;
+        const float* s = a.scales + (size_t)n * groups;
+        float sum = 0.0f;
+        for (int g = 0; g < groups; ++g) {
+            float gsum = 0.0f;
+            for (int k = g * a.group_size; k < (g + 1) * a.group_size; k += 2) {
+                const unsigned char b = w[k / 2];
+                gsum += (float)((int)(b & 0x0F) - 8) * a.x[k] +
+                        (float)((int)(b >> 4) - 8) * a.x[k + 1];
+            }
+            sum += gsum * s[g];
+        }
+        gemv_store(a, n, sum);
+    }
+}
+
+const GemvKernels* gemv_kernels_generic() {
+    static const GemvKernels kernels = {
+        "generic", gemv_f32_generic, gemv_f16_generic, gemv_q8_generic, gemv_q4_generic
+    };
+    return &kernels;
+}
+
+/**
+ * 按行区间切分到线程池: 每个线程一段连续的行，使各线程的权重读取保持顺序流。
+ * node_replica 非空时 args 为各 NUMA 节点的权重副本，node_replica[节点编号] 为该节点的副本下标，
+ * 任务读取执行线程所在节点的副本
+ */
+static void run_gemv(gemv_fn fn, const GemvArgs* args, const std::vector<int>* node_replica,
+                     int N, size_t row_bytes) {
+    if (N <= 0) {
+        return;
+    }
+    const size_t total = row_bytes * (size_t)N;
+    const int max_tasks = (int)std::min<size_t>((size_t)thread_pool_size(),
+                                                total / GEMV_MIN_TASK_BYTES);
+    const int row_groups = (N + GEMV_ROW_ALIGN - 1) / GEMV_ROW_ALIGN;
+    const int tasks = std::max(1, std::min(max_tasks, row_groups));
+    auto local_args = [&]() -> const GemvArgs& {
+        if (!node_replica) {
+            return args[0];
+        }
+        const int node = numa_current_node();
+        return args[node >= 0 && node < (int)node_replica->size() ? (*node_replica)[node] : 0];
+    };
+    if (tasks == 1) {
+        fn(local_args(), 0, N);
+        return;
+    }
+    const int rows_per_task = (row_groups + tasks - 1) / tasks * GEMV_ROW_ALIGN;
+    parallel_for(tasks, 0, [&](int task, int) {
+        const int n0 = task * rows_per_task;
+        const int n1 = std::min(N, n0 + rows_per_task);
+        if (n0 < n1) {
+            fn(local_args(), n0, n1);
+        }
+    });
+}
+
+}  // namespace simd_internal
+
+namespace {
+
+bool valid_gemv_shape(int N, int K, int ldw) {
+    return N >= 0 && K >= 0 && ldw >= K;
+}
+
+bool valid_q4_shape(int N, int K, int ldw, int group_size) {
+    return N >= 0 && K >= 0 && group_size > 0 && group_size % 2 == 0 &&
+           K % group_size == 0 && ldw >= K / 2;
+}
+
+// 打包权重的副本数上限 (每个 NUMA 节点一份)
+const int GEMV_MAX_REPLICAS = 8;
+
+simd_internal::GemvArgs make_gemv_args(const void* W, int ldw, const float* scales,
+                                       const float* x, const float* bias, float* y, int K) {
+    const simd_internal::GemvArgs args = {W, (size_t)ldw, scales, 0, x, bias, y, K};
+    return args;
+}
+
+}  // namespace
+
+/**
+ * fp32 权重 GEMV
+ */
+void simd_gemv_f32(const float* W, int ldw, const float* x, const float* bias,
+                   float* y, int N, int K) {
+    if (!valid_gemv_shape(N, K, ldw)) {
+        return;
+    }
+    const simd_internal::GemvArgs args = make_gemv_args(W, ldw, nullptr, x, bias, y, K);
+    simd_internal::run_gemv(simd_internal::dispatch_table().gemv->f32, &args, nullptr, N,
+                            (size_t)K * sizeof(float));
+}
+
+/**
+ * fp16 权重 GEMV (IEEE half，按 uint16 传入)
+ */
+void simd_gemv_f16(const unsigned short* W, int ldw, const float* x, const float* bias,
+                   float* y, int N, int K) {
+    if (!valid_gemv_shape(N, K, ldw)) {
+        return;
+    }
+    const simd_internal::GemvArgs args = make_gemv_args(W, ldw, nullptr, x, bias, y, K);
+    simd_internal::run_gemv(simd_internal::dispatch_table().gemv->f16, &args, nullptr, N,
+                            (size_t)K * sizeof(uint16_t));
+}
+
+/**
+ * int8 权重 GEMV (按输出行对称量化)
+ */
+void simd_gemv_q8(const signed char* W, int ldw, const float* scales, const float* x,
+                  const float* bias, float* y, int N, int K) {
+    if (!valid_gemv_shape(N, K, ldw) || !scales) {
+        return;
+    }
+    const simd_internal::GemvArgs args = make_gemv_args(W, ldw, scales, x, bias, y, K);
+    simd_internal::run_gemv(simd_internal::dispatch_table().gemv->q8, &args, nullptr, N, (size_t)K);
+}
+
+/**
+ * int4 权重 GEMV (按组对称量化，每字节两个权重)
+ */
+void simd_gemv_q4(const unsigned char* W, int ldw, const float* scales, int group_size,
+                  const float* x, const float* bias, float* y, int N, int K) {
+    if (!scales || !valid_q4_shape(N, K, ldw, group_size)) {
+        return;
+    }
+    simd_internal::GemvArgs args = make_gemv_args(W, ldw, scales, x, bias, y, K);
+    args.group_size = group_size;
+    simd_internal::run_gemv(simd_internal::dispatch_table().gemv->q4, &args, nullptr, N, (size_t)K / 2);
+}
+
+/**
+ * 打包权重: 每个副本为一个大页区域，行紧密排列 (ldw = 行宽)，缩放系数紧随其后
+ */
+struct SimdGemvWeights {
+    int type;
+    int N;
+    int K;
+    size_t row_bytes;
+    std::vector<void*> regions;
+    std::vector<simd_internal::GemvArgs> args;      // 各副本的权重与缩放指针
+    std::vector<int> node_replica;                  // 节点编号 -> 副本下标 (无本节点副本时为 0)
+};
+
+SimdGemvWeights* simd_gemv_pack_weights(int type, const void* W, int ldw, const float* scales,
+                                        int group_size, int N, int K, int replicas) {
+    using namespace simd_internal;
+    size_t row_bytes = 0;
+    size_t ld_bytes = 0;
+    size_t scale_count = 0;
+    switch (type) {
+        case SIMD_GEMV_F32:
+        case SIMD_GEMV_F16: {
+            if (!valid_gemv_shape(N, K, ldw)) {
+                return nullptr;
+            }
+            const size_t elem = type == SIMD_GEMV_F32 ? sizeof(float) : sizeof(uint16_t);
+            row_bytes = (size_t)K * elem;
+            ld_bytes = (size_t)ldw * elem;
+            break;
+        }
+        case SIMD_GEMV_Q8:
+            if (!scales || !valid_gemv_shape(N, K, ldw)) {
+                return nullptr;
+            }
+            row_bytes = (size_t)K;
+            ld_bytes = (size_t)ldw;
+            scale_count = (size_t)N;
+            break;
+        case SIMD_GEMV_Q4:
+            if (!scales || !valid_q4_shape(N, K, ldw, group_size)) {
+                return nullptr;
+            }
+            row_bytes = (size_t)K / 2;
+            ld_bytes = (size_t)ldw;
+            scale_count = (size_t)N * (K / group_size);
+            break;
+        default:
+            return nullptr;
+    }
+    if (!W) {
+        return nullptr;
+    }
+
+    const std::vector<int>& online = numa_online_nodes();
+    const int nodes = (int)online.size();
+    const int count = std::max(1, std::min(replicas > 0 ? std::min(replicas, nodes) : nodes,
+                                           GEMV_MAX_REPLICAS));
+    const size_t weight_bytes = (row_bytes * N + 63) / 64 * 64;
+    const size_t region_bytes = weight_bytes + scale_count * sizeof(float);
+
+    SimdGemvWeights* w = new SimdGemvWeights();
+    w->type = type;
+    w->N = N;
+    w->K = K;
+    w->row_bytes = row_bytes;
+    w->node_replica.assign(numa_node_count(), 0);
+    // 由调用线程写入，页面按区域策略落到目标节点
+    auto add_replica = [&](char* base) {
+        w->regions.push_back(base);
+        const char* src = static_cast<const char*>(W);
+        for (int n = 0; n < N; ++n) {
+            memcpy(base + row_bytes * n, src + ld_bytes * n, row_bytes);
+        }
+        float* replica_scales = nullptr;
+        if (scale_count > 0) {
+            replica_scales = reinterpret_cast<float*>(base + weight_bytes);
+            memcpy(replica_scales, scales, scale_count * sizeof(float));
+        }
+        // q4 的行距以字节计，其余以元素计
+        const size_t ldw_packed = type == SIMD_GEMV_Q4 ? row_bytes : (size_t)K;
+        const GemvArgs args = {base, ldw_packed, replica_scales, group_size, nullptr, nullptr, nullptr, K};
+        w->args.push_back(args);
+    };
+    // 多份时每份绑定到一个在线节点；mbind 失败的副本页面不会落在目标节点，直接丢弃
+    if (count > 1) {
+        for (int r = 0; r < count; ++r) {
+            char* base = static_cast<char*>(region_alloc(region_bytes, SIMD_MEM_HUGEPAGE,
+                                                         SIMD_NUMA_BIND, online[r]));
+            if (!base) {
+                simd_gemv_free_weights(w);
+                return nullptr;
+            }
+            if (!(region_flags(base) & SIMD_MEM_NUMA)) {
+                region_free(base);
+                continue;
+            }
+            w->node_replica[online[r]] = (int)w->args.size();
+            add_replica(base);
+        }
+        // 只剩一份绑定副本时其他节点全部远程读取，不如改用一份交错的共享副本
+        if (w->args.size() < 2) {
+            for (void* region : w->regions) {
+                region_free(region);
+            }
+            w->regions.clear();
+            w->args.clear();
+            std::fill(w->node_replica.begin(), w->node_replica.end(), 0);
+        }
+    }
+    // 只有一份时由所有节点的线程共享，多节点下按页交错
+    if (w->args.empty()) {
+        char* base = static_cast<char*>(region_alloc(region_bytes, SIMD_MEM_HUGEPAGE,
+                                                     nodes > 1 ? SIMD_NUMA_INTERLEAVE : SIMD_NUMA_DEFAULT, -1));
+        if (!base) {
+            simd_gemv_free_weights(w);
+            return nullptr;
+        }
+        add_replica(base);
+    }
+    return w;
+}
+
+void simd_gemv_free_weights(SimdGemvWeights* weights) {
+    if (!weights) {
+        return;
+    }
+    for (void* region : weights->regions) {
+        simd_internal::region_free(region);
+    }
+    delete weights;
+}
+
+int simd_gemv_weights_replicas(const SimdGemvWeights* weights) {
+    return weights ? (int)weights->args.size() : 0;
+}
+
+void simd_gemv_packed(const SimdGemvWeights* weights, const float* x, const float* bias, float* y) {
+    using namespace simd_internal;
+    if (!weights || !x || !y) {
+        return;
+    }
+    const GemvKernels* kernels = dispatch_table().gemv;
+    const gemv_fn fns[] = {kernels->f32, kernels->f16, kernels->q8, kernels->q4};
+    GemvArgs args[GEMV_MAX_REPLICAS];
+    const int count = (int)weights->args.size();
+    for (int r = 0; r < count; ++r) {
+        args[r] = weights->args[r];
+        args[r].x = x;
+        args[r].bias = bias;
+        args[r].y = y;
+    }
+    run_gemv(fns[weights->type], args, count > 1 ? &weights->node_replica : nullptr,
+             weights->N, weights->row_bytes);
+}
@@ -0,0 +1,207 @@
+/**
+ * AVX2/FMA GEMV 内核 - VisionAI-ClipsMaster
+ * 一次处理 4 行权重并预取下 4 行，每行两个累加器 (每步 16 个元素)，
+ * x 的每次加载由 4 行共享；fp16/int8/int4 权重在寄存器内展开为 fp32 后乘加
+ */
+
+#include "simd_internal.h"
+
+#if defined(__AVX2__) && defined(__FMA__)
+#include <immintrin.h>
+#include <cstdint>
+
+namespace simd_internal {
+
+static const int AVX2_GEMV_ROWS = 4;
+
+
+namespace {
+
+inline float hsum256(__m256 v) {
+    const __m128 s = _mm_add_ps(_mm256_castps256_ps128(v), _mm256_extractf128_ps(v, 1));
+    const __m128 t = _mm_add_ps(s, _mm_movehl_ps(s, s));
+    return _mm_cvtss_f32(_mm_add_ss(t, _mm_movehdup_ps(t)));
+}
+
+// 各权重类型: 一次展开 8 个元素，尾部逐个展开
+struct LoadF32 {
+    typedef float T;
+    static __m256 load(const float* p) { return _mm256_loadu_ps(p); }
+    static float scalar(const float* p) { return *p; }
+};
+
+struct LoadF16 {
+    typedef uint16_t T;
+    static __m256 load(const uint16_t* p) {
+        return _mm256_cvtph_ps(_mm_loadu_si128(reinterpret_cast<const __m128i*>(p)));
+    }
+    static float scalar(const uint16_t* p) { return _cvtsh_ss(*p); }
+};
+
+struct LoadQ8 {
+    typedef signed char T;
+    static __m256 load(const signed char* p) {
+        return _mm256_cvtepi32_ps(_mm256_cvtepi8_epi32(
+            _mm_loadl_epi64(reinterpret_cast<const __m128i*>(p))));
+    }
+    static float scalar(const signed char* p) { return (float)*p; }
+};
+
+template <typename L, int R>
+inline void dot_rows_avx2(const typename L::T* const* w, size_t pf, const float* x, int K,
+                           float* out) {
+    // 预取下一组行的同一位置，每步覆盖本步读取的全部缓存行
+    const int lines = (16 * (int)sizeof(typename L::T) + 63) / 64;
+    __m256 acc0[R], acc1[R];
+    for (int r = 0; r < R; ++r) {
+        acc0[r] = _mm256_setzero_ps();
+        acc1[r] = _mm256_setzero_ps();
+    }
+    int k = 0;
+    for (; k + 16 <= K; k += 16) {
+        const __m256 x0 = _mm256_loadu_ps(x + k);
+        const __m256 x1 = _mm256_loadu_ps(x + k + 8);
+        for (int r = 0; r < R; ++r) {
+            for (int l = 0; l < lines; ++l) {
+                _mm_prefetch(reinterpret_cast<const char*>(w[r] + pf + k) + 64 * l, _MM_HINT_T0);
+            }
+            acc0[r] = _mm256_fmadd_ps(L::load(w[r] + k), x0, acc0[r]);
+            acc1[r] = _mm256_fmadd_ps(L::load(w[r] + k + 8), x1, acc1[r]);
+        }
+    }
+    if (k + 8 <= K) {
+        const __m256 x0 = _mm256_loadu_ps(x + k);
+        for (int r = 0; r < R; ++r) {
+            acc0[r] = _mm256_fmadd_ps(L::load(w[r] + k), x0, acc0[r]);
+        }
+        k += 8;
+    }
+    for (int r = 0; r < R; ++r) {
+        float sum = hsum256(_mm256_add_ps(acc0[r], acc1[r]));
+        for (int kk = k; kk < K; ++kk) {
+            sum += L::scalar(w[r] + kk) * x[kk];
+        }
+        out[r] = sum;
+    }
+}
+
+template <typename L>
+void gemv_rows_avx2(const GemvArgs& a, int n0, int n1) {
+    typedef typename L::T T;
+    const T* W = static_cast<const T*>(a.W);
+    float out[AVX2_GEMV_ROWS];
+    int n = n0;
+    for (; n + AVX2_GEMV_ROWS <= n1; n += AVX2_GEMV_ROWS) {
+        const T* w[AVX2_GEMV_ROWS];
+        for (int r = 0; r < AVX2_GEMV_ROWS; ++r) {
+            w[r] = W + (size_t)(n + r) * a.ldw;
+        }
+        dot_rows_avx2<L, AVX2_GEMV_ROWS>(w, AVX2_GEMV_ROWS * a.ldw, a.x, a.K, out);
+        for (int r = 0; r < AVX2_GEMV_ROWS; ++r) {
+            gemv_store(a, n + r, a.scales ? out[r] * a.scales[n + r] : out[r]);
+        }
+    }
+    for (; n < n1; ++n) {
+        const T* w[1] = {W + (size_t)n * a.ldw};
+        dot_rows_avx2<L, 1>(w, a.ldw, a.x, a.K, out);
+        gemv_store(a, n, a.scales ? out[0] * a.scales[n] : out[0]);
+    }
+}
+
+/**
+ * int4 按 16 个元素一步: 8 字节零扩展到 32 位通道后，低/高 4 位分别对应偶数/奇数 k，
+ * x 相应地拆成偶数/奇数部分 (由所有行共享)，避免逐行交错展开；
+ * 偏移 8 不在内层减去，而是在组结束时减去 8 * sum(x) 后再乘组缩放
+ */
+template <int R>
+inline void dot_rows_q4_avx2(const GemvArgs& a, int n, float* out) {
+    const int gs = a.group_size;
+    const int groups = a.K / gs;
+    const __m256i nibble = _mm256_set1_epi32(0x0F);
+    const unsigned char* w[R];
+    const float* s[R];
+    __m256 total[R];
+    for (int r = 0; r < R; ++r) {
+        w[r] = static_cast<const unsigned char*>(a.W) + (size_t)(n + r) * a.ldw;
+        s[r] = a.scales + (size_t)(n + r) * groups;
+        total[r] = _mm256_setzero_ps();
+    }
+    for (int g = 0; g < groups; ++g) {
+        __m256 acc0[R], acc1[R];
+        for (int r = 0; r < R; ++r) {
+            acc0[r] = _mm256_setzero_ps();
+            acc1[r] = _mm256_setzero_ps();
+        }
+        __m256 xsum = _mm256_setzero_ps();
+        for (int k = g * gs; k < (g + 1) * gs; k += 16) {
+            const __m256 xa = _mm256_loadu_ps(a.x + k);
+            const __m256 xb = _mm256_loadu_ps(a.x + k + 8);
+            // shuffle_ps 在 128 位内交错两个源，再按 64 位重排回 k 顺序
+            const __m256 x_even = _mm256_castpd_ps(_mm256_permute4x64_pd(
+                _mm256_castps_pd(_mm256_shuffle_ps(xa, xb, _MM_SHUFFLE(2, 0, 2, 0))),
+                _MM_SHUFFLE(3, 1, 2, 0)));
+            const __m256 x_odd = _mm256_castpd_ps(_mm256_permute4x64_pd(
+                _mm256_castps_pd(_mm256_shuffle_ps(xa, xb, _MM_SHUFFLE(3, 1, 3, 1))),
+                _MM_SHUFFLE(3, 1, 2, 0)));
+            xsum = _mm256_add_ps(xsum, _mm256_add_ps(xa, xb));
+            for (int r = 0; r < R; ++r) {
+                const unsigned char* p = w[r] + k / 2;
+                _mm_prefetch(reinterpret_cast<const char*>(p + R * a.ldw), _MM_HINT_T0);
+                const __m256i b = _mm256_cvtepu8_epi32(
+                    _mm_loadl_epi64(reinterpret_cast<const __m128i*>(p)));
+                const __m256 lo = _mm256_cvtepi32_ps(_mm256_and_si256(b, nibble));
+                const __m256 hi = _mm256_cvtepi32_ps(_mm256_srli_epi32(b, 4));
+                acc0[r] = _mm256_fmadd_ps(lo, x_even, acc0[r]);
+                acc1[r] = _mm256_fmadd_ps(hi, x_odd, acc1[r]);
+            }
+        }
+        for (int r = 0; r < R; ++r) {
+            const __m256 q = _mm256_fnmadd_ps(xsum, _mm256_set1_ps(8.0f),
+                                              _mm256_add_ps(acc0[r], acc1[r]));
+            total[r] = _mm256_fmadd_ps(q, _mm256_set1_ps(s[r][g]), total[r]);
+        }
+    }
+    for (int r = 0; r < R; ++r) {
+        out[r] = hsum256(total[r]);
+    }
+}
+
+void gemv_q4_avx2(const GemvArgs& a, int n0, int n1) {
+    // 每步展开 16 个元素，分组长度须为其整数倍
+    if (a.group_size % 16 != 0) {
+        gemv_q4_generic(a, n0, n1);
+        return;
+    }
+    float out[AVX2_GEMV_ROWS];
+    int n = n0;
+    for (; n + AVX2_GEMV_ROWS <= n1; n += AVX2_GEMV_ROWS) {
+        dot_rows_q4_avx2<AVX2_GEMV_ROWS>(a, n, out);
+        for (int r = 0; r < AVX2_GEMV_ROWS; ++r) {
+            gemv_store(a, n + r, out[r]);
+        }
+    }
+    for (; n < n1; ++n) {
+        dot_rows_q4_avx2<1>(a, n, out);
+        gemv_store(a, n, out[0]);
+    }
+}
+
+}  // namespace
+
+const GemvKernels* gemv_kernels_avx2() {
+    static const GemvKernels kernels = {
+        "avx2", gemv_rows_avx2<LoadF32>, gemv_rows_avx2<LoadF16>, gemv_rows_avx2<LoadQ8>,
+        gemv_q4_avx2
+    };
+    return &kernels;
+}
+
+}  // namespace simd_internal
+
+#else  // 未启用 AVX2/FMA 编译
+
+namespace simd_internal {
+const GemvKernels* gemv_kernels_avx2() { return nullptr; }
+}
+
+#endif
@@ -0,0 +1,205 @@
+/**
+ * AVX-512 GEMV 内核 - VisionAI-ClipsMaster
+ * 一次处理 4 行权重并预取下 4 行，每行两个累加器 (每步 32 个元素)，
+ * x 的每次加载由 4 行共享；不足 16 个元素的尾部使用掩码加载，无需标量收尾
+ */
+
+#include "simd_internal.h"
+
+#if defined(__AVX512F__) && defined(__AVX512BW__) && defined(__AVX512VL__)
+#include <immintrin.h>
+#include <cstdint>
+
+#if defined(__GNUC__) && !defined(__clang__)
+// GCC 12 对 _mm512_undefined_* 的 -W(maybe-)uninitialized 误报 (见 _mm512_cvtph_ps)
+#pragma GCC diagnostic ignored "-Wmaybe-uninitialized"
+#pragma GCC diagnostic ignored "-Wuninitialized"
+#endif
+
+namespace simd_internal {
+
+static const int AVX512_GEMV_ROWS = 4;
+
+
+namespace {
+
+// 各权重类型: 一次展开 16 个元素，load_mask 只读取掩码内的元素
+struct LoadF32 {
+    typedef float T;
+    static __m512 load(const float* p) { return _mm512_loadu_ps(p); }
+    static __m512 load_mask(const float* p, __mmask16 m) { return _mm512_maskz_loadu_ps(m, p); }
+};
+
+struct LoadF16 {
+    typedef uint16_t T;
+    static __m512 load(const uint16_t* p) {
+        return _mm512_cvtph_ps(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(p)));
+    }
+    static __m512 load_mask(const uint16_t* p, __mmask16 m) {
+        return _mm512_cvtph_ps(_mm256_maskz_loadu_epi16(m, p));
+    }
+};
+
+struct LoadQ8 {
+    typedef signed char T;
+    static __m512 load(const signed char* p) {
+        return _mm512_cvtepi32_ps(_mm512_cvtepi8_epi32(
+            _mm_loadu_si128(reinterpret_cast<const __m128i*>(p))));
+    }
+    static __m512 load_mask(const signed char* p, __mmask16 m) {
+        return _mm512_cvtepi32_ps(_mm512_cvtepi8_epi32(_mm_maskz_loadu_epi8(m, p)));
+    }
+};
+
+template <typename L, int R>
+inline void dot_rows_avx512(const typename L::T* const* w, size_t pf, const float* x, int K,
+                             float* out) {
+    // 预取下一组行的同一位置，每步覆盖本步读取的全部缓存行
+    const int lines = (32 * (int)sizeof(typename L::T) + 63) / 64;
+    __m512 acc0[R], acc1[R];
+    for (int r = 0; r < R; ++r) {
+        acc0[r] = _mm512_setzero_ps();
+        acc1[r] = _mm512_setzero_ps();
+    }
+    int k = 0;
+    for (; k + 32 <= K; k += 32) {
+        const __m512 x0 = _mm512_loadu_ps(x + k);
+        const __m512 x1 = _mm512_loadu_ps(x + k + 16);
+        for (int r = 0; r < R; ++r) {
+            for (int l = 0; l < lines; ++l) {
+                _mm_prefetch(reinterpret_cast<const char*>(w[r] + pf + k) + 64 * l, _MM_HINT_T0);
+            }
+            acc0[r] = _mm512_fmadd_ps(L::load(w[r] + k), x0, acc0[r]);
+            acc1[r] = _mm512_fmadd_ps(L::load(w[r] + k + 16), x1, acc1[r]);
+        }
+    }
+    for (; k < K; k += 16) {
+        const __mmask16 m = K - k >= 16 ? (__mmask16)0xFFFF : (__mmask16)((1u << (K - k)) - 1);
+        const __m512 x0 = _mm512_maskz_loadu_ps(m, x + k);
+        for (int r = 0; r < R; ++r) {
+            acc0[r] = _mm512_fmadd_ps(L::load_mask(w[r] + k, m), x0, acc0[r]);
+        }
+    }
+    for (int r = 0; r < R; ++r) {
+        out[r] = _mm512_reduce_add_ps(_mm512_add_ps(acc0[r], acc1[r]));
+    }
+}
+
+template <typename L>
+void gemv_rows_avx512(const GemvArgs& a, int n0, int n1) {
+    typedef typename L::T T;
+    const T* W = static_cast<const T*>(a.W);
+    float out[AVX512_GEMV_ROWS];
+    int n = n0;
+    for (; n + AVX512_GEMV_ROWS <= n1; n += AVX512_GEMV_ROWS) {
+        const T* w[AVX512_GEMV_ROWS];
+        for (int r = 0; r < AVX512_GEMV_ROWS; ++r) {
+            w[r] = W + (size_t)(n + r) * a.ldw;
+        }
+        dot_rows_avx512<L, AVX512_GEMV_ROWS>(w, AVX512_GEMV_ROWS * a.ldw, a.x, a.K, out);
+        for (int r = 0; r < AVX512_GEMV_ROWS; ++r) {
+            gemv_store(a, n + r, a.scales ? out[r] * a.scales[n + r] : out[r]);
+        }
+    }
+    for (; n < n1; ++n) {
+        const T* w[1] = {W + (size_t)n * a.ldw};
+        dot_rows_avx512<L, 1>(w, a.ldw, a.x, a.K, out);
+        gemv_store(a, n, a.scales ? out[0] * a.scales[n] : out[0]);
+    }
+}
+
+/**
+ * int4 按 32 个元素一步: 16 字节零扩展到 32 位通道后，低/高 4 位分别对应偶数/奇数 k，
+ * x 相应地拆成偶数/奇数部分 (由所有行共享)，避免逐行交错展开；
+ * 偏移 8 不在内层减去，而是在组结束时减去 8 * sum(x) 后再乘组缩放
+ */
+template <int R>
+inline void dot_rows_q4_avx512(const GemvArgs& a, int n, float* out) {
+    const int gs = a.group_size;
+    const int groups = a.K / gs;
+    const __m512i nibble = _mm512_set1_epi32(0x0F);
+    const __m512i even_idx = _mm512_setr_epi32(0, 2, 4, 6, 8, 10, 12, 14,
+                                               16, 18, 20, 22, 24, 26, 28, 30);
+    const __m512i odd_idx = _mm512_add_epi32(even_idx, _mm512_set1_epi32(1));
+    const unsigned char* w[R];
+    const float* s[R];
+    __m512 total[R];
+    for (int r = 0; r < R; ++r) {
+        w[r] = static_cast<const unsigned char*>(a.W) + (size_t)(n + r) * a.ldw;
+        s[r] = a.scales + (size_t)(n + r) * groups;
+        total[r] = _mm512_setzero_ps();
+    }
+    for (int g = 0; g < groups; ++g) {
+        __m512 acc0[R], acc1[R];
+        for (int r = 0; r < R; ++r) {
+            acc0[r] = _mm512_setzero_ps();
+            acc1[r] = _mm512_setzero_ps();
+        }
+        __m512 xsum = _mm512_setzero_ps();
+        for (int k = g * gs; k < (g + 1) * gs; k += 32) {
+            const __m512 xa = _mm512_loadu_ps(a.x + k);
+            const __m512 xb = _mm512_loadu_ps(a.x + k + 16);
+            const __m512 x_even = _mm512_permutex2var_ps(xa, even_idx, xb);
+            const __m512 x_odd = _mm512_permutex2var_ps(xa, odd_idx, xb);
+            xsum = _mm512_add_ps(xsum, _mm512_add_ps(xa, xb));
+            for (int r = 0; r < R; ++r) {
+                const unsigned char* p = w[r] + k / 2;
+                _mm_prefetch(reinterpret_cast<const char*>(p + R * a.ldw), _MM_HINT_T0);
+                const __m512i b = _mm512_cvtepu8_epi32(
+                    _mm_loadu_si128(reinterpret_cast<const __m128i*>(p)));
+                const __m512 lo = _mm512_cvtepi32_ps(_mm512_and_si512(b, nibble));
+                const __m512 hi = _mm512_cvtepi32_ps(_mm512_srli_epi32(b, 4));
+                acc0[r] = _mm512_fmadd_ps(lo, x_even, acc0[r]);
+                acc1[r] = _mm512_fmadd_ps(hi, x_odd, acc1[r]);
+            }
+        }
+        for (int r = 0; r < R; ++r) {
+            const __m512 q = _mm512_fnmadd_ps(xsum, _mm512_set1_ps(8.0f),
+                                              _mm512_add_ps(acc0[r], acc1[r]));
+            total[r] = _mm512_fmadd_ps(q, _mm512_set1_ps(s[r][g]), total[r]);
+        }
+    }
+    for (int r = 0; r < R; ++r) {
+        out[r] = _mm512_reduce_add_ps(total[r]);
+    }
+}
+
+void gemv_q4_avx512(const GemvArgs& a, int n0, int n1) {
+    // 每步展开 32 个元素，分组长度须为其整数倍
+    if (a.group_size % 32 != 0) {
+        gemv_q4_generic(a, n0, n1);
+        return;
+    }
+    float out[AVX512_GEMV_ROWS];
+    int n = n0;
+    for (; n + AVX512_GEMV_ROWS <= n1; n += AVX512_GEMV_ROWS) {
+        dot_rows_q4_avx512<AVX512_GEMV_ROWS>(a, n, out);
+        for (int r = 0; r < AVX512_GEMV_ROWS; ++r) {
+            gemv_store(a, n + r, out[r]);
+        }
+    }
+    for (; n < n1; ++n) {
+        dot_rows_q4_avx512<1>(a, n, out);
+        gemv_store(a, n, out[0]);
+    }
+}
+
+}  // namespace
+
+const GemvKernels* gemv_kernels_avx512() {
+    static const GemvKernels kernels = {
+        "avx512", gemv_rows_avx512<LoadF32>, gemv_rows_avx512<LoadF16>, gemv_rows_avx512<LoadQ8>,
+        gemv_q4_avx512
+    };
+    return &kernels;
+}
+
+}  // namespace simd_internal
+
+#else  // 未启用 AVX-512 编译
+
+namespace simd_internal {
+const GemvKernels* gemv_kernels_avx512() { return nullptr; }
+}
+
+#endif
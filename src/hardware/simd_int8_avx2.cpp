@@ -0,0 +1,89 @@
+/**
+ * AVX2 INT8 GEMM 微内核 - VisionAI-ClipsMaster
+ * 4 x 16 寄存器分块，无 VNNI 时以 pmaddubsw + pmaddwd 组合实现四元点积。
+ * pmaddubsw 要求第一个操作数无符号且会饱和到 int16，这里取 |a| 并把 a 的符号移到
+ * 权重上 (psignb)，激活与权重均限制在 [-127, 127]，成对乘积和不超过 32258，不会饱和
+ */
+
+#include "simd_internal.h"
+
+#if defined(__AVX2__) && defined(__FMA__)
+#include <immintrin.h>
+#include <cstring>
+
+namespace simd_internal {
+
+static const int AVX2_INT8_MR = 4;
+static const int AVX2_INT8_NR = 16;
+
+template <int ROWS>
+static void s8gemm_tile_avx2(int kp, const unsigned char* A, int lda, const signed char* Bp,
+                             const float* a_scales, const float* b_scales, const int* b_comp,
+                             float* C, int ldc, int n) {
+    const __m256i ones = _mm256_set1_epi16(1);
+    __m256i acc[ROWS][2];
+    for (int i = 0; i < ROWS; ++i) {
+        acc[i][0] = _mm256_setzero_si256();
+        acc[i][1] = _mm256_setzero_si256();
+    }
+
+    for (int k = 0; k < kp; k += 4) {
+        const __m256i b0 = _mm256_load_si256(reinterpret_cast<const __m256i*>(Bp));
+        const __m256i b1 = _mm256_load_si256(reinterpret_cast<const __m256i*>(Bp + 32));
+        for (int i = 0; i < ROWS; ++i) {
+            int a4;
+            memcpy(&a4, A + (size_t)i * lda + k, sizeof(a4));
+            const __m256i a = _mm256_set1_epi32(a4);
+            const __m256i abs_a = _mm256_abs_epi8(a);
+            const __m256i p0 = _mm256_maddubs_epi16(abs_a, _mm256_sign_epi8(b0, a));
+            const __m256i p1 = _mm256_maddubs_epi16(abs_a, _mm256_sign_epi8(b1, a));
+            acc[i][0] = _mm256_add_epi32(acc[i][0], _mm256_madd_epi16(p0, ones));
+            acc[i][1] = _mm256_add_epi32(acc[i][1], _mm256_madd_epi16(p1, ones));
+        }
+        Bp += AVX2_INT8_NR * 4;
+    }
+
+    for (int j = 0; j < 2; ++j) {
+        const int rem = n - j * 8;
+        if (rem <= 0) {
+            break;
+        }
+        const __m256i comp = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(b_comp + j * 8));
+        const __m256 bs = _mm256_loadu_ps(b_scales + j * 8);
+        const __m256i mask = _mm256_cmpgt_epi32(_mm256_set1_epi32(rem),
+                                                _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7));
+        for (int i = 0; i < ROWS; ++i) {
+            const __m256 v = _mm256_cvtepi32_ps(_mm256_sub_epi32(acc[i][j], comp));
+            const __m256 r = _mm256_mul_ps(v, _mm256_mul_ps(bs, _mm256_set1_ps(a_scales[i])));
+            _mm256_maskstore_ps(C + (size_t)i * ldc + j * 8, mask, r);
+        }
+    }
+}
+
+static void s8gemm_ukernel_avx2(int kp, const unsigned char* A, int lda, const signed char* Bp,
+                                const float* a_scales, const float* b_scales, const int* b_comp,
+                                float* C, int ldc, int m, int n) {
+    switch (m) {
+    case 4: s8gemm_tile_avx2<4>(kp, A, lda, Bp, a_scales, b_scales, b_comp, C, ldc, n); break;
+    case 3: s8gemm_tile_avx2<3>(kp, A, lda, Bp, a_scales, b_scales, b_comp, C, ldc, n); break;
+    case 2: s8gemm_tile_avx2<2>(kp, A, lda, Bp, a_scales, b_scales, b_comp, C, ldc, n); break;
+    default: s8gemm_tile_avx2<1>(kp, A, lda, Bp, a_scales, b_scales, b_comp, C, ldc, n); break;
+    }
+}
+
+const Int8GemmKernelInfo* int8_gemm_kernel_avx2() {
+    static const Int8GemmKernelInfo info = {
+        "avx2", AVX2_INT8_MR, AVX2_INT8_NR, 0, s8gemm_ukernel_avx2
+    };
+    return &info;
+}
+
+}  // namespace simd_internal
+
+#else  // 未启用 AVX2/FMA 编译
+
+namespace simd_internal {
+const Int8GemmKernelInfo* int8_gemm_kernel_avx2() { return nullptr; }
+}
+
+#endif
@@ -0,0 +1,95 @@
+/**
+ * AVX512-VNNI INT8 GEMM 微内核 - VisionAI-ClipsMaster
+ * 6 x 64 寄存器分块，vpdpbusd 完成 u8 x s8 四元点积累加，
+ * 激活以 q + 128 存储，偏移量由打包时预计算的列和补偿
+ */
+
+#include "simd_internal.h"
+
+#if defined(__AVX512F__) && defined(__AVX512BW__) && defined(__AVX512VNNI__)
+#include <immintrin.h>
+#include <cstring>
+
+#if defined(__GNUC__) && !defined(__clang__)
+// GCC 12 对 _mm512_undefined_* 的 -Wmaybe-uninitialized 误报
+#pragma GCC diagnostic ignored "-Wmaybe-uninitialized"
+#endif
+
+namespace simd_internal {
+
+static const int AVX512VNNI_INT8_MR = 6;
+static const int AVX512VNNI_INT8_NR = 64;
+
+template <int ROWS>
+static void s8gemm_tile_avx512vnni(int kp, const unsigned char* A, int lda, const signed char* Bp,
+                                   const float* a_scales, const float* b_scales, const int* b_comp,
+                                   float* C, int ldc, int n) {
+    __m512i acc[ROWS][4];
+    for (int i = 0; i < ROWS; ++i) {
+        for (int j = 0; j < 4; ++j) {
+            acc[i][j] = _mm512_setzero_si512();
+        }
+    }
+
+    for (int k = 0; k < kp; k += 4) {
+        const __m512i b0 = _mm512_load_si512(Bp);
+        const __m512i b1 = _mm512_load_si512(Bp + 64);
+        const __m512i b2 = _mm512_load_si512(Bp + 128);
+        const __m512i b3 = _mm512_load_si512(Bp + 192);
+        for (int i = 0; i < ROWS; ++i) {
+            int a4;
+            memcpy(&a4, A + (size_t)i * lda + k, sizeof(a4));
+            const __m512i a = _mm512_set1_epi32(a4);
+            acc[i][0] = _mm512_dpbusd_epi32(acc[i][0], a, b0);
+            acc[i][1] = _mm512_dpbusd_epi32(acc[i][1], a, b1);
+            acc[i][2] = _mm512_dpbusd_epi32(acc[i][2], a, b2);
+            acc[i][3] = _mm512_dpbusd_epi32(acc[i][3], a, b3);
+        }
+        Bp += AVX512VNNI_INT8_NR * 4;
+    }
+
+    for (int j = 0; j < 4; ++j) {
+        const int rem = n - j * 16;
+        if (rem <= 0) {
+            break;
+        }
+        const __mmask16 mask = rem >= 16 ? (__mmask16)0xFFFF : (__mmask16)((1u << rem) - 1);
+        const __m512i comp = _mm512_loadu_si512(b_comp + j * 16);
+        const __m512 bs = _mm512_loadu_ps(b_scales + j * 16);
+        for (int i = 0; i < ROWS; ++i) {
+            const __m512 v = _mm512_cvtepi32_ps(_mm512_sub_epi32(acc[i][j], comp));
+            const __m512 s = _mm512_mul_ps(bs, _mm512_set1_ps(a_scales[i]));
+            _mm512_mask_storeu_ps(C + (size_t)i * ldc + j * 16, mask, _mm512_mul_ps(v, s));
+        }
+    }
+}
+
+static void s8gemm_ukernel_avx512vnni(int kp, const unsigned char* A, int lda, const signed char* Bp,
+                                      const float* a_scales, const float* b_scales, const int* b_comp,
+                                      float* C, int ldc, int m, int n) {
+    switch (m) {
+    case 6: s8gemm_tile_avx512vnni<6>(kp, A, lda, Bp, a_scales, b_scales, b_comp, C, ldc, n); break;
+    case 5: s8gemm_tile_avx512vnni<5>(kp, A, lda, Bp, a_scales, b_scales, b_comp, C, ldc, n); break;
+    case 4: s8gemm_tile_avx512vnni<4>(kp, A, lda, Bp, a_scales, b_scales, b_comp, C, ldc, n); break;
+    case 3: s8gemm_tile_avx512vnni<3>(kp, A, lda, Bp, a_scales, b_scales, b_comp, C, ldc, n); break;
+    case 2: s8gemm_tile_avx512vnni<2>(kp, A, lda, Bp, a_scales, b_scales, b_comp, C, ldc, n); break;
+    default: s8gemm_tile_avx512vnni<1>(kp, A, lda, Bp, a_scales, b_scales, b_comp, C, ldc, n); break;
+    }
+}
+
+const Int8GemmKernelInfo* int8_gemm_kernel_avx512vnni() {
+    static const Int8GemmKernelInfo info = {
+        "avx512_vnni", AVX512VNNI_INT8_MR, AVX512VNNI_INT8_NR, 128, s8gemm_ukernel_avx512vnni
+    };
+    return &info;
+}
+
+}  // namespace simd_internal
+
+#else  // 未启用 AVX512-VNNI 编译
+
+namespace simd_internal {
+const Int8GemmKernelInfo* int8_gemm_kernel_avx512vnni() { return nullptr; }
+}
+
+#endif
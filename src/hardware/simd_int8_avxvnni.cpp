@@ -0,0 +1,86 @@
+/**
+ * AVX-VNNI INT8 GEMM 微内核 - VisionAI-ClipsMaster
+ * 6 x 16 寄存器分块，VEX 编码的 vpdpbusd 完成 u8 x s8 四元点积累加，
+ * 用于支持 AVX-VNNI 但不支持 AVX-512 的 CPU (Alder Lake 及之后的客户端处理器)
+ */
+
+#include "simd_internal.h"
+
+#if defined(__AVX2__) && defined(__AVXVNNI__)
+#include <immintrin.h>
+#include <cstring>
+
+namespace simd_internal {
+
+static const int AVXVNNI_INT8_MR = 6;
+static const int AVXVNNI_INT8_NR = 16;
+
+template <int ROWS>
+static void s8gemm_tile_avxvnni(int kp, const unsigned char* A, int lda, const signed char* Bp,
+                                const float* a_scales, const float* b_scales, const int* b_comp,
+                                float* C, int ldc, int n) {
+    __m256i acc[ROWS][2];
+    for (int i = 0; i < ROWS; ++i) {
+        acc[i][0] = _mm256_setzero_si256();
+        acc[i][1] = _mm256_setzero_si256();
+    }
+
+    for (int k = 0; k < kp; k += 4) {
+        const __m256i b0 = _mm256_load_si256(reinterpret_cast<const __m256i*>(Bp));
+        const __m256i b1 = _mm256_load_si256(reinterpret_cast<const __m256i*>(Bp + 32));
+        for (int i = 0; i < ROWS; ++i) {
+            int a4;
+            memcpy(&a4, A + (size_t)i * lda + k, sizeof(a4));
+            const __m256i a = _mm256_set1_epi32(a4);
+            acc[i][0] = _mm256_dpbusd_avx_epi32(acc[i][0], a, b0);
+            acc[i][1] = _mm256_dpbusd_avx_epi32(acc[i][1], a, b1);
+        }
+        Bp += AVXVNNI_INT8_NR * 4;
+    }
+
+    for (int j = 0; j < 2; ++j) {
+        const int rem = n - j * 8;
+        if (rem <= 0) {
+            break;
+        }
+        const __m256i comp = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(b_comp + j * 8));
+        const __m256 bs = _mm256_loadu_ps(b_scales + j * 8);
+        const __m256i mask = _mm256_cmpgt_epi32(_mm256_set1_epi32(rem),
+                                                _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7));
+        for (int i = 0; i < ROWS; ++i) {
+            const __m256 v = _mm256_cvtepi32_ps(_mm256_sub_epi32(acc[i][j], comp));
+            const __m256 r = _mm256_mul_ps(v, _mm256_mul_ps(bs, _mm256_set1_ps(a_scales[i])));
+            _mm256_maskstore_ps(C + (size_t)i * ldc + j * 8, mask, r);
+        }
+    }
+}
+
+static void s8gemm_ukernel_avxvnni(int kp, const unsigned char* A, int lda, const signed char* Bp,
+                                   const float* a_scales, const float* b_scales, const int* b_comp,
+                                   float* C, int ldc, int m, int n) {
+    switch (m) {
+    case 6: s8gemm_tile_avxvnni<6>(kp, A, lda, Bp, a_scales, b_scales, b_comp, C, ldc, n); break;
+    case 5: s8gemm_tile_avxvnni<5>(kp, A, lda, Bp, a_scales, b_scales, b_comp, C, ldc, n); break;
+    case 4: s8gemm_tile_avxvnni<4>(kp, A, lda, Bp, a_scales, b_scales, b_comp, C, ldc, n); break;
+    case 3: s8gemm_tile_avxvnni<3>(kp, A, lda, Bp, a_scales, b_scales, b_comp, C, ldc, n); break;
+    case 2: s8gemm_tile_avxvnni<2>(kp, A, lda, Bp, a_scales, b_scales, b_comp, C, ldc, n); break;
+    default: s8gemm_tile_avxvnni<1>(kp, A, lda, Bp, a_scales, b_scales, b_comp, C, ldc, n); break;
+    }
+}
+
+const Int8GemmKernelInfo* int8_gemm_kernel_avxvnni() {
+    static const Int8GemmKernelInfo info = {
+        "avx_vnni", AVXVNNI_INT8_MR, AVXVNNI_INT8_NR, 128, s8gemm_ukernel_avxvnni
+    };
+    return &info;
+}
+
+}  // namespace simd_internal
+
+#else  // 未启用 AVX-VNNI 编译
+
+namespace simd_internal {
+const Int8GemmKernelInfo* int8_gemm_kernel_avxvnni() { return nullptr; }
+}
+
+#endif
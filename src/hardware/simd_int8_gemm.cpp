@@ -0,0 +1,284 @@
+/**
+ * INT8 GEMM (动态激活量化) - VisionAI-ClipsMaster
+ *
+ * C(M x N) = A(M x K, fp32) * W(K x N)
+ * 权重按输出通道对称量化为 int8 并预先打包；激活在每次调用时按行动态量化，
+ * int8 x int8 -> int32 累加后在微内核中直接乘以行/列缩放写回 fp32。
+ * 微内核按 CPU 选择: AVX512-VNNI / AVX-VNNI 使用 vpdpbusd，
+ * 其余 AVX2 CPU 使用 pmaddubsw，最后回退到通用实现。
+ */
+
+#include "simd_kernels.h"
+#include "simd_internal.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <vector>
+
+/**
+ * 打包后的 int8 权重 (布局取决于打包时选定的微内核)
+ */
+struct SimdInt8Weights {
+    const simd_internal::Int8GemmKernelInfo* kernel;
+    int K;
+    int N;
+    int kp;                 // K 向上取整到 4
+    int np;                 // N 向上取整到 NR
+    signed char* packed;    // [np / NR][kp / 4][NR][4]
+    float* scales;          // [np] 每个输出通道的缩放
+    int* comp;              // [np] act_offset * sum_k W[k, n]
+};
+
+namespace simd_internal {
+
+static const int GENERIC_INT8_MR = 4;
+static const int GENERIC_INT8_NR = 16;
+
+// 低于该乘加次数时直接在调用线程执行
+static const double INT8_MIN_PARALLEL_WORK = 1 << 20;
+
+static void s8gemm_ukernel_generic(int kp, const unsigned char* A, int lda, const signed char* Bp,
+                                   const float* a_scales, const float* b_scales, const int* b_comp,
+                                   float* C, int ldc, int m, int n) {
+    int acc[GENERIC_INT8_MR][GENERIC_INT8_NR];
+    memset(acc, 0, sizeof(acc));
+    const signed char* a_rows = reinterpret_cast<const signed char*>(A);
+    for (int k = 0; k < kp; k += 4) {
+        for (int i = 0; i < m; ++i) {
+            const signed char* a = a_rows + (size_t)i * lda + k;
+            for (int j = 0; j < GENERIC_INT8_NR; ++j) {
+                const signed char* b = Bp + j * 4;
+                acc[i][j] += a[0] * b[0] + a[1] * b[1] + a[2] * b[2] + a[3] * b[3];
+            }
+        }
+        Bp += GENERIC_INT8_NR * 4;
+    }
+    for (int i = 0; i < m; ++i) {
+        for (int j = 0; j < n; ++j) {
+            C[(size_t)i * ldc + j] = a_scales[i] * b_scales[j] * (float)(acc[i][j] - b_comp[j]);
+        }
+    }
+}
+
+const Int8GemmKernelInfo* int8_gemm_kernel_generic() {
+    static const Int8GemmKernelInfo info = {
+        "generic", GENERIC_INT8_MR, GENERIC_INT8_NR, 0, s8gemm_ukernel_generic
+    };
+    return &info;
+}
+
+namespace {
+
+inline int round_up(int x, int multiple) {
+    return (x + multiple - 1) / multiple * multiple;
+}
+
+inline int quantize_s8(float x, float inv_scale) {
+    const int q = (int)std::lrint(x * inv_scale);
+    return q > 127 ? 127 : (q < -127 ? -127 : q);
+}
+
+/**
+ * 按行对称量化激活: scale = max|A[i, :]| / 127，K 之后补零到 kp
+ */
+void quantize_activations(const float* A, int lda, int M, int K, int kp, int act_offset,
+                          unsigned char* Aq, float* a_scales) {
+    parallel_for_range((size_t)M, 16, [=](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i) {
+            const float* a = A + i * lda;
+            unsigned char* q = Aq + i * kp;
+            float amax = 0.0f;
+            for (int k = 0; k < K; ++k) {
+                amax = std::max(amax, std::fabs(a[k]));
+            }
+            const float scale = amax / 127.0f;
+            const float inv = amax > 0.0f ? 127.0f / amax : 0.0f;
+            for (int k = 0; k < K; ++k) {
+                q[k] = (unsigned char)(quantize_s8(a[k], inv) + act_offset);
+            }
+            for (int k = K; k < kp; ++k) {
+                q[k] = (unsigned char)act_offset;
+            }
+            a_scales[i] = scale;
+        }
+    });
+}
+
+SimdInt8Weights* pack_int8_weights(const Int8GemmKernelInfo* kernel, const signed char* Wq,
+                                   const float* scales, int K, int N, int ldw) {
+    SimdInt8Weights* w = new SimdInt8Weights();
+    const int nr = kernel->nr;
+    w->kernel = kernel;
+    w->K = K;
+    w->N = N;
+    w->kp = round_up(K, 4);
+    w->np = round_up(N, nr);
+    w->packed = static_cast<signed char*>(weight_alloc((size_t)w->np * w->kp));
+    w->scales = static_cast<float*>(aligned_malloc(sizeof(float) * w->np));
+    w->comp = static_cast<int*>(aligned_malloc(sizeof(int) * w->np));
+    if (!w->packed || !w->scales || !w->comp) {
+        simd_int8_free_weights(w);
+        return nullptr;
+    }
+
+    for (int n = 0; n < w->np; ++n) {
+        int colsum = 0;
+        if (n < N) {
+            for (int k = 0; k < K; ++k) {
+                colsum += Wq[(size_t)k * ldw + n];
+            }
+        }
+        w->scales[n] = n < N ? scales[n] : 0.0f;
+        w->comp[n] = kernel->act_offset * colsum;
+    }
+
+    const int panels = w->np / nr;
+    parallel_for_range((size_t)panels, 1, [&](size_t begin, size_t end) {
+        for (size_t p = begin; p < end; ++p) {
+            signed char* dst = w->packed + p * (size_t)nr * w->kp;
+            for (int k4 = 0; k4 < w->kp; k4 += 4) {
+                for (int j = 0; j < nr; ++j) {
+                    const int n = (int)p * nr + j;
+                    for (int t = 0; t < 4; ++t) {
+                        const int k = k4 + t;
+                        *dst++ = (k < K && n < N) ? Wq[(size_t)k * ldw + n] : 0;
+                    }
+                }
+            }
+        }
+    });
+    return w;
+}
+
+}  // namespace
+
+}  // namespace simd_internal
+
+/**
+ * 按输出通道对称量化 fp32 权重 W(K x N, 行距 ldw) 并打包
+ * 返回的句柄需通过 simd_int8_free_weights 释放
+ */
+SimdInt8Weights* simd_int8_pack_weights(const float* W, int K, int N, int ldw) {
+    using namespace simd_internal;
+    if (!W || K <= 0 || N <= 0 || ldw < N) {
+        return nullptr;
+    }
+    std::vector<float> amax(N, 0.0f);
+    for (int k = 0; k < K; ++k) {
+        const float* row = W + (size_t)k * ldw;
+        for (int n = 0; n < N; ++n) {
+            amax[n] = std::max(amax[n], std::fabs(row[n]));
+        }
+    }
+    std::vector<float> scales(N);
+    std::vector<float> inv(N);
+    for (int n = 0; n < N; ++n) {
+        scales[n] = amax[n] / 127.0f;
+        inv[n] = amax[n] > 0.0f ? 127.0f / amax[n] : 0.0f;
+    }
+    std::vector<signed char> Wq((size_t)K * N);
+    for (int k = 0; k < K; ++k) {
+        const float* row = W + (size_t)k * ldw;
+        signed char* q = Wq.data() + (size_t)k * N;
+        for (int n = 0; n < N; ++n) {
+            q[n] = (signed char)quantize_s8(row[n], inv[n]);
+        }
+    }
+    return pack_int8_weights(dispatch_table().int8, Wq.data(), scales.data(), K, N, N);
+}
+
+/**
+ * 打包已量化的 int8 权重 Wq(K x N, 行距 ldw)，scales 为每个输出通道的缩放 [N]
+ * 权重取值须在 [-127, 127] 内: -128 取绝对值会溢出 (AVX2 路径借助 abs/sign 做有符号乘法)，
+ * 出现时返回 nullptr
+ */
+SimdInt8Weights* simd_int8_pack_quantized(const signed char* Wq, const float* scales,
+                                          int K, int N, int ldw) {
+    if (!Wq || !scales || K <= 0 || N <= 0 || ldw < N) {
+        return nullptr;
+    }
+    for (int k = 0; k < K; ++k) {
+        const signed char* row = Wq + (size_t)k * ldw;
+        for (int n = 0; n < N; ++n) {
+            if (row[n] == -128) {
+                return nullptr;
+            }
+        }
+    }
+    return simd_internal::pack_int8_weights(simd_internal::dispatch_table().int8,
+                                            Wq, scales, K, N, ldw);
+}
+
+void simd_int8_free_weights(SimdInt8Weights* weights) {
+    if (!weights) {
+        return;
+    }
+    simd_internal::weight_free(weights->packed);
+    simd_internal::aligned_free(weights->scales);
+    simd_internal::aligned_free(weights->comp);
+    delete weights;
+}
+
+/**
+ * C(M x N, 行距 ldc) = A(M x K, 行距 lda) * W
+ * A 按行动态量化为 int8，输出反量化在微内核写回时完成
+ * 参数非法返回 -1，激活量化缓冲区分配失败返回 -2 (此时不写 C)，成功返回 0
+ */
+int simd_int8_gemm(const float* A, int lda, const SimdInt8Weights* weights,
+                   float* C, int ldc, int M) {
+    using namespace simd_internal;
+    if (!A || !weights || !C || M <= 0 || lda < weights->K || ldc < weights->N) {
+        return -1;
+    }
+    const Int8GemmKernelInfo* kernel = weights->kernel;
+    const int kp = weights->kp;
+    const int N = weights->N;
+
+    unsigned char* Aq = static_cast<unsigned char*>(scratch_alloc((size_t)M * kp));
+    float* a_scales = static_cast<float*>(scratch_alloc(sizeof(float) * M));
+    if (!Aq || !a_scales) {
+        scratch_free(Aq);
+        scratch_free(a_scales);
+        return -2;
+    }
+    quantize_activations(A, lda, M, weights->K, kp, kernel->act_offset, Aq, a_scales);
+
+    // 按 N 面板 x M 行块切分任务，权重面板在同一任务内被所有行块复用
+    const int mr = kernel->mr;
+    const int nr = kernel->nr;
+    const int n_panels = weights->np / nr;
+    const int m_blocks = (M + mr - 1) / mr;
+    const double work = (double)M * N * kp;
+    const int threads = work < INT8_MIN_PARALLEL_WORK ? 1 : thread_pool_size();
+    const int n_chunks = std::min(n_panels, 4 * threads);
+    const int m_chunks = std::min(m_blocks, std::max(1, (4 * threads + n_chunks - 1) / n_chunks));
+    const int panels_per_chunk = (n_panels + n_chunks - 1) / n_chunks;
+    const int blocks_per_chunk = (m_blocks + m_chunks - 1) / m_chunks;
+
+    parallel_for(n_chunks * m_chunks, threads, [&](int task, int) {
+        const int p_begin = (task % n_chunks) * panels_per_chunk;
+        const int p_end = std::min(n_panels, p_begin + panels_per_chunk);
+        const int b_begin = (task / n_chunks) * blocks_per_chunk;
+        const int b_end = std::min(m_blocks, b_begin + blocks_per_chunk);
+        for (int p = p_begin; p < p_end; ++p) {
+            const int n0 = p * nr;
+            const signed char* Bp = weights->packed + (size_t)p * nr * kp;
+            for (int b = b_begin; b < b_end; ++b) {
+                const int m0 = b * mr;
+                kernel->kernel(kp, Aq + (size_t)m0 * kp, kp, Bp,
+                               a_scales + m0, weights->scales + n0, weights->comp + n0,
+                               C + (size_t)m0 * ldc + n0, ldc,
+                               std::min(mr, M - m0), std::min(nr, N - n0));
+            }
+        }
+    });
+
+    scratch_free(Aq);
+    scratch_free(a_scales);
+    return 0;
+}
+
+const char* simd_int8_get_variant(void) {
+    return simd_internal::dispatch_table().int8->name;
+}
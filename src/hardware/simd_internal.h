@@ -0,0 +1,505 @@
+/**
+ * SIMD 内核内部头文件 - VisionAI-ClipsMaster
+ * 仅供 simd_kernels 库内部各编译单元共享，不对外导出
+ */
+
+#ifndef VISIONAI_SIMD_INTERNAL_H
+#define VISIONAI_SIMD_INTERNAL_H
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+#include "simd_kernels.h"
+
+namespace simd_internal {
+
+/**
+ * GEMM 写回尾处理 (对应 SimdGemmEpilogue，驱动层按 K 分块改写)
+ *   C = act(alpha * acc + beta * C + bias) + residual
+ * bias/residual/activation 仅在最后一个 K 分块生效，指针均已偏移到当前分块起点
+ */
+struct SgemmEpilogue {
+    float alpha;
+    float beta;                 // 0 时不读取 C 原值
+    const float* bias;          // nullptr 表示无
+    int activation;             // SIMD_ACT_*
+    const float* residual;      // nullptr 表示无
+    int ldr;
+};
+
+/**
+ * GEMM 微内核: 计算 MR x NR 的寄存器分块
+ *   acc = Ap(MR x kc, 按列打包) * Bp(kc x NR, 按行打包)
+ * 写回 C 时按 ep 施加缩放、累加与激活
+ */
+typedef void (*sgemm_ukernel_fn)(int kc, const float* Ap, const float* Bp,
+                                 float* C, int ldc, const SgemmEpilogue& ep);
+
+/**
+ * GEMM 微内核描述: 寄存器分块形状与缓存分块参数
+ */
+struct SgemmKernelInfo {
+    const char* name;       // 指令集名称
+    int mr;                 // 微内核行数
+    int nr;                 // 微内核列数
+    int mc;                 // A 面板行数 (L2 分块，缓存拓扑未知时的默认值，下同)
+    int kc;                 // 公共维度分块 (L1 分块)
+    int nc;                 // B 面板列数 (L3 分块)
+    sgemm_ukernel_fn kernel;
+};
+
+/**
+ * 运行时分块: 由缓存拓扑推导 (拓扑未知时取 SgemmKernelInfo 中的默认值)
+ */
+struct SgemmBlocking {
+    int mc;
+    int kc;
+    int nc;
+};
+
+SgemmBlocking sgemm_blocking(const SgemmKernelInfo* info);
+
+// 各指令集的微内核 (未编译对应指令集时返回 nullptr)
+const SgemmKernelInfo* sgemm_kernel_avx512();
+const SgemmKernelInfo* sgemm_kernel_avx2();
+const SgemmKernelInfo* sgemm_kernel_generic();
+
+/**
+ * 按微内核格式打包面板 (供 GEMM 驱动与融合注意力等直接调用微内核的算子使用)
+ *   A (mc x kc) 打包为 MR 行条带，B (kc x nc) 打包为 NR 列条带，尾部条带补零；
+ *   trans 非 0 时 A 的元素 (i, p) 位于 A[p * lda + i]，B 的元素 (p, j) 位于 B[j * ldb + p]
+ */
+void sgemm_pack_a(int mc, int kc, const float* A, int lda, int trans, int mr, float* Ap);
+void sgemm_pack_b(int kc, int nc, const float* B, int ldb, int trans, int nr, float* Bp);
+
+// 量化矩阵乘沿输入维的分块长度: 内核逐块扫过所有输出列，使打包权重按行顺序读取
+static const int QUANT_K_BLOCK = 256;
+
+/**
+ * 量化权重中 g_idx 取值相同的连续输入区间 [k_begin, k_end)，长度不超过 QUANT_K_BLOCK
+ */
+struct QuantRun {
+    int k_begin;
+    int k_end;
+    int group;
+};
+
+/**
+ * 沿输入维打包的量化矩阵乘 (AutoGPTQ qweight 布局)
+ *   q(k, w) 位于 qweight[(k / per_word) * width + w] 的第 (k % per_word) * bits 位
+ *   out[r, w] += sum_k vec[r, k] * scales[g, w] * (q(k, w) - zero(g, w))
+ * 驱动层按 run 预先计算 zero_scales = scales * zero 与 run_sums = sum vec[r, k]，
+ * 内核在每个 run 内只做整数解包与乘加，run 结束时统一施加缩放和零点
+ */
+struct QuantRowPackedArgs {
+    const int* qweight;         // [height / per_word, width]
+    const float* scales;        // [groups, width]
+    const float* zero_scales;   // [groups, width]
+    int bits;                   // 4 或 8
+    int height;
+    int width;
+    const QuantRun* runs;
+    int n_runs;
+    const float* vec;           // [rows, ldv]
+    int ldv;
+    const float* run_sums;      // [rows, n_runs]
+    float* out;                 // [rows, ldo]，结果累加到原值上
+    int ldo;
+    int rows;
+};
+
+/**
+ * 沿输出维打包的量化矩阵乘 (column compression 布局)
+ *   q(k, w) 位于 qweight[k * (width / per_word) + w / per_word] 的第 (w % per_word) * bits 位
+ *   out[r, w] += sum_k svec[r, k] * q(k, w) - bias[r]
+ * 其中 svec = vec * scales[k]，bias = sum_k svec[r, k] * zeros[k] 由驱动层预先计算
+ */
+struct QuantColPackedArgs {
+    const int* qweight;         // [height, width / per_word]
+    int bits;
+    int height;
+    int width;
+    const float* svec;          // [rows, height]
+    const float* bias;          // [rows]
+    float* out;                 // [rows, ldo]
+    int ldo;
+    int rows;
+};
+
+// 计算输出列 [w0, w1) (w0 须为 QuantMatmulKernels::tile 的整数倍)
+typedef void (*qmatmul_row_fn)(const QuantRowPackedArgs& args, int w0, int w1);
+typedef void (*qmatmul_col_fn)(const QuantColPackedArgs& args, int w0, int w1);
+
+struct QuantMatmulKernels {
+    const char* name;
+    int tile;                   // 每次处理的输出列数
+    qmatmul_row_fn row_packed;
+    qmatmul_col_fn col_packed;
+};
+
+// 各指令集的量化矩阵乘内核 (未编译对应指令集时返回 nullptr)
+const QuantMatmulKernels* quant_kernels_avx512();
+const QuantMatmulKernels* quant_kernels_avx2();
+const QuantMatmulKernels* quant_kernels_generic();
+
+// 通用实现，亦用于 SIMD 内核处理不足一个分块的尾列
+void qmatmul_row_packed_generic(const QuantRowPackedArgs& args, int w0, int w1);
+void qmatmul_col_packed_generic(const QuantColPackedArgs& args, int w0, int w1);
+
+/**
+ * INT8 GEMM 微内核: 计算 m x n (m <= MR, n <= NR) 的输出分块并完成反量化
+ *   C[i, j] = a_scales[i] * b_scales[j] * (sum_k A[i, k] * Bp[k, j] - b_comp[j])
+ * A 为按行动态量化的激活 (act_offset 为 128 时以 u8 存储 q + 128)，行距 lda，
+ * Bp 为 NR 列打包的 int8 权重面板 [kp / 4][NR][4]，kp 为 4 的整数倍
+ */
+typedef void (*s8gemm_ukernel_fn)(int kp, const unsigned char* A, int lda, const signed char* Bp,
+                                  const float* a_scales, const float* b_scales, const int* b_comp,
+                                  float* C, int ldc, int m, int n);
+
+struct Int8GemmKernelInfo {
+    const char* name;
+    int mr;
+    int nr;
+    int act_offset;         // 激活量化偏移 (vpdpbusd 需要无符号激活)
+    s8gemm_ukernel_fn kernel;
+};
+
+// 各指令集的 INT8 GEMM 微内核 (未编译对应指令集时返回 nullptr)
+const Int8GemmKernelInfo* int8_gemm_kernel_avx512vnni();
+const Int8GemmKernelInfo* int8_gemm_kernel_avxvnni();
+const Int8GemmKernelInfo* int8_gemm_kernel_avx2();
+const Int8GemmKernelInfo* int8_gemm_kernel_generic();
+
+/**
+ * GEMV (batch 1 解码): y[n] = s(n) * sum_k W[n, k] * x[k] + bias[n]
+ * W 按输出行存储 ([N, K] 行主序)，ldw 以元素计 (int4 以字节计)；
+ *   q8: s(n) = scales[n]
+ *   q4: 每字节两个权重 (低 4 位为偶数 k)，W[n, k] = q - 8，
+ *       按 group_size 分组缩放 scales[n * (K / group_size) + k / group_size]
+ * 内核一次处理多行以共享 x 的加载，驱动层按行区间切分到线程池
+ */
+struct GemvArgs {
+    const void* W;
+    size_t ldw;
+    const float* scales;        // f32/f16 为 nullptr
+    int group_size;             // 仅 q4
+    const float* x;             // [K]
+    const float* bias;          // [N] 或 nullptr
+    float* y;                   // [N]
+    int K;
+};
+
+// 计算输出行 [n0, n1)
+typedef void (*gemv_fn)(const GemvArgs& args, int n0, int n1);
+
+struct GemvKernels {
+    const char* name;
+    gemv_fn f32;
+    gemv_fn f16;
+    gemv_fn q8;
+    gemv_fn q4;
+};
+
+// 各指令集的 GEMV 内核 (未编译对应指令集时返回 nullptr)
+const GemvKernels* gemv_kernels_avx512();
+const GemvKernels* gemv_kernels_avx2();
+const GemvKernels* gemv_kernels_generic();
+
+// 通用 int4 实现，亦用于分组长度不满足 SIMD 内核要求的情况
+void gemv_q4_generic(const GemvArgs& args, int n0, int n1);
+
+inline void gemv_store(const GemvArgs& a, int n, float v) {
+    a.y[n] = a.bias ? v + a.bias[n] : v;
+}
+
+/**
+ * 融合逐元素表达式的单条指令内核: dst[i] = op(a[i], b[i], c[i])，i ∈ [0, len)
+ * 一元指令的 b/c 与 a 相同；dst 可与 a/b/c 相同，驱动层负责寄存器分配与分块
+ */
+typedef void (*expr_op_fn)(const SimdEwInstr& ins, float* dst, const float* a,
+                           const float* b, const float* c, int len);
+
+struct ExprKernels {
+    const char* name;
+    expr_op_fn apply;
+};
+
+// 各指令集的表达式内核 (未编译对应指令集时返回 nullptr)
+const ExprKernels* expr_kernels_avx512();
+const ExprKernels* expr_kernels_avx2();
+const ExprKernels* expr_kernels_generic();
+
+/**
+ * 归约内核: 在一个块内以多个向量累加器归约 (n >= 1)，
+ * 驱动层负责块间成对求和、并行切分与按轴归约
+ */
+struct ReduceKernels {
+    const char* name;
+    float (*sum)(const float* x, int n);
+    float (*sum_abs)(const float* x, int n);
+    float (*sum_sq)(const float* x, int n, float center);    // sum (x - center)^2
+    float (*max)(const float* x, int n);
+    float (*min)(const float* x, int n);
+    int (*argmax)(const float* x, int n);                     // 首个最大值的下标
+    int (*argmin)(const float* x, int n);
+    /**
+     * 按列累积 rows 行: acc[j] = acc[j] (op) f(X[i, j])，op 为 SIMD_REDUCE_SUM/L1/L2/MAX/MIN，
+     * L2 累积 (X[i, j] - center[j])^2 (center 为 nullptr 时视为 0)
+     */
+    void (*accumulate_cols)(int op, const float* X, int rows, int cols, size_t ld,
+                            const float* center, float* acc);
+};
+
+// 各指令集的归约内核 (未编译对应指令集时返回 nullptr)
+const ReduceKernels* reduce_kernels_avx512();
+const ReduceKernels* reduce_kernels_avx2();
+const ReduceKernels* reduce_kernels_neon();
+const ReduceKernels* reduce_kernels_generic();
+
+/**
+ * Transformer 逐行算子内核: 处理一行 (n >= 1)，驱动层负责行间并行与统计量计算
+ */
+struct TransformerKernels {
+    const char* name;
+    // y = exp(x * scale - shift)，返回 sum y (y 可与 x 相同)
+    float (*exp_sum)(const float* x, float* y, int n, float scale, float shift);
+    // y = (x - shift) * scale * w + b，w/b 可为 nullptr (y 可与 x 相同)
+    void (*norm_apply)(const float* x, const float* w, const float* b, float* y, int n,
+                       float shift, float scale);
+    // 原地旋转 half 对元素，配对方式见 simd_rope
+    void (*rope)(float* x, const float* cos, const float* sin, int half, int interleaved);
+    // o[0:d] += sum_j p[j] * V[j * ldv + 0:d]，j ∈ [0, n) (解码时的注意力 P V)
+    void (*weighted_rows)(const float* V, size_t ldv, const float* p, int n, float* o, int d);
+};
+
+// 各指令集的 Transformer 算子内核 (未编译对应指令集时返回 nullptr)
+const TransformerKernels* transformer_kernels_avx512();
+const TransformerKernels* transformer_kernels_avx2();
+const TransformerKernels* transformer_kernels_generic();
+
+/**
+ * 峰值测量内核 (simd_peak.cpp): 按指令集测量单线程 FMA 吞吐与 STREAM triad 带宽，
+ * 不经分发表选择，可测量 CPU 支持的任一已编译变体
+ */
+struct PeakKernels {
+    const char* name;
+    int flops_per_iter;                             // fma_loop 每次迭代的浮点运算数
+    float (*fma_loop)(long long iters);             // 返回累加结果，防止循环被消除
+    void (*triad)(float* a, const float* b, const float* c, float s, size_t n);   // a = b + s * c
+};
+
+// 各指令集的峰值测量内核 (未编译对应指令集时返回 nullptr)
+const PeakKernels* peak_kernels_avx512();
+const PeakKernels* peak_kernels_avx2();
+const PeakKernels* peak_kernels_generic();
+
+/**
+ * 分页 KV 缓存中一个序列某一层的只读视图 (simd_kv_cache.cpp)，供融合注意力逐块读取。
+ * 创建时在锁内复制所需范围的块号: 之后序列被追加 (块表重新分配) 或释放都不影响视图，
+ * 读取结束后用 kv_cache_view_current 核对序列是否仍是创建视图时的那一个
+ */
+struct KvCacheView {
+    const SimdKvCache* cache;
+    int seq;
+    std::vector<int> blocks;    // 从 first_block 起覆盖所需位置的物理块号
+    int first_block;
+    uint64_t generation;
+    int layer;
+    int n_tokens;
+    int block_size;
+    int head_dim;
+    int n_kv_heads;
+    bool quantized;
+};
+
+// 位置 [pos, pos + n) 的视图 (n < 0 表示到序列末尾)，范围越界时返回 false
+bool kv_cache_view(const SimdKvCache* cache, int seq, int layer, int pos, int n, KvCacheView* view);
+// 序列在视图创建之后未被释放或重建
+bool kv_cache_view_current(const KvCacheView& view);
+// 返回 K (kv = 0) 或 V (kv = 1) 中头 head 位置 [pos, pos + len) 的行 (行距 head_dim，不跨块)；
+// fp32 缓存直接返回块内指针，量化缓存反量化到 buf
+const float* kv_cache_rows(const KvCacheView& view, int kv, int head, int pos, int len, float* buf);
+
+// 运行时 CPU 特性检测 (位定义见 simd_kernels.h 中的 SIMD_CPU_*)
+unsigned int cpu_features();
+bool cpu_has_avx512f();
+bool cpu_has_avx2_fma();
+
+/**
+ * 缓存拓扑 (加载时检测一次，字段含义同 SimdCacheInfo)
+ */
+struct CacheTopology {
+    int line_size;
+    size_t l1d;
+    size_t l2;
+    size_t l3;
+    int l1d_shared;
+    int l2_shared;
+    int l3_shared;
+    const char* source;
+};
+
+const CacheTopology& cache_topology();
+
+// CPU 签名 (型号、特性位与缓存容量，不含空白)，用于匹配调优记录
+const char* cpu_signature();
+
+/**
+ * 由缓存容量推导分块长度: budget 字节可容纳的单元数 (每单元 unit_bytes)，
+ * 向下对齐到 multiple 并限制在 [lo, hi]；budget 为 0 (该级缓存未检测到) 时返回 fallback
+ */
+int cache_blocking(size_t budget, size_t unit_bytes, int multiple, int lo, int hi, int fallback);
+
+typedef void (*binary_kernel_fn)(float* a, float* b, float* c, int n);
+typedef void (*scale_kernel_fn)(float* vec, float scalar, int n);
+typedef void (*fma_kernel_fn)(float* a, float* b, float* c, float* result, int n);
+
+/**
+ * 运行时分发表: 库加载时根据 CPUID 填充一次，此后只读
+ * 逐元素内核处理任意长度与对齐 (尾部使用掩码或部分向量)
+ */
+struct SimdDispatchTable {
+    const char* variant;            // 选用的指令集变体名称
+    int vector_width;               // 每个向量寄存器容纳的 float 数
+    binary_kernel_fn matrix_mult;
+    binary_kernel_fn matrix_add;
+    scale_kernel_fn vector_scale;
+    fma_kernel_fn fma;
+    const SgemmKernelInfo* sgemm;
+    const QuantMatmulKernels* quant;
+    const Int8GemmKernelInfo* int8;
+    const GemvKernels* gemv;
+    const ExprKernels* expr;
+    const ReduceKernels* reduce;
+    const TransformerKernels* transformer;
+};
+
+const SimdDispatchTable& dispatch_table();
+
+// 64 字节对齐内存分配 (用于打包缓冲区)
+void* aligned_malloc(size_t size, size_t alignment = 64);
+void aligned_free(void* ptr);
+
+// 单次调用内的临时缓冲区从内存池分配 (simd_alloc.cpp)，alignment 不超过 4096
+void* scratch_alloc(size_t size, size_t alignment = 64);
+void scratch_free(void* ptr);
+
+/**
+ * NUMA 拓扑与大页区域 (simd_numa.cpp)。节点编号可能不连续: numa_node_count 为最大在线编号 + 1，
+ * 用于按编号索引的表，numa_online_nodes 为实际在线的编号 (升序)。
+ * numa_current_node 读取当前线程所在 CPU 的节点；
+ * numa_spread_cpus 把 CPU 列表重排为各节点轮流，供线程池绑核时把线程均匀分到各路
+ */
+int numa_node_count();
+const std::vector<int>& numa_online_nodes();
+int numa_current_node();
+std::vector<int> numa_spread_cpus(const std::vector<int>& cpus);
+void* region_alloc(size_t size, int flags, int policy, int node);
+bool region_free(void* ptr);                // 不是区域起点时返回 false
+int region_flags(const void* ptr);
+
+// 长期驻留的大块权重: 2 MiB 以上用透明大页区域 (多节点时按页交错)，否则普通对齐分配
+void* weight_alloc(size_t size);
+void weight_free(void* ptr);
+
+/**
+ * 张量存储中名称以 prefix 开头的张量在分片文件中的位置，按存储顺序追加到 out
+ * (simd_tensor_store.cpp，供 simd_prefetch.cpp 按层提交读取)；path 在存储关闭前有效
+ */
+struct TensorFileRange {
+    const char* path;
+    uint64_t offset;
+    size_t nbytes;
+};
+int tensor_store_ranges(const SimdTensorStore* store, const char* prefix,
+                        std::vector<TensorFileRange>* out);
+
+/**
+ * 线程池任务: task 为任务序号，tid 为执行线程编号 (0 为调用线程)
+ * tid 仅在单次 parallel_for 调用内唯一，可用于索引本次调用分配的线程私有缓冲区
+ */
+typedef std::function<void(int task, int tid)> ParallelTask;
+
+// 线程池线程数 (含调用线程)
+int thread_pool_size();
+
+// 当前线程是否正在执行线程池任务 (此时 parallel_for 串行执行)
+bool in_parallel_region();
+
+/**
+ * 在线程池上执行 n_tasks 个任务，返回时所有任务均已完成
+ * max_threads <= 0 表示不限制参与线程数
+ */
+void parallel_for(int n_tasks, int max_threads, const ParallelTask& fn);
+
+/**
+ * 按连续区间切分 [0, n) 并行执行 fn(begin, end)
+ * 每个区间约 grain 个元素，规模不足时在调用线程直接执行
+ */
+template <typename Fn>
+inline void parallel_for_range(size_t n, size_t grain, Fn fn) {
+    if (n == 0) {
+        return;
+    }
+    const size_t chunks = (n + grain - 1) / grain;
+    if (chunks <= 1) {
+        fn((size_t)0, n);
+        return;
+    }
+    const size_t chunk = (n + chunks - 1) / chunks;
+    parallel_for((int)chunks, 0, [&](int task, int) {
+        const size_t begin = (size_t)task * chunk;
+        const size_t end = begin + chunk < n ? begin + chunk : n;
+        if (begin < end) {
+            fn(begin, end);
+        }
+    });
+}
+
+/**
+ * 一次 GEMM 实际使用的配置: 微内核、分块与参与线程数上限 (0 表示线程池大小)
+ */
+struct SgemmConfig {
+    const SgemmKernelInfo* info;
+    SgemmBlocking blk;
+    int max_threads;
+};
+
+/**
+ * 对分发表默认内核应用调优记录 (simd_autotune.cpp)，其他内核及无记录时按缓存拓扑推导；
+ * allow_auto 为 false 时不触发 SIMD_AUTOTUNE 的自动调优 (供查询接口使用)
+ */
+SgemmConfig sgemm_config(const SgemmKernelInfo* info, bool allow_auto = true);
+
+// 读取调优文件中与本机签名匹配的记录 (库加载时调用，不启动线程池)
+void load_tuning_file();
+
+/**
+ * 通用分块 GEMM 驱动 (行主序，带前导维度)
+ *   C = op(A)(M x K) * op(B)(K x N)，op 由 trans_a/trans_b 决定是否转置，转置在打包时完成
+ * epilogue 非空时按其融合尾处理；max_threads <= 0 时按计算量使用线程池全部线程
+ */
+void sgemm_blocked(const SgemmKernelInfo* info, int trans_a, int trans_b, int M, int N, int K,
+                   const float* A, int lda, const float* B, int ldb,
+                   float* C, int ldc, const SgemmEpilogue* epilogue = nullptr,
+                   int max_threads = 0);
+
+// 同上，但按给定配置执行 (不查询调优记录，供自动调优测量候选配置)
+void sgemm_blocked_config(const SgemmConfig& cfg, int trans_a, int trans_b, int M, int N, int K,
+                          const float* A, int lda, const float* B, int ldb,
+                          float* C, int ldc, const SgemmEpilogue* epilogue);
+
+/**
+ * 批量 GEMM 驱动: C[b] = alpha * op(A[b]) * op(B[b]) + beta * C[b]，b ∈ [0, batch_count)
+ * 整批在一次调用内调度到线程池
+ */
+void sgemm_batched_blocked(const SgemmKernelInfo* info, int trans_a, int trans_b,
+                           int M, int N, int K, float alpha,
+                           const float* const* A, int lda, const float* const* B, int ldb,
+                           float beta, float* const* C, int ldc, int batch_count);
+
+}  // namespace simd_internal
+
+#endif // VISIONAI_SIMD_INTERNAL_H
@@ -8,331 +8,252 @@
  * - AVX: 256位SIMD (无FMA指令)
  * - SSE4.2: 128位SIMD (一次处理4个float)
  * - 基准实现: 无SIMD优化
+ *
+ * 各指令集变体位于 simd_kernels_<isa>.cpp，分别以对应编译选项编译，
+ * 本文件提供基准实现与基于运行时分发表的公共入口
  */
 
+#include <algorithm>
 #include <cstdint>
 #include <cstring>
 #include <cmath>
+#include <vector>
 
-// AVX-512 指令集
-#ifdef __AVX512F__
-#include <immintrin.h>
+#include "simd_kernels.h"
+#include "simd_internal.h"
 
-void matrix_mult_avx512(float* a, float* b, float* c, int n) {
-    for (int i = 0; i < n; i += 16) {
-        __m512 vecA = _mm512_loadu_ps(&a[i]);
-        __m512 vecB = _mm512_loadu_ps(&b[i]);
-        __m512 vecC = _mm512_mul_ps(vecA, vecB);
-        _mm512_storeu_ps(&c[i], vecC);
-    }
-}
+// 基准实现 (无SIMD优化)
+// 大规模输入按连续区间切分到线程池，小规模输入直接在调用线程执行
+static const size_t ELEMENTWISE_PARALLEL_GRAIN = 1 << 16;
 
-void matrix_add_avx512(float* a, float* b, float* c, int n) {
-    for (int i = 0; i < n; i += 16) {
-        __m512 vecA = _mm512_loadu_ps(&a[i]);
-        __m512 vecB = _mm512_loadu_ps(&b[i]);
-        __m512 vecC = _mm512_add_ps(vecA, vecB);
-        _mm512_storeu_ps(&c[i], vecC);
-    }
+void matrix_mult_baseline(float* a, float* b, float* c, int n) {
+    simd_internal::parallel_for_range((size_t)(n > 0 ? n : 0), ELEMENTWISE_PARALLEL_GRAIN,
+        [=](size_t begin, size_t end) {
+            for (size_t i = begin; i < end; ++i) {
+                c[i] = a[i] * b[i];
+            }
+        });
 }
 
-void vector_scale_avx512(float* vec, float scalar, int n) {
-    __m512 vscalar = _mm512_set1_ps(scalar);
-    for (int i = 0; i < n; i += 16) {
-        __m512 v = _mm512_loadu_ps(&vec[i]);
-        v = _mm512_mul_ps(v, vscalar);
-        _mm512_storeu_ps(&vec[i], v);
-    }
+void matrix_add_baseline(float* a, float* b, float* c, int n) {
+    simd_internal::parallel_for_range((size_t)(n > 0 ? n : 0), ELEMENTWISE_PARALLEL_GRAIN,
+        [=](size_t begin, size_t end) {
+            for (size_t i = begin; i < end; ++i) {
+                c[i] = a[i] + b[i];
+            }
+        });
 }
 
-// FMA (Fused Multiply-Add) 支持
-void fma_avx512(float* a, float* b, float* c, float* result, int n) {
-    for (int i = 0; i < n; i += 16) {
-        __m512 vecA = _mm512_loadu_ps(&a[i]);
-        __m512 vecB = _mm512_loadu_ps(&b[i]);
-        __m512 vecC = _mm512_loadu_ps(&c[i]);
-        // a * b + c
-        __m512 vecResult = _mm512_fmadd_ps(vecA, vecB, vecC);
-        _mm512_storeu_ps(&result[i], vecResult);
-    }
+void vector_scale_baseline(float* vec, float scalar, int n) {
+    simd_internal::parallel_for_range((size_t)(n > 0 ? n : 0), ELEMENTWISE_PARALLEL_GRAIN,
+        [=](size_t begin, size_t end) {
+            for (size_t i = begin; i < end; ++i) {
+                vec[i] *= scalar;
+            }
+        });
 }
 
-#endif // __AVX512F__
-
-// AVX2 指令集
-#ifdef __AVX2__
-#include <immintrin.h>
-
-void matrix_mult_avx2(float* a, float* b, float* c, int n) {
-    for (int i = 0; i < n; i += 8) {
-        __m256 vecA = _mm256_loadu_ps(&a[i]);
-        __m256 vecB = _mm256_loadu_ps(&b[i]);
-        __m256 vecC = _mm256_mul_ps(vecA, vecB);
-        _mm256_storeu_ps(&c[i], vecC);
-    }
+void fma_baseline(float* a, float* b, float* c, float* result, int n) {
+    simd_internal::parallel_for_range((size_t)(n > 0 ? n : 0), ELEMENTWISE_PARALLEL_GRAIN,
+        [=](size_t begin, size_t end) {
+            for (size_t i = begin; i < end; ++i) {
+                result[i] = a[i] * b[i] + c[i];
+            }
+        });
 }
 
-void matrix_add_avx2(float* a, float* b, float* c, int n) {
-    for (int i = 0; i < n; i += 8) {
-        __m256 vecA = _mm256_loadu_ps(&a[i]);
-        __m256 vecB = _mm256_loadu_ps(&b[i]);
-        __m256 vecC = _mm256_add_ps(vecA, vecB);
-        _mm256_storeu_ps(&c[i], vecC);
-    }
+// 运行时分发实现
+// 分发表中的内核处理任意长度与对齐，每个线程直接处理自己的整个区间
+void dispatch_matrix_mult(float* a, float* b, float* c, int n) {
+    const simd_internal::SimdDispatchTable& table = simd_internal::dispatch_table();
+    simd_internal::parallel_for_range((size_t)(n > 0 ? n : 0), ELEMENTWISE_PARALLEL_GRAIN,
+        [&](size_t begin, size_t end) {
+            table.matrix_mult(a + begin, b + begin, c + begin, (int)(end - begin));
+        });
 }
 
-void vector_scale_avx2(float* vec, float scalar, int n) {
-    __m256 vscalar = _mm256_set1_ps(scalar);
-    for (int i = 0; i < n; i += 8) {
-        __m256 v = _mm256_loadu_ps(&vec[i]);
-        v = _mm256_mul_ps(v, vscalar);
-        _mm256_storeu_ps(&vec[i], v);
-    }
+void dispatch_matrix_add(float* a, float* b, float* c, int n) {
+    const simd_internal::SimdDispatchTable& table = simd_internal::dispatch_table();
+    simd_internal::parallel_for_range((size_t)(n > 0 ? n : 0), ELEMENTWISE_PARALLEL_GRAIN,
+        [&](size_t begin, size_t end) {
+            table.matrix_add(a + begin, b + begin, c + begin, (int)(end - begin));
+        });
 }
 
-// FMA (Fused Multiply-Add) 支持，需要基于AVX2
-#ifdef __FMA__
-void fma_avx2(float* a, float* b, float* c, float* result, int n) {
-    for (int i = 0; i < n; i += 8) {
-        __m256 vecA = _mm256_loadu_ps(&a[i]);
-        __m256 vecB = _mm256_loadu_ps(&b[i]);
-        __m256 vecC = _mm256_loadu_ps(&c[i]);
-        // a * b + c
-        __m256 vecResult = _mm256_fmadd_ps(vecA, vecB, vecC);
-        _mm256_storeu_ps(&result[i], vecResult);
-    }
-}
-#else
-// 无FMA指令时的回退实现
-void fma_avx2(float* a, float* b, float* c, float* result, int n) {
-    for (int i = 0; i < n; i += 8) {
-        __m256 vecA = _mm256_loadu_ps(&a[i]);
-        __m256 vecB = _mm256_loadu_ps(&b[i]);
-        __m256 vecC = _mm256_loadu_ps(&c[i]);
-        // a * b + c 的两步实现
-        __m256 vecTemp = _mm256_mul_ps(vecA, vecB);
-        __m256 vecResult = _mm256_add_ps(vecTemp, vecC);
-        _mm256_storeu_ps(&result[i], vecResult);
-    }
+void dispatch_vector_scale(float* vec, float scalar, int n) {
+    const simd_internal::SimdDispatchTable& table = simd_internal::dispatch_table();
+    simd_internal::parallel_for_range((size_t)(n > 0 ? n : 0), ELEMENTWISE_PARALLEL_GRAIN,
+        [&](size_t begin, size_t end) {
+            table.vector_scale(vec + begin, scalar, (int)(end - begin));
+        });
 }
-#endif // __FMA__
-
-#endif // __AVX2__
-
-// AVX 指令集 (无FMA)
-#if defined(__AVX__) && !defined(__AVX2__)
-#include <immintrin.h>
 
-void matrix_mult_avx(float* a, float* b, float* c, int n) {
-    for (int i = 0; i < n; i += 8) {
-        __m256 vecA = _mm256_loadu_ps(&a[i]);
-        __m256 vecB = _mm256_loadu_ps(&b[i]);
-        __m256 vecC = _mm256_mul_ps(vecA, vecB);
-        _mm256_storeu_ps(&c[i], vecC);
-    }
-}
-
-void matrix_add_avx(float* a, float* b, float* c, int n) {
-    for (int i = 0; i < n; i += 8) {
-        __m256 vecA = _mm256_loadu_ps(&a[i]);
-        __m256 vecB = _mm256_loadu_ps(&b[i]);
-        __m256 vecC = _mm256_add_ps(vecA, vecB);
-        _mm256_storeu_ps(&c[i], vecC);
-    }
-}
-
-void vector_scale_avx(float* vec, float scalar, int n) {
-    __m256 vscalar = _mm256_set1_ps(scalar);
-    for (int i = 0; i < n; i += 8) {
-        __m256 v = _mm256_loadu_ps(&vec[i]);
-        v = _mm256_mul_ps(v, vscalar);
-        _mm256_storeu_ps(&vec[i], v);
-    }
+void dispatch_fma(float* a, float* b, float* c, float* result, int n) {
+    const simd_internal::SimdDispatchTable& table = simd_internal::dispatch_table();
+    simd_internal::parallel_for_range((size_t)(n > 0 ? n : 0), ELEMENTWISE_PARALLEL_GRAIN,
+        [&](size_t begin, size_t end) {
+            table.fma(a + begin, b + begin, c + begin, result + begin, (int)(end - begin));
+        });
 }
 
-#endif // __AVX__ && !__AVX2__
-
-// SSE4.2 指令集
-#ifdef __SSE4_2__
-#include <smmintrin.h>
-
-void matrix_mult_sse42(float* a, float* b, float* c, int n) {
-    for (int i = 0; i < n; i += 4) {
-        __m128 vecA = _mm_loadu_ps(&a[i]);
-        __m128 vecB = _mm_loadu_ps(&b[i]);
-        __m128 vecC = _mm_mul_ps(vecA, vecB);
-        _mm_storeu_ps(&c[i], vecC);
+/**
+ * 矩阵乘法 C = A × B (二维矩阵)
+ * 优化版本支持基于指令集的优化
+ */
+void matrix_multiply(float* A, float* B, float* C, int rows_a, int cols_a, int cols_b) {
+    for (int i = 0; i < rows_a; ++i) {
+        for (int j = 0; j < cols_b; ++j) {
+            float sum = 0.0f;
+            for (int k = 0; k < cols_a; ++k) {
+                sum += A[i * cols_a + k] * B[k * cols_b + j];
+            }
+            C[i * cols_b + j] = sum;
+        }
     }
 }
 
-void matrix_add_sse42(float* a, float* b, float* c, int n) {
-    for (int i = 0; i < n; i += 4) {
-        __m128 vecA = _mm_loadu_ps(&a[i]);
-        __m128 vecB = _mm_loadu_ps(&b[i]);
-        __m128 vecC = _mm_add_ps(vecA, vecB);
-        _mm_storeu_ps(&c[i], vecC);
+/**
+ * 根据SIMD类型选择GEMM微内核
+ * 不能超过分发表在加载时选定的变体，"auto"/nullptr 直接使用分发表结果
+ */
+static const simd_internal::SgemmKernelInfo* select_sgemm_kernel(const char* simd_type) {
+    using namespace simd_internal;
+    const SgemmKernelInfo* best = dispatch_table().sgemm;
+    if (!simd_type || strcmp(simd_type, "auto") == 0 || strcmp(simd_type, "avx512") == 0) {
+        return best;
     }
-}
-
-void vector_scale_sse42(float* vec, float scalar, int n) {
-    __m128 vscalar = _mm_set1_ps(scalar);
-    for (int i = 0; i < n; i += 4) {
-        __m128 v = _mm_loadu_ps(&vec[i]);
-        v = _mm_mul_ps(v, vscalar);
-        _mm_storeu_ps(&vec[i], v);
+    if (strcmp(simd_type, "avx2") == 0) {
+        if (best == sgemm_kernel_avx512() && sgemm_kernel_avx2()) {
+            return sgemm_kernel_avx2();
+        }
+        return best;
     }
+    return sgemm_kernel_generic();
 }
 
-#endif // __SSE4_2__
-
-// ARM NEON 指令集
-#ifdef __ARM_NEON
-#include <arm_neon.h>
-
-void matrix_mult_neon(float* a, float* b, float* c, int n) {
-    for (int i = 0; i < n; i += 4) {
-        float32x4_t vecA = vld1q_f32(&a[i]);
-        float32x4_t vecB = vld1q_f32(&b[i]);
-        float32x4_t vecC = vmulq_f32(vecA, vecB);
-        vst1q_f32(&c[i], vecC);
-    }
+/**
+ * 优化的矩阵乘法
+ * 使用A/B面板打包、三级缓存分块和寄存器分块微内核
+ */
+void matrix_multiply_optimized(float* A, float* B, float* C, int rows_a, int cols_a, int cols_b, const char* simd_type) {
+    const simd_internal::SgemmKernelInfo* info = select_sgemm_kernel(simd_type);
+    simd_internal::sgemm_blocked(info, SIMD_GEMM_NO_TRANS, SIMD_GEMM_NO_TRANS, rows_a, cols_b, cols_a,
+                                 A, cols_a, B, cols_b, C, cols_b);
 }
 
-void matrix_add_neon(float* a, float* b, float* c, int n) {
-    for (int i = 0; i < n; i += 4) {
-        float32x4_t vecA = vld1q_f32(&a[i]);
-        float32x4_t vecB = vld1q_f32(&b[i]);
-        float32x4_t vecC = vaddq_f32(vecA, vecB);
-        vst1q_f32(&c[i], vecC);
-    }
+// 自动分发函数
+void dispatch_matrix_multiply(float* A, float* B, float* C, int rows_a, int cols_a, int cols_b, const char* simd_type) {
+    // simd_type 为空时由运行时CPU检测选择最佳微内核
+    matrix_multiply_optimized(A, B, C, rows_a, cols_a, cols_b, simd_type);
 }
 
-void vector_scale_neon(float* vec, float scalar, int n) {
-    float32x4_t vscalar = vdupq_n_f32(scalar);
-    for (int i = 0; i < n; i += 4) {
-        float32x4_t v = vld1q_f32(&vec[i]);
-        v = vmulq_f32(v, vscalar);
-        vst1q_f32(&vec[i], v);
-    }
+static simd_internal::SgemmEpilogue to_internal_epilogue(const SimdGemmEpilogue& e) {
+    const simd_internal::SgemmEpilogue ep = {
+        e.alpha, e.beta, e.bias, e.activation, e.residual, e.ldr
+    };
+    return ep;
 }
 
-// ARM NEON FMA 支持
-void fma_neon(float* a, float* b, float* c, float* result, int n) {
-    for (int i = 0; i < n; i += 4) {
-        float32x4_t vecA = vld1q_f32(&a[i]);
-        float32x4_t vecB = vld1q_f32(&b[i]);
-        float32x4_t vecC = vld1q_f32(&c[i]);
-        // a * b + c
-        float32x4_t vecResult = vmlaq_f32(vecC, vecA, vecB);
-        vst1q_f32(&result[i], vecResult);
+/**
+ * 带融合尾处理的矩阵乘法: C = act(alpha * A × B + beta * C + bias) + residual
+ * 尾处理在微内核写回寄存器分块时完成
+ */
+void dispatch_matrix_multiply_epilogue(float* A, float* B, float* C, int rows_a, int cols_a, int cols_b,
+                                       const SimdGemmEpilogue* epilogue, const char* simd_type) {
+    if (!epilogue) {
+        matrix_multiply_optimized(A, B, C, rows_a, cols_a, cols_b, simd_type);
+        return;
     }
+    const simd_internal::SgemmEpilogue ep = to_internal_epilogue(*epilogue);
+    simd_internal::sgemm_blocked(select_sgemm_kernel(simd_type), SIMD_GEMM_NO_TRANS, SIMD_GEMM_NO_TRANS,
+                                 rows_a, cols_b, cols_a, A, cols_a, B, cols_b, C, cols_b, &ep);
 }
 
-#endif // __ARM_NEON
-
-// 基准实现 (无SIMD优化)
-void matrix_mult_baseline(float* a, float* b, float* c, int n) {
-    for (int i = 0; i < n; ++i) {
-        c[i] = a[i] * b[i];
+// 检查 BLAS 风格参数的前导维度是否足以容纳 op(A)/op(B)/C
+static bool valid_gemm_layout(int trans_a, int trans_b, int M, int N, int K,
+                              int lda, int ldb, int ldc) {
+    if (M < 0 || N < 0 || K < 0) {
+        return false;
     }
+    return lda >= std::max(1, trans_a ? M : K) &&
+           ldb >= std::max(1, trans_b ? K : N) &&
+           ldc >= std::max(1, N);
 }
 
-void matrix_add_baseline(float* a, float* b, float* c, int n) {
-    for (int i = 0; i < n; ++i) {
-        c[i] = a[i] + b[i];
+/**
+ * BLAS 风格矩阵乘 (行主序): C = alpha * op(A) × op(B) + beta * C
+ */
+void simd_sgemm(int trans_a, int trans_b, int M, int N, int K, float alpha,
+                const float* A, int lda, const float* B, int ldb,
+                float beta, float* C, int ldc) {
+    if (!valid_gemm_layout(trans_a, trans_b, M, N, K, lda, ldb, ldc)) {
+        return;
     }
+    const simd_internal::SgemmEpilogue ep = {alpha, beta, nullptr, SIMD_ACT_NONE, nullptr, 0};
+    simd_internal::sgemm_blocked(simd_internal::dispatch_table().sgemm, trans_a, trans_b,
+                                 M, N, K, A, lda, B, ldb, C, ldc, &ep);
 }
 
-void vector_scale_baseline(float* vec, float scalar, int n) {
-    for (int i = 0; i < n; ++i) {
-        vec[i] *= scalar;
+/**
+ * BLAS 风格矩阵乘并融合尾处理: C = act(alpha * op(A) × op(B) + beta * C + bias) + residual
+ */
+void simd_sgemm_epilogue(int trans_a, int trans_b, int M, int N, int K,
+                         const float* A, int lda, const float* B, int ldb,
+                         float* C, int ldc, const SimdGemmEpilogue* epilogue) {
+    if (!valid_gemm_layout(trans_a, trans_b, M, N, K, lda, ldb, ldc)) {
+        return;
     }
+    const SimdGemmEpilogue plain = {1.0f, 0.0f, nullptr, SIMD_ACT_NONE, nullptr, 0};
+    const simd_internal::SgemmEpilogue ep = to_internal_epilogue(epilogue ? *epilogue : plain);
+    simd_internal::sgemm_blocked(simd_internal::dispatch_table().sgemm, trans_a, trans_b,
+                                 M, N, K, A, lda, B, ldb, C, ldc, &ep);
 }
 
-void fma_baseline(float* a, float* b, float* c, float* result, int n) {
-    for (int i = 0; i < n; ++i) {
-        result[i] = a[i] * b[i] + c[i];
+void simd_get_gemm_blocking(SimdGemmBlocking* blocking) {
+    if (!blocking) {
+        return;
     }
+    const simd_internal::SgemmConfig cfg =
+        simd_internal::sgemm_config(simd_internal::dispatch_table().sgemm, false);
+    blocking->mr = cfg.info->mr;
+    blocking->nr = cfg.info->nr;
+    blocking->mc = cfg.blk.mc;
+    blocking->kc = cfg.blk.kc;
+    blocking->nc = cfg.blk.nc;
 }
 
 /**
- * 矩阵乘法 C = A × B (二维矩阵)
- * 优化版本支持基于指令集的优化
+ * 批量矩阵乘 (指针数组)
  */
-void matrix_multiply(float* A, float* B, float* C, int rows_a, int cols_a, int cols_b) {
-    for (int i = 0; i < rows_a; ++i) {
-        for (int j = 0; j < cols_b; ++j) {
-            float sum = 0.0f;
-            for (int k = 0; k < cols_a; ++k) {
-                sum += A[i * cols_a + k] * B[k * cols_b + j];
-            }
-            C[i * cols_b + j] = sum;
-        }
+void sgemm_batched(int trans_a, int trans_b, int M, int N, int K, float alpha,
+                   const float* const* A, int lda, const float* const* B, int ldb,
+                   float beta, float* const* C, int ldc, int batch_count) {
+    if (!valid_gemm_layout(trans_a, trans_b, M, N, K, lda, ldb, ldc)) {
+        return;
     }
+    simd_internal::sgemm_batched_blocked(simd_internal::dispatch_table().sgemm, trans_a, trans_b,
+                                         M, N, K, alpha, A, lda, B, ldb, beta, C, ldc, batch_count);
 }
 
 /**
- * 优化的矩阵乘法 (针对特定大小的块)
- * 使用分块技术和SIMD优化
+ * 批量矩阵乘 (固定跨度)
  */
-void matrix_multiply_optimized(float* A, float* B, float* C, int rows_a, int cols_a, int cols_b, const char* simd_type) {
-    // 支持所有SIMD指令的基本分块大小
-    const int block_size = 32;
-    
-    // 初始化结果矩阵为0
-    memset(C, 0, rows_a * cols_b * sizeof(float));
-    
-    // 分块计算
-    for (int i = 0; i < rows_a; i += block_size) {
-        for (int j = 0; j < cols_b; j += block_size) {
-            for (int k = 0; k < cols_a; k += block_size) {
-                // 为了方便示例，这里简化为不处理边界情况
-                // 实际实现应考虑矩阵大小不是block_size倍数的情况
-                
-                // 计算局部块
-                int i_end = (i + block_size < rows_a) ? i + block_size : rows_a;
-                int j_end = (j + block_size < cols_b) ? j + block_size : cols_b;
-                int k_end = (k + block_size < cols_a) ? k + block_size : cols_a;
-                
-                for (int ii = i; ii < i_end; ++ii) {
-                    for (int jj = j; jj < j_end; ++jj) {
-                        float sum = C[ii * cols_b + jj];
-                        
-                        // 这里可以根据SIMD类型选择不同的向量化方法
-                        // 为简化示例，这里仍然使用标量计算
-                        for (int kk = k; kk < k_end; ++kk) {
-                            sum += A[ii * cols_a + kk] * B[kk * cols_b + jj];
-                        }
-                        
-                        C[ii * cols_b + jj] = sum;
-                    }
-                }
-            }
-        }
+void sgemm_strided_batched(int trans_a, int trans_b, int M, int N, int K, float alpha,
+                           const float* A, int lda, long long stride_a,
+                           const float* B, int ldb, long long stride_b,
+                           float beta, float* C, int ldc, long long stride_c, int batch_count) {
+    if (batch_count <= 0 || !valid_gemm_layout(trans_a, trans_b, M, N, K, lda, ldb, ldc)) {
+        return;
     }
-}
-
-// 自动分发函数
-void dispatch_matrix_multiply(float* A, float* B, float* C, int rows_a, int cols_a, int cols_b, const char* simd_type) {
-    // 自动检测可用的SIMD类型并分发到对应实现
-    if (simd_type) {
-        // 用户指定SIMD类型
-        matrix_multiply_optimized(A, B, C, rows_a, cols_a, cols_b, simd_type);
-    } else {
-        // 自动检测
-        #if defined(__AVX512F__)
-            matrix_multiply_optimized(A, B, C, rows_a, cols_a, cols_b, "avx512");
-        #elif defined(__AVX2__)
-            matrix_multiply_optimized(A, B, C, rows_a, cols_a, cols_b, "avx2");
-        #elif defined(__AVX__)
-            matrix_multiply_optimized(A, B, C, rows_a, cols_a, cols_b, "avx");
-        #elif defined(__SSE4_2__)
-            matrix_multiply_optimized(A, B, C, rows_a, cols_a, cols_b, "sse42");
-        #elif defined(__ARM_NEON)
-            matrix_multiply_optimized(A, B, C, rows_a, cols_a, cols_b, "neon");
-        #else
-            // 回退到基础实现
-            matrix_multiply(A, B, C, rows_a, cols_a, cols_b);
-        #endif
+    std::vector<const float*> a_ptrs(batch_count);
+    std::vector<const float*> b_ptrs(batch_count);
+    std::vector<float*> c_ptrs(batch_count);
+    for (int b = 0; b < batch_count; ++b) {
+        a_ptrs[b] = A + b * stride_a;
+        b_ptrs[b] = B + b * stride_b;
+        c_ptrs[b] = C + b * stride_c;
     }
-} 
\ No newline at end of file
+    simd_internal::sgemm_batched_blocked(simd_internal::dispatch_table().sgemm, trans_a, trans_b,
+                                         M, N, K, alpha, a_ptrs.data(), lda, b_ptrs.data(), ldb,
+                                         beta, c_ptrs.data(), ldc, batch_count);
+}
@@ -9,34 +9,47 @@
 extern "C" {
 #endif
 
+// 运行时检测到的CPU特性位 (simd_get_cpu_features 返回值)
+#define SIMD_CPU_SSE42       (1u << 0)
+#define SIMD_CPU_AVX         (1u << 1)
+#define SIMD_CPU_AVX2        (1u << 2)
+#define SIMD_CPU_FMA         (1u << 3)
+#define SIMD_CPU_F16C        (1u << 4)
+#define SIMD_CPU_AVX512F     (1u << 5)
+#define SIMD_CPU_AVX512BW    (1u << 6)
+#define SIMD_CPU_AVX512DQ    (1u << 7)
+#define SIMD_CPU_AVX512VL    (1u << 8)
+#define SIMD_CPU_AVX512VNNI  (1u << 9)
+#define SIMD_CPU_AVXVNNI     (1u << 10)
+#define SIMD_CPU_NEON        (1u << 11)
+
+// 各指令集变体分别以对应编译选项单独编译 (fat binary)，
+// 调用前必须确认CPU支持，一般应通过下方 dispatch_* 入口调用；
+// 逐元素内核接受任意长度 n 与任意对齐的指针，尾部以掩码或部分向量处理，不会越界读写
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386) || defined(_M_IX86)
 // AVX-512 指令集函数
-#ifdef __AVX512F__
 void matrix_mult_avx512(float* a, float* b, float* c, int n);
 void matrix_add_avx512(float* a, float* b, float* c, int n);
 void vector_scale_avx512(float* vec, float scalar, int n);
 void fma_avx512(float* a, float* b, float* c, float* result, int n);
-#endif
 
 // AVX2 指令集函数
-#ifdef __AVX2__
 void matrix_mult_avx2(float* a, float* b, float* c, int n);
 void matrix_add_avx2(float* a, float* b, float* c, int n);
 void vector_scale_avx2(float* vec, float scalar, int n);
 void fma_avx2(float* a, float* b, float* c, float* result, int n);
-#endif
 
 // AVX 指令集函数
-#if defined(__AVX__) && !defined(__AVX2__)
 void matrix_mult_avx(float* a, float* b, float* c, int n);
 void matrix_add_avx(float* a, float* b, float* c, int n);
 void vector_scale_avx(float* vec, float scalar, int n);
-#endif
+void fma_avx(float* a, float* b, float* c, float* result, int n);
 
 // SSE4.2 指令集函数
-#ifdef __SSE4_2__
 void matrix_mult_sse42(float* a, float* b, float* c, int n);
 void matrix_add_sse42(float* a, float* b, float* c, int n);
 void vector_scale_sse42(float* vec, float scalar, int n);
+void fma_sse42(float* a, float* b, float* c, float* result, int n);
 #endif
 
 // ARM NEON 指令集函数
@@ -53,11 +66,531 @@ void matrix_add_baseline(float* a, float* b, float* c, int n);
 void vector_scale_baseline(float* vec, float scalar, int n);
 void fma_baseline(float* a, float* b, float* c, float* result, int n);
 
+// 运行时分发函数 (按加载时CPUID检测结果选择最佳变体)
+void dispatch_matrix_mult(float* a, float* b, float* c, int n);
+void dispatch_matrix_add(float* a, float* b, float* c, int n);
+void dispatch_vector_scale(float* vec, float scalar, int n);
+void dispatch_fma(float* a, float* b, float* c, float* result, int n);
+
+// 查询当前选用的指令集变体 ("avx512"/"avx2"/"avx"/"sse42"/"neon"/"baseline")
+// 可通过环境变量 SIMD_FORCE_VARIANT 将其限制为更低的变体
+const char* simd_get_active_variant(void);
+unsigned int simd_get_cpu_features(void);
+
+/**
+ * 缓存拓扑 (加载时检测一次): Linux 读取 sysfs，否则按 CPUID leaf 4 / 0x8000001D 枚举；
+ * 大小以字节计，shared 为共享该级缓存的逻辑 CPU 数，未检测到的级别大小为 0
+ */
+typedef struct {
+    int line_size;
+    long long l1d_size;
+    int l1d_shared;
+    long long l2_size;
+    int l2_shared;
+    long long l3_size;
+    int l3_shared;
+    const char* source;             // "sysfs" / "cpuid" / "default"
+} SimdCacheInfo;
+
+void simd_get_cache_info(SimdCacheInfo* info);
+
+// 当前分发变体的 SGEMM 分块: 微内核形状 (mr, nr) 与 mc/kc/nc (有调优记录时为调优结果，否则由缓存拓扑推导)
+typedef struct {
+    int mr;
+    int nr;
+    int mc;
+    int kc;
+    int nc;
+} SimdGemmBlocking;
+
+void simd_get_gemm_blocking(SimdGemmBlocking* blocking);
+
+/**
+ * GEMM 自动调优: 在代表性形状上测量候选微内核、分块 (kc/mc/nc) 与参与线程数，
+ * 胜者按 CPU 签名、变体与线程池大小写入调优文件并立即生效。
+ * 调优文件为环境变量 SIMD_TUNING_FILE，默认 $XDG_CACHE_HOME (或 ~/.cache，Windows 为
+ * %LOCALAPPDATA%)/visionai_clipsmaster/simd_tuning.txt，库加载时读取；
+ * SIMD_AUTOTUNE=1 时首次 GEMM 发现没有匹配记录即自动调优，SIMD_AUTOTUNE=0 时不读取调优文件
+ */
+typedef struct {
+    const char* kernel;             // 微内核变体
+    int mc;
+    int kc;
+    int nc;
+    int threads;                    // 参与线程数上限 (0 表示线程池大小)
+    double gflops;                  // 代表性形状上的几何平均吞吐 (GFLOP/s)，未调优时为 0
+    int tuned;                      // 1 表示来自调优记录
+} SimdTuningResult;
+
+// force 为 0 且已有匹配记录时直接返回该记录；返回 0 成功，-1 调优文件写入失败 (结果仍在本进程生效)
+int simd_autotune(int force, SimdTuningResult* result);
+void simd_get_tuning(SimdTuningResult* result);     // 当前生效的 GEMM 配置
+const char* simd_get_tuning_file(void);             // 空字符串表示无可用路径
+
+/**
+ * 机器峰值实测 (每次调用耗时约 0.2 秒)，作为基准与屋顶线分析的分母；threads <= 0 表示线程池全部线程
+ *   simd_peak_gflops: FMA 吞吐 (GFLOP/s)，variant 为 "avx512"/"avx2"/"baseline"，
+ *     NULL 表示与当前分发变体一致；CPU 不支持或未编译该变体时返回 -1
+ *   simd_peak_bandwidth: STREAM triad (a = b + s * c) 带宽 (GB/s)，bytes 为所有线程的工作集合计，
+ *     按每元素 12 字节计；分配失败时返回 -1
+ *   simd_peak_int8_gops: 当前 INT8 GEMM 微内核 (simd_int8_get_variant) 的整数乘加吞吐 (GOP/s，
+ *     乘与加各计一次)，VNNI 下高于浮点 FMA 峰值，作为 INT8 用例的算力屋顶；分配失败时返回 -1
+ */
+double simd_peak_gflops(const char* variant, int threads);
+double simd_peak_bandwidth(long long bytes, int threads);
+double simd_peak_int8_gops(int threads);
+
 // 矩阵乘法函数 (二维矩阵)
 void matrix_multiply(float* A, float* B, float* C, int rows_a, int cols_a, int cols_b);
 void matrix_multiply_optimized(float* A, float* B, float* C, int rows_a, int cols_a, int cols_b, const char* simd_type);
 void dispatch_matrix_multiply(float* A, float* B, float* C, int rows_a, int cols_a, int cols_b, const char* simd_type);
 
+// GEMM 融合尾处理的激活函数
+#define SIMD_ACT_NONE        0
+#define SIMD_ACT_RELU        1
+#define SIMD_ACT_GELU        2      // tanh 近似
+#define SIMD_ACT_SILU        3
+
+/**
+ * GEMM 融合尾处理: C = act(alpha * A × B + beta * C + bias) + residual
+ * 在微内核写回寄存器分块时完成，不再额外遍历输出
+ * beta 为 0 时不读取 C 原值；residual 不能与 C 重叠
+ */
+typedef struct SimdGemmEpilogue {
+    float alpha;
+    float beta;
+    const float* bias;          // [cols_b] 或 NULL
+    int activation;             // SIMD_ACT_*
+    const float* residual;      // [rows_a, ldr] 或 NULL
+    int ldr;
+} SimdGemmEpilogue;
+
+// epilogue 为 NULL 时等同于 dispatch_matrix_multiply
+void dispatch_matrix_multiply_epilogue(float* A, float* B, float* C, int rows_a, int cols_a, int cols_b,
+                                       const SimdGemmEpilogue* epilogue, const char* simd_type);
+
+/**
+ * BLAS 风格矩阵乘 (行主序): C = alpha * op(A) × op(B) + beta * C
+ * op(A) 为 M x K: trans_a 为 SIMD_GEMM_NO_TRANS 时 A 按 M 行 K 列存储，
+ * 为 SIMD_GEMM_TRANS 时按 K 行 M 列存储 (如 [out, in] 布局的权重)，B 同理；
+ * lda/ldb/ldc 为存储行距，可直接传入子矩阵视图；beta 为 0 时不读取 C 原值
+ */
+#define SIMD_GEMM_NO_TRANS   0
+#define SIMD_GEMM_TRANS      1
+
+void simd_sgemm(int trans_a, int trans_b, int M, int N, int K, float alpha,
+                const float* A, int lda, const float* B, int ldb,
+                float beta, float* C, int ldc);
+// 同上并融合尾处理 (epilogue 为 NULL 时 alpha = 1, beta = 0)
+void simd_sgemm_epilogue(int trans_a, int trans_b, int M, int N, int K,
+                         const float* A, int lda, const float* B, int ldb,
+                         float* C, int ldc, const SimdGemmEpilogue* epilogue);
+
+/**
+ * 批量矩阵乘: C[b] = alpha * op(A[b]) × op(B[b]) + beta * C[b]，b ∈ [0, batch_count)
+ * 转置与行距含义同 simd_sgemm，整批在一次调用内调度到线程池
+ */
+void sgemm_batched(int trans_a, int trans_b, int M, int N, int K, float alpha,
+                   const float* const* A, int lda, const float* const* B, int ldb,
+                   float beta, float* const* C, int ldc, int batch_count);
+// 第 b 个矩阵位于 A + b * stride_a 等 (以元素计)
+void sgemm_strided_batched(int trans_a, int trans_b, int M, int N, int K, float alpha,
+                           const float* A, int lda, long long stride_a,
+                           const float* B, int ldb, long long stride_b,
+                           float beta, float* C, int ldc, long long stride_c, int batch_count);
+
+// AutoGPTQ 打包布局的量化矩阵乘 (对应 cache_autogptq_cuda_256 扩展，结果累加到 mul 上)
+void vecquant8matmul(const float* vec, const int* qweight, float* mul,
+                     const float* scales, const int* zeros, const int* g_idx,
+                     int batch, int vec_height, int width, int groups, int zero_width);
+void vecquant8matmul_batched(const float* vec, const int* qweight, float* mul,
+                             const float* scales, const int* zeros,
+                             int batch, int heads, int vec_row, int vec_height,
+                             int width, int zero_width);
+void vecquant4matmul_batched(const float* vec, const int* qweight, float* mul,
+                             const float* scales, const int* zeros,
+                             int batch, int heads, int vec_row, int vec_height,
+                             int width, int zero_width);
+void vecquant8matmul_batched_column_compression(const float* vec, const int* qweight, float* mul,
+                                                const float* scales, const int* zeros,
+                                                int batch, int heads, int vec_row,
+                                                int height, int width);
+void vecquant4matmul_batched_column_compression(const float* vec, const int* qweight, float* mul,
+                                                const float* scales, const int* zeros,
+                                                int batch, int heads, int vec_row,
+                                                int height, int width);
+
+// INT8 GEMM: 权重按输出通道量化并预打包，激活按行动态量化 (VNNI / AVX2 / 通用)
+typedef struct SimdInt8Weights SimdInt8Weights;
+SimdInt8Weights* simd_int8_pack_weights(const float* W, int K, int N, int ldw);
+// Wq 取值须在 [-127, 127] 内，含 -128 时返回 NULL
+SimdInt8Weights* simd_int8_pack_quantized(const signed char* Wq, const float* scales,
+                                          int K, int N, int ldw);
+void simd_int8_free_weights(SimdInt8Weights* weights);
+// 参数非法返回 -1，内存不足返回 -2 (不写 C)，成功返回 0
+int simd_int8_gemm(const float* A, int lda, const SimdInt8Weights* weights,
+                   float* C, int ldc, int M);
+const char* simd_int8_get_variant(void);    // "avx512_vnni"/"avx_vnni"/"avx2"/"generic"
+
+/**
+ * GEMV (batch 1 解码): y[n] = sum_k W[n, k] * x[k] (+ bias[n])，n ∈ [0, N)
+ * W 按 [N, K] 行主序存储 (与 Linear 层权重布局一致)，行距 ldw 以元素计；
+ * bias 可为 NULL。按输出行切分到线程池，内核受权重读取带宽限制
+ */
+void simd_gemv_f32(const float* W, int ldw, const float* x, const float* bias,
+                   float* y, int N, int K);
+// fp16 权重 (IEEE half 位模式)
+void simd_gemv_f16(const unsigned short* W, int ldw, const float* x, const float* bias,
+                   float* y, int N, int K);
+// int8 权重按输出行对称量化: W[n, k] = Wq[n, k] * scales[n]
+void simd_gemv_q8(const signed char* W, int ldw, const float* scales, const float* x,
+                  const float* bias, float* y, int N, int K);
+// int4 权重每字节两个 (低 4 位为偶数 k)，ldw 以字节计，按组对称量化:
+//   W[n, k] = (q - 8) * scales[n * (K / group_size) + k / group_size]
+// group_size 须为偶数且整除 K
+void simd_gemv_q4(const unsigned char* W, int ldw, const float* scales, int group_size,
+                  const float* x, const float* bias, float* y, int N, int K);
+
+/**
+ * 打包的 GEMV 权重 (格式同上，type 为 SIMD_GEMV_*)，复制到透明大页区域；
+ * replicas <= 0 时每个在线 NUMA 节点一份绑定到本节点的副本，计算时每个线程读取所在节点的副本；
+ * 绑定失败的节点不保留副本 (其线程读取第一份)，绑定成功不足两份时改为一份交错副本，
+ * simd_gemv_weights_replicas 返回实际副本数；
+ * 只有一份时多节点下按页交错。scales/group_size 的含义同 simd_gemv_q8/simd_gemv_q4 (f32/f16 忽略)
+ */
+#define SIMD_GEMV_F32        0
+#define SIMD_GEMV_F16        1
+#define SIMD_GEMV_Q8         2
+#define SIMD_GEMV_Q4         3
+
+typedef struct SimdGemvWeights SimdGemvWeights;
+SimdGemvWeights* simd_gemv_pack_weights(int type, const void* W, int ldw, const float* scales,
+                                        int group_size, int N, int K, int replicas);
+void simd_gemv_free_weights(SimdGemvWeights* weights);
+int simd_gemv_weights_replicas(const SimdGemvWeights* weights);
+void simd_gemv_packed(const SimdGemvWeights* weights, const float* x, const float* bias, float* y);
+
+/**
+ * 融合逐元素表达式: 以寄存器字节码描述任意长的 add/mul/fma/缩放/截断/激活链，
+ * 按 L1 大小的分块一次遍历求值，每个输入只读一次、输出只写一次
+ *   r[dst] = op(r[a], r[b], r[c]; p0, p1)，r 为长度为 n 的向量寄存器
+ * 寄存器须先写后读；out 可与某个输入相同 (不能部分重叠)
+ */
+#define SIMD_EW_MAX_REGS     16
+
+#define SIMD_EW_LOAD         0      // r[dst] = inputs[a]
+#define SIMD_EW_CONST        1      // r[dst] = p0
+#define SIMD_EW_ADD          2      // r[dst] = r[a] + r[b]
+#define SIMD_EW_SUB          3      // r[dst] = r[a] - r[b]
+#define SIMD_EW_MUL          4      // r[dst] = r[a] * r[b]
+#define SIMD_EW_DIV          5      // r[dst] = r[a] / r[b]
+#define SIMD_EW_FMA          6      // r[dst] = r[a] * r[b] + r[c]
+#define SIMD_EW_AFFINE       7      // r[dst] = r[a] * p0 + p1
+#define SIMD_EW_MIN          8      // r[dst] = min(r[a], r[b])
+#define SIMD_EW_MAX          9      // r[dst] = max(r[a], r[b])
+#define SIMD_EW_CLAMP        10     // r[dst] = min(max(r[a], p0), p1)
+#define SIMD_EW_ACT          11     // r[dst] = act(r[a])，act = b (SIMD_ACT_*)
+
+typedef struct SimdEwInstr {
+    int op;
+    int dst;
+    int a;
+    int b;
+    int c;
+    float p0;
+    float p1;
+} SimdEwInstr;
+
+// 求值后 out = r[out_reg]；成功返回 0，程序非法时返回 -1 且不写 out
+int simd_elementwise_fused(const SimdEwInstr* program, int n_instr,
+                           const float* const* inputs, int n_inputs,
+                           int out_reg, float* out, long long n);
+
+/**
+ * 归约: 块内多累加器向量化，块间成对求和 (误差随 log n 增长)，大规模输入并行
+ * 空输入时 SUM/L1/L2 为 0，MAX 为 -inf，MIN 为 +inf，MEAN/VAR 为 NaN
+ */
+#define SIMD_REDUCE_SUM      0
+#define SIMD_REDUCE_MEAN     1
+#define SIMD_REDUCE_MAX      2
+#define SIMD_REDUCE_MIN      3
+#define SIMD_REDUCE_L1       4      // sum |x|
+#define SIMD_REDUCE_L2       5      // sqrt(sum x^2)
+#define SIMD_REDUCE_VAR      6      // 总体方差 (除以 n)
+
+float simd_reduce(int op, const float* x, long long n);
+// 首个最大/最小值的下标，n 为 0 时返回 -1
+long long simd_argmax(const float* x, long long n);
+long long simd_argmin(const float* x, long long n);
+// 均值与总体方差: 分块两遍求块内统计量，块间按 Welford/Chan 公式合并
+void simd_mean_var(const float* x, long long n, float* mean, float* var);
+
+/**
+ * 按轴归约 [rows, cols] 行主序矩阵，行距 ld:
+ *   axis = 1: 每行归约，out 长度为 rows；axis = 0: 每列归约，out 长度为 cols
+ * 参数非法时返回 -1，成功返回 0
+ */
+int simd_reduce_axis(int op, const float* X, int rows, int cols, int ld, int axis, float* out);
+// op 为 SIMD_REDUCE_MAX (argmax) 或 SIMD_REDUCE_MIN (argmin)
+int simd_arg_reduce_axis(int op, const float* X, int rows, int cols, int ld, int axis, int* out);
+int simd_mean_var_axis(const float* X, int rows, int cols, int ld, int axis,
+                       float* mean, float* var);
+
+/**
+ * Transformer 逐行算子: [rows, cols] 行主序，行距 ldx/ldy 以元素计，y 可与 x 相同；
+ * 按行切分到线程池，每行只从内存读取一次 (后续遍历命中缓存)。参数非法时返回 -1，成功返回 0
+ */
+// y = softmax(scale * x)，按块在线合并最大值与归一化因子；整行为 -inf 时输出 0
+int simd_softmax(const float* x, int ldx, float* y, int ldy, int rows, int cols, float scale);
+// y = x / sqrt(mean(x^2) + eps) * weight，weight 可为 NULL
+int simd_rmsnorm(const float* x, int ldx, const float* weight, float* y, int ldy,
+                 int rows, int cols, float eps);
+// y = (x - mean) / sqrt(var + eps) * gamma + beta，gamma/beta 可为 NULL
+int simd_layernorm(const float* x, int ldx, const float* gamma, const float* beta,
+                   float* y, int ldy, int rows, int cols, float eps);
+
+// y = act(x) 与门控形式 y = act(gate) * up (SwiGLU/GeGLU)，act 为 SIMD_ACT_*，exp 为多项式近似
+int simd_activation(int act, const float* x, float* y, long long n);
+int simd_gated_activation(int act, const float* gate, const float* up, float* y, long long n);
+
+/**
+ * 旋转位置编码 (原地): 对 x[t, h, 0:rotary_dim] 按第 t 个位置的角度旋转，
+ * 元素位于 x + t * ld_token + h * ld_head，cos/sin 为 [n_tokens, rotary_dim / 2]；
+ * interleaved 为 0 时配对 (i, i + rotary_dim / 2) (NeoX/LLaMA/Qwen)，非 0 时配对 (2i, 2i + 1) (GPT-J)
+ */
+int simd_rope(float* x, int n_tokens, int n_heads, long long ld_token, long long ld_head,
+              const float* cos, const float* sin, int rotary_dim, int interleaved);
+// cos/sin 表: angle(t, i) = positions[t] * theta^(-2i / rotary_dim)，以双精度计算
+int simd_rope_tables(const int* positions, int n_tokens, int rotary_dim, float theta,
+                     float* cos, float* sin);
+
+/**
+ * 融合注意力 (flash attention): O = softmax(scale * Q K^T + mask) V
+ * Q/K/V 按块调用 GEMM 微内核，逐块在线更新每行的最大值与归一化因子，
+ * 不分配完整的分数矩阵，额外内存与序列长度成线性关系
+ * 元素 (t, h, :) 位于 base + t * token_stride + h * head_stride，步长以元素计，最后一维连续
+ */
+typedef struct SimdAttentionParams {
+    int n_q;                        // 查询长度
+    int n_kv;                       // 键值长度
+    int head_dim;                   // Q/K/V 每个头的维度
+    int n_heads;                    // 查询头数
+    int n_kv_heads;                 // 键值头数，须整除 n_heads (GQA/MQA，查询头 h 使用 h / (n_heads / n_kv_heads))
+    long long q_token_stride, q_head_stride;
+    long long k_token_stride, k_head_stride;
+    long long v_token_stride, v_head_stride;
+    long long o_token_stride, o_head_stride;
+    float scale;                    // 0 时取 1 / sqrt(head_dim)
+    int causal;                     // 非 0 时查询 i 只看到键 j <= i + n_kv - n_q (右下对齐，适用于带 KV 缓存的解码)
+} SimdAttentionParams;
+
+// 参数非法时返回 -1，内存不足时返回 -2，成功返回 0；没有可见键的查询行输出 0
+int simd_attention(const SimdAttentionParams* params, const float* Q, const float* K,
+                   const float* V, float* O);
+
+/**
+ * 分页 KV 缓存: 创建时预留 n_blocks 个块，每块保存所有层、所有键值头的 block_size 个 token；
+ * 序列以块表引用块，所有层都写完的满块按 token 前缀登记，供新序列直接复用
+ */
+enum {
+    SIMD_KV_F32 = 0,
+    SIMD_KV_INT8 = 1,               // 每 (token, 头) 对称 int8，一个 fp32 缩放
+    SIMD_KV_FP8 = 2                 // 每 (token, 头) 缩放到 fp8 E4M3 (±448)
+};
+
+typedef struct SimdKvCacheConfig {
+    int n_layers;
+    int n_kv_heads;
+    int head_dim;
+    int block_size;                 // 每块 token 数
+    int n_blocks;                   // 池中块数 (内存上限)
+    int dtype;                      // SIMD_KV_*
+} SimdKvCacheConfig;
+
+typedef struct SimdKvCacheStats {
+    int total_blocks;
+    int free_blocks;                // 从未使用或已释放的块
+    int cached_blocks;              // 无序列引用、保留供前缀复用的块 (空闲不足时按 LRU 逐出)
+    int used_blocks;                // 被序列引用的块
+    int prefix_blocks;              // 已登记的前缀块数
+    long long block_bytes;          // 每块字节数 (含量化缩放)
+} SimdKvCacheStats;
+
+typedef struct SimdKvCache SimdKvCache;
+SimdKvCache* simd_kv_cache_create(const SimdKvCacheConfig* cfg);
+void simd_kv_cache_destroy(SimdKvCache* cache);
+int simd_kv_cache_seq_create(SimdKvCache* cache);                   // 返回序列号
+int simd_kv_cache_seq_free(SimdKvCache* cache, int seq);
+int simd_kv_cache_seq_length(const SimdKvCache* cache, int seq);
+// 空序列复用已登记的最长满块前缀，返回复用的 token 数
+int simd_kv_cache_seq_match_prefix(SimdKvCache* cache, int seq, const int* tokens, int n);
+// 追加 n 个位置，返回第一个新位置；块不足返回 -2。tokens 可为 NULL (此后该序列不再登记前缀)
+int simd_kv_cache_seq_append(SimdKvCache* cache, int seq, const int* tokens, int n);
+// 写入/读出第 layer 层位置 [pos, pos + n)，元素 (t, h, :) 位于 base + t * token_stride + h * head_stride；
+// 读出期间序列被释放时返回 -1
+int simd_kv_cache_write(SimdKvCache* cache, int seq, int layer, int pos, int n,
+                        const float* K, long long k_token_stride, long long k_head_stride,
+                        const float* V, long long v_token_stride, long long v_head_stride);
+int simd_kv_cache_read(const SimdKvCache* cache, int seq, int layer, int pos, int n,
+                       float* K, long long k_token_stride, long long k_head_stride,
+                       float* V, long long v_token_stride, long long v_head_stride);
+int simd_kv_cache_stats(const SimdKvCache* cache, SimdKvCacheStats* stats);
+
+/**
+ * 直接读取分页 KV 缓存的融合注意力: 键值为序列 seq 第 layer 层开始计算时的全部位置
+ * (params->n_kv 与 K/V 步长被忽略；head_dim、n_kv_heads 须与缓存一致)。
+ * 计算期间的追加不影响结果；序列在计算期间被释放时返回 -1
+ */
+int simd_attention_paged(const SimdAttentionParams* params, const float* Q,
+                         const SimdKvCache* cache, int seq, int layer, float* O);
+
+/**
+ * logits 处理与采样 (HF 顺序: 惩罚 -> 温度 -> top-k -> top-p -> 抽样)，不修改 logits。
+ * history 中出现过的 token 先施加重复惩罚 (logit > 0 除以、否则乘以 repetition_penalty)，
+ * 再减去 presence_penalty + frequency_penalty * 出现次数
+ */
+typedef struct SimdSamplerParams {
+    float temperature;              // <= 0 时贪心 (取惩罚后 logit 最大者)
+    int top_k;                      // <= 0 或 >= vocab 时不限制
+    float top_p;                    // (0, 1]，1 时不限制
+    float repetition_penalty;       // 1 时不惩罚
+    float presence_penalty;
+    float frequency_penalty;
+} SimdSamplerParams;
+
+// 返回 token id，参数非法时返回 -1；rng_state 为 splitmix64 状态 (贪心时可为 NULL)，每次调用推进
+int simd_sample(const float* logits, int vocab, const int* history, int n_history,
+                const SimdSamplerParams* params, unsigned long long* rng_state);
+
+/**
+ * 对齐内存池 (simd_alloc.cpp): 按大小分级缓存已释放的块，线程本地缓存命中时不加锁。
+ * alignment 为不超过 4096 的 2 的幂 (<= 0 表示 64)，否则返回 NULL；块只能由 simd_pool_free 释放，
+ * 重复释放或传入非池指针时打印错误并终止进程
+ */
+typedef struct SimdPoolStats {
+    long long bytes_in_use;         // 已分配未释放 (按大小级别计)
+    long long bytes_cached;         // 线程缓存与全局池中的空闲块
+    long long os_allocs;            // 向系统申请的次数
+    long long cache_hits;           // 由缓存满足的分配次数
+} SimdPoolStats;
+
+void* simd_pool_alloc(long long size, int alignment);
+void simd_pool_free(void* ptr);
+void simd_pool_trim(void);                  // 把当前线程缓存与全局池的空闲块还给系统
+void simd_pool_stats(SimdPoolStats* stats);
+
+/**
+ * arena: 从池中取大块 (默认 chunk_bytes 为 4 MiB) 顺序切分，不能单独释放；
+ * reset 后此前分配的指针全部失效，大块保留供下一轮复用，destroy 时归还内存池。线程安全
+ */
+typedef struct SimdArena SimdArena;
+
+SimdArena* simd_arena_create(long long chunk_bytes);
+void simd_arena_destroy(SimdArena* arena);
+void* simd_arena_alloc(SimdArena* arena, long long size, int alignment);
+void simd_arena_reset(SimdArena* arena);
+void simd_arena_stats(const SimdArena* arena, long long* used, long long* reserved, long long* peak);
+
+/**
+ * 大页与 NUMA 内存区域 (simd_numa.cpp)，用于多 GB 的权重等长期驻留的大块内存。
+ * flags 为 SIMD_MEM_* 的组合: HUGETLB 失败 (未预留大页) 时退回透明大页；
+ * numa_policy 为 SIMD_NUMA_*，BIND/PREFERRED 使用 node，策略在首次写入前通过 mbind 设置。
+ * 区域内容初始为 0；simd_region_flags 返回实际生效的标志 (含 SIMD_MEM_NUMA)，非区域指针返回 -1
+ */
+#define SIMD_MEM_HUGEPAGE    1      // 对齐到 2 MiB 并 madvise(MADV_HUGEPAGE)
+#define SIMD_MEM_HUGETLB     2      // MAP_HUGETLB (hugetlbfs 预留大页)
+#define SIMD_MEM_POPULATE    4      // 分配时预先缺页 (页面按策略落到目标节点)
+#define SIMD_MEM_NUMA        8      // 仅出现在 simd_region_flags 结果中: NUMA 策略已生效
+
+#define SIMD_NUMA_DEFAULT    0      // 首次写入的线程所在节点
+#define SIMD_NUMA_BIND       1      // 只从 node 分配
+#define SIMD_NUMA_INTERLEAVE 2      // 所有节点按页交错
+#define SIMD_NUMA_PREFERRED  3      // 优先 node，不足时退到其他节点
+
+int simd_numa_node_count(void);
+int simd_numa_current_node(void);
+// 设置调用线程之后首次写入的页面的默认策略 (set_mempolicy)，返回 0 成功、-1 失败
+int simd_numa_set_thread_policy(int policy, int node);
+
+void* simd_region_alloc(long long size, int flags, int numa_policy, int node);
+void simd_region_free(void* ptr);
+int simd_region_flags(const void* ptr);
+
+/**
+ * 零拷贝张量存储 (simd_tensor_store.cpp): 只读 mmap safetensors 分片，data 指向映射内存，
+ * 可直接传给 GEMM/GEMV/量化内核；存储关闭后所有 data 指针失效。
+ * path 为单个 .safetensors 文件、*.safetensors.index.json 分片索引或目录；
+ * 打开失败返回 NULL，原因由 simd_tensor_store_error 给出 (调用线程最近一次打开)
+ */
+#define SIMD_TENSOR_MAX_DIMS 8
+
+typedef struct SimdTensorInfo {
+    const char* name;
+    const char* dtype;              // safetensors 类型名: "F32"/"F16"/"BF16"/"I8"/"U8" 等
+    int ndim;
+    long long shape[SIMD_TENSOR_MAX_DIMS];
+    const void* data;
+    long long nbytes;
+    int shard;
+    int alignment;                  // data 地址的对齐 (2 的幂，最大 4096)
+} SimdTensorInfo;
+
+typedef struct SimdTensorStore SimdTensorStore;
+
+SimdTensorStore* simd_tensor_store_open(const char* path);
+void simd_tensor_store_close(SimdTensorStore* store);
+const char* simd_tensor_store_error(void);
+int simd_tensor_store_count(const SimdTensorStore* store);
+int simd_tensor_store_find(const SimdTensorStore* store, const char* name);     // 不存在返回 -1
+int simd_tensor_store_info(const SimdTensorStore* store, int index, SimdTensorInfo* info);
+// 以下按名称前缀选择张量 (NULL 或 "" 为全部)，返回匹配的张量数；
+// prefetch/release 的 madvise 失败时返回 -1，原因见 simd_tensor_store_error
+int simd_tensor_store_prefetch(const SimdTensorStore* store, const char* prefix);   // madvise(WILLNEED)
+int simd_tensor_store_release(const SimdTensorStore* store, const char* prefix);    // 从 RSS 释放
+long long simd_tensor_store_resident(const SimdTensorStore* store, const char* prefix); // 在页缓存中的字节数
+
+/**
+ * 逐层权重预取 (simd_prefetch.cpp): 后台 I/O 线程以 pread 把下一层权重读入固定数量的槽位缓冲区，
+ * 与当前层的计算重叠。一个批次 (通常为一层) 由若干文件范围组成，依次放入一个槽位
+ * (各范围起点 64 字节对齐，偏移由 simd_prefetcher_offset 给出)。
+ * submit 返回槽位号: 无空闲槽位返回 -1，批次超过槽位容量或参数无效返回 -2；
+ * acquire 返回就绪批次的缓冲区 (timeout_ms 为 0 只查询，小于 0 一直等待)，未就绪时
+ * 调用线程先帮忙读取剩余部分，读取失败或超时返回 NULL。缓冲区在 release 之前有效。
+ * acquire/release 应由同一个计算线程调用
+ */
+typedef struct SimdPrefetchRange {
+    int file;                       // simd_prefetcher_add_file 返回的编号
+    long long offset;
+    long long nbytes;
+} SimdPrefetchRange;
+
+typedef struct SimdPrefetchStats {
+    long long bytes_read;
+    long long batches;              // 已读完的批次
+    long long helped_chunks;        // 由 acquire 调用线程读取的 1 MiB 块数
+    long long stall_us;             // acquire 中读取与等待的累计时间
+} SimdPrefetchStats;
+
+typedef struct SimdPrefetcher SimdPrefetcher;
+
+SimdPrefetcher* simd_prefetcher_create(int n_slots, long long slot_bytes, int n_threads);
+void simd_prefetcher_destroy(SimdPrefetcher* p);
+int simd_prefetcher_add_file(SimdPrefetcher* p, const char* path);     // 返回文件编号，失败返回 -1
+int simd_prefetcher_submit(SimdPrefetcher* p, const SimdPrefetchRange* ranges, int n_ranges);
+// 按名称前缀提交张量存储中的张量，范围顺序与存储中的张量顺序一致
+int simd_prefetcher_submit_tensors(SimdPrefetcher* p, const SimdTensorStore* store, const char* prefix);
+int simd_prefetcher_ready(const SimdPrefetcher* p, int slot);          // 1 就绪，0 读取中，-1 失败或未提交
+const void* simd_prefetcher_acquire(SimdPrefetcher* p, int slot, int timeout_ms);
+long long simd_prefetcher_offset(const SimdPrefetcher* p, int slot, int index);   // 无效返回 -1
+void simd_prefetcher_release(SimdPrefetcher* p, int slot);             // 仍在读取时等待完成
+void simd_prefetcher_stats(const SimdPrefetcher* p, SimdPrefetchStats* stats);
+
+// 线程池配置 (GEMM 与大规模逐元素运算在单次调用内并行)
+void simd_set_num_threads(int n);           // n <= 0 恢复默认 (SIMD_NUM_THREADS 或硬件线程数)
+int simd_get_num_threads(void);
+void simd_set_thread_affinity(int pinned);  // 非 0 时工作线程绑定到固定核心
+int simd_get_thread_affinity(void);
+
 #ifdef __cplusplus
 }
 #endif
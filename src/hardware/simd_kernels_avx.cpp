@@ -0,0 +1,104 @@
+/**
+ * AVX 逐元素内核 - VisionAI-ClipsMaster
+ * 256位SIMD (无FMA指令)，以 -mavx 单独编译，运行时按CPUID选用
+ *
+ * 支持任意长度与任意对齐: 以 maskload/maskstore 处理到输出 32 字节对齐，主体使用
+ * 对齐写入 (输入同样对齐时使用对齐读取)，尾部同样以掩码处理，不会越界访问
+ */
+
+#include "simd_kernels.h"
+
+#if defined(__AVX__)
+#include <immintrin.h>
+#include <cstdint>
+
+namespace {
+
+const int AVX_WIDTH = 8;
+
+// 从 TAIL_MASK_TABLE + 8 - n 处读取 8 个 int 即得到低 n 个通道的掩码
+const int32_t TAIL_MASK_TABLE[16] = {-1, -1, -1, -1, -1, -1, -1, -1, 0, 0, 0, 0, 0, 0, 0, 0};
+
+inline __m256i tail_mask(int n) {
+    return _mm256_loadu_si256(reinterpret_cast<const __m256i*>(TAIL_MASK_TABLE + AVX_WIDTH - n));
+}
+
+template <int NIN, bool ALIGNED_IN, typename Op>
+inline void elementwise_body_avx(float* const* in, float* out, int begin, int end, Op op) {
+    __m256 v[NIN];
+    for (int i = begin; i < end; i += AVX_WIDTH) {
+        for (int j = 0; j < NIN; ++j) {
+            v[j] = ALIGNED_IN ? _mm256_load_ps(in[j] + i) : _mm256_loadu_ps(in[j] + i);
+        }
+        _mm256_store_ps(out + i, op(v));
+    }
+}
+
+template <int NIN, typename Op>
+inline void elementwise_masked_avx(float* const* in, float* out, int i, int count, Op op) {
+    const __m256i m = tail_mask(count);
+    __m256 v[NIN];
+    for (int j = 0; j < NIN; ++j) {
+        v[j] = _mm256_maskload_ps(in[j] + i, m);
+    }
+    _mm256_maskstore_ps(out + i, m, op(v));
+}
+
+/**
+ * 逐元素循环: out[i] = op(in[0][i], ..., in[NIN - 1][i])，out 可与某个输入相同
+ */
+template <int NIN, typename Op>
+inline void elementwise_avx(float* const (&in)[NIN], float* out, int n, Op op) {
+    if (n <= 0) {
+        return;
+    }
+    // 输出未按 float 对齐时无法通过剥离头部对齐，整体走掩码路径
+    const uintptr_t misalign = (uintptr_t)out & 31;
+    int head = misalign % sizeof(float) == 0 ? (int)((32 - misalign) & 31) / (int)sizeof(float) : n;
+    head = head < n ? head : n;
+    for (int i = 0; i < head; i += AVX_WIDTH) {
+        const int count = head - i < AVX_WIDTH ? head - i : AVX_WIDTH;
+        elementwise_masked_avx<NIN>(in, out, i, count, op);
+    }
+    const int body_end = head + (n - head) / AVX_WIDTH * AVX_WIDTH;
+    bool aligned_in = true;
+    for (int j = 0; j < NIN; ++j) {
+        aligned_in = aligned_in && ((uintptr_t)(in[j] + head) & 31) == 0;
+    }
+    if (aligned_in) {
+        elementwise_body_avx<NIN, true>(in, out, head, body_end, op);
+    } else {
+        elementwise_body_avx<NIN, false>(in, out, head, body_end, op);
+    }
+    if (body_end < n) {
+        elementwise_masked_avx<NIN>(in, out, body_end, n - body_end, op);
+    }
+}
+
+}  // namespace
+
+void matrix_mult_avx(float* a, float* b, float* c, int n) {
+    float* const in[2] = {a, b};
+    elementwise_avx(in, c, n, [](const __m256* v) { return _mm256_mul_ps(v[0], v[1]); });
+}
+
+void matrix_add_avx(float* a, float* b, float* c, int n) {
+    float* const in[2] = {a, b};
+    elementwise_avx(in, c, n, [](const __m256* v) { return _mm256_add_ps(v[0], v[1]); });
+}
+
+void vector_scale_avx(float* vec, float scalar, int n) {
+    const __m256 vscalar = _mm256_set1_ps(scalar);
+    float* const in[1] = {vec};
+    elementwise_avx(in, vec, n, [vscalar](const __m256* v) { return _mm256_mul_ps(v[0], vscalar); });
+}
+
+// 无FMA指令时 a * b + c 拆为乘法与加法两步
+void fma_avx(float* a, float* b, float* c, float* result, int n) {
+    float* const in[3] = {a, b, c};
+    elementwise_avx(in, result, n, [](const __m256* v) {
+        return _mm256_add_ps(_mm256_mul_ps(v[0], v[1]), v[2]);
+    });
+}
+
+#endif // defined(__AVX__)
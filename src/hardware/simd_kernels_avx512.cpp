@@ -0,0 +1,100 @@
+/**
+ * AVX-512 逐元素内核 - VisionAI-ClipsMaster
+ * 512位SIMD (一次处理16个float)，以 -mavx512f 单独编译，运行时按CPUID选用
+ *
+ * 支持任意长度与任意对齐: 以掩码处理到输出 64 字节对齐，主体使用对齐写入
+ * (输入同样对齐时使用对齐读取)，不足一个向量的尾部同样以掩码处理，不会越界访问
+ */
+
+#include "simd_kernels.h"
+
+#if defined(__AVX512F__)
+#include <immintrin.h>
+#include <cstdint>
+
+namespace {
+
+const int AVX512_WIDTH = 16;
+
+inline __mmask16 tail_mask(int n) {
+    return (__mmask16)((1u << n) - 1);
+}
+
+template <int NIN, bool ALIGNED_IN, typename Op>
+inline void elementwise_body_avx512(float* const* in, float* out, int begin, int end, Op op) {
+    __m512 v[NIN];
+    for (int i = begin; i < end; i += AVX512_WIDTH) {
+        for (int j = 0; j < NIN; ++j) {
+            v[j] = ALIGNED_IN ? _mm512_load_ps(in[j] + i) : _mm512_loadu_ps(in[j] + i);
+        }
+        _mm512_store_ps(out + i, op(v));
+    }
+}
+
+template <int NIN, typename Op>
+inline void elementwise_masked_avx512(float* const* in, float* out, int i, int count, Op op) {
+    const __mmask16 m = tail_mask(count);
+    __m512 v[NIN];
+    for (int j = 0; j < NIN; ++j) {
+        v[j] = _mm512_maskz_loadu_ps(m, in[j] + i);
+    }
+    _mm512_mask_storeu_ps(out + i, m, op(v));
+}
+
+/**
+ * 逐元素循环: out[i] = op(in[0][i], ..., in[NIN - 1][i])，out 可与某个输入相同
+ */
+template <int NIN, typename Op>
+inline void elementwise_avx512(float* const (&in)[NIN], float* out, int n, Op op) {
+    if (n <= 0) {
+        return;
+    }
+    // 输出未按 float 对齐时无法通过剥离头部对齐，整体走掩码/非对齐路径
+    const uintptr_t misalign = (uintptr_t)out & 63;
+    int head = misalign % sizeof(float) == 0 ? (int)((64 - misalign) & 63) / (int)sizeof(float) : n;
+    head = head < n ? head : n;
+    for (int i = 0; i < head; i += AVX512_WIDTH) {
+        const int count = head - i < AVX512_WIDTH ? head - i : AVX512_WIDTH;
+        elementwise_masked_avx512<NIN>(in, out, i, count, op);
+    }
+    const int body_end = head + (n - head) / AVX512_WIDTH * AVX512_WIDTH;
+    bool aligned_in = true;
+    for (int j = 0; j < NIN; ++j) {
+        aligned_in = aligned_in && ((uintptr_t)(in[j] + head) & 63) == 0;
+    }
+    if (aligned_in) {
+        elementwise_body_avx512<NIN, true>(in, out, head, body_end, op);
+    } else {
+        elementwise_body_avx512<NIN, false>(in, out, head, body_end, op);
+    }
+    if (body_end < n) {
+        elementwise_masked_avx512<NIN>(in, out, body_end, n - body_end, op);
+    }
+}
+
+}  // namespace
+
+void matrix_mult_avx512(float* a, float* b, float* c, int n) {
+    float* const in[2] = {a, b};
+    elementwise_avx512(in, c, n, [](const __m512* v) { return _mm512_mul_ps(v[0], v[1]); });
+}
+
+void matrix_add_avx512(float* a, float* b, float* c, int n) {
+    float* const in[2] = {a, b};
+    elementwise_avx512(in, c, n, [](const __m512* v) { return _mm512_add_ps(v[0], v[1]); });
+}
+
+void vector_scale_avx512(float* vec, float scalar, int n) {
+    const __m512 vscalar = _mm512_set1_ps(scalar);
+    float* const in[1] = {vec};
+    elementwise_avx512(in, vec, n, [vscalar](const __m512* v) { return _mm512_mul_ps(v[0], vscalar); });
+}
+
+// FMA (Fused Multiply-Add) 支持: a * b + c
+void fma_avx512(float* a, float* b, float* c, float* result, int n) {
+    float* const in[3] = {a, b, c};
+    elementwise_avx512(in, result, n,
+                       [](const __m512* v) { return _mm512_fmadd_ps(v[0], v[1], v[2]); });
+}
+
+#endif // defined(__AVX512F__)
@@ -0,0 +1,69 @@
+/**
+ * ARM NEON 逐元素内核 - VisionAI-ClipsMaster
+ * 128位SIMD (一次处理4个float)，AArch64 上为基础指令集
+ *
+ * 支持任意长度: NEON 的 vld1q/vst1q 对对齐无要求，不足一个向量的尾部经栈上缓冲区
+ * 以部分向量计算，不会越界访问
+ */
+
+#include "simd_kernels.h"
+
+#if defined(__ARM_NEON)
+#include <arm_neon.h>
+#include <cstring>
+
+namespace {
+
+const int NEON_WIDTH = 4;
+
+/**
+ * 逐元素循环: out[i] = op(in[0][i], ..., in[NIN - 1][i])，out 可与某个输入相同
+ */
+template <int NIN, typename Op>
+inline void elementwise_neon(float* const (&in)[NIN], float* out, int n, Op op) {
+    float32x4_t v[NIN];
+    int i = 0;
+    for (; i + NEON_WIDTH <= n; i += NEON_WIDTH) {
+        for (int j = 0; j < NIN; ++j) {
+            v[j] = vld1q_f32(in[j] + i);
+        }
+        vst1q_f32(out + i, op(v));
+    }
+    if (i < n) {
+        const int count = n - i;
+        float buf[NEON_WIDTH] = {0.0f, 0.0f, 0.0f, 0.0f};
+        for (int j = 0; j < NIN; ++j) {
+            memcpy(buf, in[j] + i, count * sizeof(float));
+            v[j] = vld1q_f32(buf);
+        }
+        vst1q_f32(buf, op(v));
+        memcpy(out + i, buf, count * sizeof(float));
+    }
+}
+
+}  // namespace
+
+void matrix_mult_neon(float* a, float* b, float* c, int n) {
+    float* const in[2] = {a, b};
+    elementwise_neon(in, c, n, [](const float32x4_t* v) { return vmulq_f32(v[0], v[1]); });
+}
+
+void matrix_add_neon(float* a, float* b, float* c, int n) {
+    float* const in[2] = {a, b};
+    elementwise_neon(in, c, n, [](const float32x4_t* v) { return vaddq_f32(v[0], v[1]); });
+}
+
+void vector_scale_neon(float* vec, float scalar, int n) {
+    const float32x4_t vscalar = vdupq_n_f32(scalar);
+    float* const in[1] = {vec};
+    elementwise_neon(in, vec, n, [vscalar](const float32x4_t* v) { return vmulq_f32(v[0], vscalar); });
+}
+
+// ARM NEON FMA 支持: a * b + c
+void fma_neon(float* a, float* b, float* c, float* result, int n) {
+    float* const in[3] = {a, b, c};
+    elementwise_neon(in, result, n,
+                     [](const float32x4_t* v) { return vmlaq_f32(v[2], v[0], v[1]); });
+}
+
+#endif // defined(__ARM_NEON)
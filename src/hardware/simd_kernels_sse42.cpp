@@ -0,0 +1,110 @@
+/**
+ * SSE4.2 逐元素内核 - VisionAI-ClipsMaster
+ * 128位SIMD (一次处理4个float)，以 -msse4.2 单独编译，运行时按CPUID选用
+ *
+ * 支持任意长度与任意对齐: SSE 没有掩码读写，不足一个向量的头部/尾部经栈上缓冲区
+ * 以部分向量计算，主体在输出 16 字节对齐后使用对齐写入
+ */
+
+#include "simd_kernels.h"
+
+#if defined(__SSE4_2__)
+#include <smmintrin.h>
+#include <cstdint>
+#include <cstring>
+
+namespace {
+
+const int SSE_WIDTH = 4;
+
+template <int NIN, bool ALIGNED_IN, typename Op>
+inline void elementwise_body_sse42(float* const* in, float* out, int begin, int end, Op op) {
+    __m128 v[NIN];
+    for (int i = begin; i < end; i += SSE_WIDTH) {
+        for (int j = 0; j < NIN; ++j) {
+            v[j] = ALIGNED_IN ? _mm_load_ps(in[j] + i) : _mm_loadu_ps(in[j] + i);
+        }
+        _mm_store_ps(out + i, op(v));
+    }
+}
+
+// 计算 count (< SSE_WIDTH) 个元素: 只读写缓冲区内的有效部分
+template <int NIN, typename Op>
+inline void elementwise_partial_sse42(float* const* in, float* out, int i, int count, Op op) {
+    float buf[SSE_WIDTH] = {0.0f, 0.0f, 0.0f, 0.0f};
+    __m128 v[NIN];
+    for (int j = 0; j < NIN; ++j) {
+        memcpy(buf, in[j] + i, count * sizeof(float));
+        v[j] = _mm_loadu_ps(buf);
+    }
+    _mm_storeu_ps(buf, op(v));
+    memcpy(out + i, buf, count * sizeof(float));
+}
+
+/**
+ * 逐元素循环: out[i] = op(in[0][i], ..., in[NIN - 1][i])，out 可与某个输入相同
+ */
+template <int NIN, typename Op>
+inline void elementwise_sse42(float* const (&in)[NIN], float* out, int n, Op op) {
+    if (n <= 0) {
+        return;
+    }
+    const uintptr_t misalign = (uintptr_t)out & 15;
+    int head = misalign % sizeof(float) == 0 ? (int)((16 - misalign) & 15) / (int)sizeof(float) : 0;
+    head = head < n ? head : n;
+    if (head > 0) {
+        elementwise_partial_sse42<NIN>(in, out, 0, head, op);
+    }
+    const int body_end = head + (n - head) / SSE_WIDTH * SSE_WIDTH;
+    if (misalign % sizeof(float) != 0) {
+        // 输出未按 float 对齐时主体只能使用非对齐写入
+        __m128 v[NIN];
+        for (int i = head; i < body_end; i += SSE_WIDTH) {
+            for (int j = 0; j < NIN; ++j) {
+                v[j] = _mm_loadu_ps(in[j] + i);
+            }
+            _mm_storeu_ps(out + i, op(v));
+        }
+    } else {
+        bool aligned_in = true;
+        for (int j = 0; j < NIN; ++j) {
+            aligned_in = aligned_in && ((uintptr_t)(in[j] + head) & 15) == 0;
+        }
+        if (aligned_in) {
+            elementwise_body_sse42<NIN, true>(in, out, head, body_end, op);
+        } else {
+            elementwise_body_sse42<NIN, false>(in, out, head, body_end, op);
+        }
+    }
+    if (body_end < n) {
+        elementwise_partial_sse42<NIN>(in, out, body_end, n - body_end, op);
+    }
+}
+
+}  // namespace
+
+void matrix_mult_sse42(float* a, float* b, float* c, int n) {
+    float* const in[2] = {a, b};
+    elementwise_sse42(in, c, n, [](const __m128* v) { return _mm_mul_ps(v[0], v[1]); });
+}
+
+void matrix_add_sse42(float* a, float* b, float* c, int n) {
+    float* const in[2] = {a, b};
+    elementwise_sse42(in, c, n, [](const __m128* v) { return _mm_add_ps(v[0], v[1]); });
+}
+
+void vector_scale_sse42(float* vec, float scalar, int n) {
+    const __m128 vscalar = _mm_set1_ps(scalar);
+    float* const in[1] = {vec};
+    elementwise_sse42(in, vec, n, [vscalar](const __m128* v) { return _mm_mul_ps(v[0], vscalar); });
+}
+
+// 无FMA指令时 a * b + c 拆为乘法与加法两步
+void fma_sse42(float* a, float* b, float* c, float* result, int n) {
+    float* const in[3] = {a, b, c};
+    elementwise_sse42(in, result, n, [](const __m128* v) {
+        return _mm_add_ps(_mm_mul_ps(v[0], v[1]), v[2]);
+    });
+}
+
+#endif // defined(__SSE4_2__)
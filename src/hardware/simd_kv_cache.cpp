@@ -0,0 +1,574 @@
+/**
+ * 分页 KV 缓存 - VisionAI-ClipsMaster
+ *
+ * 长时间运行的生成会话若按序列连续分配 K/V，缓存会随会话无限增长且产生碎片。
+ * 这里在创建时按固定大小的块预留整个池，每个序列只持有块表 (逻辑块 -> 物理块)，
+ * 内存上限在创建时确定。块内按 [层][K/V][键值头][token][head_dim] 存储，
+ * 可选 int8 / fp8 (E4M3) 量化，每个 (token, 头) 一行一个缩放。
+ *
+ * 前缀复用: 所有层都写完的满块按 (父块哈希, 块内 token) 登记，新会话用
+ * simd_kv_cache_seq_match_prefix 直接引用相同前缀的块 (引用计数)。引用归零的
+ * 已登记块不立即回收，而是进入 LRU 表，空闲块用尽时才被逐出，因此结束的会话
+ * 仍可被后续相同提示词的会话复用。只有满块会被共享，追加只写入序列私有的尾块。
+ */
+
+#include "simd_kernels.h"
+#include "simd_internal.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <deque>
+#include <list>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+namespace simd_internal {
+
+namespace {
+
+struct KvSequence {
+    bool active = false;
+    bool hashable = true;       // 追加时未提供 token 后不再登记前缀
+    int n_tokens = 0;
+    int frozen = 0;             // 已登记或复用的满块数，其中的位置不可再写入
+    uint64_t hash = 0;          // 最后一个已登记块的哈希
+    uint64_t generation = 0;    // 创建序号，写入期间序列被释放重建时用于识别
+    std::vector<int> blocks;
+    std::vector<int> tokens;
+    std::vector<int> written;   // [n_layers]，每层从位置 0 起已连续写入的位置数
+};
+
+}  // namespace
+
+}  // namespace simd_internal
+
+struct SimdKvCache {
+    SimdKvCacheConfig cfg;
+    size_t elem_size;
+    size_t block_planes;        // 每块的 (层, K/V, 头) 平面数，每个平面 block_size 行
+    size_t block_elems;         // 一个块的元素数
+    size_t block_rows;          // 一个块的缩放行数 (量化时)
+    unsigned char* data;
+    float* scales;
+
+    mutable std::mutex mutex;   // 保护块分配、前缀表与序列表
+    std::vector<int> refcount;
+    std::vector<int> free_blocks;
+    std::list<int> lru;                             // 引用归零但已登记的块，表头最久未用
+    std::vector<std::list<int>::iterator> lru_pos;
+    std::vector<char> registered;
+    std::vector<uint64_t> block_hash;
+    std::vector<uint64_t> block_parent;
+    std::vector<int> block_tokens;                  // [n_blocks][block_size]，用于核对哈希命中
+    std::unordered_map<uint64_t, int> prefix;
+    std::deque<simd_internal::KvSequence> seqs;     // 追加时不移动已有序列
+    uint64_t next_generation = 0;
+};
+
+namespace simd_internal {
+
+namespace {
+
+inline uint32_t float_bits(float v) {
+    uint32_t b;
+    memcpy(&b, &v, sizeof(b));
+    return b;
+}
+
+inline float bits_float(uint32_t b) {
+    float v;
+    memcpy(&v, &b, sizeof(v));
+    return v;
+}
+
+/**
+ * float -> fp8 E4M3 (最近偶数舍入，超出 ±448 饱和；调用方已按行缩放到该范围)
+ */
+inline unsigned char fp8_e4m3_encode(float v) {
+    uint32_t bits = float_bits(v);
+    const unsigned char sign = (unsigned char)((bits >> 24) & 0x80);
+    bits &= 0x7FFFFFFFu;
+    if (bits >= 0x43E00000u) {              // >= 448 (含 Inf/NaN)
+        return sign | 0x7E;
+    }
+    if (bits < 0x3C800000u) {               // < 2^-6: 次正规数，加 2^14 使 ulp 变为 2^-9
+        return sign | (unsigned char)(float_bits(bits_float(bits) + 16384.0f) - 0x46800000u);
+    }
+    const uint32_t r = bits + 0x7FFFFu + ((bits >> 20) & 1u);
+    return sign | (unsigned char)((r - 0x3C000000u) >> 20);    // 指数偏置 127 -> 7
+}
+
+struct Fp8Table {
+    float v[256];
+    Fp8Table() {
+        for (int i = 0; i < 256; ++i) {
+            const int e = (i >> 3) & 0xF;
+            const int m = i & 7;
+            float a = e == 0 ? std::ldexp((float)m, -9) : std::ldexp(1.0f + m / 8.0f, e - 7);
+            if (e == 0xF && m == 7) {
+                a = NAN;
+            }
+            v[i] = (i & 0x80) ? -a : a;
+        }
+    }
+};
+
+const Fp8Table& fp8_table() {
+    static const Fp8Table table;
+    return table;
+}
+
+// 物理块 block 中 (层, K/V, 头) 平面第 slot 行的全局行号 (数据与缩放共用)
+inline size_t row_index(const SimdKvCache* c, int block, int layer, int kv, int head, int slot) {
+    const size_t plane = (size_t)block * c->block_planes +
+                         ((size_t)layer * 2 + kv) * c->cfg.n_kv_heads + head;
+    return plane * c->cfg.block_size + slot;
+}
+
+void quantize_row(const SimdKvCache* c, const float* x, void* dst, float* scale) {
+    const int d = c->cfg.head_dim;
+    if (c->cfg.dtype == SIMD_KV_F32) {
+        memcpy(dst, x, (size_t)d * sizeof(float));
+        return;
+    }
+    float amax = 0.0f;
+    for (int i = 0; i < d; ++i) {
+        amax = std::max(amax, std::fabs(x[i]));
+    }
+    if (c->cfg.dtype == SIMD_KV_INT8) {
+        const float inv = amax > 0.0f ? 127.0f / amax : 0.0f;
+        signed char* q = static_cast<signed char*>(dst);
+        for (int i = 0; i < d; ++i) {
+            q[i] = (signed char)std::lrint(std::min(127.0f, std::max(-127.0f, x[i] * inv)));
+        }
+        *scale = amax / 127.0f;
+    } else {
+        const float inv = amax > 0.0f ? 448.0f / amax : 0.0f;
+        unsigned char* q = static_cast<unsigned char*>(dst);
+        for (int i = 0; i < d; ++i) {
+            q[i] = fp8_e4m3_encode(x[i] * inv);
+        }
+        *scale = amax / 448.0f;
+    }
+}
+
+void dequantize_rows(const SimdKvCache* c, const unsigned char* src, const float* scales,
+                     int rows, float* out) {
+    const int d = c->cfg.head_dim;
+    if (c->cfg.dtype == SIMD_KV_INT8) {
+        const signed char* q = reinterpret_cast<const signed char*>(src);
+        for (int r = 0; r < rows; ++r) {
+            const float s = scales[r];
+            for (int i = 0; i < d; ++i) {
+                out[(size_t)r * d + i] = (float)q[(size_t)r * d + i] * s;
+            }
+        }
+    } else {
+        const float* lut = fp8_table().v;
+        for (int r = 0; r < rows; ++r) {
+            const float s = scales[r];
+            for (int i = 0; i < d; ++i) {
+                out[(size_t)r * d + i] = lut[src[(size_t)r * d + i]] * s;
+            }
+        }
+    }
+}
+
+uint64_t hash_block(uint64_t parent, const int* tokens, int n) {
+    uint64_t h = parent ^ 0x9E3779B97F4A7C15ull;
+    for (int i = 0; i < n; ++i) {
+        h = (h ^ (uint32_t)tokens[i]) * 0x100000001B3ull;
+    }
+    return h ^ (h >> 29);
+}
+
+// 以下函数须持有 c->mutex
+KvSequence* find_seq(SimdKvCache* c, int seq) {
+    if (seq < 0 || seq >= (int)c->seqs.size() || !c->seqs[seq].active) {
+        return nullptr;
+    }
+    return &c->seqs[seq];
+}
+
+int available_blocks(const SimdKvCache* c) {
+    return (int)(c->free_blocks.size() + c->lru.size());
+}
+
+int take_block(SimdKvCache* c) {
+    int b;
+    if (!c->free_blocks.empty()) {
+        b = c->free_blocks.back();
+        c->free_blocks.pop_back();
+    } else {
+        b = c->lru.front();
+        c->lru.pop_front();
+        const auto it = c->prefix.find(c->block_hash[b]);
+        if (it != c->prefix.end() && it->second == b) {
+            c->prefix.erase(it);
+        }
+        c->registered[b] = 0;
+    }
+    c->refcount[b] = 1;
+    return b;
+}
+
+void release_block(SimdKvCache* c, int b) {
+    if (--c->refcount[b] > 0) {
+        return;
+    }
+    if (c->registered[b]) {
+        c->lru_pos[b] = c->lru.insert(c->lru.end(), b);
+    } else {
+        c->free_blocks.push_back(b);
+    }
+}
+
+bool valid_config(const SimdKvCacheConfig* cfg) {
+    return cfg && cfg->n_layers > 0 && cfg->n_kv_heads > 0 && cfg->head_dim > 0 &&
+           cfg->block_size > 0 && cfg->n_blocks > 0 &&
+           (cfg->dtype == SIMD_KV_F32 || cfg->dtype == SIMD_KV_INT8 || cfg->dtype == SIMD_KV_FP8);
+}
+
+}  // namespace
+
+bool kv_cache_view(const SimdKvCache* cache, int seq, int layer, int pos, int n, KvCacheView* view) {
+    if (!cache || layer < 0 || layer >= cache->cfg.n_layers || pos < 0) {
+        return false;
+    }
+    // 块号在锁内复制，视图不引用序列的块表 (追加时可能重新分配，释放后可能被新序列复用)
+    const int bs = cache->cfg.block_size;
+    std::lock_guard<std::mutex> lock(cache->mutex);
+    const KvSequence* sp = find_seq(const_cast<SimdKvCache*>(cache), seq);
+    if (!sp) {
+        return false;
+    }
+    const KvSequence& s = *sp;
+    const int end = n < 0 ? s.n_tokens : pos + n;
+    if (end < pos || end > s.n_tokens) {
+        return false;
+    }
+    view->cache = cache;
+    view->seq = seq;
+    view->first_block = pos / bs;
+    view->blocks.assign(s.blocks.begin() + view->first_block,
+                        s.blocks.begin() + (end > pos ? (end - 1) / bs + 1 : view->first_block));
+    view->generation = s.generation;
+    view->layer = layer;
+    view->n_tokens = s.n_tokens;
+    view->block_size = cache->cfg.block_size;
+    view->head_dim = cache->cfg.head_dim;
+    view->n_kv_heads = cache->cfg.n_kv_heads;
+    view->quantized = cache->cfg.dtype != SIMD_KV_F32;
+    return true;
+}
+
+bool kv_cache_view_current(const KvCacheView& view) {
+    SimdKvCache* c = const_cast<SimdKvCache*>(view.cache);
+    std::lock_guard<std::mutex> lock(c->mutex);
+    const KvSequence* s = find_seq(c, view.seq);
+    return s && s->generation == view.generation;
+}
+
+const float* kv_cache_rows(const KvCacheView& view, int kv, int head, int pos, int len,
+                           float* buf) {
+    const SimdKvCache* c = view.cache;
+    const int bs = view.block_size;
+    const size_t row = row_index(c, view.blocks[pos / bs - view.first_block], view.layer, kv, head,
+                                 pos % bs);
+    const unsigned char* src = c->data + row * view.head_dim * c->elem_size;
+    if (!view.quantized) {
+        return reinterpret_cast<const float*>(src);
+    }
+    dequantize_rows(c, src, c->scales + row, len, buf);
+    return buf;
+}
+
+}  // namespace simd_internal
+
+/**
+ * 创建 KV 缓存并预留 n_blocks 个块；返回的句柄需通过 simd_kv_cache_destroy 释放
+ */
+SimdKvCache* simd_kv_cache_create(const SimdKvCacheConfig* cfg) {
+    using namespace simd_internal;
+    if (!valid_config(cfg)) {
+        return nullptr;
+    }
+    SimdKvCache* c = new SimdKvCache();
+    c->cfg = *cfg;
+    c->elem_size = cfg->dtype == SIMD_KV_F32 ? sizeof(float) : 1;
+    c->block_planes = (size_t)cfg->n_layers * 2 * cfg->n_kv_heads;
+    c->block_rows = c->block_planes * cfg->block_size;
+    c->block_elems = c->block_rows * cfg->head_dim;
+    c->data = static_cast<unsigned char*>(
+        weight_alloc(c->block_elems * c->elem_size * cfg->n_blocks));
+    c->scales = nullptr;
+    if (cfg->dtype != SIMD_KV_F32) {
+        c->scales = static_cast<float*>(aligned_malloc(c->block_rows * cfg->n_blocks * sizeof(float)));
+    }
+    if (!c->data || (cfg->dtype != SIMD_KV_F32 && !c->scales)) {
+        simd_kv_cache_destroy(c);
+        return nullptr;
+    }
+    c->refcount.assign(cfg->n_blocks, 0);
+    c->lru_pos.resize(cfg->n_blocks);
+    c->registered.assign(cfg->n_blocks, 0);
+    c->block_hash.assign(cfg->n_blocks, 0);
+    c->block_parent.assign(cfg->n_blocks, 0);
+    c->block_tokens.assign((size_t)cfg->n_blocks * cfg->block_size, 0);
+    c->free_blocks.reserve(cfg->n_blocks);
+    for (int b = cfg->n_blocks - 1; b >= 0; --b) {
+        c->free_blocks.push_back(b);
+    }
+    return c;
+}
+
+void simd_kv_cache_destroy(SimdKvCache* cache) {
+    if (!cache) {
+        return;
+    }
+    simd_internal::weight_free(cache->data);
+    simd_internal::aligned_free(cache->scales);
+    delete cache;
+}
+
+int simd_kv_cache_seq_create(SimdKvCache* cache) {
+    if (!cache) {
+        return -1;
+    }
+    std::lock_guard<std::mutex> lock(cache->mutex);
+    int id = 0;
+    while (id < (int)cache->seqs.size() && cache->seqs[id].active) {
+        ++id;
+    }
+    if (id == (int)cache->seqs.size()) {
+        cache->seqs.emplace_back();
+    }
+    simd_internal::KvSequence& s = cache->seqs[id];
+    s = simd_internal::KvSequence();
+    s.active = true;
+    s.generation = ++cache->next_generation;
+    s.written.assign(cache->cfg.n_layers, 0);
+    return id;
+}
+
+int simd_kv_cache_seq_free(SimdKvCache* cache, int seq) {
+    using namespace simd_internal;
+    if (!cache) {
+        return -1;
+    }
+    std::lock_guard<std::mutex> lock(cache->mutex);
+    KvSequence* s = find_seq(cache, seq);
+    if (!s) {
+        return -1;
+    }
+    // 从尾块开始释放，叶子块先进入 LRU，因而先于其前缀被逐出
+    for (auto it = s->blocks.rbegin(); it != s->blocks.rend(); ++it) {
+        release_block(cache, *it);
+    }
+    *s = KvSequence();
+    return 0;
+}
+
+int simd_kv_cache_seq_length(const SimdKvCache* cache, int seq) {
+    if (!cache) {
+        return -1;
+    }
+    std::lock_guard<std::mutex> lock(cache->mutex);
+    const simd_internal::KvSequence* s =
+        simd_internal::find_seq(const_cast<SimdKvCache*>(cache), seq);
+    return s ? s->n_tokens : -1;
+}
+
+/**
+ * 为空序列复用已登记的最长满块前缀，返回复用的 token 数 (block_size 的倍数)
+ */
+int simd_kv_cache_seq_match_prefix(SimdKvCache* cache, int seq, const int* tokens, int n) {
+    using namespace simd_internal;
+    if (!cache || n < 0 || (n > 0 && !tokens)) {
+        return -1;
+    }
+    std::lock_guard<std::mutex> lock(cache->mutex);
+    KvSequence* s = find_seq(cache, seq);
+    if (!s || s->n_tokens != 0) {
+        return -1;
+    }
+    const int bs = cache->cfg.block_size;
+    for (int t0 = 0; t0 + bs <= n; t0 += bs) {
+        const uint64_t h = hash_block(s->hash, tokens + t0, bs);
+        const auto it = cache->prefix.find(h);
+        if (it == cache->prefix.end()) {
+            break;
+        }
+        const int b = it->second;
+        if (cache->block_parent[b] != s->hash ||
+            !std::equal(tokens + t0, tokens + t0 + bs,
+                        cache->block_tokens.begin() + (size_t)b * bs)) {
+            break;
+        }
+        if (cache->refcount[b]++ == 0) {
+            cache->lru.erase(cache->lru_pos[b]);
+        }
+        s->blocks.push_back(b);
+        s->tokens.insert(s->tokens.end(), tokens + t0, tokens + t0 + bs);
+        s->n_tokens += bs;
+        s->frozen += 1;
+        s->hash = h;
+    }
+    std::fill(s->written.begin(), s->written.end(), s->n_tokens);
+    return s->n_tokens;
+}
+
+/**
+ * 为序列追加 n 个位置 (按需分配块)，返回第一个新位置；块不足时返回 -2 且不做任何修改。
+ * tokens 为这些位置的 token id，用于前缀登记；传 NULL 时该序列此后不再登记前缀
+ */
+int simd_kv_cache_seq_append(SimdKvCache* cache, int seq, const int* tokens, int n) {
+    using namespace simd_internal;
+    if (!cache || n < 0) {
+        return -1;
+    }
+    std::lock_guard<std::mutex> lock(cache->mutex);
+    KvSequence* s = find_seq(cache, seq);
+    if (!s || (long long)s->n_tokens + n > INT32_MAX) {
+        return -1;
+    }
+    const int bs = cache->cfg.block_size;
+    const int need = (int)(((long long)s->n_tokens + n + bs - 1) / bs) - (int)s->blocks.size();
+    if (need > available_blocks(cache)) {
+        return -2;
+    }
+    for (int i = 0; i < need; ++i) {
+        s->blocks.push_back(take_block(cache));
+    }
+    if (tokens && s->hashable) {
+        s->tokens.insert(s->tokens.end(), tokens, tokens + n);
+    } else if (n > 0) {
+        s->hashable = false;
+    }
+    const int first = s->n_tokens;
+    s->n_tokens += n;
+    return first;
+}
+
+/**
+ * 写入第 layer 层位置 [pos, pos + n) 的 K/V；
+ * 元素 (t, h, :) 位于 K + t * token_stride + h * head_stride，V 同理。
+ * 所有层都已写入的满块登记为可复用前缀 (各层写入顺序不限)
+ */
+int simd_kv_cache_write(SimdKvCache* cache, int seq, int layer, int pos, int n,
+                        const float* K, long long k_token_stride, long long k_head_stride,
+                        const float* V, long long v_token_stride, long long v_head_stride) {
+    using namespace simd_internal;
+    if (!cache || layer < 0 || layer >= cache->cfg.n_layers || pos < 0 || n < 0) {
+        return -1;
+    }
+    // 在锁内复制涉及的块号，写入期间序列可能被并发追加 (块表重新分配) 或释放
+    const int bs = cache->cfg.block_size;
+    std::vector<int> blocks;
+    uint64_t generation;
+    {
+        std::lock_guard<std::mutex> lock(cache->mutex);
+        const KvSequence* s = find_seq(cache, seq);
+        if (!s || pos < s->frozen * bs || (long long)pos + n > s->n_tokens) {
+            return -1;
+        }
+        generation = s->generation;
+        if (n > 0) {
+            blocks.assign(s->blocks.begin() + pos / bs, s->blocks.begin() + (pos + n - 1) / bs + 1);
+        }
+    }
+    if (n == 0) {
+        return 0;
+    }
+    if (!K || !V) {
+        return -1;
+    }
+    const int d = cache->cfg.head_dim;
+    const int heads = cache->cfg.n_kv_heads;
+    const size_t row_bytes = (size_t)d * cache->elem_size;
+    parallel_for_range((size_t)n * heads * 2, std::max(1, 4096 / d), [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i) {
+            const int t = (int)(i / (2 * heads));
+            const int kv = (int)(i / heads % 2);
+            const int h = (int)(i % heads);
+            const float* src = kv == 0 ? K + t * k_token_stride + h * k_head_stride
+                                       : V + t * v_token_stride + h * v_head_stride;
+            const int p = pos + t;
+            const size_t row = row_index(cache, blocks[p / bs - pos / bs], layer, kv, h, p % bs);
+            quantize_row(cache, src, cache->data + row * row_bytes,
+                         cache->scales ? cache->scales + row : nullptr);
+        }
+    });
+
+    std::lock_guard<std::mutex> lock(cache->mutex);
+    KvSequence* s = find_seq(cache, seq);
+    if (!s || s->generation != generation) {
+        return 0;
+    }
+    int& written = s->written[layer];
+    if (pos <= written) {
+        written = std::max(written, pos + n);
+    }
+    if (s->hashable) {
+        const int ready = *std::min_element(s->written.begin(), s->written.end());
+        while ((s->frozen + 1) * bs <= ready) {
+            const int b = s->blocks[s->frozen];
+            const int* block_tokens = s->tokens.data() + (size_t)s->frozen * bs;
+            const uint64_t h = hash_block(s->hash, block_tokens, bs);
+            if (cache->prefix.emplace(h, b).second) {
+                cache->registered[b] = 1;
+                cache->block_hash[b] = h;
+                cache->block_parent[b] = s->hash;
+                std::copy(block_tokens, block_tokens + bs,
+                          cache->block_tokens.begin() + (size_t)b * bs);
+            }
+            s->hash = h;
+            s->frozen += 1;
+        }
+    }
+    return 0;
+}
+
+/**
+ * 读出第 layer 层位置 [pos, pos + n) 的 K/V (量化块反量化为 fp32)，步长约定同写入
+ */
+int simd_kv_cache_read(const SimdKvCache* cache, int seq, int layer, int pos, int n,
+                       float* K, long long k_token_stride, long long k_head_stride,
+                       float* V, long long v_token_stride, long long v_head_stride) {
+    using namespace simd_internal;
+    KvCacheView view;
+    if (n < 0 || !kv_cache_view(cache, seq, layer, pos, n, &view) || (n > 0 && (!K || !V))) {
+        return -1;
+    }
+    const int d = view.head_dim;
+    std::vector<float> buf(view.quantized ? (size_t)d : 0);
+    for (int t = 0; t < n; ++t) {
+        for (int h = 0; h < view.n_kv_heads; ++h) {
+            const float* k = kv_cache_rows(view, 0, h, pos + t, 1, buf.data());
+            std::copy(k, k + d, K + t * k_token_stride + h * k_head_stride);
+            const float* v = kv_cache_rows(view, 1, h, pos + t, 1, buf.data());
+            std::copy(v, v + d, V + t * v_token_stride + h * v_head_stride);
+        }
+    }
+    // 读出期间序列被释放时块可能已被其他序列改写
+    return kv_cache_view_current(view) ? 0 : -1;
+}
+
+int simd_kv_cache_stats(const SimdKvCache* cache, SimdKvCacheStats* stats) {
+    if (!cache || !stats) {
+        return -1;
+    }
+    const SimdKvCache* c = cache;
+    std::lock_guard<std::mutex> lock(c->mutex);
+    stats->total_blocks = c->cfg.n_blocks;
+    stats->free_blocks = (int)c->free_blocks.size();
+    stats->cached_blocks = (int)c->lru.size();
+    stats->used_blocks = stats->total_blocks - stats->free_blocks - stats->cached_blocks;
+    stats->prefix_blocks = (int)c->prefix.size();
+    stats->block_bytes = (long long)(c->block_elems * c->elem_size +
+                                     (c->scales ? c->block_rows * sizeof(float) : 0));
+    return 0;
+}
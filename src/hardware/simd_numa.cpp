@@ -0,0 +1,420 @@
+/**
+ * 大页与 NUMA 内存区域 - VisionAI-ClipsMaster
+ *
+ * 多 GB 的权重张量按 4 KiB 页映射时 TLB 缺失明显，双路服务器上页面又落在首次写入的
+ * 线程所在节点。这里以 mmap 直接映射大块区域: 可选透明大页 (对齐到 2 MiB 后
+ * madvise(MADV_HUGEPAGE)) 或 hugetlbfs 大页 (MAP_HUGETLB，失败时退回透明大页)，
+ * 并在首次写入前通过 mbind 设置绑定/交错/优先节点策略。
+ *
+ * 节点拓扑读自 /sys/devices/system/node；mbind/set_mempolicy 直接走系统调用，
+ * 不依赖 libnuma。非 Linux 平台退回 4 KiB 对齐的普通分配，策略与大页标志被忽略。
+ */
+
+#include "simd_kernels.h"
+#include "simd_internal.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <map>
+#include <mutex>
+#include <vector>
+
+#if defined(__linux__)
+    #include <sched.h>
+    #include <sys/mman.h>
+    #include <sys/syscall.h>
+    #include <unistd.h>
+#endif
+
+namespace simd_internal {
+
+namespace {
+
+const size_t HUGE_PAGE_SIZE = (size_t)2 << 20;
+const size_t SMALL_PAGE_SIZE = 4096;
+
+// 内核 mempolicy 模式 (linux/mempolicy.h)
+const int MPOL_DEFAULT_MODE = 0;
+const int MPOL_PREFERRED_MODE = 1;
+const int MPOL_BIND_MODE = 2;
+const int MPOL_INTERLEAVE_MODE = 3;
+
+struct NumaTopology {
+    int nodes = 1;                  // 最大在线节点编号 + 1 (编号可能不连续)
+    std::vector<int> online{0};     // 在线节点编号，升序
+    std::vector<int> cpu_node;      // 下标为 CPU 编号，未知 CPU 视为节点 0
+};
+
+#if defined(__linux__)
+
+bool read_sysfs_text(const char* path, char* buf, size_t len) {
+    FILE* f = fopen(path, "r");
+    if (!f) {
+        return false;
+    }
+    const bool ok = fgets(buf, (int)len, f) != nullptr;
+    fclose(f);
+    return ok;
+}
+
+// 展开 "0-3,8-11" 形式的列表
+std::vector<int> parse_list(const char* list) {
+    std::vector<int> out;
+    const char* p = list;
+    while (*p) {
+        char* end = nullptr;
+        const long lo = strtol(p, &end, 10);
+        if (end == p) {
+            break;
+        }
+        long hi = lo;
+        p = end;
+        if (*p == '-') {
+            hi = strtol(p + 1, &end, 10);
+            p = end;
+        }
+        for (long v = lo; v <= hi; ++v) {
+            out.push_back((int)v);
+        }
+        if (*p != ',') {
+            break;
+        }
+        ++p;
+    }
+    return out;
+}
+
+#endif
+
+NumaTopology load_topology() {
+    NumaTopology topo;
+#if defined(__linux__)
+    char buf[4096];
+    if (!read_sysfs_text("/sys/devices/system/node/online", buf, sizeof(buf))) {
+        return topo;
+    }
+    std::vector<int> nodes = parse_list(buf);
+    if (nodes.empty()) {
+        return topo;
+    }
+    std::sort(nodes.begin(), nodes.end());
+    nodes.erase(std::unique(nodes.begin(), nodes.end()), nodes.end());
+    topo.nodes = nodes.back() + 1;
+    topo.online = nodes;
+    for (int node : nodes) {
+        char path[96];
+        snprintf(path, sizeof(path), "/sys/devices/system/node/node%d/cpulist", node);
+        if (!read_sysfs_text(path, buf, sizeof(buf))) {
+            continue;
+        }
+        for (int cpu : parse_list(buf)) {
+            if (cpu >= (int)topo.cpu_node.size()) {
+                topo.cpu_node.resize(cpu + 1, 0);
+            }
+            topo.cpu_node[cpu] = node;
+        }
+    }
+#endif
+    return topo;
+}
+
+const NumaTopology& topology() {
+    static const NumaTopology topo = load_topology();
+    return topo;
+}
+
+#if defined(__linux__) && defined(SYS_mbind) && defined(SYS_set_mempolicy)
+
+// 由 SIMD_NUMA_* 得到内核模式与节点掩码 (只含在线节点)，node 不在线时返回 false
+bool policy_mask(int policy, int node, int* mode, std::vector<unsigned long>* mask) {
+    const NumaTopology& topo = topology();
+    const int nodes = topo.nodes;
+    const int bits = 8 * (int)sizeof(unsigned long);
+    mask->assign((size_t)(nodes + bits - 1) / bits, 0UL);
+    switch (policy) {
+        case SIMD_NUMA_DEFAULT:
+            *mode = MPOL_DEFAULT_MODE;
+            mask->clear();
+            return true;
+        case SIMD_NUMA_INTERLEAVE:
+            *mode = MPOL_INTERLEAVE_MODE;
+            for (int n : topo.online) {
+                (*mask)[n / bits] |= 1UL << (n % bits);
+            }
+            return true;
+        case SIMD_NUMA_BIND:
+        case SIMD_NUMA_PREFERRED:
+            if (!std::binary_search(topo.online.begin(), topo.online.end(), node)) {
+                return false;
+            }
+            *mode = policy == SIMD_NUMA_BIND ? MPOL_BIND_MODE : MPOL_PREFERRED_MODE;
+            (*mask)[node / bits] |= 1UL << (node % bits);
+            return true;
+        default:
+            return false;
+    }
+}
+
+bool apply_region_policy(void* addr, size_t len, int policy, int node) {
+    int mode = 0;
+    std::vector<unsigned long> mask;
+    if (!policy_mask(policy, node, &mode, &mask)) {
+        return false;
+    }
+    // maxnode 按内核约定比掩码位数多 1
+    const unsigned long maxnode = mask.empty() ? 0 : mask.size() * 8 * sizeof(unsigned long) + 1;
+    return syscall(SYS_mbind, addr, (unsigned long)len, mode,
+                   mask.empty() ? nullptr : mask.data(), maxnode, 0U) == 0;
+}
+
+bool apply_thread_policy(int policy, int node) {
+    int mode = 0;
+    std::vector<unsigned long> mask;
+    if (!policy_mask(policy, node, &mode, &mask)) {
+        return false;
+    }
+    const unsigned long maxnode = mask.empty() ? 0 : mask.size() * 8 * sizeof(unsigned long) + 1;
+    return syscall(SYS_set_mempolicy, mode, mask.empty() ? nullptr : mask.data(), maxnode) == 0;
+}
+
+#else
+
+bool apply_region_policy(void*, size_t, int policy, int) {
+    return policy == SIMD_NUMA_DEFAULT;
+}
+
+bool apply_thread_policy(int policy, int) {
+    return policy == SIMD_NUMA_DEFAULT;
+}
+
+#endif
+
+struct Region {
+    void* base;                 // 映射起点 (非 Linux 为 aligned_malloc 返回值)
+    size_t length;
+    int flags;                  // 实际生效的 SIMD_MEM_* 标志
+};
+
+struct RegionRegistry {
+    std::mutex mutex;
+    std::map<const void*, Region> regions;
+};
+
+RegionRegistry& registry() {
+    static RegionRegistry* r = new RegionRegistry();    // 不析构: 退出阶段仍可能释放区域
+    return *r;
+}
+
+inline size_t round_up_size(size_t v, size_t a) {
+    return (v + a - 1) / a * a;
+}
+
+#if defined(__linux__)
+
+void* map_anonymous(size_t length, int extra) {
+    void* p = mmap(nullptr, length, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | extra, -1, 0);
+    return p == MAP_FAILED ? nullptr : p;
+}
+
+/**
+ * 映射起点对齐到 2 MiB 的区域 (多映射一个大页后裁掉首尾)，透明大页才能覆盖整个区域
+ */
+void* map_huge_aligned(size_t length) {
+    char* raw = static_cast<char*>(map_anonymous(length + HUGE_PAGE_SIZE, 0));
+    if (!raw) {
+        return nullptr;
+    }
+    char* aligned = reinterpret_cast<char*>(round_up_size(reinterpret_cast<uintptr_t>(raw), HUGE_PAGE_SIZE));
+    if (aligned > raw) {
+        munmap(raw, aligned - raw);
+    }
+    const size_t tail = (size_t)(raw + length + HUGE_PAGE_SIZE - (aligned + length));
+    if (tail > 0) {
+        munmap(aligned + length, tail);
+    }
+    return aligned;
+}
+
+#endif
+
+}  // namespace
+
+int numa_node_count() {
+    return topology().nodes;
+}
+
+const std::vector<int>& numa_online_nodes() {
+    return topology().online;
+}
+
+int numa_current_node() {
+#if defined(__linux__)
+    const NumaTopology& topo = topology();
+    if (topo.online.size() <= 1) {
+        return topo.online[0];
+    }
+    const int cpu = sched_getcpu();
+    return cpu >= 0 && cpu < (int)topo.cpu_node.size() ? topo.cpu_node[cpu] : 0;
+#else
+    return 0;
+#endif
+}
+
+std::vector<int> numa_spread_cpus(const std::vector<int>& cpus) {
+    const NumaTopology& topo = topology();
+    if (topo.online.size() <= 1) {
+        return cpus;
+    }
+    std::vector<std::vector<int>> per_node(topo.nodes);
+    for (int cpu : cpus) {
+        const int node = cpu < (int)topo.cpu_node.size() ? topo.cpu_node[cpu] : 0;
+        per_node[node].push_back(cpu);
+    }
+    std::vector<int> out;
+    out.reserve(cpus.size());
+    for (size_t i = 0; out.size() < cpus.size(); ++i) {
+        for (const std::vector<int>& list : per_node) {
+            if (i < list.size()) {
+                out.push_back(list[i]);
+            }
+        }
+    }
+    return out;
+}
+
+void* region_alloc(size_t size, int flags, int policy, int node) {
+    if (size == 0) {
+        size = 1;
+    }
+    Region region = {nullptr, 0, 0};
+#if defined(__linux__)
+    if (flags & SIMD_MEM_HUGETLB) {
+        region.length = round_up_size(size, HUGE_PAGE_SIZE);
+        region.base = map_anonymous(region.length, MAP_HUGETLB);
+        if (region.base) {
+            region.flags |= SIMD_MEM_HUGETLB;
+        } else {
+            flags |= SIMD_MEM_HUGEPAGE;     // 没有预留的 hugetlbfs 大页时退回透明大页
+        }
+    }
+    if (!region.base && (flags & SIMD_MEM_HUGEPAGE)) {
+        region.length = round_up_size(size, HUGE_PAGE_SIZE);
+        region.base = map_huge_aligned(region.length);
+        if (region.base && madvise(region.base, region.length, MADV_HUGEPAGE) == 0) {
+            region.flags |= SIMD_MEM_HUGEPAGE;
+        }
+    }
+    if (!region.base) {
+        region.length = round_up_size(size, SMALL_PAGE_SIZE);
+        region.base = map_anonymous(region.length, 0);
+    }
+    if (!region.base) {
+        return nullptr;
+    }
+    // 策略须在首次写入前设置，页面在缺页时按策略分配
+    if (policy != SIMD_NUMA_DEFAULT && apply_region_policy(region.base, region.length, policy, node)) {
+        region.flags |= SIMD_MEM_NUMA;
+    }
+    if (flags & SIMD_MEM_POPULATE) {
+        const size_t step = (region.flags & (SIMD_MEM_HUGETLB | SIMD_MEM_HUGEPAGE)) ? HUGE_PAGE_SIZE
+                                                                                    : SMALL_PAGE_SIZE;
+        volatile char* p = static_cast<char*>(region.base);
+        for (size_t off = 0; off < region.length; off += step) {
+            p[off] = 0;
+        }
+        region.flags |= SIMD_MEM_POPULATE;
+    }
+#else
+    (void)flags;
+    (void)node;
+    region.length = round_up_size(size, SMALL_PAGE_SIZE);
+    region.base = aligned_malloc(region.length, SMALL_PAGE_SIZE);
+    if (!region.base) {
+        return nullptr;
+    }
+    memset(region.base, 0, region.length);
+    (void)policy;
+#endif
+    RegionRegistry& reg = registry();
+    std::lock_guard<std::mutex> lock(reg.mutex);
+    reg.regions[region.base] = region;
+    return region.base;
+}
+
+bool region_free(void* ptr) {
+    if (!ptr) {
+        return false;
+    }
+    Region region;
+    {
+        RegionRegistry& reg = registry();
+        std::lock_guard<std::mutex> lock(reg.mutex);
+        auto it = reg.regions.find(ptr);
+        if (it == reg.regions.end()) {
+            return false;
+        }
+        region = it->second;
+        reg.regions.erase(it);
+    }
+#if defined(__linux__)
+    munmap(region.base, region.length);
+#else
+    aligned_free(region.base);
+#endif
+    return true;
+}
+
+int region_flags(const void* ptr) {
+    RegionRegistry& reg = registry();
+    std::lock_guard<std::mutex> lock(reg.mutex);
+    auto it = reg.regions.find(ptr);
+    return it == reg.regions.end() ? -1 : it->second.flags;
+}
+
+void* weight_alloc(size_t size) {
+    if (size < HUGE_PAGE_SIZE) {
+        return aligned_malloc(size);
+    }
+    // 所有线程都会读取的共享权重: 多节点时按页交错，各节点内存通道平均分担
+    const int policy = numa_online_nodes().size() > 1 ? SIMD_NUMA_INTERLEAVE : SIMD_NUMA_DEFAULT;
+    void* p = region_alloc(size, SIMD_MEM_HUGEPAGE, policy, -1);
+    return p ? p : aligned_malloc(size);
+}
+
+void weight_free(void* ptr) {
+    if (!region_free(ptr)) {
+        aligned_free(ptr);
+    }
+}
+
+}  // namespace simd_internal
+
+int simd_numa_node_count(void) {
+    return simd_internal::numa_node_count();
+}
+
+int simd_numa_current_node(void) {
+    return simd_internal::numa_current_node();
+}
+
+int simd_numa_set_thread_policy(int policy, int node) {
+    return simd_internal::apply_thread_policy(policy, node) ? 0 : -1;
+}
+
+void* simd_region_alloc(long long size, int flags, int numa_policy, int node) {
+    if (size < 0) {
+        return nullptr;
+    }
+    return simd_internal::region_alloc((size_t)size, flags, numa_policy, node);
+}
+
+void simd_region_free(void* ptr) {
+    simd_internal::region_free(ptr);
+}
+
+int simd_region_flags(const void* ptr) {
+    return simd_internal::region_flags(ptr);
+}
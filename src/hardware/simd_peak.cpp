@@ -0,0 +1,241 @@
+/**
+ * 机器峰值测量 - VisionAI-ClipsMaster
+ *
+ * 基准与屋顶线分析需要以本机实测峰值作为分母: 浮点峰值由多条独立 FMA 累加链的
+ * 循环测得 (按指令集分别编译)，带宽由 STREAM triad 在给定工作集上测得，
+ * 工作集落在哪级缓存即得到该级的带宽；INT8 峰值由分发选用的 INT8 GEMM 微内核在 L1 常驻的
+ * 分块上测得。各线程在线程池上各自处理私有的数据切片，
+ * 切片由执行线程首次写入，NUMA 系统上页面落在本地节点。
+ */
+
+#include "simd_kernels.h"
+#include "simd_internal.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <vector>
+
+namespace simd_internal {
+
+namespace {
+
+const int PEAK_CHAINS_GENERIC = 8;
+const int PEAK_LANES_GENERIC = 4;
+
+// 乘加分开计算 (基础指令集没有 FMA)，编译器将每条链向量化为 4 通道
+float fma_loop_generic(long long iters) {
+    float acc[PEAK_CHAINS_GENERIC][PEAK_LANES_GENERIC];
+    for (int c = 0; c < PEAK_CHAINS_GENERIC; ++c) {
+        for (int l = 0; l < PEAK_LANES_GENERIC; ++l) {
+            acc[c][l] = (float)c;
+        }
+    }
+    for (long long it = 0; it < iters; ++it) {
+        for (int c = 0; c < PEAK_CHAINS_GENERIC; ++c) {
+            for (int l = 0; l < PEAK_LANES_GENERIC; ++l) {
+                acc[c][l] = acc[c][l] * 0.999999f + 1e-6f;
+            }
+        }
+    }
+    float sum = 0.0f;
+    for (int c = 0; c < PEAK_CHAINS_GENERIC; ++c) {
+        for (int l = 0; l < PEAK_LANES_GENERIC; ++l) {
+            sum += acc[c][l];
+        }
+    }
+    return sum;
+}
+
+void triad_generic(float* a, const float* b, const float* c, float s, size_t n) {
+    for (size_t i = 0; i < n; ++i) {
+        a[i] = b[i] + s * c[i];
+    }
+}
+
+}  // namespace
+
+const PeakKernels* peak_kernels_generic() {
+    static const PeakKernels kernels = {"baseline", PEAK_CHAINS_GENERIC * PEAK_LANES_GENERIC * 2,
+                                        fma_loop_generic, triad_generic};
+    return &kernels;
+}
+
+namespace {
+
+// 单次计时的目标时长与重复次数 (取最快一次，排除频率爬升与干扰)
+const double PEAK_TARGET_SECONDS = 0.05;
+const int PEAK_REPEATS = 3;
+
+// 防止测量循环的结果被优化掉
+volatile float peak_sink;
+
+/**
+ * 按名称选择峰值内核，CPU 不支持或未编译时返回 nullptr；
+ * 名称为空时与分发表选用的变体一致 (AVX/SSE4.2/NEON 变体对应通用内核)
+ */
+const PeakKernels* peak_kernels_by_name(const char* variant) {
+    if (!variant || !*variant) {
+        variant = dispatch_table().variant;
+        if (strcmp(variant, "avx512") != 0 && strcmp(variant, "avx2") != 0) {
+            return peak_kernels_generic();
+        }
+    }
+    if (strcmp(variant, "avx512") == 0) {
+        return cpu_has_avx512f() ? peak_kernels_avx512() : nullptr;
+    }
+    if (strcmp(variant, "avx2") == 0) {
+        return cpu_has_avx2_fma() ? peak_kernels_avx2() : nullptr;
+    }
+    if (strcmp(variant, "baseline") == 0) {
+        return peak_kernels_generic();
+    }
+    return nullptr;
+}
+
+int peak_threads(int threads) {
+    const int pool = thread_pool_size();
+    return threads > 0 ? std::min(threads, pool) : pool;
+}
+
+/**
+ * 在 threads 个线程上同时执行 fn(tid, reps)，自动放大 reps 使单次计时达到目标时长，
+ * 返回最快一次的秒数并通过 reps_out 给出对应的 reps
+ */
+template <typename Fn>
+double time_parallel(int threads, long long reps, Fn fn, long long* reps_out) {
+    typedef std::chrono::steady_clock Clock;
+    auto run = [&](long long r) {
+        const Clock::time_point t0 = Clock::now();
+        parallel_for(threads, threads, [&](int task, int) { fn(task, r); });
+        return std::chrono::duration<double>(Clock::now() - t0).count();
+    };
+    double sec = run(reps);
+    while (sec < PEAK_TARGET_SECONDS) {
+        const double grow = sec > 0.0 ? PEAK_TARGET_SECONDS * 1.2 / sec : 16.0;
+        reps = (long long)((double)reps * std::min(std::max(grow, 2.0), 16.0));
+        sec = run(reps);
+    }
+    for (int r = 1; r < PEAK_REPEATS; ++r) {
+        sec = std::min(sec, run(reps));
+    }
+    *reps_out = reps;
+    return sec;
+}
+
+}  // namespace
+
+}  // namespace simd_internal
+
+double simd_peak_gflops(const char* variant, int threads) {
+    using namespace simd_internal;
+    const PeakKernels* kernels = peak_kernels_by_name(variant);
+    if (!kernels) {
+        return -1.0;
+    }
+    const int n = peak_threads(threads);
+    long long iters = 0;
+    const double sec = time_parallel(n, 1 << 14, [&](int, long long reps) {
+        peak_sink = kernels->fma_loop(reps);
+    }, &iters);
+    return (double)n * (double)iters * kernels->flops_per_iter / sec * 1e-9;
+}
+
+double simd_peak_bandwidth(long long bytes, int threads) {
+    using namespace simd_internal;
+    const PeakKernels* kernels = peak_kernels_by_name(nullptr);
+    const int n = peak_threads(threads);
+    // 每个线程三个数组，切片长度对齐到 64 字节
+    const size_t per_thread = std::max<size_t>(
+        (size_t)std::max(bytes, 0LL) / ((size_t)n * 3 * sizeof(float)) / 16 * 16, 16);
+    std::vector<float*> slices((size_t)n * 3, nullptr);
+    bool ok = true;
+    parallel_for(n, n, [&](int task, int) {
+        for (int a = 0; a < 3; ++a) {
+            float* p = static_cast<float*>(aligned_malloc(per_thread * sizeof(float)));
+            if (p) {
+                std::fill(p, p + per_thread, 1.0f);
+            }
+            slices[(size_t)task * 3 + a] = p;
+        }
+    });
+    for (float* p : slices) {
+        ok = ok && p;
+    }
+
+    double gbs = -1.0;
+    if (ok) {
+        long long passes = 0;
+        const double sec = time_parallel(n, 1, [&](int task, long long reps) {
+            float* a = slices[(size_t)task * 3];
+            const float* b = slices[(size_t)task * 3 + 1];
+            const float* c = slices[(size_t)task * 3 + 2];
+            for (long long r = 0; r < reps; ++r) {
+                kernels->triad(a, b, c, 0.5f, per_thread);
+            }
+        }, &passes);
+        // STREAM 约定: 每元素读 b、c 写 a 共 12 字节，不计写分配
+        gbs = (double)n * (double)passes * per_thread * 3 * sizeof(float) / sec * 1e-9;
+    }
+    for (float* p : slices) {
+        aligned_free(p);
+    }
+    return gbs;
+}
+
+double simd_peak_int8_gops(int threads) {
+    using namespace simd_internal;
+    const Int8GemmKernelInfo* kernel = dispatch_table().int8;
+    const int n = peak_threads(threads);
+    // 每线程一个完整分块，kp = 256 时权重面板至多 16 KiB (NR = 64)，常驻 L1
+    const int kp = 256;
+    const int mr = kernel->mr;
+    const int nr = kernel->nr;
+    struct Tile {
+        unsigned char* a;
+        signed char* b;
+        float* scales;
+        int* comp;
+        float* c;
+    };
+    std::vector<Tile> tiles((size_t)n, Tile{nullptr, nullptr, nullptr, nullptr, nullptr});
+    parallel_for(n, n, [&](int task, int) {
+        Tile& t = tiles[(size_t)task];
+        t.a = static_cast<unsigned char*>(aligned_malloc((size_t)mr * kp));
+        t.b = static_cast<signed char*>(aligned_malloc((size_t)nr * kp));
+        t.scales = static_cast<float*>(aligned_malloc(sizeof(float) * (mr + nr)));
+        t.comp = static_cast<int*>(aligned_malloc(sizeof(int) * nr));
+        t.c = static_cast<float*>(aligned_malloc(sizeof(float) * mr * nr));
+        if (t.a && t.b && t.scales && t.comp && t.c) {
+            memset(t.a, 1, (size_t)mr * kp);
+            memset(t.b, 1, (size_t)nr * kp);
+            std::fill(t.scales, t.scales + mr + nr, 1.0f);
+            memset(t.comp, 0, sizeof(int) * nr);
+        }
+    });
+    bool ok = true;
+    for (const Tile& t : tiles) {
+        ok = ok && t.a && t.b && t.scales && t.comp && t.c;
+    }
+
+    double gops = -1.0;
+    if (ok) {
+        long long calls = 0;
+        const double sec = time_parallel(n, 1 << 10, [&](int task, long long reps) {
+            const Tile& t = tiles[(size_t)task];
+            for (long long r = 0; r < reps; ++r) {
+                kernel->kernel(kp, t.a, kp, t.b, t.scales, t.scales + mr, t.comp, t.c, nr, mr, nr);
+            }
+            peak_sink = t.c[0];
+        }, &calls);
+        gops = (double)n * (double)calls * 2.0 * mr * nr * kp / sec * 1e-9;
+    }
+    for (const Tile& t : tiles) {
+        aligned_free(t.a);
+        aligned_free(t.b);
+        aligned_free(t.scales);
+        aligned_free(t.comp);
+        aligned_free(t.c);
+    }
+    return gops;
+}
@@ -0,0 +1,67 @@
+/**
+ * AVX2/FMA 峰值吞吐内核 - VisionAI-ClipsMaster
+ * 10 条独立的 FMA 累加链 (16 个 ymm 寄存器中留出常量)，覆盖 2 个 FMA 端口 x 4-5 周期延迟
+ */
+
+#include "simd_internal.h"
+
+#if defined(__AVX2__) && defined(__FMA__)
+#include <immintrin.h>
+
+namespace simd_internal {
+
+namespace {
+
+const int PEAK_CHAINS_AVX2 = 10;
+
+float fma_loop_avx2(long long iters) {
+    const __m256 m = _mm256_set1_ps(0.999999f);
+    const __m256 a = _mm256_set1_ps(1e-6f);
+    __m256 acc[PEAK_CHAINS_AVX2];
+    for (int c = 0; c < PEAK_CHAINS_AVX2; ++c) {
+        acc[c] = _mm256_set1_ps((float)c);
+    }
+    for (long long it = 0; it < iters; ++it) {
+        for (int c = 0; c < PEAK_CHAINS_AVX2; ++c) {
+            acc[c] = _mm256_fmadd_ps(acc[c], m, a);
+        }
+    }
+    __m256 sum = acc[0];
+    for (int c = 1; c < PEAK_CHAINS_AVX2; ++c) {
+        sum = _mm256_add_ps(sum, acc[c]);
+    }
+    __m128 s = _mm_add_ps(_mm256_castps256_ps128(sum), _mm256_extractf128_ps(sum, 1));
+    s = _mm_add_ps(s, _mm_movehl_ps(s, s));
+    s = _mm_add_ss(s, _mm_movehdup_ps(s));
+    return _mm_cvtss_f32(s);
+}
+
+void triad_avx2(float* a, const float* b, const float* c, float s, size_t n) {
+    const __m256 vs = _mm256_set1_ps(s);
+    size_t i = 0;
+    for (; i + 16 <= n; i += 16) {
+        _mm256_storeu_ps(a + i, _mm256_fmadd_ps(_mm256_loadu_ps(c + i), vs, _mm256_loadu_ps(b + i)));
+        _mm256_storeu_ps(a + i + 8,
+                         _mm256_fmadd_ps(_mm256_loadu_ps(c + i + 8), vs, _mm256_loadu_ps(b + i + 8)));
+    }
+    for (; i < n; ++i) {
+        a[i] = b[i] + s * c[i];
+    }
+}
+
+}  // namespace
+
+const PeakKernels* peak_kernels_avx2() {
+    static const PeakKernels kernels = {"avx2", PEAK_CHAINS_AVX2 * 8 * 2, fma_loop_avx2, triad_avx2};
+    return &kernels;
+}
+
+}  // namespace simd_internal
+
+#else  // 未启用 AVX2 编译
+
+namespace simd_internal {
+const PeakKernels* peak_kernels_avx2() { return nullptr; }
+}
+
+#endif
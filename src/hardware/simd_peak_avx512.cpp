@@ -0,0 +1,72 @@
+/**
+ * AVX-512 峰值吞吐内核 - VisionAI-ClipsMaster
+ * 16 条独立的 FMA 累加链覆盖 2 个 FMA 端口 x 4 周期延迟，测得单核浮点峰值；
+ * STREAM triad 以整向量读写测量各级缓存与内存带宽
+ */
+
+#include "simd_internal.h"
+
+#if defined(__AVX512F__)
+#include <immintrin.h>
+
+namespace simd_internal {
+
+namespace {
+
+const int PEAK_CHAINS_AVX512 = 16;
+
+float fma_loop_avx512(long long iters) {
+    const __m512 m = _mm512_set1_ps(0.999999f);
+    const __m512 a = _mm512_set1_ps(1e-6f);
+    __m512 acc[PEAK_CHAINS_AVX512];
+    for (int c = 0; c < PEAK_CHAINS_AVX512; ++c) {
+        acc[c] = _mm512_set1_ps((float)c);
+    }
+    for (long long it = 0; it < iters; ++it) {
+        for (int c = 0; c < PEAK_CHAINS_AVX512; ++c) {
+            acc[c] = _mm512_fmadd_ps(acc[c], m, a);
+        }
+    }
+    __m512 sum = acc[0];
+    for (int c = 1; c < PEAK_CHAINS_AVX512; ++c) {
+        sum = _mm512_add_ps(sum, acc[c]);
+    }
+    alignas(64) float lanes[16];
+    _mm512_store_ps(lanes, sum);
+    float total = 0.0f;
+    for (int l = 0; l < 16; ++l) {
+        total += lanes[l];
+    }
+    return total;
+}
+
+void triad_avx512(float* a, const float* b, const float* c, float s, size_t n) {
+    const __m512 vs = _mm512_set1_ps(s);
+    size_t i = 0;
+    for (; i + 32 <= n; i += 32) {
+        _mm512_storeu_ps(a + i, _mm512_fmadd_ps(_mm512_loadu_ps(c + i), vs, _mm512_loadu_ps(b + i)));
+        _mm512_storeu_ps(a + i + 16,
+                         _mm512_fmadd_ps(_mm512_loadu_ps(c + i + 16), vs, _mm512_loadu_ps(b + i + 16)));
+    }
+    for (; i < n; ++i) {
+        a[i] = b[i] + s * c[i];
+    }
+}
+
+}  // namespace
+
+const PeakKernels* peak_kernels_avx512() {
+    static const PeakKernels kernels = {"avx512", PEAK_CHAINS_AVX512 * 16 * 2, fma_loop_avx512,
+                                        triad_avx512};
+    return &kernels;
+}
+
+}  // namespace simd_internal
+
+#else  // 未启用 AVX-512 编译
+
+namespace simd_internal {
+const PeakKernels* peak_kernels_avx512() { return nullptr; }
+}
+
+#endif
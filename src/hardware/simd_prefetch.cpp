@@ -0,0 +1,479 @@
+/**
+ * 逐层权重预取 - VisionAI-ClipsMaster
+ *
+ * 权重超过内存预算 (4 GB 设备模式) 时按层从磁盘流式读入: 计算第 N 层的同时，
+ * 后台 I/O 线程用 pread 把第 N+1 层读入预先分配的槽位缓冲区，磁盘读取与计算重叠。
+ *
+ * 槽位数与容量在创建时固定，内存占用有上界。槽位状态是生产者 (I/O 线程) 与
+ * 消费者 (计算线程) 之间唯一的交接点: FREE → FILLING → LOADING → READY → FREE。
+ * 数据已就绪时 acquire 只做一次 acquire 语义的原子读，不加锁；未就绪时调用线程
+ * 先领取剩余的读取块自己读，仍有块在 I/O 线程手中才进入等待。
+ * 每个批次切成 1 MiB 的读取块，多个 I/O 线程可并行读同一批次。
+ */
+
+#include "simd_kernels.h"
+#include "simd_internal.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <cstring>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#if defined(_WIN32)
+    #include <windows.h>
+#else
+    #include <fcntl.h>
+    #include <unistd.h>
+#endif
+
+namespace simd_internal {
+
+namespace {
+
+const size_t PREFETCH_CHUNK = (size_t)1 << 20;
+const size_t PREFETCH_ALIGN = 64;
+
+enum SlotState {
+    SLOT_FREE = 0,
+    SLOT_FILLING,           // 提交方正在填写读取块
+    SLOT_LOADING,
+    SLOT_READY,
+    SLOT_FAILED,
+};
+
+#if defined(_WIN32)
+typedef HANDLE FileHandle;
+const FileHandle INVALID_FILE = INVALID_HANDLE_VALUE;
+#else
+typedef int FileHandle;
+const FileHandle INVALID_FILE = -1;
+#endif
+
+FileHandle open_file(const char* path) {
+#if defined(_WIN32)
+    return CreateFileA(path, GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+                       FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+#else
+    const int fd = open(path, O_RDONLY | O_CLOEXEC);
+#if defined(POSIX_FADV_SEQUENTIAL)
+    if (fd >= 0) {
+        posix_fadvise(fd, 0, 0, POSIX_FADV_SEQUENTIAL);     // 加大内核预读窗口
+    }
+#endif
+    return fd;
+#endif
+}
+
+void close_file(FileHandle f) {
+#if defined(_WIN32)
+    CloseHandle(f);
+#else
+    close(f);
+#endif
+}
+
+// 从文件 offset 处读满 n 字节，遇到 EOF 或错误返回 false
+bool read_at(FileHandle f, unsigned char* dst, uint64_t offset, size_t n) {
+    while (n > 0) {
+#if defined(_WIN32)
+        OVERLAPPED ov = {};
+        ov.Offset = (DWORD)offset;
+        ov.OffsetHigh = (DWORD)(offset >> 32);
+        DWORD got = 0;
+        if (!ReadFile(f, dst, (DWORD)n, &got, &ov) || got == 0) {
+            return false;
+        }
+#else
+        const ssize_t got = pread(f, dst, n, (off_t)offset);
+        if (got < 0 && errno == EINTR) {
+            continue;
+        }
+        if (got <= 0) {
+            return false;
+        }
+#endif
+        dst += got;
+        offset += (uint64_t)got;
+        n -= (size_t)got;
+    }
+    return true;
+}
+
+struct PrefetchChunk {
+    FileHandle file;
+    uint64_t file_offset;
+    size_t buf_offset;
+    size_t nbytes;
+};
+
+struct PrefetchSlot {
+    std::atomic<int> state{SLOT_FREE};
+    unsigned char* buffer = nullptr;
+    std::vector<PrefetchChunk> chunks;
+    std::vector<size_t> offsets;        // 各范围在缓冲区中的起点
+    std::atomic<int> next_chunk{0};     // 下一个待领取的读取块
+    std::atomic<int> done_chunks{0};
+    std::atomic<int> failed{0};
+};
+
+long long elapsed_us(std::chrono::steady_clock::time_point t0) {
+    return (long long)std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now() - t0).count();
+}
+
+}  // namespace
+
+}  // namespace simd_internal
+
+struct SimdPrefetcher {
+    size_t slot_bytes = 0;
+    std::vector<std::unique_ptr<simd_internal::PrefetchSlot>> slots;
+
+    std::mutex files_mutex;
+    std::vector<std::string> paths;
+    std::vector<simd_internal::FileHandle> files;
+
+    // 只保护 I/O 线程的任务队列与休眠/唤醒，不在数据交接路径上
+    std::mutex mutex;
+    std::condition_variable work_cv;
+    std::condition_variable ready_cv;
+    std::deque<int> queue;              // 仍有未领取读取块的槽位，按提交顺序
+    bool stop = false;
+    std::vector<std::thread> threads;
+
+    std::atomic<long long> bytes_read{0};
+    std::atomic<long long> batches{0};
+    std::atomic<long long> helped_chunks{0};
+    std::atomic<long long> stall_us{0};
+};
+
+namespace simd_internal {
+
+namespace {
+
+void finish_chunk(SimdPrefetcher* p, PrefetchSlot* slot) {
+    // 块数须在计数之前读取: 计数完成后槽位可能已被归还并重新填写
+    const int n_chunks = (int)slot->chunks.size();
+    if (slot->done_chunks.fetch_add(1, std::memory_order_acq_rel) + 1 != n_chunks) {
+        return;
+    }
+    const bool ok = slot->failed.load(std::memory_order_relaxed) == 0;
+    slot->state.store(ok ? SLOT_READY : SLOT_FAILED, std::memory_order_release);
+    if (ok) {
+        p->batches.fetch_add(1, std::memory_order_relaxed);
+    }
+    {
+        // 空临界区: 保证等待方在检查状态与进入休眠之间不会错过通知
+        std::lock_guard<std::mutex> lock(p->mutex);
+    }
+    p->ready_cv.notify_all();
+}
+
+void run_chunk(SimdPrefetcher* p, PrefetchSlot* slot, int index) {
+    const PrefetchChunk& c = slot->chunks[index];
+    if (read_at(c.file, slot->buffer + c.buf_offset, c.file_offset, c.nbytes)) {
+        p->bytes_read.fetch_add((long long)c.nbytes, std::memory_order_relaxed);
+    } else {
+        slot->failed.store(1, std::memory_order_relaxed);
+    }
+    finish_chunk(p, slot);
+}
+
+void io_worker(SimdPrefetcher* p) {
+    for (;;) {
+        PrefetchSlot* slot;
+        int index;
+        int n_chunks;
+        {
+            std::unique_lock<std::mutex> lock(p->mutex);
+            p->work_cv.wait(lock, [p] { return p->stop || !p->queue.empty(); });
+            if (p->stop) {
+                return;
+            }
+            slot = p->slots[p->queue.front()].get();
+            if (slot->state.load(std::memory_order_acquire) != SLOT_LOADING) {
+                p->queue.pop_front();       // 读取块已全部被领取并完成的残留项
+                continue;
+            }
+            n_chunks = (int)slot->chunks.size();
+            index = slot->next_chunk.fetch_add(1, std::memory_order_relaxed);
+            if (index >= n_chunks - 1) {
+                p->queue.pop_front();       // 最后一块已被领取 (可能由 acquire 的调用线程领走)
+            }
+        }
+        if (index < n_chunks) {
+            run_chunk(p, slot, index);
+        }
+    }
+}
+
+int add_file_locked(SimdPrefetcher* p, const char* path) {
+    for (size_t i = 0; i < p->paths.size(); ++i) {
+        if (p->paths[i] == path) {
+            return (int)i;
+        }
+    }
+    const FileHandle f = open_file(path);
+    if (f == INVALID_FILE) {
+        return -1;
+    }
+    p->paths.push_back(path);
+    p->files.push_back(f);
+    return (int)p->files.size() - 1;
+}
+
+/**
+ * 领取一个空闲槽位，把各范围排进缓冲区并切成读取块，然后交给 I/O 线程
+ */
+int submit_ranges(SimdPrefetcher* p, const std::vector<PrefetchChunk>& ranges) {
+    size_t total = 0;
+    for (const PrefetchChunk& r : ranges) {
+        total = (total + PREFETCH_ALIGN - 1) / PREFETCH_ALIGN * PREFETCH_ALIGN + r.nbytes;
+    }
+    if (ranges.empty() || total > p->slot_bytes) {
+        return -2;
+    }
+    int id = -1;
+    for (size_t i = 0; i < p->slots.size() && id < 0; ++i) {
+        int expected = SLOT_FREE;
+        if (p->slots[i]->state.compare_exchange_strong(expected, SLOT_FILLING,
+                                                       std::memory_order_acquire)) {
+            id = (int)i;
+        }
+    }
+    if (id < 0) {
+        return -1;
+    }
+    PrefetchSlot* slot = p->slots[id].get();
+    // 在队列锁内填写: I/O 线程只在持锁且槽位处于 LOADING 时读取 chunks
+    std::unique_lock<std::mutex> lock(p->mutex);
+    slot->chunks.clear();
+    slot->offsets.clear();
+    size_t pos = 0;
+    for (const PrefetchChunk& r : ranges) {
+        pos = (pos + PREFETCH_ALIGN - 1) / PREFETCH_ALIGN * PREFETCH_ALIGN;
+        slot->offsets.push_back(pos);
+        for (size_t done = 0; done < r.nbytes; done += PREFETCH_CHUNK) {
+            const size_t n = r.nbytes - done < PREFETCH_CHUNK ? r.nbytes - done : PREFETCH_CHUNK;
+            slot->chunks.push_back({r.file, r.file_offset + done, pos + done, n});
+        }
+        pos += r.nbytes;
+    }
+    slot->next_chunk.store(0, std::memory_order_relaxed);
+    slot->done_chunks.store(0, std::memory_order_relaxed);
+    slot->failed.store(0, std::memory_order_relaxed);
+    if (slot->chunks.empty()) {             // 全是空张量
+        slot->state.store(SLOT_READY, std::memory_order_release);
+        p->batches.fetch_add(1, std::memory_order_relaxed);
+        return id;
+    }
+    slot->state.store(SLOT_LOADING, std::memory_order_release);
+    p->queue.push_back(id);
+    lock.unlock();
+    p->work_cv.notify_all();
+    return id;
+}
+
+PrefetchSlot* get_slot(const SimdPrefetcher* p, int slot) {
+    return p && slot >= 0 && slot < (int)p->slots.size() ? p->slots[slot].get() : nullptr;
+}
+
+}  // namespace
+
+}  // namespace simd_internal
+
+
+/**
+ * 创建预取器: n_slots 个容量为 slot_bytes 的缓冲区 (2 MiB 以上使用大页区域)，
+ * n_threads 个后台 I/O 线程 (<= 0 时为 2)；失败返回 NULL
+ */
+SimdPrefetcher* simd_prefetcher_create(int n_slots, long long slot_bytes, int n_threads) {
+    using namespace simd_internal;
+    if (n_slots <= 0 || slot_bytes <= 0) {
+        return nullptr;
+    }
+    SimdPrefetcher* p = new SimdPrefetcher();
+    p->slot_bytes = (size_t)slot_bytes;
+    for (int i = 0; i < n_slots; ++i) {
+        std::unique_ptr<PrefetchSlot> slot(new PrefetchSlot());
+        slot->buffer = static_cast<unsigned char*>(weight_alloc(p->slot_bytes));
+        if (!slot->buffer) {
+            simd_prefetcher_destroy(p);
+            return nullptr;
+        }
+        p->slots.push_back(std::move(slot));
+    }
+    const int threads = n_threads > 0 ? std::min(n_threads, 16) : 2;
+    for (int i = 0; i < threads; ++i) {
+        p->threads.emplace_back(io_worker, p);
+    }
+    return p;
+}
+
+/**
+ * 停止 I/O 线程并释放缓冲区与文件；仍在读取的批次被放弃
+ */
+void simd_prefetcher_destroy(SimdPrefetcher* p) {
+    if (!p) {
+        return;
+    }
+    {
+        std::lock_guard<std::mutex> lock(p->mutex);
+        p->stop = true;
+    }
+    p->work_cv.notify_all();
+    for (std::thread& t : p->threads) {
+        t.join();
+    }
+    for (auto& slot : p->slots) {
+        simd_internal::weight_free(slot->buffer);
+    }
+    for (simd_internal::FileHandle f : p->files) {
+        simd_internal::close_file(f);
+    }
+    delete p;
+}
+
+int simd_prefetcher_add_file(SimdPrefetcher* p, const char* path) {
+    if (!p || !path) {
+        return -1;
+    }
+    std::lock_guard<std::mutex> lock(p->files_mutex);
+    return simd_internal::add_file_locked(p, path);
+}
+
+int simd_prefetcher_submit(SimdPrefetcher* p, const SimdPrefetchRange* ranges, int n_ranges) {
+    using namespace simd_internal;
+    if (!p || !ranges || n_ranges <= 0) {
+        return -2;
+    }
+    std::vector<PrefetchChunk> list;
+    {
+        std::lock_guard<std::mutex> lock(p->files_mutex);
+        for (int i = 0; i < n_ranges; ++i) {
+            const SimdPrefetchRange& r = ranges[i];
+            if (r.file < 0 || r.file >= (int)p->files.size() || r.offset < 0 || r.nbytes < 0) {
+                return -2;
+            }
+            list.push_back({p->files[r.file], (uint64_t)r.offset, 0, (size_t)r.nbytes});
+        }
+    }
+    return submit_ranges(p, list);
+}
+
+/**
+ * 按名称前缀提交张量存储中的一组张量 (如 "model.layers.12.")，
+ * 范围顺序与存储中的张量顺序一致
+ */
+int simd_prefetcher_submit_tensors(SimdPrefetcher* p, const SimdTensorStore* store, const char* prefix) {
+    using namespace simd_internal;
+    if (!p || !store) {
+        return -2;
+    }
+    std::vector<TensorFileRange> ranges;
+    tensor_store_ranges(store, prefix, &ranges);
+    std::vector<PrefetchChunk> list;
+    {
+        std::lock_guard<std::mutex> lock(p->files_mutex);
+        for (const TensorFileRange& r : ranges) {
+            const int file = add_file_locked(p, r.path);
+            if (file < 0) {
+                return -2;
+            }
+            list.push_back({p->files[file], r.offset, 0, r.nbytes});
+        }
+    }
+    return submit_ranges(p, list);
+}
+
+int simd_prefetcher_ready(const SimdPrefetcher* p, int slot) {
+    const simd_internal::PrefetchSlot* s = simd_internal::get_slot(p, slot);
+    if (!s) {
+        return -1;
+    }
+    const int state = s->state.load(std::memory_order_acquire);
+    return state == simd_internal::SLOT_READY ? 1 : state == simd_internal::SLOT_LOADING ? 0 : -1;
+}
+
+/**
+ * 取得就绪批次的缓冲区；未就绪时调用线程先读取尚未被 I/O 线程领取的块
+ */
+const void* simd_prefetcher_acquire(SimdPrefetcher* p, int slot, int timeout_ms) {
+    using namespace simd_internal;
+    PrefetchSlot* s = get_slot(p, slot);
+    if (!s) {
+        return nullptr;
+    }
+    int state = s->state.load(std::memory_order_acquire);
+    if (state != SLOT_LOADING || timeout_ms == 0) {
+        return state == SLOT_READY ? s->buffer : nullptr;
+    }
+    const auto t0 = std::chrono::steady_clock::now();
+    for (;;) {
+        const int index = s->next_chunk.fetch_add(1, std::memory_order_relaxed);
+        if (index >= (int)s->chunks.size()) {
+            break;
+        }
+        run_chunk(p, s, index);
+        p->helped_chunks.fetch_add(1, std::memory_order_relaxed);
+    }
+    {
+        std::unique_lock<std::mutex> lock(p->mutex);
+        auto done = [s] { return s->state.load(std::memory_order_acquire) != SLOT_LOADING; };
+        if (timeout_ms < 0) {
+            p->ready_cv.wait(lock, done);
+        } else {
+            p->ready_cv.wait_for(lock, std::chrono::milliseconds(timeout_ms), done);
+        }
+    }
+    p->stall_us.fetch_add(elapsed_us(t0), std::memory_order_relaxed);
+    state = s->state.load(std::memory_order_acquire);
+    return state == SLOT_READY ? s->buffer : nullptr;
+}
+
+long long simd_prefetcher_offset(const SimdPrefetcher* p, int slot, int index) {
+    const simd_internal::PrefetchSlot* s = simd_internal::get_slot(p, slot);
+    if (!s || s->state.load(std::memory_order_acquire) == simd_internal::SLOT_FREE ||
+        index < 0 || index >= (int)s->offsets.size()) {
+        return -1;
+    }
+    return (long long)s->offsets[index];
+}
+
+/**
+ * 归还槽位；批次仍在读取时先等待其完成
+ */
+void simd_prefetcher_release(SimdPrefetcher* p, int slot) {
+    using namespace simd_internal;
+    PrefetchSlot* s = get_slot(p, slot);
+    if (!s) {
+        return;
+    }
+    const int state = s->state.load(std::memory_order_acquire);
+    if (state == SLOT_FREE || state == SLOT_FILLING) {
+        return;
+    }
+    if (state == SLOT_LOADING) {
+        simd_prefetcher_acquire(p, slot, -1);
+    }
+    s->state.store(SLOT_FREE, std::memory_order_release);
+}
+
+void simd_prefetcher_stats(const SimdPrefetcher* p, SimdPrefetchStats* stats) {
+    if (!p || !stats) {
+        return;
+    }
+    stats->bytes_read = p->bytes_read.load(std::memory_order_relaxed);
+    stats->batches = p->batches.load(std::memory_order_relaxed);
+    stats->helped_chunks = p->helped_chunks.load(std::memory_order_relaxed);
+    stats->stall_us = p->stall_us.load(std::memory_order_relaxed);
+}
@@ -0,0 +1,239 @@
+/**
+ * AVX2/FMA 量化矩阵乘内核 - VisionAI-ClipsMaster
+ * 每次处理最多 4 行输入，整数解包后直接乘加，每个 g_idx 区间结束时再施加缩放与零点
+ */
+
+#include "simd_internal.h"
+
+#if defined(__AVX2__) && defined(__FMA__)
+#include <immintrin.h>
+#include <cstdint>
+
+namespace simd_internal {
+
+static const int AVX2_QUANT_TILE = 16;
+static const int AVX2_QUANT_ROWS = 4;
+
+// 行打包布局每次沿一行权重连续扫过的列数 (累加器缓冲区驻留 L1)
+static const int AVX2_QUANT_PANEL = 1024;
+
+// 列打包布局提前预取的权重行数
+static const int QUANT_PREFETCH_ROWS = 4;
+
+/**
+ * 行打包布局: 在一个 run 内按权重行顺序扫过 [w0, w0 + nw) 列，
+ * 部分和存放在 acc 缓冲区中，run 结束时施加缩放与零点并累加到输出
+ */
+template <int BITS, int NB>
+static void row_packed_panel_avx2(const QuantRowPackedArgs& a, int ri, int r0,
+                                    int w0, int nw, float* acc) {
+    const int per_word = 32 / BITS;
+    const __m256i mask = _mm256_set1_epi32((1 << BITS) - 1);
+    const size_t width = (size_t)a.width;
+    const QuantRun& run = a.runs[ri];
+    const float* v[NB];
+    for (int b = 0; b < NB; ++b) {
+        v[b] = a.vec + (size_t)(r0 + b) * a.ldv;
+        for (int j = 0; j < nw; j += 8) {
+            _mm256_store_ps(acc + b * AVX2_QUANT_PANEL + j, _mm256_setzero_ps());
+        }
+    }
+
+    int k = run.k_begin;
+    // 区间首尾未对齐到打包字的部分逐个处理
+    for (; k < run.k_end && k % per_word != 0; ++k) {
+        const int* src = a.qweight + (size_t)(k / per_word) * width + w0;
+        const __m128i shift = _mm_cvtsi32_si128((k % per_word) * BITS);
+        for (int j = 0; j < nw; j += 8) {
+            const __m256 q = _mm256_cvtepi32_ps(_mm256_and_si256(_mm256_srl_epi32(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + j)), shift), mask));
+            for (int b = 0; b < NB; ++b) {
+                float* p = acc + b * AVX2_QUANT_PANEL + j;
+                _mm256_store_ps(p, _mm256_fmadd_ps(_mm256_set1_ps(v[b][k]), q, _mm256_load_ps(p)));
+            }
+        }
+    }
+    for (; k + per_word <= run.k_end; k += per_word) {
+        const int* src = a.qweight + (size_t)(k / per_word) * width + w0;
+        for (int j = 0; j < nw; j += 8) {
+            __m256i x = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + j));
+            __m256 sum[NB];
+            for (int b = 0; b < NB; ++b) {
+                sum[b] = _mm256_load_ps(acc + b * AVX2_QUANT_PANEL + j);
+            }
+            for (int s = 0; s < per_word; ++s) {
+                const __m256 q = _mm256_cvtepi32_ps(_mm256_and_si256(x, mask));
+                x = _mm256_srli_epi32(x, BITS);
+                for (int b = 0; b < NB; ++b) {
+                    sum[b] = _mm256_fmadd_ps(_mm256_set1_ps(v[b][k + s]), q, sum[b]);
+                }
+            }
+            for (int b = 0; b < NB; ++b) {
+                _mm256_store_ps(acc + b * AVX2_QUANT_PANEL + j, sum[b]);
+            }
+        }
+    }
+    for (; k < run.k_end; ++k) {
+        const int* src = a.qweight + (size_t)(k / per_word) * width + w0;
+        const __m128i shift = _mm_cvtsi32_si128((k % per_word) * BITS);
+        for (int j = 0; j < nw; j += 8) {
+            const __m256 q = _mm256_cvtepi32_ps(_mm256_and_si256(_mm256_srl_epi32(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + j)), shift), mask));
+            for (int b = 0; b < NB; ++b) {
+                float* p = acc + b * AVX2_QUANT_PANEL + j;
+                _mm256_store_ps(p, _mm256_fmadd_ps(_mm256_set1_ps(v[b][k]), q, _mm256_load_ps(p)));
+            }
+        }
+    }
+
+    // out += scale * acc - scale * zero * sum(vec)
+    const float* scales = a.scales + (size_t)run.group * width + w0;
+    const float* zero_scales = a.zero_scales + (size_t)run.group * width + w0;
+    for (int b = 0; b < NB; ++b) {
+        float* out = a.out + (size_t)(r0 + b) * a.ldo + w0;
+        const float* p = acc + b * AVX2_QUANT_PANEL;
+        const __m256 sum = _mm256_set1_ps(a.run_sums[(size_t)(r0 + b) * a.n_runs + ri]);
+        for (int j = 0; j < nw; j += 8) {
+            __m256 o = _mm256_fmadd_ps(_mm256_loadu_ps(scales + j), _mm256_load_ps(p + j), _mm256_loadu_ps(out + j));
+            _mm256_storeu_ps(out + j, _mm256_fnmadd_ps(_mm256_loadu_ps(zero_scales + j), sum, o));
+        }
+    }
+}
+
+template <int BITS>
+static void row_packed_avx2(const QuantRowPackedArgs& a, int w0, int w1) {
+    alignas(32) float acc[AVX2_QUANT_ROWS * AVX2_QUANT_PANEL];
+    const int w_end = w0 + (w1 - w0) / 8 * 8;
+    for (int pw = w0; pw < w_end; pw += AVX2_QUANT_PANEL) {
+        const int nw = w_end - pw < AVX2_QUANT_PANEL ? w_end - pw : AVX2_QUANT_PANEL;
+        for (int ri = 0; ri < a.n_runs; ++ri) {
+            int r = 0;
+            for (; r + AVX2_QUANT_ROWS <= a.rows; r += AVX2_QUANT_ROWS) {
+                row_packed_panel_avx2<BITS, 4>(a, ri, r, pw, nw, acc);
+            }
+            switch (a.rows - r) {
+                case 3: row_packed_panel_avx2<BITS, 3>(a, ri, r, pw, nw, acc); break;
+                case 2: row_packed_panel_avx2<BITS, 2>(a, ri, r, pw, nw, acc); break;
+                case 1: row_packed_panel_avx2<BITS, 1>(a, ri, r, pw, nw, acc); break;
+                default: break;
+            }
+        }
+    }
+    if (w_end < w1) {
+        qmatmul_row_packed_generic(a, w_end, w1);
+    }
+}
+
+static void qmatmul_row_packed_avx2(const QuantRowPackedArgs& a, int w0, int w1) {
+    if (a.bits == 8) {
+        row_packed_avx2<8>(a, w0, w1);
+    } else if (a.bits == 4) {
+        row_packed_avx2<4>(a, w0, w1);
+    } else {
+        qmatmul_row_packed_generic(a, w0, w1);
+    }
+}
+
+/**
+ * 解包 16 个沿输出维打包的量化值
+ * 8 位: 每字节一个值；4 位: 每字节低/高半字节依次为相邻两列
+ */
+template <int BITS>
+static inline void unpack_cols_avx2(const uint8_t* src, __m256& q0, __m256& q1);
+
+template <>
+inline void unpack_cols_avx2<8>(const uint8_t* src, __m256& q0, __m256& q1) {
+    q0 = _mm256_cvtepi32_ps(_mm256_cvtepu8_epi32(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(src))));
+    q1 = _mm256_cvtepi32_ps(_mm256_cvtepu8_epi32(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(src + 8))));
+}
+
+template <>
+inline void unpack_cols_avx2<4>(const uint8_t* src, __m256& q0, __m256& q1) {
+    const __m128i nibble = _mm_set1_epi8(0x0F);
+    const __m128i x = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(src));
+    const __m128i lo = _mm_and_si128(x, nibble);
+    const __m128i hi = _mm_and_si128(_mm_srli_epi16(x, 4), nibble);
+    const __m128i q = _mm_unpacklo_epi8(lo, hi);
+    q0 = _mm256_cvtepi32_ps(_mm256_cvtepu8_epi32(q));
+    q1 = _mm256_cvtepi32_ps(_mm256_cvtepu8_epi32(_mm_srli_si128(q, 8)));
+}
+
+template <int BITS, int NB>
+static void col_packed_tile_avx2(const QuantColPackedArgs& a, int k0, int k1, int r0, int w) {
+    const size_t row_bytes = (size_t)a.width * BITS / 8;
+    const uint8_t* base = reinterpret_cast<const uint8_t*>(a.qweight) + (size_t)w * BITS / 8;
+    const float* sv[NB];
+    __m256 acc0[NB], acc1[NB];
+    for (int b = 0; b < NB; ++b) {
+        sv[b] = a.svec + (size_t)(r0 + b) * a.height;
+        acc0[b] = _mm256_setzero_ps();
+        acc1[b] = _mm256_setzero_ps();
+    }
+
+    for (int k = k0; k < k1; ++k) {
+        const uint8_t* src = base + (size_t)k * row_bytes;
+        _mm_prefetch(reinterpret_cast<const char*>(src + QUANT_PREFETCH_ROWS * row_bytes), _MM_HINT_T0);
+        __m256 q0, q1;
+        unpack_cols_avx2<BITS>(src, q0, q1);
+        for (int b = 0; b < NB; ++b) {
+            const __m256 vb = _mm256_set1_ps(sv[b][k]);
+            acc0[b] = _mm256_fmadd_ps(vb, q0, acc0[b]);
+            acc1[b] = _mm256_fmadd_ps(vb, q1, acc1[b]);
+        }
+    }
+
+    for (int b = 0; b < NB; ++b) {
+        float* out = a.out + (size_t)(r0 + b) * a.ldo + w;
+        const __m256 bias = _mm256_set1_ps(k0 == 0 ? a.bias[r0 + b] : 0.0f);
+        _mm256_storeu_ps(out, _mm256_add_ps(_mm256_loadu_ps(out), _mm256_sub_ps(acc0[b], bias)));
+        _mm256_storeu_ps(out + 8, _mm256_add_ps(_mm256_loadu_ps(out + 8), _mm256_sub_ps(acc1[b], bias)));
+    }
+}
+
+template <int BITS>
+static void col_packed_avx2(const QuantColPackedArgs& a, int w0, int w1) {
+    const int w_end = w0 + (w1 - w0) / AVX2_QUANT_TILE * AVX2_QUANT_TILE;
+    for (int k0 = 0; k0 < a.height; k0 += QUANT_K_BLOCK) {
+        const int k1 = k0 + QUANT_K_BLOCK < a.height ? k0 + QUANT_K_BLOCK : a.height;
+        for (int w = w0; w < w_end; w += AVX2_QUANT_TILE) {
+            int r = 0;
+            for (; r + AVX2_QUANT_ROWS <= a.rows; r += AVX2_QUANT_ROWS) {
+                col_packed_tile_avx2<BITS, 4>(a, k0, k1, r, w);
+            }
+            switch (a.rows - r) {
+                case 3: col_packed_tile_avx2<BITS, 3>(a, k0, k1, r, w); break;
+                case 2: col_packed_tile_avx2<BITS, 2>(a, k0, k1, r, w); break;
+                case 1: col_packed_tile_avx2<BITS, 1>(a, k0, k1, r, w); break;
+                default: break;
+            }
+        }
+    }
+    if (w_end < w1) {
+        qmatmul_col_packed_generic(a, w_end, w1);
+    }
+}
+
+static void qmatmul_col_packed_avx2(const QuantColPackedArgs& a, int w0, int w1) {
+    if (a.bits == 8) {
+        col_packed_avx2<8>(a, w0, w1);
+    } else if (a.bits == 4) {
+        col_packed_avx2<4>(a, w0, w1);
+    } else {
+        qmatmul_col_packed_generic(a, w0, w1);
+    }
+}
+
+const QuantMatmulKernels* quant_kernels_avx2() {
+    static const QuantMatmulKernels kernels = {
+        "avx2", AVX2_QUANT_TILE, qmatmul_row_packed_avx2, qmatmul_col_packed_avx2
+    };
+    return &kernels;
+}
+
+}  // namespace simd_internal
+
+#else  // 未启用 AVX2/FMA 编译
+
+namespace simd_internal {
+const QuantMatmulKernels* quant_kernels_avx2() { return nullptr; }
+}
+
+#endif
@@ -0,0 +1,243 @@
+/**
+ * AVX-512 量化矩阵乘内核 - VisionAI-ClipsMaster
+ * 每次处理最多 4 行输入，整数解包后直接乘加，每个 g_idx 区间结束时再施加缩放与零点
+ */
+
+#include "simd_internal.h"
+
+#if defined(__AVX512F__) && defined(__AVX512BW__)
+#include <immintrin.h>
+#include <cstdint>
+
+// GCC 12 对 _mm512_undefined_* 的自初始化会误报 -Wmaybe-uninitialized
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic ignored "-Wmaybe-uninitialized"
+#endif
+
+namespace simd_internal {
+
+static const int AVX512_QUANT_TILE = 32;
+static const int AVX512_QUANT_ROWS = 4;
+
+// 行打包布局每次沿一行权重连续扫过的列数 (累加器缓冲区驻留 L1)
+static const int AVX512_QUANT_PANEL = 1024;
+
+// 列打包布局提前预取的权重行数
+static const int QUANT_PREFETCH_ROWS = 4;
+
+/**
+ * 行打包布局: 在一个 run 内按权重行顺序扫过 [w0, w0 + nw) 列，
+ * 部分和存放在 acc 缓冲区中，run 结束时施加缩放与零点并累加到输出
+ */
+template <int BITS, int NB>
+static void row_packed_panel_avx512(const QuantRowPackedArgs& a, int ri, int r0,
+                                    int w0, int nw, float* acc) {
+    const int per_word = 32 / BITS;
+    const __m512i mask = _mm512_set1_epi32((1 << BITS) - 1);
+    const size_t width = (size_t)a.width;
+    const QuantRun& run = a.runs[ri];
+    const float* v[NB];
+    for (int b = 0; b < NB; ++b) {
+        v[b] = a.vec + (size_t)(r0 + b) * a.ldv;
+        for (int j = 0; j < nw; j += 16) {
+            _mm512_store_ps(acc + b * AVX512_QUANT_PANEL + j, _mm512_setzero_ps());
+        }
+    }
+
+    int k = run.k_begin;
+    // 区间首尾未对齐到打包字的部分逐个处理
+    for (; k < run.k_end && k % per_word != 0; ++k) {
+        const int* src = a.qweight + (size_t)(k / per_word) * width + w0;
+        const __m128i shift = _mm_cvtsi32_si128((k % per_word) * BITS);
+        for (int j = 0; j < nw; j += 16) {
+            const __m512 q = _mm512_cvtepi32_ps(_mm512_and_si512(_mm512_srl_epi32(_mm512_loadu_si512(src + j), shift), mask));
+            for (int b = 0; b < NB; ++b) {
+                float* p = acc + b * AVX512_QUANT_PANEL + j;
+                _mm512_store_ps(p, _mm512_fmadd_ps(_mm512_set1_ps(v[b][k]), q, _mm512_load_ps(p)));
+            }
+        }
+    }
+    for (; k + per_word <= run.k_end; k += per_word) {
+        const int* src = a.qweight + (size_t)(k / per_word) * width + w0;
+        for (int j = 0; j < nw; j += 16) {
+            __m512i x = _mm512_loadu_si512(src + j);
+            __m512 sum[NB];
+            for (int b = 0; b < NB; ++b) {
+                sum[b] = _mm512_load_ps(acc + b * AVX512_QUANT_PANEL + j);
+            }
+            for (int s = 0; s < per_word; ++s) {
+                const __m512 q = _mm512_cvtepi32_ps(_mm512_and_si512(x, mask));
+                x = _mm512_srli_epi32(x, BITS);
+                for (int b = 0; b < NB; ++b) {
+                    sum[b] = _mm512_fmadd_ps(_mm512_set1_ps(v[b][k + s]), q, sum[b]);
+                }
+            }
+            for (int b = 0; b < NB; ++b) {
+                _mm512_store_ps(acc + b * AVX512_QUANT_PANEL + j, sum[b]);
+            }
+        }
+    }
+    for (; k < run.k_end; ++k) {
+        const int* src = a.qweight + (size_t)(k / per_word) * width + w0;
+        const __m128i shift = _mm_cvtsi32_si128((k % per_word) * BITS);
+        for (int j = 0; j < nw; j += 16) {
+            const __m512 q = _mm512_cvtepi32_ps(_mm512_and_si512(_mm512_srl_epi32(_mm512_loadu_si512(src + j), shift), mask));
+            for (int b = 0; b < NB; ++b) {
+                float* p = acc + b * AVX512_QUANT_PANEL + j;
+                _mm512_store_ps(p, _mm512_fmadd_ps(_mm512_set1_ps(v[b][k]), q, _mm512_load_ps(p)));
+            }
+        }
+    }
+
+    // out += scale * acc - scale * zero * sum(vec)
+    const float* scales = a.scales + (size_t)run.group * width + w0;
+    const float* zero_scales = a.zero_scales + (size_t)run.group * width + w0;
+    for (int b = 0; b < NB; ++b) {
+        float* out = a.out + (size_t)(r0 + b) * a.ldo + w0;
+        const float* p = acc + b * AVX512_QUANT_PANEL;
+        const __m512 sum = _mm512_set1_ps(a.run_sums[(size_t)(r0 + b) * a.n_runs + ri]);
+        for (int j = 0; j < nw; j += 16) {
+            __m512 o = _mm512_fmadd_ps(_mm512_loadu_ps(scales + j), _mm512_load_ps(p + j), _mm512_loadu_ps(out + j));
+            _mm512_storeu_ps(out + j, _mm512_fnmadd_ps(_mm512_loadu_ps(zero_scales + j), sum, o));
+        }
+    }
+}
+
+template <int BITS>
+static void row_packed_avx512(const QuantRowPackedArgs& a, int w0, int w1) {
+    alignas(64) float acc[AVX512_QUANT_ROWS * AVX512_QUANT_PANEL];
+    const int w_end = w0 + (w1 - w0) / 16 * 16;
+    for (int pw = w0; pw < w_end; pw += AVX512_QUANT_PANEL) {
+        const int nw = w_end - pw < AVX512_QUANT_PANEL ? w_end - pw : AVX512_QUANT_PANEL;
+        for (int ri = 0; ri < a.n_runs; ++ri) {
+            int r = 0;
+            for (; r + AVX512_QUANT_ROWS <= a.rows; r += AVX512_QUANT_ROWS) {
+                row_packed_panel_avx512<BITS, 4>(a, ri, r, pw, nw, acc);
+            }
+            switch (a.rows - r) {
+                case 3: row_packed_panel_avx512<BITS, 3>(a, ri, r, pw, nw, acc); break;
+                case 2: row_packed_panel_avx512<BITS, 2>(a, ri, r, pw, nw, acc); break;
+                case 1: row_packed_panel_avx512<BITS, 1>(a, ri, r, pw, nw, acc); break;
+                default: break;
+            }
+        }
+    }
+    if (w_end < w1) {
+        qmatmul_row_packed_generic(a, w_end, w1);
+    }
+}
+
+static void qmatmul_row_packed_avx512(const QuantRowPackedArgs& a, int w0, int w1) {
+    if (a.bits == 8) {
+        row_packed_avx512<8>(a, w0, w1);
+    } else if (a.bits == 4) {
+        row_packed_avx512<4>(a, w0, w1);
+    } else {
+        qmatmul_row_packed_generic(a, w0, w1);
+    }
+}
+
+/**
+ * 解包 32 个沿输出维打包的量化值
+ * 8 位: 每字节一个值；4 位: 每字节低/高半字节依次为相邻两列
+ */
+template <int BITS>
+static inline void unpack_cols_avx512(const uint8_t* src, __m512& q0, __m512& q1);
+
+template <>
+inline void unpack_cols_avx512<8>(const uint8_t* src, __m512& q0, __m512& q1) {
+    q0 = _mm512_cvtepi32_ps(_mm512_cvtepu8_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i*>(src))));
+    q1 = _mm512_cvtepi32_ps(_mm512_cvtepu8_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i*>(src + 16))));
+}
+
+template <>
+inline void unpack_cols_avx512<4>(const uint8_t* src, __m512& q0, __m512& q1) {
+    const __m128i nibble = _mm_set1_epi8(0x0F);
+    const __m128i x = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src));
+    const __m128i lo = _mm_and_si128(x, nibble);
+    const __m128i hi = _mm_and_si128(_mm_srli_epi16(x, 4), nibble);
+    q0 = _mm512_cvtepi32_ps(_mm512_cvtepu8_epi32(_mm_unpacklo_epi8(lo, hi)));
+    q1 = _mm512_cvtepi32_ps(_mm512_cvtepu8_epi32(_mm_unpackhi_epi8(lo, hi)));
+}
+
+template <int BITS, int NB>
+static void col_packed_tile_avx512(const QuantColPackedArgs& a, int k0, int k1, int r0, int w) {
+    const size_t row_bytes = (size_t)a.width * BITS / 8;
+    const uint8_t* base = reinterpret_cast<const uint8_t*>(a.qweight) + (size_t)w * BITS / 8;
+    const float* sv[NB];
+    __m512 acc0[NB], acc1[NB];
+    for (int b = 0; b < NB; ++b) {
+        sv[b] = a.svec + (size_t)(r0 + b) * a.height;
+        acc0[b] = _mm512_setzero_ps();
+        acc1[b] = _mm512_setzero_ps();
+    }
+
+    for (int k = k0; k < k1; ++k) {
+        const uint8_t* src = base + (size_t)k * row_bytes;
+        _mm_prefetch(reinterpret_cast<const char*>(src + QUANT_PREFETCH_ROWS * row_bytes), _MM_HINT_T0);
+        __m512 q0, q1;
+        unpack_cols_avx512<BITS>(src, q0, q1);
+        for (int b = 0; b < NB; ++b) {
+            const __m512 vb = _mm512_set1_ps(sv[b][k]);
+            acc0[b] = _mm512_fmadd_ps(vb, q0, acc0[b]);
+            acc1[b] = _mm512_fmadd_ps(vb, q1, acc1[b]);
+        }
+    }
+
+    for (int b = 0; b < NB; ++b) {
+        float* out = a.out + (size_t)(r0 + b) * a.ldo + w;
+        const __m512 bias = _mm512_set1_ps(k0 == 0 ? a.bias[r0 + b] : 0.0f);
+        _mm512_storeu_ps(out, _mm512_add_ps(_mm512_loadu_ps(out), _mm512_sub_ps(acc0[b], bias)));
+        _mm512_storeu_ps(out + 16, _mm512_add_ps(_mm512_loadu_ps(out + 16), _mm512_sub_ps(acc1[b], bias)));
+    }
+}
+
+template <int BITS>
+static void col_packed_avx512(const QuantColPackedArgs& a, int w0, int w1) {
+    const int w_end = w0 + (w1 - w0) / AVX512_QUANT_TILE * AVX512_QUANT_TILE;
+    for (int k0 = 0; k0 < a.height; k0 += QUANT_K_BLOCK) {
+        const int k1 = k0 + QUANT_K_BLOCK < a.height ? k0 + QUANT_K_BLOCK : a.height;
+        for (int w = w0; w < w_end; w += AVX512_QUANT_TILE) {
+            int r = 0;
+            for (; r + AVX512_QUANT_ROWS <= a.rows; r += AVX512_QUANT_ROWS) {
+                col_packed_tile_avx512<BITS, 4>(a, k0, k1, r, w);
+            }
+            switch (a.rows - r) {
+                case 3: col_packed_tile_avx512<BITS, 3>(a, k0, k1, r, w); break;
+                case 2: col_packed_tile_avx512<BITS, 2>(a, k0, k1, r, w); break;
+                case 1: col_packed_tile_avx512<BITS, 1>(a, k0, k1, r, w); break;
+                default: break;
+            }
+        }
+    }
+    if (w_end < w1) {
+        qmatmul_col_packed_generic(a, w_end, w1);
+    }
+}
+
+static void qmatmul_col_packed_avx512(const QuantColPackedArgs& a, int w0, int w1) {
+    if (a.bits == 8) {
+        col_packed_avx512<8>(a, w0, w1);
+    } else if (a.bits == 4) {
+        col_packed_avx512<4>(a, w0, w1);
+    } else {
+        qmatmul_col_packed_generic(a, w0, w1);
+    }
+}
+
+const QuantMatmulKernels* quant_kernels_avx512() {
+    static const QuantMatmulKernels kernels = {
+        "avx512", AVX512_QUANT_TILE, qmatmul_row_packed_avx512, qmatmul_col_packed_avx512
+    };
+    return &kernels;
+}
+
+}  // namespace simd_internal
+
+#else  // 未启用 AVX-512 编译
+
+namespace simd_internal {
+const QuantMatmulKernels* quant_kernels_avx512() { return nullptr; }
+}
+
+#endif
@@ -0,0 +1,380 @@
+/**
+ * 量化矩阵乘 (AutoGPTQ 打包布局) - VisionAI-ClipsMaster
+ *
+ * models/models/qwen/base/cache_autogptq_cuda_kernel_256.cu 中
+ * vecquant8matmul / vecquant4matmul_batched 及 column compression 变体的 CPU 实现，
+ * 直接在打包的 qweight/scales/zeros/g_idx 上计算，无需先反量化为 fp32。
+ * 与 CUDA 版本一致，结果累加到 mul 原有值上。
+ *
+ * 按输出列分块并行；指令集内核由分发表选择，尾列使用通用实现。
+ */
+
+#include "simd_kernels.h"
+#include "simd_internal.h"
+
+#include <algorithm>
+#include <vector>
+
+namespace simd_internal {
+
+// 通用实现每次处理的输出列数 (栈上累加器)
+static const int GENERIC_QUANT_TILE = 64;
+
+// 低于该乘加次数时直接在调用线程执行
+static const double QUANT_MIN_PARALLEL_WORK = 1 << 18;
+
+void qmatmul_row_packed_generic(const QuantRowPackedArgs& a, int w0, int w1) {
+    const int per_word = 32 / a.bits;
+    const unsigned int mask = (1u << a.bits) - 1;
+    float acc[GENERIC_QUANT_TILE];
+
+    for (int ri = 0; ri < a.n_runs; ++ri) {
+        const QuantRun& run = a.runs[ri];
+        for (int wt = w0; wt < w1; wt += GENERIC_QUANT_TILE) {
+            const int nw = std::min(GENERIC_QUANT_TILE, w1 - wt);
+            for (int r = 0; r < a.rows; ++r) {
+                const float* v = a.vec + (size_t)r * a.ldv;
+                const float* sums = a.run_sums + (size_t)r * a.n_runs;
+                float* out = a.out + (size_t)r * a.ldo + wt;
+                std::fill(acc, acc + nw, 0.0f);
+                for (int k = run.k_begin; k < run.k_end; ++k) {
+                    const int* src = a.qweight + (size_t)(k / per_word) * a.width + wt;
+                    const int shift = (k % per_word) * a.bits;
+                    const float vk = v[k];
+                    for (int j = 0; j < nw; ++j) {
+                        acc[j] += vk * (float)(((unsigned int)src[j] >> shift) & mask);
+                    }
+                }
+                const size_t gw = (size_t)run.group * a.width + wt;
+                for (int j = 0; j < nw; ++j) {
+                    out[j] += a.scales[gw + j] * acc[j] - a.zero_scales[gw + j] * sums[ri];
+                }
+            }
+        }
+    }
+}
+
+void qmatmul_col_packed_generic(const QuantColPackedArgs& a, int w0, int w1) {
+    const int per_word = 32 / a.bits;
+    const int words_per_row = a.width / per_word;
+    const unsigned int mask = (1u << a.bits) - 1;
+    float acc[GENERIC_QUANT_TILE];
+
+    for (int k0 = 0; k0 < a.height; k0 += QUANT_K_BLOCK) {
+        const int k1 = std::min(a.height, k0 + QUANT_K_BLOCK);
+        for (int wt = w0; wt < w1; wt += GENERIC_QUANT_TILE) {
+            const int nw = std::min(GENERIC_QUANT_TILE, w1 - wt);
+            for (int r = 0; r < a.rows; ++r) {
+                const float* sv = a.svec + (size_t)r * a.height;
+                std::fill(acc, acc + nw, 0.0f);
+                for (int k = k0; k < k1; ++k) {
+                    const int* src = a.qweight + (size_t)k * words_per_row;
+                    const float vk = sv[k];
+                    for (int j = 0; j < nw; ++j) {
+                        const int w = wt + j;
+                        const unsigned int word = (unsigned int)src[w / per_word];
+                        acc[j] += vk * (float)((word >> ((w % per_word) * a.bits)) & mask);
+                    }
+                }
+                const float bias = k0 == 0 ? a.bias[r] : 0.0f;
+                float* out = a.out + (size_t)r * a.ldo + wt;
+                for (int j = 0; j < nw; ++j) {
+                    out[j] += acc[j] - bias;
+                }
+            }
+        }
+    }
+}
+
+const QuantMatmulKernels* quant_kernels_generic() {
+    static const QuantMatmulKernels kernels = {
+        "generic", GENERIC_QUANT_TILE, qmatmul_row_packed_generic, qmatmul_col_packed_generic
+    };
+    return &kernels;
+}
+
+namespace {
+
+/**
+ * 将 g_idx 切分为取值相同、长度不超过 QUANT_K_BLOCK 的连续区间
+ * g_idx 为空时整个输入维属于第 0 组；按 act-order 量化的模型 g_idx 无序，
+ * 此时区间较短但结果依旧正确
+ */
+void build_runs(const int* g_idx, int height, std::vector<QuantRun>& runs) {
+    runs.clear();
+    int begin = 0;
+    for (int k = 1; k <= height; ++k) {
+        const int group = g_idx ? g_idx[begin] : 0;
+        if (k == height || k - begin == QUANT_K_BLOCK || (g_idx && g_idx[k] != group)) {
+            QuantRun run = {begin, k, group};
+            runs.push_back(run);
+            begin = k;
+        }
+    }
+}
+
+/**
+ * 计算 zero_scales[g, w] = scales[g, w] * zero(g, w)
+ * packed 为 true 时零点按 bits 位打包，解包后加上 zero_offset
+ */
+void prepare_zero_scales(const float* scales, const int* zeros, int groups, int width,
+                         int zero_width, bool packed, int bits, int zero_offset,
+                         float* zero_scales) {
+    const int per_word = 32 / bits;
+    const unsigned int mask = (1u << bits) - 1;
+    for (int g = 0; g < groups; ++g) {
+        const float* s = scales + (size_t)g * width;
+        const int* z = zeros + (size_t)g * zero_width;
+        float* zs = zero_scales + (size_t)g * width;
+        if (!packed) {
+            for (int w = 0; w < width; ++w) {
+                zs[w] = s[w] * (float)z[w];
+            }
+            continue;
+        }
+        for (int w0 = 0; w0 < width; w0 += per_word) {
+            const unsigned int word = (unsigned int)z[w0 / per_word];
+            const int n = std::min(per_word, width - w0);
+            for (int j = 0; j < n; ++j) {
+                const float zero = (float)(((word >> (j * bits)) & mask) + zero_offset);
+                zs[w0 + j] = s[w0 + j] * zero;
+            }
+        }
+    }
+}
+
+void prepare_run_sums(const float* vec, int ldv, int rows, const std::vector<QuantRun>& runs,
+                      float* run_sums) {
+    const int n_runs = (int)runs.size();
+    for (int r = 0; r < rows; ++r) {
+        const float* v = vec + (size_t)r * ldv;
+        for (int ri = 0; ri < n_runs; ++ri) {
+            float sum = 0.0f;
+            for (int k = runs[ri].k_begin; k < runs[ri].k_end; ++k) {
+                sum += v[k];
+            }
+            run_sums[(size_t)r * n_runs + ri] = sum;
+        }
+    }
+}
+
+/**
+ * 将 n_mats 个矩阵的输出列按分块切成任务，并在线程池上执行
+ * fn(mat, w0, w1) 中 w0 对齐到内核分块
+ */
+template <typename Fn>
+void parallel_quant_columns(int n_mats, int width, int tile, double work, Fn fn) {
+    const int tiles = (width + tile - 1) / tile;
+    if (n_mats <= 0 || tiles <= 0) {
+        return;
+    }
+    const int threads = work < QUANT_MIN_PARALLEL_WORK ? 1 : thread_pool_size();
+    // 每个线程约 4 个任务，便于负载均衡
+    const int target = std::max(1, 4 * threads / n_mats);
+    const int chunks = std::min(tiles, target);
+    const int tiles_per_chunk = (tiles + chunks - 1) / chunks;
+    const int chunk_cols = tiles_per_chunk * tile;
+    const int chunks_per_mat = (width + chunk_cols - 1) / chunk_cols;
+
+    parallel_for(n_mats * chunks_per_mat, threads, [&](int task, int) {
+        const int mat = task / chunks_per_mat;
+        const int w0 = (task % chunks_per_mat) * chunk_cols;
+        const int w1 = std::min(width, w0 + chunk_cols);
+        fn(mat, w0, w1);
+    });
+}
+
+/**
+ * 沿输入维打包的批量量化矩阵乘，每个 (batch, head) 对应独立的权重、
+ * 单组 scales [width] 与零点 [zero_width]
+ */
+void run_row_packed_batched(const float* vec, const int* mat, float* mul,
+                            const float* scales, const int* zeros,
+                            int batch, int heads, int vec_row, int vec_height,
+                            int width, int zero_width, int bits, int zero_offset) {
+    if (batch <= 0 || heads <= 0 || vec_row <= 0 || vec_height <= 0 || width <= 0) {
+        return;
+    }
+    const int n_mats = batch * heads;
+    const int per_word = 32 / bits;
+    const int height = (vec_height + per_word - 1) / per_word;
+
+    std::vector<QuantRun> runs;
+    build_runs(nullptr, vec_height, runs);
+    std::vector<float> zero_scales((size_t)n_mats * width);
+    std::vector<float> run_sums((size_t)n_mats * vec_row);
+    for (int m = 0; m < n_mats; ++m) {
+        prepare_zero_scales(scales + (size_t)m * width, zeros + (size_t)m * zero_width,
+                            1, width, zero_width, zero_width != width, bits, zero_offset,
+                            zero_scales.data() + (size_t)m * width);
+        prepare_run_sums(vec + (size_t)m * vec_row * vec_height, vec_height, vec_row, runs,
+                         run_sums.data() + (size_t)m * vec_row);
+    }
+
+    const QuantMatmulKernels* kernels = dispatch_table().quant;
+    const double work = (double)n_mats * vec_row * vec_height * width;
+    parallel_quant_columns(n_mats, width, kernels->tile, work, [&](int m, int w0, int w1) {
+        QuantRowPackedArgs args;
+        args.qweight = mat + (size_t)m * height * width;
+        args.scales = scales + (size_t)m * width;
+        args.zero_scales = zero_scales.data() + (size_t)m * width;
+        args.bits = bits;
+        args.height = vec_height;
+        args.width = width;
+        args.runs = runs.data();
+        args.n_runs = (int)runs.size();
+        args.vec = vec + (size_t)m * vec_row * vec_height;
+        args.ldv = vec_height;
+        args.run_sums = run_sums.data() + (size_t)m * vec_row;
+        args.out = mul + (size_t)m * vec_row * width;
+        args.ldo = width;
+        args.rows = vec_row;
+        kernels->row_packed(args, w0, w1);
+    });
+}
+
+/**
+ * 沿输出维打包的批量量化矩阵乘，scales/zeros 按 (batch, head, k) 逐行给出
+ */
+void run_col_packed_batched(const float* vec, const int* mat, float* mul,
+                            const float* scales, const int* zeros,
+                            int batch, int heads, int vec_row, int height, int width, int bits) {
+    if (batch <= 0 || heads <= 0 || vec_row <= 0 || height <= 0 || width <= 0) {
+        return;
+    }
+    const int n_mats = batch * heads;
+    const int words_per_row = width / (32 / bits);
+
+    // svec = vec * scale[k]，bias = sum_k svec * zero[k]
+    std::vector<float> svec((size_t)n_mats * vec_row * height);
+    std::vector<float> bias((size_t)n_mats * vec_row);
+    for (int m = 0; m < n_mats; ++m) {
+        const float* s = scales + (size_t)m * height;
+        const int* z = zeros + (size_t)m * height;
+        for (int r = 0; r < vec_row; ++r) {
+            const size_t row = (size_t)m * vec_row + r;
+            const float* v = vec + row * height;
+            float* sv = svec.data() + row * height;
+            float b = 0.0f;
+            for (int k = 0; k < height; ++k) {
+                sv[k] = v[k] * s[k];
+                b += sv[k] * (float)z[k];
+            }
+            bias[row] = b;
+        }
+    }
+
+    const QuantMatmulKernels* kernels = dispatch_table().quant;
+    const double work = (double)n_mats * vec_row * height * width;
+    parallel_quant_columns(n_mats, width, kernels->tile, work, [&](int m, int w0, int w1) {
+        QuantColPackedArgs args;
+        args.qweight = mat + (size_t)m * height * words_per_row;
+        args.bits = bits;
+        args.height = height;
+        args.width = width;
+        args.svec = svec.data() + (size_t)m * vec_row * height;
+        args.bias = bias.data() + (size_t)m * vec_row;
+        args.out = mul + (size_t)m * vec_row * width;
+        args.ldo = width;
+        args.rows = vec_row;
+        kernels->col_packed(args, w0, w1);
+    });
+}
+
+}  // namespace
+
+}  // namespace simd_internal
+
+/**
+ * 8 位分组量化矩阵乘 (对应 VecQuant8MatMulKernel)
+ *   vec [batch, vec_height]，qweight [vec_height / 4, width]，mul [batch, width]
+ *   scales [groups, width]，zeros [groups, zero_width] (打包，零点 +1)，g_idx [vec_height]
+ */
+void vecquant8matmul(const float* vec, const int* qweight, float* mul,
+                     const float* scales, const int* zeros, const int* g_idx,
+                     int batch, int vec_height, int width, int groups, int zero_width) {
+    using namespace simd_internal;
+    if (batch <= 0 || vec_height <= 0 || width <= 0 || groups <= 0) {
+        return;
+    }
+
+    std::vector<QuantRun> runs;
+    build_runs(g_idx, vec_height, runs);
+    std::vector<float> zero_scales((size_t)groups * width);
+    prepare_zero_scales(scales, zeros, groups, width, zero_width, true, 8, 1, zero_scales.data());
+    std::vector<float> run_sums((size_t)batch * runs.size());
+    prepare_run_sums(vec, vec_height, batch, runs, run_sums.data());
+
+    const QuantMatmulKernels* kernels = dispatch_table().quant;
+    const double work = (double)batch * vec_height * width;
+    parallel_quant_columns(1, width, kernels->tile, work, [&](int, int w0, int w1) {
+        QuantRowPackedArgs args;
+        args.qweight = qweight;
+        args.scales = scales;
+        args.zero_scales = zero_scales.data();
+        args.bits = 8;
+        args.height = vec_height;
+        args.width = width;
+        args.runs = runs.data();
+        args.n_runs = (int)runs.size();
+        args.vec = vec;
+        args.ldv = vec_height;
+        args.run_sums = run_sums.data();
+        args.out = mul;
+        args.ldo = width;
+        args.rows = batch;
+        kernels->row_packed(args, w0, w1);
+    });
+}
+
+/**
+ * 8 位批量量化矩阵乘 (对应 VecQuant8BatchMatMulKernel)
+ *   vec [batch, heads, vec_row, vec_height]，qweight [batch, heads, vec_height / 4, width]
+ *   scales [batch, heads, width]，zeros [batch, heads, zero_width]
+ *   zero_width == width 时零点未打包，否则为 8 位打包且零点 +1
+ */
+void vecquant8matmul_batched(const float* vec, const int* qweight, float* mul,
+                             const float* scales, const int* zeros,
+                             int batch, int heads, int vec_row, int vec_height,
+                             int width, int zero_width) {
+    simd_internal::run_row_packed_batched(vec, qweight, mul, scales, zeros, batch, heads,
+                                          vec_row, vec_height, width, zero_width, 8, 1);
+}
+
+/**
+ * 4 位批量量化矩阵乘 (对应 VecQuant4BatchMatMulKernel)
+ *   qweight [batch, heads, vec_height / 8, width]，其余同 vecquant8matmul_batched，
+ *   打包零点不加 1
+ */
+void vecquant4matmul_batched(const float* vec, const int* qweight, float* mul,
+                             const float* scales, const int* zeros,
+                             int batch, int heads, int vec_row, int vec_height,
+                             int width, int zero_width) {
+    simd_internal::run_row_packed_batched(vec, qweight, mul, scales, zeros, batch, heads,
+                                          vec_row, vec_height, width, zero_width, 4, 0);
+}
+
+/**
+ * 8 位列压缩批量量化矩阵乘 (对应 VecQuant8BatchMatMulColumnCompressionKernel)
+ *   vec [batch, heads, vec_row, height]，qweight [batch, heads, height, width / 4]
+ *   scales/zeros [batch, heads, height] (零点未打包)
+ */
+void vecquant8matmul_batched_column_compression(const float* vec, const int* qweight, float* mul,
+                                                const float* scales, const int* zeros,
+                                                int batch, int heads, int vec_row,
+                                                int height, int width) {
+    simd_internal::run_col_packed_batched(vec, qweight, mul, scales, zeros,
+                                          batch, heads, vec_row, height, width, 8);
+}
+
+/**
+ * 4 位列压缩批量量化矩阵乘 (对应 VecQuant4BatchMatMulColumnCompressionKernel)
+ *   qweight [batch, heads, height, width / 8]，其余同 8 位版本
+ */
+void vecquant4matmul_batched_column_compression(const float* vec, const int* qweight, float* mul,
+                                                const float* scales, const int* zeros,
+                                                int batch, int heads, int vec_row,
+                                                int height, int width) {
+    simd_internal::run_col_packed_batched(vec, qweight, mul, scales, zeros,
+                                          batch, heads, vec_row, height, width, 4);
+}
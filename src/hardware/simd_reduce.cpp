@@ -0,0 +1,599 @@
+/**
+ * 向量化归约 - VisionAI-ClipsMaster
+ *
+ * sum / min / max / argmax / L1 / L2 范数 / 均值方差，支持一维与二维按轴归约。
+ * 指令集内核只负责一个块 (长度由 L1d 容量推导) 内的多累加器归约，
+ * 驱动层在块之间成对求和，使舍入误差随 log n 而不是 n 增长；
+ * 方差在块内两遍计算 (块驻留 L1)，块间按 Welford/Chan 公式合并均值与二阶矩。
+ */
+
+#include "simd_kernels.h"
+#include "simd_internal.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <vector>
+
+namespace simd_internal {
+
+// 块内归约长度的默认值 (16KB)，缓存拓扑已知时由 reduce_block_len 按 L1d 推导
+static const int REDUCE_BLOCK_DEFAULT = 4096;
+
+// 每个线程至少处理的元素数
+static const size_t REDUCE_PARALLEL_GRAIN = 1 << 18;
+
+// argmax/argmin 内核一次处理的最大长度 (下标以 int 表示)
+static const size_t REDUCE_ARG_CHUNK = (size_t)1 << 24;
+
+// 按列归约: 每次累积的行数 (行块之间成对求和) 与每个任务负责列数的默认值
+static const int REDUCE_COL_BLOCK = 64;
+static const int REDUCE_COL_STRIP_DEFAULT = 1024;
+
+/**
+ * 块内归约长度: 方差两遍计算时块驻留 L1，取 L1d 的 1/3
+ */
+static int reduce_block_len() {
+    static const int len = cache_blocking(cache_topology().l1d / 3, sizeof(float), 256, 1024, 16384,
+                                          REDUCE_BLOCK_DEFAULT);
+    return len;
+}
+
+/**
+ * 按列归约的列条带宽度: 结果与成对求和的一层临时结果 (各 w 个 float) 合占 L1d 的一半
+ */
+static int reduce_col_strip() {
+    static const int width = cache_blocking(cache_topology().l1d / 2, 2 * sizeof(float), 64, 256,
+                                            4096, REDUCE_COL_STRIP_DEFAULT);
+    return width;
+}
+
+static float reduce_sum_generic(const float* x, int n) {
+    float acc[8] = {0.0f};
+    int i = 0;
+    for (; i + 8 <= n; i += 8) {
+        for (int j = 0; j < 8; ++j) {
+            acc[j] += x[i + j];
+        }
+    }
+    for (; i < n; ++i) {
+        acc[0] += x[i];
+    }
+    return ((acc[0] + acc[1]) + (acc[2] + acc[3])) + ((acc[4] + acc[5]) + (acc[6] + acc[7]));
+}
+
+static float reduce_sum_abs_generic(const float* x, int n) {
+    float acc[8] = {0.0f};
+    int i = 0;
+    for (; i + 8 <= n; i += 8) {
+        for (int j = 0; j < 8; ++j) {
+            acc[j] += std::fabs(x[i + j]);
+        }
+    }
+    for (; i < n; ++i) {
+        acc[0] += std::fabs(x[i]);
+    }
+    return ((acc[0] + acc[1]) + (acc[2] + acc[3])) + ((acc[4] + acc[5]) + (acc[6] + acc[7]));
+}
+
+static float reduce_sum_sq_generic(const float* x, int n, float center) {
+    float acc[8] = {0.0f};
+    int i = 0;
+    for (; i + 8 <= n; i += 8) {
+        for (int j = 0; j < 8; ++j) {
+            const float d = x[i + j] - center;
+            acc[j] += d * d;
+        }
+    }
+    for (; i < n; ++i) {
+        const float d = x[i] - center;
+        acc[0] += d * d;
+    }
+    return ((acc[0] + acc[1]) + (acc[2] + acc[3])) + ((acc[4] + acc[5]) + (acc[6] + acc[7]));
+}
+
+static float reduce_max_generic(const float* x, int n) {
+    float m = -std::numeric_limits<float>::infinity();
+    for (int i = 0; i < n; ++i) {
+        m = x[i] > m ? x[i] : m;
+    }
+    return m;
+}
+
+static float reduce_min_generic(const float* x, int n) {
+    float m = std::numeric_limits<float>::infinity();
+    for (int i = 0; i < n; ++i) {
+        m = x[i] < m ? x[i] : m;
+    }
+    return m;
+}
+
+static int reduce_argmax_generic(const float* x, int n) {
+    int best = 0;
+    for (int i = 1; i < n; ++i) {
+        if (x[i] > x[best]) {
+            best = i;
+        }
+    }
+    return best;
+}
+
+static int reduce_argmin_generic(const float* x, int n) {
+    int best = 0;
+    for (int i = 1; i < n; ++i) {
+        if (x[i] < x[best]) {
+            best = i;
+        }
+    }
+    return best;
+}
+
+static void reduce_accumulate_cols_generic(int op, const float* X, int rows, int cols, size_t ld,
+                                           const float* center, float* acc) {
+    for (int i = 0; i < rows; ++i) {
+        const float* row = X + (size_t)i * ld;
+        switch (op) {
+        case SIMD_REDUCE_SUM:
+            for (int j = 0; j < cols; ++j) acc[j] += row[j];
+            break;
+        case SIMD_REDUCE_L1:
+            for (int j = 0; j < cols; ++j) acc[j] += std::fabs(row[j]);
+            break;
+        case SIMD_REDUCE_L2:
+            for (int j = 0; j < cols; ++j) {
+                const float d = center ? row[j] - center[j] : row[j];
+                acc[j] += d * d;
+            }
+            break;
+        case SIMD_REDUCE_MAX:
+            for (int j = 0; j < cols; ++j) acc[j] = row[j] > acc[j] ? row[j] : acc[j];
+            break;
+        case SIMD_REDUCE_MIN:
+            for (int j = 0; j < cols; ++j) acc[j] = row[j] < acc[j] ? row[j] : acc[j];
+            break;
+        default:
+            break;
+        }
+    }
+}
+
+const ReduceKernels* reduce_kernels_generic() {
+    static const ReduceKernels kernels = {
+        "generic", reduce_sum_generic, reduce_sum_abs_generic, reduce_sum_sq_generic,
+        reduce_max_generic, reduce_min_generic, reduce_argmax_generic, reduce_argmin_generic,
+        reduce_accumulate_cols_generic
+    };
+    return &kernels;
+}
+
+namespace {
+
+bool is_extremum(int op) {
+    return op == SIMD_REDUCE_MAX || op == SIMD_REDUCE_MIN;
+}
+
+// 归约的单位元 (空区间的原始结果)
+float reduce_identity(int op) {
+    if (op == SIMD_REDUCE_MAX) {
+        return -std::numeric_limits<float>::infinity();
+    }
+    if (op == SIMD_REDUCE_MIN) {
+        return std::numeric_limits<float>::infinity();
+    }
+    return 0.0f;
+}
+
+float reduce_combine(int op, float a, float b) {
+    if (op == SIMD_REDUCE_MAX) {
+        return b > a ? b : a;
+    }
+    if (op == SIMD_REDUCE_MIN) {
+        return b < a ? b : a;
+    }
+    return a + b;
+}
+
+/**
+ * 原始归约结果: SUM/MEAN 为和，L1 为绝对值和，L2 为平方和，MAX/MIN 为极值
+ * op 在此之前已映射为 SUM/L1/L2/MAX/MIN 之一
+ */
+float reduce_block(const ReduceKernels* k, int op, const float* x, int n) {
+    switch (op) {
+    case SIMD_REDUCE_L1:
+        return k->sum_abs(x, n);
+    case SIMD_REDUCE_L2:
+        return k->sum_sq(x, n, 0.0f);
+    case SIMD_REDUCE_MAX:
+        return k->max(x, n);
+    case SIMD_REDUCE_MIN:
+        return k->min(x, n);
+    default:
+        return k->sum(x, n);
+    }
+}
+
+// 把区间对半切分 (切点对齐到 block 的整数倍)，两半的结果相加
+size_t pairwise_split(size_t n, size_t block) {
+    return (n / 2 + block - 1) / block * block;
+}
+
+float reduce_pairwise(const ReduceKernels* k, int op, const float* x, size_t n) {
+    const int block = reduce_block_len();
+    if (n <= (size_t)block) {
+        return n == 0 ? reduce_identity(op) : reduce_block(k, op, x, (int)n);
+    }
+    const size_t half = pairwise_split(n, block);
+    return reduce_combine(op, reduce_pairwise(k, op, x, half),
+                          reduce_pairwise(k, op, x + half, n - half));
+}
+
+/**
+ * 并行切分: 任务数受线程池大小与最小粒度限制，切点对齐到块长
+ */
+int reduce_tasks(size_t n, size_t* chunk) {
+    const size_t tasks = std::max<size_t>(1, std::min<size_t>((size_t)thread_pool_size(),
+                                                               n / REDUCE_PARALLEL_GRAIN));
+    const size_t per_task = (n + tasks - 1) / tasks;
+    const size_t block = (size_t)reduce_block_len();
+    *chunk = (per_task + block - 1) / block * block;
+    return (int)tasks;
+}
+
+float reduce_raw(const ReduceKernels* k, int op, const float* x, size_t n) {
+    size_t chunk = 0;
+    const int tasks = reduce_tasks(n, &chunk);
+    if (tasks == 1) {
+        return reduce_pairwise(k, op, x, n);
+    }
+    std::vector<float> partial(tasks, reduce_identity(op));
+    parallel_for(tasks, 0, [&](int task, int) {
+        const size_t begin = (size_t)task * chunk;
+        const size_t end = std::min(n, begin + chunk);
+        if (begin < end) {
+            partial[task] = reduce_pairwise(k, op, x + begin, end - begin);
+        }
+    });
+    float result = partial[0];
+    for (int t = 1; t < tasks; ++t) {
+        result = reduce_combine(op, result, partial[t]);
+    }
+    return result;
+}
+
+// 原始结果转换为最终结果 (VAR 由 mean_var 单独计算)
+float reduce_finalize(int op, float raw, size_t n) {
+    switch (op) {
+    case SIMD_REDUCE_MEAN:
+        return n > 0 ? (float)((double)raw / (double)n) : std::numeric_limits<float>::quiet_NaN();
+    case SIMD_REDUCE_L2:
+        return std::sqrt(raw);
+    default:
+        return raw;
+    }
+}
+
+int reduce_raw_op(int op) {
+    return op == SIMD_REDUCE_MEAN ? SIMD_REDUCE_SUM : op;
+}
+
+/**
+ * 均值与二阶矩 (count 个元素，m2 = sum (x - mean)^2)
+ */
+struct Moments {
+    double count;
+    double mean;
+    double m2;
+};
+
+// Chan 等人的并行合并公式 (Welford 在线更新的分块形式)
+void moments_merge(Moments& a, const Moments& b) {
+    if (b.count == 0.0) {
+        return;
+    }
+    const double count = a.count + b.count;
+    const double delta = b.mean - a.mean;
+    a.mean += delta * b.count / count;
+    a.m2 += b.m2 + delta * delta * a.count * b.count / count;
+    a.count = count;
+}
+
+Moments moments_range(const ReduceKernels* k, const float* x, size_t n) {
+    Moments m = {0.0, 0.0, 0.0};
+    const size_t block_len = (size_t)reduce_block_len();
+    for (size_t i = 0; i < n; i += block_len) {
+        const int len = (int)std::min(block_len, n - i);
+        const float mean = k->sum(x + i, len) / (float)len;
+        const Moments block = {(double)len, (double)mean, (double)k->sum_sq(x + i, len, mean)};
+        moments_merge(m, block);
+    }
+    return m;
+}
+
+Moments moments_parallel(const ReduceKernels* k, const float* x, size_t n) {
+    size_t chunk = 0;
+    const int tasks = reduce_tasks(n, &chunk);
+    if (tasks == 1) {
+        return moments_range(k, x, n);
+    }
+    std::vector<Moments> partial(tasks, Moments{0.0, 0.0, 0.0});
+    parallel_for(tasks, 0, [&](int task, int) {
+        const size_t begin = (size_t)task * chunk;
+        const size_t end = std::min(n, begin + chunk);
+        if (begin < end) {
+            partial[task] = moments_range(k, x + begin, end - begin);
+        }
+    });
+    Moments m = partial[0];
+    for (int t = 1; t < tasks; ++t) {
+        moments_merge(m, partial[t]);
+    }
+    return m;
+}
+
+void moments_finalize(const Moments& m, float* mean, float* var) {
+    const float nan = std::numeric_limits<float>::quiet_NaN();
+    if (mean) {
+        *mean = m.count > 0.0 ? (float)m.mean : nan;
+    }
+    if (var) {
+        *var = m.count > 0.0 ? (float)(m.m2 / m.count) : nan;
+    }
+}
+
+// argmax/argmin: 按 REDUCE_ARG_CHUNK 分段，段间严格比较以保留首个极值
+long long arg_range(const ReduceKernels* k, bool is_max, const float* x, size_t n) {
+    long long best = -1;
+    for (size_t i = 0; i < n; i += REDUCE_ARG_CHUNK) {
+        const int len = (int)std::min(REDUCE_ARG_CHUNK, n - i);
+        const long long idx = (long long)i + (is_max ? k->argmax(x + i, len) : k->argmin(x + i, len));
+        if (best < 0 || (is_max ? x[idx] > x[best] : x[idx] < x[best])) {
+            best = idx;
+        }
+    }
+    return best;
+}
+
+long long arg_parallel(const ReduceKernels* k, bool is_max, const float* x, size_t n) {
+    size_t chunk = 0;
+    const int tasks = reduce_tasks(n, &chunk);
+    if (tasks == 1) {
+        return arg_range(k, is_max, x, n);
+    }
+    std::vector<long long> partial(tasks, -1);
+    parallel_for(tasks, 0, [&](int task, int) {
+        const size_t begin = (size_t)task * chunk;
+        const size_t end = std::min(n, begin + chunk);
+        if (begin < end) {
+            partial[task] = (long long)begin + arg_range(k, is_max, x + begin, end - begin);
+        }
+    });
+    long long best = -1;
+    for (int t = 0; t < tasks; ++t) {
+        const long long idx = partial[t];
+        if (idx >= 0 && (best < 0 || (is_max ? x[idx] > x[best] : x[idx] < x[best]))) {
+            best = idx;
+        }
+    }
+    return best;
+}
+
+/**
+ * 按列成对求和: out[j] = sum_i f(X[i, j])，行区间对半切分直到 REDUCE_COL_BLOCK 行，
+ * tmp 为递归各层的临时结果 (每层 cols 个元素)
+ */
+void cols_pairwise(const ReduceKernels* k, int op, const float* X, int rows, int cols, size_t ld,
+                   const float* center, float* out, float* tmp) {
+    if (rows <= REDUCE_COL_BLOCK) {
+        std::fill(out, out + cols, 0.0f);
+        k->accumulate_cols(op, X, rows, cols, ld, center, out);
+        return;
+    }
+    const int half = (int)pairwise_split((size_t)rows, REDUCE_COL_BLOCK);
+    cols_pairwise(k, op, X, half, cols, ld, center, out, tmp + cols);
+    cols_pairwise(k, op, X + (size_t)half * ld, rows - half, cols, ld, center, tmp, tmp + cols);
+    for (int j = 0; j < cols; ++j) {
+        out[j] += tmp[j];
+    }
+}
+
+size_t cols_pairwise_scratch(int rows, int cols) {
+    int depth = 1;
+    for (int r = rows; r > REDUCE_COL_BLOCK; r = (r + 1) / 2) {
+        ++depth;
+    }
+    return (size_t)(depth + 1) * cols;
+}
+
+/**
+ * 每列归约 (axis = 0): 按列条带切分到线程池，每个任务沿行方向流式读取自己的列条带；
+ * 条带宽度不超过 reduce_col_strip，并行时再缩小到每个线程至少分得一条
+ */
+template <typename Fn>
+void for_each_col_strip(int rows, int cols, Fn fn) {
+    const size_t work = (size_t)rows * cols;
+    const int max_threads = work < REDUCE_PARALLEL_GRAIN ? 1 : 0;
+    int width = reduce_col_strip();
+    if (max_threads == 0) {
+        const int per_thread = (cols + thread_pool_size() - 1) / thread_pool_size();
+        width = std::min(width, std::max(64, (per_thread + 63) / 64 * 64));
+    }
+    const int strips = (cols + width - 1) / width;
+    parallel_for(strips, max_threads, [&](int s, int) {
+        const int j0 = s * width;
+        fn(j0, std::min(cols, j0 + width));
+    });
+}
+
+// op 为 SIMD_REDUCE_VAR 时 mean 非空则同时输出列均值
+void reduce_cols(const ReduceKernels* k, int op, const float* X, int rows, int cols, size_t ld,
+                 float* out, float* mean = nullptr) {
+    for_each_col_strip(rows, cols, [&](int j0, int j1) {
+        const int w = j1 - j0;
+        float* o = out + j0;
+        const int raw_op = reduce_raw_op(op);
+        if (is_extremum(raw_op)) {
+            std::fill(o, o + w, reduce_identity(raw_op));
+            k->accumulate_cols(raw_op, X + j0, rows, w, ld, nullptr, o);
+            return;
+        }
+        std::vector<float> tmp(cols_pairwise_scratch(rows, w));
+        if (op == SIMD_REDUCE_VAR) {
+            // 两遍: 先求列均值，再以均值为中心累积平方差
+            std::vector<float> local;
+            float* m = mean ? mean + j0 : (local.resize(w), local.data());
+            cols_pairwise(k, SIMD_REDUCE_SUM, X + j0, rows, w, ld, nullptr, m, tmp.data());
+            for (int j = 0; j < w; ++j) {
+                m[j] = rows > 0 ? m[j] / (float)rows : std::numeric_limits<float>::quiet_NaN();
+            }
+            cols_pairwise(k, SIMD_REDUCE_L2, X + j0, rows, w, ld, m, o, tmp.data());
+            for (int j = 0; j < w; ++j) {
+                o[j] = rows > 0 ? o[j] / (float)rows : std::numeric_limits<float>::quiet_NaN();
+            }
+            return;
+        }
+        cols_pairwise(k, raw_op, X + j0, rows, w, ld, nullptr, o, tmp.data());
+        for (int j = 0; j < w; ++j) {
+            o[j] = reduce_finalize(op, o[j], (size_t)rows);
+        }
+    });
+}
+
+// 每行归约 (axis = 1)
+template <typename Fn>
+void for_each_row(int rows, int cols, Fn fn) {
+    const size_t grain = std::max<size_t>(1, REDUCE_PARALLEL_GRAIN / std::max(cols, 1));
+    parallel_for_range((size_t)rows, grain, [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i) {
+            fn((int)i);
+        }
+    });
+}
+
+bool valid_reduce_op(int op) {
+    return op >= SIMD_REDUCE_SUM && op <= SIMD_REDUCE_VAR;
+}
+
+bool valid_matrix(const float* X, int rows, int cols, int ld, int axis) {
+    return rows >= 0 && cols >= 0 && ld >= cols && (axis == 0 || axis == 1) &&
+           (X || rows == 0 || cols == 0);
+}
+
+}  // namespace
+
+}  // namespace simd_internal
+
+/**
+ * 一维归约
+ */
+float simd_reduce(int op, const float* x, long long n) {
+    using namespace simd_internal;
+    if (!valid_reduce_op(op) || n < 0) {
+        return std::numeric_limits<float>::quiet_NaN();
+    }
+    if (op == SIMD_REDUCE_VAR) {
+        float var = 0.0f;
+        simd_mean_var(x, n, nullptr, &var);
+        return var;
+    }
+    const int raw_op = reduce_raw_op(op);
+    const float raw = n > 0 ? reduce_raw(dispatch_table().reduce, raw_op, x, (size_t)n)
+                            : reduce_identity(raw_op);
+    return reduce_finalize(op, raw, (size_t)n);
+}
+
+long long simd_argmax(const float* x, long long n) {
+    using namespace simd_internal;
+    return n > 0 ? arg_parallel(dispatch_table().reduce, true, x, (size_t)n) : -1;
+}
+
+long long simd_argmin(const float* x, long long n) {
+    using namespace simd_internal;
+    return n > 0 ? arg_parallel(dispatch_table().reduce, false, x, (size_t)n) : -1;
+}
+
+void simd_mean_var(const float* x, long long n, float* mean, float* var) {
+    using namespace simd_internal;
+    const Moments m = n > 0 ? moments_parallel(dispatch_table().reduce, x, (size_t)n)
+                            : Moments{0.0, 0.0, 0.0};
+    moments_finalize(m, mean, var);
+}
+
+/**
+ * 二维按轴归约
+ */
+int simd_reduce_axis(int op, const float* X, int rows, int cols, int ld, int axis, float* out) {
+    using namespace simd_internal;
+    if (!valid_reduce_op(op) || !valid_matrix(X, rows, cols, ld, axis) || !out) {
+        return -1;
+    }
+    const ReduceKernels* k = dispatch_table().reduce;
+    if (axis == 0) {
+        reduce_cols(k, op, X, rows, cols, (size_t)ld, out);
+        return 0;
+    }
+    for_each_row(rows, cols, [&](int i) {
+        const float* row = X + (size_t)i * ld;
+        if (op == SIMD_REDUCE_VAR) {
+            moments_finalize(moments_range(k, row, (size_t)cols), nullptr, out + i);
+            return;
+        }
+        const int raw_op = reduce_raw_op(op);
+        const float raw = cols > 0 ? reduce_pairwise(k, raw_op, row, (size_t)cols)
+                                   : reduce_identity(raw_op);
+        out[i] = reduce_finalize(op, raw, (size_t)cols);
+    });
+    return 0;
+}
+
+int simd_arg_reduce_axis(int op, const float* X, int rows, int cols, int ld, int axis, int* out) {
+    using namespace simd_internal;
+    if ((op != SIMD_REDUCE_MAX && op != SIMD_REDUCE_MIN) ||
+        !valid_matrix(X, rows, cols, ld, axis) || !out) {
+        return -1;
+    }
+    const ReduceKernels* k = dispatch_table().reduce;
+    const bool is_max = op == SIMD_REDUCE_MAX;
+    if (axis == 1) {
+        for_each_row(rows, cols, [&](int i) {
+            const float* row = X + (size_t)i * ld;
+            out[i] = cols > 0 ? (is_max ? k->argmax(row, cols) : k->argmin(row, cols)) : -1;
+        });
+        return 0;
+    }
+    // 每列: 逐行流式比较，保留首个极值所在的行
+    for_each_col_strip(rows, cols, [&](int j0, int j1) {
+        const int w = j1 - j0;
+        std::vector<float> best(w);
+        for (int j = 0; j < w; ++j) {
+            best[j] = rows > 0 ? X[j0 + j] : 0.0f;
+            out[j0 + j] = rows > 0 ? 0 : -1;
+        }
+        for (int i = 1; i < rows; ++i) {
+            const float* row = X + (size_t)i * ld + j0;
+            for (int j = 0; j < w; ++j) {
+                if (is_max ? row[j] > best[j] : row[j] < best[j]) {
+                    best[j] = row[j];
+                    out[j0 + j] = i;
+                }
+            }
+        }
+    });
+    return 0;
+}
+
+int simd_mean_var_axis(const float* X, int rows, int cols, int ld, int axis,
+                       float* mean, float* var) {
+    using namespace simd_internal;
+    if (!valid_matrix(X, rows, cols, ld, axis) || !mean || !var) {
+        return -1;
+    }
+    if (axis == 0) {
+        reduce_cols(dispatch_table().reduce, SIMD_REDUCE_VAR, X, rows, cols, (size_t)ld, var, mean);
+        return 0;
+    }
+    const ReduceKernels* k = dispatch_table().reduce;
+    for_each_row(rows, cols, [&](int i) {
+        moments_finalize(moments_range(k, X + (size_t)i * ld, (size_t)cols), mean + i, var + i);
+    });
+    return 0;
+}
@@ -0,0 +1,259 @@
+/**
+ * AVX2/FMA 归约内核 - VisionAI-ClipsMaster
+ * 4 个累加器 (每步 32 个元素) 隐藏加法延迟，尾部使用 maskload；
+ * argmax/argmin 按通道记录首个极值的下标，最后在通道间取下标最小者
+ */
+
+#include "simd_internal.h"
+
+#if defined(__AVX2__) && defined(__FMA__)
+#include <immintrin.h>
+#include <climits>
+#include <cmath>
+#include <cstdint>
+
+namespace simd_internal {
+
+namespace {
+
+// 从 REDUCE_TAIL_MASK + 8 - n 处读取 8 个 int 即得到低 n 个通道的掩码
+const int32_t REDUCE_TAIL_MASK[16] = {-1, -1, -1, -1, -1, -1, -1, -1, 0, 0, 0, 0, 0, 0, 0, 0};
+
+inline __m256i tail_mask8(int n) {
+    return _mm256_loadu_si256(reinterpret_cast<const __m256i*>(REDUCE_TAIL_MASK + 8 - n));
+}
+
+inline float hsum256(__m256 v) {
+    __m128 s = _mm_add_ps(_mm256_castps256_ps128(v), _mm256_extractf128_ps(v, 1));
+    s = _mm_add_ps(s, _mm_movehl_ps(s, s));
+    s = _mm_add_ss(s, _mm_movehdup_ps(s));
+    return _mm_cvtss_f32(s);
+}
+
+template <bool MAX>
+inline __m256 extremum256(__m256 a, __m256 b) {
+    return MAX ? _mm256_max_ps(a, b) : _mm256_min_ps(a, b);
+}
+
+template <bool MAX>
+inline float hextremum256(__m256 v) {
+    __m128 s = _mm256_castps256_ps128(v);
+    const __m128 hi = _mm256_extractf128_ps(v, 1);
+    s = MAX ? _mm_max_ps(s, hi) : _mm_min_ps(s, hi);
+    const __m128 h = _mm_movehl_ps(s, s);
+    s = MAX ? _mm_max_ps(s, h) : _mm_min_ps(s, h);
+    const __m128 d = _mm_movehdup_ps(s);
+    s = MAX ? _mm_max_ss(s, d) : _mm_min_ss(s, d);
+    return _mm_cvtss_f32(s);
+}
+
+/**
+ * 求和型归约: acc += f(x)，f 对掩码外的通道须返回 0
+ */
+template <typename F>
+inline float sum_avx2(const float* x, int n, F f) {
+    const __m256 all = _mm256_castsi256_ps(_mm256_set1_epi32(-1));
+    __m256 acc0 = _mm256_setzero_ps();
+    __m256 acc1 = _mm256_setzero_ps();
+    __m256 acc2 = _mm256_setzero_ps();
+    __m256 acc3 = _mm256_setzero_ps();
+    int i = 0;
+    for (; i + 32 <= n; i += 32) {
+        acc0 = f(acc0, _mm256_loadu_ps(x + i), all);
+        acc1 = f(acc1, _mm256_loadu_ps(x + i + 8), all);
+        acc2 = f(acc2, _mm256_loadu_ps(x + i + 16), all);
+        acc3 = f(acc3, _mm256_loadu_ps(x + i + 24), all);
+    }
+    for (; i + 8 <= n; i += 8) {
+        acc0 = f(acc0, _mm256_loadu_ps(x + i), all);
+    }
+    if (i < n) {
+        const __m256i m = tail_mask8(n - i);
+        acc1 = f(acc1, _mm256_maskload_ps(x + i, m), _mm256_castsi256_ps(m));
+    }
+    return hsum256(_mm256_add_ps(_mm256_add_ps(acc0, acc1), _mm256_add_ps(acc2, acc3)));
+}
+
+float reduce_sum_avx2(const float* x, int n) {
+    return sum_avx2(x, n, [](__m256 acc, __m256 v, __m256) { return _mm256_add_ps(acc, v); });
+}
+
+float reduce_sum_abs_avx2(const float* x, int n) {
+    const __m256 abs_mask = _mm256_castsi256_ps(_mm256_set1_epi32(0x7FFFFFFF));
+    return sum_avx2(x, n, [abs_mask](__m256 acc, __m256 v, __m256) {
+        return _mm256_add_ps(acc, _mm256_and_ps(v, abs_mask));
+    });
+}
+
+float reduce_sum_sq_avx2(const float* x, int n, float center) {
+    const __m256 c = _mm256_set1_ps(center);
+    return sum_avx2(x, n, [c](__m256 acc, __m256 v, __m256 m) {
+        const __m256 d = _mm256_and_ps(_mm256_sub_ps(v, c), m);
+        return _mm256_fmadd_ps(d, d, acc);
+    });
+}
+
+template <bool MAX>
+float extremum_avx2(const float* x, int n) {
+    const __m256 init = _mm256_set1_ps(MAX ? -INFINITY : INFINITY);
+    __m256 acc0 = init, acc1 = init, acc2 = init, acc3 = init;
+    int i = 0;
+    for (; i + 32 <= n; i += 32) {
+        acc0 = extremum256<MAX>(acc0, _mm256_loadu_ps(x + i));
+        acc1 = extremum256<MAX>(acc1, _mm256_loadu_ps(x + i + 8));
+        acc2 = extremum256<MAX>(acc2, _mm256_loadu_ps(x + i + 16));
+        acc3 = extremum256<MAX>(acc3, _mm256_loadu_ps(x + i + 24));
+    }
+    for (; i + 8 <= n; i += 8) {
+        acc0 = extremum256<MAX>(acc0, _mm256_loadu_ps(x + i));
+    }
+    if (i < n) {
+        const __m256i m = tail_mask8(n - i);
+        const __m256 v = _mm256_blendv_ps(init, _mm256_maskload_ps(x + i, m), _mm256_castsi256_ps(m));
+        acc1 = extremum256<MAX>(acc1, v);
+    }
+    return hextremum256<MAX>(extremum256<MAX>(extremum256<MAX>(acc0, acc1),
+                                              extremum256<MAX>(acc2, acc3)));
+}
+
+float reduce_max_avx2(const float* x, int n) {
+    return extremum_avx2<true>(x, n);
+}
+
+float reduce_min_avx2(const float* x, int n) {
+    return extremum_avx2<false>(x, n);
+}
+
+template <bool MAX>
+int arg_avx2(const float* x, int n) {
+    const int cmp = MAX ? _CMP_GT_OQ : _CMP_LT_OQ;
+    __m256 best = _mm256_set1_ps(MAX ? -INFINITY : INFINITY);
+    __m256i best_idx = _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7);
+    __m256i idx = best_idx;
+    const __m256i step = _mm256_set1_epi32(8);
+    int i = 0;
+    for (; i + 8 <= n; i += 8) {
+        const __m256 v = _mm256_loadu_ps(x + i);
+        const __m256 better = _mm256_cmp_ps(v, best, cmp);
+        best = _mm256_blendv_ps(best, v, better);
+        best_idx = _mm256_castps_si256(_mm256_blendv_ps(_mm256_castsi256_ps(best_idx),
+                                                        _mm256_castsi256_ps(idx), better));
+        idx = _mm256_add_epi32(idx, step);
+    }
+    if (i < n) {
+        const __m256i m = tail_mask8(n - i);
+        const __m256 v = _mm256_maskload_ps(x + i, m);
+        const __m256 better = _mm256_and_ps(_mm256_cmp_ps(v, best, cmp), _mm256_castsi256_ps(m));
+        best = _mm256_blendv_ps(best, v, better);
+        best_idx = _mm256_castps_si256(_mm256_blendv_ps(_mm256_castsi256_ps(best_idx),
+                                                        _mm256_castsi256_ps(idx), better));
+    }
+    // 各通道保留本通道首个极值，取极值相等的通道中下标最小者
+    alignas(32) float vals[8];
+    alignas(32) int32_t lanes[8];
+    _mm256_store_ps(vals, best);
+    _mm256_store_si256(reinterpret_cast<__m256i*>(lanes), best_idx);
+    const float extreme = hextremum256<MAX>(best);
+    int result = INT_MAX;
+    for (int l = 0; l < 8; ++l) {
+        if (vals[l] == extreme && lanes[l] < result) {
+            result = lanes[l];
+        }
+    }
+    return result < n ? result : 0;
+}
+
+int reduce_argmax_avx2(const float* x, int n) {
+    return arg_avx2<true>(x, n);
+}
+
+int reduce_argmin_avx2(const float* x, int n) {
+    return arg_avx2<false>(x, n);
+}
+
+template <int OP>
+inline __m256 accumulate256(__m256 acc, __m256 v, __m256 c) {
+    switch (OP) {
+    case SIMD_REDUCE_L1:
+        return _mm256_add_ps(acc, _mm256_and_ps(v, _mm256_castsi256_ps(_mm256_set1_epi32(0x7FFFFFFF))));
+    case SIMD_REDUCE_L2: {
+        const __m256 d = _mm256_sub_ps(v, c);
+        return _mm256_fmadd_ps(d, d, acc);
+    }
+    case SIMD_REDUCE_MAX:
+        return _mm256_max_ps(acc, v);
+    case SIMD_REDUCE_MIN:
+        return _mm256_min_ps(acc, v);
+    default:
+        return _mm256_add_ps(acc, v);
+    }
+}
+
+/**
+ * 按列累积: 逐行顺序读取整行，累加器留在 L1 (驱动层的列条带不超过数千列)
+ */
+template <int OP>
+void accumulate_cols_avx2(const float* X, int rows, int cols, size_t ld,
+                          const float* center, float* acc) {
+    const __m256 zero = _mm256_setzero_ps();
+    for (int i = 0; i < rows; ++i) {
+        const float* row = X + (size_t)i * ld;
+        int j = 0;
+        for (; j + 16 <= cols; j += 16) {
+            const __m256 c0 = center ? _mm256_loadu_ps(center + j) : zero;
+            const __m256 c1 = center ? _mm256_loadu_ps(center + j + 8) : zero;
+            _mm256_storeu_ps(acc + j, accumulate256<OP>(_mm256_loadu_ps(acc + j),
+                                                        _mm256_loadu_ps(row + j), c0));
+            _mm256_storeu_ps(acc + j + 8, accumulate256<OP>(_mm256_loadu_ps(acc + j + 8),
+                                                            _mm256_loadu_ps(row + j + 8), c1));
+        }
+        for (; j < cols; j += 8) {
+            const __m256i m = tail_mask8(cols - j < 8 ? cols - j : 8);
+            const __m256 c = center ? _mm256_maskload_ps(center + j, m) : zero;
+            _mm256_maskstore_ps(acc + j, m, accumulate256<OP>(_mm256_maskload_ps(acc + j, m),
+                                                              _mm256_maskload_ps(row + j, m), c));
+        }
+    }
+}
+
+void reduce_accumulate_cols_avx2(int op, const float* X, int rows, int cols, size_t ld,
+                                 const float* center, float* acc) {
+    switch (op) {
+    case SIMD_REDUCE_L1:
+        accumulate_cols_avx2<SIMD_REDUCE_L1>(X, rows, cols, ld, center, acc);
+        break;
+    case SIMD_REDUCE_L2:
+        accumulate_cols_avx2<SIMD_REDUCE_L2>(X, rows, cols, ld, center, acc);
+        break;
+    case SIMD_REDUCE_MAX:
+        accumulate_cols_avx2<SIMD_REDUCE_MAX>(X, rows, cols, ld, center, acc);
+        break;
+    case SIMD_REDUCE_MIN:
+        accumulate_cols_avx2<SIMD_REDUCE_MIN>(X, rows, cols, ld, center, acc);
+        break;
+    default:
+        accumulate_cols_avx2<SIMD_REDUCE_SUM>(X, rows, cols, ld, center, acc);
+        break;
+    }
+}
+
+}  // namespace
+
+const ReduceKernels* reduce_kernels_avx2() {
+    static const ReduceKernels kernels = {
+        "avx2", reduce_sum_avx2, reduce_sum_abs_avx2, reduce_sum_sq_avx2,
+        reduce_max_avx2, reduce_min_avx2, reduce_argmax_avx2, reduce_argmin_avx2,
+        reduce_accumulate_cols_avx2
+    };
+    return &kernels;
+}
+
+}  // namespace simd_internal
+
+#else  // 未启用 AVX2/FMA 编译
+
+namespace simd_internal {
+const ReduceKernels* reduce_kernels_avx2() { return nullptr; }
+}
+
+#endif
@@ -0,0 +1,229 @@
+/**
+ * AVX-512 归约内核 - VisionAI-ClipsMaster
+ * 4 个累加器 (每步 64 个元素) 隐藏加法延迟，尾部使用掩码加载；
+ * argmax/argmin 按通道记录首个极值的下标，最后在通道间取下标最小者
+ */
+
+#include "simd_internal.h"
+
+#if defined(__AVX512F__)
+#include <immintrin.h>
+#include <climits>
+#include <cmath>
+
+#if defined(__GNUC__) && !defined(__clang__)
+// GCC 12 对 _mm512_undefined_* 的 -W(maybe-)uninitialized 误报 (见 _mm512_reduce_*_ps)
+#pragma GCC diagnostic ignored "-Wmaybe-uninitialized"
+#pragma GCC diagnostic ignored "-Wuninitialized"
+#endif
+
+namespace simd_internal {
+
+namespace {
+
+inline __mmask16 tail_mask16(int n) {
+    return (__mmask16)((1u << n) - 1);
+}
+
+/**
+ * 求和型归约: acc += f(x)，f 对掩码外的通道须返回 0
+ */
+template <typename F>
+inline float sum_avx512(const float* x, int n, F f) {
+    __m512 acc0 = _mm512_setzero_ps();
+    __m512 acc1 = _mm512_setzero_ps();
+    __m512 acc2 = _mm512_setzero_ps();
+    __m512 acc3 = _mm512_setzero_ps();
+    int i = 0;
+    for (; i + 64 <= n; i += 64) {
+        acc0 = f(acc0, _mm512_loadu_ps(x + i), (__mmask16)0xFFFF);
+        acc1 = f(acc1, _mm512_loadu_ps(x + i + 16), (__mmask16)0xFFFF);
+        acc2 = f(acc2, _mm512_loadu_ps(x + i + 32), (__mmask16)0xFFFF);
+        acc3 = f(acc3, _mm512_loadu_ps(x + i + 48), (__mmask16)0xFFFF);
+    }
+    for (; i + 16 <= n; i += 16) {
+        acc0 = f(acc0, _mm512_loadu_ps(x + i), (__mmask16)0xFFFF);
+    }
+    if (i < n) {
+        const __mmask16 m = tail_mask16(n - i);
+        acc1 = f(acc1, _mm512_maskz_loadu_ps(m, x + i), m);
+    }
+    return _mm512_reduce_add_ps(_mm512_add_ps(_mm512_add_ps(acc0, acc1), _mm512_add_ps(acc2, acc3)));
+}
+
+float reduce_sum_avx512(const float* x, int n) {
+    return sum_avx512(x, n, [](__m512 acc, __m512 v, __mmask16) { return _mm512_add_ps(acc, v); });
+}
+
+float reduce_sum_abs_avx512(const float* x, int n) {
+    return sum_avx512(x, n, [](__m512 acc, __m512 v, __mmask16) {
+        return _mm512_add_ps(acc, _mm512_abs_ps(v));
+    });
+}
+
+float reduce_sum_sq_avx512(const float* x, int n, float center) {
+    const __m512 c = _mm512_set1_ps(center);
+    return sum_avx512(x, n, [c](__m512 acc, __m512 v, __mmask16 m) {
+        const __m512 d = _mm512_maskz_sub_ps(m, v, c);
+        return _mm512_fmadd_ps(d, d, acc);
+    });
+}
+
+template <bool MAX>
+inline __m512 extremum512(__m512 a, __m512 b) {
+    return MAX ? _mm512_max_ps(a, b) : _mm512_min_ps(a, b);
+}
+
+template <bool MAX>
+float extremum_avx512(const float* x, int n) {
+    const __m512 init = _mm512_set1_ps(MAX ? -INFINITY : INFINITY);
+    __m512 acc0 = init, acc1 = init, acc2 = init, acc3 = init;
+    int i = 0;
+    for (; i + 64 <= n; i += 64) {
+        acc0 = extremum512<MAX>(acc0, _mm512_loadu_ps(x + i));
+        acc1 = extremum512<MAX>(acc1, _mm512_loadu_ps(x + i + 16));
+        acc2 = extremum512<MAX>(acc2, _mm512_loadu_ps(x + i + 32));
+        acc3 = extremum512<MAX>(acc3, _mm512_loadu_ps(x + i + 48));
+    }
+    for (; i + 16 <= n; i += 16) {
+        acc0 = extremum512<MAX>(acc0, _mm512_loadu_ps(x + i));
+    }
+    if (i < n) {
+        acc1 = extremum512<MAX>(acc1, _mm512_mask_loadu_ps(init, tail_mask16(n - i), x + i));
+    }
+    const __m512 acc = extremum512<MAX>(extremum512<MAX>(acc0, acc1), extremum512<MAX>(acc2, acc3));
+    return MAX ? _mm512_reduce_max_ps(acc) : _mm512_reduce_min_ps(acc);
+}
+
+float reduce_max_avx512(const float* x, int n) {
+    return extremum_avx512<true>(x, n);
+}
+
+float reduce_min_avx512(const float* x, int n) {
+    return extremum_avx512<false>(x, n);
+}
+
+template <bool MAX>
+int arg_avx512(const float* x, int n) {
+    const int cmp = MAX ? _CMP_GT_OQ : _CMP_LT_OQ;
+    __m512 best = _mm512_set1_ps(MAX ? -INFINITY : INFINITY);
+    __m512i best_idx = _mm512_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15);
+    __m512i idx = best_idx;
+    const __m512i step = _mm512_set1_epi32(16);
+    int i = 0;
+    for (; i + 16 <= n; i += 16) {
+        const __m512 v = _mm512_loadu_ps(x + i);
+        const __mmask16 better = _mm512_cmp_ps_mask(v, best, cmp);
+        best = _mm512_mask_mov_ps(best, better, v);
+        best_idx = _mm512_mask_mov_epi32(best_idx, better, idx);
+        idx = _mm512_add_epi32(idx, step);
+    }
+    if (i < n) {
+        const __mmask16 m = tail_mask16(n - i);
+        const __m512 v = _mm512_maskz_loadu_ps(m, x + i);
+        const __mmask16 better = _mm512_mask_cmp_ps_mask(m, v, best, cmp);
+        best = _mm512_mask_mov_ps(best, better, v);
+        best_idx = _mm512_mask_mov_epi32(best_idx, better, idx);
+    }
+    // 各通道保留本通道首个极值，取极值相等的通道中下标最小者
+    const float extreme = MAX ? _mm512_reduce_max_ps(best) : _mm512_reduce_min_ps(best);
+    const __mmask16 hit = _mm512_cmp_ps_mask(best, _mm512_set1_ps(extreme), _CMP_EQ_OQ);
+    const int result = _mm512_reduce_min_epi32(
+        _mm512_mask_mov_epi32(_mm512_set1_epi32(INT_MAX), hit, best_idx));
+    return result < n ? result : 0;
+}
+
+int reduce_argmax_avx512(const float* x, int n) {
+    return arg_avx512<true>(x, n);
+}
+
+int reduce_argmin_avx512(const float* x, int n) {
+    return arg_avx512<false>(x, n);
+}
+
+template <int OP>
+inline __m512 accumulate512(__m512 acc, __m512 v, __m512 c) {
+    switch (OP) {
+    case SIMD_REDUCE_L1:
+        return _mm512_add_ps(acc, _mm512_abs_ps(v));
+    case SIMD_REDUCE_L2: {
+        const __m512 d = _mm512_sub_ps(v, c);
+        return _mm512_fmadd_ps(d, d, acc);
+    }
+    case SIMD_REDUCE_MAX:
+        return _mm512_max_ps(acc, v);
+    case SIMD_REDUCE_MIN:
+        return _mm512_min_ps(acc, v);
+    default:
+        return _mm512_add_ps(acc, v);
+    }
+}
+
+/**
+ * 按列累积: 逐行顺序读取整行，累加器留在 L1 (驱动层的列条带不超过数千列)
+ */
+template <int OP>
+void accumulate_cols_avx512(const float* X, int rows, int cols, size_t ld,
+                            const float* center, float* acc) {
+    const __m512 zero = _mm512_setzero_ps();
+    for (int i = 0; i < rows; ++i) {
+        const float* row = X + (size_t)i * ld;
+        int j = 0;
+        for (; j + 32 <= cols; j += 32) {
+            const __m512 c0 = center ? _mm512_loadu_ps(center + j) : zero;
+            const __m512 c1 = center ? _mm512_loadu_ps(center + j + 16) : zero;
+            _mm512_storeu_ps(acc + j, accumulate512<OP>(_mm512_loadu_ps(acc + j),
+                                                        _mm512_loadu_ps(row + j), c0));
+            _mm512_storeu_ps(acc + j + 16, accumulate512<OP>(_mm512_loadu_ps(acc + j + 16),
+                                                             _mm512_loadu_ps(row + j + 16), c1));
+        }
+        for (; j < cols; j += 16) {
+            const __mmask16 m = tail_mask16(cols - j < 16 ? cols - j : 16);
+            const __m512 c = center ? _mm512_maskz_loadu_ps(m, center + j) : zero;
+            _mm512_mask_storeu_ps(acc + j, m, accumulate512<OP>(_mm512_maskz_loadu_ps(m, acc + j),
+                                                                _mm512_maskz_loadu_ps(m, row + j), c));
+        }
+    }
+}
+
+void reduce_accumulate_cols_avx512(int op, const float* X, int rows, int cols, size_t ld,
+                                   const float* center, float* acc) {
+    switch (op) {
+    case SIMD_REDUCE_L1:
+        accumulate_cols_avx512<SIMD_REDUCE_L1>(X, rows, cols, ld, center, acc);
+        break;
+    case SIMD_REDUCE_L2:
+        accumulate_cols_avx512<SIMD_REDUCE_L2>(X, rows, cols, ld, center, acc);
+        break;
+    case SIMD_REDUCE_MAX:
+        accumulate_cols_avx512<SIMD_REDUCE_MAX>(X, rows, cols, ld, center, acc);
+        break;
+    case SIMD_REDUCE_MIN:
+        accumulate_cols_avx512<SIMD_REDUCE_MIN>(X, rows, cols, ld, center, acc);
+        break;
+    default:
+        accumulate_cols_avx512<SIMD_REDUCE_SUM>(X, rows, cols, ld, center, acc);
+        break;
+    }
+}
+
+}  // namespace
+
+const ReduceKernels* reduce_kernels_avx512() {
+    static const ReduceKernels kernels = {
+        "avx512", reduce_sum_avx512, reduce_sum_abs_avx512, reduce_sum_sq_avx512,
+        reduce_max_avx512, reduce_min_avx512, reduce_argmax_avx512, reduce_argmin_avx512,
+        reduce_accumulate_cols_avx512
+    };
+    return &kernels;
+}
+
+}  // namespace simd_internal
+
+#else  // 未启用 AVX-512 编译
+
+namespace simd_internal {
+const ReduceKernels* reduce_kernels_avx512() { return nullptr; }
+}
+
+#endif
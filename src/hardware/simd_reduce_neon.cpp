@@ -0,0 +1,232 @@
+/**
+ * ARM NEON 归约内核 - VisionAI-ClipsMaster
+ * 4 个累加器 (每步 16 个元素)，通道间归约使用 AArch64 的 vaddvq/vmaxvq/vminvq，
+ * 不足一个向量的尾部以标量处理
+ */
+
+#include "simd_internal.h"
+
+#if defined(__ARM_NEON) && defined(__aarch64__)
+#include <arm_neon.h>
+#include <cmath>
+
+namespace simd_internal {
+
+namespace {
+
+template <typename F, typename S>
+inline float sum_neon(const float* x, int n, F f, S scalar) {
+    float32x4_t acc0 = vdupq_n_f32(0.0f);
+    float32x4_t acc1 = vdupq_n_f32(0.0f);
+    float32x4_t acc2 = vdupq_n_f32(0.0f);
+    float32x4_t acc3 = vdupq_n_f32(0.0f);
+    int i = 0;
+    for (; i + 16 <= n; i += 16) {
+        acc0 = f(acc0, vld1q_f32(x + i));
+        acc1 = f(acc1, vld1q_f32(x + i + 4));
+        acc2 = f(acc2, vld1q_f32(x + i + 8));
+        acc3 = f(acc3, vld1q_f32(x + i + 12));
+    }
+    for (; i + 4 <= n; i += 4) {
+        acc0 = f(acc0, vld1q_f32(x + i));
+    }
+    float tail = 0.0f;
+    for (; i < n; ++i) {
+        tail += scalar(x[i]);
+    }
+    return vaddvq_f32(vaddq_f32(vaddq_f32(acc0, acc1), vaddq_f32(acc2, acc3))) + tail;
+}
+
+float reduce_sum_neon(const float* x, int n) {
+    return sum_neon(x, n, [](float32x4_t acc, float32x4_t v) { return vaddq_f32(acc, v); },
+                    [](float v) { return v; });
+}
+
+float reduce_sum_abs_neon(const float* x, int n) {
+    return sum_neon(x, n, [](float32x4_t acc, float32x4_t v) { return vaddq_f32(acc, vabsq_f32(v)); },
+                    [](float v) { return std::fabs(v); });
+}
+
+float reduce_sum_sq_neon(const float* x, int n, float center) {
+    const float32x4_t c = vdupq_n_f32(center);
+    return sum_neon(x, n,
+                    [c](float32x4_t acc, float32x4_t v) {
+                        const float32x4_t d = vsubq_f32(v, c);
+                        return vfmaq_f32(acc, d, d);
+                    },
+                    [center](float v) { return (v - center) * (v - center); });
+}
+
+template <bool MAX>
+inline float32x4_t extremum4(float32x4_t a, float32x4_t b) {
+    return MAX ? vmaxq_f32(a, b) : vminq_f32(a, b);
+}
+
+template <bool MAX>
+float extremum_neon(const float* x, int n) {
+    const float32x4_t init = vdupq_n_f32(MAX ? -INFINITY : INFINITY);
+    float32x4_t acc0 = init, acc1 = init, acc2 = init, acc3 = init;
+    int i = 0;
+    for (; i + 16 <= n; i += 16) {
+        acc0 = extremum4<MAX>(acc0, vld1q_f32(x + i));
+        acc1 = extremum4<MAX>(acc1, vld1q_f32(x + i + 4));
+        acc2 = extremum4<MAX>(acc2, vld1q_f32(x + i + 8));
+        acc3 = extremum4<MAX>(acc3, vld1q_f32(x + i + 12));
+    }
+    for (; i + 4 <= n; i += 4) {
+        acc0 = extremum4<MAX>(acc0, vld1q_f32(x + i));
+    }
+    const float32x4_t acc = extremum4<MAX>(extremum4<MAX>(acc0, acc1), extremum4<MAX>(acc2, acc3));
+    float m = MAX ? vmaxvq_f32(acc) : vminvq_f32(acc);
+    for (; i < n; ++i) {
+        m = (MAX ? x[i] > m : x[i] < m) ? x[i] : m;
+    }
+    return m;
+}
+
+float reduce_max_neon(const float* x, int n) {
+    return extremum_neon<true>(x, n);
+}
+
+float reduce_min_neon(const float* x, int n) {
+    return extremum_neon<false>(x, n);
+}
+
+template <bool MAX>
+int arg_neon(const float* x, int n) {
+    float32x4_t best = vdupq_n_f32(MAX ? -INFINITY : INFINITY);
+    const uint32_t lane_init[4] = {0, 1, 2, 3};
+    uint32x4_t best_idx = vld1q_u32(lane_init);
+    uint32x4_t idx = best_idx;
+    const uint32x4_t step = vdupq_n_u32(4);
+    int i = 0;
+    for (; i + 4 <= n; i += 4) {
+        const float32x4_t v = vld1q_f32(x + i);
+        const uint32x4_t better = MAX ? vcgtq_f32(v, best) : vcltq_f32(v, best);
+        best = vbslq_f32(better, v, best);
+        best_idx = vbslq_u32(better, idx, best_idx);
+        idx = vaddq_u32(idx, step);
+    }
+    // 各通道保留本通道首个极值，取极值相等的通道中下标最小者
+    const float extreme = MAX ? vmaxvq_f32(best) : vminvq_f32(best);
+    const uint32x4_t hit = vceqq_f32(best, vdupq_n_f32(extreme));
+    uint32_t result = vminvq_u32(vbslq_u32(hit, best_idx, vdupq_n_u32(0xFFFFFFFFu)));
+    float value = extreme;
+    if (result >= (uint32_t)n) {
+        result = 0;
+        value = x[0];
+    }
+    for (; i < n; ++i) {
+        if (MAX ? x[i] > value : x[i] < value) {
+            value = x[i];
+            result = (uint32_t)i;
+        }
+    }
+    return (int)result;
+}
+
+int reduce_argmax_neon(const float* x, int n) {
+    return arg_neon<true>(x, n);
+}
+
+int reduce_argmin_neon(const float* x, int n) {
+    return arg_neon<false>(x, n);
+}
+
+template <int OP>
+inline float32x4_t accumulate4(float32x4_t acc, float32x4_t v, float32x4_t c) {
+    switch (OP) {
+    case SIMD_REDUCE_L1:
+        return vaddq_f32(acc, vabsq_f32(v));
+    case SIMD_REDUCE_L2: {
+        const float32x4_t d = vsubq_f32(v, c);
+        return vfmaq_f32(acc, d, d);
+    }
+    case SIMD_REDUCE_MAX:
+        return vmaxq_f32(acc, v);
+    case SIMD_REDUCE_MIN:
+        return vminq_f32(acc, v);
+    default:
+        return vaddq_f32(acc, v);
+    }
+}
+
+template <int OP>
+inline float accumulate1(float acc, float v, float c) {
+    switch (OP) {
+    case SIMD_REDUCE_L1:
+        return acc + std::fabs(v);
+    case SIMD_REDUCE_L2:
+        return acc + (v - c) * (v - c);
+    case SIMD_REDUCE_MAX:
+        return v > acc ? v : acc;
+    case SIMD_REDUCE_MIN:
+        return v < acc ? v : acc;
+    default:
+        return acc + v;
+    }
+}
+
+/**
+ * 按列累积: 逐行顺序读取整行，累加器留在 L1 (驱动层的列条带不超过数千列)
+ */
+template <int OP>
+void accumulate_cols_neon(const float* X, int rows, int cols, size_t ld,
+                          const float* center, float* acc) {
+    const float32x4_t zero = vdupq_n_f32(0.0f);
+    for (int i = 0; i < rows; ++i) {
+        const float* row = X + (size_t)i * ld;
+        int j = 0;
+        for (; j + 8 <= cols; j += 8) {
+            const float32x4_t c0 = center ? vld1q_f32(center + j) : zero;
+            const float32x4_t c1 = center ? vld1q_f32(center + j + 4) : zero;
+            vst1q_f32(acc + j, accumulate4<OP>(vld1q_f32(acc + j), vld1q_f32(row + j), c0));
+            vst1q_f32(acc + j + 4, accumulate4<OP>(vld1q_f32(acc + j + 4), vld1q_f32(row + j + 4), c1));
+        }
+        for (; j < cols; ++j) {
+            acc[j] = accumulate1<OP>(acc[j], row[j], center ? center[j] : 0.0f);
+        }
+    }
+}
+
+void reduce_accumulate_cols_neon(int op, const float* X, int rows, int cols, size_t ld,
+                                 const float* center, float* acc) {
+    switch (op) {
+    case SIMD_REDUCE_L1:
+        accumulate_cols_neon<SIMD_REDUCE_L1>(X, rows, cols, ld, center, acc);
+        break;
+    case SIMD_REDUCE_L2:
+        accumulate_cols_neon<SIMD_REDUCE_L2>(X, rows, cols, ld, center, acc);
+        break;
+    case SIMD_REDUCE_MAX:
+        accumulate_cols_neon<SIMD_REDUCE_MAX>(X, rows, cols, ld, center, acc);
+        break;
+    case SIMD_REDUCE_MIN:
+        accumulate_cols_neon<SIMD_REDUCE_MIN>(X, rows, cols, ld, center, acc);
+        break;
+    default:
+        accumulate_cols_neon<SIMD_REDUCE_SUM>(X, rows, cols, ld, center, acc);
+        break;
+    }
+}
+
+}  // namespace
+
+const ReduceKernels* reduce_kernels_neon() {
+    static const ReduceKernels kernels = {
+        "neon", reduce_sum_neon, reduce_sum_abs_neon, reduce_sum_sq_neon,
+        reduce_max_neon, reduce_min_neon, reduce_argmax_neon, reduce_argmin_neon,
+        reduce_accumulate_cols_neon
+    };
+    return &kernels;
+}
+
+}  // namespace simd_internal
+
+#else  // 非 AArch64 NEON 编译
+
+namespace simd_internal {
+const ReduceKernels* reduce_kernels_neon() { return nullptr; }
+}
+
+#endif
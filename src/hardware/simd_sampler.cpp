@@ -0,0 +1,357 @@
+/**
+ * 原生 logits 处理与采样 - VisionAI-ClipsMaster
+ *
+ * 解码每个 token 时，重复惩罚、温度、top-k、top-p 与抽样若在 Python 中逐步执行，
+ * 15 万词表上每一步都会生成新的 NumPy 数组。这里按 HF 的处理顺序
+ * (惩罚 -> 温度 -> top-k -> top-p) 在一次调用内完成，且不修改输入 logits:
+ *   - 惩罚只作用于历史中出现过的 token，按计数表单独处理；
+ *   - top-k 按块求最大值 (归约内核) 与当前第 k 大比较，整块落后时跳过，
+ *     其余元素进入大小为 k 的最小堆；
+ *   - 不限 top-k 时以 exp_sum 内核求全词表的归一化因子 Z，概率低于
+ *     (1 - top_p) / vocab 的 token 总质量不超过 1 - top_p，必不在核内；
+ *     其余候选按浮点位模式分桶累计质量，只对跨越 top_p 的桶排序即得核的概率下限，
+ *     抽样时按块和 (归约内核) 定位随机数落入的块，再在块内逐个累加。
+ * 筛选与压缩均写成无分支形式，15 万词表上分支预测失败的代价高于计算本身。
+ * 随机数为 splitmix64，状态由调用方持有，相同种子得到相同的 token 序列。
+ */
+
+#include "simd_kernels.h"
+#include "simd_internal.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <vector>
+
+namespace simd_internal {
+
+// 按块筛选时的块长 (元素数)
+static const int SAMPLER_SCAN_BLOCK = 256;
+
+// 核采样分桶: 取 float 位模式的高位 (8 位指数 + 4 位尾数)，(0, 1] 内的概率落在前 2048 个桶
+static const int SAMPLER_BUCKET_SHIFT = 19;
+static const int SAMPLER_BUCKETS = 2048;
+
+namespace {
+
+struct Candidate {
+    float score;                // 筛选时为惩罚后的 logit，抽样时为未归一化概率
+    int id;
+};
+
+inline bool score_greater(const Candidate& a, const Candidate& b) {
+    return a.score > b.score || (a.score == b.score && a.id < b.id);
+}
+
+/**
+ * 线程私有缓冲区: counts 长度不小于词表且每次调用结束时恢复为 0
+ */
+struct SamplerScratch {
+    std::vector<int> counts;
+    std::vector<int> seen;      // 历史中的不同 token
+    std::vector<float> probs;   // 全词表的未归一化概率
+    std::vector<float> nucleus; // 核采样的候选概率
+    std::vector<double> buckets;
+    std::vector<Candidate> cand;
+};
+
+SamplerScratch& sampler_scratch() {
+    thread_local SamplerScratch s;
+    return s;
+}
+
+inline uint32_t float_bits(float v) {
+    uint32_t b;
+    memcpy(&b, &v, sizeof(b));
+    return b;
+}
+
+uint64_t next_random(unsigned long long* state) {
+    uint64_t z = (*state += 0x9E3779B97F4A7C15ull);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+    return z ^ (z >> 31);
+}
+
+// [0, 1) 均匀分布
+double next_uniform(unsigned long long* state) {
+    return (double)(next_random(state) >> 11) * (1.0 / 9007199254740992.0);
+}
+
+float penalize(float x, int count, const SimdSamplerParams& p) {
+    if (p.repetition_penalty != 1.0f) {
+        x = x < 0.0f ? x * p.repetition_penalty : x / p.repetition_penalty;
+    }
+    return x - p.presence_penalty - p.frequency_penalty * (float)count;
+}
+
+/**
+ * 惩罚后 logit 最大的 k 个 token (按分数降序)
+ */
+void select_top_k(const ReduceKernels* r, const float* x, int vocab, int k,
+                  const SimdSamplerParams& p, SamplerScratch& s) {
+    std::vector<Candidate>& heap = s.cand;
+    heap.clear();
+    // 最小堆: heap.front() 为当前第 k 大
+    const auto push = [&](float v, int id) {
+        if ((int)heap.size() < k) {
+            heap.push_back({v, id});
+            std::push_heap(heap.begin(), heap.end(), score_greater);
+        } else if (score_greater({v, id}, heap.front())) {
+            std::pop_heap(heap.begin(), heap.end(), score_greater);
+            heap.back() = {v, id};
+            std::push_heap(heap.begin(), heap.end(), score_greater);
+        }
+    };
+    // 堆未满时阈值为 -inf (-inf 与 NaN 均不入堆)
+    float thr = -INFINITY;
+    for (int b = 0; b < vocab; b += SAMPLER_SCAN_BLOCK) {
+        const int len = std::min(SAMPLER_SCAN_BLOCK, vocab - b);
+        if (!(r->max(x + b, len) > thr)) {
+            continue;
+        }
+        for (int i = b; i < b + len; ++i) {
+            if (x[i] > thr && s.counts[i] == 0) {
+                push(x[i], i);
+                if ((int)heap.size() == k) {
+                    thr = heap.front().score;
+                }
+            }
+        }
+    }
+    for (int id : s.seen) {
+        const float v = penalize(x[id], s.counts[id], p);
+        if (!std::isnan(v)) {
+            push(v, id);
+        }
+    }
+    std::sort(heap.begin(), heap.end(), score_greater);
+}
+
+/**
+ * 在按概率降序排列、总质量为 total 的候选中截取累计质量首次达到 top_p * total 的前缀，
+ * 再按概率抽样
+ */
+int draw_sorted(const std::vector<Candidate>& cand, double total, float top_p,
+                unsigned long long* rng_state) {
+    const double limit = top_p < 1.0f ? (double)top_p * total : total;
+    size_t n = 0;
+    double kept = 0.0;
+    while (n < cand.size() && (n == 0 || kept < limit)) {
+        kept += cand[n].score;
+        ++n;
+    }
+    const double u = next_uniform(rng_state) * kept;
+    double acc = 0.0;
+    for (size_t i = 0; i < n; ++i) {
+        acc += cand[i].score;
+        if (u < acc) {
+            return cand[i].id;
+        }
+    }
+    return cand[n - 1].id;
+}
+
+/**
+ * 按 token 顺序对 y 中不小于 floor 的概率抽样 (u ∈ [0, 总质量))：先以块和定位，再在块内累加
+ */
+int draw_scan(const ReduceKernels* r, const float* y, int vocab, float floor, double u) {
+    double acc = 0.0;
+    for (int b = 0; b < vocab; b += SAMPLER_SCAN_BLOCK) {
+        const int len = std::min(SAMPLER_SCAN_BLOCK, vocab - b);
+        if (floor <= 0.0f) {
+            const double block = r->sum(y + b, len);
+            if (u >= acc + block) {
+                acc += block;
+                continue;
+            }
+        } else if (r->max(y + b, len) < floor) {
+            continue;
+        }
+        for (int i = b; i < b + len; ++i) {
+            if (y[i] >= floor && y[i] > 0.0f) {
+                acc += y[i];
+                if (u < acc) {
+                    return i;
+                }
+            }
+        }
+    }
+    // 舍入使 u 超出累计和时取最后一个有效 token
+    for (int i = vocab - 1; i >= 0; --i) {
+        if (y[i] >= floor && y[i] > 0.0f) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+/**
+ * 降序累计质量首次达到 target 的元素值 (核的概率下限)，*kept 返回不小于该值的元素总质量。
+ * 先按位模式分桶累计质量定位跨越 target 的桶，再只对该桶内的元素排序
+ */
+float mass_threshold(std::vector<float>& v, size_t n, double target, std::vector<double>& buckets,
+                     double* kept) {
+    buckets.assign(SAMPLER_BUCKETS, 0.0);
+    for (size_t i = 0; i < n; ++i) {
+        const uint32_t key = std::min<uint32_t>(float_bits(v[i]) >> SAMPLER_BUCKET_SHIFT,
+                                                SAMPLER_BUCKETS - 1);
+        buckets[key] += v[i];
+    }
+    // 舍入使总质量略低于 target 时停在最低的非空桶
+    double above = 0.0;
+    int key = -1;
+    for (int b = SAMPLER_BUCKETS - 1; b >= 0; --b) {
+        if (buckets[b] == 0.0) {
+            continue;
+        }
+        key = b;
+        if (above + buckets[b] >= target) {
+            break;
+        }
+        above += buckets[b];
+    }
+    // 压缩出跨越桶中的元素并降序累加
+    size_t m = 0;
+    for (size_t i = 0; i < n; ++i) {
+        v[m] = v[i];
+        m += std::min<uint32_t>(float_bits(v[i]) >> SAMPLER_BUCKET_SHIFT, SAMPLER_BUCKETS - 1) ==
+             (uint32_t)key;
+    }
+    std::sort(v.begin(), v.begin() + m, std::greater<float>());
+    size_t i = 0;
+    while (i + 1 < m && above + v[i] < target) {
+        above += v[i++];
+    }
+    if (m == 0) {
+        *kept = above;
+        return 0.0f;
+    }
+    // 与下限相等的元素同样在核内
+    const float floor = v[i];
+    for (; i < m && v[i] == floor; ++i) {
+        above += v[i];
+    }
+    *kept = above;
+    return floor;
+}
+
+/**
+ * 不限 top-k: 全词表 softmax，按需截取核后抽样
+ */
+int sample_full(const SimdDispatchTable& table, const float* x, int vocab,
+                const SimdSamplerParams& p, unsigned long long* rng_state, SamplerScratch& s) {
+    const float inv_t = 1.0f / p.temperature;
+    float m = table.reduce->max(x, vocab);
+    for (int id : s.seen) {
+        m = std::max(m, penalize(x[id], s.counts[id], p));
+    }
+    if (!std::isfinite(m)) {
+        return -1;
+    }
+    std::vector<float>& y = s.probs;
+    y.resize(vocab);
+    double z = table.transformer->exp_sum(x, y.data(), vocab, inv_t, m * inv_t);
+    for (int id : s.seen) {
+        z -= y[id];
+        y[id] = std::exp(penalize(x[id], s.counts[id], p) * inv_t - m * inv_t);
+        z += y[id];
+    }
+
+    if (p.top_p >= 1.0f) {
+        return draw_scan(table.reduce, y.data(), vocab, 0.0f, next_uniform(rng_state) * z);
+    }
+
+    const float cutoff = (float)((1.0 - p.top_p) * z / vocab);
+    std::vector<float>& v = s.nucleus;
+    v.resize((size_t)vocab + 1);
+    size_t n = 0;
+    for (int b = 0; b < vocab; b += SAMPLER_SCAN_BLOCK) {
+        const int len = std::min(SAMPLER_SCAN_BLOCK, vocab - b);
+        if (table.reduce->max(y.data() + b, len) < cutoff) {
+            continue;
+        }
+        for (int i = b; i < b + len; ++i) {
+            v[n] = y[i];
+            n += y[i] >= cutoff;
+        }
+    }
+    // 核: 概率不小于下限的全部 token (与下限相等者一并保留)，其余置 0 后按块和抽样
+    double kept = 0.0;
+    const float floor = mass_threshold(v, n, (double)p.top_p * z, s.buckets, &kept);
+    for (int i = 0; i < vocab; ++i) {
+        y[i] = y[i] >= floor ? y[i] : 0.0f;
+    }
+    return draw_scan(table.reduce, y.data(), vocab, 0.0f, next_uniform(rng_state) * kept);
+}
+
+bool valid_sampler(const float* logits, int vocab, const int* history, int n_history,
+                   const SimdSamplerParams* p, const unsigned long long* rng_state) {
+    if (!logits || vocab <= 0 || n_history < 0 || (n_history > 0 && !history) || !p ||
+        std::isnan(p->temperature) || !(p->top_p > 0.0f && p->top_p <= 1.0f) ||
+        !(p->repetition_penalty > 0.0f) || !std::isfinite(p->presence_penalty) ||
+        !std::isfinite(p->frequency_penalty)) {
+        return false;
+    }
+    for (int i = 0; i < n_history; ++i) {
+        if (history[i] < 0 || history[i] >= vocab) {
+            return false;
+        }
+    }
+    return p->temperature <= 0.0f || rng_state;
+}
+
+}  // namespace
+
+}  // namespace simd_internal
+
+/**
+ * 返回采样得到的 token id；参数非法或惩罚后没有有限的 logit 时返回 -1
+ */
+int simd_sample(const float* logits, int vocab, const int* history, int n_history,
+                const SimdSamplerParams* params, unsigned long long* rng_state) {
+    using namespace simd_internal;
+    if (!valid_sampler(logits, vocab, history, n_history, params, rng_state)) {
+        return -1;
+    }
+    const SimdSamplerParams& p = *params;
+    const SimdDispatchTable& table = dispatch_table();
+    SamplerScratch& s = sampler_scratch();
+    if ((int)s.counts.size() < vocab) {
+        s.counts.resize(vocab, 0);
+    }
+    s.seen.clear();
+    for (int i = 0; i < n_history; ++i) {
+        if (s.counts[history[i]]++ == 0) {
+            s.seen.push_back(history[i]);
+        }
+    }
+
+    int token;
+    if (p.temperature <= 0.0f) {
+        select_top_k(table.reduce, logits, vocab, 1, p, s);
+        token = s.cand.empty() || !std::isfinite(s.cand[0].score) ? -1 : s.cand[0].id;
+    } else if (p.top_k > 0 && p.top_k < vocab) {
+        select_top_k(table.reduce, logits, vocab, p.top_k, p, s);
+        token = -1;
+        if (!s.cand.empty() && std::isfinite(s.cand[0].score)) {
+            const float inv_t = 1.0f / p.temperature;
+            const float m = s.cand[0].score;
+            double total = 0.0;
+            for (Candidate& c : s.cand) {
+                c.score = std::exp((c.score - m) * inv_t);
+                total += c.score;
+            }
+            token = draw_sorted(s.cand, total, p.top_p, rng_state);
+        }
+    } else {
+        token = sample_full(table, logits, vocab, p, rng_state, s);
+    }
+
+    for (int id : s.seen) {
+        s.counts[id] = 0;
+    }
+    return token;
+}
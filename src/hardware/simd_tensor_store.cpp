@@ -0,0 +1,816 @@
+/**
+ * 零拷贝张量存储 - VisionAI-ClipsMaster
+ *
+ * 读取 safetensors 文件 (单个文件、*.safetensors.index.json 分片索引或包含分片的目录)，
+ * 各分片只读 mmap，张量以映射地址直接交给 GEMM/GEMV/量化内核，不做任何复制。
+ * 打开时只解析文件头，页面在内核首次读取时才从磁盘载入，进程 RSS 只包含实际用到的页；
+ * 按名称前缀 (如 "model.layers.12.") 对下一层执行 madvise(WILLNEED) 预读，
+ * 用完的层可以 MADV_DONTNEED 从 RSS 中释放 (页缓存仍保留，再次访问无需重读磁盘)。
+ *
+ * safetensors 格式: 8 字节小端头长度 n，n 字节 JSON 头，其后为数据区；
+ * JSON 中每个张量给出 dtype、shape 与相对数据区起点的 data_offsets [begin, end)。
+ * Windows 上退回整文件读入内存。
+ */
+
+#include "simd_kernels.h"
+#include "simd_internal.h"
+
+#include <algorithm>
+#include <cctype>
+#include <cerrno>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#if defined(_WIN32)
+    #include <windows.h>
+#else
+    #include <dirent.h>
+    #include <fcntl.h>
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+    #include <unistd.h>
+#endif
+
+namespace simd_internal {
+
+namespace {
+
+// 打开或 madvise 失败的原因 (每个线程一份，供 simd_tensor_store_error 读取)
+thread_local std::string tls_store_error;
+
+bool store_fail(const std::string& msg) {
+    tls_store_error = msg;
+    return false;
+}
+
+/**
+ * 最小 JSON 解析器: 只覆盖 safetensors 头与分片索引用到的语法
+ */
+struct JsonValue {
+    enum Type { NUL, BOOL, NUMBER, STRING, ARRAY, OBJECT } type = NUL;
+    double number = 0.0;
+    std::string str;
+    std::vector<JsonValue> items;
+    std::vector<std::pair<std::string, JsonValue>> members;
+
+    const JsonValue* get(const char* key) const {
+        for (const auto& m : members) {
+            if (m.first == key) {
+                return &m.second;
+            }
+        }
+        return nullptr;
+    }
+};
+
+class JsonParser {
+public:
+    JsonParser(const char* p, const char* end) : p_(p), end_(end) {}
+
+    bool parse(JsonValue* out) {
+        if (!value(out, 0)) {
+            return false;
+        }
+        skip_ws();
+        return p_ == end_;
+    }
+
+private:
+    static const int MAX_DEPTH = 32;
+
+    void skip_ws() {
+        while (p_ < end_ && (*p_ == ' ' || *p_ == '\t' || *p_ == '\n' || *p_ == '\r')) {
+            ++p_;
+        }
+    }
+
+    bool literal(const char* word) {
+        const size_t n = strlen(word);
+        if ((size_t)(end_ - p_) < n || memcmp(p_, word, n) != 0) {
+            return false;
+        }
+        p_ += n;
+        return true;
+    }
+
+    static void append_utf8(std::string* s, uint32_t cp) {
+        if (cp < 0x80) {
+            s->push_back((char)cp);
+        } else if (cp < 0x800) {
+            s->push_back((char)(0xC0 | (cp >> 6)));
+            s->push_back((char)(0x80 | (cp & 0x3F)));
+        } else if (cp < 0x10000) {
+            s->push_back((char)(0xE0 | (cp >> 12)));
+            s->push_back((char)(0x80 | ((cp >> 6) & 0x3F)));
+            s->push_back((char)(0x80 | (cp & 0x3F)));
+        } else {
+            s->push_back((char)(0xF0 | (cp >> 18)));
+            s->push_back((char)(0x80 | ((cp >> 12) & 0x3F)));
+            s->push_back((char)(0x80 | ((cp >> 6) & 0x3F)));
+            s->push_back((char)(0x80 | (cp & 0x3F)));
+        }
+    }
+
+    bool hex4(uint32_t* out) {
+        if (end_ - p_ < 4) {
+            return false;
+        }
+        uint32_t v = 0;
+        for (int i = 0; i < 4; ++i) {
+            const char c = *p_++;
+            v <<= 4;
+            if (c >= '0' && c <= '9') v |= (uint32_t)(c - '0');
+            else if (c >= 'a' && c <= 'f') v |= (uint32_t)(c - 'a' + 10);
+            else if (c >= 'A' && c <= 'F') v |= (uint32_t)(c - 'A' + 10);
+            else return false;
+        }
+        *out = v;
+        return true;
+    }
+
+    bool string(std::string* out) {
+        if (p_ >= end_ || *p_ != '"') {
+            return false;
+        }
+        ++p_;
+        while (p_ < end_ && *p_ != '"') {
+            const char c = *p_++;
+            if (c != '\\') {
+                out->push_back(c);
+                continue;
+            }
+            if (p_ >= end_) {
+                return false;
+            }
+            const char e = *p_++;
+            switch (e) {
+                case '"': case '\\': case '/': out->push_back(e); break;
+                case 'b': out->push_back('\b'); break;
+                case 'f': out->push_back('\f'); break;
+                case 'n': out->push_back('\n'); break;
+                case 'r': out->push_back('\r'); break;
+                case 't': out->push_back('\t'); break;
+                case 'u': {
+                    uint32_t cp = 0;
+                    if (!hex4(&cp)) {
+                        return false;
+                    }
+                    // 代理对
+                    if (cp >= 0xD800 && cp < 0xDC00 && end_ - p_ >= 6 && p_[0] == '\\' && p_[1] == 'u') {
+                        p_ += 2;
+                        uint32_t lo = 0;
+                        if (!hex4(&lo) || lo < 0xDC00 || lo >= 0xE000) {
+                            return false;
+                        }
+                        cp = 0x10000 + ((cp - 0xD800) << 10) + (lo - 0xDC00);
+                    }
+                    append_utf8(out, cp);
+                    break;
+                }
+                default:
+                    return false;
+            }
+        }
+        if (p_ >= end_) {
+            return false;
+        }
+        ++p_;
+        return true;
+    }
+
+    bool value(JsonValue* out, int depth) {
+        if (depth > MAX_DEPTH) {
+            return false;
+        }
+        skip_ws();
+        if (p_ >= end_) {
+            return false;
+        }
+        const char c = *p_;
+        if (c == '{') {
+            ++p_;
+            out->type = JsonValue::OBJECT;
+            skip_ws();
+            if (p_ < end_ && *p_ == '}') {
+                ++p_;
+                return true;
+            }
+            for (;;) {
+                skip_ws();
+                std::pair<std::string, JsonValue> member;
+                if (!string(&member.first)) {
+                    return false;
+                }
+                skip_ws();
+                if (p_ >= end_ || *p_++ != ':') {
+                    return false;
+                }
+                if (!value(&member.second, depth + 1)) {
+                    return false;
+                }
+                out->members.push_back(std::move(member));
+                skip_ws();
+                if (p_ < end_ && *p_ == ',') {
+                    ++p_;
+                    continue;
+                }
+                if (p_ < end_ && *p_ == '}') {
+                    ++p_;
+                    return true;
+                }
+                return false;
+            }
+        }
+        if (c == '[') {
+            ++p_;
+            out->type = JsonValue::ARRAY;
+            skip_ws();
+            if (p_ < end_ && *p_ == ']') {
+                ++p_;
+                return true;
+            }
+            for (;;) {
+                out->items.emplace_back();
+                if (!value(&out->items.back(), depth + 1)) {
+                    return false;
+                }
+                skip_ws();
+                if (p_ < end_ && *p_ == ',') {
+                    ++p_;
+                    continue;
+                }
+                if (p_ < end_ && *p_ == ']') {
+                    ++p_;
+                    return true;
+                }
+                return false;
+            }
+        }
+        if (c == '"') {
+            out->type = JsonValue::STRING;
+            return string(&out->str);
+        }
+        if (literal("true") || literal("false")) {
+            out->type = JsonValue::BOOL;
+            out->number = p_[-2] == 'u' ? 1.0 : 0.0;     // "true" 以 "ue" 结尾
+            return true;
+        }
+        if (literal("null")) {
+            out->type = JsonValue::NUL;
+            return true;
+        }
+        // 数字: 拷贝到以 0 结尾的缓冲区再解析
+        const char* start = p_;
+        while (p_ < end_ && (isdigit((unsigned char)*p_) || *p_ == '-' || *p_ == '+' ||
+                             *p_ == '.' || *p_ == 'e' || *p_ == 'E')) {
+            ++p_;
+        }
+        if (p_ == start || p_ - start > 63) {
+            return false;
+        }
+        char buf[64];
+        memcpy(buf, start, (size_t)(p_ - start));
+        buf[p_ - start] = '\0';
+        char* num_end = nullptr;
+        out->type = JsonValue::NUMBER;
+        out->number = strtod(buf, &num_end);
+        return *num_end == '\0';
+    }
+
+    const char* p_;
+    const char* end_;
+};
+
+// safetensors dtype 的元素字节数，未知类型返回 0 (不校验大小)
+size_t dtype_size(const std::string& dtype) {
+    static const struct { const char* name; size_t size; } table[] = {
+        {"F64", 8}, {"I64", 8}, {"U64", 8},
+        {"F32", 4}, {"I32", 4}, {"U32", 4},
+        {"F16", 2}, {"BF16", 2}, {"I16", 2}, {"U16", 2},
+        {"I8", 1}, {"U8", 1}, {"BOOL", 1}, {"F8_E4M3", 1}, {"F8_E5M2", 1},
+    };
+    for (const auto& e : table) {
+        if (dtype == e.name) {
+            return e.size;
+        }
+    }
+    return 0;
+}
+
+/**
+ * JSON 数值转为非负整数: 须为整数且不超过 2^53 (double 能精确表示的范围)
+ */
+bool json_uint(const JsonValue& v, uint64_t* out) {
+    if (v.type != JsonValue::NUMBER || !(v.number >= 0.0) || v.number > 9007199254740992.0 ||
+        std::floor(v.number) != v.number) {
+        return false;
+    }
+    *out = (uint64_t)v.number;
+    return true;
+}
+
+// *out = a * b，溢出时返回 false
+inline bool checked_mul(uint64_t a, uint64_t b, uint64_t* out) {
+#if defined(__GNUC__) || defined(__clang__)
+    return !__builtin_mul_overflow(a, b, out);
+#else
+    if (b != 0 && a > UINT64_MAX / b) {
+        return false;
+    }
+    *out = a * b;
+    return true;
+#endif
+}
+
+bool read_file(const std::string& path, std::string* out) {
+    FILE* f = fopen(path.c_str(), "rb");
+    if (!f) {
+        return false;
+    }
+    char buf[1 << 16];
+    size_t n;
+    while ((n = fread(buf, 1, sizeof(buf), f)) > 0) {
+        out->append(buf, n);
+    }
+    fclose(f);
+    return true;
+}
+
+std::string dir_of(const std::string& path) {
+    const size_t slash = path.find_last_of("/\\");
+    return slash == std::string::npos ? std::string(".") : path.substr(0, slash);
+}
+
+bool ends_with(const std::string& s, const char* suffix) {
+    const size_t n = strlen(suffix);
+    return s.size() >= n && s.compare(s.size() - n, n, suffix) == 0;
+}
+
+}  // namespace
+
+}  // namespace simd_internal
+
+struct SimdTensorStore {
+    struct Shard {
+        std::string path;
+        const unsigned char* map = nullptr;     // 整个文件的只读映射
+        size_t size = 0;
+        size_t data_offset = 0;                 // 数据区在文件中的起点
+    };
+    struct Tensor {
+        std::string name;
+        std::string dtype;
+        std::vector<long long> shape;
+        int shard;
+        size_t begin;                           // 相对文件起点
+        size_t end;
+    };
+    std::vector<Shard> shards;
+    std::vector<Tensor> tensors;                // 按分片与文件偏移排序
+    std::unordered_map<std::string, int> index;
+};
+
+namespace simd_internal {
+
+namespace {
+
+void unmap_shard(SimdTensorStore::Shard* shard) {
+    if (!shard->map) {
+        return;
+    }
+#if defined(_WIN32)
+    aligned_free(const_cast<unsigned char*>(shard->map));
+#else
+    munmap(const_cast<unsigned char*>(shard->map), shard->size);
+#endif
+    shard->map = nullptr;
+}
+
+bool map_shard(const std::string& path, SimdTensorStore::Shard* shard) {
+    shard->path = path;
+#if defined(_WIN32)
+    std::string data;
+    if (!read_file(path, &data)) {
+        return store_fail("无法打开分片: " + path);
+    }
+    if (data.size() < 8) {
+        return store_fail("分片过小: " + path);
+    }
+    shard->size = data.size();
+    unsigned char* buf = static_cast<unsigned char*>(aligned_malloc(std::max<size_t>(data.size(), 1)));
+    if (!buf) {
+        return store_fail("内存不足: " + path);
+    }
+    memcpy(buf, data.data(), data.size());
+    shard->map = buf;
+#else
+    const int fd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        return store_fail("无法打开分片: " + path);
+    }
+    struct stat st;
+    if (fstat(fd, &st) != 0 || st.st_size < 8) {
+        close(fd);
+        return store_fail("分片过小或无法读取: " + path);
+    }
+    shard->size = (size_t)st.st_size;
+    void* map = mmap(nullptr, shard->size, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);      // 映射建立后不再需要文件描述符
+    if (map == MAP_FAILED) {
+        return store_fail("mmap 失败: " + path);
+    }
+    shard->map = static_cast<const unsigned char*>(map);
+#endif
+    return true;
+}
+
+/**
+ * 解析分片头并登记其中的张量
+ */
+bool load_shard(SimdTensorStore* store, const std::string& path) {
+    SimdTensorStore::Shard shard;
+    if (!map_shard(path, &shard)) {
+        return false;
+    }
+    uint64_t header_len = 0;
+    for (int i = 7; i >= 0; --i) {
+        header_len = (header_len << 8) | shard.map[i];
+    }
+    if (header_len > shard.size - 8) {
+        unmap_shard(&shard);
+        return store_fail("头长度超出文件大小: " + path);
+    }
+    JsonValue header;
+    const char* text = reinterpret_cast<const char*>(shard.map + 8);
+    if (!JsonParser(text, text + header_len).parse(&header) || header.type != JsonValue::OBJECT) {
+        unmap_shard(&shard);
+        return store_fail("文件头不是合法的 JSON 对象: " + path);
+    }
+    shard.data_offset = 8 + (size_t)header_len;
+    const size_t data_size = shard.size - shard.data_offset;
+    const int shard_id = (int)store->shards.size();
+
+    for (const auto& m : header.members) {
+        if (m.first == "__metadata__") {
+            continue;
+        }
+        const JsonValue* dtype = m.second.get("dtype");
+        const JsonValue* shape = m.second.get("shape");
+        const JsonValue* offsets = m.second.get("data_offsets");
+        if (!dtype || dtype->type != JsonValue::STRING || !shape || shape->type != JsonValue::ARRAY ||
+            shape->items.size() > SIMD_TENSOR_MAX_DIMS || !offsets ||
+            offsets->type != JsonValue::ARRAY || offsets->items.size() != 2) {
+            unmap_shard(&shard);
+            return store_fail("张量描述不完整: " + m.first);
+        }
+        SimdTensorStore::Tensor t;
+        t.name = m.first;
+        t.dtype = dtype->str;
+        t.shard = shard_id;
+        uint64_t elems = 1;
+        for (const JsonValue& d : shape->items) {
+            uint64_t dim = 0;
+            if (!json_uint(d, &dim) || !checked_mul(elems, dim, &elems)) {
+                unmap_shard(&shard);
+                return store_fail("形状非法: " + m.first);
+            }
+            t.shape.push_back((long long)dim);
+        }
+        uint64_t b = 0;
+        uint64_t e = 0;
+        if (!json_uint(offsets->items[0], &b) || !json_uint(offsets->items[1], &e) || e < b ||
+            e > (uint64_t)data_size) {
+            unmap_shard(&shard);
+            return store_fail("数据偏移越界: " + m.first);
+        }
+        t.begin = shard.data_offset + (size_t)b;
+        t.end = shard.data_offset + (size_t)e;
+        // 未知 dtype 无法核对大小，只保证偏移在数据区内
+        const size_t elem_size = dtype_size(t.dtype);
+        uint64_t bytes = 0;
+        if (elem_size > 0 && (!checked_mul(elems, elem_size, &bytes) || bytes != e - b)) {
+            unmap_shard(&shard);
+            return store_fail("数据大小与形状不符: " + m.first);
+        }
+        if (store->index.count(t.name)) {
+            unmap_shard(&shard);
+            return store_fail("张量名重复: " + m.first);
+        }
+        store->index[t.name] = -1;
+        store->tensors.push_back(std::move(t));
+    }
+    store->shards.push_back(shard);
+    return true;
+}
+
+/**
+ * 分片索引 (*.safetensors.index.json) 的 weight_map 给出张量到分片文件的映射，按首次出现顺序载入分片
+ */
+bool load_index(SimdTensorStore* store, const std::string& path) {
+    std::string text;
+    if (!read_file(path, &text)) {
+        return store_fail("无法读取索引: " + path);
+    }
+    JsonValue root;
+    if (!JsonParser(text.data(), text.data() + text.size()).parse(&root)) {
+        return store_fail("索引不是合法的 JSON: " + path);
+    }
+    const JsonValue* weight_map = root.get("weight_map");
+    if (!weight_map || weight_map->type != JsonValue::OBJECT) {
+        return store_fail("索引缺少 weight_map: " + path);
+    }
+    std::vector<std::string> files;
+    for (const auto& m : weight_map->members) {
+        if (m.second.type == JsonValue::STRING &&
+            std::find(files.begin(), files.end(), m.second.str) == files.end()) {
+            files.push_back(m.second.str);
+        }
+    }
+    const std::string dir = dir_of(path);
+    for (const std::string& f : files) {
+        if (!load_shard(store, dir + "/" + f)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * 目录: 优先使用其中的 model.safetensors.index.json，否则载入全部 *.safetensors (按文件名排序)
+ */
+bool load_directory(SimdTensorStore* store, const std::string& dir) {
+    const std::string index = dir + "/model.safetensors.index.json";
+    if (FILE* f = fopen(index.c_str(), "rb")) {
+        fclose(f);
+        return load_index(store, index);
+    }
+    std::vector<std::string> files;
+#if defined(_WIN32)
+    WIN32_FIND_DATAA entry;
+    HANDLE h = FindFirstFileA((dir + "\\*.safetensors").c_str(), &entry);
+    if (h != INVALID_HANDLE_VALUE) {
+        do {
+            files.push_back(entry.cFileName);
+        } while (FindNextFileA(h, &entry));
+        FindClose(h);
+    }
+#else
+    DIR* d = opendir(dir.c_str());
+    if (!d) {
+        return store_fail("无法打开目录: " + dir);
+    }
+    while (struct dirent* e = readdir(d)) {
+        const std::string name = e->d_name;
+        if (ends_with(name, ".safetensors")) {
+            files.push_back(name);
+        }
+    }
+    closedir(d);
+#endif
+    if (files.empty()) {
+        return store_fail("目录中没有 safetensors 文件: " + dir);
+    }
+    std::sort(files.begin(), files.end());
+    for (const std::string& f : files) {
+        if (!load_shard(store, dir + "/" + f)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool is_directory(const std::string& path) {
+#if defined(_WIN32)
+    const DWORD attr = GetFileAttributesA(path.c_str());
+    return attr != INVALID_FILE_ATTRIBUTES && (attr & FILE_ATTRIBUTE_DIRECTORY);
+#else
+    struct stat st;
+    return stat(path.c_str(), &st) == 0 && S_ISDIR(st.st_mode);
+#endif
+}
+
+template <typename Fn>
+int for_prefix(const SimdTensorStore* store, const char* prefix, Fn fn) {
+    const size_t n = prefix ? strlen(prefix) : 0;
+    int count = 0;
+    for (const SimdTensorStore::Tensor& t : store->tensors) {
+        if (t.name.compare(0, n, prefix ? prefix : "", n) == 0) {
+            fn(t);
+            ++count;
+        }
+    }
+    return count;
+}
+
+}  // namespace
+
+}  // namespace simd_internal
+
+
+const char* simd_tensor_store_error(void) {
+    return simd_internal::tls_store_error.c_str();
+}
+
+/**
+ * 打开张量存储，path 为单个 .safetensors 文件、分片索引 .json 或目录；失败返回 NULL
+ */
+SimdTensorStore* simd_tensor_store_open(const char* path) {
+    using namespace simd_internal;
+    tls_store_error.clear();
+    if (!path || !*path) {
+        store_fail("路径为空");
+        return nullptr;
+    }
+    SimdTensorStore* store = new SimdTensorStore();
+    const std::string p = path;
+    bool ok;
+    if (is_directory(p)) {
+        ok = load_directory(store, p);
+    } else if (ends_with(p, ".json")) {
+        ok = load_index(store, p);
+    } else {
+        ok = load_shard(store, p);
+    }
+    if (!ok) {
+        simd_tensor_store_close(store);
+        return nullptr;
+    }
+    // 按文件位置排序，前缀预读与逐层遍历都是顺序访问
+    std::sort(store->tensors.begin(), store->tensors.end(),
+              [](const SimdTensorStore::Tensor& a, const SimdTensorStore::Tensor& b) {
+                  return a.shard != b.shard ? a.shard < b.shard : a.begin < b.begin;
+              });
+    for (size_t i = 0; i < store->tensors.size(); ++i) {
+        store->index[store->tensors[i].name] = (int)i;
+    }
+    return store;
+}
+
+void simd_tensor_store_close(SimdTensorStore* store) {
+    if (!store) {
+        return;
+    }
+    for (SimdTensorStore::Shard& shard : store->shards) {
+        simd_internal::unmap_shard(&shard);
+    }
+    delete store;
+}
+
+int simd_tensor_store_count(const SimdTensorStore* store) {
+    return store ? (int)store->tensors.size() : 0;
+}
+
+int simd_tensor_store_find(const SimdTensorStore* store, const char* name) {
+    if (!store || !name) {
+        return -1;
+    }
+    auto it = store->index.find(name);
+    return it == store->index.end() ? -1 : it->second;
+}
+
+int simd_tensor_store_info(const SimdTensorStore* store, int index, SimdTensorInfo* info) {
+    if (!store || !info || index < 0 || index >= (int)store->tensors.size()) {
+        return -1;
+    }
+    const SimdTensorStore::Tensor& t = store->tensors[index];
+    const SimdTensorStore::Shard& shard = store->shards[t.shard];
+    info->name = t.name.c_str();
+    info->dtype = t.dtype.c_str();
+    info->ndim = (int)t.shape.size();
+    for (int d = 0; d < SIMD_TENSOR_MAX_DIMS; ++d) {
+        info->shape[d] = d < info->ndim ? t.shape[d] : 0;
+    }
+    info->data = shard.map + t.begin;
+    info->nbytes = (long long)(t.end - t.begin);
+    info->shard = t.shard;
+    info->alignment = 1;
+    while (info->alignment < 4096 && ((uintptr_t)info->data % (info->alignment * 2)) == 0) {
+        info->alignment *= 2;
+    }
+    return 0;
+}
+
+namespace {
+
+#if !defined(_WIN32)
+// 系统页大小 (16K/64K 页的内核上 madvise/mincore 的地址必须按实际页对齐)
+size_t store_page() {
+    static const size_t page = [] {
+        const long p = sysconf(_SC_PAGESIZE);
+        return p > 0 ? (size_t)p : (size_t)4096;
+    }();
+    return page;
+}
+
+// 张量所覆盖的整页范围
+void page_range(const SimdTensorStore* store, const SimdTensorStore::Tensor& t,
+                unsigned char** start, size_t* len) {
+    const size_t page = store_page();
+    const unsigned char* base = store->shards[t.shard].map;
+    const size_t b = t.begin / page * page;
+    const size_t e = std::min((t.end + page - 1) / page * page, store->shards[t.shard].size);
+    *start = const_cast<unsigned char*>(base + b);
+    *len = e > b ? e - b : 0;
+}
+
+// 对匹配的张量逐个 madvise，任一失败时记录原因并返回 -1
+int advise_prefix(const SimdTensorStore* store, const char* prefix, int advice, const char* what) {
+    int err = 0;
+    const int count = simd_internal::for_prefix(store, prefix, [&](const SimdTensorStore::Tensor& t) {
+        unsigned char* start;
+        size_t len;
+        page_range(store, t, &start, &len);
+        if (len > 0 && madvise(start, len, advice) != 0 && err == 0) {
+            err = errno;
+        }
+    });
+    if (err != 0) {
+        simd_internal::tls_store_error = std::string("madvise(") + what + ") 失败: " + strerror(err);
+        return -1;
+    }
+    return count;
+}
+#endif
+
+}  // namespace
+
+/**
+ * 对名称以 prefix 开头的张量发起异步预读，返回匹配的张量数；madvise 失败返回 -1
+ */
+int simd_tensor_store_prefetch(const SimdTensorStore* store, const char* prefix) {
+    if (!store) {
+        return -1;
+    }
+#if !defined(_WIN32)
+    return advise_prefix(store, prefix, MADV_WILLNEED, "WILLNEED");
+#else
+    return simd_internal::for_prefix(store, prefix, [](const SimdTensorStore::Tensor&) {});
+#endif
+}
+
+/**
+ * 把名称以 prefix 开头的张量的页从进程 RSS 中释放 (内容不变，再次访问时从页缓存重新映射)；
+ * madvise 失败返回 -1
+ */
+int simd_tensor_store_release(const SimdTensorStore* store, const char* prefix) {
+    if (!store) {
+        return -1;
+    }
+#if !defined(_WIN32)
+    return advise_prefix(store, prefix, MADV_DONTNEED, "DONTNEED");
+#else
+    return simd_internal::for_prefix(store, prefix, [](const SimdTensorStore::Tensor&) {});
+#endif
+}
+
+/**
+ * 名称以 prefix 开头的张量已在页缓存中的字节数 (按页统计，mincore)，即访问时无需读盘的部分；
+ * 不支持时返回 -1
+ */
+long long simd_tensor_store_resident(const SimdTensorStore* store, const char* prefix) {
+    if (!store) {
+        return -1;
+    }
+#if defined(_WIN32)
+    (void)prefix;
+    return -1;
+#else
+    long long resident = 0;
+    std::vector<unsigned char> vec;
+    simd_internal::for_prefix(store, prefix, [&](const SimdTensorStore::Tensor& t) {
+        unsigned char* start;
+        size_t len;
+        page_range(store, t, &start, &len);
+        const size_t page = store_page();
+        const size_t pages = (len + page - 1) / page;
+        vec.resize(pages);
+        if (pages == 0 || mincore(start, len, vec.data()) != 0) {
+            return;
+        }
+        for (size_t i = 0; i < pages; ++i) {
+            if (vec[i] & 1) {
+                resident += (long long)std::min(page, len - i * page);
+            }
+        }
+    });
+    return resident;
+#endif
+}
+
+namespace simd_internal {
+
+int tensor_store_ranges(const SimdTensorStore* store, const char* prefix,
+                        std::vector<TensorFileRange>* out) {
+    return for_prefix(store, prefix, [&](const SimdTensorStore::Tensor& t) {
+        out->push_back({store->shards[t.shard].path.c_str(), (uint64_t)t.begin, t.end - t.begin});
+    });
+}
+
+}  // namespace simd_internal
@@ -0,0 +1,324 @@
+/**
+ * 常驻线程池 - VisionAI-ClipsMaster
+ *
+ * 库内部的持久化工作线程，用于在单次调用内按 M/N 分块并行执行
+ * GEMM、GEMV 及大规模逐元素运算，避免 Python 层多进程的序列化开销。
+ * 调用线程本身作为 0 号线程参与计算；嵌套调用在当前线程串行执行。
+ */
+
+#include "simd_kernels.h"
+#include "simd_internal.h"
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstdlib>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#if defined(_WIN32)
+    #include <windows.h>
+#else
+    #include <unistd.h>
+    #include <pthread.h>
+    #if defined(__linux__)
+        #include <sched.h>
+    #endif
+#endif
+
+namespace simd_internal {
+
+namespace {
+
+// 当前线程是否正在执行线程池任务 (用于检测嵌套并行)
+thread_local bool tls_in_parallel_region = false;
+
+class ThreadPool {
+public:
+    static ThreadPool& instance() {
+        // 故意不析构: 进程退出时不在静态析构阶段 join 工作线程
+        static ThreadPool* pool = new ThreadPool();
+        return *pool;
+    }
+
+    int size() {
+        // 任务内 run_mutex_ 由发起调用的线程持有，线程数在任务结束前不会改变
+        if (tls_in_parallel_region) {
+            return num_threads_;
+        }
+        std::lock_guard<std::mutex> run_lock(run_mutex_);
+        ensure_started();
+        return num_threads_;
+    }
+
+    void resize(int n) {
+        std::lock_guard<std::mutex> run_lock(run_mutex_);
+        requested_threads_ = n > 0 ? n : default_thread_count();
+        if (started_) {
+            stop_workers();
+        }
+    }
+
+    void set_affinity(bool pinned) {
+        std::lock_guard<std::mutex> run_lock(run_mutex_);
+        pinned_ = pinned;
+        if (started_) {
+            stop_workers();
+        }
+    }
+
+    bool affinity() const { return pinned_; }
+
+    void run(int n_tasks, int max_threads, const ParallelTask& fn) {
+        if (n_tasks <= 0) {
+            return;
+        }
+        if (n_tasks == 1 || max_threads == 1 || tls_in_parallel_region) {
+            run_serial(n_tasks, fn);
+            return;
+        }
+
+        std::lock_guard<std::mutex> run_lock(run_mutex_);
+        ensure_started();
+        const int participants = std::min(std::min(num_threads_, n_tasks),
+                                           max_threads > 0 ? max_threads : num_threads_);
+        if (participants <= 1) {
+            // 仍持有 run_mutex_: 标记为并行区域，任务内的嵌套调用不再加锁
+            tls_in_parallel_region = true;
+            run_serial(n_tasks, fn);
+            tls_in_parallel_region = false;
+            return;
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            job_ = &fn;
+            job_tasks_ = n_tasks;
+            job_participants_ = participants;
+            next_task_.store(0, std::memory_order_relaxed);
+            pending_workers_ = (int)workers_.size();
+            ++generation_;
+        }
+        start_cv_.notify_all();
+
+        tls_in_parallel_region = true;
+        execute_tasks(0);
+        tls_in_parallel_region = false;
+
+        std::unique_lock<std::mutex> lock(mutex_);
+        done_cv_.wait(lock, [this] { return pending_workers_ == 0; });
+        job_ = nullptr;
+    }
+
+private:
+    ThreadPool() = default;
+
+    static int default_thread_count() {
+        const char* env = getenv("SIMD_NUM_THREADS");
+        if (env) {
+            int n = atoi(env);
+            if (n > 0) {
+                return n;
+            }
+        }
+        unsigned int hw = std::thread::hardware_concurrency();
+        return hw > 0 ? (int)hw : 1;
+    }
+
+    static void run_serial(int n_tasks, const ParallelTask& fn) {
+        for (int t = 0; t < n_tasks; ++t) {
+            fn(t, 0);
+        }
+    }
+
+    void ensure_started() {
+#if !defined(_WIN32)
+        // fork 后子进程中没有工作线程: 旧线程句柄无法 join，直接丢弃并重建
+        if (started_ && owner_pid_ != getpid()) {
+            workers_.clear();
+            started_ = false;
+        }
+#endif
+        if (started_) {
+            return;
+        }
+        if (requested_threads_ <= 0) {
+            requested_threads_ = default_thread_count();
+        }
+        num_threads_ = requested_threads_;
+        stop_ = false;
+#if !defined(_WIN32)
+        owner_pid_ = getpid();
+#endif
+        // 以创建时的任务代数作为起点，避免新线程错过紧随其后的第一个任务
+        const unsigned long start_generation = generation_;
+        for (int tid = 1; tid < num_threads_; ++tid) {
+            workers_.push_back(new std::thread(&ThreadPool::worker_loop, this, tid, start_generation));
+        }
+        started_ = true;
+    }
+
+    void stop_workers() {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            stop_ = true;
+        }
+        start_cv_.notify_all();
+        for (std::thread* t : workers_) {
+            t->join();
+            delete t;
+        }
+        workers_.clear();
+        started_ = false;
+    }
+
+    void pin_current_thread(int tid) {
+#if defined(__linux__)
+        cpu_set_t allowed;
+        CPU_ZERO(&allowed);
+        if (sched_getaffinity(0, sizeof(allowed), &allowed) != 0) {
+            return;
+        }
+        // 在进程允许的CPU集合中选取第 tid 个CPU (多 NUMA 节点时各节点轮流，
+        // 线程数少于CPU数时也能用上所有节点的内存带宽)
+        std::vector<int> cpus;
+        for (int cpu = 0; cpu < CPU_SETSIZE; ++cpu) {
+            if (CPU_ISSET(cpu, &allowed)) {
+                cpus.push_back(cpu);
+            }
+        }
+        if (cpus.empty()) {
+            return;
+        }
+        cpus = numa_spread_cpus(cpus);
+        cpu_set_t one;
+        CPU_ZERO(&one);
+        CPU_SET(cpus[tid % cpus.size()], &one);
+        pthread_setaffinity_np(pthread_self(), sizeof(one), &one);
+#elif defined(_WIN32)
+        DWORD_PTR process_mask = 0, system_mask = 0;
+        if (!GetProcessAffinityMask(GetCurrentProcess(), &process_mask, &system_mask)) {
+            return;
+        }
+        int count = 0;
+        for (int bit = 0; bit < (int)(sizeof(DWORD_PTR) * 8); ++bit) {
+            if (process_mask & ((DWORD_PTR)1 << bit)) ++count;
+        }
+        if (count == 0) {
+            return;
+        }
+        int target = tid % count;
+        for (int bit = 0; bit < (int)(sizeof(DWORD_PTR) * 8); ++bit) {
+            if ((process_mask & ((DWORD_PTR)1 << bit)) && target-- == 0) {
+                SetThreadAffinityMask(GetCurrentThread(), (DWORD_PTR)1 << bit);
+                return;
+            }
+        }
+#else
+        (void)tid;  // 其他平台 (如 macOS) 不支持硬绑定
+#endif
+    }
+
+    void execute_tasks(int tid) {
+        const ParallelTask& fn = *job_;
+        const int n_tasks = job_tasks_;
+        for (;;) {
+            int task = next_task_.fetch_add(1, std::memory_order_relaxed);
+            if (task >= n_tasks) {
+                break;
+            }
+            fn(task, tid);
+        }
+    }
+
+    void worker_loop(int tid, unsigned long seen_generation) {
+        if (pinned_) {
+            pin_current_thread(tid);
+        }
+        tls_in_parallel_region = true;
+
+        for (;;) {
+            bool participate;
+            {
+                std::unique_lock<std::mutex> lock(mutex_);
+                start_cv_.wait(lock, [&] { return stop_ || generation_ != seen_generation; });
+                if (stop_) {
+                    return;
+                }
+                seen_generation = generation_;
+                participate = tid < job_participants_;
+            }
+
+            if (participate) {
+                execute_tasks(tid);
+            }
+
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (--pending_workers_ == 0) {
+                done_cv_.notify_one();
+            }
+        }
+    }
+
+    std::mutex run_mutex_;          // 串行化外部调用与重配置
+    std::mutex mutex_;              // 保护任务分发状态
+    std::condition_variable start_cv_;
+    std::condition_variable done_cv_;
+    std::vector<std::thread*> workers_;
+
+    const ParallelTask* job_ = nullptr;
+    int job_tasks_ = 0;
+    int job_participants_ = 0;
+    std::atomic<int> next_task_{0};
+    int pending_workers_ = 0;
+    unsigned long generation_ = 0;
+    bool stop_ = false;
+
+    bool started_ = false;
+    bool pinned_ = false;
+    int requested_threads_ = 0;
+    int num_threads_ = 1;
+#if !defined(_WIN32)
+    pid_t owner_pid_ = 0;
+#endif
+};
+
+}  // namespace
+
+int thread_pool_size() {
+    return ThreadPool::instance().size();
+}
+
+bool in_parallel_region() {
+    return tls_in_parallel_region;
+}
+
+void parallel_for(int n_tasks, int max_threads, const ParallelTask& fn) {
+    ThreadPool::instance().run(n_tasks, max_threads, fn);
+}
+
+}  // namespace simd_internal
+
+/**
+ * 设置线程池线程数 (含调用线程)，n <= 0 恢复默认值
+ * 默认值取环境变量 SIMD_NUM_THREADS，未设置时为硬件线程数
+ */
+void simd_set_num_threads(int n) {
+    simd_internal::ThreadPool::instance().resize(n);
+}
+
+int simd_get_num_threads(void) {
+    return simd_internal::thread_pool_size();
+}
+
+/**
+ * 设置工作线程是否绑定到固定CPU核心
+ */
+void simd_set_thread_affinity(int pinned) {
+    simd_internal::ThreadPool::instance().set_affinity(pinned != 0);
+}
+
+int simd_get_thread_affinity(void) {
+    return simd_internal::ThreadPool::instance().affinity() ? 1 : 0;
+}
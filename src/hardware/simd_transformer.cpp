@@ -0,0 +1,278 @@
+/**
+ * Transformer 逐行算子 - VisionAI-ClipsMaster
+ *
+ * softmax / RMSNorm / LayerNorm / 激活 / 旋转位置编码。CPU 上运行本地 LLM 时，
+ * 矩阵乘之外的归一化、softmax 与激活若在 PyTorch eager 模式下逐个执行，
+ * 每一步都要完整遍历一次激活张量；这里每行只从内存读取一次，统计量
+ * 由归约内核求出，写回在同一行驻留缓存时完成，行间按线程池并行。
+ * softmax 按块在线合并: 每块求块内最大值后直接写出 exp 并求和，
+ * 块间按最大值差重新缩放归一化因子，exp 每个元素只计算一次。
+ */
+
+#include "simd_kernels.h"
+#include "simd_internal.h"
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+namespace simd_internal {
+
+// 每个线程至少处理的元素数
+static const size_t TRANSFORMER_PARALLEL_GRAIN = 1 << 15;
+
+// softmax 在线合并的块数上限与最小块长 (块长按行长放大，块统计量放在栈上)
+static const int SOFTMAX_MAX_BLOCKS = 64;
+static const int SOFTMAX_MIN_BLOCK = 1024;
+
+static float exp_sum_generic(const float* x, float* y, int n, float scale, float shift) {
+    float sum = 0.0f;
+    for (int i = 0; i < n; ++i) {
+        y[i] = std::exp(x[i] * scale - shift);
+        sum += y[i];
+    }
+    return sum;
+}
+
+static void norm_apply_generic(const float* x, const float* w, const float* b, float* y, int n,
+                               float shift, float scale) {
+    for (int i = 0; i < n; ++i) {
+        float v = (x[i] - shift) * scale;
+        if (w) {
+            v *= w[i];
+        }
+        y[i] = b ? v + b[i] : v;
+    }
+}
+
+static void rope_generic(float* x, const float* cos, const float* sin, int half, int interleaved) {
+    for (int i = 0; i < half; ++i) {
+        float* p0 = interleaved ? x + 2 * i : x + i;
+        float* p1 = interleaved ? x + 2 * i + 1 : x + half + i;
+        const float x0 = *p0;
+        const float x1 = *p1;
+        *p0 = x0 * cos[i] - x1 * sin[i];
+        *p1 = x1 * cos[i] + x0 * sin[i];
+    }
+}
+
+static void weighted_rows_generic(const float* V, size_t ldv, const float* p, int n,
+                                  float* o, int d) {
+    for (int j = 0; j < n; ++j) {
+        const float* row = V + (size_t)j * ldv;
+        for (int c = 0; c < d; ++c) {
+            o[c] += p[j] * row[c];
+        }
+    }
+}
+
+const TransformerKernels* transformer_kernels_generic() {
+    static const TransformerKernels kernels = {
+        "generic", exp_sum_generic, norm_apply_generic, rope_generic, weighted_rows_generic
+    };
+    return &kernels;
+}
+
+namespace {
+
+template <typename Fn>
+void for_each_row(int rows, int cols, Fn fn) {
+    const size_t grain = std::max<size_t>(1, TRANSFORMER_PARALLEL_GRAIN / std::max(cols, 1));
+    parallel_for_range((size_t)rows, grain, [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i) {
+            fn((int)i);
+        }
+    });
+}
+
+bool valid_rows(const float* x, int ldx, const float* y, int ldy, int rows, int cols) {
+    return rows >= 0 && cols >= 0 && ldx >= cols && ldy >= cols &&
+           ((x && y) || rows == 0 || cols == 0);
+}
+
+/**
+ * 单行 softmax: 各块的最大值 m_b 与 d_b = sum exp(s * x - m_b) 在写出 exp 时一并求出，
+ * 最后按 exp(m_b - m) / d 缩放各块 (d = sum_b d_b * exp(m_b - m))
+ */
+void softmax_row(const TransformerKernels* k, const ReduceKernels* r, scale_kernel_fn scale_fn,
+                 const float* x, float* y, int n, float scale) {
+    const int min_block = (n + SOFTMAX_MAX_BLOCKS - 1) / SOFTMAX_MAX_BLOCKS;
+    const int block = std::max(SOFTMAX_MIN_BLOCK, (min_block + 15) & ~15);
+    const int n_blocks = (n + block - 1) / block;
+    float maxes[SOFTMAX_MAX_BLOCKS];
+    float sums[SOFTMAX_MAX_BLOCKS];
+    float m = -INFINITY;
+    for (int b = 0; b < n_blocks; ++b) {
+        const int begin = b * block;
+        const int len = std::min(block, n - begin);
+        const float mb = scale >= 0.0f ? r->max(x + begin, len) * scale
+                                       : r->min(x + begin, len) * scale;
+        maxes[b] = mb;
+        if (mb == -INFINITY) {
+            // 整块被屏蔽: 输出 0，避免 -inf - (-inf) 产生 NaN
+            std::fill(y + begin, y + begin + len, 0.0f);
+            sums[b] = 0.0f;
+            continue;
+        }
+        sums[b] = k->exp_sum(x + begin, y + begin, len, scale, mb);
+        m = std::max(m, mb);
+    }
+    if (m == -INFINITY) {
+        return;
+    }
+    double d = 0.0;
+    for (int b = 0; b < n_blocks; ++b) {
+        if (maxes[b] != -INFINITY) {
+            d += (double)sums[b] * std::exp((double)maxes[b] - m);
+        }
+    }
+    for (int b = 0; b < n_blocks; ++b) {
+        if (maxes[b] != -INFINITY) {
+            const int begin = b * block;
+            scale_fn(y + begin, (float)(std::exp((double)maxes[b] - m) / d),
+                     std::min(block, n - begin));
+        }
+    }
+}
+
+bool valid_activation(int act) {
+    return act >= SIMD_ACT_NONE && act <= SIMD_ACT_SILU;
+}
+
+}  // namespace
+
+}  // namespace simd_internal
+
+int simd_softmax(const float* x, int ldx, float* y, int ldy, int rows, int cols, float scale) {
+    using namespace simd_internal;
+    if (!valid_rows(x, ldx, y, ldy, rows, cols)) {
+        return -1;
+    }
+    if (cols == 0) {
+        return 0;
+    }
+    const SimdDispatchTable& table = dispatch_table();
+    for_each_row(rows, cols, [&](int i) {
+        softmax_row(table.transformer, table.reduce, table.vector_scale,
+                    x + (size_t)i * ldx, y + (size_t)i * ldy, cols, scale);
+    });
+    return 0;
+}
+
+int simd_rmsnorm(const float* x, int ldx, const float* weight, float* y, int ldy,
+                 int rows, int cols, float eps) {
+    using namespace simd_internal;
+    if (!valid_rows(x, ldx, y, ldy, rows, cols) || !(eps >= 0.0f)) {
+        return -1;
+    }
+    if (cols == 0) {
+        return 0;
+    }
+    const SimdDispatchTable& table = dispatch_table();
+    for_each_row(rows, cols, [&](int i) {
+        const float* row = x + (size_t)i * ldx;
+        const float ms = table.reduce->sum_sq(row, cols, 0.0f) / (float)cols;
+        table.transformer->norm_apply(row, weight, nullptr, y + (size_t)i * ldy, cols,
+                                      0.0f, 1.0f / std::sqrt(ms + eps));
+    });
+    return 0;
+}
+
+int simd_layernorm(const float* x, int ldx, const float* gamma, const float* beta,
+                   float* y, int ldy, int rows, int cols, float eps) {
+    using namespace simd_internal;
+    if (!valid_rows(x, ldx, y, ldy, rows, cols) || !(eps >= 0.0f)) {
+        return -1;
+    }
+    if (cols == 0) {
+        return 0;
+    }
+    const SimdDispatchTable& table = dispatch_table();
+    for_each_row(rows, cols, [&](int i) {
+        const float* row = x + (size_t)i * ldx;
+        // 方差以均值为中心再求一遍 (行驻留 L1)，避免 E[x^2] - E[x]^2 的抵消误差
+        const float mean = table.reduce->sum(row, cols) / (float)cols;
+        const float var = table.reduce->sum_sq(row, cols, mean) / (float)cols;
+        table.transformer->norm_apply(row, gamma, beta, y + (size_t)i * ldy, cols,
+                                      mean, 1.0f / std::sqrt(var + eps));
+    });
+    return 0;
+}
+
+/**
+ * 激活函数复用融合逐元素表达式引擎 (分块、并行与各指令集的多项式 exp)
+ */
+int simd_activation(int act, const float* x, float* y, long long n) {
+    using namespace simd_internal;
+    if (!valid_activation(act)) {
+        return -1;
+    }
+    const SimdEwInstr program[2] = {
+        {SIMD_EW_LOAD, 0, 0, 0, 0, 0.0f, 0.0f},
+        {SIMD_EW_ACT, 0, 0, act, 0, 0.0f, 0.0f},
+    };
+    return simd_elementwise_fused(program, 2, &x, 1, 0, y, n);
+}
+
+int simd_gated_activation(int act, const float* gate, const float* up, float* y, long long n) {
+    using namespace simd_internal;
+    if (!valid_activation(act)) {
+        return -1;
+    }
+    const float* inputs[2] = {gate, up};
+    const SimdEwInstr program[4] = {
+        {SIMD_EW_LOAD, 0, 0, 0, 0, 0.0f, 0.0f},
+        {SIMD_EW_LOAD, 1, 1, 0, 0, 0.0f, 0.0f},
+        {SIMD_EW_ACT, 0, 0, act, 0, 0.0f, 0.0f},
+        {SIMD_EW_MUL, 0, 0, 1, 0, 0.0f, 0.0f},
+    };
+    return simd_elementwise_fused(program, 4, inputs, 2, 0, y, n);
+}
+
+int simd_rope(float* x, int n_tokens, int n_heads, long long ld_token, long long ld_head,
+              const float* cos, const float* sin, int rotary_dim, int interleaved) {
+    using namespace simd_internal;
+    if (n_tokens < 0 || n_heads < 0 || rotary_dim <= 0 || rotary_dim % 2 != 0) {
+        return -1;
+    }
+    const size_t pairs = (size_t)n_tokens * (size_t)n_heads;
+    if (pairs == 0) {
+        return 0;
+    }
+    if (!x || !cos || !sin) {
+        return -1;
+    }
+    const TransformerKernels* k = dispatch_table().transformer;
+    const int half = rotary_dim / 2;
+    const size_t grain = std::max<size_t>(1, TRANSFORMER_PARALLEL_GRAIN / (size_t)rotary_dim);
+    parallel_for_range(pairs, grain, [&](size_t begin, size_t end) {
+        for (size_t p = begin; p < end; ++p) {
+            const long long t = (long long)(p / (size_t)n_heads);
+            const long long h = (long long)(p % (size_t)n_heads);
+            k->rope(x + t * ld_token + h * ld_head, cos + t * half, sin + t * half,
+                    half, interleaved);
+        }
+    });
+    return 0;
+}
+
+int simd_rope_tables(const int* positions, int n_tokens, int rotary_dim, float theta,
+                     float* cos, float* sin) {
+    if (n_tokens < 0 || rotary_dim <= 0 || rotary_dim % 2 != 0 || !(theta > 0.0f) ||
+        (n_tokens > 0 && (!positions || !cos || !sin))) {
+        return -1;
+    }
+    const int half = rotary_dim / 2;
+    std::vector<double> inv_freq(half);
+    for (int i = 0; i < half; ++i) {
+        inv_freq[i] = std::pow((double)theta, -2.0 * i / rotary_dim);
+    }
+    for (int t = 0; t < n_tokens; ++t) {
+        for (int i = 0; i < half; ++i) {
+            const double angle = (double)positions[t] * inv_freq[i];
+            cos[(size_t)t * half + i] = (float)std::cos(angle);
+            sin[(size_t)t * half + i] = (float)std::sin(angle);
+        }
+    }
+    return 0;
+}
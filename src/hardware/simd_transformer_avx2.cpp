@@ -0,0 +1,159 @@
+/**
+ * AVX2/FMA Transformer 逐行算子内核 - VisionAI-ClipsMaster
+ * exp 使用 simd_vecmath.h 的多项式近似，尾部使用 maskload/maskstore；
+ * 交错式 rope 以 fmaddsub 完成成对旋转
+ */
+
+#include "simd_internal.h"
+#include "simd_vecmath.h"
+
+#if defined(__AVX2__) && defined(__FMA__)
+#include <immintrin.h>
+#include <cstdint>
+
+namespace simd_internal {
+
+namespace {
+
+// 从 TRANSFORMER_TAIL_MASK + 8 - n 处读取 8 个 int 即得到低 n 个通道的掩码
+const int32_t TRANSFORMER_TAIL_MASK[16] = {-1, -1, -1, -1, -1, -1, -1, -1, 0, 0, 0, 0, 0, 0, 0, 0};
+
+inline __m256i tail_mask8(int n) {
+    return _mm256_loadu_si256(reinterpret_cast<const __m256i*>(TRANSFORMER_TAIL_MASK + 8 - n));
+}
+
+inline float hsum256(__m256 v) {
+    __m128 s = _mm_add_ps(_mm256_castps256_ps128(v), _mm256_extractf128_ps(v, 1));
+    s = _mm_add_ps(s, _mm_movehl_ps(s, s));
+    s = _mm_add_ss(s, _mm_movehdup_ps(s));
+    return _mm_cvtss_f32(s);
+}
+
+float exp_sum_avx2(const float* x, float* y, int n, float scale, float shift) {
+    const __m256 s = _mm256_set1_ps(scale);
+    const __m256 sh = _mm256_set1_ps(shift);
+    __m256 acc0 = _mm256_setzero_ps();
+    __m256 acc1 = _mm256_setzero_ps();
+    int i = 0;
+    for (; i + 16 <= n; i += 16) {
+        const __m256 e0 = exp256_ps(_mm256_fmsub_ps(_mm256_loadu_ps(x + i), s, sh));
+        const __m256 e1 = exp256_ps(_mm256_fmsub_ps(_mm256_loadu_ps(x + i + 8), s, sh));
+        _mm256_storeu_ps(y + i, e0);
+        _mm256_storeu_ps(y + i + 8, e1);
+        acc0 = _mm256_add_ps(acc0, e0);
+        acc1 = _mm256_add_ps(acc1, e1);
+    }
+    for (; i < n; i += 8) {
+        const __m256i m = tail_mask8(n - i < 8 ? n - i : 8);
+        const __m256 e = _mm256_and_ps(
+            exp256_ps(_mm256_fmsub_ps(_mm256_maskload_ps(x + i, m), s, sh)),
+            _mm256_castsi256_ps(m));
+        _mm256_maskstore_ps(y + i, m, e);
+        acc0 = _mm256_add_ps(acc0, e);
+    }
+    return hsum256(_mm256_add_ps(acc0, acc1));
+}
+
+template <bool HAS_W, bool HAS_B>
+void norm_loop_avx2(const float* x, const float* w, const float* b, float* y, int n,
+                    float shift, float scale) {
+    const __m256 sh = _mm256_set1_ps(shift);
+    const __m256 sc = _mm256_set1_ps(scale);
+    for (int i = 0; i < n; i += 8) {
+        const __m256i m = tail_mask8(n - i < 8 ? n - i : 8);
+        __m256 v = _mm256_mul_ps(_mm256_sub_ps(_mm256_maskload_ps(x + i, m), sh), sc);
+        if (HAS_W) {
+            v = _mm256_mul_ps(v, _mm256_maskload_ps(w + i, m));
+        }
+        if (HAS_B) {
+            v = _mm256_add_ps(v, _mm256_maskload_ps(b + i, m));
+        }
+        _mm256_maskstore_ps(y + i, m, v);
+    }
+}
+
+void norm_apply_avx2(const float* x, const float* w, const float* b, float* y, int n,
+                     float shift, float scale) {
+    if (w && b) {
+        norm_loop_avx2<true, true>(x, w, b, y, n, shift, scale);
+    } else if (w) {
+        norm_loop_avx2<true, false>(x, w, b, y, n, shift, scale);
+    } else if (b) {
+        norm_loop_avx2<false, true>(x, w, b, y, n, shift, scale);
+    } else {
+        norm_loop_avx2<false, false>(x, w, b, y, n, shift, scale);
+    }
+}
+
+void rope_avx2(float* x, const float* cos, const float* sin, int half, int interleaved) {
+    int i = 0;
+    if (!interleaved) {
+        for (; i < half; i += 8) {
+            const __m256i m = tail_mask8(half - i < 8 ? half - i : 8);
+            const __m256 c = _mm256_maskload_ps(cos + i, m);
+            const __m256 s = _mm256_maskload_ps(sin + i, m);
+            const __m256 x0 = _mm256_maskload_ps(x + i, m);
+            const __m256 x1 = _mm256_maskload_ps(x + half + i, m);
+            _mm256_maskstore_ps(x + i, m, _mm256_fmsub_ps(x0, c, _mm256_mul_ps(x1, s)));
+            _mm256_maskstore_ps(x + half + i, m, _mm256_fmadd_ps(x1, c, _mm256_mul_ps(x0, s)));
+        }
+        return;
+    }
+    // 交错配对: 每个向量 4 对，cos/sin 按对复制到相邻通道，
+    // 偶数通道 x0 * c - x1 * s，奇数通道 x1 * c + x0 * s
+    const __m256i dup = _mm256_setr_epi32(0, 0, 1, 1, 2, 2, 3, 3);
+    for (; i < half; i += 4) {
+        const int pairs = half - i < 4 ? half - i : 4;
+        const __m256i m = tail_mask8(2 * pairs);
+        const __m256i mh = tail_mask8(pairs);
+        const __m256 c = _mm256_permutevar8x32_ps(_mm256_maskload_ps(cos + i, mh), dup);
+        const __m256 s = _mm256_permutevar8x32_ps(_mm256_maskload_ps(sin + i, mh), dup);
+        const __m256 v = _mm256_maskload_ps(x + 2 * i, m);
+        const __m256 swapped = _mm256_permute_ps(v, 0xB1);
+        _mm256_maskstore_ps(x + 2 * i, m, _mm256_fmaddsub_ps(v, c, _mm256_mul_ps(swapped, s)));
+    }
+}
+
+/**
+ * 每次保留 o 的 64 列 (8 个累加器) 在寄存器中，逐行读取 V 的对应片段
+ */
+void weighted_rows_avx2(const float* V, size_t ldv, const float* p, int n, float* o, int d) {
+    for (int c = 0; c < d; c += 64) {
+        __m256i m[8];
+        __m256 acc[8];
+        for (int k = 0; k < 8; ++k) {
+            const int left = d - c - 8 * k;
+            m[k] = tail_mask8(left >= 8 ? 8 : (left > 0 ? left : 0));
+            acc[k] = _mm256_maskload_ps(o + c + 8 * k, m[k]);
+        }
+        for (int j = 0; j < n; ++j) {
+            const __m256 pj = _mm256_set1_ps(p[j]);
+            const float* row = V + (size_t)j * ldv + c;
+            for (int k = 0; k < 8; ++k) {
+                acc[k] = _mm256_fmadd_ps(_mm256_maskload_ps(row + 8 * k, m[k]), pj, acc[k]);
+            }
+        }
+        for (int k = 0; k < 8; ++k) {
+            _mm256_maskstore_ps(o + c + 8 * k, m[k], acc[k]);
+        }
+    }
+}
+
+}  // namespace
+
+const TransformerKernels* transformer_kernels_avx2() {
+    static const TransformerKernels kernels = {
+        "avx2", exp_sum_avx2, norm_apply_avx2, rope_avx2, weighted_rows_avx2
+    };
+    return &kernels;
+}
+
+}  // namespace simd_internal
+
+#else  // 未启用 AVX2/FMA 编译
+
+namespace simd_internal {
+const TransformerKernels* transformer_kernels_avx2() { return nullptr; }
+}
+
+#endif
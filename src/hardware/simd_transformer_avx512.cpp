@@ -0,0 +1,152 @@
+/**
+ * AVX-512 Transformer 逐行算子内核 - VisionAI-ClipsMaster
+ * exp 使用 simd_vecmath.h 的多项式近似，尾部使用掩码读写；
+ * 交错式 rope 以 fmaddsub 完成成对旋转
+ */
+
+#include "simd_internal.h"
+#include "simd_vecmath.h"
+
+#if defined(__AVX512F__)
+#include <immintrin.h>
+
+#if defined(__GNUC__) && !defined(__clang__)
+// GCC 12 对 _mm512_undefined_* 的 -W(maybe-)uninitialized 误报 (见 _mm512_reduce_*_ps)
+#pragma GCC diagnostic ignored "-Wmaybe-uninitialized"
+#pragma GCC diagnostic ignored "-Wuninitialized"
+#endif
+
+namespace simd_internal {
+
+namespace {
+
+inline __mmask16 tail_mask16(int n) {
+    return (__mmask16)((1u << n) - 1);
+}
+
+float exp_sum_avx512(const float* x, float* y, int n, float scale, float shift) {
+    const __m512 s = _mm512_set1_ps(scale);
+    const __m512 sh = _mm512_set1_ps(shift);
+    __m512 acc0 = _mm512_setzero_ps();
+    __m512 acc1 = _mm512_setzero_ps();
+    int i = 0;
+    for (; i + 32 <= n; i += 32) {
+        const __m512 e0 = exp512_ps(_mm512_fmsub_ps(_mm512_loadu_ps(x + i), s, sh));
+        const __m512 e1 = exp512_ps(_mm512_fmsub_ps(_mm512_loadu_ps(x + i + 16), s, sh));
+        _mm512_storeu_ps(y + i, e0);
+        _mm512_storeu_ps(y + i + 16, e1);
+        acc0 = _mm512_add_ps(acc0, e0);
+        acc1 = _mm512_add_ps(acc1, e1);
+    }
+    for (; i < n; i += 16) {
+        const __mmask16 m = tail_mask16(n - i < 16 ? n - i : 16);
+        const __m512 e = exp512_ps(_mm512_fmsub_ps(_mm512_maskz_loadu_ps(m, x + i), s, sh));
+        _mm512_mask_storeu_ps(y + i, m, e);
+        acc0 = _mm512_mask_add_ps(acc0, m, acc0, e);
+    }
+    return _mm512_reduce_add_ps(_mm512_add_ps(acc0, acc1));
+}
+
+template <bool HAS_W, bool HAS_B>
+void norm_loop_avx512(const float* x, const float* w, const float* b, float* y, int n,
+                      float shift, float scale) {
+    const __m512 sh = _mm512_set1_ps(shift);
+    const __m512 sc = _mm512_set1_ps(scale);
+    for (int i = 0; i < n; i += 16) {
+        const __mmask16 m = tail_mask16(n - i < 16 ? n - i : 16);
+        __m512 v = _mm512_mul_ps(_mm512_sub_ps(_mm512_maskz_loadu_ps(m, x + i), sh), sc);
+        if (HAS_W) {
+            v = _mm512_mul_ps(v, _mm512_maskz_loadu_ps(m, w + i));
+        }
+        if (HAS_B) {
+            v = _mm512_add_ps(v, _mm512_maskz_loadu_ps(m, b + i));
+        }
+        _mm512_mask_storeu_ps(y + i, m, v);
+    }
+}
+
+void norm_apply_avx512(const float* x, const float* w, const float* b, float* y, int n,
+                       float shift, float scale) {
+    if (w && b) {
+        norm_loop_avx512<true, true>(x, w, b, y, n, shift, scale);
+    } else if (w) {
+        norm_loop_avx512<true, false>(x, w, b, y, n, shift, scale);
+    } else if (b) {
+        norm_loop_avx512<false, true>(x, w, b, y, n, shift, scale);
+    } else {
+        norm_loop_avx512<false, false>(x, w, b, y, n, shift, scale);
+    }
+}
+
+void rope_avx512(float* x, const float* cos, const float* sin, int half, int interleaved) {
+    int i = 0;
+    if (!interleaved) {
+        for (; i < half; i += 16) {
+            const __mmask16 m = tail_mask16(half - i < 16 ? half - i : 16);
+            const __m512 c = _mm512_maskz_loadu_ps(m, cos + i);
+            const __m512 s = _mm512_maskz_loadu_ps(m, sin + i);
+            const __m512 x0 = _mm512_maskz_loadu_ps(m, x + i);
+            const __m512 x1 = _mm512_maskz_loadu_ps(m, x + half + i);
+            _mm512_mask_storeu_ps(x + i, m, _mm512_fmsub_ps(x0, c, _mm512_mul_ps(x1, s)));
+            _mm512_mask_storeu_ps(x + half + i, m, _mm512_fmadd_ps(x1, c, _mm512_mul_ps(x0, s)));
+        }
+        return;
+    }
+    // 交错配对: 每个向量 8 对，cos/sin 按对复制到相邻通道，
+    // 偶数通道 x0 * c - x1 * s，奇数通道 x1 * c + x0 * s
+    const __m512i dup = _mm512_setr_epi32(0, 0, 1, 1, 2, 2, 3, 3, 4, 4, 5, 5, 6, 6, 7, 7);
+    for (; i < half; i += 8) {
+        const int pairs = half - i < 8 ? half - i : 8;
+        const __mmask16 m = tail_mask16(2 * pairs);
+        const __mmask16 mh = tail_mask16(pairs);
+        const __m512 c = _mm512_permutexvar_ps(dup, _mm512_maskz_loadu_ps(mh, cos + i));
+        const __m512 s = _mm512_permutexvar_ps(dup, _mm512_maskz_loadu_ps(mh, sin + i));
+        const __m512 v = _mm512_maskz_loadu_ps(m, x + 2 * i);
+        const __m512 swapped = _mm512_permute_ps(v, 0xB1);
+        _mm512_mask_storeu_ps(x + 2 * i, m, _mm512_fmaddsub_ps(v, c, _mm512_mul_ps(swapped, s)));
+    }
+}
+
+/**
+ * 每次保留 o 的 128 列 (8 个累加器) 在寄存器中，逐行读取 V 的对应片段
+ */
+void weighted_rows_avx512(const float* V, size_t ldv, const float* p, int n, float* o, int d) {
+    for (int c = 0; c < d; c += 128) {
+        __mmask16 m[8];
+        __m512 acc[8];
+        for (int k = 0; k < 8; ++k) {
+            const int left = d - c - 16 * k;
+            m[k] = left >= 16 ? (__mmask16)0xFFFF : tail_mask16(left > 0 ? left : 0);
+            acc[k] = _mm512_maskz_loadu_ps(m[k], o + c + 16 * k);
+        }
+        for (int j = 0; j < n; ++j) {
+            const __m512 pj = _mm512_set1_ps(p[j]);
+            const float* row = V + (size_t)j * ldv + c;
+            for (int k = 0; k < 8; ++k) {
+                acc[k] = _mm512_fmadd_ps(_mm512_maskz_loadu_ps(m[k], row + 16 * k), pj, acc[k]);
+            }
+        }
+        for (int k = 0; k < 8; ++k) {
+            _mm512_mask_storeu_ps(o + c + 16 * k, m[k], acc[k]);
+        }
+    }
+}
+
+}  // namespace
+
+const TransformerKernels* transformer_kernels_avx512() {
+    static const TransformerKernels kernels = {
+        "avx512", exp_sum_avx512, norm_apply_avx512, rope_avx512, weighted_rows_avx512
+    };
+    return &kernels;
+}
+
+}  // namespace simd_internal
+
+#else  // 未启用 AVX-512 编译
+
+namespace simd_internal {
+const TransformerKernels* transformer_kernels_avx512() { return nullptr; }
+}
+
+#endif
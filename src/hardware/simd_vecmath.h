@@ -0,0 +1,126 @@
+/**
+ * SIMD 向量数学函数 - VisionAI-ClipsMaster
+ * exp 与激活函数的向量实现，供各指令集编译单元内联使用 (按编译选项启用对应部分)
+ */
+
+#ifndef VISIONAI_SIMD_VECMATH_H
+#define VISIONAI_SIMD_VECMATH_H
+
+#include "simd_kernels.h"
+
+#include <cmath>
+
+#if defined(__AVX2__) || defined(__AVX512F__)
+#include <immintrin.h>
+#endif
+
+namespace simd_internal {
+
+// GELU tanh 近似: 0.5x(1 + tanh(u)) = x / (1 + exp(-2u))，u = sqrt(2/pi)(x + 0.044715x^3)
+static const float GELU_K0 = 0.7978845608f;
+static const float GELU_K1 = 0.044715f;
+
+inline float activation_scalar(float x, int activation) {
+    switch (activation) {
+    case SIMD_ACT_RELU:
+        return x > 0.0f ? x : 0.0f;
+    case SIMD_ACT_GELU:
+        return 0.5f * x * (1.0f + std::tanh(GELU_K0 * (x + GELU_K1 * x * x * x)));
+    case SIMD_ACT_SILU:
+        return x / (1.0f + std::exp(-x));
+    default:
+        return x;
+    }
+}
+
+#if defined(__AVX2__) && defined(__FMA__)
+
+/**
+ * exp(x): 2^n * p(r)，r = x - n * ln2 ∈ [-ln2/2, ln2/2]，5 次多项式，相对误差约 2e-7
+ */
+inline __m256 exp256_ps(__m256 x) {
+    x = _mm256_min_ps(_mm256_max_ps(x, _mm256_set1_ps(-87.3f)), _mm256_set1_ps(88.3f));
+    const __m256 n = _mm256_round_ps(_mm256_mul_ps(x, _mm256_set1_ps(1.44269504f)),
+                                     _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC);
+    __m256 r = _mm256_fnmadd_ps(n, _mm256_set1_ps(0.693359375f), x);
+    r = _mm256_fnmadd_ps(n, _mm256_set1_ps(-2.12194440e-4f), r);
+    __m256 p = _mm256_set1_ps(1.9875691500e-4f);
+    p = _mm256_fmadd_ps(p, r, _mm256_set1_ps(1.3981999507e-3f));
+    p = _mm256_fmadd_ps(p, r, _mm256_set1_ps(8.3334519073e-3f));
+    p = _mm256_fmadd_ps(p, r, _mm256_set1_ps(4.1665795894e-2f));
+    p = _mm256_fmadd_ps(p, r, _mm256_set1_ps(1.6666665459e-1f));
+    p = _mm256_fmadd_ps(p, r, _mm256_set1_ps(5.0000001201e-1f));
+    p = _mm256_fmadd_ps(p, _mm256_mul_ps(r, r), _mm256_add_ps(r, _mm256_set1_ps(1.0f)));
+    const __m256i e = _mm256_slli_epi32(_mm256_add_epi32(_mm256_cvtps_epi32(n),
+                                                         _mm256_set1_epi32(127)), 23);
+    return _mm256_mul_ps(p, _mm256_castsi256_ps(e));
+}
+
+inline __m256 activation256_ps(__m256 x, int activation) {
+    switch (activation) {
+    case SIMD_ACT_RELU:
+        return _mm256_max_ps(x, _mm256_setzero_ps());
+    case SIMD_ACT_GELU: {
+        const __m256 x2 = _mm256_mul_ps(x, x);
+        const __m256 u = _mm256_mul_ps(_mm256_mul_ps(x, _mm256_set1_ps(-2.0f * GELU_K0)),
+                                       _mm256_fmadd_ps(x2, _mm256_set1_ps(GELU_K1),
+                                                       _mm256_set1_ps(1.0f)));
+        return _mm256_div_ps(x, _mm256_add_ps(_mm256_set1_ps(1.0f), exp256_ps(u)));
+    }
+    case SIMD_ACT_SILU:
+        return _mm256_div_ps(x, _mm256_add_ps(_mm256_set1_ps(1.0f),
+                                              exp256_ps(_mm256_sub_ps(_mm256_setzero_ps(), x))));
+    default:
+        return x;
+    }
+}
+
+#endif  // __AVX2__ && __FMA__
+
+#if defined(__AVX512F__)
+
+#if defined(__GNUC__) && !defined(__clang__)
+// GCC 12 对 _mm512_undefined_* 的 -Wmaybe-uninitialized 误报
+#pragma GCC diagnostic ignored "-Wmaybe-uninitialized"
+#endif
+
+inline __m512 exp512_ps(__m512 x) {
+    x = _mm512_min_ps(_mm512_max_ps(x, _mm512_set1_ps(-87.3f)), _mm512_set1_ps(88.3f));
+    const __m512 n = _mm512_roundscale_ps(_mm512_mul_ps(x, _mm512_set1_ps(1.44269504f)),
+                                          _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC);
+    __m512 r = _mm512_fnmadd_ps(n, _mm512_set1_ps(0.693359375f), x);
+    r = _mm512_fnmadd_ps(n, _mm512_set1_ps(-2.12194440e-4f), r);
+    __m512 p = _mm512_set1_ps(1.9875691500e-4f);
+    p = _mm512_fmadd_ps(p, r, _mm512_set1_ps(1.3981999507e-3f));
+    p = _mm512_fmadd_ps(p, r, _mm512_set1_ps(8.3334519073e-3f));
+    p = _mm512_fmadd_ps(p, r, _mm512_set1_ps(4.1665795894e-2f));
+    p = _mm512_fmadd_ps(p, r, _mm512_set1_ps(1.6666665459e-1f));
+    p = _mm512_fmadd_ps(p, r, _mm512_set1_ps(5.0000001201e-1f));
+    p = _mm512_fmadd_ps(p, _mm512_mul_ps(r, r), _mm512_add_ps(r, _mm512_set1_ps(1.0f)));
+    return _mm512_scalef_ps(p, n);
+}
+
+inline __m512 activation512_ps(__m512 x, int activation) {
+    switch (activation) {
+    case SIMD_ACT_RELU:
+        return _mm512_max_ps(x, _mm512_setzero_ps());
+    case SIMD_ACT_GELU: {
+        const __m512 x2 = _mm512_mul_ps(x, x);
+        const __m512 u = _mm512_mul_ps(_mm512_mul_ps(x, _mm512_set1_ps(-2.0f * GELU_K0)),
+                                       _mm512_fmadd_ps(x2, _mm512_set1_ps(GELU_K1),
+                                                       _mm512_set1_ps(1.0f)));
+        return _mm512_div_ps(x, _mm512_add_ps(_mm512_set1_ps(1.0f), exp512_ps(u)));
+    }
+    case SIMD_ACT_SILU:
+        return _mm512_div_ps(x, _mm512_add_ps(_mm512_set1_ps(1.0f),
+                                              exp512_ps(_mm512_sub_ps(_mm512_setzero_ps(), x))));
+    default:
+        return x;
+    }
+}
+
+#endif  // __AVX512F__
+
+}  // namespace simd_internal
+
+#endif // VISIONAI_SIMD_VECMATH_H
@@ -15,6 +15,7 @@ import logging
 from pathlib import Path
 import time
 import json
+import weakref
 
 # 项目根目录
 ROOT_DIR = Path(__file__).resolve().parent.parent.parent
@@ -32,7 +33,10 @@ else:  # Linux和其他类Unix系统
 
 # 尝试导入内存对齐模块
 try:
-    from src.hardware.memory_aligner import align_array, is_aligned, get_alignment_for_simd
+    from src.hardware.memory_aligner import (
+        align_array, is_aligned, get_alignment_for_simd,
+        register_native_pool, has_native_pool, pool_empty, NativeArena, NativeBlock
+    )
     HAS_MEMORY_ALIGNMENT = True
 except ImportError:
     HAS_MEMORY_ALIGNMENT = False
@@ -72,6 +76,903 @@ def load_simd_config() -> Dict:
         logger.error(f"加载SIMD配置失败: {str(e)}，使用默认配置")
         return default_config
 
+# simd_get_cpu_features 返回的特性位 (对应 simd_kernels.h 中的 SIMD_CPU_*)
+CPU_FEATURES = ("sse4.2", "avx", "avx2", "fma", "f16c", "avx512f", "avx512bw", "avx512dq",
+                "avx512vl", "avx512vnni", "avxvnni", "neon")
+
+# GEMM 融合尾处理的激活函数 (对应 simd_kernels.h 中的 SIMD_ACT_*)
+GEMM_ACTIVATIONS = {None: 0, "none": 0, "relu": 1, "gelu": 2, "silu": 3}
+
+class SimdGemmEpilogue(ctypes.Structure):
+    """对应 simd_kernels.h 中的 SimdGemmEpilogue"""
+    _fields_ = [
+        ("alpha", ctypes.c_float),
+        ("beta", ctypes.c_float),
+        ("bias", ctypes.POINTER(ctypes.c_float)),
+        ("activation", ctypes.c_int),
+        ("residual", ctypes.POINTER(ctypes.c_float)),
+        ("ldr", ctypes.c_int),
+    ]
+
+class SimdCacheInfo(ctypes.Structure):
+    """对应 simd_kernels.h 中的 SimdCacheInfo"""
+    _fields_ = [
+        ("line_size", ctypes.c_int),
+        ("l1d_size", ctypes.c_longlong),
+        ("l1d_shared", ctypes.c_int),
+        ("l2_size", ctypes.c_longlong),
+        ("l2_shared", ctypes.c_int),
+        ("l3_size", ctypes.c_longlong),
+        ("l3_shared", ctypes.c_int),
+        ("source", ctypes.c_char_p),
+    ]
+
+class SimdGemmBlocking(ctypes.Structure):
+    """对应 simd_kernels.h 中的 SimdGemmBlocking"""
+    _fields_ = [(name, ctypes.c_int) for name in ("mr", "nr", "mc", "kc", "nc")]
+
+class SimdTuningResult(ctypes.Structure):
+    """对应 simd_kernels.h 中的 SimdTuningResult"""
+    _fields_ = [
+        ("kernel", ctypes.c_char_p),
+        ("mc", ctypes.c_int),
+        ("kc", ctypes.c_int),
+        ("nc", ctypes.c_int),
+        ("threads", ctypes.c_int),
+        ("gflops", ctypes.c_double),
+        ("tuned", ctypes.c_int),
+    ]
+
+    def to_dict(self) -> Dict:
+        result = {name: getattr(self, name) for name, _ in self._fields_}
+        result["kernel"] = self.kernel.decode("utf-8")
+        result["tuned"] = bool(self.tuned)
+        return result
+
+class SimdPoolStats(ctypes.Structure):
+    """对应 simd_kernels.h 中的 SimdPoolStats"""
+    _fields_ = [(name, ctypes.c_longlong)
+                for name in ("bytes_in_use", "bytes_cached", "os_allocs", "cache_hits")]
+
+class Int8PackedWeights:
+    """原生库打包的 INT8 权重句柄，对象销毁时释放"""
+    
+    def __init__(self, lib, handle: int, K: int, N: int):
+        self._lib = lib
+        self.handle = ctypes.c_void_p(handle)
+        self.K = K
+        self.N = N
+    
+    def __del__(self):
+        if self.handle:
+            self._lib.simd_int8_free_weights(self.handle)
+            self.handle = None
+
+class GemvPackedWeights:
+    """原生库打包的 GEMV 权重句柄 (每个 NUMA 节点一份大页副本)，对象销毁时释放"""
+    
+    def __init__(self, lib, handle: int, N: int, K: int):
+        self._lib = lib
+        self.handle = ctypes.c_void_p(handle)
+        self.N = N
+        self.K = K
+        self.replicas = lib.simd_gemv_weights_replicas(self.handle)
+    
+    def __del__(self):
+        if self.handle:
+            self._lib.simd_gemv_free_weights(self.handle)
+            self.handle = None
+
+# 大页/NUMA 区域的策略 (对应 simd_kernels.h 中的 SIMD_NUMA_*)
+NUMA_POLICIES = {None: 0, "default": 0, "bind": 1, "interleave": 2, "preferred": 3}
+MEM_HUGEPAGE, MEM_HUGETLB, MEM_POPULATE, MEM_NUMA = 1, 2, 4, 8
+
+# 融合逐元素表达式的操作码 (对应 simd_kernels.h 中的 SIMD_EW_*)
+EW_OPS = {"load": 0, "const": 1, "add": 2, "sub": 3, "mul": 4, "div": 5, "fma": 6,
+          "affine": 7, "min": 8, "max": 9, "clamp": 10, "act": 11}
+EW_MAX_REGS = 16
+
+class SimdEwInstr(ctypes.Structure):
+    """对应 simd_kernels.h 中的 SimdEwInstr"""
+    _fields_ = [
+        ("op", ctypes.c_int),
+        ("dst", ctypes.c_int),
+        ("a", ctypes.c_int),
+        ("b", ctypes.c_int),
+        ("c", ctypes.c_int),
+        ("p0", ctypes.c_float),
+        ("p1", ctypes.c_float),
+    ]
+
+class ElementwiseExpr:
+    """
+    融合逐元素表达式描述符
+    
+    用运算符组合输入即可构造整条链，例如
+        x, y, z = ElementwiseExpr.inputs(3)
+        expr = ((x * y + z) * 0.5).clamp(-1.0, 1.0).gelu()
+    SimdOperations.fused_elementwise 将其编译为寄存器字节码，在原生库中一次遍历求值；
+    a * b + c 自动合并为 fma，连续的标量缩放/偏移合并为一条 affine 指令
+    """
+    
+    def __init__(self, op: str, args: Tuple["ElementwiseExpr", ...] = (),
+                 p0: float = 0.0, p1: float = 0.0, index: int = 0):
+        self.op = op
+        self.args = args
+        self.p0 = p0
+        self.p1 = p1
+        self.index = index      # load 的输入序号或 act 的激活编号
+    
+    @staticmethod
+    def input(index: int) -> "ElementwiseExpr":
+        return ElementwiseExpr("load", index=index)
+    
+    @staticmethod
+    def inputs(count: int) -> List["ElementwiseExpr"]:
+        return [ElementwiseExpr.input(i) for i in range(count)]
+    
+    @staticmethod
+    def const(value: float) -> "ElementwiseExpr":
+        return ElementwiseExpr("const", p0=float(value))
+    
+    @staticmethod
+    def _wrap(x) -> "ElementwiseExpr":
+        return x if isinstance(x, ElementwiseExpr) else ElementwiseExpr.const(x)
+    
+    def affine(self, scale: float, shift: float = 0.0) -> "ElementwiseExpr":
+        """self * scale + shift"""
+        if self.op == "affine":
+            return ElementwiseExpr("affine", self.args, self.p0 * scale, self.p1 * scale + shift)
+        return ElementwiseExpr("affine", (self,), float(scale), float(shift))
+    
+    @staticmethod
+    def fma(a, b, c) -> "ElementwiseExpr":
+        w = ElementwiseExpr._wrap
+        return ElementwiseExpr("fma", (w(a), w(b), w(c)))
+    
+    def __add__(self, other):
+        if not isinstance(other, ElementwiseExpr):
+            return self.affine(1.0, other)
+        if self.op == "mul":
+            return ElementwiseExpr("fma", self.args + (other,))
+        if other.op == "mul":
+            return ElementwiseExpr("fma", other.args + (self,))
+        return ElementwiseExpr("add", (self, other))
+    
+    def __radd__(self, other):
+        return self.__add__(other)
+    
+    def __sub__(self, other):
+        if not isinstance(other, ElementwiseExpr):
+            return self.affine(1.0, -other)
+        return ElementwiseExpr("sub", (self, other))
+    
+    def __rsub__(self, other):
+        return self.affine(-1.0, other)
+    
+    def __mul__(self, other):
+        if not isinstance(other, ElementwiseExpr):
+            return self.affine(other, 0.0)
+        return ElementwiseExpr("mul", (self, other))
+    
+    def __rmul__(self, other):
+        return self.__mul__(other)
+    
+    def __truediv__(self, other):
+        if not isinstance(other, ElementwiseExpr):
+            return self.affine(1.0 / other, 0.0)
+        return ElementwiseExpr("div", (self, other))
+    
+    def __rtruediv__(self, other):
+        return ElementwiseExpr("div", (ElementwiseExpr.const(other), self))
+    
+    def __neg__(self):
+        return self.affine(-1.0, 0.0)
+    
+    def minimum(self, other) -> "ElementwiseExpr":
+        return ElementwiseExpr("min", (self, self._wrap(other)))
+    
+    def maximum(self, other) -> "ElementwiseExpr":
+        return ElementwiseExpr("max", (self, self._wrap(other)))
+    
+    def clamp(self, lo: float = -np.inf, hi: float = np.inf) -> "ElementwiseExpr":
+        return ElementwiseExpr("clamp", (self,), float(lo), float(hi))
+    
+    def activation(self, name: str) -> "ElementwiseExpr":
+        if name not in GEMM_ACTIVATIONS:
+            raise ValueError(f"不支持的激活函数: {name}")
+        return ElementwiseExpr("act", (self,), index=GEMM_ACTIVATIONS[name])
+    
+    def relu(self) -> "ElementwiseExpr":
+        return self.activation("relu")
+    
+    def gelu(self) -> "ElementwiseExpr":
+        return self.activation("gelu")
+    
+    def silu(self) -> "ElementwiseExpr":
+        return self.activation("silu")
+    
+    def compile(self) -> Tuple[List[Tuple], int, int]:
+        """
+        编译为寄存器字节码
+        
+        Returns:
+            (指令列表 [(op, dst, a, b, c, p0, p1)], 结果寄存器, 所需输入个数)
+            子表达式被多处引用时只计算一次，寄存器在最后一次使用后回收
+        """
+        order, uses, seen = [], {}, set()
+        stack = [(self, False)]
+        while stack:
+            node, expanded = stack.pop()
+            if expanded:
+                order.append(node)
+                continue
+            if id(node) in seen:
+                continue
+            seen.add(id(node))
+            stack.append((node, True))
+            for child in reversed(node.args):
+                stack.append((child, False))
+        for node in order:
+            for child in node.args:
+                uses[id(child)] = uses.get(id(child), 0) + 1
+        
+        free = list(range(EW_MAX_REGS))
+        reg, program, n_inputs = {}, [], 0
+        for node in order:
+            srcs = [reg[id(child)] for child in node.args]
+            for child in node.args:
+                uses[id(child)] -= 1
+                if uses[id(child)] == 0:
+                    free.append(reg[id(child)])
+            free.sort()
+            if not free:
+                raise ValueError(f"表达式所需寄存器超过 {EW_MAX_REGS} 个")
+            dst = free.pop(0)
+            reg[id(node)] = dst
+            srcs += [0] * (3 - len(srcs))
+            if node.op == "load":
+                srcs[0] = node.index
+                n_inputs = max(n_inputs, node.index + 1)
+            elif node.op == "act":
+                srcs[1] = node.index
+            program.append((EW_OPS[node.op], dst, srcs[0], srcs[1], srcs[2], node.p0, node.p1))
+        return program, reg[id(self)], n_inputs
+
+def _activation_numpy(x: np.ndarray, kind: int) -> np.ndarray:
+    """NumPy 激活函数 (kind 为 GEMM_ACTIVATIONS 中的编号，GELU 为 tanh 近似)"""
+    if kind == GEMM_ACTIVATIONS["relu"]:
+        return np.maximum(x, 0)
+    if kind == GEMM_ACTIVATIONS["gelu"]:
+        return 0.5 * x * (1 + np.tanh(0.7978845608 * (x + 0.044715 * x ** 3)))
+    if kind == GEMM_ACTIVATIONS["silu"]:
+        return x / (1 + np.exp(-x))
+    return x
+
+def _eval_ew_program_numpy(program: List[Tuple], out_reg: int, arrays: List[np.ndarray]) -> np.ndarray:
+    """用 NumPy 解释执行字节码 (原生库不可用时的回退路径)"""
+    act = _activation_numpy
+    
+    r = {}
+    for op, dst, a, b, c, p0, p1 in program:
+        if op == EW_OPS["load"]:
+            r[dst] = arrays[a]
+        elif op == EW_OPS["const"]:
+            r[dst] = np.float32(p0)
+        elif op == EW_OPS["add"]:
+            r[dst] = r[a] + r[b]
+        elif op == EW_OPS["sub"]:
+            r[dst] = r[a] - r[b]
+        elif op == EW_OPS["mul"]:
+            r[dst] = r[a] * r[b]
+        elif op == EW_OPS["div"]:
+            r[dst] = r[a] / r[b]
+        elif op == EW_OPS["fma"]:
+            r[dst] = r[a] * r[b] + r[c]
+        elif op == EW_OPS["affine"]:
+            r[dst] = r[a] * np.float32(p0) + np.float32(p1)
+        elif op == EW_OPS["min"]:
+            r[dst] = np.minimum(r[a], r[b])
+        elif op == EW_OPS["max"]:
+            r[dst] = np.maximum(r[a], r[b])
+        elif op == EW_OPS["clamp"]:
+            r[dst] = np.clip(r[a], p0, p1)
+        elif op == EW_OPS["act"]:
+            r[dst] = act(r[a], b)
+    return r[out_reg]
+
+# 归约操作 (对应 simd_kernels.h 中的 SIMD_REDUCE_*)
+REDUCE_OPS = {"sum": 0, "mean": 1, "max": 2, "min": 3, "l1": 4, "l2": 5, "var": 6}
+
+def _reduce_numpy(x: np.ndarray, op: str, axis: Optional[int]):
+    """NumPy 归约 (原生库不可用时的回退路径)"""
+    if op == "l1":
+        result = np.sum(np.abs(x), axis=axis)
+    elif op == "l2":
+        result = np.sqrt(np.sum(np.square(x), axis=axis))
+    else:
+        result = getattr(np, op)(x, axis=axis)
+    return float(result) if axis is None else result
+
+def _softmax_numpy(x: np.ndarray, scale: float) -> np.ndarray:
+    """NumPy 按最后一维 softmax (原生库不可用时的回退路径)"""
+    if x.shape[-1] == 0:
+        return np.zeros(x.shape, dtype=np.float32)
+    z = x * np.float32(scale)
+    m = np.max(z, axis=-1, keepdims=True)
+    e = np.exp(z - np.where(np.isneginf(m), 0, m))
+    d = np.sum(e, axis=-1, keepdims=True)
+    return np.divide(e, d, out=np.zeros_like(e), where=d > 0)
+
+def _rope_numpy(x: np.ndarray, cos: np.ndarray, sin: np.ndarray, interleaved: bool):
+    """NumPy 原地旋转位置编码，x 为 (..., seq, head_dim)，cos/sin 为 (seq, rotary_dim / 2)"""
+    half = cos.shape[-1]
+    if interleaved:
+        x0, x1 = x[..., 0:2 * half:2], x[..., 1:2 * half:2]
+    else:
+        x0, x1 = x[..., :half], x[..., half:2 * half]
+    r0 = x0 * cos - x1 * sin
+    r1 = x1 * cos + x0 * sin
+    x0[...] = r0
+    x1[...] = r1
+
+class SimdAttentionParams(ctypes.Structure):
+    """对应 simd_kernels.h 中的 SimdAttentionParams (步长以元素计)"""
+    _fields_ = [
+        ("n_q", ctypes.c_int),
+        ("n_kv", ctypes.c_int),
+        ("head_dim", ctypes.c_int),
+        ("n_heads", ctypes.c_int),
+        ("n_kv_heads", ctypes.c_int),
+        ("q_token_stride", ctypes.c_longlong),
+        ("q_head_stride", ctypes.c_longlong),
+        ("k_token_stride", ctypes.c_longlong),
+        ("k_head_stride", ctypes.c_longlong),
+        ("v_token_stride", ctypes.c_longlong),
+        ("v_head_stride", ctypes.c_longlong),
+        ("o_token_stride", ctypes.c_longlong),
+        ("o_head_stride", ctypes.c_longlong),
+        ("scale", ctypes.c_float),
+        ("causal", ctypes.c_int),
+    ]
+
+def _attention_numpy(q: np.ndarray, k: np.ndarray, v: np.ndarray, causal: bool,
+                     scale: float) -> np.ndarray:
+    """NumPy 注意力 (显式构造分数矩阵，原生库不可用时的回退路径)"""
+    group = q.shape[0] // k.shape[0]
+    k = np.repeat(k, group, axis=0)
+    v = np.repeat(v, group, axis=0)
+    scores = np.matmul(q, np.swapaxes(k, -1, -2)) * np.float32(scale)
+    if causal:
+        n_q, n_kv = scores.shape[-2:]
+        visible = np.arange(n_kv)[None, :] <= np.arange(n_q)[:, None] + (n_kv - n_q)
+        scores = np.where(visible, scores, -np.inf)
+    return np.matmul(_softmax_numpy(scores, 1.0), v).astype(np.float32)
+
+class SimdKvCacheConfig(ctypes.Structure):
+    """对应 simd_kernels.h 中的 SimdKvCacheConfig"""
+    _fields_ = [
+        ("n_layers", ctypes.c_int),
+        ("n_kv_heads", ctypes.c_int),
+        ("head_dim", ctypes.c_int),
+        ("block_size", ctypes.c_int),
+        ("n_blocks", ctypes.c_int),
+        ("dtype", ctypes.c_int),
+    ]
+
+class SimdKvCacheStats(ctypes.Structure):
+    """对应 simd_kernels.h 中的 SimdKvCacheStats"""
+    _fields_ = [
+        ("total_blocks", ctypes.c_int),
+        ("free_blocks", ctypes.c_int),
+        ("cached_blocks", ctypes.c_int),
+        ("used_blocks", ctypes.c_int),
+        ("prefix_blocks", ctypes.c_int),
+        ("block_bytes", ctypes.c_longlong),
+    ]
+
+SIMD_TENSOR_MAX_DIMS = 8
+
+class SimdTensorInfo(ctypes.Structure):
+    """对应 simd_kernels.h 中的 SimdTensorInfo"""
+    _fields_ = [
+        ("name", ctypes.c_char_p),
+        ("dtype", ctypes.c_char_p),
+        ("ndim", ctypes.c_int),
+        ("shape", ctypes.c_longlong * SIMD_TENSOR_MAX_DIMS),
+        ("data", ctypes.c_void_p),
+        ("nbytes", ctypes.c_longlong),
+        ("shard", ctypes.c_int),
+        ("alignment", ctypes.c_int),
+    ]
+
+# safetensors 类型名到 NumPy 类型 (BF16 与 FP8 以无符号整数位模式返回)
+SAFETENSORS_DTYPES = {
+    "F64": np.float64, "F32": np.float32, "F16": np.float16, "BF16": np.uint16,
+    "I64": np.int64, "I32": np.int32, "I16": np.int16, "I8": np.int8,
+    "U64": np.uint64, "U32": np.uint32, "U16": np.uint16, "U8": np.uint8,
+    "BOOL": np.bool_, "F8_E4M3": np.uint8, "F8_E5M2": np.uint8,
+}
+
+class _MappedView:
+    """映射内存的只读持有者: 数组以本对象为 base，存活期间保持张量存储打开"""
+    
+    def __init__(self, store: "TensorStore", ptr: int, nbytes: int):
+        self.store = store
+        self.__array_interface__ = {
+            'shape': (nbytes,),
+            'typestr': '|u1',
+            'data': (ptr or 0, True),
+            'version': 3,
+        }
+
+class TensorStore:
+    """
+    原生零拷贝张量存储句柄 (只读 mmap 的 safetensors 分片)
+    
+    store[name] 返回直接指向映射内存的只读 NumPy 数组，可不经复制传给 gemv/gemv_q8 等；
+    页面在首次读取时才从磁盘载入。逐层推理时可在计算第 N 层前 prefetch 第 N+1 层的前缀，
+    用完的层 release 后从 RSS 中移除。所有数组回收后存储才会关闭
+    """
+    
+    def __init__(self, lib, path: str):
+        self._lib = lib
+        self.handle = None
+        handle = lib.simd_tensor_store_open(os.fsencode(str(path)))
+        if not handle:
+            raise OSError(f"无法打开张量存储: {lib.simd_tensor_store_error().decode('utf-8')}")
+        self.handle = ctypes.c_void_p(handle)
+        self.path = str(path)
+    
+    def __del__(self):
+        if self.handle:
+            self._lib.simd_tensor_store_close(self.handle)
+            self.handle = None
+    
+    def __len__(self) -> int:
+        return self._lib.simd_tensor_store_count(self.handle)
+    
+    def __contains__(self, name: str) -> bool:
+        return self._lib.simd_tensor_store_find(self.handle, name.encode('utf-8')) >= 0
+    
+    def _info(self, index: int) -> SimdTensorInfo:
+        info = SimdTensorInfo()
+        self._lib.simd_tensor_store_info(self.handle, index, ctypes.byref(info))
+        return info
+    
+    def names(self) -> List[str]:
+        """按文件位置排列的张量名"""
+        return [self._info(i).name.decode('utf-8') for i in range(len(self))]
+    
+    def info(self, name: str) -> Dict:
+        """张量的 dtype、shape、字节数、所在分片与地址对齐"""
+        index = self._lib.simd_tensor_store_find(self.handle, name.encode('utf-8'))
+        if index < 0:
+            raise KeyError(name)
+        info = self._info(index)
+        return {"dtype": info.dtype.decode('utf-8'), "shape": tuple(info.shape[:info.ndim]),
+                "nbytes": info.nbytes, "shard": info.shard, "alignment": info.alignment}
+    
+    def __getitem__(self, name: str) -> np.ndarray:
+        index = self._lib.simd_tensor_store_find(self.handle, name.encode('utf-8'))
+        if index < 0:
+            raise KeyError(name)
+        info = self._info(index)
+        dtype_name = info.dtype.decode('utf-8')
+        dtype = np.dtype(SAFETENSORS_DTYPES.get(dtype_name, np.uint8))
+        shape = tuple(info.shape[:info.ndim])
+        raw = np.asarray(_MappedView(self, info.data, info.nbytes))
+        if dtype_name not in SAFETENSORS_DTYPES:
+            return raw      # 未知类型按字节返回
+        return raw.view(dtype).reshape(shape)
+    
+    def get(self, name: str, default=None) -> Optional[np.ndarray]:
+        return self[name] if name in self else default
+    
+    def prefetch(self, prefix: str = "") -> int:
+        """对名称以 prefix 开头的张量发起异步预读 (madvise WILLNEED)，返回张量数"""
+        return self._advise(self._lib.simd_tensor_store_prefetch, prefix)
+    
+    def release(self, prefix: str = "") -> int:
+        """把名称以 prefix 开头的张量从 RSS 中释放 (数组仍可访问，内容从页缓存重新映射)"""
+        return self._advise(self._lib.simd_tensor_store_release, prefix)
+    
+    def _advise(self, fn, prefix: str) -> int:
+        count = fn(self.handle, prefix.encode('utf-8'))
+        if count < 0:
+            raise OSError(self._lib.simd_tensor_store_error().decode('utf-8'))
+        return count
+    
+    def resident_bytes(self, prefix: str = "") -> int:
+        """名称以 prefix 开头的张量已在页缓存中 (访问时无需读盘) 的字节数，不支持时返回 -1"""
+        return self._lib.simd_tensor_store_resident(self.handle, prefix.encode('utf-8'))
+
+class SimdPrefetchStats(ctypes.Structure):
+    """对应 simd_kernels.h 中的 SimdPrefetchStats"""
+    _fields_ = [(name, ctypes.c_longlong)
+                for name in ("bytes_read", "batches", "helped_chunks", "stall_us")]
+
+class _SlotView:
+    """预取槽位缓冲区的只读持有者: 数组以本对象为 base，存活期间槽位不能 release"""
+    
+    def __init__(self, prefetcher: "WeightPrefetcher", ptr: int, nbytes: int):
+        self.prefetcher = prefetcher
+        self.__array_interface__ = {
+            'shape': (nbytes,),
+            'typestr': '|u1',
+            'data': (ptr or 0, True),
+            'version': 3,
+        }
+
+class WeightPrefetcher:
+    """
+    原生逐层权重预取器: 后台 I/O 线程用 pread 把下一层权重读入固定数量的槽位缓冲区
+    
+    典型流程 (两个槽位):
+        slot = pf.submit(store, "model.layers.0.")
+        for i in range(n_layers):
+            nxt = pf.submit(store, f"model.layers.{i + 1}.") if i + 1 < n_layers else None
+            weights = pf.acquire(slot)      # 第 i 层已在缓冲区中
+            ...计算第 i 层...
+            del weights
+            pf.release(slot)
+            slot = nxt
+    acquire 返回的数组在 release 前有效，仍被引用时 release 与 close 会拒绝 (除非 force=True)
+    """
+    
+    def __init__(self, lib, n_slots: int = 2, slot_bytes: int = 256 << 20, n_threads: int = 2):
+        self._lib = lib
+        self.handle = None
+        self._batches = {}      # 槽位 -> [(名称, dtype 名, shape, 字节数)]
+        self._views = {}        # 槽位 -> 每次 acquire 的持有者弱引用列表
+        handle = lib.simd_prefetcher_create(n_slots, slot_bytes, n_threads)
+        if not handle:
+            raise MemoryError(f"无法创建预取器 ({n_slots} x {slot_bytes} 字节)")
+        self.handle = ctypes.c_void_p(handle)
+        self.slot_bytes = slot_bytes
+    
+    def __del__(self):
+        self.close()
+    
+    def close(self, force: bool = False):
+        """
+        停止 I/O 线程并释放缓冲区
+        
+        Args:
+            force: 为 True 时即使 acquire 返回的数组仍被引用也释放 (调用方保证不再访问)
+        """
+        if not force and any(ref() is not None for refs in self._views.values() for ref in refs):
+            raise RuntimeError("仍有数组引用预取缓冲区，不能 close")
+        handle, self.handle = self.handle, None
+        if handle:
+            self._lib.simd_prefetcher_destroy(handle)
+    
+    def submit(self, store: TensorStore, prefix: str) -> int:
+        """提交名称以 prefix 开头的张量的后台读取，返回槽位号"""
+        tensors = []
+        for i in range(len(store)):
+            info = store._info(i)
+            name = info.name.decode('utf-8')
+            if name.startswith(prefix):
+                tensors.append((name, info.dtype.decode('utf-8'), tuple(info.shape[:info.ndim]),
+                                info.nbytes))
+        slot = self._lib.simd_prefetcher_submit_tensors(self.handle, store.handle,
+                                                        prefix.encode('utf-8'))
+        if slot == -1:
+            raise RuntimeError("没有空闲的预取槽位，请先 release")
+        if slot < 0:
+            raise ValueError(f"无法预取 '{prefix}': 没有匹配的张量、超过槽位容量或文件无法打开")
+        self._batches[slot] = tensors
+        return slot
+    
+    def ready(self, slot: int) -> bool:
+        return self._lib.simd_prefetcher_ready(self.handle, slot) == 1
+    
+    def acquire(self, slot: int, timeout: Optional[float] = None) -> Dict[str, np.ndarray]:
+        """
+        等待槽位读完并返回 {名称: 只读数组}；未就绪时调用线程会帮忙读取剩余部分
+        
+        Args:
+            timeout: 等待秒数，None 表示一直等待
+        """
+        timeout_ms = -1 if timeout is None else max(1, int(timeout * 1000))
+        ptr = self._lib.simd_prefetcher_acquire(self.handle, slot, timeout_ms)
+        if not ptr:
+            raise TimeoutError(f"预取槽位 {slot} 读取失败或超时")
+        holder = _SlotView(self, ptr, self.slot_bytes)
+        # 同一槽位可多次 acquire，每次的数组都要在 release 前失效
+        refs = [ref for ref in self._views.get(slot, []) if ref() is not None]
+        refs.append(weakref.ref(holder))
+        self._views[slot] = refs
+        raw = np.asarray(holder)
+        arrays = {}
+        for i, (name, dtype_name, shape, nbytes) in enumerate(self._batches.get(slot, [])):
+            offset = self._lib.simd_prefetcher_offset(self.handle, slot, i)
+            data = raw[offset:offset + nbytes]
+            if dtype_name not in SAFETENSORS_DTYPES:
+                arrays[name] = data     # 未知类型按字节返回
+            else:
+                arrays[name] = data.view(SAFETENSORS_DTYPES[dtype_name]).reshape(shape)
+        return arrays
+    
+    def release(self, slot: int, force: bool = False):
+        """
+        归还槽位供下一次 submit 使用
+        
+        Args:
+            force: 为 True 时即使 acquire 返回的数组仍被引用也归还 (调用方保证不再访问)
+        """
+        if not force and any(ref() is not None for ref in self._views.get(slot, [])):
+            raise RuntimeError(f"仍有数组引用预取槽位 {slot}，不能 release")
+        self._views.pop(slot, None)
+        self._batches.pop(slot, None)
+        self._lib.simd_prefetcher_release(self.handle, slot)
+    
+    def get_stats(self) -> Dict[str, int]:
+        """返回 bytes_read、batches、helped_chunks (由 acquire 线程读取的块) 与 stall_us"""
+        stats = SimdPrefetchStats()
+        self._lib.simd_prefetcher_stats(self.handle, ctypes.byref(stats))
+        return {name: getattr(stats, name) for name, _ in SimdPrefetchStats._fields_}
+
+# KV 缓存存储类型 (对应 simd_kernels.h 中的 SIMD_KV_*)
+KV_DTYPES = {"f32": 0, "int8": 1, "fp8": 2}
+
+class PagedKvCache:
+    """
+    原生分页 KV 缓存句柄，对象销毁时释放
+    
+    K/V 的形状约定与 SimdOperations.attention 相同: (n_kv_heads, n_tokens, head_dim)。
+    典型流程: create_sequence -> match_prefix(提示词) -> append(未命中的 token) ->
+    逐层 write 后调用 attention；会话结束时 free_sequence，满块仍保留供后续会话复用
+    """
+    
+    def __init__(self, lib, handle: int, config: SimdKvCacheConfig):
+        self._lib = lib
+        self.handle = ctypes.c_void_p(handle)
+        self.n_layers = config.n_layers
+        self.n_kv_heads = config.n_kv_heads
+        self.head_dim = config.head_dim
+        self.block_size = config.block_size
+        self.n_blocks = config.n_blocks
+        self.dtype = next(k for k, v in KV_DTYPES.items() if v == config.dtype)
+    
+    def __del__(self):
+        if self.handle:
+            self._lib.simd_kv_cache_destroy(self.handle)
+            self.handle = None
+    
+    def create_sequence(self) -> int:
+        seq = self._lib.simd_kv_cache_seq_create(self.handle)
+        if seq < 0:
+            raise RuntimeError("创建KV缓存序列失败")
+        return seq
+    
+    def free_sequence(self, seq: int):
+        if self._lib.simd_kv_cache_seq_free(self.handle, seq) != 0:
+            raise ValueError(f"无效的KV缓存序列: {seq}")
+    
+    def length(self, seq: int) -> int:
+        n = self._lib.simd_kv_cache_seq_length(self.handle, seq)
+        if n < 0:
+            raise ValueError(f"无效的KV缓存序列: {seq}")
+        return n
+    
+    @staticmethod
+    def _tokens(tokens) -> np.ndarray:
+        return np.ascontiguousarray(tokens, dtype=np.int32).reshape(-1)
+    
+    def match_prefix(self, seq: int, tokens) -> int:
+        """空序列复用已缓存的最长满块前缀，返回复用的 token 数 (调用方只需计算其后的部分)"""
+        tokens = self._tokens(tokens)
+        n = self._lib.simd_kv_cache_seq_match_prefix(
+            self.handle, seq, tokens.ctypes.data_as(ctypes.POINTER(ctypes.c_int)), len(tokens))
+        if n < 0:
+            raise ValueError(f"前缀匹配失败: 序列 {seq} 无效或非空")
+        return n
+    
+    def append(self, seq: int, tokens=None, n: Optional[int] = None) -> int:
+        """
+        追加位置并返回第一个新位置；提供 tokens 时满块写完最后一层后登记为可复用前缀
+        
+        Raises:
+            MemoryError: 池中块不足 (可先释放结束的会话)
+        """
+        if tokens is not None:
+            tokens = self._tokens(tokens)
+            ptr, n = tokens.ctypes.data_as(ctypes.POINTER(ctypes.c_int)), len(tokens)
+        elif n is None:
+            raise ValueError("append 需要 tokens 或 n")
+        else:
+            ptr = None
+        pos = self._lib.simd_kv_cache_seq_append(self.handle, seq, ptr, int(n))
+        if pos == -2:
+            raise MemoryError(f"KV缓存块不足: 需要追加 {n} 个位置")
+        if pos < 0:
+            raise ValueError(f"无效的KV缓存序列: {seq}")
+        return pos
+    
+    def _operand(self, x: np.ndarray, name: str) -> np.ndarray:
+        x = SimdOperations._attention_operand(x, name)
+        if x.shape[0] != self.n_kv_heads or x.shape[2] != self.head_dim:
+            raise ValueError(f"{name} 的形状应为 ({self.n_kv_heads}, n, {self.head_dim}): {x.shape}")
+        return x
+    
+    def write(self, seq: int, layer: int, pos: int, k: np.ndarray, v: np.ndarray):
+        """写入第 layer 层从 pos 开始的 K/V，形状 (n_kv_heads, n, head_dim)"""
+        k = self._operand(k, "k")
+        v = self._operand(v, "v")
+        if k.shape != v.shape:
+            raise ValueError(f"k/v 形状不一致: {k.shape} vs {v.shape}")
+        status = self._lib.simd_kv_cache_write(
+            self.handle, seq, layer, pos, k.shape[1],
+            SimdOperations._float_ptr(k), k.strides[1] // 4, k.strides[0] // 4,
+            SimdOperations._float_ptr(v), v.strides[1] // 4, v.strides[0] // 4)
+        if status != 0:
+            raise ValueError(f"KV缓存写入失败: 序列 {seq}，层 {layer}，位置 [{pos}, {pos + k.shape[1]})")
+    
+    def read(self, seq: int, layer: int, pos: int = 0,
+             n: Optional[int] = None) -> Tuple[np.ndarray, np.ndarray]:
+        """读出第 layer 层的 K/V (量化缓存反量化为 float32)"""
+        if n is None:
+            n = self.length(seq) - pos
+        k = np.empty((self.n_kv_heads, n, self.head_dim), dtype=np.float32)
+        v = np.empty_like(k)
+        status = self._lib.simd_kv_cache_read(
+            self.handle, seq, layer, pos, n,
+            SimdOperations._float_ptr(k), self.head_dim, n * self.head_dim,
+            SimdOperations._float_ptr(v), self.head_dim, n * self.head_dim)
+        if status != 0:
+            raise ValueError(f"KV缓存读取失败: 序列 {seq}，层 {layer}，位置 [{pos}, {pos + n})")
+        return k, v
+    
+    def attention(self, q: np.ndarray, seq: int, layer: int, causal: bool = True,
+                  scale: Optional[float] = None, out: Optional[np.ndarray] = None) -> np.ndarray:
+        """
+        直接读取缓存块的融合注意力，键值为序列 seq 第 layer 层的全部位置
+        
+        Args:
+            q: (n_heads, n_q, head_dim)，二维时视为单头；n_kv_heads 须整除 n_heads
+            causal: 查询 i 只看到键 j <= i + n_kv - n_q（新 token 已追加并写入时即为自回归掩码）
+        """
+        squeeze = np.ndim(q) == 2
+        qa = SimdOperations._attention_operand(q, "q")
+        n_heads, n_q, d = qa.shape
+        if d != self.head_dim or n_heads % self.n_kv_heads:
+            raise ValueError(f"q 形状 {qa.shape} 与缓存 ({self.n_kv_heads} 头, {self.head_dim} 维) 不匹配")
+        if out is None:
+            result = np.empty(qa.shape, dtype=np.float32)
+        else:
+            result = out[None] if squeeze else out
+            if (not isinstance(out, np.ndarray) or out.dtype != np.float32
+                    or result.shape != qa.shape or result.strides[-1] != 4):
+                raise ValueError(f"out 必须是形状为 {np.shape(q)}、最后一维连续的float32数组")
+        scale = 1.0 / np.sqrt(d) if scale is None else float(scale)
+        st = lambda x: [x.strides[1] // 4, x.strides[0] // 4]
+        params = SimdAttentionParams(n_q, 0, d, n_heads, self.n_kv_heads, *st(qa),
+                                     0, 0, 0, 0, *st(result), scale, int(causal))
+        status = self._lib.simd_attention_paged(ctypes.byref(params), SimdOperations._float_ptr(qa),
+                                                self.handle, seq, layer,
+                                                SimdOperations._float_ptr(result))
+        if status == -2:
+            raise MemoryError("分页注意力分配缓冲区失败")
+        if status != 0:
+            raise ValueError(f"分页注意力参数无效: 序列 {seq}，层 {layer}")
+        return result[0] if squeeze else result
+    
+    def stats(self) -> Dict:
+        st = SimdKvCacheStats()
+        self._lib.simd_kv_cache_stats(self.handle, ctypes.byref(st))
+        return {name: getattr(st, name) for name, _ in SimdKvCacheStats._fields_}
+
+class SimdSamplerParams(ctypes.Structure):
+    """对应 simd_kernels.h 中的 SimdSamplerParams"""
+    _fields_ = [
+        ("temperature", ctypes.c_float),
+        ("top_k", ctypes.c_int),
+        ("top_p", ctypes.c_float),
+        ("repetition_penalty", ctypes.c_float),
+        ("presence_penalty", ctypes.c_float),
+        ("frequency_penalty", ctypes.c_float),
+    ]
+
+_U64_MASK = (1 << 64) - 1
+
+def _splitmix_uniform(state: ctypes.c_ulonglong) -> float:
+    """与原生采样器相同的 splitmix64，返回 [0, 1) 均匀数并推进状态"""
+    state.value = (state.value + 0x9E3779B97F4A7C15) & _U64_MASK
+    z = state.value
+    z = ((z ^ (z >> 30)) * 0xBF58476D1CE4E5B9) & _U64_MASK
+    z = ((z ^ (z >> 27)) * 0x94D049BB133111EB) & _U64_MASK
+    z ^= z >> 31
+    return (z >> 11) / float(1 << 53)
+
+def _sample_numpy(logits: np.ndarray, history: np.ndarray, p: SimdSamplerParams,
+                  state: ctypes.c_ulonglong) -> int:
+    """NumPy 采样 (与 simd_sample 相同的处理顺序与截取规则，原生库不可用时的回退路径)"""
+    x = logits.astype(np.float32)
+    vocab = len(x)
+    if len(history):
+        ids, counts = np.unique(history, return_counts=True)
+        v = x[ids]
+        if p.repetition_penalty != 1.0:
+            v = np.where(v < 0, v * np.float32(p.repetition_penalty), v / np.float32(p.repetition_penalty))
+        x[ids] = v - np.float32(p.presence_penalty) - np.float32(p.frequency_penalty) * counts
+    if p.temperature <= 0:
+        return int(np.argmax(x))
+    if 0 < p.top_k < vocab:
+        idx = np.argpartition(-x, p.top_k - 1)[:p.top_k]
+        cand = idx[np.lexsort((idx, -x[idx]))]
+        w = np.exp((x[cand] - x[cand[0]]) / np.float32(p.temperature))
+        total = float(w.sum(dtype=np.float64))
+    else:
+        m = x.max()
+        y = np.exp(x / np.float32(p.temperature) - m / np.float32(p.temperature))
+        total = float(y.sum(dtype=np.float64))
+        if p.top_p < 1.0:
+            # 核: 概率不小于降序累计质量首次达到 top_p 处的全部 token，按 token 顺序抽样
+            w = np.sort(y[y >= (1.0 - p.top_p) * total / vocab])[::-1]
+            cum = np.cumsum(w, dtype=np.float64)
+            y = np.where(y >= w[min(int(np.searchsorted(cum, p.top_p * total)), len(w) - 1)], y, 0)
+            total = float(y.sum(dtype=np.float64))
+        cum = np.cumsum(y, dtype=np.float64)
+        i = int(np.searchsorted(cum, _splitmix_uniform(state) * total, side="right"))
+        return i if i < vocab else int(np.nonzero(y)[0][-1])
+    cum = np.cumsum(w, dtype=np.float64)
+    limit = p.top_p * total if p.top_p < 1.0 else total
+    n = min(int(np.searchsorted(cum, limit, side="left")) + 1, len(cand))
+    u = _splitmix_uniform(state) * cum[n - 1]
+    return int(cand[min(int(np.searchsorted(cum[:n], u, side="right")), n - 1)])
+
+class TokenSampler:
+    """
+    logits 处理与采样器: 惩罚 -> 温度 -> top-k -> top-p -> 抽样 (HF 顺序)，不修改 logits。
+    随机数状态随调用推进，相同种子得到相同的 token 序列；原生库不可用时以 NumPy 执行同一流程
+    """
+    
+    def __init__(self, lib, temperature: float = 1.0, top_k: int = 0, top_p: float = 1.0,
+                 repetition_penalty: float = 1.0, presence_penalty: float = 0.0,
+                 frequency_penalty: float = 0.0, seed: int = 0):
+        if not 0.0 < top_p <= 1.0:
+            raise ValueError(f"top_p 必须在 (0, 1] 内: {top_p}")
+        if repetition_penalty <= 0:
+            raise ValueError(f"repetition_penalty 必须为正: {repetition_penalty}")
+        self._lib = lib
+        self.params = SimdSamplerParams(temperature, top_k, top_p, repetition_penalty,
+                                        presence_penalty, frequency_penalty)
+        self.state = ctypes.c_ulonglong(seed & _U64_MASK)
+        self._no_history = np.zeros(0, dtype=np.int32)
+    
+    def __call__(self, logits: np.ndarray, history=None) -> int:
+        """
+        Args:
+            logits: 一维 logits (词表大小)
+            history: 已生成/提示词 token id，用于惩罚
+            
+        Returns:
+            int: 采样得到的 token id
+        """
+        if not isinstance(logits, np.ndarray) or logits.dtype != np.float32 or not logits.flags.c_contiguous:
+            logits = np.ascontiguousarray(logits, dtype=np.float32)
+        if logits.ndim != 1 or len(logits) == 0:
+            raise ValueError(f"logits 必须是非空一维数组: {logits.shape}")
+        if history is None:
+            history = self._no_history
+        elif not isinstance(history, np.ndarray) or history.dtype != np.int32 or not history.flags.c_contiguous:
+            history = np.ascontiguousarray(history, dtype=np.int32).reshape(-1)
+        
+        if self._lib is not None:
+            token = self._lib.simd_sample(logits.ctypes.data, len(logits), history.ctypes.data,
+                                          len(history), ctypes.byref(self.params),
+                                          ctypes.byref(self.state))
+            if token < 0:
+                raise ValueError("采样失败: 参数非法、history 越界或 logits 中没有有限值")
+            return token
+        
+        # 回退到NumPy
+        if len(history) and (history.min() < 0 or history.max() >= len(logits)):
+            raise ValueError("history 中的 token id 超出词表范围")
+        return _sample_numpy(logits, history, self.params, self.state)
+
 class SimdOperations:
     """SIMD优化的矩阵和向量操作"""
     
@@ -115,11 +1016,11 @@ class SimdOperations:
         try:
             if _check_simd_lib_exists():
                 self.simd_lib = ctypes.CDLL(SIMD_LIB_PATH)
+                self.simd_lib_loaded = True
                 
-                # 设置函数参数和返回类型
+                # 设置函数参数和返回类型 (失败时会重置加载标志)
                 self._setup_function_signatures()
                 
-                self.simd_lib_loaded = True
                 logger.info(f"已加载SIMD库: {SIMD_LIB_PATH}")
             else:
                 # 使用mock实现 (纯Python)
@@ -147,6 +1048,49 @@ class SimdOperations:
             ]
             self.simd_lib.dispatch_matrix_multiply.restype = None
             
+            self.simd_lib.dispatch_matrix_multiply_epilogue.argtypes = [
+                ctypes.POINTER(ctypes.c_float),
+                ctypes.POINTER(ctypes.c_float),
+                ctypes.POINTER(ctypes.c_float),
+                ctypes.c_int,
+                ctypes.c_int,
+                ctypes.c_int,
+                ctypes.POINTER(SimdGemmEpilogue),
+                ctypes.c_char_p
+            ]
+            self.simd_lib.dispatch_matrix_multiply_epilogue.restype = None
+            
+            self.simd_lib.simd_sgemm.argtypes = [
+                ctypes.c_int, ctypes.c_int, ctypes.c_int, ctypes.c_int, ctypes.c_int, ctypes.c_float,
+                ctypes.c_void_p, ctypes.c_int, ctypes.c_void_p, ctypes.c_int,
+                ctypes.c_float, ctypes.c_void_p, ctypes.c_int
+            ]
+            self.simd_lib.simd_sgemm.restype = None
+            self.simd_lib.simd_sgemm_epilogue.argtypes = [
+                ctypes.c_int, ctypes.c_int, ctypes.c_int, ctypes.c_int, ctypes.c_int,
+                ctypes.c_void_p, ctypes.c_int, ctypes.c_void_p, ctypes.c_int,
+                ctypes.c_void_p, ctypes.c_int, ctypes.POINTER(SimdGemmEpilogue)
+            ]
+            self.simd_lib.simd_sgemm_epilogue.restype = None
+            
+            float_pp = ctypes.POINTER(ctypes.POINTER(ctypes.c_float))
+            self.simd_lib.sgemm_batched.argtypes = [
+                ctypes.c_int, ctypes.c_int,
+                ctypes.c_int, ctypes.c_int, ctypes.c_int, ctypes.c_float,
+                float_pp, ctypes.c_int, float_pp, ctypes.c_int,
+                ctypes.c_float, float_pp, ctypes.c_int, ctypes.c_int
+            ]
+            self.simd_lib.sgemm_batched.restype = None
+            self.simd_lib.sgemm_strided_batched.argtypes = [
+                ctypes.c_int, ctypes.c_int,
+                ctypes.c_int, ctypes.c_int, ctypes.c_int, ctypes.c_float,
+                ctypes.POINTER(ctypes.c_float), ctypes.c_int, ctypes.c_longlong,
+                ctypes.POINTER(ctypes.c_float), ctypes.c_int, ctypes.c_longlong,
+                ctypes.c_float, ctypes.POINTER(ctypes.c_float), ctypes.c_int, ctypes.c_longlong,
+                ctypes.c_int
+            ]
+            self.simd_lib.sgemm_strided_batched.restype = None
+            
             # 基准实现（永远可用）
             self.simd_lib.matrix_mult_baseline.argtypes = [
                 ctypes.POINTER(ctypes.c_float),
@@ -180,6 +1124,275 @@ class SimdOperations:
             ]
             self.simd_lib.fma_baseline.restype = None
             
+            # 运行时分发入口 (加载时按CPUID选择指令集变体)
+            for name in ("dispatch_matrix_mult", "dispatch_matrix_add"):
+                getattr(self.simd_lib, name).argtypes = [
+                    ctypes.POINTER(ctypes.c_float),
+                    ctypes.POINTER(ctypes.c_float),
+                    ctypes.POINTER(ctypes.c_float),
+                    ctypes.c_int
+                ]
+                getattr(self.simd_lib, name).restype = None
+            
+            self.simd_lib.dispatch_vector_scale.argtypes = [
+                ctypes.POINTER(ctypes.c_float),
+                ctypes.c_float,
+                ctypes.c_int
+            ]
+            self.simd_lib.dispatch_vector_scale.restype = None
+            
+            self.simd_lib.dispatch_fma.argtypes = [
+                ctypes.POINTER(ctypes.c_float),
+                ctypes.POINTER(ctypes.c_float),
+                ctypes.POINTER(ctypes.c_float),
+                ctypes.POINTER(ctypes.c_float),
+                ctypes.c_int
+            ]
+            self.simd_lib.dispatch_fma.restype = None
+            
+            self.simd_lib.simd_get_active_variant.argtypes = []
+            self.simd_lib.simd_get_active_variant.restype = ctypes.c_char_p
+            self.simd_lib.simd_get_cpu_features.argtypes = []
+            self.simd_lib.simd_get_cpu_features.restype = ctypes.c_uint
+            self.simd_lib.simd_get_cache_info.argtypes = [ctypes.POINTER(SimdCacheInfo)]
+            self.simd_lib.simd_get_cache_info.restype = None
+            self.simd_lib.simd_get_gemm_blocking.argtypes = [ctypes.POINTER(SimdGemmBlocking)]
+            self.simd_lib.simd_get_gemm_blocking.restype = None
+            self.simd_lib.simd_autotune.argtypes = [ctypes.c_int, ctypes.POINTER(SimdTuningResult)]
+            self.simd_lib.simd_autotune.restype = ctypes.c_int
+            self.simd_lib.simd_get_tuning.argtypes = [ctypes.POINTER(SimdTuningResult)]
+            self.simd_lib.simd_get_tuning.restype = None
+            self.simd_lib.simd_get_tuning_file.argtypes = []
+            self.simd_lib.simd_get_tuning_file.restype = ctypes.c_char_p
+            
+            # AutoGPTQ 打包布局的量化矩阵乘
+            float_p = ctypes.POINTER(ctypes.c_float)
+            int_p = ctypes.POINTER(ctypes.c_int)
+            self.simd_lib.vecquant8matmul.argtypes = [
+                float_p, int_p, float_p, float_p, int_p, int_p
+            ] + [ctypes.c_int] * 5
+            self.simd_lib.vecquant8matmul.restype = None
+            for name in ("vecquant8matmul_batched", "vecquant4matmul_batched"):
+                getattr(self.simd_lib, name).argtypes = [
+                    float_p, int_p, float_p, float_p, int_p
+                ] + [ctypes.c_int] * 6
+                getattr(self.simd_lib, name).restype = None
+            for name in ("vecquant8matmul_batched_column_compression",
+                         "vecquant4matmul_batched_column_compression"):
+                getattr(self.simd_lib, name).argtypes = [
+                    float_p, int_p, float_p, float_p, int_p
+                ] + [ctypes.c_int] * 5
+                getattr(self.simd_lib, name).restype = None
+            
+            # INT8 GEMM (权重预打包为不透明句柄)
+            self.simd_lib.simd_int8_pack_weights.argtypes = [float_p] + [ctypes.c_int] * 3
+            self.simd_lib.simd_int8_pack_weights.restype = ctypes.c_void_p
+            self.simd_lib.simd_int8_pack_quantized.argtypes = [
+                ctypes.POINTER(ctypes.c_int8), float_p
+            ] + [ctypes.c_int] * 3
+            self.simd_lib.simd_int8_pack_quantized.restype = ctypes.c_void_p
+            self.simd_lib.simd_int8_free_weights.argtypes = [ctypes.c_void_p]
+            self.simd_lib.simd_int8_free_weights.restype = None
+            self.simd_lib.simd_int8_gemm.argtypes = [
+                float_p, ctypes.c_int, ctypes.c_void_p, float_p, ctypes.c_int, ctypes.c_int
+            ]
+            self.simd_lib.simd_int8_gemm.restype = ctypes.c_int
+            self.simd_lib.simd_int8_get_variant.argtypes = []
+            self.simd_lib.simd_int8_get_variant.restype = ctypes.c_char_p
+            
+            # GEMV (batch 1 解码)
+            self.simd_lib.simd_gemv_f32.argtypes = [
+                float_p, ctypes.c_int, float_p, float_p, float_p, ctypes.c_int, ctypes.c_int
+            ]
+            self.simd_lib.simd_gemv_f32.restype = None
+            self.simd_lib.simd_gemv_f16.argtypes = [
+                ctypes.POINTER(ctypes.c_uint16), ctypes.c_int, float_p, float_p, float_p,
+                ctypes.c_int, ctypes.c_int
+            ]
+            self.simd_lib.simd_gemv_f16.restype = None
+            self.simd_lib.simd_gemv_q8.argtypes = [
+                ctypes.POINTER(ctypes.c_int8), ctypes.c_int, float_p, float_p, float_p, float_p,
+                ctypes.c_int, ctypes.c_int
+            ]
+            self.simd_lib.simd_gemv_q8.restype = None
+            self.simd_lib.simd_gemv_q4.argtypes = [
+                ctypes.POINTER(ctypes.c_uint8), ctypes.c_int, float_p, ctypes.c_int,
+                float_p, float_p, float_p, ctypes.c_int, ctypes.c_int
+            ]
+            self.simd_lib.simd_gemv_q4.restype = None
+            self.simd_lib.simd_gemv_pack_weights.argtypes = [
+                ctypes.c_int, ctypes.c_void_p, ctypes.c_int, float_p, ctypes.c_int,
+                ctypes.c_int, ctypes.c_int, ctypes.c_int
+            ]
+            self.simd_lib.simd_gemv_pack_weights.restype = ctypes.c_void_p
+            self.simd_lib.simd_gemv_free_weights.argtypes = [ctypes.c_void_p]
+            self.simd_lib.simd_gemv_free_weights.restype = None
+            self.simd_lib.simd_gemv_weights_replicas.argtypes = [ctypes.c_void_p]
+            self.simd_lib.simd_gemv_weights_replicas.restype = ctypes.c_int
+            self.simd_lib.simd_gemv_packed.argtypes = [ctypes.c_void_p, float_p, float_p, float_p]
+            self.simd_lib.simd_gemv_packed.restype = None
+            
+            # 融合逐元素表达式
+            self.simd_lib.simd_elementwise_fused.argtypes = [
+                ctypes.POINTER(SimdEwInstr), ctypes.c_int,
+                ctypes.POINTER(ctypes.POINTER(ctypes.c_float)), ctypes.c_int,
+                ctypes.c_int, float_p, ctypes.c_longlong
+            ]
+            self.simd_lib.simd_elementwise_fused.restype = ctypes.c_int
+            
+            # 归约
+            self.simd_lib.simd_reduce.argtypes = [ctypes.c_int, float_p, ctypes.c_longlong]
+            self.simd_lib.simd_reduce.restype = ctypes.c_float
+            for name in ("simd_argmax", "simd_argmin"):
+                getattr(self.simd_lib, name).argtypes = [float_p, ctypes.c_longlong]
+                getattr(self.simd_lib, name).restype = ctypes.c_longlong
+            self.simd_lib.simd_mean_var.argtypes = [float_p, ctypes.c_longlong, float_p, float_p]
+            self.simd_lib.simd_mean_var.restype = None
+            self.simd_lib.simd_reduce_axis.argtypes = [ctypes.c_int, float_p] + [ctypes.c_int] * 4 + [float_p]
+            self.simd_lib.simd_reduce_axis.restype = ctypes.c_int
+            self.simd_lib.simd_arg_reduce_axis.argtypes = [ctypes.c_int, float_p] + [ctypes.c_int] * 4 + [
+                ctypes.POINTER(ctypes.c_int)
+            ]
+            self.simd_lib.simd_arg_reduce_axis.restype = ctypes.c_int
+            self.simd_lib.simd_mean_var_axis.argtypes = [float_p] + [ctypes.c_int] * 4 + [float_p, float_p]
+            self.simd_lib.simd_mean_var_axis.restype = ctypes.c_int
+            
+            # Transformer 逐行算子
+            self.simd_lib.simd_softmax.argtypes = [float_p, ctypes.c_int, float_p] + [ctypes.c_int] * 3 + [
+                ctypes.c_float
+            ]
+            self.simd_lib.simd_softmax.restype = ctypes.c_int
+            self.simd_lib.simd_rmsnorm.argtypes = [float_p, ctypes.c_int, float_p, float_p] + [
+                ctypes.c_int
+            ] * 3 + [ctypes.c_float]
+            self.simd_lib.simd_rmsnorm.restype = ctypes.c_int
+            self.simd_lib.simd_layernorm.argtypes = [float_p, ctypes.c_int, float_p, float_p, float_p] + [
+                ctypes.c_int
+            ] * 3 + [ctypes.c_float]
+            self.simd_lib.simd_layernorm.restype = ctypes.c_int
+            self.simd_lib.simd_activation.argtypes = [ctypes.c_int, float_p, float_p, ctypes.c_longlong]
+            self.simd_lib.simd_activation.restype = ctypes.c_int
+            self.simd_lib.simd_gated_activation.argtypes = [ctypes.c_int, float_p, float_p, float_p,
+                                                            ctypes.c_longlong]
+            self.simd_lib.simd_gated_activation.restype = ctypes.c_int
+            self.simd_lib.simd_rope.argtypes = [float_p, ctypes.c_int, ctypes.c_int, ctypes.c_longlong,
+                                                ctypes.c_longlong, float_p, float_p, ctypes.c_int,
+                                                ctypes.c_int]
+            self.simd_lib.simd_rope.restype = ctypes.c_int
+            self.simd_lib.simd_rope_tables.argtypes = [ctypes.POINTER(ctypes.c_int), ctypes.c_int,
+                                                       ctypes.c_int, ctypes.c_float, float_p, float_p]
+            self.simd_lib.simd_rope_tables.restype = ctypes.c_int
+            
+            # 融合注意力
+            self.simd_lib.simd_attention.argtypes = [ctypes.POINTER(SimdAttentionParams),
+                                                     float_p, float_p, float_p, float_p]
+            self.simd_lib.simd_attention.restype = ctypes.c_int
+            
+            void_p = ctypes.c_void_p
+            int_p = ctypes.POINTER(ctypes.c_int)
+            lib = self.simd_lib
+            
+            # 零拷贝张量存储
+            lib.simd_tensor_store_open.argtypes = [ctypes.c_char_p]
+            lib.simd_tensor_store_open.restype = void_p
+            lib.simd_tensor_store_close.argtypes = [void_p]
+            lib.simd_tensor_store_close.restype = None
+            lib.simd_tensor_store_error.argtypes = []
+            lib.simd_tensor_store_error.restype = ctypes.c_char_p
+            lib.simd_tensor_store_count.argtypes = [void_p]
+            lib.simd_tensor_store_count.restype = ctypes.c_int
+            lib.simd_tensor_store_find.argtypes = [void_p, ctypes.c_char_p]
+            lib.simd_tensor_store_find.restype = ctypes.c_int
+            lib.simd_tensor_store_info.argtypes = [void_p, ctypes.c_int, ctypes.POINTER(SimdTensorInfo)]
+            lib.simd_tensor_store_info.restype = ctypes.c_int
+            for fn in (lib.simd_tensor_store_prefetch, lib.simd_tensor_store_release):
+                fn.argtypes = [void_p, ctypes.c_char_p]
+                fn.restype = ctypes.c_int
+            lib.simd_tensor_store_resident.argtypes = [void_p, ctypes.c_char_p]
+            lib.simd_tensor_store_resident.restype = ctypes.c_longlong
+            
+            # 逐层权重预取
+            lib.simd_prefetcher_create.argtypes = [ctypes.c_int, ctypes.c_longlong, ctypes.c_int]
+            lib.simd_prefetcher_create.restype = void_p
+            lib.simd_prefetcher_destroy.argtypes = [void_p]
+            lib.simd_prefetcher_destroy.restype = None
+            lib.simd_prefetcher_add_file.argtypes = [void_p, ctypes.c_char_p]
+            lib.simd_prefetcher_add_file.restype = ctypes.c_int
+            lib.simd_prefetcher_submit_tensors.argtypes = [void_p, void_p, ctypes.c_char_p]
+            lib.simd_prefetcher_submit_tensors.restype = ctypes.c_int
+            lib.simd_prefetcher_ready.argtypes = [void_p, ctypes.c_int]
+            lib.simd_prefetcher_ready.restype = ctypes.c_int
+            lib.simd_prefetcher_acquire.argtypes = [void_p, ctypes.c_int, ctypes.c_int]
+            lib.simd_prefetcher_acquire.restype = void_p
+            lib.simd_prefetcher_offset.argtypes = [void_p, ctypes.c_int, ctypes.c_int]
+            lib.simd_prefetcher_offset.restype = ctypes.c_longlong
+            lib.simd_prefetcher_release.argtypes = [void_p, ctypes.c_int]
+            lib.simd_prefetcher_release.restype = None
+            lib.simd_prefetcher_stats.argtypes = [void_p, ctypes.POINTER(SimdPrefetchStats)]
+            lib.simd_prefetcher_stats.restype = None
+            
+            # 分页 KV 缓存
+            lib.simd_kv_cache_create.argtypes = [ctypes.POINTER(SimdKvCacheConfig)]
+            lib.simd_kv_cache_create.restype = void_p
+            lib.simd_kv_cache_destroy.argtypes = [void_p]
+            lib.simd_kv_cache_destroy.restype = None
+            lib.simd_kv_cache_seq_create.argtypes = [void_p]
+            lib.simd_kv_cache_seq_create.restype = ctypes.c_int
+            for name in ("simd_kv_cache_seq_free", "simd_kv_cache_seq_length"):
+                getattr(lib, name).argtypes = [void_p, ctypes.c_int]
+                getattr(lib, name).restype = ctypes.c_int
+            for name in ("simd_kv_cache_seq_match_prefix", "simd_kv_cache_seq_append"):
+                getattr(lib, name).argtypes = [void_p, ctypes.c_int, int_p, ctypes.c_int]
+                getattr(lib, name).restype = ctypes.c_int
+            for name in ("simd_kv_cache_write", "simd_kv_cache_read"):
+                getattr(lib, name).argtypes = [void_p, ctypes.c_int, ctypes.c_int, ctypes.c_int,
+                                               ctypes.c_int, float_p, ctypes.c_longlong,
+                                               ctypes.c_longlong, float_p, ctypes.c_longlong,
+                                               ctypes.c_longlong]
+                getattr(lib, name).restype = ctypes.c_int
+            lib.simd_kv_cache_stats.argtypes = [void_p, ctypes.POINTER(SimdKvCacheStats)]
+            lib.simd_kv_cache_stats.restype = ctypes.c_int
+            lib.simd_attention_paged.argtypes = [ctypes.POINTER(SimdAttentionParams), float_p,
+                                                 void_p, ctypes.c_int, ctypes.c_int, float_p]
+            lib.simd_attention_paged.restype = ctypes.c_int
+            
+            # logits 采样 (指针以整数地址传入，减少每个 token 的调用开销)
+            lib.simd_sample.argtypes = [void_p, ctypes.c_int, void_p, ctypes.c_int,
+                                        ctypes.POINTER(SimdSamplerParams),
+                                        ctypes.POINTER(ctypes.c_ulonglong)]
+            lib.simd_sample.restype = ctypes.c_int
+            
+            # 线程池配置
+            self.simd_lib.simd_set_num_threads.argtypes = [ctypes.c_int]
+            self.simd_lib.simd_set_num_threads.restype = None
+            self.simd_lib.simd_get_num_threads.argtypes = []
+            self.simd_lib.simd_get_num_threads.restype = ctypes.c_int
+            self.simd_lib.simd_set_thread_affinity.argtypes = [ctypes.c_int]
+            self.simd_lib.simd_set_thread_affinity.restype = None
+            
+            # 对齐内存池 (分配/arena 的签名由 memory_aligner 注册)
+            self.simd_lib.simd_pool_trim.argtypes = []
+            self.simd_lib.simd_pool_trim.restype = None
+            self.simd_lib.simd_pool_stats.argtypes = [ctypes.POINTER(SimdPoolStats)]
+            self.simd_lib.simd_pool_stats.restype = None
+            if HAS_MEMORY_ALIGNMENT:
+                register_native_pool(self.simd_lib)
+            
+            # 大页与 NUMA 区域
+            self.simd_lib.simd_numa_node_count.argtypes = []
+            self.simd_lib.simd_numa_node_count.restype = ctypes.c_int
+            self.simd_lib.simd_numa_current_node.argtypes = []
+            self.simd_lib.simd_numa_current_node.restype = ctypes.c_int
+            self.simd_lib.simd_numa_set_thread_policy.argtypes = [ctypes.c_int, ctypes.c_int]
+            self.simd_lib.simd_numa_set_thread_policy.restype = ctypes.c_int
+            self.simd_lib.simd_region_alloc.argtypes = [ctypes.c_longlong, ctypes.c_int,
+                                                        ctypes.c_int, ctypes.c_int]
+            self.simd_lib.simd_region_alloc.restype = ctypes.c_void_p
+            self.simd_lib.simd_region_free.argtypes = [ctypes.c_void_p]
+            self.simd_lib.simd_region_free.restype = None
+            self.simd_lib.simd_region_flags.argtypes = [ctypes.c_void_p]
+            self.simd_lib.simd_region_flags.restype = ctypes.c_int
+            
         except Exception as e:
             logger.error(f"设置函数签名失败: {str(e)}")
             self.simd_lib_loaded = False
@@ -191,6 +1404,11 @@ class SimdOperations:
         Returns:
             str: 最佳SIMD类型
         """
+        # 原生库已加载时直接使用其CPUID分发结果
+        if self.simd_lib_loaded and self.simd_lib:
+            variant = self.simd_lib.simd_get_active_variant().decode('utf-8')
+            return 'sse4.2' if variant == 'sse42' else variant
+        
         # 尝试从指令集路由器获取
         try:
             from src.hardware.optimization_router import select_optimization_path
@@ -317,8 +1535,12 @@ class SimdOperations:
         if not HAS_MEMORY_ALIGNMENT:
             return array
             
-        # 只有在需要时才进行对齐操作
+        # 只有在需要时才进行对齐操作；临时副本优先取自原生内存池，回收后复用
         if not is_aligned(array, self.memory_alignment):
+            if has_native_pool():
+                aligned = pool_empty(array.shape, array.dtype, self.memory_alignment)
+                aligned[...] = array
+                return aligned
             return align_array(array, self.memory_alignment)
         return array
     
@@ -333,6 +1555,10 @@ class SimdOperations:
         Returns:
             矩阵乘法结果C
         """
+        a, b = np.asarray(a), np.asarray(b)
+        # 原生内核按二维行主序读取，形状不符时会越界
+        if a.ndim != 2 or b.ndim != 2 or a.shape[1] != b.shape[0]:
+            raise ValueError(f"矩阵形状不匹配: {a.shape} x {b.shape}")
         # 进行内存对齐以获得最佳性能
         a_aligned = self._ensure_aligned(a)
         b_aligned = self._ensure_aligned(b)
@@ -340,10 +1566,13 @@ class SimdOperations:
         try:
             if self.simd_lib_loaded and self.simd_lib:
                 # 获取数组指针
+                a_aligned = np.ascontiguousarray(a_aligned, dtype=np.float32)
+                b_aligned = np.ascontiguousarray(b_aligned, dtype=np.float32)
+                c = np.empty((a_aligned.shape[0], b_aligned.shape[1]), dtype=np.float32)
                 a_ptr = a_aligned.ctypes.data_as(ctypes.POINTER(ctypes.c_float))
                 b_ptr = b_aligned.ctypes.data_as(ctypes.POINTER(ctypes.c_float))
-                c_ptr = np.zeros_like(a_aligned, dtype=np.float32).ctypes.data_as(ctypes.POINTER(ctypes.c_float))
-                
+                c_ptr = c.ctypes.data_as(ctypes.POINTER(ctypes.c_float))
+
                 # 调用库函数
                 simd_type_bytes = self.simd_type.encode('utf-8')
                 self.simd_lib.dispatch_matrix_multiply(
@@ -351,123 +1580,307 @@ class SimdOperations:
                     a_aligned.shape[0], a_aligned.shape[1], b_aligned.shape[1],
                     simd_type_bytes
                 )
-                return np.ctypeslib.as_array(c_ptr).reshape(a_aligned.shape[0], b_aligned.shape[1])
+                return c
         except Exception as e:
             logger.warning(f"SIMD矩阵乘法失败: {str(e)}，回退到NumPy")
         
         # 回退到NumPy
         return np.matmul(a_aligned, b_aligned)
     
-    def matrix_element_multiply(self, a: np.ndarray, b: np.ndarray) -> np.ndarray:
+    @staticmethod
+    def _gemm_operand(x: np.ndarray) -> Tuple[np.ndarray, int, int]:
         """
-        矩阵元素点乘 (Hadamard积)
+        将二维数组映射为 BLAS 风格的 (数组, 转置标志, 行距)
+        行内连续或列内连续 (如 w.T、切片视图) 的 float32 数组直接使用，其他布局先复制
+        """
+        x = np.asarray(x, dtype=np.float32)
+        if x.ndim != 2:
+            raise ValueError("矩阵乘操作数必须是二维数组")
+        rows, cols = x.shape
+        s0, s1 = x.strides
+        if (s1 == 4 or cols == 1) and s0 % 4 == 0 and s0 // 4 >= cols:
+            return x, 0, max(1, s0 // 4)
+        if (s0 == 4 or rows == 1) and s1 % 4 == 0 and s1 // 4 >= rows:
+            return x, 1, max(1, s1 // 4)
+        x = np.ascontiguousarray(x)
+        return x, 0, max(1, cols)
+    
+    def gemm(self, a: np.ndarray, b: np.ndarray, alpha: float = 1.0, beta: float = 0.0,
+             out: Optional[np.ndarray] = None) -> np.ndarray:
+        """
+        BLAS 风格矩阵乘: out = alpha * a × b + beta * out
+        a/b 可以是转置视图 (如 [out, in] 布局权重的 w.T) 或子矩阵切片，不会复制数据
         
         Args:
-            a: 矩阵A
-            b: 矩阵B（与A形状相同）
+            a: 矩阵 [M, K]
+            b: 矩阵 [K, N]
+            alpha: a × b 的缩放
+            beta: out 原值的系数，非 0 时必须提供 out
+            out: 输出 [M, N]，可以是行内连续的切片视图
             
         Returns:
-            结果矩阵C，C[i,j] = A[i,j] * B[i,j]
+            out
         """
-        # 进行内存对齐以获得最佳性能
-        a_aligned = self._ensure_aligned(a)
-        b_aligned = self._ensure_aligned(b)
-        
-        try:
-            if self.simd_lib_loaded and self.simd_lib:
-                # 将数组展平为1D
-                a_flat = a_aligned.flatten()
-                b_flat = b_aligned.flatten()
-                c_flat = np.zeros_like(a_flat, dtype=np.float32)
-                n = a_flat.size
-                
-                # 获取数组指针
-                a_ptr = a_flat.ctypes.data_as(ctypes.POINTER(ctypes.c_float))
-                b_ptr = b_flat.ctypes.data_as(ctypes.POINTER(ctypes.c_float))
-                c_ptr = c_flat.ctypes.data_as(ctypes.POINTER(ctypes.c_float))
-                
-                # 调用基准函数（即使没有对应SIMD实现）
-                self.simd_lib.matrix_mult_baseline(a_ptr, b_ptr, c_ptr, n)
-                return c_flat.reshape(a_aligned.shape)
-        except Exception as e:
-            logger.warning(f"SIMD元素乘法失败: {str(e)}，回退到NumPy")
+        if beta != 0.0 and out is None:
+            raise ValueError("beta 非 0 时必须提供 out")
+        a, trans_a, lda = self._gemm_operand(a)
+        b, trans_b, ldb = self._gemm_operand(b)
+        if a.shape[1] != b.shape[0]:
+            raise ValueError(f"矩阵形状不匹配: {a.shape} x {b.shape}")
+        M, K, N = a.shape[0], a.shape[1], b.shape[1]
+        if out is None:
+            out = np.empty((M, N), dtype=np.float32)
+        elif out.shape != (M, N) or out.dtype != np.float32 or out.strides[1] != 4:
+            raise ValueError("out 必须是形状为 [M, N]、行内连续的float32数组")
         
-        # 回退到NumPy
-        return a_aligned * b_aligned
+        if not self.simd_lib_loaded or not self.simd_lib:
+            result = alpha * np.matmul(a, b)
+            if beta != 0.0:
+                result += beta * out
+            out[...] = result
+            return out
+        self.simd_lib.simd_sgemm(
+            trans_a, trans_b, M, N, K, alpha,
+            a.ctypes.data, lda, b.ctypes.data, ldb,
+            beta, out.ctypes.data, out.strides[0] // 4
+        )
+        return out
     
-    def matrix_add(self, a: np.ndarray, b: np.ndarray) -> np.ndarray:
+    def matrix_multiply_fused(self, a: np.ndarray, b: np.ndarray,
+                              bias: Optional[np.ndarray] = None,
+                              activation: Optional[str] = None,
+                              residual: Optional[np.ndarray] = None,
+                              alpha: float = 1.0, beta: float = 0.0,
+                              out: Optional[np.ndarray] = None) -> np.ndarray:
         """
-        矩阵元素加法
+        带融合尾处理的矩阵乘法: out = act(alpha * A × B + beta * out + bias) + residual
+        偏置、激活与残差在原生 GEMM 写回时完成，不再额外遍历输出
         
         Args:
-            a: 矩阵A
-            b: 矩阵B（与A形状相同）
+            a: 矩阵A [M, K]
+            b: 矩阵B [K, N]
+            bias: 偏置 [N]
+            activation: None/"relu"/"gelu"/"silu" (gelu 为 tanh 近似)
+            residual: 残差 [M, N]，不能与 out 共享内存
+            alpha: A × B 的缩放
+            beta: out 原值的系数，非 0 时必须提供 out
+            out: 输出数组 [M, N] (float32，内存连续)
             
         Returns:
-            结果矩阵C，C[i,j] = A[i,j] + B[i,j]
+            out
         """
-        # 进行内存对齐以获得最佳性能
-        a_aligned = self._ensure_aligned(a)
-        b_aligned = self._ensure_aligned(b)
+        if activation not in GEMM_ACTIVATIONS:
+            raise ValueError(f"不支持的激活函数: {activation}")
+        if beta != 0.0 and out is None:
+            raise ValueError("beta 非 0 时必须提供 out")
         
-        try:
-            if self.simd_lib_loaded and self.simd_lib:
-                # 将数组展平为1D
-                a_flat = a_aligned.flatten()
-                b_flat = b_aligned.flatten()
-                c_flat = np.zeros_like(a_flat, dtype=np.float32)
-                n = a_flat.size
-                
-                # 获取数组指针
-                a_ptr = a_flat.ctypes.data_as(ctypes.POINTER(ctypes.c_float))
-                b_ptr = b_flat.ctypes.data_as(ctypes.POINTER(ctypes.c_float))
-                c_ptr = c_flat.ctypes.data_as(ctypes.POINTER(ctypes.c_float))
-                
-                # 调用基准函数（即使没有对应SIMD实现）
-                self.simd_lib.matrix_add_baseline(a_ptr, b_ptr, c_ptr, n)
-                return c_flat.reshape(a_aligned.shape)
-        except Exception as e:
-            logger.warning(f"SIMD矩阵加法失败: {str(e)}，回退到NumPy")
+        a, trans_a, lda = self._gemm_operand(a)
+        b, trans_b, ldb = self._gemm_operand(b)
+        if a.shape[1] != b.shape[0]:
+            raise ValueError(f"矩阵形状不匹配: {a.shape} x {b.shape}")
+        M, K, N = a.shape[0], a.shape[1], b.shape[1]
+        if out is None:
+            out = np.empty((M, N), dtype=np.float32)
+        elif out.shape != (M, N) or out.dtype != np.float32 or out.strides[1] != 4:
+            raise ValueError("out 必须是形状为 [M, N]、行内连续的float32数组")
+        if bias is not None:
+            bias = np.ascontiguousarray(bias, dtype=np.float32).reshape(N)
+        if residual is not None:
+            residual, trans_r, ldr = self._gemm_operand(residual)
+            if residual.shape != (M, N):
+                raise ValueError("residual 形状必须为 [M, N]")
+            if trans_r:
+                residual = np.ascontiguousarray(residual)
+                ldr = N
+        
+        if self.simd_lib_loaded and self.simd_lib:
+            epilogue = SimdGemmEpilogue(
+                alpha, beta,
+                self._float_ptr(bias) if bias is not None else None,
+                GEMM_ACTIVATIONS[activation],
+                self._float_ptr(residual) if residual is not None else None,
+                ldr if residual is not None else 0
+            )
+            self.simd_lib.simd_sgemm_epilogue(
+                trans_a, trans_b, M, N, K,
+                a.ctypes.data, lda, b.ctypes.data, ldb,
+                out.ctypes.data, out.strides[0] // 4, ctypes.byref(epilogue)
+            )
+            return out
         
         # 回退到NumPy
-        return a_aligned + b_aligned
+        result = alpha * np.matmul(a, b)
+        if beta != 0.0:
+            result += beta * out
+        if bias is not None:
+            result += bias
+        if activation == "relu":
+            result = np.maximum(result, 0.0)
+        elif activation == "gelu":
+            result = 0.5 * result * (1.0 + np.tanh(0.7978845608 * (result + 0.044715 * result ** 3)))
+        elif activation == "silu":
+            result = result / (1.0 + np.exp(-result))
+        if residual is not None:
+            result += residual
+        out[...] = result
+        return out
     
-    def vector_scale(self, vec: np.ndarray, scalar: float) -> np.ndarray:
+    def matrix_multiply_batched(self, a: Union[np.ndarray, List[np.ndarray]],
+                                b: Union[np.ndarray, List[np.ndarray]],
+                                alpha: float = 1.0,
+                                transpose_b: bool = False) -> Union[np.ndarray, List[np.ndarray]]:
         """
-        向量缩放操作 vec = vec * scalar
+        批量矩阵乘法，整批只跨越一次 ctypes 调用并在原生线程池上调度
         
         Args:
-            vec: 输入向量
-            scalar: 缩放因子
+            a: [batch, M, K] 数组，或形状相同的二维矩阵列表
+            b: [batch, K, N] 数组 ([K, N] 时所有矩阵共享)，或与 a 等长的二维矩阵列表
+            alpha: 结果缩放
+            transpose_b: 为 True 时 b 按 [batch, N, K] (或 [N, K]) 存储，计算 a × b^T
             
         Returns:
-            缩放后的向量
+            a 为数组时返回 [batch, M, N] 数组，否则返回结果矩阵列表
         """
-        # 进行内存对齐以获得最佳性能
-        vec_aligned = self._ensure_aligned(vec)
+        if isinstance(a, np.ndarray):
+            a = np.ascontiguousarray(a, dtype=np.float32)
+            b = np.ascontiguousarray(b, dtype=np.float32)
+            k_axis = -1 if transpose_b else -2
+            if a.ndim != 3 or b.ndim not in (2, 3) or a.shape[2] != b.shape[k_axis] or \
+                    (b.ndim == 3 and b.shape[0] != a.shape[0]):
+                raise ValueError(f"批量矩阵形状不匹配: {a.shape} x {b.shape}")
+            batch, M, K = a.shape
+            N = b.shape[-2] if transpose_b else b.shape[-1]
+            c = np.empty((batch, M, N), dtype=np.float32)
+            if not self.simd_lib_loaded or not self.simd_lib:
+                np.matmul(a, np.swapaxes(b, -1, -2) if transpose_b else b, out=c)
+                return c * alpha if alpha != 1.0 else c
+            self.simd_lib.sgemm_strided_batched(
+                0, int(transpose_b), M, N, K, alpha,
+                self._float_ptr(a), K, M * K,
+                self._float_ptr(b), b.shape[-1], K * N if b.ndim == 3 else 0,
+                0.0, self._float_ptr(c), N, M * N, batch
+            )
+            return c
         
-        try:
-            if self.simd_lib_loaded and self.simd_lib:
-                # 将数组展平为1D
-                vec_flat = vec_aligned.flatten()
-                n = vec_flat.size
-                
-                # 获取数组指针
-                vec_ptr = vec_flat.ctypes.data_as(ctypes.POINTER(ctypes.c_float))
-                
-                # 创建结果数组（复制原数组）
-                result = vec_flat.copy()
-                
-                # 调用基准函数
-                self.simd_lib.vector_scale_baseline(vec_ptr, scalar, n)
-                return result.reshape(vec_aligned.shape)
-        except Exception as e:
-            logger.warning(f"SIMD向量缩放失败: {str(e)}，回退到NumPy")
+        a_list = [np.ascontiguousarray(x, dtype=np.float32) for x in a]
+        b_list = [np.ascontiguousarray(x, dtype=np.float32) for x in b]
+        if len(a_list) != len(b_list):
+            raise ValueError("a 与 b 的矩阵数量不一致")
+        if not a_list:
+            return []
+        M, K = a_list[0].shape
+        N = b_list[0].shape[0] if transpose_b else b_list[0].shape[1]
+        b_shape = (N, K) if transpose_b else (K, N)
+        if any(x.shape != (M, K) for x in a_list) or any(x.shape != b_shape for x in b_list):
+            raise ValueError("批量矩阵乘要求所有矩阵形状相同")
+        if not self.simd_lib_loaded or not self.simd_lib:
+            return [alpha * (x @ (y.T if transpose_b else y)) for x, y in zip(a_list, b_list)]
+        c_list = [np.empty((M, N), dtype=np.float32) for _ in a_list]
+        ptr_array = ctypes.POINTER(ctypes.c_float) * len(a_list)
+        self.simd_lib.sgemm_batched(
+            0, int(transpose_b), M, N, K, alpha,
+            ptr_array(*[self._float_ptr(x) for x in a_list]), K,
+            ptr_array(*[self._float_ptr(x) for x in b_list]), b_shape[1],
+            0.0, ptr_array(*[self._float_ptr(x) for x in c_list]), N, len(a_list)
+        )
+        return c_list
+    
+    @staticmethod
+    def _elementwise_operand(x: np.ndarray) -> np.ndarray:
+        """逐元素内核支持任意长度与对齐: 连续的 float32 数组 (含切片视图) 直接传入，不做拷贝"""
+        return np.ascontiguousarray(x, dtype=np.float32)
+    
+    def _elementwise_output(self, shape, out: Optional[np.ndarray]) -> np.ndarray:
+        if out is None:
+            return np.empty(shape, dtype=np.float32)
+        if (not isinstance(out, np.ndarray) or out.dtype != np.float32
+                or not out.flags.c_contiguous or out.shape != shape):
+            raise ValueError(f"out 必须是形状为 {shape} 的连续float32数组")
+        return out
+    
+    def _elementwise(self, name: str, inputs: List[np.ndarray], out: Optional[np.ndarray],
+                     fallback) -> np.ndarray:
+        """逐元素运算公共路径: 输入与输出均以一维视图传给分发函数，out 可与某个输入相同"""
+        arrays = [self._elementwise_operand(x) for x in inputs]
+        shape = arrays[0].shape
+        if any(x.shape != shape for x in arrays[1:]):
+            raise ValueError(f"逐元素运算要求输入形状相同: {[x.shape for x in arrays]}")
+        result = self._elementwise_output(shape, out)
+        
+        if self.simd_lib_loaded and self.simd_lib and result.size > 0:
+            try:
+                getattr(self.simd_lib, name)(*[self._float_ptr(x) for x in arrays],
+                                             self._float_ptr(result), result.size)
+                return result
+            except Exception as e:
+                logger.warning(f"SIMD逐元素运算 {name} 失败: {str(e)}，回退到NumPy")
         
         # 回退到NumPy
-        return vec_aligned * scalar
+        result[...] = fallback(*arrays)
+        return result
+    
+    def matrix_element_multiply(self, a: np.ndarray, b: np.ndarray,
+                                out: Optional[np.ndarray] = None) -> np.ndarray:
+        """
+        矩阵元素点乘 (Hadamard积)
+        
+        Args:
+            a: 矩阵A
+            b: 矩阵B（与A形状相同）
+            out: 可选的输出数组（连续float32，可与a或b相同）
+            
+        Returns:
+            结果矩阵C，C[i,j] = A[i,j] * B[i,j]
+        """
+        return self._elementwise("dispatch_matrix_mult", [a, b], out, lambda x, y: x * y)
     
-    def fused_multiply_add(self, a: np.ndarray, b: np.ndarray, c: np.ndarray) -> np.ndarray:
+    def matrix_add(self, a: np.ndarray, b: np.ndarray,
+                   out: Optional[np.ndarray] = None) -> np.ndarray:
+        """
+        矩阵元素加法
+        
+        Args:
+            a: 矩阵A
+            b: 矩阵B（与A形状相同）
+            out: 可选的输出数组（连续float32，可与a或b相同）
+            
+        Returns:
+            结果矩阵C，C[i,j] = A[i,j] + B[i,j]
+        """
+        return self._elementwise("dispatch_matrix_add", [a, b], out, lambda x, y: x + y)
+    
+    def vector_scale(self, vec: np.ndarray, scalar: float,
+                     out: Optional[np.ndarray] = None) -> np.ndarray:
+        """
+        向量缩放操作 vec * scalar
+        
+        Args:
+            vec: 输入向量
+            scalar: 缩放因子
+            out: 可选的输出数组，传入 vec 本身时原地缩放
+            
+        Returns:
+            缩放后的向量
+        """
+        src = self._elementwise_operand(vec)
+        result = self._elementwise_output(src.shape, out)
+        if result is not src:
+            np.copyto(result, src)
+        
+        if self.simd_lib_loaded and self.simd_lib and result.size > 0:
+            try:
+                # 分发函数原地缩放
+                self.simd_lib.dispatch_vector_scale(self._float_ptr(result), scalar, result.size)
+                return result
+            except Exception as e:
+                logger.warning(f"SIMD向量缩放失败: {str(e)}，回退到NumPy")
+        
+        # 回退到NumPy
+        result *= np.float32(scalar)
+        return result
+    
+    def fused_multiply_add(self, a: np.ndarray, b: np.ndarray, c: np.ndarray,
+                           out: Optional[np.ndarray] = None) -> np.ndarray:
         """
         融合乘加操作 (Fused Multiply-Add)
         result = a * b + c
@@ -476,38 +1889,978 @@ class SimdOperations:
             a: 数组A
             b: 数组B（与A形状相同）
             c: 数组C（与A形状相同）
+            out: 可选的输出数组（连续float32，可与任一输入相同）
             
         Returns:
             结果数组 result = a * b + c
         """
-        # 进行内存对齐以获得最佳性能
-        a_aligned = self._ensure_aligned(a)
-        b_aligned = self._ensure_aligned(b)
-        c_aligned = self._ensure_aligned(c)
+        return self._elementwise("dispatch_fma", [a, b, c], out, lambda x, y, z: x * y + z)
+    
+    def fused_elementwise(self, expr: ElementwiseExpr, inputs: List[np.ndarray],
+                          out: Optional[np.ndarray] = None) -> np.ndarray:
+        """
+        融合逐元素表达式: 整条 add/mul/fma/缩放/截断/激活链在一次内存遍历中完成
+        
+        Args:
+            expr: ElementwiseExpr 描述符，ElementwiseExpr.input(i) 对应 inputs[i]
+            inputs: 形状相同的输入数组
+            out: 可选的输出数组（连续float32，可与某个输入相同）
+            
+        Returns:
+            表达式结果
+        """
+        program, out_reg, n_inputs = expr.compile()
+        if n_inputs > len(inputs):
+            raise ValueError(f"表达式引用了 {n_inputs} 个输入，但只提供了 {len(inputs)} 个")
+        arrays = [self._elementwise_operand(x) for x in inputs]
+        shape = arrays[0].shape if arrays else np.shape(out)
+        if any(x.shape != shape for x in arrays[1:]):
+            raise ValueError(f"逐元素运算要求输入形状相同: {[x.shape for x in arrays]}")
+        result = self._elementwise_output(shape, out)
+        
+        if self.simd_lib_loaded and self.simd_lib:
+            instrs = (SimdEwInstr * len(program))(*[SimdEwInstr(*ins) for ins in program])
+            ptrs = (ctypes.POINTER(ctypes.c_float) * max(len(arrays), 1))(
+                *[self._float_ptr(x) for x in arrays])
+            status = self.simd_lib.simd_elementwise_fused(
+                instrs, len(program), ptrs, len(arrays), out_reg,
+                self._float_ptr(result), result.size
+            )
+            if status != 0:
+                raise ValueError("原生库拒绝了表达式字节码")
+            return result
+        
+        # 回退到NumPy
+        result[...] = _eval_ew_program_numpy(program, out_reg, arrays)
+        return result
+    
+    def _reduce_matrix(self, x: np.ndarray, axis: int) -> Tuple[np.ndarray, int, int, int, int, Tuple]:
+        """
+        将按轴归约映射为二维行主序矩阵上的 axis 0/1 归约
+        
+        Returns:
+            (数组, 行数, 列数, 行距, 轴, 结果形状)；转置视图与切片视图不复制
+        """
+        if not -x.ndim <= axis < x.ndim:
+            raise ValueError(f"axis {axis} 超出数组维度 {x.ndim}")
+        axis %= x.ndim
+        out_shape = x.shape[:axis] + x.shape[axis + 1:]
+        if x.ndim == 2:
+            mat, trans, ld = self._gemm_operand(x)
+            rows, cols = x.shape
+            if trans:
+                rows, cols, axis = cols, rows, 1 - axis
+            return mat, rows, cols, ld, axis, out_shape
+        if axis == 0:
+            mat = np.ascontiguousarray(x).reshape(x.shape[0], -1)
+        else:
+            mat = np.ascontiguousarray(np.moveaxis(x, axis, -1)).reshape(-1, x.shape[axis])
+            axis = 1
+        return mat, mat.shape[0], mat.shape[1], max(1, mat.shape[1]), axis, out_shape
+    
+    def reduce(self, x: np.ndarray, op: str = "sum",
+               axis: Optional[int] = None) -> Union[float, np.ndarray]:
+        """
+        向量化归约 (块内多累加器，块间成对求和)
+        
+        Args:
+            x: 输入数组
+            op: "sum"/"mean"/"max"/"min"/"l1"/"l2"/"var"（总体方差）
+            axis: None 时归约全部元素，否则沿指定轴归约
+            
+        Returns:
+            axis 为 None 时返回标量，否则返回去掉该轴后的数组
+        """
+        if op not in REDUCE_OPS:
+            raise ValueError(f"不支持的归约操作: {op}")
+        x = np.asarray(x, dtype=np.float32)
+        if not self.simd_lib_loaded or not self.simd_lib:
+            return _reduce_numpy(x, op, axis)
         
+        if axis is None or x.ndim == 1:
+            if axis is not None and not -1 <= axis < 1:
+                raise ValueError(f"axis {axis} 超出数组维度 1")
+            flat = np.ascontiguousarray(x).reshape(-1)
+            return float(self.simd_lib.simd_reduce(REDUCE_OPS[op], self._float_ptr(flat), flat.size))
+        mat, rows, cols, ld, ax, out_shape = self._reduce_matrix(x, axis)
+        out = np.empty(cols if ax == 0 else rows, dtype=np.float32)
+        self.simd_lib.simd_reduce_axis(REDUCE_OPS[op], self._float_ptr(mat), rows, cols, ld, ax,
+                                       self._float_ptr(out))
+        return out.reshape(out_shape)
+    
+    def _arg_reduce(self, x: np.ndarray, op: str, axis: Optional[int]):
+        x = np.asarray(x, dtype=np.float32)
+        if x.size == 0:
+            raise ValueError(f"空数组不能求 arg{op}")
+        if not self.simd_lib_loaded or not self.simd_lib:
+            return (np.argmax if op == "max" else np.argmin)(x, axis=axis)
+        
+        if axis is None or x.ndim == 1:
+            flat = np.ascontiguousarray(x).reshape(-1)
+            fn = self.simd_lib.simd_argmax if op == "max" else self.simd_lib.simd_argmin
+            return int(fn(self._float_ptr(flat), flat.size))
+        mat, rows, cols, ld, ax, out_shape = self._reduce_matrix(x, axis)
+        out = np.empty(cols if ax == 0 else rows, dtype=np.int32)
+        self.simd_lib.simd_arg_reduce_axis(REDUCE_OPS[op], self._float_ptr(mat), rows, cols, ld, ax,
+                                           out.ctypes.data_as(ctypes.POINTER(ctypes.c_int)))
+        return out.astype(np.int64).reshape(out_shape)
+    
+    def argmax(self, x: np.ndarray, axis: Optional[int] = None) -> Union[int, np.ndarray]:
+        """首个最大值的下标 (axis 为 None 时为展平后的下标)"""
+        return self._arg_reduce(x, "max", axis)
+    
+    def argmin(self, x: np.ndarray, axis: Optional[int] = None) -> Union[int, np.ndarray]:
+        """首个最小值的下标 (axis 为 None 时为展平后的下标)"""
+        return self._arg_reduce(x, "min", axis)
+    
+    def mean_var(self, x: np.ndarray, axis: Optional[int] = None):
+        """
+        一次调用同时求均值与总体方差 (块内两遍，块间 Welford/Chan 合并)
+        
+        Returns:
+            (mean, var)，axis 为 None 时为标量
+        """
+        x = np.asarray(x, dtype=np.float32)
+        if not self.simd_lib_loaded or not self.simd_lib:
+            return _reduce_numpy(x, "mean", axis), _reduce_numpy(x, "var", axis)
+        
+        if axis is None or x.ndim == 1:
+            flat = np.ascontiguousarray(x).reshape(-1)
+            mean, var = ctypes.c_float(), ctypes.c_float()
+            self.simd_lib.simd_mean_var(self._float_ptr(flat), flat.size,
+                                        ctypes.byref(mean), ctypes.byref(var))
+            return float(mean.value), float(var.value)
+        mat, rows, cols, ld, ax, out_shape = self._reduce_matrix(x, axis)
+        size = cols if ax == 0 else rows
+        mean, var = np.empty(size, dtype=np.float32), np.empty(size, dtype=np.float32)
+        self.simd_lib.simd_mean_var_axis(self._float_ptr(mat), rows, cols, ld, ax,
+                                         self._float_ptr(mean), self._float_ptr(var))
+        return mean.reshape(out_shape), var.reshape(out_shape)
+    
+    def _row_matrix(self, x: np.ndarray) -> Tuple[np.ndarray, int, int, int]:
+        """
+        将数组视为按最后一维的 [rows, cols] 矩阵
+        
+        Returns:
+            (数组, 行数, 列数, 行距)；行距不等于列数的二维切片视图不复制
+        """
+        x = np.asarray(x, dtype=np.float32)
+        if x.ndim == 0:
+            raise ValueError("逐行算子要求至少一维的输入")
+        if (x.ndim == 2 and x.strides[1] == 4 and x.strides[0] % 4 == 0
+                and x.strides[0] // 4 >= x.shape[1]):
+            return x, x.shape[0], x.shape[1], max(1, x.strides[0] // 4)
+        mat = np.ascontiguousarray(x).reshape(-1, x.shape[-1])
+        return mat, mat.shape[0], mat.shape[1], max(1, mat.shape[1])
+    
+    def _row_op(self, name: str, x: np.ndarray, out: Optional[np.ndarray], params: Tuple,
+                fallback) -> np.ndarray:
+        """逐行算子公共路径: out 为连续数组，可与 x 相同 (原地)"""
+        mat, rows, cols, ld = self._row_matrix(x)
+        result = self._elementwise_output(np.shape(x), out)
+        
+        if self.simd_lib_loaded and self.simd_lib and result.size > 0:
+            status = getattr(self.simd_lib, name)(
+                self._float_ptr(mat), ld, *params[:-1], self._float_ptr(result), cols,
+                rows, cols, params[-1]
+            )
+            if status != 0:
+                raise ValueError(f"原生库拒绝了 {name} 的参数")
+            return result
+        
+        # 回退到NumPy
+        result[...] = fallback(mat.reshape(np.shape(x)))
+        return result
+    
+    @staticmethod
+    def _optional_vector(v: Optional[np.ndarray], cols: int, what: str) -> Optional[np.ndarray]:
+        if v is None:
+            return None
+        v = np.ascontiguousarray(v, dtype=np.float32).reshape(-1)
+        if v.size != cols:
+            raise ValueError(f"{what} 的长度 {v.size} 与最后一维 {cols} 不一致")
+        return v
+    
+    def softmax(self, x: np.ndarray, axis: int = -1, scale: float = 1.0,
+                out: Optional[np.ndarray] = None) -> np.ndarray:
+        """
+        数值稳定的 softmax(scale * x)，按块在线合并最大值与归一化因子，每行只读一次
+        
+        Args:
+            x: 输入数组
+            axis: 归一化的轴（非最后一维时先移到最后一维）
+            scale: 输入缩放（如注意力的 1/sqrt(d)）
+            out: 可选的输出数组（连续float32，可与x相同）
+            
+        Returns:
+            softmax 结果；整行为 -inf 时输出 0
+        """
+        x = np.asarray(x, dtype=np.float32)
+        if x.ndim > 0 and axis % x.ndim != x.ndim - 1:
+            if out is not None:
+                raise ValueError("非最后一维的 softmax 不支持 out")
+            return np.moveaxis(self.softmax(np.moveaxis(x, axis, -1), scale=scale), -1, axis)
+        return self._row_op("simd_softmax", x, out, (scale,),
+                            lambda v: _softmax_numpy(v, scale))
+    
+    def rms_norm(self, x: np.ndarray, weight: Optional[np.ndarray] = None, eps: float = 1e-6,
+                 out: Optional[np.ndarray] = None) -> np.ndarray:
+        """
+        RMSNorm: x / sqrt(mean(x^2) + eps) * weight，按最后一维归一化，缩放在写回时融合
+        """
+        x = np.asarray(x, dtype=np.float32)
+        w = self._optional_vector(weight, x.shape[-1] if x.ndim else 0, "weight")
+        
+        def fallback(v):
+            r = v / np.sqrt(np.mean(np.square(v), axis=-1, keepdims=True) + np.float32(eps))
+            return r * w if w is not None else r
+        return self._row_op("simd_rmsnorm", x, out,
+                            (self._float_ptr(w) if w is not None else None, eps), fallback)
+    
+    def layer_norm(self, x: np.ndarray, weight: Optional[np.ndarray] = None,
+                   bias: Optional[np.ndarray] = None, eps: float = 1e-5,
+                   out: Optional[np.ndarray] = None) -> np.ndarray:
+        """
+        LayerNorm: (x - mean) / sqrt(var + eps) * weight + bias，按最后一维归一化
+        """
+        x = np.asarray(x, dtype=np.float32)
+        cols = x.shape[-1] if x.ndim else 0
+        w = self._optional_vector(weight, cols, "weight")
+        b = self._optional_vector(bias, cols, "bias")
+        
+        def fallback(v):
+            r = (v - np.mean(v, axis=-1, keepdims=True)) / np.sqrt(
+                np.var(v, axis=-1, keepdims=True) + np.float32(eps))
+            r = r * w if w is not None else r
+            return r + b if b is not None else r
+        return self._row_op("simd_layernorm", x, out,
+                            (self._float_ptr(w) if w is not None else None,
+                             self._float_ptr(b) if b is not None else None, eps), fallback)
+    
+    def activation(self, x: np.ndarray, act: str = "silu",
+                   out: Optional[np.ndarray] = None) -> np.ndarray:
+        """
+        逐元素激活 ("relu"/"gelu"/"silu")，GELU 为 tanh 近似，exp 使用多项式 SIMD 近似
+        """
+        if act not in GEMM_ACTIVATIONS:
+            raise ValueError(f"不支持的激活函数: {act}")
+        src = self._elementwise_operand(x)
+        result = self._elementwise_output(src.shape, out)
+        if self.simd_lib_loaded and self.simd_lib:
+            self.simd_lib.simd_activation(GEMM_ACTIVATIONS[act], self._float_ptr(src),
+                                          self._float_ptr(result), result.size)
+            return result
+        result[...] = _activation_numpy(src, GEMM_ACTIVATIONS[act])
+        return result
+    
+    def silu(self, x: np.ndarray, out: Optional[np.ndarray] = None) -> np.ndarray:
+        return self.activation(x, "silu", out)
+    
+    def gelu(self, x: np.ndarray, out: Optional[np.ndarray] = None) -> np.ndarray:
+        return self.activation(x, "gelu", out)
+    
+    def gated_activation(self, gate: np.ndarray, up: np.ndarray, act: str = "silu",
+                         out: Optional[np.ndarray] = None) -> np.ndarray:
+        """
+        门控激活 act(gate) * up（SwiGLU / GeGLU），一次遍历完成
+        """
+        if act not in GEMM_ACTIVATIONS:
+            raise ValueError(f"不支持的激活函数: {act}")
+        kind = GEMM_ACTIVATIONS[act]
+        g = self._elementwise_operand(gate)
+        u = self._elementwise_operand(up)
+        if g.shape != u.shape:
+            raise ValueError(f"gate 与 up 的形状不一致: {g.shape} vs {u.shape}")
+        result = self._elementwise_output(g.shape, out)
+        if self.simd_lib_loaded and self.simd_lib:
+            self.simd_lib.simd_gated_activation(kind, self._float_ptr(g), self._float_ptr(u),
+                                                self._float_ptr(result), result.size)
+            return result
+        result[...] = _activation_numpy(g, kind) * u
+        return result
+    
+    def rope_tables(self, positions: np.ndarray, rotary_dim: int,
+                    theta: float = 10000.0) -> Tuple[np.ndarray, np.ndarray]:
+        """
+        旋转位置编码的 cos/sin 表，形状为 (len(positions), rotary_dim // 2)
+        """
+        if rotary_dim <= 0 or rotary_dim % 2:
+            raise ValueError(f"rotary_dim 必须是正偶数: {rotary_dim}")
+        pos = np.ascontiguousarray(positions, dtype=np.int32).reshape(-1)
+        half = rotary_dim // 2
+        cos = np.empty((pos.size, half), dtype=np.float32)
+        sin = np.empty((pos.size, half), dtype=np.float32)
+        if self.simd_lib_loaded and self.simd_lib:
+            self.simd_lib.simd_rope_tables(pos.ctypes.data_as(ctypes.POINTER(ctypes.c_int)), pos.size,
+                                           rotary_dim, theta, self._float_ptr(cos), self._float_ptr(sin))
+            return cos, sin
+        inv_freq = np.power(float(theta), -2.0 * np.arange(half) / rotary_dim)
+        angle = np.outer(pos.astype(np.float64), inv_freq)
+        cos[...] = np.cos(angle)
+        sin[...] = np.sin(angle)
+        return cos, sin
+    
+    def rope(self, x: np.ndarray, positions: Optional[np.ndarray] = None, theta: float = 10000.0,
+             rotary_dim: Optional[int] = None, interleaved: bool = False,
+             cos: Optional[np.ndarray] = None, sin: Optional[np.ndarray] = None) -> np.ndarray:
+        """
+        原地施加旋转位置编码
+        
+        Args:
+            x: (..., seq, head_dim) 的可写float32数组，最后一维须连续；前导维视为多个头
+               （如 (heads, seq, dim) 或 (seq, heads, dim) 的转置视图，不复制）
+            positions: 各 token 的位置，默认 0..seq-1
+            theta: 频率基数
+            rotary_dim: 旋转的维度数（默认 head_dim，部分旋转时只处理前 rotary_dim 维）
+            interleaved: False 为 NeoX/LLaMA/Qwen 的前后半配对，True 为 GPT-J 的相邻配对
+            cos, sin: 预先计算的 (seq, rotary_dim // 2) 表，给出时忽略 positions 与 theta
+            
+        Returns:
+            x 本身
+        """
+        if (not isinstance(x, np.ndarray) or x.dtype != np.float32 or x.ndim < 2
+                or not x.flags.writeable or x.strides[-1] != 4):
+            raise ValueError("rope 要求最后一维连续、至少二维的可写float32数组")
+        seq, head_dim = x.shape[-2:]
+        rotary_dim = head_dim if rotary_dim is None else rotary_dim
+        if rotary_dim <= 0 or rotary_dim % 2 or rotary_dim > head_dim:
+            raise ValueError(f"rotary_dim 必须是不超过 head_dim 的正偶数: {rotary_dim}")
+        if cos is None or sin is None:
+            pos = np.arange(seq) if positions is None else positions
+            cos, sin = self.rope_tables(pos, rotary_dim, theta)
+        cos = np.ascontiguousarray(cos, dtype=np.float32)
+        sin = np.ascontiguousarray(sin, dtype=np.float32)
+        if cos.shape != (seq, rotary_dim // 2) or sin.shape != cos.shape:
+            raise ValueError(f"cos/sin 的形状应为 {(seq, rotary_dim // 2)}")
+        
+        heads = x.view()
         try:
-            if self.simd_lib_loaded and self.simd_lib:
-                # 将数组展平为1D
-                a_flat = a_aligned.flatten()
-                b_flat = b_aligned.flatten()
-                c_flat = c_aligned.flatten()
-                result_flat = np.zeros_like(a_flat, dtype=np.float32)
-                n = a_flat.size
-                
-                # 获取数组指针
-                a_ptr = a_flat.ctypes.data_as(ctypes.POINTER(ctypes.c_float))
-                b_ptr = b_flat.ctypes.data_as(ctypes.POINTER(ctypes.c_float))
-                c_ptr = c_flat.ctypes.data_as(ctypes.POINTER(ctypes.c_float))
-                result_ptr = result_flat.ctypes.data_as(ctypes.POINTER(ctypes.c_float))
-                
-                # 调用基准函数
-                self.simd_lib.fma_baseline(a_ptr, b_ptr, c_ptr, result_ptr, n)
-                return result_flat.reshape(a_aligned.shape)
-        except Exception as e:
-            logger.warning(f"SIMD融合乘加失败: {str(e)}，回退到NumPy")
+            heads.shape = (-1, seq, head_dim)
+        except AttributeError:
+            heads = None
+        if (heads is not None and self.simd_lib_loaded and self.simd_lib and x.size > 0
+                and all(st % 4 == 0 for st in heads.strides)):
+            self.simd_lib.simd_rope(self._float_ptr(heads), seq, heads.shape[0],
+                                    heads.strides[1] // 4, heads.strides[0] // 4,
+                                    self._float_ptr(cos), self._float_ptr(sin),
+                                    rotary_dim, int(interleaved))
+            return x
+        
+        # 回退到NumPy
+        _rope_numpy(x, cos, sin, interleaved)
+        return x
+    
+    @staticmethod
+    def _attention_operand(x: np.ndarray, name: str) -> np.ndarray:
+        """注意力输入: (heads, seq, head_dim)，最后一维连续即可 ((seq, heads, dim) 的转置视图不复制)"""
+        x = np.asarray(x, dtype=np.float32)
+        if x.ndim == 2:
+            x = x[None]
+        if x.ndim != 3:
+            raise ValueError(f"{name} 的形状应为 (heads, seq, head_dim): {x.shape}")
+        if x.strides[-1] != 4 or any(st % 4 for st in x.strides):
+            x = np.ascontiguousarray(x)
+        return x
+    
+    def attention(self, q: np.ndarray, k: np.ndarray, v: np.ndarray, causal: bool = False,
+                  scale: Optional[float] = None, out: Optional[np.ndarray] = None) -> np.ndarray:
+        """
+        融合注意力 softmax(scale * Q K^T) V，按块在线 softmax，不构造完整的分数矩阵
+        
+        Args:
+            q: (n_heads, n_q, head_dim)，二维时视为单头
+            k, v: (n_kv_heads, n_kv, head_dim)，n_kv_heads 须整除 n_heads (GQA/MQA)
+            causal: 查询 i 只看到键 j <= i + n_kv - n_q（右下对齐，适用于带 KV 缓存的解码）
+            scale: 默认 1/sqrt(head_dim)
+            out: 可选的输出数组，形状与 q 相同，最后一维连续
+            
+        Returns:
+            与 q 形状相同的输出
+        """
+        squeeze = np.ndim(q) == 2
+        qa = self._attention_operand(q, "q")
+        ka = self._attention_operand(k, "k")
+        va = self._attention_operand(v, "v")
+        n_heads, n_q, d = qa.shape
+        n_kv_heads, n_kv = ka.shape[:2]
+        if ka.shape[2] != d or va.shape != ka.shape or n_heads % n_kv_heads:
+            raise ValueError(f"注意力输入形状不匹配: q {qa.shape}, k {ka.shape}, v {va.shape}")
+        scale = 1.0 / np.sqrt(d) if scale is None else float(scale)
+        
+        if out is None:
+            result = np.empty(qa.shape, dtype=np.float32)
+        else:
+            result = out[None] if squeeze else out
+            if (not isinstance(out, np.ndarray) or out.dtype != np.float32
+                    or result.shape != qa.shape or result.strides[-1] != 4):
+                raise ValueError(f"out 必须是形状为 {np.shape(q)}、最后一维连续的float32数组")
+        if n_q == 0 or n_kv == 0:
+            result[...] = 0.0
+            return result[0] if squeeze else result
+        
+        if self.simd_lib_loaded and self.simd_lib:
+            st = lambda x: [x.strides[1] // 4, x.strides[0] // 4]
+            params = SimdAttentionParams(n_q, n_kv, d, n_heads, n_kv_heads,
+                                         *st(qa), *st(ka), *st(va), *st(result),
+                                         scale, int(causal))
+            status = self.simd_lib.simd_attention(ctypes.byref(params), self._float_ptr(qa),
+                                                  self._float_ptr(ka), self._float_ptr(va),
+                                                  self._float_ptr(result))
+            if status == 0:
+                return result[0] if squeeze else result
+            logger.warning(f"SIMD融合注意力失败 (状态 {status})，回退到NumPy")
         
         # 回退到NumPy
-        return a_aligned * b_aligned + c_aligned
+        result[...] = _attention_numpy(qa, ka, va, causal, scale)
+        return result[0] if squeeze else result
+    
+    def open_tensor_store(self, path: str) -> TensorStore:
+        """
+        以只读 mmap 打开 safetensors 权重 (单个文件、*.safetensors.index.json 或目录)，
+        张量以零拷贝只读数组返回
+        """
+        if not self.simd_lib_loaded or not self.simd_lib:
+            raise RuntimeError("SIMD库未加载，无法打开张量存储")
+        return TensorStore(self.simd_lib, path)
+    
+    def create_prefetcher(self, n_slots: int = 2, slot_bytes: int = 256 << 20,
+                          n_threads: int = 2) -> WeightPrefetcher:
+        """
+        创建逐层权重预取器: n_slots 个 slot_bytes 字节的缓冲区 (需容纳最大的一层)，
+        n_threads 个后台 I/O 线程
+        """
+        if not self.simd_lib_loaded or not self.simd_lib:
+            raise RuntimeError("SIMD库未加载，无法创建预取器")
+        return WeightPrefetcher(self.simd_lib, n_slots, slot_bytes, n_threads)
+    
+    def create_kv_cache(self, n_layers: int, n_kv_heads: int, head_dim: int,
+                        n_blocks: Optional[int] = None, block_size: int = 16,
+                        dtype: str = "f32", max_bytes: Optional[int] = None) -> "PagedKvCache":
+        """
+        创建原生分页 KV 缓存，池在创建时一次性预留
+        
+        Args:
+            n_blocks: 池中块数；未给出时由 max_bytes 推算
+            block_size: 每块 token 数
+            dtype: "f32"、"int8" 或 "fp8" (每个 token、每个头一个缩放)
+            max_bytes: 缓存内存上限 (字节)
+        """
+        if not self.simd_lib_loaded or not self.simd_lib:
+            raise RuntimeError("SIMD库未加载，无法创建分页KV缓存")
+        if dtype not in KV_DTYPES:
+            raise ValueError(f"不支持的KV缓存类型: {dtype}，可选 {list(KV_DTYPES)}")
+        if n_blocks is None:
+            if max_bytes is None:
+                raise ValueError("需要指定 n_blocks 或 max_bytes")
+            rows = n_layers * 2 * n_kv_heads * block_size
+            block_bytes = rows * head_dim * (4 if dtype == "f32" else 1) + (0 if dtype == "f32" else rows * 4)
+            n_blocks = int(max_bytes) // block_bytes
+        config = SimdKvCacheConfig(n_layers, n_kv_heads, head_dim, block_size, int(n_blocks),
+                                   KV_DTYPES[dtype])
+        handle = self.simd_lib.simd_kv_cache_create(ctypes.byref(config))
+        if not handle:
+            raise MemoryError(f"分页KV缓存创建失败: {n_blocks} 块 x {block_size} token")
+        return PagedKvCache(self.simd_lib, handle, config)
+    
+    def create_sampler(self, temperature: float = 1.0, top_k: int = 0, top_p: float = 1.0,
+                       repetition_penalty: float = 1.0, presence_penalty: float = 0.0,
+                       frequency_penalty: float = 0.0, seed: int = 0) -> "TokenSampler":
+        """
+        创建 logits 采样器，每次调用返回一个 token id
+        
+        Args:
+            temperature: <= 0 时贪心
+            top_k: <= 0 时不限制
+            top_p: (0, 1]，1 时不限制
+            repetition_penalty: history 中的 token，logit > 0 时除以该值，否则乘以该值
+            presence_penalty / frequency_penalty: 按是否出现 / 出现次数减去的值
+            seed: 随机数种子
+        """
+        lib = self.simd_lib if self.simd_lib_loaded and self.simd_lib else None
+        return TokenSampler(lib, temperature, top_k, top_p, repetition_penalty,
+                            presence_penalty, frequency_penalty, seed)
+    
+    def _check_quant_arrays(self, vec, qweight, mul, scales, zeros, g_idx=None,
+                            layout: str = "grouped", per_word: int = 4):
+        """
+        验证量化矩阵乘的输入数组类型、内存布局与相互一致的形状 (原生内核不检查越界)
+        
+        Args:
+            layout: "grouped" (vecquant8matmul)、"row" (*_batched) 或 "column" (*_column_compression)
+            per_word: 每个 int32 打包的权重数 (8 位为 4，4 位为 8)
+        """
+        if not self.simd_lib_loaded or not self.simd_lib:
+            raise RuntimeError("SIMD库未加载，无法执行量化矩阵乘")
+        self._validate_arrays(vec, mul, scales)
+        for arr in (qweight, zeros) + ((g_idx,) if g_idx is not None else ()):
+            if not isinstance(arr, np.ndarray) or arr.dtype != np.int32:
+                raise TypeError("qweight/zeros/g_idx 必须是int32类型的NumPy数组")
+            if not arr.flags.c_contiguous:
+                raise ValueError("输入数组必须是内存连续的")
+        
+        def expect(name, arr, shape):
+            if arr.shape != tuple(shape):
+                raise ValueError(f"{name} 形状应为 {tuple(shape)}，实际为 {arr.shape}")
+        
+        words = lambda n: (n + per_word - 1) // per_word
+        if layout == "grouped":
+            if vec.ndim != 2 or qweight.ndim != 2 or scales.ndim != 2:
+                raise ValueError("vec/qweight/scales 必须是二维数组")
+            batch, height = vec.shape
+            width = qweight.shape[1]
+            groups = scales.shape[0]
+            if groups <= 0:
+                raise ValueError("scales 至少需要一个分组")
+            expect("qweight", qweight, (words(height), width))
+            expect("mul", mul, (batch, width))
+            expect("scales", scales, (groups, width))
+            expect("zeros", zeros, (groups, words(width)))
+            expect("g_idx", g_idx, (height,))
+            if height > 0 and (g_idx.min() < 0 or g_idx.max() >= groups):
+                raise ValueError(f"g_idx 取值必须在 [0, {groups}) 内")
+            return
+        if vec.ndim != 4 or qweight.ndim != 4:
+            raise ValueError("vec/qweight 必须是四维数组 [batch, heads, ...]")
+        batch, heads, vec_row, height = vec.shape
+        if layout == "row":
+            width = qweight.shape[3]
+            expect("qweight", qweight, (batch, heads, words(height), width))
+            expect("mul", mul, (batch, heads, vec_row, width))
+            expect("scales", scales, (batch, heads, width))
+            if zeros.shape not in ((batch, heads, width), (batch, heads, words(width))):
+                raise ValueError(f"zeros 形状应为 {(batch, heads, width)} (未打包) 或 "
+                                 f"{(batch, heads, words(width))} (打包)，实际为 {zeros.shape}")
+        else:
+            width = qweight.shape[3] * per_word
+            expect("qweight", qweight, (batch, heads, height, qweight.shape[3]))
+            expect("mul", mul, (batch, heads, vec_row, width))
+            expect("scales", scales, (batch, heads, height))
+            expect("zeros", zeros, (batch, heads, height))
+    
+    @staticmethod
+    def _float_ptr(arr: np.ndarray):
+        return arr.ctypes.data_as(ctypes.POINTER(ctypes.c_float))
+    
+    @staticmethod
+    def _int_ptr(arr: np.ndarray):
+        return arr.ctypes.data_as(ctypes.POINTER(ctypes.c_int))
+    
+    def vecquant8matmul(self, vec: np.ndarray, qweight: np.ndarray, mul: np.ndarray,
+                        scales: np.ndarray, zeros: np.ndarray, g_idx: np.ndarray) -> np.ndarray:
+        """
+        8位分组量化矩阵乘，直接使用 AutoGPTQ 打包权重，结果累加到 mul 上
+        
+        Args:
+            vec: 输入 [batch, vec_height]
+            qweight: 打包权重 [vec_height / 4, width]
+            mul: 输出 [batch, width]，原地累加
+            scales: 缩放 [groups, width]
+            zeros: 打包零点 [groups, width / 4]
+            g_idx: 分组索引 [vec_height]
+            
+        Returns:
+            mul
+        """
+        self._check_quant_arrays(vec, qweight, mul, scales, zeros, g_idx)
+        self.simd_lib.vecquant8matmul(
+            self._float_ptr(vec), self._int_ptr(qweight), self._float_ptr(mul),
+            self._float_ptr(scales), self._int_ptr(zeros), self._int_ptr(g_idx),
+            vec.shape[0], vec.shape[1], qweight.shape[1], scales.shape[0], zeros.shape[1]
+        )
+        return mul
+    
+    def _vecquant_batched(self, name, per_word, vec, qweight, mul, scales, zeros):
+        self._check_quant_arrays(vec, qweight, mul, scales, zeros, layout="row", per_word=per_word)
+        batch, heads, vec_row, vec_height = vec.shape
+        getattr(self.simd_lib, name)(
+            self._float_ptr(vec), self._int_ptr(qweight), self._float_ptr(mul),
+            self._float_ptr(scales), self._int_ptr(zeros),
+            batch, heads, vec_row, vec_height, qweight.shape[3], zeros.shape[2]
+        )
+        return mul
+    
+    def vecquant8matmul_batched(self, vec: np.ndarray, qweight: np.ndarray, mul: np.ndarray,
+                                scales: np.ndarray, zeros: np.ndarray) -> np.ndarray:
+        """
+        8位批量量化矩阵乘，vec [batch, heads, vec_row, vec_height]，
+        qweight [batch, heads, vec_height / 4, width]，结果累加到 mul 上
+        """
+        return self._vecquant_batched("vecquant8matmul_batched", 4, vec, qweight, mul, scales, zeros)
+    
+    def vecquant4matmul_batched(self, vec: np.ndarray, qweight: np.ndarray, mul: np.ndarray,
+                                scales: np.ndarray, zeros: np.ndarray) -> np.ndarray:
+        """
+        4位批量量化矩阵乘，qweight [batch, heads, vec_height / 8, width]，结果累加到 mul 上
+        """
+        return self._vecquant_batched("vecquant4matmul_batched", 8, vec, qweight, mul, scales, zeros)
+    
+    def _vecquant_column_compression(self, name, per_word, vec, qweight, mul, scales, zeros):
+        self._check_quant_arrays(vec, qweight, mul, scales, zeros, layout="column",
+                                 per_word=per_word)
+        batch, heads, vec_row, height = vec.shape
+        getattr(self.simd_lib, name)(
+            self._float_ptr(vec), self._int_ptr(qweight), self._float_ptr(mul),
+            self._float_ptr(scales), self._int_ptr(zeros),
+            batch, heads, vec_row, height, qweight.shape[3] * per_word
+        )
+        return mul
+    
+    def vecquant8matmul_batched_column_compression(self, vec: np.ndarray, qweight: np.ndarray,
+                                                   mul: np.ndarray, scales: np.ndarray,
+                                                   zeros: np.ndarray) -> np.ndarray:
+        """
+        8位列压缩批量量化矩阵乘，qweight [batch, heads, height, width / 4]，
+        scales/zeros [batch, heads, height]，结果累加到 mul 上
+        """
+        return self._vecquant_column_compression(
+            "vecquant8matmul_batched_column_compression", 4, vec, qweight, mul, scales, zeros)
+    
+    def vecquant4matmul_batched_column_compression(self, vec: np.ndarray, qweight: np.ndarray,
+                                                   mul: np.ndarray, scales: np.ndarray,
+                                                   zeros: np.ndarray) -> np.ndarray:
+        """
+        4位列压缩批量量化矩阵乘，qweight [batch, heads, height, width / 8]，结果累加到 mul 上
+        """
+        return self._vecquant_column_compression(
+            "vecquant4matmul_batched_column_compression", 8, vec, qweight, mul, scales, zeros)
+    
+    def pack_int8_weights(self, weights: np.ndarray,
+                          scales: Optional[np.ndarray] = None) -> "Int8PackedWeights":
+        """
+        预打包 INT8 GEMM 权重
+        
+        Args:
+            weights: float32 权重 [K, N] (按输出通道量化)，
+                     或已量化的 int8 权重 [K, N] (此时须提供 scales，取值限制在 [-127, 127])
+            scales: int8 权重的每输出通道缩放 [N]
+            
+        Returns:
+            Int8PackedWeights: 打包后的权重句柄
+        """
+        if not self.simd_lib_loaded or not self.simd_lib:
+            raise RuntimeError("SIMD库未加载，无法执行INT8矩阵乘")
+        if not isinstance(weights, np.ndarray) or weights.ndim != 2:
+            raise ValueError("权重必须是二维NumPy数组")
+        weights = np.ascontiguousarray(weights)
+        K, N = weights.shape
+        if weights.dtype == np.int8:
+            if scales is None:
+                raise ValueError("int8 权重必须提供每输出通道的 scales")
+            scales = np.ascontiguousarray(scales, dtype=np.float32)
+            if scales.shape != (N,):
+                raise ValueError("scales 形状必须为 [N]")
+            if (weights == -128).any():
+                raise ValueError("int8 权重取值必须在 [-127, 127] 内")
+            handle = self.simd_lib.simd_int8_pack_quantized(
+                weights.ctypes.data_as(ctypes.POINTER(ctypes.c_int8)),
+                self._float_ptr(scales), K, N, N)
+        else:
+            weights = np.ascontiguousarray(weights, dtype=np.float32)
+            handle = self.simd_lib.simd_int8_pack_weights(self._float_ptr(weights), K, N, N)
+        if not handle:
+            raise MemoryError("INT8 权重打包失败")
+        return Int8PackedWeights(self.simd_lib, handle, K, N)
+    
+    def int8_matmul(self, a: np.ndarray, packed: "Int8PackedWeights") -> np.ndarray:
+        """
+        INT8 矩阵乘: a [M, K] 按行动态量化后与预打包权重相乘
+        
+        Returns:
+            np.ndarray: float32 结果 [M, N]
+        """
+        if not self.simd_lib_loaded or not self.simd_lib:
+            raise RuntimeError("SIMD库未加载，无法执行INT8矩阵乘")
+        a = np.ascontiguousarray(a, dtype=np.float32)
+        if a.ndim != 2 or a.shape[1] != packed.K:
+            raise ValueError(f"输入形状不匹配: {a.shape} x ({packed.K}, {packed.N})")
+        out = np.empty((a.shape[0], packed.N), dtype=np.float32)
+        if a.shape[0] > 0:
+            ret = self.simd_lib.simd_int8_gemm(self._float_ptr(a), packed.K, packed.handle,
+                                               self._float_ptr(out), packed.N, a.shape[0])
+            if ret == -2:
+                raise MemoryError("INT8 矩阵乘激活缓冲区分配失败")
+            if ret != 0:
+                raise ValueError(f"INT8 矩阵乘参数非法 (错误码 {ret})")
+        return out
+    
+    def _gemv_vectors(self, x, bias, N, K):
+        """检查 GEMV 的输入向量与偏置，返回 (x, bias 指针, 输出)"""
+        if not self.simd_lib_loaded or not self.simd_lib:
+            raise RuntimeError("SIMD库未加载，无法执行GEMV")
+        x = np.ascontiguousarray(x, dtype=np.float32).reshape(-1)
+        if x.shape[0] != K:
+            raise ValueError(f"输入向量长度不匹配: {x.shape[0]} != {K}")
+        bias_ptr = None
+        if bias is not None:
+            bias = np.ascontiguousarray(bias, dtype=np.float32).reshape(-1)
+            if bias.shape[0] != N:
+                raise ValueError(f"bias 长度必须为 {N}")
+            bias_ptr = self._float_ptr(bias)
+        return x, bias, bias_ptr, np.empty(N, dtype=np.float32)
+    
+    @staticmethod
+    def _gemv_weight(weight, dtype):
+        """返回行连续的二维权重与行距 (行切片视图无需复制)"""
+        if not isinstance(weight, np.ndarray) or weight.ndim != 2:
+            raise ValueError("权重必须是二维NumPy数组 [N, K]")
+        if weight.shape[0] <= 1:
+            weight = np.ascontiguousarray(weight, dtype=dtype)
+            return weight, weight.shape[1]
+        if weight.dtype != dtype or weight.strides[1] != weight.itemsize or \
+                weight.strides[0] % weight.itemsize != 0 or \
+                weight.strides[0] < weight.shape[1] * weight.itemsize:
+            weight = np.ascontiguousarray(weight, dtype=dtype)
+        return weight, weight.strides[0] // weight.itemsize
+    
+    def gemv(self, weight: np.ndarray, x: np.ndarray,
+             bias: Optional[np.ndarray] = None) -> np.ndarray:
+        """
+        GEMV: y = weight @ x (+ bias)，用于 batch 1 解码
+        
+        Args:
+            weight: float32 或 float16 权重 [N, K] (Linear 层布局)
+            x: 输入向量 [K]
+            bias: 偏置 [N]，可选
+            
+        Returns:
+            np.ndarray: float32 结果 [N]
+        """
+        dtype = np.float16 if isinstance(weight, np.ndarray) and weight.dtype == np.float16 \
+            else np.float32
+        weight, ldw = self._gemv_weight(weight, dtype)
+        N, K = weight.shape
+        x, bias, bias_ptr, out = self._gemv_vectors(x, bias, N, K)
+        if dtype == np.float16:
+            self.simd_lib.simd_gemv_f16(weight.ctypes.data_as(ctypes.POINTER(ctypes.c_uint16)),
+                                        ldw, self._float_ptr(x), bias_ptr,
+                                        self._float_ptr(out), N, K)
+        else:
+            self.simd_lib.simd_gemv_f32(self._float_ptr(weight), ldw, self._float_ptr(x),
+                                        bias_ptr, self._float_ptr(out), N, K)
+        return out
+    
+    @staticmethod
+    def quantize_gemv_q8(weight: np.ndarray) -> Tuple[np.ndarray, np.ndarray]:
+        """按输出行对称量化 [N, K] 权重，返回 (int8 权重, scales [N])"""
+        weight = np.asarray(weight, dtype=np.float32)
+        scales = np.abs(weight).max(axis=1) / 127.0
+        scales[scales == 0] = 1.0
+        q = np.clip(np.rint(weight / scales[:, None]), -127, 127).astype(np.int8)
+        return q, scales.astype(np.float32)
+    
+    @staticmethod
+    def quantize_gemv_q4(weight: np.ndarray, group_size: int = 128) -> Tuple[np.ndarray, np.ndarray]:
+        """
+        按组对称量化 [N, K] 权重为 int4，返回 (打包权重 uint8 [N, K / 2], scales [N, K / group_size])
+        每字节低 4 位为偶数列，存储值为 q + 8
+        """
+        weight = np.asarray(weight, dtype=np.float32)
+        N, K = weight.shape
+        if group_size <= 0 or group_size % 2 != 0 or K % group_size != 0:
+            raise ValueError("group_size 须为偶数且整除 K")
+        groups = weight.reshape(N, K // group_size, group_size)
+        scales = np.abs(groups).max(axis=2) / 7.0
+        scales[scales == 0] = 1.0
+        q = np.clip(np.rint(groups / scales[:, :, None]), -8, 7).astype(np.int32) + 8
+        q = q.reshape(N, K).astype(np.uint8)
+        packed = (q[:, 0::2] | (q[:, 1::2] << 4)).astype(np.uint8)
+        return np.ascontiguousarray(packed), scales.astype(np.float32)
+    
+    def gemv_q8(self, weight: np.ndarray, scales: np.ndarray, x: np.ndarray,
+                bias: Optional[np.ndarray] = None) -> np.ndarray:
+        """
+        int8 权重 GEMV: y[n] = scales[n] * (weight[n] @ x) (+ bias)
+        
+        Args:
+            weight: int8 权重 [N, K]
+            scales: 每输出行缩放 [N]
+        """
+        weight, ldw = self._gemv_weight(weight, np.int8)
+        N, K = weight.shape
+        scales = np.ascontiguousarray(scales, dtype=np.float32).reshape(-1)
+        if scales.shape[0] != N:
+            raise ValueError("scales 形状必须为 [N]")
+        x, bias, bias_ptr, out = self._gemv_vectors(x, bias, N, K)
+        self.simd_lib.simd_gemv_q8(weight.ctypes.data_as(ctypes.POINTER(ctypes.c_int8)), ldw,
+                                   self._float_ptr(scales), self._float_ptr(x), bias_ptr,
+                                   self._float_ptr(out), N, K)
+        return out
+    
+    def gemv_q4(self, packed: np.ndarray, scales: np.ndarray, x: np.ndarray,
+                bias: Optional[np.ndarray] = None) -> np.ndarray:
+        """
+        int4 权重 GEMV，权重格式见 quantize_gemv_q4
+        
+        Args:
+            packed: 打包权重 uint8 [N, K / 2]
+            scales: 分组缩放 [N, K / group_size]
+        """
+        packed, ldw = self._gemv_weight(packed, np.uint8)
+        N, K = packed.shape[0], packed.shape[1] * 2
+        scales = np.ascontiguousarray(scales, dtype=np.float32)
+        if scales.ndim != 2 or scales.shape[0] != N or scales.shape[1] == 0 or \
+                K % scales.shape[1] != 0:
+            raise ValueError("scales 形状必须为 [N, K / group_size]")
+        group_size = K // scales.shape[1]
+        if group_size % 2 != 0:
+            raise ValueError("group_size 必须为偶数")
+        x, bias, bias_ptr, out = self._gemv_vectors(x, bias, N, K)
+        self.simd_lib.simd_gemv_q4(packed.ctypes.data_as(ctypes.POINTER(ctypes.c_uint8)), ldw,
+                                   self._float_ptr(scales), group_size, self._float_ptr(x),
+                                   bias_ptr, self._float_ptr(out), N, K)
+        return out
+    
+    def pack_gemv_weights(self, weight: np.ndarray, scales: Optional[np.ndarray] = None,
+                          replicas: int = 0) -> GemvPackedWeights:
+        """
+        打包 GEMV 权重到大页区域，多 NUMA 节点时每个节点一份副本 (解码时各线程读本节点副本)
+        
+        Args:
+            weight: float32/float16 [N, K]，int8 [N, K] (需 scales [N])，
+                    或 quantize_gemv_q4 打包的 uint8 [N, K / 2] (需 scales [N, K / group_size])
+            scales: 量化缩放，float 权重不需要
+            replicas: 副本数，<= 0 为每个节点一份，1 为单份 (多节点时按页交错)
+        """
+        if not self.simd_lib_loaded or not self.simd_lib:
+            raise RuntimeError("SIMD库未加载，无法打包GEMV权重")
+        if not isinstance(weight, np.ndarray) or weight.ndim != 2:
+            raise ValueError("权重必须是二维NumPy数组")
+        kinds = {np.dtype(np.float32): 0, np.dtype(np.float16): 1,
+                 np.dtype(np.int8): 2, np.dtype(np.uint8): 3}
+        if weight.dtype not in kinds:
+            weight = weight.astype(np.float32)
+        kind = kinds[weight.dtype]
+        weight, ldw = self._gemv_weight(weight, weight.dtype)
+        N = weight.shape[0]
+        K = weight.shape[1] * 2 if kind == 3 else weight.shape[1]
+        scales_ptr, group_size = None, 0
+        if kind >= 2:
+            if scales is None:
+                raise ValueError("量化权重需要 scales")
+            scales = np.ascontiguousarray(scales, dtype=np.float32)
+            if kind == 2 and scales.size != N:
+                raise ValueError("scales 形状必须为 [N]")
+            if kind == 3:
+                if scales.ndim != 2 or scales.shape[0] != N or scales.shape[1] == 0 or \
+                        K % scales.shape[1] != 0 or (K // scales.shape[1]) % 2 != 0:
+                    raise ValueError("scales 形状必须为 [N, K / group_size]，group_size 为偶数")
+                group_size = K // scales.shape[1]
+            scales_ptr = self._float_ptr(scales)
+        handle = self.simd_lib.simd_gemv_pack_weights(kind, weight.ctypes.data, ldw, scales_ptr,
+                                                      group_size, N, K, int(replicas))
+        if not handle:
+            raise MemoryError("GEMV 权重打包失败")
+        return GemvPackedWeights(self.simd_lib, handle, N, K)
+    
+    def gemv_packed(self, packed: GemvPackedWeights, x: np.ndarray,
+                    bias: Optional[np.ndarray] = None) -> np.ndarray:
+        """使用 pack_gemv_weights 打包的权重计算 y = W @ x (+ bias)"""
+        x, bias, bias_ptr, out = self._gemv_vectors(x, bias, packed.N, packed.K)
+        self.simd_lib.simd_gemv_packed(packed.handle, self._float_ptr(x), bias_ptr,
+                                       self._float_ptr(out))
+        return out
+    
+    def get_numa_info(self) -> Optional[Dict]:
+        """NUMA 节点数与调用线程当前所在节点，原生库未加载时返回 None"""
+        if not (self.simd_lib_loaded and self.simd_lib):
+            return None
+        return {"nodes": self.simd_lib.simd_numa_node_count(),
+                "current_node": self.simd_lib.simd_numa_current_node()}
+    
+    def set_numa_policy(self, policy: Optional[str] = None, node: int = -1) -> bool:
+        """
+        设置调用线程之后首次写入的内存页的 NUMA 策略 (default/bind/interleave/preferred)，
+        对此后由该线程首次写入的 NumPy 数组同样生效
+        """
+        if not (self.simd_lib_loaded and self.simd_lib):
+            return False
+        return self.simd_lib.simd_numa_set_thread_policy(NUMA_POLICIES[policy], node) == 0
+    
+    def region_empty(self, shape, dtype=np.float32, hugepage: bool = True, hugetlb: bool = False,
+                     numa_policy: Optional[str] = None, node: int = -1,
+                     populate: bool = False) -> np.ndarray:
+        """
+        在大页/NUMA 区域中创建数组 (内容为 0)，用于长期驻留的大块权重；数组回收时释放区域。
+        实际生效的标志可通过 region_flags(array) 查询
+        """
+        if not (self.simd_lib_loaded and self.simd_lib and HAS_MEMORY_ALIGNMENT):
+            return np.zeros(shape, dtype=dtype)
+        dtype = np.dtype(dtype)
+        size = int(np.prod(shape)) * dtype.itemsize
+        flags = (MEM_HUGEPAGE if hugepage else 0) | (MEM_HUGETLB if hugetlb else 0) | \
+            (MEM_POPULATE if populate else 0)
+        ptr = self.simd_lib.simd_region_alloc(size, flags, NUMA_POLICIES[numa_policy], node)
+        if not ptr:
+            raise MemoryError(f"区域分配 {size} 字节失败")
+        block = NativeBlock(ptr, size, self.simd_lib.simd_region_free)
+        return np.asarray(block).view(dtype).reshape(shape)
+    
+    def region_flags(self, array: np.ndarray) -> Dict[str, bool]:
+        """查询 region_empty 创建的数组实际生效的大页/NUMA 标志"""
+        base = array
+        while isinstance(base, np.ndarray) and base.base is not None:
+            base = base.base
+        flags = self.simd_lib.simd_region_flags(base.ptr) if isinstance(base, NativeBlock) else -1
+        if flags < 0:
+            return {}
+        return {"hugepage": bool(flags & MEM_HUGEPAGE), "hugetlb": bool(flags & MEM_HUGETLB),
+                "populated": bool(flags & MEM_POPULATE), "numa": bool(flags & MEM_NUMA)}
+    
+    def set_num_threads(self, num_threads: int, pin_threads: bool = False) -> bool:
+        """
+        配置原生线程池
+        
+        Args:
+            num_threads: 线程数（含调用线程），<= 0 恢复默认值
+            pin_threads: 是否将工作线程绑定到固定CPU核心
+            
+        Returns:
+            bool: 是否配置成功
+        """
+        if not self.simd_lib_loaded or not self.simd_lib:
+            return False
+        self.simd_lib.simd_set_thread_affinity(1 if pin_threads else 0)
+        self.simd_lib.simd_set_num_threads(int(num_threads))
+        return True
+    
+    def get_num_threads(self) -> int:
+        """获取原生线程池线程数，库未加载时返回1"""
+        if not self.simd_lib_loaded or not self.simd_lib:
+            return 1
+        return self.simd_lib.simd_get_num_threads()
+    
+    def pool_empty(self, shape, dtype=np.float32, alignment: int = 64) -> np.ndarray:
+        """
+        从原生内存池创建未初始化数组 (alignment 为 64 或 4096 以内的 2 的幂)，
+        数组回收后内存块回到池中；原生库未加载时退回 np.empty
+        """
+        if HAS_MEMORY_ALIGNMENT and has_native_pool():
+            return pool_empty(shape, dtype, alignment)
+        return np.empty(shape, dtype=dtype)
+    
+    def create_arena(self, chunk_bytes: int = 4 << 20) -> Optional["NativeArena"]:
+        """
+        创建原生 arena，供一个流水线阶段内的临时数组使用，阶段结束时 reset()
+        
+        Returns:
+            Optional[NativeArena]: 原生库未加载时返回 None
+        """
+        if not (HAS_MEMORY_ALIGNMENT and has_native_pool()):
+            return None
+        return NativeArena(chunk_bytes, self.simd_lib)
+    
+    def get_pool_stats(self) -> Optional[Dict]:
+        """原生内存池统计 (bytes_in_use/bytes_cached/os_allocs/cache_hits)，原生库未加载时返回 None"""
+        if not (self.simd_lib_loaded and self.simd_lib):
+            return None
+        stats = SimdPoolStats()
+        self.simd_lib.simd_pool_stats(ctypes.byref(stats))
+        return {name: getattr(stats, name) for name, _ in SimdPoolStats._fields_}
+    
+    def trim_pool(self):
+        """把原生内存池缓存的空闲块还给系统 (当前线程缓存与全局池)"""
+        if self.simd_lib_loaded and self.simd_lib:
+            self.simd_lib.simd_pool_trim()
     
     def get_performance_stats(self) -> Dict:
         """
@@ -568,6 +2921,69 @@ class SimdOperations:
             "is_correct": is_correct
         }
 
+    def get_cpu_features(self) -> List[str]:
+        """
+        获取原生库运行时检测到的 CPU 特性 (已确认操作系统保存对应寄存器状态)
+
+        Returns:
+            List[str]: 特性名称；原生库未加载时为空列表
+        """
+        if not (self.simd_lib_loaded and self.simd_lib):
+            return []
+        bits = self.simd_lib.simd_get_cpu_features()
+        return [name for i, name in enumerate(CPU_FEATURES) if bits & (1 << i)]
+
+    def get_cache_info(self) -> Optional[Dict]:
+        """
+        获取原生库检测到的缓存拓扑及当前变体的 GEMM 分块
+
+        Returns:
+            Optional[Dict]: 各级缓存大小 (字节)、共享的逻辑 CPU 数、缓存行大小与
+                            gemm_blocking；原生库未加载时返回 None
+        """
+        if not (self.simd_lib_loaded and self.simd_lib):
+            return None
+        info = SimdCacheInfo()
+        self.simd_lib.simd_get_cache_info(ctypes.byref(info))
+        blocking = SimdGemmBlocking()
+        self.simd_lib.simd_get_gemm_blocking(ctypes.byref(blocking))
+        result = {name: getattr(info, name) for name, _ in SimdCacheInfo._fields_}
+        result["source"] = info.source.decode("utf-8")
+        result["gemm_blocking"] = {name: getattr(blocking, name) for name, _ in SimdGemmBlocking._fields_}
+        return result
+
+    def autotune(self, force: bool = False) -> Optional[Dict]:
+        """
+        测量并持久化本机最优的 GEMM 微内核、分块与线程数 (首次约数秒)
+
+        Args:
+            force: 为 True 时忽略已有调优记录重新测量
+
+        Returns:
+            Optional[Dict]: 生效的配置 (kernel/mc/kc/nc/threads/gflops/tuned) 与调优文件路径
+                            file_saved；原生库未加载时返回 None
+        """
+        if not (self.simd_lib_loaded and self.simd_lib):
+            return None
+        result = SimdTuningResult()
+        rc = self.simd_lib.simd_autotune(int(force), ctypes.byref(result))
+        info = result.to_dict()
+        info["file"] = self.simd_lib.simd_get_tuning_file().decode("utf-8")
+        info["file_saved"] = rc == 0
+        if rc != 0:
+            logger.warning(f"GEMM 调优结果未能写入调优文件: {info['file'] or '(无可用路径)'}")
+        return info
+
+    def get_tuning(self) -> Optional[Dict]:
+        """
+        获取当前生效的 GEMM 配置 (tuned 为 False 表示没有调优记录，使用缓存拓扑推导值)
+        """
+        if not (self.simd_lib_loaded and self.simd_lib):
+            return None
+        result = SimdTuningResult()
+        self.simd_lib.simd_get_tuning(ctypes.byref(result))
+        return result.to_dict()
+
     def get_info(self) -> Dict:
         """
         获取SIMD操作信息
@@ -578,7 +2994,13 @@ class SimdOperations:
         return {
             'simd_type': self.simd_type,
             'is_native': self.simd_lib_loaded,
-            'features': self._get_supported_operations(),
+            'active_variant': (self.simd_lib.simd_get_active_variant().decode('utf-8')
+                               if self.simd_lib_loaded and self.simd_lib else 'python'),
+            'int8_variant': (self.simd_lib.simd_int8_get_variant().decode('utf-8')
+                             if self.simd_lib_loaded and self.simd_lib else None),
+            'cache': self.get_cache_info(),
+            'gemm_tuning': self.get_tuning(),
+            'features': self.get_cpu_features(),
             'memory_alignment': self.memory_alignment,
             'has_memory_alignment': HAS_MEMORY_ALIGNMENT
         }
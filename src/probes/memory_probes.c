@@ -14,6 +14,8 @@
 #ifdef _WIN32
 #include <windows.h>
 #else
+#include <fcntl.h>
+#include <pthread.h>
 #include <unistd.h>
 #include <sys/resource.h>
 #endif
@@ -44,6 +46,161 @@ typedef struct {
     int error_code;             /* 错误代码 */
 } MemoryProbeResult;
 
+#ifndef _WIN32
+/*
+ * /proc 快速路径：/proc/self/statm 与 /proc/meminfo 的文件描述符常驻，每次用 pread
+ * 从偏移 0 重新读取，省去 fopen/逐行解析。statm 只有一行页数，比 status 便宜得多；
+ * meminfo 生成代价较高，按 MEMINFO_MAX_AGE_NS 限频，其余时间返回缓存值。
+ * 后台采样线程运行时，RSS 与可用内存都由它刷新，fast_mem_check 只做一次原子读。
+ * fork 后子进程关闭继承的描述符（/proc/self 指向父进程）并停止使用采样值。
+ */
+#define MEMINFO_MAX_AGE_NS 100000000ULL     /* 无采样线程时 meminfo 最多每 100ms 读一次 */
+
+static int statm_fd = -1;
+static int meminfo_fd = -1;
+static uint64_t page_size_bytes = 4096;
+static pthread_once_t proc_once = PTHREAD_ONCE_INIT;
+
+static uint64_t cached_rss_mb = 0;          /* 采样线程写入 */
+static uint64_t cached_avail_mb = 0;
+static uint64_t avail_stamp_ns = 0;         /* cached_avail_mb 的读取时间，0 表示无效 */
+
+static int sampler_running = 0;
+static int sampler_stopping = 0;            /* 停止中: 线程尚未 join，不能启动新线程 */
+static uint32_t sampler_interval_ms = 10;
+static pthread_t sampler_thread;
+static pthread_mutex_t sampler_lock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t sampler_cond = PTHREAD_COND_INITIALIZER;
+static pthread_cond_t sampler_stopped_cond = PTHREAD_COND_INITIALIZER;
+
+static uint64_t monotonic_ns(void) {
+    struct timespec ts;
+#ifdef CLOCK_MONOTONIC_COARSE
+    clock_gettime(CLOCK_MONOTONIC_COARSE, &ts);
+#else
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+#endif
+    return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+static void reset_after_fork(void) {
+    int fd = __atomic_exchange_n(&statm_fd, -1, __ATOMIC_RELAXED);
+    if (fd >= 0) close(fd);
+    fd = __atomic_exchange_n(&meminfo_fd, -1, __ATOMIC_RELAXED);
+    if (fd >= 0) close(fd);
+    /* 采样线程不会被 fork 复制 */
+    __atomic_store_n(&sampler_running, 0, __ATOMIC_RELAXED);
+    sampler_stopping = 0;
+    __atomic_store_n(&avail_stamp_ns, 0, __ATOMIC_RELAXED);
+    pthread_mutex_init(&sampler_lock, NULL);
+    pthread_cond_init(&sampler_cond, NULL);
+    pthread_cond_init(&sampler_stopped_cond, NULL);
+}
+
+static void init_proc(void) {
+    long page = sysconf(_SC_PAGESIZE);
+    if (page > 0) {
+        page_size_bytes = (uint64_t)page;
+    }
+    pthread_atfork(NULL, NULL, reset_after_fork);
+}
+
+/**
+ * 取得常驻描述符，首次使用时打开；多个线程同时打开时只保留一个
+ */
+static int proc_fd(int* slot, const char* path) {
+    int fd = __atomic_load_n(slot, __ATOMIC_ACQUIRE);
+    if (fd >= 0) {
+        return fd;
+    }
+    pthread_once(&proc_once, init_proc);
+    fd = open(path, O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        return -1;
+    }
+    int expected = -1;
+    if (!__atomic_compare_exchange_n(slot, &expected, fd, 0, __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE)) {
+        close(fd);
+        fd = expected;
+    }
+    return fd;
+}
+
+/**
+ * 从偏移 0 读取整个 /proc 文件到 buf（以 0 结尾），返回读到的字节数，失败返回 -1
+ */
+static ssize_t read_proc(int* slot, const char* path, char* buf, size_t size) {
+    int fd = proc_fd(slot, path);
+    if (fd < 0) {
+        return -1;
+    }
+    ssize_t n = pread(fd, buf, size - 1, 0);
+    if (n < 0) {
+        return -1;
+    }
+    buf[n] = '\0';
+    return n;
+}
+
+/* statm 第二列为常驻页数 */
+static uint64_t read_rss_mb(void) {
+    char buf[128];
+    if (read_proc(&statm_fd, "/proc/self/statm", buf, sizeof(buf)) <= 0) {
+        return 0;
+    }
+    char* end;
+    strtoull(buf, &end, 10);
+    uint64_t pages = strtoull(end, NULL, 10);
+    return pages * page_size_bytes / (1024 * 1024);
+}
+
+static uint64_t read_avail_mb(void) {
+    char buf[4096];
+    if (read_proc(&meminfo_fd, "/proc/meminfo", buf, sizeof(buf)) <= 0) {
+        return 0;
+    }
+    const char* line = strstr(buf, "MemAvailable:");
+    if (!line) {
+        return 0;
+    }
+    /* MemAvailable以KB为单位，转换为MB */
+    uint64_t avail = (uint64_t)strtoull(line + 13, NULL, 10) / 1024;
+    __atomic_store_n(&cached_avail_mb, avail, __ATOMIC_RELAXED);
+    __atomic_store_n(&avail_stamp_ns, monotonic_ns(), __ATOMIC_RELEASE);
+    return avail;
+}
+
+static void* sampler_main(void* arg) {
+    (void)arg;
+    pthread_mutex_lock(&sampler_lock);
+    while (__atomic_load_n(&sampler_running, __ATOMIC_ACQUIRE)) {
+        uint32_t interval = sampler_interval_ms;
+        pthread_mutex_unlock(&sampler_lock);
+
+        __atomic_store_n(&cached_rss_mb, read_rss_mb(), __ATOMIC_RELAXED);
+        uint64_t stamp = __atomic_load_n(&avail_stamp_ns, __ATOMIC_ACQUIRE);
+        if (stamp == 0 || monotonic_ns() - stamp >= MEMINFO_MAX_AGE_NS) {
+            read_avail_mb();
+        }
+
+        struct timespec deadline;
+        clock_gettime(CLOCK_REALTIME, &deadline);
+        deadline.tv_sec += interval / 1000;
+        deadline.tv_nsec += (long)(interval % 1000) * 1000000L;
+        if (deadline.tv_nsec >= 1000000000L) {
+            deadline.tv_sec += 1;
+            deadline.tv_nsec -= 1000000000L;
+        }
+        pthread_mutex_lock(&sampler_lock);
+        if (__atomic_load_n(&sampler_running, __ATOMIC_ACQUIRE)) {
+            pthread_cond_timedwait(&sampler_cond, &sampler_lock, &deadline);
+        }
+    }
+    pthread_mutex_unlock(&sampler_lock);
+    return NULL;
+}
+#endif
+
 /**
  * 获取当前进程的内存使用情况
  */
@@ -57,26 +214,15 @@ static uint64_t current_mem(void) {
         memory_usage = (uint64_t)(pmc.WorkingSetSize / (1024 * 1024));
     }
 #else
-    /* Linux/Unix实现 */
-    FILE* file = fopen("/proc/self/status", "r");
-    if (file) {
-        char line[128];
-        while (fgets(line, sizeof(line), file)) {
-            if (strncmp(line, "VmRSS:", 6) == 0) {
-                /* VmRSS以KB为单位，转换为MB */
-                memory_usage = (uint64_t)atoll(line + 6) / 1024;
-                break;
-            }
-        }
-        fclose(file);
-    }
+    /* Linux/Unix实现：pread 常驻的 /proc/self/statm */
+    memory_usage = read_rss_mb();
 #endif
 
     return memory_usage;
 }
 
 /**
- * 获取系统可用内存
+ * 获取系统可用内存（/proc/meminfo 按 MEMINFO_MAX_AGE_NS 限频，其余时间返回缓存值）
  */
 static uint64_t available_mem(void) {
     uint64_t available = 0;
@@ -90,17 +236,11 @@ static uint64_t available_mem(void) {
     }
 #else
     /* Linux/Unix实现 */
-    FILE* file = fopen("/proc/meminfo", "r");
-    if (file) {
-        char line[128];
-        while (fgets(line, sizeof(line), file)) {
-            if (strncmp(line, "MemAvailable:", 13) == 0) {
-                /* MemAvailable以KB为单位，转换为MB */
-                available = (uint64_t)atoll(line + 13) / 1024;
-                break;
-            }
-        }
-        fclose(file);
+    uint64_t stamp = __atomic_load_n(&avail_stamp_ns, __ATOMIC_ACQUIRE);
+    if (stamp != 0 && monotonic_ns() - stamp < MEMINFO_MAX_AGE_NS) {
+        available = __atomic_load_n(&cached_avail_mb, __ATOMIC_RELAXED);
+    } else {
+        available = read_avail_mb();
     }
 #endif
 
@@ -175,11 +315,21 @@ int mem_probe(MemoryProbe* probe, MemoryProbeResult* result) {
 
 /**
  * 快速内存检查点 - 可以在高频调用的代码中使用
+ * 后台采样线程运行时只读取采样值（滞后不超过一个采样周期），否则 pread 一次 statm
  */
 PROBE_SECTION
 void fast_mem_check(uint64_t threshold) {
     /* 快速检查当前内存是否超过阈值 */
-    if (current_mem() > threshold) {
+    uint64_t mem_usage = 0;
+#ifndef _WIN32
+    if (__atomic_load_n(&sampler_running, __ATOMIC_ACQUIRE)) {
+        mem_usage = __atomic_load_n(&cached_rss_mb, __ATOMIC_RELAXED);
+    }
+#endif
+    if (mem_usage == 0) {
+        mem_usage = current_mem();
+    }
+    if (mem_usage > threshold) {
         log_alert("内存超限在函数", __builtin_return_address(0));
     }
 }
@@ -200,6 +350,71 @@ int check_memory_usage(const char* probe_name, uint64_t threshold, MemoryProbeRe
     return mem_probe(&probe, result);
 }
 
+/**
+ * 启动后台采样线程，每 interval_ms 毫秒刷新 RSS 与可用内存（0 表示 10ms）；
+ * 已在运行时只更新周期。成功返回 0，不支持的平台返回 -1
+ */
+int probe_sampler_start(uint32_t interval_ms) {
+#ifdef _WIN32
+    (void)interval_ms;
+    return -1;
+#else
+    if (interval_ms == 0) {
+        interval_ms = 10;
+    }
+    pthread_mutex_lock(&sampler_lock);
+    /* 等正在停止的旧线程 join 完，否则 sampler_thread 会在 join 之前被覆盖 */
+    while (sampler_stopping) {
+        pthread_cond_wait(&sampler_stopped_cond, &sampler_lock);
+    }
+    sampler_interval_ms = interval_ms;
+    if (sampler_running) {
+        pthread_cond_signal(&sampler_cond);
+        pthread_mutex_unlock(&sampler_lock);
+        return 0;
+    }
+    /* 先采样一次，线程启动后 fast_mem_check 立即可用 */
+    __atomic_store_n(&cached_rss_mb, read_rss_mb(), __ATOMIC_RELAXED);
+    read_avail_mb();
+    __atomic_store_n(&sampler_running, 1, __ATOMIC_RELEASE);
+    if (pthread_create(&sampler_thread, NULL, sampler_main, NULL) != 0) {
+        __atomic_store_n(&sampler_running, 0, __ATOMIC_RELEASE);
+        pthread_mutex_unlock(&sampler_lock);
+        return -1;
+    }
+    pthread_mutex_unlock(&sampler_lock);
+    return 0;
+#endif
+}
+
+/**
+ * 停止后台采样线程并等待其退出，之后的检查恢复为直接读取 /proc
+ */
+void probe_sampler_stop(void) {
+#ifndef _WIN32
+    pthread_mutex_lock(&sampler_lock);
+    /* 其他线程正在停止时等它 join 完再返回 */
+    while (sampler_stopping) {
+        pthread_cond_wait(&sampler_stopped_cond, &sampler_lock);
+    }
+    if (!sampler_running) {
+        pthread_mutex_unlock(&sampler_lock);
+        return;
+    }
+    __atomic_store_n(&sampler_running, 0, __ATOMIC_RELEASE);
+    sampler_stopping = 1;
+    pthread_t thread = sampler_thread;
+    pthread_cond_signal(&sampler_cond);
+    pthread_mutex_unlock(&sampler_lock);
+    pthread_join(thread, NULL);
+
+    pthread_mutex_lock(&sampler_lock);
+    sampler_stopping = 0;
+    pthread_cond_broadcast(&sampler_stopped_cond);
+    pthread_mutex_unlock(&sampler_lock);
+#endif
+}
+
 /**
  * 测试函数
  */
@@ -159,7 +159,7 @@ class MemoryProbeWrapper:
             if system == "Windows":
                 cmd = f'cl /LD "{source_file}" /Fe"{output_file}" /DMEMORY_PROBE_MAIN /I"C:\\Program Files (x86)\\Windows Kits\\10\\Include\\10.0.19041.0\\ucrt"'
             else:  # Linux/macOS
-                cmd = f'gcc -shared -fPIC -o "{output_file}" "{source_file}" -DMEMORY_PROBE_MAIN'
+                cmd = f'gcc -shared -fPIC -pthread -o "{output_file}" "{source_file}" -DMEMORY_PROBE_MAIN'
             
             logger.info(f"编译内存探针库: {cmd}")
             
@@ -199,6 +199,13 @@ class MemoryProbeWrapper:
         self.lib.test_memory_probe.argtypes = []
         self.lib.test_memory_probe.restype = ctypes.c_int
         
+        # 配置后台采样函数（旧版本库中不存在）
+        if hasattr(self.lib, "probe_sampler_start"):
+            self.lib.probe_sampler_start.argtypes = [ctypes.c_uint32]  # interval_ms
+            self.lib.probe_sampler_start.restype = ctypes.c_int
+            self.lib.probe_sampler_stop.argtypes = []
+            self.lib.probe_sampler_stop.restype = None
+        
     def check_memory(self, 
                     probe_name: str, 
                     threshold_mb: int = 0) -> Dict[str, Any]:
@@ -255,6 +262,30 @@ class MemoryProbeWrapper:
             
         self.lib.fast_mem_check(ctypes.c_uint64(threshold_mb))
         
+    def start_sampler(self, interval_ms: int = 10) -> bool:
+        """
+        启动C探针的后台采样线程，之后fast_check只读取采样值（亚微秒级）
+        
+        Args:
+            interval_ms: 采样周期（毫秒），/proc/meminfo 最多每100ms读取一次
+            
+        Returns:
+            bool: 是否启动成功（Windows及旧版本库不支持）
+        """
+        if not self.initialized:
+            if not self._initialize():
+                return False
+        
+        if not self.lib or not hasattr(self.lib, "probe_sampler_start"):
+            return False
+            
+        return self.lib.probe_sampler_start(ctypes.c_uint32(interval_ms)) == 0
+        
+    def stop_sampler(self) -> None:
+        """停止后台采样线程"""
+        if self.lib and hasattr(self.lib, "probe_sampler_stop"):
+            self.lib.probe_sampler_stop()
+        
     def test_probe(self) -> Dict[str, Any]:
         """
         测试内存探针
@@ -308,6 +339,21 @@ def fast_check(threshold_mb: int) -> None:
     """
     get_probe_wrapper().fast_check(threshold_mb)
 
+def start_sampler(interval_ms: int = 10) -> bool:
+    """
+    便捷函数：启动C探针后台采样线程
+    
+    Args:
+        interval_ms: 采样周期（毫秒）
+    """
+    return get_probe_wrapper().start_sampler(interval_ms)
+
+def stop_sampler() -> None:
+    """
+    便捷函数：停止C探针后台采样线程（等待线程退出后返回）
+    """
+    get_probe_wrapper().stop_sampler()
+
 if __name__ == "__main__":
     # 配置日志记录
     logging.basicConfig(level=logging.DEBUG, 
@@ -0,0 +1,121 @@
+#!/usr/bin/env python
+# -*- coding: utf-8 -*-
+"""
+原生 SIMD 内核测试夹具
+
+libsimd_kernels 的路径取环境变量 SIMD_KERNELS_LIB，否则依次查找 CMake 构建目录
+(_gate_build/build 下的 lib/) 与项目 lib/；找不到时跳过依赖原生库的测试。
+从项目根目录运行时用 --confcutdir 跳过根目录依赖 PyQt6 的 conftest:
+
+    python -m pytest tests/hardware --confcutdir=tests/hardware
+"""
+
+import functools
+import os
+import subprocess
+import sys
+import textwrap
+from pathlib import Path
+
+import numpy as np
+import pytest
+
+ROOT_DIR = Path(__file__).resolve().parent.parent.parent
+sys.path.insert(0, str(ROOT_DIR))
+
+from src.hardware import simd_wrapper  # noqa: E402
+
+LIB_NAME = os.path.basename(simd_wrapper.SIMD_LIB_PATH)
+
+
+def find_simd_library():
+    """返回 libsimd_kernels 的路径，找不到时返回 None"""
+    env = os.environ.get("SIMD_KERNELS_LIB")
+    if env:
+        return env if os.path.exists(env) else None
+    for build_dir in ("_gate_build", "build"):
+        path = ROOT_DIR / build_dir / "lib" / LIB_NAME
+        if path.exists():
+            return str(path)
+    return simd_wrapper.SIMD_LIB_PATH if os.path.exists(simd_wrapper.SIMD_LIB_PATH) else None
+
+
+SIMD_LIB = find_simd_library()
+
+
+NATIVE_FIXTURES = {"simd_lib_path", "ops", "lib", "run_native", "native_tool"}
+
+
+def pytest_collection_modifyitems(config, items):
+    if SIMD_LIB:
+        return
+    skip = pytest.mark.skip(reason="未找到 libsimd_kernels (设置 SIMD_KERNELS_LIB 或先构建)")
+    for item in items:
+        if NATIVE_FIXTURES & set(getattr(item, "fixturenames", ())):
+            item.add_marker(skip)
+
+
+@pytest.fixture(scope="session")
+def simd_lib_path():
+    return SIMD_LIB
+
+
+@pytest.fixture(scope="session")
+def ops(simd_lib_path):
+    """加载了原生库的 SimdOperations (不回退到 NumPy)"""
+    simd_wrapper.SIMD_LIB_PATH = simd_lib_path
+    instance = simd_wrapper.SimdOperations()
+    assert instance.simd_lib_loaded, f"无法加载 {simd_lib_path}"
+    return instance
+
+
+@pytest.fixture(scope="session")
+def lib(ops):
+    """原生库句柄 (函数签名已由 SimdOperations 配置)"""
+    return ops.simd_lib
+
+
+@pytest.fixture
+def rng():
+    return np.random.default_rng(1234)
+
+
+def _run_native(simd_lib_path, body, env=None, timeout=300):
+    script = textwrap.dedent("""
+        import sys
+        sys.path.insert(0, {root!r})
+        import numpy as np
+        from src.hardware import simd_wrapper
+        simd_wrapper.SIMD_LIB_PATH = {lib!r}
+        ops = simd_wrapper.SimdOperations()
+        assert ops.simd_lib_loaded
+    """).format(root=str(ROOT_DIR), lib=simd_lib_path) + textwrap.dedent(body)
+    full_env = dict(os.environ)
+    full_env.update(env or {})
+    return subprocess.run([sys.executable, "-c", script], env=full_env, capture_output=True,
+                          text=True, timeout=timeout)
+
+
+@pytest.fixture(scope="session")
+def run_native(simd_lib_path):
+    """
+    在子进程中加载原生库并执行代码片段 (其中 ops 为 SimdOperations)，用于加载时读取的
+    环境变量与预期使进程中止的路径: run_native(body, env=None) 返回 CompletedProcess
+    """
+    return functools.partial(_run_native, simd_lib_path)
+
+
+@pytest.fixture(scope="session")
+def native_tool(simd_lib_path):
+    """
+    返回与库同一构建目录下 bin/ 中的原生工具路径 (bench_kernels、roofline)，
+    未构建 (BUILD_BENCHMARKS=OFF) 时跳过
+    """
+    bin_dir = Path(simd_lib_path).resolve().parent.parent / "bin"
+
+    def find(name):
+        for candidate in (bin_dir / name, bin_dir / (name + ".exe")):
+            if candidate.exists():
+                return str(candidate)
+        pytest.skip(f"未找到 {name} (需要 BUILD_BENCHMARKS=ON 的构建)")
+    return find
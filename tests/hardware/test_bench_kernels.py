@@ -0,0 +1,86 @@
+#!/usr/bin/env python
+# -*- coding: utf-8 -*-
+"""
+原生基准测试: bench_kernels 的用例列表、过滤、JSON 报告字段 (运算/字节计数、强度、GFLOP/s)
+与峰值比例 (INT8 用例以 INT8 峰值为分母、带宽以工作集所在级别为分母) 及参数错误
+"""
+
+import json
+import re
+import subprocess
+
+import pytest
+
+pytestmark = pytest.mark.unit
+
+FAST = ["--min_time=0.01", "--repetitions=2", "--threads=1"]
+
+
+def run_bench(native_tool, tmp_path, *args):
+    out = tmp_path / "bench.json"
+    proc = subprocess.run([native_tool("bench_kernels"), *args, f"--json={out}"],
+                          capture_output=True, text=True, timeout=300)
+    assert proc.returncode == 0, proc.stderr
+    return json.loads(out.read_text())
+
+
+def test_list_and_quick_mode(native_tool):
+    exe = native_tool("bench_kernels")
+    full = subprocess.run([exe, "--list"], capture_output=True, text=True, check=True).stdout.split()
+    quick = subprocess.run([exe, "--list", "--quick"], capture_output=True, text=True,
+                           check=True).stdout.split()
+    assert len(set(full)) == len(full) and len(quick) < len(full)
+    families = {name.split("/")[0] for name in full}
+    assert {"sgemm", "sgemm_batched", "gemv_f32", "gemv_q4", "int8_gemm", "vecquant8matmul",
+            "add", "fma", "reduce_sum", "softmax", "rmsnorm", "silu", "attention"} <= families
+    # 每个族在 quick 模式下至少保留一个用例
+    assert {name.split("/")[0] for name in quick} == families
+
+
+def test_json_counts_without_peak(native_tool, tmp_path):
+    report = run_bench(native_tool, tmp_path, "--filter=^(add|int8_gemm|sgemm)/", "--quick",
+                       "--no_peak", *FAST)
+    ctx = report["context"]
+    assert ctx["num_threads"] == 1 and ctx["repetitions"] == 2
+    assert ctx["peak_gflops"] == 0 and ctx["bandwidth_levels"] == []
+    names = [b["name"] for b in report["benchmarks"]]
+    assert names and all(re.match(r"^(add|int8_gemm|sgemm)/", n) for n in names)
+    for b in report["benchmarks"]:
+        dims = [int(d) for d in b["name"].split("/")[1].split("x")]
+        if b["family"] == "add":
+            assert b["flops"] == dims[0] and b["bytes"] == 12 * dims[0]
+        else:
+            m, n, k = dims
+            assert b["flops"] == 2 * m * n * k
+        assert b["iterations"] > 0 and 0 < b["min_time_ns"] <= b["real_time_ns"]
+        assert b["gflops"] == pytest.approx(b["flops"] / b["real_time_ns"], rel=1e-2, abs=2e-3)
+        assert b["intensity"] == pytest.approx(b["flops"] / b["bytes"], rel=1e-3)
+        # 未测峰值时不给出比例
+        assert b["pct_peak_flops"] is None and b["pct_peak_bandwidth"] is None
+
+
+def test_json_peak_ratios(native_tool, tmp_path):
+    report = run_bench(native_tool, tmp_path, "--filter=^(gemv_f32|int8_gemm)/", "--quick", *FAST)
+    ctx = report["context"]
+    assert ctx["peak_gflops"] > 0 and ctx["peak_int8_gops"] > 0
+    levels = ctx["bandwidth_levels"]
+    assert [lv["level"] for lv in levels][-1] == "DRAM" and levels[-1]["capacity"] == 0
+    for b in report["benchmarks"]:
+        peak = ctx["peak_int8_gops"] if b["family"] == "int8_gemm" else ctx["peak_gflops"]
+        assert b["pct_peak_flops"] == pytest.approx(b["gflops"] / peak, rel=1e-2, abs=1e-3)
+        # 带宽分母为能容纳工作集的最内层存储
+        level = next(lv for lv in levels if lv["capacity"] == 0 or b["bytes"] <= lv["capacity"])
+        assert b["bw_level"] == level["level"]
+        assert b["pct_peak_bandwidth"] == pytest.approx(b["gbs"] / level["gbs"], rel=1e-2, abs=1e-3)
+
+
+def test_bad_arguments(native_tool, tmp_path):
+    exe = native_tool("bench_kernels")
+    proc = subprocess.run([exe, "--bogus"], capture_output=True, text=True, timeout=60)
+    assert proc.returncode != 0 and "usage" in proc.stderr
+    proc = subprocess.run([exe, "--filter=^no_such_kernel$", "--no_peak",
+                           f"--json={tmp_path / 'empty.json'}"], capture_output=True, text=True,
+                          timeout=60)
+    # 没有匹配的用例时输出空报告
+    assert proc.returncode == 0, proc.stderr
+    assert json.loads((tmp_path / "empty.json").read_text())["benchmarks"] == []
@@ -0,0 +1,131 @@
+#!/usr/bin/env python
+# -*- coding: utf-8 -*-
+"""
+内存探针测试: 按 scripts/build_memory_probes.py 的参数用 gcc 编译 src/probes/memory_probes.c，
+检查 RSS/阈值结果、后台采样线程的启动/停止 (含并发启停) 与 probe_wrapper 的模块级接口
+"""
+
+import ctypes
+import importlib.util
+import platform
+import shutil
+import subprocess
+import sys
+import textwrap
+import threading
+from pathlib import Path
+
+import pytest
+
+pytestmark = [
+    pytest.mark.unit,
+    pytest.mark.skipif(platform.system() == "Windows" or shutil.which("gcc") is None,
+                       reason="需要 gcc 与 pthread"),
+]
+
+PROBE_DIR = Path(__file__).resolve().parents[2] / "src" / "probes"
+
+
+@pytest.fixture(scope="module")
+def probe_lib_path(tmp_path_factory):
+    out = tmp_path_factory.mktemp("probes") / "libmemory_probes.so"
+    subprocess.run(["gcc", "-shared", "-fPIC", "-pthread", "-o", str(out),
+                    str(PROBE_DIR / "memory_probes.c"), "-DMEMORY_PROBE_MAIN"],
+                   check=True, capture_output=True)
+    return out
+
+
+@pytest.fixture(scope="module")
+def probe_wrapper():
+    # src/probes 包的 __init__.py 当前无法导入，这里按文件路径单独载入包装器
+    spec = importlib.util.spec_from_file_location("probe_wrapper_under_test",
+                                                  PROBE_DIR / "probe_wrapper.py")
+    module = importlib.util.module_from_spec(spec)
+    spec.loader.exec_module(module)
+    return module
+
+
+@pytest.fixture
+def wrapper(probe_wrapper, probe_lib_path, monkeypatch):
+    """指向测试构建的探针库的 MemoryProbeWrapper (不搜索默认安装路径)"""
+    w = probe_wrapper.MemoryProbeWrapper.__new__(probe_wrapper.MemoryProbeWrapper)
+    w.lib = ctypes.CDLL(str(probe_lib_path))
+    w._configure_functions()
+    w.initialized = True
+    monkeypatch.setattr(probe_wrapper, "_PROBE_WRAPPER", w)
+    yield w
+    w.stop_sampler()
+
+
+def test_check_memory_thresholds(wrapper):
+    low = wrapper.check_memory("unit_low", threshold_mb=1)
+    assert low["current_memory_mb"] > 1 and low["available_memory_mb"] > 0
+    assert low["peak_memory_mb"] >= low["current_memory_mb"]
+    assert low["threshold_exceeded"] and low["probe_name"] == "unit_low"
+    high = wrapper.check_memory("unit_high", threshold_mb=1 << 40)
+    assert not high["threshold_exceeded"]
+    assert wrapper.test_probe()["status"] in (0, 1)
+
+
+def test_sampler_start_stop(wrapper, probe_wrapper):
+    assert wrapper.start_sampler(5)
+    assert wrapper.start_sampler(20)                      # 已运行时只更新周期
+    wrapper.fast_check(1 << 40)
+    assert not wrapper.check_memory("sampled", 1 << 40)["threshold_exceeded"]
+    wrapper.stop_sampler()
+    wrapper.stop_sampler()                                # 未运行时直接返回
+    # 模块级接口使用同一单例
+    assert probe_wrapper.start_sampler(0)
+    probe_wrapper.stop_sampler()
+    assert wrapper.start_sampler(1)
+    wrapper.stop_sampler()
+
+
+def test_concurrent_start_stop(wrapper):
+    errors = []
+
+    def worker(seed):
+        try:
+            for i in range(200):
+                if (i + seed) % 3:
+                    assert wrapper.start_sampler(1 + i % 4)
+                else:
+                    wrapper.stop_sampler()
+                wrapper.fast_check(1 << 40)
+        except AssertionError as exc:
+            errors.append(exc)
+
+    threads = [threading.Thread(target=worker, args=(s,)) for s in range(6)]
+    for t in threads:
+        t.start()
+    for t in threads:
+        t.join(timeout=60)
+    assert not any(t.is_alive() for t in threads), "采样线程启停死锁"
+    assert not errors
+    wrapper.stop_sampler()
+
+
+def test_stop_while_starting_in_subprocess(probe_lib_path):
+    # 并发启停中丢失 join 的线程会在库卸载/进程退出时崩溃，放在子进程中检查退出状态
+    script = textwrap.dedent("""
+        import ctypes, threading
+        lib = ctypes.CDLL({path!r})
+        lib.probe_sampler_start.argtypes = [ctypes.c_uint32]
+        def start():
+            for _ in range(500):
+                lib.probe_sampler_start(1)
+        def stop():
+            for _ in range(500):
+                lib.probe_sampler_stop()
+        threads = [threading.Thread(target=f) for f in (start, stop, start, stop)]
+        for t in threads:
+            t.start()
+        for t in threads:
+            t.join()
+        lib.probe_sampler_stop()
+        print("ok")
+    """).format(path=str(probe_lib_path))
+    proc = subprocess.run([sys.executable, "-c", script], capture_output=True, text=True,
+                          timeout=120)
+    assert proc.returncode == 0, proc.stderr
+    assert proc.stdout.strip().endswith("ok")
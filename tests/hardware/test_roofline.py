@@ -0,0 +1,109 @@
+#!/usr/bin/env python
+# -*- coding: utf-8 -*-
+"""
+屋顶线工具测试: roofline 读取基准 JSON 后按工作集所在级别放置用例，可达性能为
+min(算力峰值, 强度 x 该级带宽) (INT8 用例以 INT8 峰值为算力屋顶)，超过全部屋顶的标为 over_roof；
+以及 performance_verification.load_roofline_report 的汇总
+"""
+
+import json
+import subprocess
+
+import pytest
+
+from src.hardware import performance_verification
+
+pytestmark = pytest.mark.unit
+
+# 合成的基准用例 (name, family, flops, bytes, real_time_ns)，强度与实测值覆盖各个区域
+SYNTHETIC = [
+    ("mem_l1/1", "add", 1e3, 1e4, 1e6),            # 工作集放入 L1d，远低于屋顶
+    ("mem_dram/1", "add", 1e9, 1e10, 1e11),         # 工作集超过所有缓存
+    ("compute/1", "sgemm", 1e12, 1e6, 1e12),        # 高强度，受算力限制
+    ("int8_gemm/1", "int8_gemm", 1e12, 1e6, 1e12),  # 以 INT8 峰值为屋顶
+    ("over/1", "sgemm", 1e15, 1e6, 1.0),            # 超过全部屋顶
+]
+
+
+def write_bench(path):
+    """按 bench_kernels --json 的格式写出: 每个用例占一行"""
+    lines = ['{', '  "context": {', '    "num_threads": 1,', '    "repetitions": 1', '  },',
+             '  "benchmarks": [']
+    rows = [f'    {{"name": "{n}", "family": "{f}", "iterations": 1, "real_time_ns": {t}, '
+            f'"flops": {fl:.0f}, "bytes": {b:.0f}}}' for n, f, fl, b, t in SYNTHETIC]
+    lines.append(",\n".join(rows))
+    lines += ['  ]', '}']
+    path.write_text("\n".join(lines) + "\n")
+    json.loads(path.read_text())                              # 确认是合法 JSON
+    return path
+
+
+@pytest.fixture(scope="module")
+def roofline_report(native_tool, tmp_path_factory):
+    tmp = tmp_path_factory.mktemp("roofline")
+    out = tmp / "roofline.json"
+    proc = subprocess.run([native_tool("roofline"), f"--bench={write_bench(tmp / 'bench.json')}",
+                           f"--json={out}", "--no_chart"], capture_output=True, text=True,
+                          timeout=600)
+    assert proc.returncode == 0, proc.stderr
+    return out
+
+
+def test_ceilings(roofline_report):
+    report = json.loads(roofline_report.read_text())
+    assert report["context"]["num_threads"] == 1               # 沿用基准的线程数
+    kinds = {(c["kind"], c["threads"]) for c in report["compute_ceilings"]}
+    assert ("fp32", 1) in kinds and ("int8", 1) in kinds
+    assert report["peak_gflops"] > 0 and report["peak_int8_gops"] > 0
+    levels = [c for c in report["bandwidth_ceilings"] if c["threads"] == 1]
+    assert [c["level"] for c in levels] == ["L1d", "L2", "L3", "DRAM"]
+    assert all(c["gbs"] > 0 for c in levels)
+    assert report["dram_gbs"] == levels[-1]["gbs"]
+    assert report["ridge_intensity"] == pytest.approx(report["peak_gflops"] / report["dram_gbs"],
+                                                      rel=1e-3)
+
+
+def test_kernel_placement(roofline_report):
+    report = json.loads(roofline_report.read_text())
+    levels = {c["level"]: c for c in report["bandwidth_ceilings"] if c["threads"] == 1}
+    kernels = {k["name"]: k for k in report["kernels"]}
+    assert sorted(kernels) == sorted(n for n, *_ in SYNTHETIC)
+    for name, family, flops, nbytes, ns in SYNTHETIC:
+        k = kernels[name]
+        assert k["gflops"] == pytest.approx(flops / ns, rel=1e-3)
+        assert k["intensity"] == pytest.approx(flops / nbytes, rel=1e-3)
+        peak = report["peak_int8_gops"] if family == "int8_gemm" else report["peak_gflops"]
+        assert k["peak_gflops"] == pytest.approx(peak, rel=1e-3)
+        assert k["roof_gbs"] == pytest.approx(levels[k["level"]]["gbs"], rel=1e-3)
+        memory_roof = k["intensity"] * k["roof_gbs"]
+        assert k["attainable_gflops"] == pytest.approx(min(peak, memory_roof), rel=1e-3)
+        assert k["bound"] == ("compute" if memory_roof >= peak else "memory")
+        # 效率保留四位小数
+        assert k["efficiency"] == pytest.approx(k["gflops"] / k["attainable_gflops"], rel=1e-3,
+                                                abs=1e-4)
+        assert k["over_roof"] == (name == "over/1")
+    assert kernels["mem_l1/1"]["level"] == "L1d" and kernels["mem_l1/1"]["bound"] == "memory"
+    assert kernels["mem_dram/1"]["level"] == "DRAM"
+    assert kernels["compute/1"]["bound"] == kernels["int8_gemm/1"]["bound"] == "compute"
+
+
+def test_load_roofline_report(roofline_report):
+    report = performance_verification.load_roofline_report(str(roofline_report), threshold=0.5)
+    summary = report["summary"]
+    bounds = [k["bound"] for k in report["kernels"]]
+    assert summary["compute_bound"] == bounds.count("compute")
+    assert summary["memory_bound"] == bounds.count("memory")
+    assert summary["over_roof"] == ["over/1"]
+    headroom = [k["efficiency"] for k in summary["headroom"]]
+    assert headroom == sorted(headroom) and all(e < 0.5 for e in headroom)
+    assert "mem_l1/1" in [k["name"] for k in summary["headroom"]]
+    assert "over/1" not in [k["name"] for k in summary["headroom"]]
+
+
+def test_bad_arguments(native_tool, tmp_path):
+    exe = native_tool("roofline")
+    proc = subprocess.run([exe, "--bogus"], capture_output=True, text=True, timeout=60)
+    assert proc.returncode == 2 and "usage" in proc.stderr
+    proc = subprocess.run([exe, f"--bench={tmp_path / 'missing.json'}"], capture_output=True,
+                          text=True, timeout=60)
+    assert proc.returncode == 1 and "cannot read" in proc.stderr
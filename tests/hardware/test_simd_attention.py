@@ -0,0 +1,71 @@
+#!/usr/bin/env python
+# -*- coding: utf-8 -*-
+"""
+融合注意力测试: 分块在线 softmax 对照 NumPy 的完整注意力 (float64 参考)，覆盖 GQA/MQA、
+右下对齐的因果掩码 (带缓存的预填充与解码)、(seq, heads, dim) 转置视图与 out
+"""
+
+import numpy as np
+import pytest
+
+pytestmark = pytest.mark.unit
+
+
+def softmax_ref(x, axis=-1):
+    x = x.astype(np.float64)
+    e = np.exp(x - x.max(axis=axis, keepdims=True))
+    return e / e.sum(axis=axis, keepdims=True)
+
+
+def attention_ref(q, k, v, causal, scale):
+    group = q.shape[0] // k.shape[0]
+    k = np.repeat(k.astype(np.float64), group, axis=0)
+    v = np.repeat(v.astype(np.float64), group, axis=0)
+    s = q.astype(np.float64) @ np.swapaxes(k, -1, -2) * scale
+    if causal:
+        n_q, n_kv = s.shape[-2:]
+        visible = np.arange(n_kv)[None, :] <= np.arange(n_q)[:, None] + (n_kv - n_q)
+        s = np.where(visible, s, -np.inf)
+    return softmax_ref(s) @ v
+
+
+ATTENTION_CASES = [
+    # n_heads, n_kv_heads, n_q, n_kv, head_dim, causal
+    (4, 4, 16, 16, 64, False),
+    (4, 4, 33, 33, 64, True),
+    (8, 2, 7, 130, 128, True),     # GQA + 带缓存的分块预填充 (右下对齐)
+    (6, 1, 1, 515, 64, True),      # MQA 解码
+    (2, 2, 5, 300, 80, False),
+]
+
+
+@pytest.mark.parametrize("n_heads,n_kv_heads,n_q,n_kv,head_dim,causal", ATTENTION_CASES)
+def test_attention(ops, rng, n_heads, n_kv_heads, n_q, n_kv, head_dim, causal):
+    q = rng.standard_normal((n_heads, n_q, head_dim), dtype=np.float32)
+    k = rng.standard_normal((n_kv_heads, n_kv, head_dim), dtype=np.float32)
+    v = rng.standard_normal((n_kv_heads, n_kv, head_dim), dtype=np.float32)
+    scale = 1.0 / np.sqrt(head_dim)
+    np.testing.assert_allclose(ops.attention(q, k, v, causal=causal),
+                               attention_ref(q, k, v, causal, scale), rtol=1e-4, atol=1e-5)
+
+
+def test_attention_layouts_and_errors(ops, rng):
+    # (seq, heads, dim) 布局的转置视图、二维单头与 out
+    qs = rng.standard_normal((12, 4, 32), dtype=np.float32)
+    ks = rng.standard_normal((20, 2, 32), dtype=np.float32)
+    vs = rng.standard_normal((20, 2, 32), dtype=np.float32)
+    q, k, v = (np.swapaxes(t, 0, 1) for t in (qs, ks, vs))
+    expected = attention_ref(q, k, v, True, 0.3)
+    out = np.empty((12, 4, 32), dtype=np.float32)
+    ops.attention(q, k, v, causal=True, scale=0.3, out=np.swapaxes(out, 0, 1))
+    np.testing.assert_allclose(np.swapaxes(out, 0, 1), expected, rtol=1e-4, atol=1e-5)
+    np.testing.assert_allclose(ops.attention(q[0], k[0], v[0]),
+                               attention_ref(q[:1], k[:1], v[:1], False, 32 ** -0.5)[0],
+                               rtol=1e-4, atol=1e-5)
+    np.testing.assert_array_equal(ops.attention(q, k[:, :0], v[:, :0]), 0.0)
+    with pytest.raises(ValueError):
+        ops.attention(q[:3], k, v)
+    with pytest.raises(ValueError):
+        ops.attention(q, k, v[:, :5])
+    with pytest.raises(ValueError):
+        ops.attention(q, k, v, out=np.empty((4, 12, 16), dtype=np.float32))
@@ -0,0 +1,80 @@
+#!/usr/bin/env python
+# -*- coding: utf-8 -*-
+"""
+GEMM 自动调优测试: 调优记录的写入与跨进程加载、SIMD_AUTOTUNE 开关、损坏的调优文件与
+不可写路径 (调优文件路径在加载时读取，每个用例在独立子进程中运行)
+"""
+
+import json
+
+import pytest
+
+pytestmark = [pytest.mark.unit, pytest.mark.slow]
+
+REPORT = """
+import json
+rng = np.random.default_rng(5)
+a = rng.standard_normal((123, 301), dtype=np.float32)
+b = rng.standard_normal((301, 77), dtype=np.float32)
+ok = bool(np.allclose(ops.gemm(a, b), a.astype(np.float64) @ b, rtol=1e-4, atol=1e-3))
+print(json.dumps({"before": ops.get_tuning(), "tune": TUNE and ops.autotune(force=True),
+                  "after": ops.get_tuning(), "gemm_ok": ok}))
+"""
+
+
+def run_tuning(run_native, tuning_file, tune=False, mode=None):
+    env = {"SIMD_TUNING_FILE": str(tuning_file), "SIMD_NUM_THREADS": "2"}
+    if mode is not None:
+        env["SIMD_AUTOTUNE"] = mode
+    proc = run_native(f"TUNE = {tune!r}\n" + REPORT, env=env, timeout=600)
+    assert proc.returncode == 0, proc.stderr
+    return json.loads(proc.stdout.strip().splitlines()[-1])
+
+
+def test_tuning_persists_across_processes(run_native, tmp_path):
+    path = tmp_path / "cache" / "simd_tuning.txt"
+    first = run_tuning(run_native, path, tune=True)
+    assert first["before"]["tuned"] is False and first["gemm_ok"]
+    tune = first["tune"]
+    assert tune["tuned"] and tune["file_saved"] and tune["file"] == str(path)
+    assert tune["gflops"] > 0 and min(tune["mc"], tune["kc"], tune["nc"]) > 0
+    assert first["after"] == {k: tune[k] for k in first["after"]}
+    assert path.exists()
+
+    # 新进程只读取记录 (未设置 SIMD_AUTOTUNE)；文件中的 GFLOPS 保留一位小数
+    second = run_tuning(run_native, path)
+    assert second["before"]["gflops"] == pytest.approx(tune["gflops"], abs=0.05)
+    second["before"]["gflops"] = first["after"]["gflops"]
+    assert second["before"] == first["after"] and second["gemm_ok"]
+
+    # SIMD_AUTOTUNE=0 时忽略调优文件
+    disabled = run_tuning(run_native, path, mode="0")
+    assert disabled["before"]["tuned"] is False and disabled["gemm_ok"]
+
+
+def test_auto_mode_tunes_on_first_gemm(run_native, tmp_path):
+    path = tmp_path / "simd_tuning.txt"
+    result = run_tuning(run_native, path, mode="1")
+    # 第一次 GEMM 触发调优，随后查询得到记录
+    assert result["gemm_ok"] and result["after"]["tuned"] is True
+    assert path.exists()
+
+
+def test_malformed_tuning_file_is_ignored(run_native, tmp_path):
+    path = tmp_path / "simd_tuning.txt"
+    path.write_text("# comment\ngarbage line\nother-cpu avx2 2 avx2_6x16 96 256 2048 2 99.0\n\n")
+    result = run_tuning(run_native, path)
+    assert result["before"]["tuned"] is False and result["gemm_ok"]
+    # 调优后保留无法解析的行之外的其他机器记录
+    tuned = run_tuning(run_native, path, tune=True)
+    assert tuned["tune"]["file_saved"]
+    assert "other-cpu" in path.read_text()
+
+
+def test_unwritable_tuning_file(run_native, tmp_path):
+    blocker = tmp_path / "not_a_dir"
+    blocker.write_text("")
+    result = run_tuning(run_native, blocker / "simd_tuning.txt", tune=True)
+    # 测量结果仍在进程内生效，只是未能持久化
+    assert result["tune"]["tuned"] and not result["tune"]["file_saved"]
+    assert result["after"]["tuned"] is True and result["gemm_ok"]
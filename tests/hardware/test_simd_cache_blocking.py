@@ -0,0 +1,60 @@
+#!/usr/bin/env python
+# -*- coding: utf-8 -*-
+"""
+缓存拓扑分块测试: 检测到的缓存大小与由其推导的 GEMM 分块的约束、跨 mc/kc/nc 分块边界的 GEMM
+与按列归约对照 NumPy，以及 microarch_tuner 采用原生缓存拓扑
+"""
+
+import numpy as np
+import pytest
+
+from src.hardware import microarch_tuner, simd_wrapper
+
+pytestmark = pytest.mark.unit
+
+
+def test_cache_info(ops):
+    cache = ops.get_cache_info()
+    assert cache["source"] in ("sysfs", "cpuid", "default")
+    assert cache["line_size"] in (32, 64, 128, 256)
+    if cache["source"] != "default":
+        assert cache["l1d_size"] > 0 and cache["l2_size"] >= cache["l1d_size"]
+    assert cache["l3_size"] >= 0
+    for level in ("l1d", "l2", "l3"):
+        assert cache[f"{level}_shared"] >= 1
+    blocking = cache["gemm_blocking"]
+    assert blocking["mr"] > 0 and blocking["nr"] > 0
+    assert blocking["kc"] > 0 and blocking["mc"] % blocking["mr"] == 0
+    assert blocking["nc"] % blocking["nr"] == 0
+    # 未被调优记录覆盖时，kc 行的 B 微面板放入 L1d (下限 128 除外)
+    if cache["l1d_size"] and not ops.get_tuning()["tuned"]:
+        assert blocking["kc"] == 128 or blocking["kc"] * blocking["nr"] * 4 <= cache["l1d_size"]
+
+
+def test_gemm_across_block_boundaries(ops, rng):
+    blocking = ops.get_cache_info()["gemm_blocking"]
+    mc, kc = blocking["mc"], blocking["kc"]
+    nc = min(blocking["nc"], 2048)
+    for m, n, k in ((mc + 1, 33, kc + 1), (mc - 1, nc + 3, 2 * kc + 5), (2 * mc + 3, 17, 64)):
+        a = rng.standard_normal((m, k), dtype=np.float32)
+        b = rng.standard_normal((k, n), dtype=np.float32)
+        np.testing.assert_allclose(ops.gemm(a, b), a.astype(np.float64) @ b,
+                                   rtol=1e-4, atol=1e-4 * k ** 0.5)
+
+
+def test_column_reduction_spanning_cache_strips(ops, rng):
+    # 按列归约的条带宽度由 L1d 推导，宽矩阵跨越多个条带
+    x = rng.standard_normal((300, 20011), dtype=np.float32)
+    np.testing.assert_allclose(ops.reduce(x, "sum", axis=0), x.astype(np.float64).sum(0),
+                               rtol=1e-4, atol=1e-3)
+    np.testing.assert_allclose(ops.reduce(x, "max", axis=0), x.max(0))
+
+
+def test_microarch_tuner_uses_native_cache(ops, monkeypatch):
+    monkeypatch.setattr(simd_wrapper, "get_simd_operations", lambda: ops)
+    cache = ops.get_cache_info()
+    config = microarch_tuner.MicroArchTuner().tune_for_microarch()
+    assert config["cache_line_size"] == cache["line_size"]
+    assert config["cache_sizes"] == {"l1d": cache["l1d_size"], "l2": cache["l2_size"],
+                                     "l3": cache["l3_size"]}
+    assert config["gemm_blocking"] == cache["gemm_blocking"]
@@ -0,0 +1,82 @@
+#!/usr/bin/env python
+# -*- coding: utf-8 -*-
+"""
+CPUID 分发测试: 选中的变体被 CPU 支持，SIMD_FORCE_VARIANT 限制到每个较低变体时
+各内核结果仍与 NumPy 一致
+"""
+
+import json
+
+import pytest
+
+from src.hardware import simd_wrapper
+
+pytestmark = pytest.mark.unit
+
+VARIANT_ORDER = ["baseline", "neon", "sse42", "avx", "avx2", "avx512"]
+
+
+def test_cpu_features_and_variant(ops):
+    info = ops.get_info()
+    features = set(info["features"])
+    assert features <= set(simd_wrapper.CPU_FEATURES)
+    variant = info["active_variant"]
+    assert variant in VARIANT_ORDER
+    # 选中的变体必须被 CPU 支持 (AVX2 级别同时要求 FMA 与 F16C)
+    required = {"avx512": {"avx512f", "avx2", "fma", "f16c"}, "avx2": {"avx2", "fma", "f16c"},
+                "avx": {"avx"}, "sse42": {"sse4.2"}, "neon": {"neon"}, "baseline": set()}
+    assert required[variant] <= features
+    int8 = info["int8_variant"]
+    if int8 == "avx512_vnni":
+        assert {"avx512f", "avx512vnni"} <= features
+    elif int8 == "avx_vnni":
+        assert {"avx2", "avxvnni"} <= features
+
+
+FORCED_BODY = """
+import json
+rng = np.random.default_rng(7)
+a = rng.standard_normal((45, 77), dtype=np.float32)
+b = rng.standard_normal((77, 51), dtype=np.float32)
+x = rng.standard_normal((3, 1000), dtype=np.float32)
+y = rng.standard_normal(1003, dtype=np.float32)
+ref = a.astype(np.float64) @ b
+ok = {
+    "matmul": bool(np.allclose(ops.matrix_multiply(a, b), ref, rtol=1e-4, atol=1e-3)),
+    "gemm": bool(np.allclose(ops.gemm(a, b), ref, rtol=1e-4, atol=1e-3)),
+    "softmax": bool(np.allclose(ops.softmax(x), np.exp(x - x.max(-1, keepdims=True)) /
+                                np.exp(x - x.max(-1, keepdims=True)).sum(-1, keepdims=True),
+                                rtol=1e-4, atol=1e-7)),
+    "add": bool(np.array_equal(ops.matrix_add(y, y), y + y)),
+    "sum": bool(np.isclose(ops.reduce(y, "sum"), y.astype(np.float64).sum(), rtol=1e-5, atol=1e-4)),
+    "silu": bool(np.allclose(ops.silu(y), y / (1 + np.exp(-y.astype(np.float64))), rtol=1e-4, atol=1e-6)),
+}
+w = rng.standard_normal((96, 40), dtype=np.float32)
+packed = ops.pack_int8_weights(w)
+h = rng.standard_normal((5, 96), dtype=np.float32)
+ok["int8"] = bool(np.abs(ops.int8_matmul(h, packed) - h @ w).max() < 0.05 * np.abs(h @ w).max())
+print(json.dumps({"variant": ops.get_info()["active_variant"],
+                  "int8": ops.get_info()["int8_variant"], "ok": ok}))
+"""
+
+
+@pytest.mark.parametrize("forced", ["baseline", "sse42", "avx", "avx2", "avx512"])
+def test_forced_variant_matches_numpy(run_native, ops, forced):
+    native = ops.get_info()["active_variant"]
+    proc = run_native(FORCED_BODY, env={"SIMD_FORCE_VARIANT": forced})
+    assert proc.returncode == 0, proc.stderr
+    result = json.loads(proc.stdout.strip().splitlines()[-1])
+    # 强制值只能降低变体
+    assert VARIANT_ORDER.index(result["variant"]) <= VARIANT_ORDER.index(forced)
+    assert VARIANT_ORDER.index(result["variant"]) <= VARIANT_ORDER.index(native)
+    if forced == "baseline":
+        assert result["variant"] == "baseline"
+        assert result["int8"] == "generic"
+    assert all(result["ok"].values()), result
+
+
+def test_unknown_forced_variant_is_ignored(run_native, ops):
+    proc = run_native("print(ops.get_info()['active_variant'])",
+                      env={"SIMD_FORCE_VARIANT": "not-a-variant"})
+    assert proc.returncode == 0, proc.stderr
+    assert proc.stdout.split()[-1] == ops.get_info()["active_variant"]
@@ -0,0 +1,89 @@
+#!/usr/bin/env python
+# -*- coding: utf-8 -*-
+"""
+逐元素内核测试: 任意长度 (含非向量宽度倍数的尾部) 与任意起始对齐的切片视图、out 与输入相同的
+原地运算，在每个指令集变体下与 NumPy 逐位一致
+"""
+
+import json
+
+import numpy as np
+import pytest
+
+pytestmark = pytest.mark.unit
+
+LENGTHS = list(range(0, 35)) + [63, 64, 65, 127, 1000, 4099]
+
+
+def views(rng, n, offset):
+    """从同一缓冲区按 offset 个 float 偏移切出的三个长度为 n 的视图 (起始地址不对齐)"""
+    buf = rng.standard_normal(3 * (n + 32), dtype=np.float32)
+    return [buf[i * (n + 32) + offset:i * (n + 32) + offset + n] for i in range(3)]
+
+
+@pytest.mark.parametrize("offset", [0, 1, 3, 7, 15])
+def test_elementwise_lengths_and_alignment(ops, rng, offset):
+    for n in LENGTHS:
+        a, b, c = views(rng, n, offset)
+        np.testing.assert_array_equal(ops.matrix_add(a, b), a + b)
+        np.testing.assert_array_equal(ops.matrix_element_multiply(a, b), a * b)
+        np.testing.assert_allclose(ops.fused_multiply_add(a, b, c),
+                                   a.astype(np.float64) * b + c, rtol=1e-6, atol=1e-6)
+        np.testing.assert_array_equal(ops.vector_scale(a, 1.5), a * np.float32(1.5))
+
+
+def test_elementwise_out_and_inplace(ops, rng):
+    a, b, c = views(rng, 1001, 5)
+    a0, c0 = a.copy(), c.copy()
+    # out 为另一个不对齐的视图，写入范围之外的元素不变
+    buf = np.full(1100, 7.0, dtype=np.float32)
+    out = buf[3:1004]
+    assert ops.matrix_add(a, b, out=out) is out
+    np.testing.assert_array_equal(out, a + b)
+    assert (buf[:3] == 7.0).all() and (buf[1004:] == 7.0).all()
+    # out 与输入相同时原地运算
+    ops.matrix_element_multiply(a, b, out=a)
+    np.testing.assert_array_equal(a, a0 * b)
+    ops.vector_scale(c, -2.0, out=c)
+    np.testing.assert_array_equal(c, c0 * np.float32(-2.0))
+
+
+def test_elementwise_multidimensional_and_errors(ops, rng):
+    a = rng.standard_normal((17, 33), dtype=np.float32)
+    b = rng.standard_normal((17, 33), dtype=np.float32)
+    assert ops.matrix_add(a, b).shape == (17, 33)
+    np.testing.assert_array_equal(ops.matrix_add(a, b), a + b)
+    # 非连续输入先复制
+    np.testing.assert_array_equal(ops.matrix_add(a.T, b.T), a.T + b.T)
+    with pytest.raises(ValueError):
+        ops.matrix_add(a, b[:, :32])
+    with pytest.raises(ValueError):
+        ops.matrix_add(a, b, out=np.empty((17, 33), dtype=np.float64))
+    with pytest.raises(ValueError):
+        ops.matrix_add(a, b, out=np.empty((33, 17), dtype=np.float32).T)
+
+
+FORCED_BODY = """
+import json
+rng = np.random.default_rng(3)
+ok = True
+for n in list(range(0, 70)) + [1000, 4099]:
+    for offset in (0, 1, 5, 13):
+        buf = rng.standard_normal(3 * (n + 32), dtype=np.float32)
+        a, b, c = (buf[i * (n + 32) + offset:i * (n + 32) + offset + n] for i in range(3))
+        ok &= bool(np.array_equal(ops.matrix_add(a, b), a + b))
+        ok &= bool(np.array_equal(ops.matrix_element_multiply(a, b), a * b))
+        ok &= bool(np.allclose(ops.fused_multiply_add(a, b, c), a.astype(np.float64) * b + c,
+                               rtol=1e-6, atol=1e-6))
+        ok &= bool(np.array_equal(ops.vector_scale(a, 0.25), a * np.float32(0.25)))
+print(json.dumps({"variant": ops.get_info()["active_variant"], "ok": ok}))
+"""
+
+
+@pytest.mark.parametrize("forced", ["baseline", "sse42", "avx", "avx2", "avx512"])
+def test_elementwise_tails_per_variant(run_native, forced):
+    # 每个变体自行处理头部与尾部的不完整向量
+    proc = run_native(FORCED_BODY, env={"SIMD_FORCE_VARIANT": forced})
+    assert proc.returncode == 0, proc.stderr
+    result = json.loads(proc.stdout.strip().splitlines()[-1])
+    assert result["ok"], result
@@ -0,0 +1,58 @@
+#!/usr/bin/env python
+# -*- coding: utf-8 -*-
+"""
+融合逐元素表达式测试: ElementwiseExpr 编译的字节码在原生引擎与 NumPy 解释器中的结果一致，
+并与直接写出的 NumPy 表达式对照
+"""
+
+import numpy as np
+import pytest
+
+from src.hardware.simd_wrapper import ElementwiseExpr, _eval_ew_program_numpy
+
+pytestmark = pytest.mark.unit
+
+
+def test_fused_elementwise(ops, rng):
+    a, b, c = (rng.standard_normal(2053, dtype=np.float32) for _ in range(3))
+    x0, x1, x2 = ElementwiseExpr.inputs(3)
+    expr = ((x0 * x1 + x2).affine(0.5, 1.0) / (x2 * x2 + 1.0)).clamp(-2.0, 2.0).silu() \
+        - ElementwiseExpr.fma(x0, x1, 3.0).maximum(x2).relu()
+    ad, bd, cd = (v.astype(np.float64) for v in (a, b, c))
+    z = np.clip(((ad * bd + cd) * 0.5 + 1.0) / (cd * cd + 1.0), -2.0, 2.0)
+    ref = z / (1 + np.exp(-z)) - np.maximum(np.maximum(ad * bd + 3.0, cd), 0.0)
+    np.testing.assert_allclose(ops.fused_elementwise(expr, [a, b, c]), ref, rtol=1e-4, atol=1e-5)
+
+
+@pytest.mark.parametrize("n", [0, 1, 7, 16, 17, 255, 4099])
+def test_native_matches_numpy_interpreter(ops, rng, n):
+    a, b = (rng.standard_normal(n, dtype=np.float32) for _ in range(2))
+    x0, x1 = ElementwiseExpr.inputs(2)
+    expr = (x0.gelu() * ElementwiseExpr.const(0.5) + x1.minimum(0.25)).activation("silu") - x1
+    program, out_reg, _ = expr.compile()
+    expected = _eval_ew_program_numpy(program, out_reg, [a, b])
+    np.testing.assert_allclose(ops.fused_elementwise(expr, [a, b]), expected, rtol=1e-4, atol=1e-6)
+
+
+def test_fused_elementwise_out_and_shapes(ops, rng):
+    a = rng.standard_normal((31, 19), dtype=np.float32)
+    b = rng.standard_normal((31, 19), dtype=np.float32)
+    x0, x1 = ElementwiseExpr.inputs(2)
+    ad, bd = a.astype(np.float64), b.astype(np.float64)
+    # 输出可与输入相同，多维数组按元素处理
+    out = a.copy()
+    assert ops.fused_elementwise(x0 * 2.0 - x1, [out, b], out=out) is out
+    np.testing.assert_allclose(out, 2.0 * ad - bd, rtol=1e-6, atol=1e-6)
+    # 只引用部分输入的常量表达式
+    np.testing.assert_allclose(ops.fused_elementwise(x1 + 1.0, [a, b]), bd + 1.0, rtol=1e-6)
+
+
+def test_fused_elementwise_errors(ops, rng):
+    a, b = (rng.standard_normal(64, dtype=np.float32) for _ in range(2))
+    x0, x1, x2 = ElementwiseExpr.inputs(3)
+    with pytest.raises(ValueError):
+        ops.fused_elementwise(x0 + x2, [a, b])              # 引用了未提供的输入
+    with pytest.raises(ValueError):
+        ops.fused_elementwise(x0 + x1, [a, b[:10]])
+    with pytest.raises(ValueError):
+        ops.fused_elementwise(x0 + x1, [a, b], out=np.empty(64, dtype=np.float64))
@@ -0,0 +1,60 @@
+#!/usr/bin/env python
+# -*- coding: utf-8 -*-
+"""
+批量 GEMM 测试: 跨步批量 (含 transpose_b 与共享右矩阵) 与指针数组批量对照 NumPy
+"""
+
+import numpy as np
+import pytest
+
+pytestmark = pytest.mark.unit
+
+
+def assert_gemm_close(actual, expected, k):
+    np.testing.assert_allclose(actual, expected, rtol=1e-4, atol=1e-5 * max(k, 1) ** 0.5 * 4)
+
+
+@pytest.mark.parametrize("transpose_b", [False, True])
+def test_batched_strided(ops, rng, transpose_b):
+    batch, m, n, k = 9, 19, 24, 40
+    a = rng.standard_normal((batch, m, k), dtype=np.float32)
+    b = rng.standard_normal((batch, n, k) if transpose_b else (batch, k, n), dtype=np.float32)
+    c = ops.matrix_multiply_batched(a, b, alpha=2.0, transpose_b=transpose_b)
+    bb = np.swapaxes(b, -1, -2) if transpose_b else b
+    assert c.shape == (batch, m, n)
+    assert_gemm_close(c, 2.0 * (a.astype(np.float64) @ bb.astype(np.float64)), k)
+
+
+def test_batched_many_small_matrices(ops, rng):
+    # 批量数多于线程数、单个矩阵小于一个微内核块
+    a = rng.standard_normal((257, 3, 5), dtype=np.float32)
+    b = rng.standard_normal((257, 5, 2), dtype=np.float32)
+    assert_gemm_close(ops.matrix_multiply_batched(a, b), a.astype(np.float64) @ b, 5)
+
+
+def test_batched_shared_rhs_and_lists(ops, rng):
+    a = rng.standard_normal((5, 8, 16), dtype=np.float32)
+    w = rng.standard_normal((16, 12), dtype=np.float32)
+    assert_gemm_close(ops.matrix_multiply_batched(a, w), a.astype(np.float64) @ w, 16)
+    assert_gemm_close(ops.matrix_multiply_batched(a, w.T.copy(), transpose_b=True),
+                      a.astype(np.float64) @ w, 16)
+
+    a_list = [rng.standard_normal((6, 10), dtype=np.float32) for _ in range(4)]
+    b_list = [rng.standard_normal((10, 3), dtype=np.float32) for _ in range(4)]
+    for c, x, y in zip(ops.matrix_multiply_batched(a_list, b_list), a_list, b_list):
+        assert_gemm_close(c, x.astype(np.float64) @ y, 10)
+    assert ops.matrix_multiply_batched([], []) == []
+
+
+def test_batched_rejects_mismatched_shapes(ops, rng):
+    a = rng.standard_normal((5, 8, 16), dtype=np.float32)
+    a_list = [rng.standard_normal((6, 10), dtype=np.float32) for _ in range(4)]
+    b_list = [rng.standard_normal((10, 3), dtype=np.float32) for _ in range(4)]
+    with pytest.raises(ValueError):
+        ops.matrix_multiply_batched(a_list, b_list[:3])
+    with pytest.raises(ValueError):
+        ops.matrix_multiply_batched(a_list, b_list[:3] + [np.zeros((10, 4), dtype=np.float32)])
+    with pytest.raises(ValueError):
+        ops.matrix_multiply_batched(a, rng.standard_normal((4, 16, 12), dtype=np.float32))
+    with pytest.raises(ValueError):
+        ops.matrix_multiply_batched(a, rng.standard_normal((5, 15, 12), dtype=np.float32))
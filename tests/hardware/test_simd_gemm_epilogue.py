@@ -0,0 +1,70 @@
+#!/usr/bin/env python
+# -*- coding: utf-8 -*-
+"""
+GEMM 融合尾处理测试: bias/激活/残差/alpha-beta 在微内核写回时完成，对照 NumPy (float64 参考)
+"""
+
+import numpy as np
+import pytest
+
+pytestmark = pytest.mark.unit
+
+ACTIVATIONS = {
+    None: lambda v: v,
+    "relu": lambda v: np.maximum(v, 0.0),
+    "gelu": lambda v: 0.5 * v * (1.0 + np.tanh(0.7978845608 * (v + 0.044715 * v ** 3))),
+    "silu": lambda v: v / (1.0 + np.exp(-v)),
+}
+
+
+def reference(a, b):
+    return a.astype(np.float64) @ b.astype(np.float64)
+
+
+@pytest.mark.parametrize("activation", [None, "relu", "gelu", "silu"])
+def test_fused_epilogue(ops, rng, activation):
+    m, n, k = 37, 70, 129
+    a = rng.standard_normal((m, k), dtype=np.float32)
+    b = rng.standard_normal((k, n), dtype=np.float32) * 0.1
+    bias = rng.standard_normal(n, dtype=np.float32)
+    residual = rng.standard_normal((m, n), dtype=np.float32)
+    out = rng.standard_normal((m, n), dtype=np.float32)
+    prior = out.astype(np.float64)
+
+    ops.matrix_multiply_fused(a, b, bias=bias, activation=activation, residual=residual,
+                              alpha=0.75, beta=0.5, out=out)
+    z = 0.75 * reference(a, b) + 0.5 * prior + bias
+    # 激活中的 exp 为多项式近似
+    np.testing.assert_allclose(out, ACTIVATIONS[activation](z) + residual, rtol=1e-4, atol=1e-4)
+
+
+@pytest.mark.parametrize("activation", ["relu", "silu"])
+def test_fused_epilogue_partial_terms(ops, rng, activation):
+    # 只有部分尾处理项时其余项不参与 (尾块 M/N 与多个 kc 分块)
+    m, n, k = 9, 21, 300
+    a = rng.standard_normal((m, k), dtype=np.float32)
+    b = rng.standard_normal((k, n), dtype=np.float32) * 0.1
+    bias = rng.standard_normal(n, dtype=np.float32)
+    np.testing.assert_allclose(ops.matrix_multiply_fused(a, b, bias=bias, activation=activation),
+                               ACTIVATIONS[activation](reference(a, b) + bias), rtol=1e-4, atol=1e-4)
+    # 转置存储的残差 (列内连续)
+    residual = np.ascontiguousarray(rng.standard_normal((n, m), dtype=np.float32)).T
+    np.testing.assert_allclose(ops.matrix_multiply_fused(a, b, residual=residual, alpha=2.0),
+                               2.0 * reference(a, b) + residual, rtol=1e-4, atol=1e-4)
+
+
+def test_fused_rejects_bad_arguments(ops, rng):
+    a = rng.standard_normal((4, 6), dtype=np.float32)
+    b = rng.standard_normal((6, 5), dtype=np.float32)
+    with pytest.raises(ValueError):
+        ops.matrix_multiply_fused(a, b, activation="tanh")
+    with pytest.raises(ValueError):
+        ops.matrix_multiply_fused(a, b, beta=1.0)          # beta 非 0 时需要 out
+    with pytest.raises(ValueError):
+        ops.matrix_multiply_fused(a, a)
+    with pytest.raises(ValueError):
+        ops.matrix_multiply_fused(a, b, bias=np.zeros(4, dtype=np.float32))
+    with pytest.raises(ValueError):
+        ops.matrix_multiply_fused(a, b, residual=np.zeros((4, 4), dtype=np.float32))
+    with pytest.raises(ValueError):
+        ops.matrix_multiply_fused(a, b, out=np.empty((4, 5), dtype=np.float64))
@@ -0,0 +1,73 @@
+#!/usr/bin/env python
+# -*- coding: utf-8 -*-
+"""
+BLAS 风格 GEMM 测试: NN/NT/TN/TT 与行距大于列数的切片视图零拷贝传入、alpha/beta 写入切片，
+对照 NumPy (float64 参考)
+"""
+
+import numpy as np
+import pytest
+
+pytestmark = pytest.mark.unit
+
+
+def reference(a, b):
+    return a.astype(np.float64) @ b.astype(np.float64)
+
+
+def assert_gemm_close(actual, expected, k):
+    np.testing.assert_allclose(actual, expected, rtol=1e-4, atol=1e-5 * max(k, 1) ** 0.5 * 4)
+
+
+@pytest.mark.parametrize("trans_a", [False, True])
+@pytest.mark.parametrize("trans_b", [False, True])
+def test_gemm_transpose_combinations(ops, rng, trans_a, trans_b):
+    m, n, k = 45, 70, 131
+    a = rng.standard_normal((k, m) if trans_a else (m, k), dtype=np.float32)
+    b = rng.standard_normal((n, k) if trans_b else (k, n), dtype=np.float32)
+    a_op = a.T if trans_a else a
+    b_op = b.T if trans_b else b
+    assert_gemm_close(ops.gemm(a_op, b_op), reference(a_op, b_op), k)
+
+
+def test_gemm_sliced_operands(ops, rng):
+    big = rng.standard_normal((70, 120), dtype=np.float32)
+    a = big[5:45, 10:90]                                    # 行距大于列数的子矩阵
+    b = rng.standard_normal((200, 64), dtype=np.float32)[:80]
+    assert_gemm_close(ops.gemm(a, b), reference(a, b), 80)
+    # 转置的切片视图 (列内连续、列距大于行数)
+    at = np.ascontiguousarray(rng.standard_normal((100, 60), dtype=np.float32))[:80, 7:47].T
+    assert_gemm_close(ops.gemm(at, b), reference(at, b), 80)
+    # 两个维度都不连续时先复制
+    strided = big[::2, ::3][:20, :30]
+    w = rng.standard_normal((30, 9), dtype=np.float32)
+    assert_gemm_close(ops.gemm(strided, w), reference(strided, w), 30)
+
+
+def test_gemm_alpha_beta_into_slice(ops, rng):
+    a = rng.standard_normal((17, 31), dtype=np.float32)
+    b = rng.standard_normal((31, 23), dtype=np.float32)
+    base = rng.standard_normal((20, 40), dtype=np.float32)
+    out = base.copy()
+    view = out[2:19, 5:28]
+    assert ops.gemm(a, b, alpha=0.5, beta=2.0, out=view) is view
+    expected = 0.5 * reference(a, b) + 2.0 * base[2:19, 5:28]
+    assert_gemm_close(view, expected, 31)
+    # 切片之外的元素不变
+    mask = np.ones_like(out, dtype=bool)
+    mask[2:19, 5:28] = False
+    np.testing.assert_array_equal(out[mask], base[mask])
+
+
+def test_gemm_rejects_bad_arguments(ops, rng):
+    a = rng.standard_normal((4, 5), dtype=np.float32)
+    with pytest.raises(ValueError):
+        ops.gemm(a, rng.standard_normal((6, 3), dtype=np.float32))
+    with pytest.raises(ValueError):
+        ops.gemm(a, a.T, beta=1.0)
+    with pytest.raises(ValueError):
+        ops.gemm(a, a.T, out=np.empty((4, 4), dtype=np.float64))
+    with pytest.raises(ValueError):
+        ops.gemm(a, a.T, out=np.empty((4, 3), dtype=np.float32))
+    with pytest.raises(ValueError):
+        ops.gemm(a.reshape(-1), a.T)
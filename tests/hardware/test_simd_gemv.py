@@ -0,0 +1,62 @@
+#!/usr/bin/env python
+# -*- coding: utf-8 -*-
+"""
+GEMV 测试: 批大小为 1 的 f32/f16/q8/q4 矩阵向量乘 (含行切片视图与量化误差界) 对照 NumPy
+"""
+
+import numpy as np
+import pytest
+
+pytestmark = pytest.mark.unit
+
+
+@pytest.mark.parametrize("n,k", [(1, 1), (33, 70), (257, 1024)])
+def test_gemv_f32_f16(ops, rng, n, k):
+    w = rng.standard_normal((n, k), dtype=np.float32)
+    x = rng.standard_normal(k, dtype=np.float32)
+    bias = rng.standard_normal(n, dtype=np.float32)
+    ref = w.astype(np.float64) @ x + bias
+    np.testing.assert_allclose(ops.gemv(w, x, bias), ref, rtol=1e-4, atol=1e-4 * k ** 0.5)
+    w16 = w.astype(np.float16)
+    ref16 = w16.astype(np.float64) @ x
+    np.testing.assert_allclose(ops.gemv(w16, x), ref16, rtol=1e-4, atol=1e-4 * k ** 0.5)
+
+
+def test_gemv_row_slice_and_errors(ops, rng):
+    big = rng.standard_normal((40, 100), dtype=np.float32)
+    w = big[3:30, :64]                                   # 行距 100 的视图
+    x = rng.standard_normal(64, dtype=np.float32)
+    np.testing.assert_allclose(ops.gemv(w, x), w.astype(np.float64) @ x, rtol=1e-4, atol=1e-4)
+    with pytest.raises(ValueError):
+        ops.gemv(w, x[:63])
+    with pytest.raises(ValueError):
+        ops.gemv(w, x, bias=np.zeros(26, dtype=np.float32))
+    with pytest.raises(ValueError):
+        ops.gemv(w.reshape(-1), x)
+
+
+def test_gemv_q8_q4(ops, rng):
+    n, k = 75, 256
+    w = rng.standard_normal((n, k), dtype=np.float32)
+    x = rng.standard_normal(k, dtype=np.float32)
+    bias = rng.standard_normal(n, dtype=np.float32)
+
+    q8, s8 = ops.quantize_gemv_q8(w)
+    ref8 = (q8.astype(np.float64) @ x) * s8 + bias
+    np.testing.assert_allclose(ops.gemv_q8(q8, s8, x, bias), ref8, rtol=1e-4, atol=1e-3)
+
+    q4, s4 = ops.quantize_gemv_q4(w, group_size=64)
+    nib = np.empty((n, k), dtype=np.int64)
+    nib[:, 0::2] = q4 & 0xF
+    nib[:, 1::2] = q4 >> 4
+    deq = (nib - 8) * np.repeat(s4.astype(np.float64), 64, axis=1)
+    np.testing.assert_allclose(ops.gemv_q4(q4, s4, x, bias), deq @ x + bias, rtol=1e-4, atol=1e-3)
+    # 量化误差有界
+    assert np.abs(deq - w).max() <= s4.max() / 2 + 1e-6
+
+    with pytest.raises(ValueError):
+        ops.gemv_q8(q8, s8[:-1], x)
+    with pytest.raises(ValueError):
+        ops.gemv_q4(q4, s4[:, :3], x)
+    with pytest.raises(ValueError):
+        ops.quantize_gemv_q4(w, group_size=3)
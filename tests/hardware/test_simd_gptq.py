@@ -0,0 +1,119 @@
+#!/usr/bin/env python
+# -*- coding: utf-8 -*-
+"""
+AutoGPTQ 量化矩阵乘测试: 打包布局的 vecquant 8/4 位内核 (分组、行打包、列压缩) 对照
+NumPy 反量化参考，以及操作数类型与形状检查
+"""
+
+import numpy as np
+import pytest
+
+pytestmark = pytest.mark.unit
+
+
+def pack_words(q, bits, axis):
+    """沿 axis 把 bits 位无符号整数打包为 int32 (低位在前)"""
+    per_word = 32 // bits
+    q = np.moveaxis(np.asarray(q, dtype=np.uint32), axis, -1)
+    n = q.shape[-1]
+    pad = (-n) % per_word
+    if pad:
+        q = np.concatenate([q, np.zeros(q.shape[:-1] + (pad,), dtype=np.uint32)], axis=-1)
+    q = q.reshape(q.shape[:-1] + (-1, per_word))
+    shifts = (np.arange(per_word, dtype=np.uint32) * bits)
+    words = np.bitwise_or.reduce(q << shifts, axis=-1).astype(np.uint32).view(np.int32)
+    return np.ascontiguousarray(np.moveaxis(words, -1, axis))
+
+
+def quant_case(rng, bits, shape):
+    return rng.integers(0, 1 << bits, size=shape, dtype=np.int64)
+
+
+def test_vecquant8matmul_grouped(ops, rng):
+    batch, height, width, groups = 3, 96, 70, 3
+    vec = rng.standard_normal((batch, height), dtype=np.float32)
+    q = quant_case(rng, 8, (height, width))
+    scales = rng.uniform(0.01, 0.1, (groups, width)).astype(np.float32)
+    zeros = quant_case(rng, 8, (groups, width)) % 255           # 存储值为零点 - 1
+    g_idx = rng.integers(0, groups, height).astype(np.int32)     # act-order: 分组无序
+    mul = rng.standard_normal((batch, width), dtype=np.float32)
+    prior = mul.astype(np.float64)
+
+    ops.vecquant8matmul(vec, pack_words(q, 8, 0), mul, scales, pack_words(zeros, 8, 1), g_idx)
+    w = scales[g_idx].astype(np.float64) * (q - (zeros[g_idx] + 1))
+    np.testing.assert_allclose(mul, prior + vec.astype(np.float64) @ w, rtol=1e-4, atol=1e-3)
+
+
+@pytest.mark.parametrize("bits,packed_zeros", [(8, False), (8, True), (4, False), (4, True)])
+def test_vecquant_batched_row_packed(ops, rng, bits, packed_zeros):
+    batch, heads, vec_row, height, width = 2, 3, 5, 64, 40
+    vec = rng.standard_normal((batch, heads, vec_row, height), dtype=np.float32)
+    q = quant_case(rng, bits, (batch, heads, height, width))
+    scales = rng.uniform(0.01, 0.1, (batch, heads, width)).astype(np.float32)
+    z = quant_case(rng, bits, (batch, heads, width))
+    if packed_zeros:
+        # 8 位打包零点存储值为零点 - 1，4 位无偏移
+        stored = z % 255 if bits == 8 else z
+        zeros = pack_words(stored, bits, 2)
+        z = stored + (1 if bits == 8 else 0)
+    else:
+        zeros = z.astype(np.int32)
+    mul = np.zeros((batch, heads, vec_row, width), dtype=np.float32)
+
+    fn = ops.vecquant8matmul_batched if bits == 8 else ops.vecquant4matmul_batched
+    fn(vec, pack_words(q, bits, 2), mul, scales, zeros)
+    w = scales[:, :, None, :].astype(np.float64) * (q - z[:, :, None, :])
+    np.testing.assert_allclose(mul, vec.astype(np.float64) @ w, rtol=1e-4, atol=1e-3)
+
+
+@pytest.mark.parametrize("bits", [8, 4])
+def test_vecquant_batched_column_compression(ops, rng, bits):
+    batch, heads, vec_row, height, width = 2, 2, 3, 300, 48
+    vec = rng.standard_normal((batch, heads, vec_row, height), dtype=np.float32)
+    q = quant_case(rng, bits, (batch, heads, height, width))
+    scales = rng.uniform(0.01, 0.1, (batch, heads, height)).astype(np.float32)
+    zeros = quant_case(rng, bits, (batch, heads, height)).astype(np.int32)
+    mul = rng.standard_normal((batch, heads, vec_row, width), dtype=np.float32)
+    prior = mul.astype(np.float64)
+
+    fn = ops.vecquant8matmul_batched_column_compression if bits == 8 \
+        else ops.vecquant4matmul_batched_column_compression
+    fn(vec, pack_words(q, bits, 3), mul, scales, zeros)
+    w = scales[..., None].astype(np.float64) * (q - zeros[..., None])
+    np.testing.assert_allclose(mul, prior + vec.astype(np.float64) @ w, rtol=1e-4, atol=2e-3)
+
+
+def test_vecquant_rejects_bad_arrays(ops, rng):
+    vec = rng.standard_normal((2, 16), dtype=np.float32)
+    qweight = np.zeros((4, 8), dtype=np.int32)
+    mul = np.zeros((2, 8), dtype=np.float32)
+    scales = np.ones((2, 8), dtype=np.float32)
+    zeros = np.zeros((2, 2), dtype=np.int32)
+    g_idx = np.zeros(16, dtype=np.int32)
+    ops.vecquant8matmul(vec, qweight, mul, scales, zeros, g_idx)
+
+    with pytest.raises(TypeError):
+        ops.vecquant8matmul(vec, qweight.astype(np.int64), mul, scales, zeros, g_idx)
+    with pytest.raises(ValueError):
+        ops.vecquant8matmul(vec, qweight[:3], mul, scales, zeros, g_idx)
+    with pytest.raises(ValueError):
+        ops.vecquant8matmul(vec, qweight, mul[:, :4], scales, zeros, g_idx)
+    with pytest.raises(ValueError):
+        ops.vecquant8matmul(vec, qweight, mul, scales, zeros[:, :1], g_idx)
+    for bad in (2, -1):
+        g = g_idx.copy()
+        g[5] = bad
+        with pytest.raises(ValueError):
+            ops.vecquant8matmul(vec, qweight, mul, scales, zeros, g)
+
+    vec4 = rng.standard_normal((1, 1, 2, 16), dtype=np.float32)
+    with pytest.raises(ValueError):
+        ops.vecquant8matmul_batched(vec4, np.zeros((1, 1, 4, 8), dtype=np.int32),
+                                    np.zeros((1, 1, 2, 8), dtype=np.float32),
+                                    np.ones((1, 1, 8), dtype=np.float32),
+                                    np.zeros((1, 1, 3), dtype=np.int32))
+    with pytest.raises(ValueError):
+        ops.vecquant4matmul_batched_column_compression(
+            vec4, np.zeros((1, 1, 16, 1), dtype=np.int32),
+            np.zeros((1, 1, 2, 8), dtype=np.float32),
+            np.ones((1, 1, 15), dtype=np.float32), np.zeros((1, 1, 16), dtype=np.int32))
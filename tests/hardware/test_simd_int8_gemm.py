@@ -0,0 +1,53 @@
+#!/usr/bin/env python
+# -*- coding: utf-8 -*-
+"""
+INT8 GEMM 测试: 浮点/预量化权重的打包、动态激活量化后的矩阵乘对照 NumPy，以及参数检查
+"""
+
+import numpy as np
+import pytest
+
+pytestmark = pytest.mark.unit
+
+
+@pytest.mark.parametrize("m,k,n", [(1, 64, 32), (7, 200, 45), (64, 512, 130)])
+def test_int8_matmul_float_weights(ops, rng, m, k, n):
+    w = rng.standard_normal((k, n), dtype=np.float32)
+    a = rng.standard_normal((m, k), dtype=np.float32)
+    packed = ops.pack_int8_weights(w)
+    out = ops.int8_matmul(a, packed)
+    ref = a.astype(np.float64) @ w
+    # 权重按输出通道、激活按行各量化一次
+    assert out.shape == (m, n)
+    assert np.abs(out - ref).max() < 0.03 * np.abs(ref).max()
+
+
+def test_int8_matmul_prequantized_weights(ops, rng):
+    k, n = 96, 24
+    q = rng.integers(-127, 128, (k, n)).astype(np.int8)
+    scales = rng.uniform(0.001, 0.01, n).astype(np.float32)
+    # 整数值激活可被精确量化
+    a = rng.integers(-127, 128, (5, k)).astype(np.float32)
+    a[:, 0] = 127.0
+    out = ops.int8_matmul(a, ops.pack_int8_weights(q, scales))
+    ref = (a.astype(np.float64) @ q.astype(np.float64)) * scales
+    np.testing.assert_allclose(out, ref, rtol=1e-5, atol=1e-4)
+    assert ops.int8_matmul(np.zeros((0, k), dtype=np.float32),
+                           ops.pack_int8_weights(q, scales)).shape == (0, n)
+
+
+def test_int8_rejects_bad_arguments(ops, rng):
+    q = rng.integers(-127, 128, (32, 8)).astype(np.int8)
+    scales = np.ones(8, dtype=np.float32)
+    with pytest.raises(ValueError):
+        ops.pack_int8_weights(q)
+    with pytest.raises(ValueError):
+        ops.pack_int8_weights(q, scales[:4])
+    q[3, 2] = -128
+    with pytest.raises(ValueError):
+        ops.pack_int8_weights(q, scales)
+    with pytest.raises(ValueError):
+        ops.pack_int8_weights(np.zeros(8, dtype=np.float32))
+    packed = ops.pack_int8_weights(rng.standard_normal((32, 8), dtype=np.float32))
+    with pytest.raises(ValueError):
+        ops.int8_matmul(np.zeros((2, 31), dtype=np.float32), packed)
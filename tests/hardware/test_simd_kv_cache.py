@@ -0,0 +1,235 @@
+#!/usr/bin/env python
+# -*- coding: utf-8 -*-
+"""
+分页 KV 缓存测试: f32/int8/fp8 写读、分页注意力对照 NumPy、前缀复用与 LRU 逐出、
+块不足与非法写入
+"""
+
+import threading
+
+import numpy as np
+import pytest
+
+pytestmark = pytest.mark.unit
+
+N_LAYERS, N_KV_HEADS, HEAD_DIM, BLOCK = 2, 2, 32, 16
+
+
+def attention_ref(q, k, v, causal, scale):
+    group = q.shape[0] // k.shape[0]
+    k = np.repeat(k.astype(np.float64), group, axis=0)
+    v = np.repeat(v.astype(np.float64), group, axis=0)
+    s = q.astype(np.float64) @ np.swapaxes(k, -1, -2) * scale
+    if causal:
+        n_q, n_kv = s.shape[-2:]
+        s = np.where(np.arange(n_kv)[None, :] <= np.arange(n_q)[:, None] + (n_kv - n_q), s, -np.inf)
+    e = np.exp(s - s.max(-1, keepdims=True))
+    return (e / e.sum(-1, keepdims=True)) @ v
+
+
+@pytest.fixture
+def make_cache(ops):
+    def make(n_blocks=8, dtype="f32"):
+        return ops.create_kv_cache(N_LAYERS, N_KV_HEADS, HEAD_DIM, n_blocks=n_blocks,
+                                   block_size=BLOCK, dtype=dtype)
+    return make
+
+
+def kv(rng, n):
+    return (rng.standard_normal((N_KV_HEADS, n, HEAD_DIM), dtype=np.float32),
+            rng.standard_normal((N_KV_HEADS, n, HEAD_DIM), dtype=np.float32))
+
+
+def fill(cache, seq, rng, tokens):
+    """追加 tokens 并写入所有层，返回各层的 (K, V)"""
+    pos = cache.append(seq, tokens)
+    layers = []
+    for layer in range(N_LAYERS):
+        k, v = kv(rng, len(tokens))
+        cache.write(seq, layer, pos, k, v)
+        layers.append((k, v))
+    return layers
+
+
+@pytest.mark.parametrize("dtype", ["f32", "int8", "fp8"])
+def test_write_read_roundtrip(make_cache, rng, dtype):
+    cache = make_cache(dtype=dtype)
+    seq = cache.create_sequence()
+    layers = fill(cache, seq, rng, np.arange(37))
+    assert cache.length(seq) == 37
+    for layer, (k, v) in enumerate(layers):
+        rk, rv = cache.read(seq, layer)
+        for got, ref in ((rk, k), (rv, v)):
+            amax = np.abs(ref).max(axis=-1, keepdims=True)
+            if dtype == "f32":
+                np.testing.assert_array_equal(got, ref)
+            elif dtype == "int8":
+                # 每个 (token, 头) 一个缩放，误差不超过半个量化步长
+                assert np.all(np.abs(got - ref) <= amax / 127 * 0.5 + 1e-6)
+            else:
+                # E4M3 尾数 3 位
+                assert np.all(np.abs(got - ref) <= np.maximum(np.abs(ref) / 16, amax / 448 * 2 ** -6 * 4))
+    k, v = cache.read(seq, 1, pos=30, n=5)
+    assert k.shape == (N_KV_HEADS, 5, HEAD_DIM)
+    with pytest.raises(ValueError):
+        cache.read(seq, 0, pos=30, n=10)
+
+
+@pytest.mark.parametrize("dtype", ["f32", "int8"])
+@pytest.mark.parametrize("n_heads,n_q", [(2, 1), (4, 1), (4, 9)])
+def test_paged_attention(make_cache, ops, rng, dtype, n_heads, n_q):
+    cache = make_cache(dtype=dtype)
+    seq = cache.create_sequence()
+    fill(cache, seq, rng, np.arange(50))
+    q = rng.standard_normal((n_heads, n_q, HEAD_DIM), dtype=np.float32)
+    out = cache.attention(q, seq, 1)
+    k, v = cache.read(seq, 1)
+    # 与对反量化后的 K/V 做连续注意力一致
+    np.testing.assert_allclose(out, attention_ref(q, k, v, True, HEAD_DIM ** -0.5),
+                               rtol=1e-4, atol=1e-5)
+    np.testing.assert_allclose(out, ops.attention(q, k, v, causal=True), rtol=1e-4, atol=1e-5)
+    with pytest.raises(ValueError):
+        cache.attention(q[:, :, :16], seq, 1)
+    with pytest.raises(ValueError):
+        cache.attention(q, seq, N_LAYERS)
+
+
+def test_prefix_reuse_after_free(make_cache, rng):
+    cache = make_cache()
+    prompt = np.arange(100, 140)                          # 2 个满块 + 8 个 token
+    a = cache.create_sequence()
+    layers = fill(cache, a, rng, prompt)
+    stats = cache.stats()
+    assert stats["prefix_blocks"] == 2 and stats["used_blocks"] == 3
+    cache.free_sequence(a)
+    # 结束会话的满块进入 LRU，尾块回到空闲表
+    stats = cache.stats()
+    assert stats["cached_blocks"] == 2 and stats["free_blocks"] == 6 and stats["used_blocks"] == 0
+
+    b = cache.create_sequence()
+    assert cache.match_prefix(b, prompt) == 2 * BLOCK
+    assert cache.length(b) == 2 * BLOCK
+    for layer, (k, v) in enumerate(layers):
+        rk, rv = cache.read(b, layer)
+        np.testing.assert_array_equal(rk, k[:, :2 * BLOCK])
+        np.testing.assert_array_equal(rv, v[:, :2 * BLOCK])
+    assert cache.stats()["cached_blocks"] == 0
+    # 共享块只读，其后的位置可以写入
+    with pytest.raises(ValueError):
+        cache.write(b, 0, 0, *kv(rng, 1))
+    pos = cache.append(b, prompt[2 * BLOCK:])
+    assert pos == 2 * BLOCK
+    cache.write(b, 0, pos, *kv(rng, 8))
+
+    # 不同的提示词只匹配公共的满块前缀
+    c = cache.create_sequence()
+    other = prompt.copy()
+    other[BLOCK + 3] = -5
+    assert cache.match_prefix(c, other) == BLOCK
+    with pytest.raises(ValueError):
+        cache.match_prefix(c, prompt)                     # 非空序列
+
+
+def test_prefix_registered_only_after_all_layers(make_cache, rng):
+    cache = make_cache()
+    seq = cache.create_sequence()
+    pos = cache.append(seq, np.arange(BLOCK))
+    cache.write(seq, 0, pos, *kv(rng, BLOCK))
+    assert cache.stats()["prefix_blocks"] == 0
+    other = cache.create_sequence()
+    assert cache.match_prefix(other, np.arange(BLOCK)) == 0
+    cache.write(seq, 1, pos, *kv(rng, BLOCK))
+    assert cache.stats()["prefix_blocks"] == 1
+
+
+def test_append_without_tokens_is_not_shared(make_cache, rng):
+    cache = make_cache()
+    seq = cache.create_sequence()
+    pos = cache.append(seq, n=BLOCK)
+    for layer in range(N_LAYERS):
+        cache.write(seq, layer, pos, *kv(rng, BLOCK))
+    assert cache.stats()["prefix_blocks"] == 0
+    with pytest.raises(ValueError):
+        cache.append(seq)
+
+
+def test_out_of_blocks_and_lru_eviction(make_cache, rng):
+    cache = make_cache(n_blocks=4)
+    a = cache.create_sequence()
+    fill(cache, a, rng, np.arange(3 * BLOCK))
+    b = cache.create_sequence()
+    with pytest.raises(MemoryError):
+        cache.append(b, n=2 * BLOCK)
+    # 失败的追加不修改序列
+    assert cache.length(b) == 0 and cache.stats()["free_blocks"] == 1
+    cache.free_sequence(a)
+    assert cache.stats()["cached_blocks"] == 3
+    # 空闲块用尽后逐出最久未用的已缓存块: 叶子块先于其前缀被逐出
+    assert cache.append(b, n=3 * BLOCK) == 0
+    stats = cache.stats()
+    assert stats["free_blocks"] == 0 and stats["cached_blocks"] == 1 and stats["prefix_blocks"] == 1
+    c = cache.create_sequence()
+    assert cache.match_prefix(c, np.arange(3 * BLOCK)) == BLOCK
+
+
+def test_invalid_sequences_and_writes(make_cache, rng):
+    cache = make_cache()
+    seq = cache.create_sequence()
+    cache.append(seq, n=4)
+    with pytest.raises(ValueError):
+        cache.write(seq, 0, 2, *kv(rng, 3))               # 越过序列末尾
+    with pytest.raises(ValueError):
+        cache.write(seq, N_LAYERS, 0, *kv(rng, 1))
+    with pytest.raises(ValueError):
+        cache.write(seq, 0, 0, rng.standard_normal((3, 1, HEAD_DIM), dtype=np.float32),
+                    rng.standard_normal((3, 1, HEAD_DIM), dtype=np.float32))
+    k, v = kv(rng, 2)
+    with pytest.raises(ValueError):
+        cache.write(seq, 0, 0, k, v[:, :1])
+    cache.free_sequence(seq)
+    for call in (lambda: cache.length(seq), lambda: cache.free_sequence(seq),
+                 lambda: cache.append(seq, n=1), lambda: cache.read(seq, 0, 0, 1)):
+        with pytest.raises(ValueError):
+            call()
+    with pytest.raises(ValueError):
+        cache.free_sequence(12345)
+
+
+def test_reads_during_concurrent_appends(make_cache, rng):
+    # 追加会让块表重新分配，读出与分页注意力使用创建视图时复制的块号
+    cache = make_cache(n_blocks=512)
+    seq = cache.create_sequence()
+    layers = fill(cache, seq, rng, np.arange(2 * BLOCK))
+    q = rng.standard_normal((N_KV_HEADS, 1, HEAD_DIM), dtype=np.float32)
+    stop = threading.Event()
+
+    def grow():
+        while not stop.is_set() and cache.stats()["free_blocks"] > 1:
+            cache.append(seq, n=BLOCK)
+
+    writer = threading.Thread(target=grow)
+    writer.start()
+    try:
+        for _ in range(200):
+            for layer, (k, v) in enumerate(layers):
+                rk, rv = cache.read(seq, layer, 0, 2 * BLOCK)
+                np.testing.assert_array_equal(rk, k)
+                np.testing.assert_array_equal(rv, v)
+            assert cache.attention(q, seq, 0).shape == q.shape
+    finally:
+        stop.set()
+        writer.join()
+    assert cache.length(seq) > 2 * BLOCK
+
+
+def test_create_arguments(ops):
+    cache = ops.create_kv_cache(1, 1, 8, block_size=4, max_bytes=1 << 12)
+    stats = cache.stats()
+    assert stats["block_bytes"] == 2 * 4 * 8 * 4
+    assert stats["total_blocks"] == (1 << 12) // stats["block_bytes"]
+    with pytest.raises(ValueError):
+        ops.create_kv_cache(1, 1, 8, n_blocks=4, dtype="bf16")
+    with pytest.raises(ValueError):
+        ops.create_kv_cache(1, 1, 8)
+    with pytest.raises(MemoryError):
+        ops.create_kv_cache(0, 1, 8, n_blocks=4)
@@ -0,0 +1,62 @@
+#!/usr/bin/env python
+# -*- coding: utf-8 -*-
+"""
+大页/NUMA 测试: 区域分配的标志与回退、NUMA 拓扑与内存策略、按节点复制的 GEMV 权重副本
+与未打包的 GEMV 结果一致
+"""
+
+import numpy as np
+import pytest
+
+pytestmark = pytest.mark.unit
+
+
+def test_region_allocation(ops):
+    a = ops.region_empty((3 << 20) // 4, np.float32)
+    assert not a.any()                                     # 内容为 0
+    assert a.ctypes.data % 4096 == 0
+    a[::1024] = 1.0
+    flags = ops.region_flags(a)
+    assert set(flags) == {"hugepage", "hugetlb", "populated", "numa"}
+    assert not flags["numa"] and not flags["populated"]
+    assert ops.region_flags(a[100:]) == flags
+    # hugetlb 没有预留大页时退回透明大页或普通页
+    b = ops.region_empty((1000,), np.int32, hugepage=False, hugetlb=True, populate=True)
+    assert ops.region_flags(b)["populated"] and not b.any()
+    assert ops.region_flags(np.zeros(4)) == {}
+
+
+def test_numa_info_and_policy(ops):
+    info = ops.get_numa_info()
+    assert info["nodes"] >= 1
+    assert -1 <= info["current_node"] < info["nodes"]
+    assert ops.set_numa_policy("default")
+    assert not ops.set_numa_policy("bind", node=info["nodes"] + 7)
+    region = ops.region_empty(1 << 16, np.uint8, numa_policy="interleave")
+    region[...] = 7
+    if info["nodes"] > 1:
+        assert ops.region_flags(region)["numa"]
+    ops.set_numa_policy("default")
+
+
+@pytest.mark.parametrize("replicas", [0, 1])
+def test_gemv_packed_all_kinds(ops, rng, replicas):
+    n, k = 50, 128
+    w = rng.standard_normal((n, k), dtype=np.float32)
+    x = rng.standard_normal(k, dtype=np.float32)
+    bias = rng.standard_normal(n, dtype=np.float32)
+    q8, s8 = ops.quantize_gemv_q8(w)
+    q4, s4 = ops.quantize_gemv_q4(w, group_size=32)
+    cases = [(w, None, ops.gemv(w, x, bias)),
+             (w.astype(np.float16), None, ops.gemv(w.astype(np.float16), x, bias)),
+             (q8, s8, ops.gemv_q8(q8, s8, x, bias)),
+             (q4, s4, ops.gemv_q4(q4, s4, x, bias))]
+    for weight, scales, expected in cases:
+        packed = ops.pack_gemv_weights(weight, scales, replicas=replicas)
+        assert (packed.N, packed.K) == (n, k)
+        np.testing.assert_allclose(ops.gemv_packed(packed, x, bias), expected,
+                                   rtol=1e-5, atol=1e-5)
+    with pytest.raises(ValueError):
+        ops.pack_gemv_weights(q8)
+    with pytest.raises(ValueError):
+        ops.gemv_packed(ops.pack_gemv_weights(w), x[:10])
@@ -0,0 +1,111 @@
+#!/usr/bin/env python
+# -*- coding: utf-8 -*-
+"""
+内存池测试: 原生尺寸分级内存池 (对齐、复用、统计、视图保持块存活、重复释放与外来指针检测)
+与 arena 的生命周期
+"""
+
+import gc
+
+import numpy as np
+import pytest
+
+from src.hardware import memory_aligner
+
+pytestmark = pytest.mark.unit
+
+
+@pytest.mark.parametrize("alignment", [16, 64, 256, 4096])
+def test_pool_empty_alignment(ops, alignment):
+    for shape in ((1,), (37, 5), (1 << 16,)):
+        a = ops.pool_empty(shape, np.float32, alignment=alignment)
+        assert a.shape == shape and a.dtype == np.float32
+        assert a.ctypes.data % alignment == 0
+        a[...] = 1.5                                       # 整块可写
+        assert float(a.sum()) == 1.5 * a.size
+
+
+@pytest.mark.parametrize("alignment", [8192, 1 << 16])
+def test_pool_empty_large_alignment_fallback(ops, alignment):
+    # 超过池支持范围的对齐退回多分配的 np.empty
+    a = memory_aligner.pool_empty((100, 3), np.float64, alignment)
+    assert a.ctypes.data % alignment == 0 and a.shape == (100, 3)
+    assert ops.pool_empty(10, alignment=alignment).ctypes.data % alignment == 0
+
+
+def test_pool_empty_without_native_pool(ops, monkeypatch):
+    monkeypatch.setattr(memory_aligner, "_NATIVE_LIB", None)
+    a = memory_aligner.pool_empty((33,), np.float32, 128)
+    assert a.ctypes.data % 128 == 0 and a.shape == (33,)
+    assert ops.create_arena() is None
+
+
+def test_pool_reuse_and_stats(ops):
+    ops.trim_pool()
+    gc.collect()
+    base = ops.get_pool_stats()
+    a = ops.pool_empty(1000, np.float32)
+    in_use = ops.get_pool_stats()["bytes_in_use"]
+    assert in_use >= base["bytes_in_use"] + 4000
+    ptr = a.ctypes.data
+    del a
+    gc.collect()
+    stats = ops.get_pool_stats()
+    assert stats["bytes_in_use"] == base["bytes_in_use"] and stats["bytes_cached"] > 0
+    # 同尺寸类的块从缓存复用
+    b = ops.pool_empty(1000, np.float32)
+    after = ops.get_pool_stats()
+    assert after["cache_hits"] > stats["cache_hits"] and b.ctypes.data == ptr
+    del b
+    ops.trim_pool()
+
+
+def test_pool_views_keep_block_alive(ops):
+    a = ops.pool_empty((64, 64), np.float32)
+    a[...] = np.arange(64 * 64, dtype=np.float32).reshape(64, 64)
+    view = a[10:20, ::2]
+    del a
+    gc.collect()
+    ops.pool_empty((64, 64), np.float32)[...] = -1.0      # 未回收的块不会被复用
+    np.testing.assert_array_equal(view, np.arange(64 * 64, dtype=np.float32).reshape(64, 64)[10:20, ::2])
+
+
+def test_arena_lifecycle(ops):
+    arena = ops.create_arena(chunk_bytes=1 << 16)
+    a = arena.empty((100, 10), np.float32)
+    b = arena.empty(5000, np.float64, alignment=4096)      # 超过块大小的分配单独成块
+    assert a.ctypes.data % 64 == 0 and b.ctypes.data % 4096 == 0
+    a[...] = 1.0
+    b[...] = 2.0
+    stats = arena.get_stats()
+    assert stats["used"] >= 4000 + 40000 and stats["reserved"] >= stats["used"]
+    assert arena.live_arrays() == 2
+    # 仍有数组存活时拒绝 reset
+    with pytest.raises(RuntimeError):
+        arena.reset()
+    view = a[3]
+    del a, b
+    gc.collect()
+    with pytest.raises(RuntimeError):
+        arena.reset()
+    del view
+    gc.collect()
+    arena.reset()
+    stats = arena.get_stats()
+    assert stats["used"] == 0 and stats["peak"] >= 44000
+    arena.empty(10)
+    arena.reset(force=True)
+    arena.close()
+
+
+@pytest.mark.parametrize("body,message", [
+    ("p = lib.simd_pool_alloc(256, 64)\nlib.simd_pool_free(p)\nlib.simd_pool_free(p)\n",
+     "was already freed"),
+    ("import ctypes\nbuf = ctypes.create_string_buffer(4096)\n"
+     "lib.simd_pool_free(ctypes.addressof(buf) + 2048)\n",
+     "was not allocated by the pool"),
+])
+def test_pool_free_misuse_aborts(run_native, body, message):
+    proc = run_native("lib = ops.simd_lib\n" + body + "print('survived')\n")
+    assert proc.returncode != 0 and "survived" not in proc.stdout
+    assert message in proc.stderr
@@ -0,0 +1,95 @@
+#!/usr/bin/env python
+# -*- coding: utf-8 -*-
+"""
+逐层权重预取测试: 后台线程把下一层权重读入对齐槽位，槽位复用、acquire 的数组存活时拒绝 release
+与 close
+"""
+
+import gc
+
+import numpy as np
+import pytest
+
+from test_simd_tensor_store import layer_weights, write_safetensors
+
+pytestmark = pytest.mark.unit
+
+
+def test_prefetcher_layer_loop(ops, rng, tmp_path):
+    n_layers = 4
+    tensors = layer_weights(rng, n_layers)
+    store = ops.open_tensor_store(write_safetensors(tmp_path / "m.safetensors", tensors))
+    pf = ops.create_prefetcher(n_slots=2, slot_bytes=1 << 16, n_threads=2)
+    slot = pf.submit(store, "model.layers.0.")
+    for i in range(n_layers):
+        nxt = pf.submit(store, f"model.layers.{i + 1}.") if i + 1 < n_layers else None
+        weights = pf.acquire(slot, timeout=30)
+        assert pf.ready(slot)
+        assert sorted(weights) == sorted(n for n in tensors if n.startswith(f"model.layers.{i}."))
+        for name, arr in weights.items():
+            np.testing.assert_array_equal(arr, tensors[name])
+            assert arr.ctypes.data % 64 == 0
+        del weights, arr
+        pf.release(slot)
+        slot = nxt
+    stats = pf.get_stats()
+    layer_bytes = sum(t.nbytes for n, t in tensors.items() if n.startswith("model.layers."))
+    assert stats["batches"] == n_layers and stats["bytes_read"] >= layer_bytes
+    pf.close()
+
+
+def test_prefetcher_slot_errors(ops, rng, tmp_path):
+    tensors = layer_weights(rng, 2)
+    store = ops.open_tensor_store(write_safetensors(tmp_path / "m.safetensors", tensors))
+    pf = ops.create_prefetcher(n_slots=1, slot_bytes=1 << 16, n_threads=1)
+    with pytest.raises(ValueError):
+        pf.submit(store, "nothing.")
+    small = ops.create_prefetcher(n_slots=1, slot_bytes=1024, n_threads=1)
+    with pytest.raises(ValueError):
+        small.submit(store, "model.layers.0.")             # 超过槽位容量
+
+    slot = pf.submit(store, "model.layers.0.")
+    with pytest.raises(RuntimeError):
+        pf.submit(store, "model.layers.1.")                # 没有空闲槽位
+    first = pf.acquire(slot)
+    second = pf.acquire(slot)                              # 同一槽位多次 acquire
+    del first
+    gc.collect()
+    # 任一次 acquire 的数组存活都拒绝 release
+    with pytest.raises(RuntimeError):
+        pf.release(slot)
+    view = second["model.layers.0.attn.weight"][3:5]
+    del second
+    gc.collect()
+    with pytest.raises(RuntimeError):
+        pf.release(slot)
+    del view
+    gc.collect()
+    pf.release(slot)
+    slot = pf.submit(store, "model.layers.1.")
+    kept = pf.acquire(slot)
+    pf.release(slot, force=True)
+    del kept
+    np.testing.assert_array_equal(pf.acquire(pf.submit(store, "lm_head."))["lm_head.weight"],
+                                  tensors["lm_head.weight"])
+
+
+def test_prefetcher_close_with_live_arrays(ops, rng, tmp_path):
+    tensors = layer_weights(rng, 1)
+    store = ops.open_tensor_store(write_safetensors(tmp_path / "m.safetensors", tensors))
+    pf = ops.create_prefetcher(n_slots=1, slot_bytes=1 << 16, n_threads=1)
+    weights = pf.acquire(pf.submit(store, "model.layers.0."))
+    with pytest.raises(RuntimeError):
+        pf.close()
+    # 拒绝之后缓冲区仍然有效
+    for name, arr in weights.items():
+        np.testing.assert_array_equal(arr, tensors[name])
+    del weights, arr
+    gc.collect()
+    pf.close()
+    pf.close()                                             # 重复 close 无操作
+
+    pf = ops.create_prefetcher(n_slots=1, slot_bytes=1 << 16, n_threads=1)
+    kept = pf.acquire(pf.submit(store, "model.layers.0."))
+    pf.close(force=True)
+    del kept
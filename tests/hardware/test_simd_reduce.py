@@ -0,0 +1,66 @@
+#!/usr/bin/env python
+# -*- coding: utf-8 -*-
+"""
+归约测试: sum/mean/max/min/var/L1/L2 全局与按轴归约 (含转置视图与三维数组)、argmax/argmin
+的并列取首个、mean_var 的数值稳定性，对照 NumPy (float64 参考)
+"""
+
+import numpy as np
+import pytest
+
+pytestmark = pytest.mark.unit
+
+
+REDUCE_REFS = {
+    "sum": np.sum, "mean": np.mean, "max": np.max, "min": np.min, "var": np.var,
+    "l1": lambda v, axis=None: np.abs(v).sum(axis=axis),
+    "l2": lambda v, axis=None: np.sqrt((v ** 2).sum(axis=axis)),
+}
+
+
+@pytest.mark.parametrize("op", sorted(REDUCE_REFS))
+def test_reduce(ops, rng, op):
+    x = rng.standard_normal((37, 129), dtype=np.float32) + 0.5
+    xd = x.astype(np.float64)
+    fn = REDUCE_REFS[op]
+    assert ops.reduce(x, op) == pytest.approx(fn(xd), rel=1e-4, abs=1e-4)
+    for axis in (0, 1, -1):
+        np.testing.assert_allclose(ops.reduce(x, op, axis=axis), fn(xd, axis=axis),
+                                   rtol=1e-4, atol=1e-4)
+    # 转置视图与三维数组
+    np.testing.assert_allclose(ops.reduce(x.T, op, axis=0), fn(xd.T, axis=0), rtol=1e-4, atol=1e-4)
+    x3 = x[:36].reshape(4, 9, 129)
+    np.testing.assert_allclose(ops.reduce(x3, op, axis=1), fn(x3.astype(np.float64), axis=1),
+                               rtol=1e-4, atol=1e-4)
+
+
+def test_reduce_arg_and_mean_var(ops, rng):
+    x = rng.standard_normal((23, 77), dtype=np.float32)
+    x[4, 9] = x[4, 60] = 100.0                            # 并列最大值取首个
+    assert ops.argmax(x) == int(np.argmax(x))
+    assert ops.argmin(x) == int(np.argmin(x))
+    np.testing.assert_array_equal(ops.argmax(x, axis=1), np.argmax(x, axis=1))
+    np.testing.assert_array_equal(ops.argmin(x, axis=0), np.argmin(x, axis=0))
+    mean, var = ops.mean_var(x + 1000.0)
+    assert mean == pytest.approx(float(np.mean(x.astype(np.float64) + 1000.0)), rel=1e-6)
+    assert var == pytest.approx(float(np.var(x.astype(np.float64))), rel=1e-3)
+    m, v = ops.mean_var(x, axis=0)
+    np.testing.assert_allclose(m, x.astype(np.float64).mean(0), rtol=1e-4, atol=1e-6)
+    np.testing.assert_allclose(v, x.astype(np.float64).var(0), rtol=1e-4, atol=1e-6)
+    with pytest.raises(ValueError):
+        ops.reduce(x, "median")
+    with pytest.raises(ValueError):
+        ops.argmax(np.zeros(0, dtype=np.float32))
+    with pytest.raises(ValueError):
+        ops.reduce(x, "sum", axis=2)
+
+
+@pytest.mark.parametrize("n", [1, 2, 15, 16, 17, 1000, 100003])
+def test_reduce_lengths(ops, rng, n):
+    # 向量宽度尾部与多线程切分的长向量
+    x = rng.standard_normal(n, dtype=np.float32)
+    xd = x.astype(np.float64)
+    assert ops.reduce(x, "sum") == pytest.approx(xd.sum(), rel=1e-4, abs=1e-3)
+    assert ops.reduce(x, "max") == float(x.max())
+    assert ops.argmin(x) == int(np.argmin(x))
+
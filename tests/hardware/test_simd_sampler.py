@@ -0,0 +1,109 @@
+#!/usr/bin/env python
+# -*- coding: utf-8 -*-
+"""
+采样器测试: 原生 simd_sample 与同一随机数流的 NumPy 实现逐 token 一致、贪心/惩罚/top-k/top-p
+语义、抽样分布与非法参数
+"""
+
+import numpy as np
+import pytest
+
+from src.hardware.simd_wrapper import TokenSampler
+
+pytestmark = pytest.mark.unit
+
+CONFIGS = [
+    dict(temperature=1.0),
+    dict(temperature=0.7, top_k=40),
+    dict(temperature=1.3, top_p=0.9),
+    dict(temperature=0.8, top_k=50, top_p=0.8),
+    dict(temperature=1.0, top_k=1),
+    dict(temperature=0.9, repetition_penalty=1.3, presence_penalty=0.5, frequency_penalty=0.2),
+    dict(temperature=0.0, repetition_penalty=1.5),
+]
+
+
+@pytest.mark.parametrize("config", CONFIGS, ids=lambda c: ",".join(f"{k}={v}" for k, v in c.items()))
+def test_native_matches_numpy_sequence(lib, rng, config):
+    vocab = 3000
+    native = TokenSampler(lib, seed=42, **config)
+    reference = TokenSampler(None, seed=42, **config)
+    history = list(rng.integers(0, vocab, 20))
+    for _ in range(50):
+        logits = rng.standard_normal(vocab, dtype=np.float32) * 3
+        expected = reference(logits, history)
+        assert native(logits, history) == expected
+        history.append(expected)
+    # 随机数状态同步推进
+    assert native.state.value == reference.state.value
+
+
+def test_greedy_and_top_k_one(ops, rng):
+    logits = rng.standard_normal(1000, dtype=np.float32)
+    assert ops.create_sampler(temperature=0)(logits) == int(np.argmax(logits))
+    sampler = ops.create_sampler(top_k=1, seed=3)
+    assert all(sampler(logits) == int(np.argmax(logits)) for _ in range(10))
+
+
+def test_penalties_change_greedy_choice(ops):
+    logits = np.array([2.0, 1.9, -1.0, 0.5], dtype=np.float32)
+    original = logits.copy()
+    greedy = ops.create_sampler(temperature=0, repetition_penalty=1.1)
+    assert greedy(logits, [0]) == 1                       # 2.0 / 1.1 < 1.9
+    assert greedy(logits, [1]) == 0
+    freq = ops.create_sampler(temperature=0, frequency_penalty=0.06)
+    assert freq(logits, [0, 0]) == 1                      # 2.0 - 0.12 < 1.9
+    assert freq(logits, [0]) == 0
+    presence = ops.create_sampler(temperature=0, presence_penalty=5.0)
+    assert presence(logits, [0, 1]) == 3
+    # 不修改 logits
+    np.testing.assert_array_equal(logits, original)
+
+
+def test_sampling_distribution(ops):
+    probs = np.array([0.5, 0.3, 0.15, 0.05])
+    logits = np.log(probs).astype(np.float32)
+    sampler = ops.create_sampler(seed=7)
+    counts = np.bincount([sampler(logits) for _ in range(20000)], minlength=4)
+    np.testing.assert_allclose(counts / counts.sum(), probs, atol=0.015)
+
+    # top-p: 只在累计质量首次达到 0.75 的 token 中抽样
+    nucleus = ops.create_sampler(top_p=0.75, seed=7)
+    counts = np.bincount([nucleus(logits) for _ in range(20000)], minlength=4)
+    assert counts[2] == counts[3] == 0
+    np.testing.assert_allclose(counts[:2] / counts.sum(), [0.625, 0.375], atol=0.015)
+
+    # top-k 与 -inf 屏蔽
+    masked = logits.copy()
+    masked[0] = -np.inf
+    top2 = ops.create_sampler(top_k=2, seed=7)
+    assert set(top2(masked) for _ in range(500)) == {1, 2}
+
+
+def test_seed_reproducible(ops, rng):
+    logits = rng.standard_normal(500, dtype=np.float32)
+    a = ops.create_sampler(seed=11, top_p=0.95)
+    b = ops.create_sampler(seed=11, top_p=0.95)
+    c = ops.create_sampler(seed=12, top_p=0.95)
+    seq_a = [a(logits) for _ in range(30)]
+    assert seq_a == [b(logits) for _ in range(30)]
+    assert seq_a != [c(logits) for _ in range(30)]
+
+
+def test_invalid_arguments(ops):
+    for kwargs in (dict(top_p=0.0), dict(top_p=1.5), dict(repetition_penalty=0.0)):
+        with pytest.raises(ValueError):
+            ops.create_sampler(**kwargs)
+    sampler = ops.create_sampler()
+    logits = np.zeros(10, dtype=np.float32)
+    for history in ([10], [-1]):
+        with pytest.raises(ValueError):
+            sampler(logits, history)
+        with pytest.raises(ValueError):
+            TokenSampler(None)(logits, history)
+    with pytest.raises(ValueError):
+        sampler(np.zeros((2, 5), dtype=np.float32))
+    with pytest.raises(ValueError):
+        sampler(np.zeros(0, dtype=np.float32))
+    with pytest.raises(ValueError):
+        sampler(np.full(4, -np.inf, dtype=np.float32))
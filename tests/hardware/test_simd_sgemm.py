@@ -0,0 +1,63 @@
+#!/usr/bin/env python
+# -*- coding: utf-8 -*-
+"""
+SGEMM 引擎测试: dispatch_matrix_multiply 的打包分块 GEMM 对照 NumPy (float64 参考)，
+覆盖微内核整块、M/N 尾块与多个 kc 分块
+"""
+
+import numpy as np
+import pytest
+
+pytestmark = pytest.mark.unit
+
+# 覆盖微内核整块、尾块 (M/N 非 mr/nr 倍数) 与多个 kc 分块 (K > kc)
+SHAPES = [(1, 1, 1), (7, 13, 5), (64, 64, 64), (33, 130, 257), (1, 4096, 96), (200, 3, 700)]
+
+
+def reference(a, b):
+    return a.astype(np.float64) @ b.astype(np.float64)
+
+
+def assert_gemm_close(actual, expected, k):
+    # 误差随 K 增长 (float32 累加)
+    np.testing.assert_allclose(actual, expected, rtol=1e-4, atol=1e-5 * max(k, 1) ** 0.5 * 4)
+
+
+@pytest.mark.parametrize("m,n,k", SHAPES)
+def test_matrix_multiply_matches_numpy(ops, rng, m, n, k):
+    a = rng.standard_normal((m, k), dtype=np.float32)
+    b = rng.standard_normal((k, n), dtype=np.float32)
+    c = ops.matrix_multiply(a, b)
+    assert c.shape == (m, n) and c.dtype == np.float32
+    assert_gemm_close(c, reference(a, b), k)
+
+
+def test_matrix_multiply_converts_operands(ops, rng):
+    # float64 与非连续输入先转换为连续 float32
+    a = rng.standard_normal((48, 96))
+    b = rng.standard_normal((96, 40))
+    assert_gemm_close(ops.matrix_multiply(a, b), reference(a.astype(np.float32), b.astype(np.float32)), 96)
+    big = rng.standard_normal((60, 120), dtype=np.float32)
+    view = big[3:51, ::2][:, :40]
+    w = rng.standard_normal((40, 17), dtype=np.float32)
+    assert_gemm_close(ops.matrix_multiply(view, w), reference(view, w), 40)
+
+
+def test_matrix_multiply_repeated_calls_are_identical(ops, rng):
+    # 打包缓冲区在调用之间复用，不影响结果
+    a = rng.standard_normal((130, 257), dtype=np.float32)
+    b = rng.standard_normal((257, 70), dtype=np.float32)
+    first = ops.matrix_multiply(a, b)
+    ops.matrix_multiply(rng.standard_normal((9, 11), dtype=np.float32),
+                        rng.standard_normal((11, 5), dtype=np.float32))
+    np.testing.assert_array_equal(ops.matrix_multiply(a, b), first)
+
+
+def test_matrix_multiply_rejects_bad_shapes(ops, rng):
+    a = rng.standard_normal((8, 12), dtype=np.float32)
+    for b in (rng.standard_normal((13, 4), dtype=np.float32), rng.standard_normal(12, dtype=np.float32),
+              rng.standard_normal((2, 12, 4), dtype=np.float32)):
+        with pytest.raises(ValueError):
+            ops.matrix_multiply(a, b)
+    with pytest.raises(ValueError):
+        ops.matrix_multiply(a[0], rng.standard_normal((12, 4), dtype=np.float32))
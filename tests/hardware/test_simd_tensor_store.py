@@ -0,0 +1,178 @@
+#!/usr/bin/env python
+# -*- coding: utf-8 -*-
+"""
+张量存储测试: safetensors 零拷贝 mmap 张量存储 (单文件/分片索引/目录、页缓存预取与释放、
+数组存活时保持映射) 与非法文件头的拒绝
+"""
+
+import gc
+import json
+import os
+import struct
+
+import numpy as np
+import pytest
+
+pytestmark = pytest.mark.unit
+
+ST_NAMES = {np.dtype(np.float32): "F32", np.dtype(np.float16): "F16", np.dtype(np.int8): "I8",
+            np.dtype(np.int32): "I32", np.dtype(np.uint8): "U8"}
+
+
+def write_safetensors(path, tensors, header_override=None, metadata=None):
+    """按 safetensors 格式写文件: 8 字节小端头长度 + JSON 头 + 数据区"""
+    header, blobs, offset = {}, [], 0
+    if metadata:
+        header["__metadata__"] = metadata
+    for name, arr in tensors.items():
+        data = np.ascontiguousarray(arr).tobytes()
+        header[name] = {"dtype": ST_NAMES[arr.dtype], "shape": list(arr.shape),
+                        "data_offsets": [offset, offset + len(data)]}
+        blobs.append(data)
+        offset += len(data)
+    if header_override:
+        for name, fields in header_override.items():
+            header[name].update(fields)
+    text = json.dumps(header).encode("utf-8")
+    text += b" " * (-len(text) % 8)
+    path.write_bytes(struct.pack("<Q", len(text)) + text + b"".join(blobs))
+    return path
+
+
+def layer_weights(rng, n_layers=3):
+    tensors = {}
+    for i in range(n_layers):
+        tensors[f"model.layers.{i}.attn.weight"] = rng.standard_normal((64, 48), dtype=np.float32)
+        tensors[f"model.layers.{i}.mlp.weight"] = rng.standard_normal((32, 96)).astype(np.float16)
+        tensors[f"model.layers.{i}.scale"] = rng.integers(-127, 128, 33).astype(np.int8)
+    tensors["lm_head.weight"] = rng.standard_normal((10, 64), dtype=np.float32)
+    return tensors
+
+
+def test_open_single_file(ops, rng, tmp_path):
+    tensors = layer_weights(rng)
+    path = write_safetensors(tmp_path / "model.safetensors", tensors, metadata={"format": "pt"})
+    store = ops.open_tensor_store(path)
+    assert len(store) == len(tensors)
+    assert store.names() == list(tensors)                 # 按文件位置排列
+    assert "lm_head.weight" in store and "missing" not in store
+    for name, ref in tensors.items():
+        arr = store[name]
+        np.testing.assert_array_equal(arr, ref)
+        assert not arr.flags.writeable
+        info = store.info(name)
+        assert info["shape"] == ref.shape and info["nbytes"] == ref.nbytes and info["shard"] == 0
+        assert arr.ctypes.data % info["alignment"] == 0
+    assert store.get("missing") is None
+    with pytest.raises(KeyError):
+        store["missing"]
+    with pytest.raises(KeyError):
+        store.info("missing")
+    # 零拷贝数组可直接参与计算
+    w = store["model.layers.1.attn.weight"]
+    x = rng.standard_normal(48, dtype=np.float32)
+    np.testing.assert_allclose(ops.gemv(w, x), w.astype(np.float64) @ x, rtol=1e-4, atol=1e-4)
+
+
+def test_prefetch_release_and_lifetime(ops, rng, tmp_path):
+    tensors = layer_weights(rng)
+    path = write_safetensors(tmp_path / "model.safetensors", tensors)
+    store = ops.open_tensor_store(path)
+    assert store.prefetch("model.layers.0.") == 3
+    assert store.prefetch("nothing.") == 0
+    resident = store.resident_bytes("model.layers.0.")
+    assert resident == -1 or resident >= 0
+    assert store.release("model.layers.") == 9
+    # release 后内容从页缓存重新映射
+    np.testing.assert_array_equal(store["model.layers.2.scale"], tensors["model.layers.2.scale"])
+    # 数组存活时存储保持打开
+    arr = store["lm_head.weight"]
+    del store
+    gc.collect()
+    np.testing.assert_array_equal(arr, tensors["lm_head.weight"])
+
+
+def test_page_ranges_use_system_page_size(ops, rng, tmp_path):
+    tensors = {"w": rng.standard_normal(3 * 65536 // 4 + 5, dtype=np.float32)}
+    path = write_safetensors(tmp_path / "w.safetensors", tensors)
+    store = ops.open_tensor_store(path)
+    assert store.prefetch() == 1 and store.release() == 1
+    np.testing.assert_array_equal(store["w"], tensors["w"])
+    resident = store.resident_bytes()
+    if resident == -1:
+        pytest.skip("不支持 mincore")
+    # 刚写入的文件在页缓存中，统计范围按系统页向下对齐到张量起点所在页
+    page = os.sysconf("SC_PAGESIZE")
+    data = path.read_bytes()
+    begin = 8 + struct.unpack("<Q", data[:8])[0]
+    assert resident == len(data) - begin // page * page
+
+
+def test_sharded_index_and_directory(ops, rng, tmp_path):
+    tensors = layer_weights(rng, n_layers=2)
+    names = list(tensors)
+    first = {n: tensors[n] for n in names[:4]}
+    second = {n: tensors[n] for n in names[4:]}
+    write_safetensors(tmp_path / "model-00001-of-00002.safetensors", first)
+    write_safetensors(tmp_path / "model-00002-of-00002.safetensors", second)
+    weight_map = {n: "model-00001-of-00002.safetensors" for n in first}
+    weight_map.update({n: "model-00002-of-00002.safetensors" for n in second})
+    index = tmp_path / "model.safetensors.index.json"
+    index.write_text(json.dumps({"metadata": {}, "weight_map": weight_map}))
+
+    for path in (index, tmp_path):
+        store = ops.open_tensor_store(path)
+        assert sorted(store.names()) == sorted(names)
+        for name, ref in tensors.items():
+            np.testing.assert_array_equal(store[name], ref)
+            assert store.info(name)["shard"] == (0 if name in first else 1)
+
+    # 没有索引时载入目录中的全部分片
+    index.unlink()
+    assert sorted(ops.open_tensor_store(tmp_path).names()) == sorted(names)
+
+
+MALFORMED = {
+    "negative_dim": {"w": {"shape": [-2, 4]}},
+    "fractional_dim": {"w": {"shape": [2.5, 4]}},
+    "overflowing_dim": {"w": {"shape": [2 ** 40, 2 ** 40]}},
+    "string_dim": {"w": {"shape": ["2", 4]}},
+    "offsets_reversed": {"w": {"data_offsets": [32, 0]}},
+    "offsets_past_end": {"w": {"data_offsets": [0, 4096]}},
+    "negative_offset": {"w": {"data_offsets": [-8, 24]}},
+    "float_offset": {"w": {"data_offsets": [0, 32.5]}},
+    "size_mismatch": {"w": {"shape": [3, 4]}},
+    "null_dtype": {"w": {"dtype": None}},
+    "short_offsets": {"w": {"data_offsets": [0]}},
+}
+
+
+@pytest.mark.parametrize("case", sorted(MALFORMED))
+def test_malformed_header_rejected(ops, tmp_path, case):
+    path = write_safetensors(tmp_path / "bad.safetensors",
+                             {"w": np.zeros((2, 4), dtype=np.float32),
+                              "v": np.zeros(3, dtype=np.int8)}, header_override=MALFORMED[case])
+    with pytest.raises(OSError):
+        ops.open_tensor_store(path)
+
+
+def test_unreadable_files_rejected(ops, tmp_path):
+    for name, content in (("short", b"\x01\x02"),
+                          ("huge_header", struct.pack("<Q", 1 << 40) + b"{}"),
+                          ("not_json", struct.pack("<Q", 4) + b"[1,2"),
+                          ("not_object", struct.pack("<Q", 2) + b"[]")):
+        path = tmp_path / f"{name}.safetensors"
+        path.write_bytes(content)
+        with pytest.raises(OSError):
+            ops.open_tensor_store(path)
+    with pytest.raises(OSError):
+        ops.open_tensor_store(tmp_path / "missing.safetensors")
+    (tmp_path / "empty").mkdir()
+    with pytest.raises(OSError):
+        ops.open_tensor_store(tmp_path / "empty")
+    dup = tmp_path / "dup"
+    dup.mkdir()
+    write_safetensors(dup / "a.safetensors", {"w": np.zeros(2, dtype=np.float32)})
+    write_safetensors(dup / "b.safetensors", {"w": np.zeros(2, dtype=np.float32)})
+    with pytest.raises(OSError):
+        ops.open_tensor_store(dup)
@@ -0,0 +1,53 @@
+#!/usr/bin/env python
+# -*- coding: utf-8 -*-
+"""
+线程池测试: 线程数配置与 SIMD_NUM_THREADS、多线程 GEMM 的结果与切分无关
+"""
+
+import numpy as np
+import pytest
+
+pytestmark = pytest.mark.unit
+
+
+@pytest.fixture
+def restore_threads(ops):
+    yield
+    ops.set_num_threads(0)
+
+
+def test_set_num_threads(ops, restore_threads):
+    assert ops.set_num_threads(3)
+    assert ops.get_num_threads() == 3
+    assert ops.set_num_threads(1)
+    assert ops.get_num_threads() == 1
+    ops.set_num_threads(0)                                 # <= 0 恢复默认值
+    assert ops.get_num_threads() >= 1
+
+
+@pytest.mark.parametrize("threads", [1, 2, 4])
+def test_results_independent_of_thread_count(ops, rng, restore_threads, threads):
+    a = rng.standard_normal((150, 300), dtype=np.float32)
+    b = rng.standard_normal((300, 140), dtype=np.float32)
+    ops.set_num_threads(1)
+    c1 = ops.matrix_multiply(a, b)
+    ops.set_num_threads(threads, pin_threads=threads == 4)
+    c = ops.matrix_multiply(a, b)
+    # 每个输出元素的累加顺序与切分无关
+    np.testing.assert_array_equal(c, c1)
+    np.testing.assert_allclose(c, a.astype(np.float64) @ b, rtol=1e-4, atol=1e-3)
+
+
+def test_small_problem_with_many_threads(ops, rng, restore_threads):
+    # 线程数多于可切分的块时多余线程不参与
+    ops.set_num_threads(8)
+    a = rng.standard_normal((3, 5), dtype=np.float32)
+    b = rng.standard_normal((5, 2), dtype=np.float32)
+    np.testing.assert_allclose(ops.matrix_multiply(a, b), a.astype(np.float64) @ b,
+                               rtol=1e-5, atol=1e-6)
+
+
+def test_num_threads_environment(run_native):
+    proc = run_native("print(ops.get_num_threads())", env={"SIMD_NUM_THREADS": "3"})
+    assert proc.returncode == 0, proc.stderr
+    assert proc.stdout.split()[-1] == "3"
@@ -0,0 +1,130 @@
+#!/usr/bin/env python
+# -*- coding: utf-8 -*-
+"""
+Transformer 算子测试: softmax (含整行 -inf 与按轴)、RMSNorm/LayerNorm、ReLU/GELU/SiLU 及门控激活、
+RoPE (半旋转/交错、部分旋转维度、转置视图原地处理) 对照 NumPy (float64 参考)
+"""
+
+import numpy as np
+import pytest
+
+pytestmark = pytest.mark.unit
+
+
+def softmax_ref(x, axis=-1):
+    x = x.astype(np.float64)
+    e = np.exp(x - x.max(axis=axis, keepdims=True))
+    return e / e.sum(axis=axis, keepdims=True)
+
+
+@pytest.mark.parametrize("cols", [1, 7, 16, 1000, 4099])
+def test_softmax(ops, rng, cols):
+    x = rng.standard_normal((5, cols), dtype=np.float32) * 4
+    np.testing.assert_allclose(ops.softmax(x, scale=0.5), softmax_ref(0.5 * x),
+                               rtol=1e-4, atol=1e-7)
+
+
+def test_softmax_axis_inplace_and_masked_rows(ops, rng):
+    x = rng.standard_normal((6, 9, 4), dtype=np.float32)
+    np.testing.assert_allclose(ops.softmax(x, axis=1), softmax_ref(x, axis=1), rtol=1e-4, atol=1e-7)
+    y = x.reshape(-1, 4).copy()
+    expected = softmax_ref(y)
+    assert ops.softmax(y, out=y) is y
+    np.testing.assert_allclose(y, expected, rtol=1e-4, atol=1e-7)
+    # 整行为 -inf 时输出 0，部分 -inf 的位置概率为 0
+    m = np.array([[-np.inf] * 5, [0.0, -np.inf, 1.0, -np.inf, 2.0]], dtype=np.float32)
+    s = ops.softmax(m)
+    np.testing.assert_array_equal(s[0], 0.0)
+    np.testing.assert_allclose(s[1], softmax_ref(np.array([0.0, -1e30, 1.0, -1e30, 2.0])),
+                               rtol=1e-5, atol=1e-7)
+
+
+def test_rms_and_layer_norm(ops, rng):
+    x = rng.standard_normal((11, 333), dtype=np.float32) * 3 + 1
+    w = rng.standard_normal(333, dtype=np.float32)
+    b = rng.standard_normal(333, dtype=np.float32)
+    xd = x.astype(np.float64)
+    rms = xd / np.sqrt((xd ** 2).mean(-1, keepdims=True) + 1e-6) * w
+    np.testing.assert_allclose(ops.rms_norm(x, w), rms, rtol=1e-4, atol=1e-5)
+    ln = (xd - xd.mean(-1, keepdims=True)) / np.sqrt(xd.var(-1, keepdims=True) + 1e-5) * w + b
+    np.testing.assert_allclose(ops.layer_norm(x, w, b), ln, rtol=1e-4, atol=1e-4)
+    # 行距大于列数的切片视图
+    big = rng.standard_normal((8, 400), dtype=np.float32)
+    view = big[1:7, 10:343]
+    vd = view.astype(np.float64)
+    np.testing.assert_allclose(ops.rms_norm(view, w),
+                               vd / np.sqrt((vd ** 2).mean(-1, keepdims=True) + 1e-6) * w,
+                               rtol=1e-4, atol=1e-5)
+    with pytest.raises(ValueError):
+        ops.rms_norm(x, w[:10])
+    with pytest.raises(ValueError):
+        ops.layer_norm(x, w, b[:-1])
+
+
+ACTIVATIONS = {
+    "relu": lambda v: np.maximum(v, 0.0),
+    "gelu": lambda v: 0.5 * v * (1.0 + np.tanh(0.7978845608 * (v + 0.044715 * v ** 3))),
+    "silu": lambda v: v / (1.0 + np.exp(-v)),
+}
+
+
+@pytest.mark.parametrize("act", sorted(ACTIVATIONS))
+def test_activation_and_gated(ops, rng, act):
+    g = rng.standard_normal(1031, dtype=np.float32) * 5
+    u = rng.standard_normal(1031, dtype=np.float32)
+    ref = ACTIVATIONS[act](g.astype(np.float64))
+    np.testing.assert_allclose(ops.activation(g, act), ref, rtol=1e-4, atol=1e-5)
+    np.testing.assert_allclose(ops.gated_activation(g, u, act), ref * u, rtol=1e-4, atol=1e-5)
+
+
+def test_activation_errors(ops, rng):
+    x = rng.standard_normal(8, dtype=np.float32)
+    with pytest.raises(ValueError):
+        ops.activation(x, "tanh")
+    with pytest.raises(ValueError):
+        ops.gated_activation(x, x[:4])
+
+
+def rope_ref(x, positions, theta, rotary_dim, interleaved):
+    x = x.astype(np.float64)
+    half = rotary_dim // 2
+    angle = np.outer(positions, theta ** (-2.0 * np.arange(half) / rotary_dim))
+    cos, sin = np.cos(angle), np.sin(angle)
+    out = x.copy()
+    if interleaved:
+        x0, x1 = x[..., 0:rotary_dim:2], x[..., 1:rotary_dim:2]
+        out[..., 0:rotary_dim:2] = x0 * cos - x1 * sin
+        out[..., 1:rotary_dim:2] = x1 * cos + x0 * sin
+    else:
+        x0, x1 = x[..., :half], x[..., half:rotary_dim]
+        out[..., :half] = x0 * cos - x1 * sin
+        out[..., half:rotary_dim] = x1 * cos + x0 * sin
+    return out
+
+
+@pytest.mark.parametrize("interleaved", [False, True])
+@pytest.mark.parametrize("rotary_dim", [64, 32])
+def test_rope(ops, rng, interleaved, rotary_dim):
+    x = rng.standard_normal((4, 10, 64), dtype=np.float32)
+    positions = np.arange(100, 110)
+    expected = rope_ref(x, positions, 10000.0, rotary_dim, interleaved)
+    y = x.copy()
+    assert ops.rope(y, positions, rotary_dim=rotary_dim, interleaved=interleaved) is y
+    np.testing.assert_allclose(y, expected, rtol=1e-4, atol=1e-4)
+
+    # (seq, heads, dim) 的转置视图原地处理
+    z = np.ascontiguousarray(np.swapaxes(x, 0, 1))
+    ops.rope(np.swapaxes(z, 0, 1), positions, rotary_dim=rotary_dim, interleaved=interleaved)
+    np.testing.assert_allclose(np.swapaxes(z, 0, 1), expected, rtol=1e-4, atol=1e-4)
+
+
+def test_rope_errors(ops, rng):
+    x = rng.standard_normal((2, 3, 8), dtype=np.float32)
+    with pytest.raises(ValueError):
+        ops.rope(x, rotary_dim=3)
+    with pytest.raises(ValueError):
+        ops.rope(x, rotary_dim=16)
+    with pytest.raises(ValueError):
+        ops.rope(x.astype(np.float64))
+    with pytest.raises(ValueError):
+        ops.rope(x, cos=np.ones((2, 4), dtype=np.float32), sin=np.ones((2, 4), dtype=np.float32))